@@ -0,0 +1,81 @@
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <memory>
+#include <string>
+#include <thread>  // NOLINT
+
+#include "benchmark/benchmark.h"
+#include "network/network_io_wrapper.h"
+
+namespace terrier {
+
+/**
+ * Measures how fast the responses to the clients are flushed to their sockets, with all the buffered writes gathered
+ * into a single writev and with one write per buffer. A client thread reads the responses on the other end of a
+ * socket pair as fast as it can.
+ */
+class NetworkIoBenchmark : public benchmark::Fixture {
+ public:
+  void SetUp(const benchmark::State &state) final {
+    socketpair(AF_UNIX, SOCK_STREAM, 0, fds_);
+    client_ = std::thread([fd = fds_[1]] {
+      char buffer[SOCKET_BUFFER_CAPACITY];
+      while (read(fd, buffer, sizeof(buffer)) > 0) {
+      }
+    });
+  }
+
+  void TearDown(const benchmark::State &state) final {
+    // The client stops reading once the server side is closed
+    close(fds_[0]);
+    client_.join();
+    close(fds_[1]);
+  }
+
+  static constexpr uint32_t NUM_RESPONSES = 1000;
+
+  int fds_[2];
+  std::thread client_;
+};
+
+// NOLINTNEXTLINE
+BENCHMARK_DEFINE_F(NetworkIoBenchmark, FlushAllWrites)(benchmark::State &state) {
+  const bool vectored_writes = state.range(0) != 0;
+  const std::string response(static_cast<std::size_t>(state.range(1)), 'x');
+  // The wrapper does not close the socket, TearDown does
+  auto io_wrapper = std::make_unique<network::NetworkIoWrapper>(fds_[0], vectored_writes, 0, 0, 0);
+  const auto queue = io_wrapper->GetWriteQueue();
+  // NOLINTNEXTLINE
+  for (auto _ : state) {
+    for (uint32_t i = 0; i < NUM_RESPONSES; i++) {
+      queue->BufferWriteRaw(response.data(), response.size());
+      queue->ForceFlush();
+      while (io_wrapper->FlushAllWrites() == network::Transition::NEED_WRITE) {
+        pollfd writable{fds_[0], POLLOUT, 0};
+        poll(&writable, 1, -1);
+      }
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * NUM_RESPONSES);
+  state.SetBytesProcessed(state.iterations() * NUM_RESPONSES * state.range(1));
+}
+
+// ----------------------------------------------------------------------------
+// BENCHMARK REGISTRATION
+// ----------------------------------------------------------------------------
+// clang-format off
+// Small responses to OLTP statements fit in a single buffer, large result sets take many
+BENCHMARK_REGISTER_F(NetworkIoBenchmark, FlushAllWrites)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime()
+    ->Args({0, 128})
+    ->Args({1, 128})
+    ->Args({0, 65536})
+    ->Args({1, 65536})
+    ->Args({0, 1 << 20})
+    ->Args({1, 1 << 20});
+// clang-format on
+
+}  // namespace terrier
@@ -0,0 +1,102 @@
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "common/constants.h"
+#include "common/math_util.h"
+#include "execution/sql/value.h"
+#include "network/network_io_utils.h"
+#include "network/postgres/postgres_packet_writer.h"
+#include "parser/expression/constant_value_expression.h"
+#include "planner/plannodes/output_schema.h"
+
+namespace terrier {
+
+/**
+ * Measures how fast the results of a 10M-row SELECT are serialized into DataRow messages in text format, which is what
+ * bounds the throughput of large result sets. The rows are handed to the packet writer in batches of the given size,
+ * like the OutputBuffer of the execution engine does. Each row holds a BIGINT, a DECIMAL and a short VARCHAR.
+ */
+class ResultSerializationBenchmark : public benchmark::Fixture {
+ public:
+  void SetUp(const benchmark::State &state) final {
+    for (const auto type : {type::TypeId::BIGINT, type::TypeId::DECIMAL, type::TypeId::VARCHAR}) {
+      columns_.emplace_back("col", type, std::make_unique<parser::ConstantValueExpression>(type));
+      tuple_size_ = static_cast<uint32_t>(
+          common::MathUtil::AlignTo(tuple_size_, execution::sql::ValUtil::GetSqlAlignment(type)));
+      offsets_.push_back(tuple_size_);
+      tuple_size_ += execution::sql::ValUtil::GetSqlSize(type);
+    }
+    tuple_size_ = static_cast<uint32_t>(common::MathUtil::AlignTo(tuple_size_, alignof(uint64_t)));
+
+    // One batch of rows, serialized over and over
+    const auto batch_size = static_cast<uint32_t>(state.range(0));
+    tuples_.assign(static_cast<std::size_t>(batch_size) * tuple_size_, byte{0});
+    batch_bytes_ = 0;
+    for (uint32_t row = 0; row < batch_size; row++) {
+      byte *const tuple = tuples_.data() + static_cast<std::size_t>(row) * tuple_size_;
+      const execution::sql::Integer id(static_cast<int64_t>(row) * 1000003);
+      const execution::sql::Real price(row + 0.5);
+      const execution::sql::StringVal name(NAME);
+      std::memcpy(tuple + offsets_[0], &id, sizeof(id));
+      std::memcpy(tuple + offsets_[1], &price, sizeof(price));
+      std::memcpy(tuple + offsets_[2], &name, sizeof(name));
+      // Message type, length and number of fields, then the length and the text of every field
+      batch_bytes_ += 1 + sizeof(int32_t) + sizeof(int16_t) + 3 * sizeof(int32_t);
+      batch_bytes_ += std::to_string(static_cast<int64_t>(row) * 1000003).size();
+      batch_bytes_ += std::to_string(row).size() + 2 + std::strlen(NAME);
+    }
+  }
+
+  void TearDown(const benchmark::State &state) final {
+    columns_.clear();
+    offsets_.clear();
+    tuple_size_ = 0;
+  }
+
+  static constexpr uint64_t NUM_ROWS = 10000000;
+  static constexpr const char *NAME = "terrier";
+
+  std::vector<planner::OutputSchema::Column> columns_;
+  std::vector<uint32_t> offsets_;
+  uint32_t tuple_size_ = 0;
+  std::vector<byte> tuples_;
+  uint64_t batch_bytes_ = 0;
+};
+
+// NOLINTNEXTLINE
+BENCHMARK_DEFINE_F(ResultSerializationBenchmark, TextDataRows)(benchmark::State &state) {
+  const auto batch_size = static_cast<uint32_t>(state.range(0));
+  const std::vector<network::FieldFormat> field_formats{network::FieldFormat::text};
+  network::WriteQueue queue;
+  auto writer = network::PostgresPacketWriter(common::ManagedPointer(&queue));
+  uint64_t rows = 0;
+  uint64_t bytes = 0;
+  // NOLINTNEXTLINE
+  for (auto _ : state) {
+    for (uint64_t written = 0; written < NUM_ROWS; written += batch_size) {
+      writer.WriteDataRows(tuples_.data(), batch_size, tuple_size_, columns_, field_formats);
+      // The network layer would send the batch to the client now
+      queue.Reset();
+      rows += batch_size;
+      bytes += batch_bytes_;
+    }
+  }
+  state.SetItemsProcessed(static_cast<int64_t>(rows));
+  state.SetBytesProcessed(static_cast<int64_t>(bytes));
+}
+
+// ----------------------------------------------------------------------------
+// BENCHMARK REGISTRATION
+// ----------------------------------------------------------------------------
+// clang-format off
+BENCHMARK_REGISTER_F(ResultSerializationBenchmark, TextDataRows)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime()
+    ->Arg(32)
+    ->Arg(common::Constants::OUTPUT_BATCH_SIZE);
+// clang-format on
+
+}  // namespace terrier
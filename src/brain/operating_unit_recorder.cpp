@@ -11,6 +11,7 @@
 #include "execution/compiler/operator/hash_aggregation_translator.h"
 #include "execution/compiler/operator/hash_join_translator.h"
 #include "execution/compiler/operator/operator_translator.h"
+#include "execution/compiler/operator/sort_aggregation_translator.h"
 #include "execution/compiler/operator/sort_translator.h"
 #include "execution/compiler/operator/static_aggregation_translator.h"
 #include "execution/sql/aggregators.h"
@@ -651,7 +652,10 @@ void OperatingUnitRecorder::Visit(const planner::ProjectionPlanNode *plan) {
 }
 
 void OperatingUnitRecorder::Visit(const planner::AggregatePlanNode *plan) {
-  if (plan->IsStaticAggregation()) {
+  if (plan->GetAggregateStrategyType() == planner::AggregateStrategyType::SORTED) {
+    auto translator = current_translator_.CastManagedPointerTo<execution::compiler::SortAggregationTranslator>();
+    RecordAggregateTranslator(translator, plan);
+  } else if (plan->IsStaticAggregation()) {
     auto translator = current_translator_.CastManagedPointerTo<execution::compiler::StaticAggregationTranslator>();
     RecordAggregateTranslator(translator, plan);
   } else {
@@ -16,6 +16,7 @@
 #include "execution/sql/table_vector_iterator.h"
 #include "execution/sql/thread_state_container.h"
 #include "execution/sql/value.h"
+#include "execution/sql/window_evaluator.h"
 #include "execution/sql/vector_projection_iterator.h"
 // #include "execution/util/csv_reader.h" Fix later.
 
@@ -1131,8 +1131,10 @@ ast::Expr *CodeGen::SorterIterNext(ast::Expr *iter) {
   return call;
 }
 
-ast::Expr *CodeGen::SorterIterSkipRows(ast::Expr *iter, uint32_t n) {
-  ast::Expr *call = CallBuiltin(ast::Builtin::SorterIterSkipRows, {iter, Const64(n)});
+ast::Expr *CodeGen::SorterIterSkipRows(ast::Expr *iter, uint32_t n) { return SorterIterSkipRows(iter, Const64(n)); }
+
+ast::Expr *CodeGen::SorterIterSkipRows(ast::Expr *iter, ast::Expr *n) {
+  ast::Expr *call = CallBuiltin(ast::Builtin::SorterIterSkipRows, {iter, n});
   call->SetType(ast::BuiltinType::Get(context_, ast::BuiltinType::Nil));
   return call;
 }
@@ -1149,6 +1151,45 @@ ast::Expr *CodeGen::SorterIterClose(ast::Expr *iter) {
   return call;
 }
 
+ast::Expr *CodeGen::WindowInit(ast::Expr *evaluator, ast::Identifier same_partition_fn_name,
+                               ast::Identifier same_peer_fn_name) {
+  ast::Expr *call = CallBuiltin(ast::Builtin::WindowEvaluatorInit,
+                                {evaluator, MakeExpr(same_partition_fn_name), MakeExpr(same_peer_fn_name)});
+  call->SetType(ast::BuiltinType::Get(context_, ast::BuiltinType::Nil));
+  return call;
+}
+
+ast::Expr *CodeGen::WindowAddFunction(ast::Expr *evaluator, sql::WindowFunction function, sql::TypeId type,
+                                      ast::Expr *arg_offset, ast::Expr *result_offset, int64_t offset) {
+  ast::Expr *call =
+      CallBuiltin(ast::Builtin::WindowEvaluatorAddFunction, {evaluator, Const32(static_cast<int32_t>(function)),
+                                                             Const32(static_cast<int32_t>(type)), arg_offset,
+                                                             result_offset, Const64(offset)});
+  call->SetType(ast::BuiltinType::Get(context_, ast::BuiltinType::Nil));
+  return call;
+}
+
+ast::Expr *CodeGen::WindowSetFrame(ast::Expr *evaluator, sql::WindowFrameType type, sql::WindowFrameBound start,
+                                   int64_t start_offset, sql::WindowFrameBound end, int64_t end_offset) {
+  ast::Expr *call = CallBuiltin(ast::Builtin::WindowEvaluatorSetFrame,
+                                {evaluator, Const32(static_cast<int32_t>(type)), Const32(static_cast<int32_t>(start)),
+                                 Const64(start_offset), Const32(static_cast<int32_t>(end)), Const64(end_offset)});
+  call->SetType(ast::BuiltinType::Get(context_, ast::BuiltinType::Nil));
+  return call;
+}
+
+ast::Expr *CodeGen::WindowEvaluate(ast::Expr *evaluator, ast::Expr *sorter) {
+  ast::Expr *call = CallBuiltin(ast::Builtin::WindowEvaluatorEvaluate, {evaluator, sorter});
+  call->SetType(ast::BuiltinType::Get(context_, ast::BuiltinType::Nil));
+  return call;
+}
+
+ast::Expr *CodeGen::WindowFree(ast::Expr *evaluator) {
+  ast::Expr *call = CallBuiltin(ast::Builtin::WindowEvaluatorFree, {evaluator});
+  call->SetType(ast::BuiltinType::Get(context_, ast::BuiltinType::Nil));
+  return call;
+}
+
 // ---------------------------------------------------------
 // SQL functions
 // ---------------------------------------------------------
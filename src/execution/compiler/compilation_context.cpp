@@ -32,14 +32,17 @@
 #include "execution/compiler/operator/index_scan_translator.h"
 #include "execution/compiler/operator/insert_translator.h"
 #include "execution/compiler/operator/limit_translator.h"
+#include "execution/compiler/operator/merge_join_translator.h"
 #include "execution/compiler/operator/nested_loop_join_translator.h"
 #include "execution/compiler/operator/operator_translator.h"
 #include "execution/compiler/operator/output_translator.h"
 #include "execution/compiler/operator/projection_translator.h"
 #include "execution/compiler/operator/seq_scan_translator.h"
+#include "execution/compiler/operator/sort_aggregation_translator.h"
 #include "execution/compiler/operator/sort_translator.h"
 #include "execution/compiler/operator/static_aggregation_translator.h"
 #include "execution/compiler/operator/update_translator.h"
+#include "execution/compiler/operator/window_translator.h"
 #include "execution/compiler/pipeline.h"
 #include "parser/expression/abstract_expression.h"
 #include "parser/expression/column_value_expression.h"
@@ -61,12 +64,14 @@
 #include "planner/plannodes/index_scan_plan_node.h"
 #include "planner/plannodes/insert_plan_node.h"
 #include "planner/plannodes/limit_plan_node.h"
+#include "planner/plannodes/merge_join_plan_node.h"
 #include "planner/plannodes/nested_loop_join_plan_node.h"
 #include "planner/plannodes/order_by_plan_node.h"
 #include "planner/plannodes/projection_plan_node.h"
 #include "planner/plannodes/seq_scan_plan_node.h"
 #include "planner/plannodes/set_op_plan_node.h"
 #include "planner/plannodes/update_plan_node.h"
+#include "planner/plannodes/window_plan_node.h"
 #include "spdlog/fmt/fmt.h"
 
 namespace terrier::execution::compiler {
@@ -213,9 +218,8 @@ void CompilationContext::Prepare(const planner::AbstractPlanNode &plan, Pipeline
     case planner::PlanNodeType::AGGREGATE: {
       const auto &aggregation = dynamic_cast<const planner::AggregatePlanNode &>(plan);
       if (aggregation.GetAggregateStrategyType() == planner::AggregateStrategyType::SORTED) {
-        throw NOT_IMPLEMENTED_EXCEPTION("Code generation for sort-based aggregations.");
-      }
-      if (aggregation.IsStaticAggregation()) {
+        translator = std::make_unique<SortAggregationTranslator>(aggregation, this, pipeline);
+      } else if (aggregation.IsStaticAggregation()) {
         translator = std::make_unique<StaticAggregationTranslator>(aggregation, this, pipeline);
       } else {
         translator = std::make_unique<HashAggregationTranslator>(aggregation, this, pipeline);
@@ -237,6 +241,11 @@ void CompilationContext::Prepare(const planner::AbstractPlanNode &plan, Pipeline
       translator = std::make_unique<LimitTranslator>(limit, this, pipeline);
       break;
     }
+    case planner::PlanNodeType::MERGEJOIN: {
+      const auto &merge_join = dynamic_cast<const planner::MergeJoinPlanNode &>(plan);
+      translator = std::make_unique<MergeJoinTranslator>(merge_join, this, pipeline);
+      break;
+    }
     case planner::PlanNodeType::NESTLOOP: {
       const auto &nested_loop = dynamic_cast<const planner::NestedLoopJoinPlanNode &>(plan);
       translator = std::make_unique<NestedLoopJoinTranslator>(nested_loop, this, pipeline);
@@ -247,6 +256,11 @@ void CompilationContext::Prepare(const planner::AbstractPlanNode &plan, Pipeline
       translator = std::make_unique<SortTranslator>(sort, this, pipeline);
       break;
     }
+    case planner::PlanNodeType::WINDOW: {
+      const auto &window = dynamic_cast<const planner::WindowPlanNode &>(plan);
+      translator = std::make_unique<WindowTranslator>(window, this, pipeline);
+      break;
+    }
     case planner::PlanNodeType::PROJECTION: {
       const auto &projection = dynamic_cast<const planner::ProjectionPlanNode &>(plan);
       translator = std::make_unique<ProjectionTranslator>(projection, this, pipeline);
@@ -1,17 +1,26 @@
 #include "execution/compiler/executable_query.h"
 
 #include <algorithm>
+#include <functional>
+#include <utility>
+#include <vector>
 
 #include "brain/operating_unit.h"
 #include "common/error/error_code.h"
 #include "common/error/exception.h"
+#include "common/resource_tracker.h"
+#include "common/thread_context.h"
 #include "execution/ast/ast_dump.h"
 #include "execution/ast/context.h"
 #include "execution/compiler/compiler.h"
 #include "execution/exec/execution_context.h"
+#include "execution/exec/execution_settings.h"
 #include "execution/sema/error_reporter.h"
+#include "execution/util/timer.h"
+#include "execution/vm/background_compiler.h"
 #include "execution/vm/module.h"
 #include "loggers/execution_logger.h"
+#include "metrics/metrics_store.h"
 #include "transaction/transaction_context.h"
 
 namespace terrier::execution::compiler {
@@ -56,12 +65,31 @@ void ExecutableQuery::Fragment::Run(byte query_state[], vm::ExecutionMode mode)
   }
 }
 
+void ExecutableQuery::Fragment::CompileToMachineCode() const { module_->CompileToMachineCode(); }
+
+bool ExecutableQuery::Fragment::IsCompiledToMachineCode() const { return module_->IsCompiled(); }
+
 //===----------------------------------------------------------------------===//
 //
 // Executable Query
 //
 //===----------------------------------------------------------------------===//
 
+struct ExecutableQuery::TieringState {
+  // The number of interpreted executions, and their total time in microseconds.
+  std::atomic<uint64_t> num_interpreted_runs_{0};
+  std::atomic<uint64_t> interpreted_us_{0};
+  // Set by the first execution that finds the query hot.
+  std::atomic<bool> compile_requested_{false};
+  // The background compilation task.
+  vm::BackgroundCompiler::TaskId compile_task_{0};
+  // Set once all fragments are compiled. Published with release semantics, after compile_metrics_ is written.
+  std::atomic<bool> compiled_{false};
+  common::ResourceTracker::Metrics compile_metrics_{};
+  // Set by the first compiled execution, which reports the tier-up.
+  std::atomic<bool> reported_{false};
+};
+
 // For mini_runners.cpp.
 namespace {
 std::string GetFileName(const std::string &path) {
@@ -86,13 +114,16 @@ ExecutableQuery::ExecutableQuery(const planner::AbstractPlanNode &plan, const ex
       ast_context_(std::make_unique<ast::Context>(context_region_.get(), errors_.get())),
       query_state_size_(0),
       pipeline_operating_units_(nullptr),
+      tiering_(std::make_unique<TieringState>()),
       query_id_(query_identifier++) {}
 
 ExecutableQuery::ExecutableQuery(const std::string &contents,
                                  const common::ManagedPointer<exec::ExecutionContext> exec_ctx, bool is_file,
                                  size_t query_state_size, const exec::ExecutionSettings &exec_settings)
     // TODO(WAN): Giant hack for the plan. The whole point is that you have no plan.
-    : plan_(reinterpret_cast<const planner::AbstractPlanNode &>(exec_settings)), exec_settings_(exec_settings) {
+    : plan_(reinterpret_cast<const planner::AbstractPlanNode &>(exec_settings)),
+      exec_settings_(exec_settings),
+      tiering_(std::make_unique<TieringState>()) {
   context_region_ = std::make_unique<util::Region>("context_region");
   errors_region_ = std::make_unique<util::Region>("error_region");
   errors_ = std::make_unique<sema::ErrorReporter>(errors_region_.get());
@@ -131,8 +162,12 @@ ExecutableQuery::ExecutableQuery(const std::string &contents,
   }
 }
 
-// Needed because we forward-declare classes used as template types to std::unique_ptr<>
-ExecutableQuery::~ExecutableQuery() = default;
+ExecutableQuery::~ExecutableQuery() {
+  // The background compilation task refers to this query's fragments. Make sure it never runs, or has finished.
+  if (tiering_->compile_requested_.load()) {
+    vm::BackgroundCompiler::Instance()->CancelOrWait(tiering_->compile_task_);
+  }
+}
 
 void ExecutableQuery::Setup(std::vector<std::unique_ptr<Fragment>> &&fragments, const std::size_t query_state_size,
                             std::unique_ptr<brain::PipelineOperatingUnits> pipeline_operating_units) {
@@ -151,6 +186,16 @@ void ExecutableQuery::Setup(std::vector<std::unique_ptr<Fragment>> &&fragments,
 }
 
 void ExecutableQuery::Run(common::ManagedPointer<exec::ExecutionContext> exec_ctx, vm::ExecutionMode mode) {
+  if (mode == vm::ExecutionMode::Adaptive) {
+    RunTiered(exec_ctx);
+  } else {
+    RunFragments(exec_ctx, mode);
+  }
+}
+
+bool ExecutableQuery::IsTieredUp() const { return tiering_->compiled_.load(std::memory_order_acquire); }
+
+void ExecutableQuery::RunFragments(common::ManagedPointer<exec::ExecutionContext> exec_ctx, vm::ExecutionMode mode) {
   // First, allocate the query state and move the execution context into it.
   auto query_state = std::make_unique<byte[]>(query_state_size_);
   *reinterpret_cast<exec::ExecutionContext **>(query_state.get()) = exec_ctx.Get();
@@ -158,10 +203,84 @@ void ExecutableQuery::Run(common::ManagedPointer<exec::ExecutionContext> exec_ct
   exec_ctx->SetExecutionMode(static_cast<uint8_t>(mode));
   exec_ctx->SetPipelineOperatingUnits(GetPipelineOperatingUnits());
 
+  // Fragments would otherwise be compiled one after the other, as each one is first run.
+  if (mode == vm::ExecutionMode::Compiled) {
+    CompileFragmentsToMachineCode();
+  }
+
   // Now run through fragments.
   for (const auto &fragment : fragments_) {
     fragment->Run(query_state.get(), mode);
   }
 }
 
+void ExecutableQuery::RunTiered(common::ManagedPointer<exec::ExecutionContext> exec_ctx) {
+  // Once compiled, every fragment's function table points into machine code and the compiled mode calls through it
+  // directly. The execution mode is also recorded in the pipeline metrics of this execution.
+  const bool compiled = IsTieredUp();
+  double elapsed_us = 0;
+  {
+    util::ScopedTimer<std::micro> timer(&elapsed_us);
+    RunFragments(exec_ctx, compiled ? vm::ExecutionMode::Compiled : vm::ExecutionMode::Interpret);
+  }
+
+  if (compiled) {
+    if (!tiering_->reported_.exchange(true)) {
+      ReportTierUp(static_cast<uint64_t>(elapsed_us));
+    }
+    return;
+  }
+
+  const auto run_us = static_cast<uint64_t>(elapsed_us);
+  const auto num_runs = tiering_->num_interpreted_runs_.fetch_add(1) + 1;
+  const auto total_us = tiering_->interpreted_us_.fetch_add(run_us) + run_us;
+  const auto &exec_settings = exec_ctx->GetExecutionSettings();
+  const bool hot =
+      num_runs >= exec_settings.GetJitExecutionThreshold() || total_us >= exec_settings.GetJitTimeThresholdUs();
+  if (hot && !tiering_->compile_requested_.exchange(true)) {
+    EXECUTION_LOG_DEBUG("Query {} is hot after {} interpreted runs ({} us), compiling in the background.",
+                        query_id_.UnderlyingValue(), num_runs, total_us);
+    tiering_->compile_task_ = vm::BackgroundCompiler::Instance()->Submit([this] { CompileFragments(); });
+  }
+}
+
+void ExecutableQuery::CompileFragmentsToMachineCode() const {
+  // Each fragment is a separate module with its own LLVM context, so they can be compiled independently.
+  std::vector<std::function<void()>> tasks;
+  for (const auto &fragment : fragments_) {
+    if (!fragment->IsCompiledToMachineCode()) {
+      tasks.emplace_back([fragment = fragment.get()] { fragment->CompileToMachineCode(); });
+    }
+  }
+  if (tasks.size() == 1) {
+    tasks[0]();
+  } else {
+    vm::BackgroundCompiler::Instance()->RunConcurrently(std::move(tasks));
+  }
+}
+
+void ExecutableQuery::CompileFragments() {
+  common::ResourceTracker tracker;
+  tracker.Start();
+  CompileFragmentsToMachineCode();
+  tracker.Stop();
+  tiering_->compile_metrics_ = tracker.GetMetrics();
+  tiering_->compiled_.store(true, std::memory_order_release);
+  EXECUTION_LOG_DEBUG("Query {} compiled in {} us.", query_id_.UnderlyingValue(),
+                      tiering_->compile_metrics_.elapsed_us_);
+}
+
+void ExecutableQuery::ReportTierUp(const uint64_t compiled_us) const {
+  const auto num_runs = tiering_->num_interpreted_runs_.load();
+  const auto interpreted_avg_us = num_runs == 0 ? 0 : tiering_->interpreted_us_.load() / num_runs;
+  EXECUTION_LOG_DEBUG("Query {} tiered up: interpreted {} us on average over {} runs, compiled {} us.",
+                      query_id_.UnderlyingValue(), interpreted_avg_us, num_runs, compiled_us);
+
+  if (common::thread_context.metrics_store_ != nullptr &&
+      common::thread_context.metrics_store_->ComponentEnabled(metrics::MetricsComponent::EXECUTION_PIPELINE)) {
+    common::thread_context.metrics_store_->RecordPipelineJitData(query_id_, num_runs, interpreted_avg_us, compiled_us,
+                                                                 tiering_->compile_metrics_);
+  }
+}
+
 }  // namespace terrier::execution::compiler
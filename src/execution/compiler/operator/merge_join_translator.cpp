@@ -0,0 +1,282 @@
+#include "execution/compiler/operator/merge_join_translator.h"
+
+#include "execution/compiler/compilation_context.h"
+#include "execution/compiler/function_builder.h"
+#include "execution/compiler/if.h"
+#include "execution/compiler/loop.h"
+#include "execution/compiler/work_context.h"
+#include "planner/plannodes/merge_join_plan_node.h"
+
+namespace terrier::execution::compiler {
+
+namespace {
+constexpr const char LEFT_ROW_ATTR_PREFIX[] = "attr";
+}  // namespace
+
+MergeJoinTranslator::MergeJoinTranslator(const planner::MergeJoinPlanNode &plan,
+                                         CompilationContext *compilation_context, Pipeline *pipeline)
+    : OperatorTranslator(plan, compilation_context, pipeline, brain::ExecutionOperatingUnitType::DUMMY),
+      left_row_var_(GetCodeGen()->MakeFreshIdentifier("leftRow")),
+      left_row_type_(GetCodeGen()->MakeFreshIdentifier("MergeRow")),
+      lhs_row_(GetCodeGen()->MakeIdentifier("lhs")),
+      rhs_row_(GetCodeGen()->MakeIdentifier("rhs")),
+      compare_func_(GetCodeGen()->MakeFreshIdentifier(pipeline->CreatePipelineFunctionName("MergeCompare"))),
+      left_pipeline_(this, Pipeline::Parallelism::Serial),
+      current_row_(CurrentRow::Child) {
+  TERRIER_ASSERT(!plan.GetLeftMergeKeys().empty(), "Merge-join must have join keys from left input");
+  TERRIER_ASSERT(plan.GetLeftMergeKeys().size() == plan.GetRightMergeKeys().size(),
+                 "Merge-join must have the same number of left and right join keys");
+  TERRIER_ASSERT(plan.GetJoinPredicate() != nullptr, "Merge-join must have a join predicate!");
+  TERRIER_ASSERT(plan.GetLogicalJoinType() == planner::LogicalJoinType::INNER, "Only inner merge-joins are supported");
+
+  // Both inputs are consumed in key order, so neither side may be split across threads.
+  left_pipeline_.UpdateParallelism(Pipeline::Parallelism::Serial);
+  pipeline->UpdateParallelism(Pipeline::Parallelism::Serial);
+
+  // Probe pipeline begins after the left side has been materialized.
+  pipeline->LinkSourcePipeline(&left_pipeline_);
+  // Register left and right child in their appropriate pipelines.
+  compilation_context->Prepare(*plan.GetChild(0), &left_pipeline_);
+  compilation_context->Prepare(*plan.GetChild(1), pipeline);
+
+  // Prepare join predicate, left, and right merge keys.
+  compilation_context->Prepare(*plan.GetJoinPredicate());
+  for (const auto left_merge_key : plan.GetLeftMergeKeys()) {
+    compilation_context->Prepare(*left_merge_key);
+  }
+  for (const auto right_merge_key : plan.GetRightMergeKeys()) {
+    compilation_context->Prepare(*right_merge_key);
+  }
+
+  // Declare global state.
+  auto *codegen = GetCodeGen();
+  ast::Expr *sorter_type = codegen->BuiltinType(ast::BuiltinType::Sorter);
+  left_rows_ = compilation_context->GetQueryState()->DeclareStateEntry(codegen, "mergeRows", sorter_type);
+  cursor_ = compilation_context->GetQueryState()->DeclareStateEntry(codegen, "mergeCursor", codegen->Int64Type());
+}
+
+void MergeJoinTranslator::DefineHelperStructs(util::RegionVector<ast::StructDecl *> *decls) {
+  auto *codegen = GetCodeGen();
+  auto fields = codegen->MakeEmptyFieldList();
+  GetAllChildOutputFields(0, LEFT_ROW_ATTR_PREFIX, &fields);
+  decls->push_back(codegen->DeclareStruct(left_row_type_, std::move(fields)));
+}
+
+void MergeJoinTranslator::GenerateComparisonFunction(FunctionBuilder *function) {
+  auto *codegen = GetCodeGen();
+  WorkContext context(GetCompilationContext(), left_pipeline_);
+  context.SetExpressionCacheEnable(false);
+  for (const auto &key : GetPlanAs<planner::MergeJoinPlanNode>().GetLeftMergeKeys()) {
+    int32_t ret_value = -1;
+    for (const auto tok : {parsing::Token::Type::LESS, parsing::Token::Type::GREATER}) {
+      current_row_ = CurrentRow::Lhs;
+      ast::Expr *lhs = context.DeriveValue(*key, this);
+      current_row_ = CurrentRow::Rhs;
+      ast::Expr *rhs = context.DeriveValue(*key, this);
+      If check_comparison(function, codegen->Compare(tok, lhs, rhs));
+      function->Append(codegen->Return(codegen->Const32(ret_value)));
+      check_comparison.EndIf();
+      ret_value = -ret_value;
+    }
+  }
+  current_row_ = CurrentRow::Child;
+}
+
+void MergeJoinTranslator::DefineHelperFunctions(util::RegionVector<ast::FunctionDecl *> *decls) {
+  // The left input arrives sorted and is never re-sorted, but a sorter requires a comparison
+  // function. It orders rows on the left join keys, which is the order they already arrive in.
+  auto *codegen = GetCodeGen();
+  auto params = codegen->MakeFieldList({
+      codegen->MakeField(lhs_row_, codegen->PointerType(left_row_type_)),
+      codegen->MakeField(rhs_row_, codegen->PointerType(left_row_type_)),
+  });
+  FunctionBuilder builder(codegen, compare_func_, std::move(params), codegen->Int32Type());
+  {
+    GenerateComparisonFunction(&builder);
+  }
+  decls->push_back(builder.Finish(codegen->Const32(0)));
+}
+
+void MergeJoinTranslator::InitializeQueryState(FunctionBuilder *function) const {
+  auto *codegen = GetCodeGen();
+  function->Append(codegen->SorterInit(left_rows_.GetPtr(codegen), GetMemoryPool(), compare_func_, left_row_type_));
+  function->Append(codegen->Assign(cursor_.Get(codegen), codegen->Const64(0)));
+}
+
+void MergeJoinTranslator::TearDownQueryState(FunctionBuilder *function) const {
+  function->Append(GetCodeGen()->SorterFree(left_rows_.GetPtr(GetCodeGen())));
+}
+
+ast::Expr *MergeJoinTranslator::GetLeftRowAttribute(ast::Identifier row, uint32_t attr_idx) const {
+  auto *codegen = GetCodeGen();
+  auto attr_name = codegen->MakeIdentifier(LEFT_ROW_ATTR_PREFIX + std::to_string(attr_idx));
+  return codegen->AccessStructMember(codegen->MakeExpr(row), attr_name);
+}
+
+ast::Expr *MergeJoinTranslator::KeysNotNull(
+    WorkContext *ctx, const std::vector<common::ManagedPointer<parser::AbstractExpression>> &keys) const {
+  auto *codegen = GetCodeGen();
+  ast::Expr *result = nullptr;
+  for (const auto &key : keys) {
+    ast::Expr *is_null = codegen->CallBuiltin(ast::Builtin::IsValNull, {ctx->DeriveValue(*key, this)});
+    ast::Expr *not_null = codegen->UnaryOp(parsing::Token::Type::BANG, is_null);
+    result = result == nullptr ? not_null : codegen->BinaryOp(parsing::Token::Type::AND, result, not_null);
+  }
+  return result;
+}
+
+void MergeJoinTranslator::MaterializeLeftRow(WorkContext *ctx, FunctionBuilder *function) const {
+  auto *codegen = GetCodeGen();
+  const auto &plan = GetPlanAs<planner::MergeJoinPlanNode>();
+
+  // Rows with a NULL key never join, and skipping them keeps the materialized keys totally ordered.
+  If check_keys(function, KeysNotNull(ctx, plan.GetLeftMergeKeys()));
+  {
+    // var leftRow = @ptrCast(*MergeRow, @sorterInsert())
+    ast::Expr *insert_call = codegen->SorterInsert(left_rows_.GetPtr(codegen), left_row_type_);
+    function->Append(codegen->DeclareVarWithInit(left_row_var_, insert_call));
+
+    const auto child_schema = plan.GetChild(0)->GetOutputSchema();
+    for (uint32_t attr_idx = 0; attr_idx < child_schema->GetColumns().size(); attr_idx++) {
+      ast::Expr *lhs = GetLeftRowAttribute(left_row_var_, attr_idx);
+      ast::Expr *rhs = OperatorTranslator::GetChildOutput(ctx, 0, attr_idx);
+      function->Append(codegen->Assign(lhs, rhs));
+    }
+  }
+  check_keys.EndIf();
+}
+
+void MergeJoinTranslator::CompareKeys(WorkContext *ctx, FunctionBuilder *function, ast::Identifier cmp,
+                                      std::size_t key_idx) const {
+  const auto &plan = GetPlanAs<planner::MergeJoinPlanNode>();
+  if (key_idx == plan.GetLeftMergeKeys().size()) {
+    return;
+  }
+
+  auto *codegen = GetCodeGen();
+  ast::Expr *left_key = ctx->DeriveValue(*plan.GetLeftMergeKeys()[key_idx], this);
+  ast::Expr *right_key = ctx->DeriveValue(*plan.GetRightMergeKeys()[key_idx], this);
+
+  // if (left < right) { cmp = -1 } else if (left > right) { cmp = 1 } else { compare the next key }
+  If check_less(function, codegen->Compare(parsing::Token::Type::LESS, left_key, right_key));
+  function->Append(codegen->Assign(codegen->MakeExpr(cmp), codegen->Const32(-1)));
+  check_less.Else();
+  {
+    If check_greater(function, codegen->Compare(parsing::Token::Type::GREATER, left_key, right_key));
+    function->Append(codegen->Assign(codegen->MakeExpr(cmp), codegen->Const32(1)));
+    check_greater.Else();
+    CompareKeys(ctx, function, cmp, key_idx + 1);
+    check_greater.EndIf();
+  }
+  check_less.EndIf();
+}
+
+void MergeJoinTranslator::MergeRightRow(WorkContext *ctx, FunctionBuilder *function) const {
+  auto *codegen = GetCodeGen();
+  const auto &plan = GetPlanAs<planner::MergeJoinPlanNode>();
+
+  // A right tuple with a NULL key has no join partner. Skipping it also keeps the cursor in place,
+  // since NULL compares neither less nor greater than any left key.
+  If check_keys(function, KeysNotNull(ctx, plan.GetRightMergeKeys()));
+  {
+    // var mergeIterBase: SorterIterator
+    auto iter_base = codegen->MakeFreshIdentifier("mergeIterBase");
+    function->Append(codegen->DeclareVarNoInit(iter_base, ast::BuiltinType::SorterIterator));
+    // var mergeIter = &mergeIterBase
+    auto iter_name = codegen->MakeFreshIdentifier("mergeIter");
+    auto iter = codegen->MakeExpr(iter_name);
+    function->Append(codegen->DeclareVarWithInit(iter_name, codegen->AddressOf(codegen->MakeExpr(iter_base))));
+    function->Append(codegen->SorterIterInit(iter, left_rows_.GetPtr(codegen)));
+
+    // var mergeDone = false
+    auto done = codegen->MakeFreshIdentifier("mergeDone");
+    function->Append(codegen->DeclareVarWithInit(done, codegen->ConstBool(false)));
+    // var mergeAtCursor = true
+    auto at_cursor = codegen->MakeFreshIdentifier("mergeAtCursor");
+    function->Append(codegen->DeclareVarWithInit(at_cursor, codegen->ConstBool(true)));
+
+    // for (@sorterIterSkipRows(mergeIter, cursor); !mergeDone and @sorterIterHasNext(mergeIter);
+    //      @sorterIterNext(mergeIter))
+    auto loop_cond = codegen->BinaryOp(parsing::Token::Type::AND,
+                                       codegen->UnaryOp(parsing::Token::Type::BANG, codegen->MakeExpr(done)),
+                                       codegen->SorterIterHasNext(iter));
+    Loop loop(function, codegen->MakeStmt(codegen->SorterIterSkipRows(iter, cursor_.Get(codegen))), loop_cond,
+              codegen->MakeStmt(codegen->SorterIterNext(iter)));
+    {
+      // var leftRow = @ptrCast(*MergeRow, @sorterIterGetRow(mergeIter))
+      function->Append(codegen->DeclareVarWithInit(left_row_var_, codegen->SorterIterGetRow(iter, left_row_type_)));
+
+      // var mergeCmp: int32 = 0
+      auto cmp = codegen->MakeFreshIdentifier("mergeCmp");
+      function->Append(codegen->DeclareVar(cmp, codegen->Int32Type(), codegen->Const32(0)));
+      CompareKeys(ctx, function, cmp, 0);
+
+      If check_smaller(function, codegen->Compare(parsing::Token::Type::LESS, codegen->MakeExpr(cmp),
+                                                   codegen->Const32(0)));
+      {
+        // The left row is smaller than this right tuple, and hence smaller than all later right
+        // tuples. If no equal row has been seen yet, it can be skipped permanently.
+        If check_at_cursor(function, codegen->MakeExpr(at_cursor));
+        auto next_cursor = codegen->BinaryOp(parsing::Token::Type::PLUS, cursor_.Get(codegen), codegen->Const64(1));
+        function->Append(codegen->Assign(cursor_.Get(codegen), next_cursor));
+        check_at_cursor.EndIf();
+      }
+      check_smaller.Else();
+      {
+        If check_equal(function, codegen->Compare(parsing::Token::Type::EQUAL_EQUAL, codegen->MakeExpr(cmp),
+                                                   codegen->Const32(0)));
+        {
+          // The next right tuple may have the same key, so the cursor stays on this group.
+          function->Append(codegen->Assign(codegen->MakeExpr(at_cursor), codegen->ConstBool(false)));
+          If check_condition(function, ctx->DeriveValue(*plan.GetJoinPredicate(), this));
+          ctx->Push(function);
+          check_condition.EndIf();
+        }
+        check_equal.Else();
+        {
+          // All remaining left rows are larger.
+          function->Append(codegen->Assign(codegen->MakeExpr(done), codegen->ConstBool(true)));
+        }
+        check_equal.EndIf();
+      }
+      check_smaller.EndIf();
+    }
+    loop.EndLoop();
+
+    // @sorterIterClose(mergeIter)
+    function->Append(codegen->SorterIterClose(iter));
+  }
+  check_keys.EndIf();
+}
+
+void MergeJoinTranslator::PerformPipelineWork(WorkContext *ctx, FunctionBuilder *function) const {
+  if (IsLeftPipeline(ctx->GetPipeline())) {
+    MaterializeLeftRow(ctx, function);
+  } else {
+    TERRIER_ASSERT(IsRightPipeline(ctx->GetPipeline()), "Pipeline is unknown to join translator");
+    MergeRightRow(ctx, function);
+  }
+}
+
+ast::Expr *MergeJoinTranslator::GetChildOutput(WorkContext *context, uint32_t child_idx, uint32_t attr_idx) const {
+  // In the probe pipeline, attributes of the left child are read from the materialized row the
+  // merge is positioned on.
+  if (IsRightPipeline(context->GetPipeline()) && child_idx == 0) {
+    return GetLeftRowAttribute(left_row_var_, attr_idx);
+  }
+
+  // When generating the comparison function, attributes are read from its arguments.
+  if (IsLeftPipeline(context->GetPipeline())) {
+    switch (current_row_) {
+      case CurrentRow::Lhs:
+        return GetLeftRowAttribute(lhs_row_, attr_idx);
+      case CurrentRow::Rhs:
+        return GetLeftRowAttribute(rhs_row_, attr_idx);
+      case CurrentRow::Child:
+        break;
+    }
+  }
+  return OperatorTranslator::GetChildOutput(context, child_idx, attr_idx);
+}
+
+}  // namespace terrier::execution::compiler
@@ -0,0 +1,361 @@
+#include "execution/compiler/operator/sort_aggregation_translator.h"
+
+#include "execution/compiler/codegen.h"
+#include "execution/compiler/compilation_context.h"
+#include "execution/compiler/function_builder.h"
+#include "execution/compiler/if.h"
+#include "execution/compiler/loop.h"
+#include "execution/compiler/work_context.h"
+#include "planner/plannodes/aggregate_plan_node.h"
+
+namespace terrier::execution::compiler {
+
+namespace {
+constexpr char GROUP_BY_TERM_ATTR_PREFIX[] = "gb_term_attr";
+constexpr char AGGREGATE_TERM_ATTR_PREFIX[] = "agg_term_attr";
+}  // namespace
+
+SortAggregationTranslator::SortAggregationTranslator(const planner::AggregatePlanNode &plan,
+                                                     CompilationContext *compilation_context, Pipeline *pipeline)
+    : OperatorTranslator(plan, compilation_context, pipeline, brain::ExecutionOperatingUnitType::DUMMY),
+      agg_row_var_(GetCodeGen()->MakeFreshIdentifier("aggRow")),
+      agg_payload_type_(GetCodeGen()->MakeFreshIdentifier("AggPayload")),
+      agg_values_type_(GetCodeGen()->MakeFreshIdentifier("AggValues")),
+      key_check_fn_(GetCodeGen()->MakeFreshIdentifier(pipeline->CreatePipelineFunctionName("KeyCheck"))),
+      compare_fn_(GetCodeGen()->MakeFreshIdentifier(pipeline->CreatePipelineFunctionName("GroupCompare"))),
+      build_pipeline_(this, Pipeline::Parallelism::Serial) {
+  TERRIER_ASSERT(!plan.GetGroupByTerms().empty(), "Sort aggregation should have grouping keys");
+  TERRIER_ASSERT(plan.GetAggregateStrategyType() == planner::AggregateStrategyType::SORTED,
+                 "Expected sort-based aggregation plan node");
+  TERRIER_ASSERT(plan.GetChildrenSize() == 1, "Sort aggregations should only have one child");
+  // Groups are only contiguous if the sorted input is consumed in order.
+  build_pipeline_.UpdateParallelism(Pipeline::Parallelism::Serial);
+
+  // The produce pipeline begins after the build.
+  pipeline->LinkSourcePipeline(&build_pipeline_);
+
+  // Prepare the child.
+  compilation_context->Prepare(*plan.GetChild(0), &build_pipeline_);
+
+  // The groups are produced in input order, which must be maintained.
+  pipeline->RegisterSource(this, Pipeline::Parallelism::Serial);
+
+  // Prepare all grouping and aggregate expressions.
+  for (const auto group_by_term : plan.GetGroupByTerms()) {
+    compilation_context->Prepare(*group_by_term);
+  }
+  for (const auto agg_term : plan.GetAggregateTerms()) {
+    compilation_context->Prepare(*agg_term->GetChild(0));
+  }
+
+  // If there's a having clause, prepare it, too.
+  if (const auto having_clause = plan.GetHavingClausePredicate(); having_clause != nullptr) {
+    compilation_context->Prepare(*having_clause);
+  }
+
+  // Declare the group buffer and the pointer to the open group.
+  auto *codegen = GetCodeGen();
+  ast::Expr *sorter_type = codegen->BuiltinType(ast::BuiltinType::Sorter);
+  groups_ = compilation_context->GetQueryState()->DeclareStateEntry(codegen, "aggGroups", sorter_type);
+  current_group_ = compilation_context->GetQueryState()->DeclareStateEntry(codegen, "aggCurrentGroup",
+                                                                           codegen->PointerType(agg_payload_type_));
+
+  num_agg_inputs_ = CounterDeclare("num_agg_inputs");
+  num_agg_outputs_ = CounterDeclare("num_agg_outputs");
+}
+
+ast::StructDecl *SortAggregationTranslator::GeneratePayloadStruct() {
+  auto *codegen = GetCodeGen();
+  auto fields = codegen->MakeEmptyFieldList();
+  fields.reserve(GetAggPlan().GetGroupByTerms().size() + GetAggPlan().GetAggregateTerms().size());
+
+  // Create a field for every group by term.
+  uint32_t term_idx = 0;
+  for (const auto &term : GetAggPlan().GetGroupByTerms()) {
+    auto field_name = codegen->MakeIdentifier(GROUP_BY_TERM_ATTR_PREFIX + std::to_string(term_idx));
+    auto type = codegen->TplType(sql::GetTypeId(term->GetReturnValueType()));
+    fields.push_back(codegen->MakeField(field_name, type));
+    term_idx++;
+  }
+
+  // Create a field for every aggregate term.
+  term_idx = 0;
+  for (const auto &term : GetAggPlan().GetAggregateTerms()) {
+    auto field_name = codegen->MakeIdentifier(AGGREGATE_TERM_ATTR_PREFIX + std::to_string(term_idx));
+    auto type = codegen->AggregateType(term->GetExpressionType(), sql::GetTypeId(term->GetReturnValueType()));
+    fields.push_back(codegen->MakeField(field_name, type));
+    term_idx++;
+  }
+
+  struct_decl_ = codegen->DeclareStruct(agg_payload_type_, std::move(fields));
+  return struct_decl_;
+}
+
+ast::StructDecl *SortAggregationTranslator::GenerateInputValuesStruct() {
+  auto *codegen = GetCodeGen();
+  auto fields = codegen->MakeEmptyFieldList();
+  fields.reserve(GetAggPlan().GetGroupByTerms().size() + GetAggPlan().GetAggregateTerms().size());
+
+  // Create a field for every group by term.
+  uint32_t term_idx = 0;
+  for (const auto &term : GetAggPlan().GetGroupByTerms()) {
+    auto field_name = codegen->MakeIdentifier(GROUP_BY_TERM_ATTR_PREFIX + std::to_string(term_idx));
+    auto type = codegen->TplType(sql::GetTypeId(term->GetReturnValueType()));
+    fields.push_back(codegen->MakeField(field_name, type));
+    term_idx++;
+  }
+
+  // Create a field for every aggregate term.
+  term_idx = 0;
+  for (const auto &term : GetAggPlan().GetAggregateTerms()) {
+    auto field_name = codegen->MakeIdentifier(AGGREGATE_TERM_ATTR_PREFIX + std::to_string(term_idx));
+    auto type = codegen->TplType(sql::GetTypeId(term->GetChild(0)->GetReturnValueType()));
+    fields.push_back(codegen->MakeField(field_name, type));
+    term_idx++;
+  }
+
+  return codegen->DeclareStruct(agg_values_type_, std::move(fields));
+}
+
+void SortAggregationTranslator::DefineHelperStructs(util::RegionVector<ast::StructDecl *> *decls) {
+  decls->push_back(GeneratePayloadStruct());
+  decls->push_back(GenerateInputValuesStruct());
+}
+
+ast::FunctionDecl *SortAggregationTranslator::GenerateKeyCheckFunction() {
+  auto *codegen = GetCodeGen();
+  auto agg_payload = codegen->MakeIdentifier("aggPayload");
+  auto agg_values = codegen->MakeIdentifier("aggValues");
+  auto params = codegen->MakeFieldList({
+      codegen->MakeField(agg_payload, codegen->PointerType(agg_payload_type_)),
+      codegen->MakeField(agg_values, codegen->PointerType(agg_values_type_)),
+  });
+  auto ret_type = codegen->BuiltinType(ast::BuiltinType::Kind::Bool);
+  FunctionBuilder builder(codegen, key_check_fn_, std::move(params), ret_type);
+  {
+    for (uint32_t term_idx = 0; term_idx < GetAggPlan().GetGroupByTerms().size(); term_idx++) {
+      auto lhs = GetGroupByTerm(agg_payload, term_idx);
+      auto rhs = GetGroupByTerm(agg_values, term_idx);
+      // NULLs form a group of their own, so a NULL key never matches a non-NULL key.
+      auto lhs_null = codegen->CallBuiltin(ast::Builtin::IsValNull, {lhs});
+      auto rhs_null = codegen->CallBuiltin(ast::Builtin::IsValNull, {rhs});
+      If check_null(&builder, codegen->Compare(parsing::Token::Type::BANG_EQUAL, lhs_null, rhs_null));
+      builder.Append(codegen->Return(codegen->ConstBool(false)));
+      check_null.EndIf();
+      If check_match(&builder, codegen->Compare(parsing::Token::Type::BANG_EQUAL, GetGroupByTerm(agg_payload, term_idx),
+                                                GetGroupByTerm(agg_values, term_idx)));
+      builder.Append(codegen->Return(codegen->ConstBool(false)));
+    }
+    builder.Append(codegen->Return(codegen->ConstBool(true)));
+  }
+  return builder.Finish();
+}
+
+ast::FunctionDecl *SortAggregationTranslator::GenerateCompareFunction() {
+  // The group buffer is never sorted since groups are appended in order, but a sorter requires a
+  // comparison function. It orders groups on their keys, which is the order they're produced in.
+  auto *codegen = GetCodeGen();
+  auto lhs_row = codegen->MakeIdentifier("lhs");
+  auto rhs_row = codegen->MakeIdentifier("rhs");
+  auto params = codegen->MakeFieldList({
+      codegen->MakeField(lhs_row, codegen->PointerType(agg_payload_type_)),
+      codegen->MakeField(rhs_row, codegen->PointerType(agg_payload_type_)),
+  });
+  FunctionBuilder builder(codegen, compare_fn_, std::move(params), codegen->Int32Type());
+  {
+    for (uint32_t term_idx = 0; term_idx < GetAggPlan().GetGroupByTerms().size(); term_idx++) {
+      int32_t ret_value = -1;
+      for (const auto tok : {parsing::Token::Type::LESS, parsing::Token::Type::GREATER}) {
+        auto lhs = GetGroupByTerm(lhs_row, term_idx);
+        auto rhs = GetGroupByTerm(rhs_row, term_idx);
+        If check_comparison(&builder, codegen->Compare(tok, lhs, rhs));
+        builder.Append(codegen->Return(codegen->Const32(ret_value)));
+        check_comparison.EndIf();
+        ret_value = -ret_value;
+      }
+    }
+  }
+  return builder.Finish(codegen->Const32(0));
+}
+
+void SortAggregationTranslator::DefineHelperFunctions(util::RegionVector<ast::FunctionDecl *> *decls) {
+  decls->push_back(GenerateKeyCheckFunction());
+  decls->push_back(GenerateCompareFunction());
+}
+
+void SortAggregationTranslator::InitializeQueryState(FunctionBuilder *function) const {
+  auto *codegen = GetCodeGen();
+  function->Append(codegen->SorterInit(groups_.GetPtr(codegen), GetMemoryPool(), compare_fn_, agg_payload_type_));
+  function->Append(codegen->Assign(current_group_.Get(codegen), codegen->Nil()));
+
+  CounterSet(function, num_agg_inputs_, 0);
+  CounterSet(function, num_agg_outputs_, 0);
+}
+
+void SortAggregationTranslator::TearDownQueryState(FunctionBuilder *function) const {
+  function->Append(GetCodeGen()->SorterFree(groups_.GetPtr(GetCodeGen())));
+}
+
+ast::Expr *SortAggregationTranslator::GetGroupByTerm(ast::Identifier agg_row, uint32_t attr_idx) const {
+  auto *codegen = GetCodeGen();
+  auto member = codegen->MakeIdentifier(GROUP_BY_TERM_ATTR_PREFIX + std::to_string(attr_idx));
+  return codegen->AccessStructMember(codegen->MakeExpr(agg_row), member);
+}
+
+ast::Expr *SortAggregationTranslator::GetAggregateTerm(ast::Identifier agg_row, uint32_t attr_idx) const {
+  auto *codegen = GetCodeGen();
+  auto member = codegen->MakeIdentifier(AGGREGATE_TERM_ATTR_PREFIX + std::to_string(attr_idx));
+  return codegen->AccessStructMember(codegen->MakeExpr(agg_row), member);
+}
+
+ast::Expr *SortAggregationTranslator::GetAggregateTermPtr(ast::Identifier agg_row, uint32_t attr_idx) const {
+  return GetCodeGen()->AddressOf(GetAggregateTerm(agg_row, attr_idx));
+}
+
+ast::Identifier SortAggregationTranslator::FillInputValues(FunctionBuilder *function, WorkContext *ctx) const {
+  auto *codegen = GetCodeGen();
+
+  // var aggValues : AggValues
+  auto agg_values = codegen->MakeFreshIdentifier("aggValues");
+  function->Append(codegen->DeclareVarNoInit(agg_values, codegen->MakeExpr(agg_values_type_)));
+
+  // Populate the grouping terms.
+  uint32_t term_idx = 0;
+  for (const auto &term : GetAggPlan().GetGroupByTerms()) {
+    auto lhs = GetGroupByTerm(agg_values, term_idx);
+    auto rhs = ctx->DeriveValue(*term, this);
+    function->Append(codegen->Assign(lhs, rhs));
+    term_idx++;
+  }
+
+  // Populate the raw aggregate values.
+  term_idx = 0;
+  for (const auto &term : GetAggPlan().GetAggregateTerms()) {
+    auto lhs = GetAggregateTerm(agg_values, term_idx);
+    auto rhs = ctx->DeriveValue(*term->GetChild(0), this);
+    function->Append(codegen->Assign(lhs, rhs));
+    term_idx++;
+  }
+
+  return agg_values;
+}
+
+void SortAggregationTranslator::UpdateAggregates(WorkContext *context, FunctionBuilder *function) const {
+  auto *codegen = GetCodeGen();
+
+  auto agg_values = FillInputValues(function, context);
+
+  // var aggRow = state.aggCurrentGroup
+  function->Append(codegen->DeclareVarWithInit(agg_row_var_, current_group_.Get(codegen)));
+
+  // if (aggRow == nil or !keyCheck(aggRow, &aggValues)) { open a new group }
+  auto key_check = codegen->Call(key_check_fn_, {codegen->MakeExpr(agg_row_var_),
+                                                 codegen->AddressOf(codegen->MakeExpr(agg_values))});
+  auto new_group = codegen->BinaryOp(parsing::Token::Type::OR, codegen->IsNilPointer(codegen->MakeExpr(agg_row_var_)),
+                                     codegen->UnaryOp(parsing::Token::Type::BANG, key_check));
+  If check_new_group(function, new_group);
+  {
+    // aggRow = @ptrCast(*AggPayload, @sorterInsert(&state.aggGroups))
+    auto insert_call = codegen->SorterInsert(groups_.GetPtr(codegen), agg_payload_type_);
+    function->Append(codegen->Assign(codegen->MakeExpr(agg_row_var_), insert_call));
+    function->Append(codegen->Assign(current_group_.Get(codegen), codegen->MakeExpr(agg_row_var_)));
+
+    // Copy the grouping keys.
+    for (uint32_t term_idx = 0; term_idx < GetAggPlan().GetGroupByTerms().size(); term_idx++) {
+      auto lhs = GetGroupByTerm(agg_row_var_, term_idx);
+      auto rhs = GetGroupByTerm(agg_values, term_idx);
+      function->Append(codegen->Assign(lhs, rhs));
+    }
+
+    // Initialize all aggregate terms.
+    for (uint32_t term_idx = 0; term_idx < GetAggPlan().GetAggregateTerms().size(); term_idx++) {
+      function->Append(codegen->AggregatorInit(GetAggregateTermPtr(agg_row_var_, term_idx)));
+    }
+  }
+  check_new_group.EndIf();
+
+  // Advance the open group.
+  for (uint32_t term_idx = 0; term_idx < GetAggPlan().GetAggregateTerms().size(); term_idx++) {
+    auto agg = GetAggregateTermPtr(agg_row_var_, term_idx);
+    auto val = GetAggregateTermPtr(agg_values, term_idx);
+    function->Append(codegen->AggregatorAdvance(agg, val));
+  }
+
+  CounterAdd(function, num_agg_inputs_, 1);
+}
+
+void SortAggregationTranslator::ScanGroups(WorkContext *context, FunctionBuilder *function) const {
+  auto *codegen = GetCodeGen();
+
+  // var iterBase: SorterIterator
+  auto iter_base = codegen->MakeFreshIdentifier("iterBase");
+  function->Append(codegen->DeclareVarNoInit(iter_base, ast::BuiltinType::SorterIterator));
+
+  // var iter = &iterBase
+  auto iter_name = codegen->MakeFreshIdentifier("iter");
+  auto iter = codegen->MakeExpr(iter_name);
+  function->Append(codegen->DeclareVarWithInit(iter_name, codegen->AddressOf(codegen->MakeExpr(iter_base))));
+
+  Loop loop(function, codegen->MakeStmt(codegen->SorterIterInit(iter, groups_.GetPtr(codegen))),
+            codegen->SorterIterHasNext(iter), codegen->MakeStmt(codegen->SorterIterNext(iter)));
+  {
+    // var aggRow = @ptrCast(*AggPayload, @sorterIterGetRow(iter))
+    function->Append(codegen->DeclareVarWithInit(agg_row_var_, codegen->SorterIterGetRow(iter, agg_payload_type_)));
+
+    // Check having clause.
+    if (const auto having = GetAggPlan().GetHavingClausePredicate(); having != nullptr) {
+      If check_having(function, context->DeriveValue(*having, this));
+      context->Push(function);
+    } else {
+      context->Push(function);
+    }
+
+    CounterAdd(function, num_agg_outputs_, 1);
+  }
+  loop.EndLoop();
+
+  // @sorterIterClose(iter)
+  function->Append(codegen->SorterIterClose(iter));
+}
+
+void SortAggregationTranslator::PerformPipelineWork(WorkContext *context, FunctionBuilder *function) const {
+  if (IsBuildPipeline(context->GetPipeline())) {
+    UpdateAggregates(context, function);
+  } else {
+    TERRIER_ASSERT(IsProducePipeline(context->GetPipeline()), "Pipeline is unknown to sort aggregation translator");
+    ScanGroups(context, function);
+  }
+}
+
+void SortAggregationTranslator::FinishPipelineWork(const Pipeline &pipeline, FunctionBuilder *function) const {
+  auto *codegen = GetCodeGen();
+  auto num_groups = codegen->CallBuiltin(ast::Builtin::SorterGetTupleCount, {groups_.GetPtr(codegen)});
+
+  if (IsBuildPipeline(pipeline)) {
+    FeatureRecord(function, brain::ExecutionOperatingUnitType::AGGREGATE_BUILD,
+                  brain::ExecutionOperatingUnitFeatureAttribute::NUM_ROWS, pipeline, CounterVal(num_agg_inputs_));
+    FeatureRecord(function, brain::ExecutionOperatingUnitType::AGGREGATE_BUILD,
+                  brain::ExecutionOperatingUnitFeatureAttribute::CARDINALITY, pipeline, num_groups);
+    FeatureArithmeticRecordMul(function, pipeline, GetTranslatorId(), CounterVal(num_agg_inputs_));
+  } else {
+    FeatureRecord(function, brain::ExecutionOperatingUnitType::AGGREGATE_ITERATE,
+                  brain::ExecutionOperatingUnitFeatureAttribute::NUM_ROWS, pipeline, CounterVal(num_agg_outputs_));
+    FeatureRecord(function, brain::ExecutionOperatingUnitType::AGGREGATE_ITERATE,
+                  brain::ExecutionOperatingUnitFeatureAttribute::CARDINALITY, pipeline, num_groups);
+    FeatureArithmeticRecordMul(function, pipeline, GetTranslatorId(), CounterVal(num_agg_outputs_));
+  }
+}
+
+ast::Expr *SortAggregationTranslator::GetChildOutput(WorkContext *context, uint32_t child_idx,
+                                                     uint32_t attr_idx) const {
+  if (IsProducePipeline(context->GetPipeline())) {
+    if (child_idx == 0) {
+      return GetGroupByTerm(agg_row_var_, attr_idx);
+    }
+    return GetCodeGen()->AggregatorResult(GetAggregateTermPtr(agg_row_var_, attr_idx));
+  }
+  // The request is in the build pipeline. Forward to child translator.
+  return OperatorTranslator::GetChildOutput(context, child_idx, attr_idx);
+}
+
+}  // namespace terrier::execution::compiler
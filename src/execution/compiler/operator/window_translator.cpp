@@ -0,0 +1,470 @@
+#include "execution/compiler/operator/window_translator.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/error/exception.h"
+#include "execution/compiler/compilation_context.h"
+#include "execution/compiler/function_builder.h"
+#include "execution/compiler/if.h"
+#include "execution/compiler/loop.h"
+#include "execution/compiler/work_context.h"
+#include "planner/plannodes/window_plan_node.h"
+#include "spdlog/fmt/fmt.h"
+
+namespace terrier::execution::compiler {
+
+namespace {
+constexpr const char WINDOW_ROW_ATTR_PREFIX[] = "attr";
+constexpr const char WINDOW_ROW_ARG_PREFIX[] = "arg";
+constexpr const char WINDOW_ROW_RESULT_PREFIX[] = "res";
+
+sql::WindowFunction ToWindowFunction(const planner::WindowFunctionType type) {
+  switch (type) {
+    case planner::WindowFunctionType::ROW_NUMBER:
+      return sql::WindowFunction::RowNumber;
+    case planner::WindowFunctionType::RANK:
+      return sql::WindowFunction::Rank;
+    case planner::WindowFunctionType::DENSE_RANK:
+      return sql::WindowFunction::DenseRank;
+    case planner::WindowFunctionType::LAG:
+      return sql::WindowFunction::Lag;
+    case planner::WindowFunctionType::LEAD:
+      return sql::WindowFunction::Lead;
+    case planner::WindowFunctionType::COUNT_STAR:
+      return sql::WindowFunction::CountStar;
+    case planner::WindowFunctionType::COUNT:
+      return sql::WindowFunction::Count;
+    case planner::WindowFunctionType::SUM:
+      return sql::WindowFunction::Sum;
+    case planner::WindowFunctionType::MIN:
+      return sql::WindowFunction::Min;
+    case planner::WindowFunctionType::MAX:
+      return sql::WindowFunction::Max;
+    case planner::WindowFunctionType::AVG:
+      return sql::WindowFunction::Avg;
+    default:
+      UNREACHABLE("Invalid window function");
+  }
+}
+
+sql::WindowFrameBound ToWindowFrameBound(const planner::WindowFrameBoundType bound) {
+  switch (bound) {
+    case planner::WindowFrameBoundType::UNBOUNDED_PRECEDING:
+      return sql::WindowFrameBound::UnboundedPreceding;
+    case planner::WindowFrameBoundType::PRECEDING:
+      return sql::WindowFrameBound::Preceding;
+    case planner::WindowFrameBoundType::CURRENT_ROW:
+      return sql::WindowFrameBound::CurrentRow;
+    case planner::WindowFrameBoundType::FOLLOWING:
+      return sql::WindowFrameBound::Following;
+    case planner::WindowFrameBoundType::UNBOUNDED_FOLLOWING:
+      return sql::WindowFrameBound::UnboundedFollowing;
+  }
+  UNREACHABLE("Impossible frame bound");
+}
+
+bool IsNumeric(const sql::TypeId type) {
+  return type == sql::TypeId::TinyInt || type == sql::TypeId::SmallInt || type == sql::TypeId::Integer ||
+         type == sql::TypeId::BigInt || type == sql::TypeId::Float || type == sql::TypeId::Double;
+}
+}  // namespace
+
+WindowTranslator::WindowTranslator(const planner::WindowPlanNode &plan, CompilationContext *compilation_context,
+                                   Pipeline *pipeline)
+    : OperatorTranslator(plan, compilation_context, pipeline, brain::ExecutionOperatingUnitType::DUMMY),
+      row_var_(GetCodeGen()->MakeFreshIdentifier("windowRow")),
+      row_type_(GetCodeGen()->MakeFreshIdentifier("WindowRow")),
+      lhs_row_(GetCodeGen()->MakeIdentifier("lhs")),
+      rhs_row_(GetCodeGen()->MakeIdentifier("rhs")),
+      compare_func_(GetCodeGen()->MakeFreshIdentifier(pipeline->CreatePipelineFunctionName("WindowCompare"))),
+      same_partition_func_(GetCodeGen()->MakeFreshIdentifier(pipeline->CreatePipelineFunctionName("SamePartition"))),
+      same_peer_func_(GetCodeGen()->MakeFreshIdentifier(pipeline->CreatePipelineFunctionName("SamePeer"))),
+      build_pipeline_(this, Pipeline::Parallelism::Parallel),
+      current_row_(CurrentRow::Child) {
+  TERRIER_ASSERT(plan.GetChildrenSize() == 1, "Windows expected to have a single child.");
+  for (const auto &term : plan.GetWindowTerms()) {
+    CheckWindowTerm(term);
+  }
+
+  // Register this as the source for the pipeline. It must be serial to maintain sorted output order.
+  pipeline->RegisterSource(this, Pipeline::Parallelism::Serial);
+
+  // The build pipeline must complete before the produce pipeline.
+  pipeline->LinkSourcePipeline(&build_pipeline_);
+
+  // Prepare the child.
+  compilation_context->Prepare(*plan.GetChild(0), &build_pipeline_);
+
+  // Prepare the partitioning keys, ordering keys and function arguments.
+  for (const auto &term : plan.GetPartitionByTerms()) {
+    compilation_context->Prepare(*term);
+  }
+  for (const auto &[expr, _] : plan.GetSortKeys()) {
+    (void)_;
+    compilation_context->Prepare(*expr);
+  }
+  for (const auto &term : plan.GetWindowTerms()) {
+    if (term.argument_ != nullptr) {
+      compilation_context->Prepare(*term.argument_);
+    }
+  }
+
+  // Register the Sorter and WindowEvaluator instances in the global query state.
+  CodeGen *codegen = compilation_context->GetCodeGen();
+  ast::Expr *sorter_type = codegen->BuiltinType(ast::BuiltinType::Sorter);
+  global_sorter_ = compilation_context->GetQueryState()->DeclareStateEntry(codegen, "windowSorter", sorter_type);
+  evaluator_ = compilation_context->GetQueryState()->DeclareStateEntry(
+      codegen, "windowEvaluator", codegen->BuiltinType(ast::BuiltinType::WindowEvaluator));
+
+  // Register another Sorter instance in the pipeline-local state if the build pipeline is parallel.
+  if (build_pipeline_.IsParallel()) {
+    local_sorter_ = build_pipeline_.DeclarePipelineStateEntry("windowSorter", sorter_type);
+  }
+}
+
+void WindowTranslator::CheckWindowTerm(const planner::WindowTerm &term) {
+  if (term.type_ == planner::WindowFunctionType::INVALID) {
+    throw EXECUTION_EXCEPTION("Invalid window function", common::ErrorCode::ERRCODE_INTERNAL_ERROR);
+  }
+
+  const bool needs_argument = term.type_ != planner::WindowFunctionType::ROW_NUMBER &&
+                              term.type_ != planner::WindowFunctionType::RANK &&
+                              term.type_ != planner::WindowFunctionType::DENSE_RANK &&
+                              term.type_ != planner::WindowFunctionType::COUNT_STAR;
+  if (needs_argument != (term.argument_ != nullptr)) {
+    throw EXECUTION_EXCEPTION("Window function has the wrong number of arguments",
+                              common::ErrorCode::ERRCODE_INTERNAL_ERROR);
+  }
+
+  // SUM, MIN, MAX and AVG are only computed over numbers.
+  if (term.type_ == planner::WindowFunctionType::SUM || term.type_ == planner::WindowFunctionType::MIN ||
+      term.type_ == planner::WindowFunctionType::MAX || term.type_ == planner::WindowFunctionType::AVG) {
+    const auto arg_type = sql::GetTypeId(term.argument_->GetReturnValueType());
+    if (!IsNumeric(arg_type)) {
+      throw NOT_IMPLEMENTED_EXCEPTION(
+          fmt::format("Window SUM, MIN, MAX or AVG over values of type {}", sql::TypeIdToString(arg_type)));
+    }
+  }
+
+  if (term.offset_ < 0 || term.frame_start_offset_ < 0 || term.frame_end_offset_ < 0) {
+    throw EXECUTION_EXCEPTION("Window offsets must not be negative", common::ErrorCode::ERRCODE_INTERNAL_ERROR);
+  }
+
+  if (term.frame_start_ == planner::WindowFrameBoundType::UNBOUNDED_FOLLOWING ||
+      term.frame_end_ == planner::WindowFrameBoundType::UNBOUNDED_PRECEDING) {
+    throw EXECUTION_EXCEPTION("Invalid window frame", common::ErrorCode::ERRCODE_INTERNAL_ERROR);
+  }
+
+  // RANGE frames with offsets need arithmetic on the ordering key.
+  const auto has_offset = [](planner::WindowFrameBoundType bound) {
+    return bound == planner::WindowFrameBoundType::PRECEDING || bound == planner::WindowFrameBoundType::FOLLOWING;
+  };
+  if (term.frame_type_ == planner::WindowFrameType::RANGE &&
+      (has_offset(term.frame_start_) || has_offset(term.frame_end_))) {
+    throw NOT_IMPLEMENTED_EXCEPTION("RANGE window frames with PRECEDING or FOLLOWING offsets");
+  }
+}
+
+sql::TypeId WindowTranslator::GetResultType(const planner::WindowTerm &term) {
+  switch (term.type_) {
+    case planner::WindowFunctionType::ROW_NUMBER:
+    case planner::WindowFunctionType::RANK:
+    case planner::WindowFunctionType::DENSE_RANK:
+    case planner::WindowFunctionType::COUNT_STAR:
+    case planner::WindowFunctionType::COUNT:
+      return sql::TypeId::BigInt;
+    case planner::WindowFunctionType::AVG:
+      return sql::TypeId::Double;
+    default:
+      return sql::GetTypeId(term.argument_->GetReturnValueType());
+  }
+}
+
+void WindowTranslator::DefineHelperStructs(util::RegionVector<ast::StructDecl *> *decls) {
+  auto *codegen = GetCodeGen();
+  auto fields = codegen->MakeEmptyFieldList();
+  GetAllChildOutputFields(0, WINDOW_ROW_ATTR_PREFIX, &fields);
+  const auto &window_terms = GetPlanAs<planner::WindowPlanNode>().GetWindowTerms();
+  for (uint32_t term_idx = 0; term_idx < window_terms.size(); term_idx++) {
+    const auto &term = window_terms[term_idx];
+    if (term.argument_ != nullptr) {
+      auto field_name = codegen->MakeIdentifier(WINDOW_ROW_ARG_PREFIX + std::to_string(term_idx));
+      auto type = codegen->TplType(sql::GetTypeId(term.argument_->GetReturnValueType()));
+      fields.push_back(codegen->MakeField(field_name, type));
+    }
+    auto field_name = codegen->MakeIdentifier(WINDOW_ROW_RESULT_PREFIX + std::to_string(term_idx));
+    fields.push_back(codegen->MakeField(field_name, codegen->TplType(GetResultType(term))));
+  }
+  decls->push_back(codegen->DeclareStruct(row_type_, std::move(fields)));
+}
+
+ast::FunctionDecl *WindowTranslator::GenerateComparisonFunction() {
+  auto *codegen = GetCodeGen();
+  auto params = codegen->MakeFieldList({
+      codegen->MakeField(lhs_row_, codegen->PointerType(row_type_)),
+      codegen->MakeField(rhs_row_, codegen->PointerType(row_type_)),
+  });
+  FunctionBuilder builder(codegen, compare_func_, std::move(params), codegen->Int32Type());
+  {
+    // Rows are ordered on the partitioning keys, then on the ordering keys.
+    const auto &plan = GetPlanAs<planner::WindowPlanNode>();
+    std::vector<planner::SortKey> keys;
+    for (const auto &term : plan.GetPartitionByTerms()) {
+      keys.emplace_back(term, optimizer::OrderByOrderingType::ASC);
+    }
+    keys.insert(keys.end(), plan.GetSortKeys().begin(), plan.GetSortKeys().end());
+
+    WorkContext context(GetCompilationContext(), build_pipeline_);
+    context.SetExpressionCacheEnable(false);
+    const auto derive = [&](const parser::AbstractExpression &expr, CurrentRow row) {
+      current_row_ = row;
+      return context.DeriveValue(expr, this);
+    };
+    for (const auto &[expr, sort_order] : keys) {
+      const int32_t greater = sort_order == optimizer::OrderByOrderingType::ASC ? 1 : -1;
+
+      // As in Postgres, NULLs sort after all other values in ascending order and before them in descending order.
+      // They are peers of each other.
+      ast::Expr *lhs_null = codegen->CallBuiltin(ast::Builtin::IsValNull, {derive(*expr, CurrentRow::Lhs)});
+      ast::Expr *rhs_null = codegen->CallBuiltin(ast::Builtin::IsValNull, {derive(*expr, CurrentRow::Rhs)});
+      If check_null(&builder, codegen->Compare(parsing::Token::Type::BANG_EQUAL, lhs_null, rhs_null));
+      {
+        If check_lhs_null(&builder, codegen->CallBuiltin(ast::Builtin::IsValNull, {derive(*expr, CurrentRow::Lhs)}));
+        builder.Append(codegen->Return(codegen->Const32(greater)));
+        check_lhs_null.EndIf();
+        builder.Append(codegen->Return(codegen->Const32(-greater)));
+      }
+      check_null.EndIf();
+
+      int32_t ret_value = -greater;
+      for (const auto tok : {parsing::Token::Type::LESS, parsing::Token::Type::GREATER}) {
+        ast::Expr *lhs = derive(*expr, CurrentRow::Lhs);
+        ast::Expr *rhs = derive(*expr, CurrentRow::Rhs);
+        If check_comparison(&builder, codegen->Compare(tok, lhs, rhs));
+        builder.Append(codegen->Return(codegen->Const32(ret_value)));
+        check_comparison.EndIf();
+        ret_value = -ret_value;
+      }
+    }
+    current_row_ = CurrentRow::Child;
+  }
+  return builder.Finish(codegen->Const32(0));
+}
+
+ast::FunctionDecl *WindowTranslator::GenerateKeyEqualityFunction(
+    ast::Identifier name, const std::vector<common::ManagedPointer<parser::AbstractExpression>> &keys) {
+  auto *codegen = GetCodeGen();
+  auto params = codegen->MakeFieldList({
+      codegen->MakeField(lhs_row_, codegen->PointerType(row_type_)),
+      codegen->MakeField(rhs_row_, codegen->PointerType(row_type_)),
+  });
+  FunctionBuilder builder(codegen, name, std::move(params), codegen->BuiltinType(ast::BuiltinType::Kind::Bool));
+  {
+    WorkContext context(GetCompilationContext(), build_pipeline_);
+    context.SetExpressionCacheEnable(false);
+    const auto derive = [&](const parser::AbstractExpression &expr, CurrentRow row) {
+      current_row_ = row;
+      return context.DeriveValue(expr, this);
+    };
+    for (const auto &key : keys) {
+      // NULLs are equal to each other, and to nothing else.
+      ast::Expr *lhs_null = codegen->CallBuiltin(ast::Builtin::IsValNull, {derive(*key, CurrentRow::Lhs)});
+      ast::Expr *rhs_null = codegen->CallBuiltin(ast::Builtin::IsValNull, {derive(*key, CurrentRow::Rhs)});
+      If check_null(&builder, codegen->Compare(parsing::Token::Type::BANG_EQUAL, lhs_null, rhs_null));
+      builder.Append(codegen->Return(codegen->ConstBool(false)));
+      check_null.EndIf();
+
+      If check_match(&builder, codegen->Compare(parsing::Token::Type::BANG_EQUAL, derive(*key, CurrentRow::Lhs),
+                                                derive(*key, CurrentRow::Rhs)));
+      builder.Append(codegen->Return(codegen->ConstBool(false)));
+      check_match.EndIf();
+    }
+    current_row_ = CurrentRow::Child;
+  }
+  return builder.Finish(codegen->ConstBool(true));
+}
+
+void WindowTranslator::DefineHelperFunctions(util::RegionVector<ast::FunctionDecl *> *decls) {
+  const auto &plan = GetPlanAs<planner::WindowPlanNode>();
+  std::vector<common::ManagedPointer<parser::AbstractExpression>> sort_keys;
+  for (const auto &[expr, _] : plan.GetSortKeys()) {
+    (void)_;
+    sort_keys.push_back(expr);
+  }
+  decls->push_back(GenerateComparisonFunction());
+  decls->push_back(GenerateKeyEqualityFunction(same_partition_func_, plan.GetPartitionByTerms()));
+  decls->push_back(GenerateKeyEqualityFunction(same_peer_func_, sort_keys));
+}
+
+void WindowTranslator::InitializeSorter(FunctionBuilder *function, ast::Expr *sorter_ptr) const {
+  ast::Expr *mem_pool = GetMemoryPool();
+  function->Append(GetCodeGen()->SorterInit(sorter_ptr, mem_pool, compare_func_, row_type_));
+}
+
+void WindowTranslator::TearDownSorter(FunctionBuilder *function, ast::Expr *sorter_ptr) const {
+  function->Append(GetCodeGen()->SorterFree(sorter_ptr));
+}
+
+void WindowTranslator::InitializeQueryState(FunctionBuilder *function) const {
+  auto *codegen = GetCodeGen();
+  InitializeSorter(function, global_sorter_.GetPtr(codegen));
+
+  // Register every window function, and its frame, with the evaluator.
+  ast::Expr *evaluator_ptr = evaluator_.GetPtr(codegen);
+  function->Append(codegen->WindowInit(evaluator_ptr, same_partition_func_, same_peer_func_));
+  const auto &window_terms = GetPlanAs<planner::WindowPlanNode>().GetWindowTerms();
+  for (uint32_t term_idx = 0; term_idx < window_terms.size(); term_idx++) {
+    const auto &term = window_terms[term_idx];
+    sql::TypeId arg_type = sql::TypeId::BigInt;
+    ast::Expr *arg_offset = codegen->Const32(0);
+    if (term.argument_ != nullptr) {
+      arg_type = sql::GetTypeId(term.argument_->GetReturnValueType());
+      arg_offset =
+          codegen->OffsetOf(row_type_, codegen->MakeIdentifier(WINDOW_ROW_ARG_PREFIX + std::to_string(term_idx)));
+    }
+    ast::Expr *result_offset =
+        codegen->OffsetOf(row_type_, codegen->MakeIdentifier(WINDOW_ROW_RESULT_PREFIX + std::to_string(term_idx)));
+    function->Append(codegen->WindowAddFunction(evaluator_.GetPtr(codegen), ToWindowFunction(term.type_), arg_type,
+                                                arg_offset, result_offset, term.offset_));
+    if (term.IsAggregate()) {
+      const auto frame_type = term.frame_type_ == planner::WindowFrameType::ROWS ? sql::WindowFrameType::Rows
+                                                                                 : sql::WindowFrameType::Range;
+      function->Append(codegen->WindowSetFrame(evaluator_.GetPtr(codegen), frame_type,
+                                               ToWindowFrameBound(term.frame_start_), term.frame_start_offset_,
+                                               ToWindowFrameBound(term.frame_end_), term.frame_end_offset_));
+    }
+  }
+}
+
+void WindowTranslator::TearDownQueryState(FunctionBuilder *function) const {
+  auto *codegen = GetCodeGen();
+  function->Append(codegen->WindowFree(evaluator_.GetPtr(codegen)));
+  TearDownSorter(function, global_sorter_.GetPtr(codegen));
+}
+
+void WindowTranslator::InitializePipelineState(const Pipeline &pipeline, FunctionBuilder *function) const {
+  if (IsBuildPipeline(pipeline) && build_pipeline_.IsParallel()) {
+    InitializeSorter(function, local_sorter_.GetPtr(GetCodeGen()));
+  }
+}
+
+void WindowTranslator::TearDownPipelineState(const Pipeline &pipeline, FunctionBuilder *function) const {
+  if (IsBuildPipeline(pipeline) && build_pipeline_.IsParallel()) {
+    TearDownSorter(function, local_sorter_.GetPtr(GetCodeGen()));
+  }
+}
+
+ast::Expr *WindowTranslator::GetRowAttribute(ast::Identifier row, uint32_t attr_idx) const {
+  auto *codegen = GetCodeGen();
+  ast::Identifier attr_name = codegen->MakeIdentifier(WINDOW_ROW_ATTR_PREFIX + std::to_string(attr_idx));
+  return codegen->AccessStructMember(codegen->MakeExpr(row), attr_name);
+}
+
+ast::Expr *WindowTranslator::GetRowArgument(ast::Identifier row, uint32_t term_idx) const {
+  auto *codegen = GetCodeGen();
+  ast::Identifier arg_name = codegen->MakeIdentifier(WINDOW_ROW_ARG_PREFIX + std::to_string(term_idx));
+  return codegen->AccessStructMember(codegen->MakeExpr(row), arg_name);
+}
+
+ast::Expr *WindowTranslator::GetRowResult(ast::Identifier row, uint32_t term_idx) const {
+  auto *codegen = GetCodeGen();
+  ast::Identifier result_name = codegen->MakeIdentifier(WINDOW_ROW_RESULT_PREFIX + std::to_string(term_idx));
+  return codegen->AccessStructMember(codegen->MakeExpr(row), result_name);
+}
+
+void WindowTranslator::InsertIntoSorter(WorkContext *ctx, FunctionBuilder *function) const {
+  auto *codegen = GetCodeGen();
+
+  // Collect correct sorter instance.
+  const auto sorter = ctx->GetPipeline().IsParallel() ? local_sorter_ : global_sorter_;
+  function->Append(codegen->DeclareVarWithInit(row_var_, codegen->SorterInsert(sorter.GetPtr(codegen), row_type_)));
+
+  // Materialize the input columns and the function arguments. Results are filled in by the evaluator.
+  const auto child_schema = GetPlan().GetChild(0)->GetOutputSchema();
+  for (uint32_t attr_idx = 0; attr_idx < child_schema->GetColumns().size(); attr_idx++) {
+    function->Append(codegen->Assign(GetRowAttribute(row_var_, attr_idx), GetChildOutput(ctx, 0, attr_idx)));
+  }
+  const auto &window_terms = GetPlanAs<planner::WindowPlanNode>().GetWindowTerms();
+  for (uint32_t term_idx = 0; term_idx < window_terms.size(); term_idx++) {
+    if (const auto argument = window_terms[term_idx].argument_; argument != nullptr) {
+      function->Append(codegen->Assign(GetRowArgument(row_var_, term_idx), ctx->DeriveValue(*argument, this)));
+    }
+  }
+}
+
+void WindowTranslator::ScanSorter(WorkContext *ctx, FunctionBuilder *function) const {
+  auto *codegen = GetCodeGen();
+
+  // var iterBase: SorterIterator
+  auto base_iter_name = codegen->MakeFreshIdentifier("iterBase");
+  function->Append(codegen->DeclareVarNoInit(base_iter_name, ast::BuiltinType::SorterIterator));
+
+  // var iter = &iterBase
+  auto iter_name = codegen->MakeFreshIdentifier("iter");
+  auto iter = codegen->MakeExpr(iter_name);
+  function->Append(codegen->DeclareVarWithInit(iter_name, codegen->AddressOf(codegen->MakeExpr(base_iter_name))));
+
+  // Call @sorterIterInit().
+  function->Append(codegen->SorterIterInit(iter, global_sorter_.GetPtr(codegen)));
+
+  Loop loop(function, nullptr, codegen->SorterIterHasNext(iter), codegen->MakeStmt(codegen->SorterIterNext(iter)));
+  {
+    // var windowRow = @ptrCast(*WindowRow, @sorterIterGetRow(iter))
+    function->Append(codegen->DeclareVarWithInit(row_var_, codegen->SorterIterGetRow(iter, row_type_)));
+    // Move along
+    ctx->Push(function);
+  }
+  loop.EndLoop();
+
+  // @sorterIterClose()
+  function->Append(codegen->SorterIterClose(iter));
+}
+
+void WindowTranslator::PerformPipelineWork(WorkContext *ctx, FunctionBuilder *function) const {
+  if (IsScanPipeline(ctx->GetPipeline())) {
+    ScanSorter(ctx, function);
+  } else {
+    TERRIER_ASSERT(IsBuildPipeline(ctx->GetPipeline()), "Pipeline is unknown to window translator");
+    InsertIntoSorter(ctx, function);
+  }
+}
+
+void WindowTranslator::FinishPipelineWork(const Pipeline &pipeline, FunctionBuilder *function) const {
+  if (!IsBuildPipeline(pipeline)) {
+    return;
+  }
+
+  auto *codegen = GetCodeGen();
+  ast::Expr *sorter_ptr = global_sorter_.GetPtr(codegen);
+  if (build_pipeline_.IsParallel()) {
+    ast::Expr *offset = local_sorter_.OffsetFromState(codegen);
+    function->Append(codegen->SortParallel(sorter_ptr, GetThreadStateContainer(), offset));
+  } else {
+    function->Append(codegen->SorterSort(sorter_ptr));
+  }
+
+  // With the rows in order, compute the window functions.
+  function->Append(codegen->WindowEvaluate(evaluator_.GetPtr(codegen), global_sorter_.GetPtr(codegen)));
+}
+
+ast::Expr *WindowTranslator::GetChildOutput(WorkContext *context, uint32_t child_idx, uint32_t attr_idx) const {
+  if (IsScanPipeline(context->GetPipeline())) {
+    return child_idx == 0 ? GetRowAttribute(row_var_, attr_idx) : GetRowResult(row_var_, attr_idx);
+  }
+
+  TERRIER_ASSERT(IsBuildPipeline(context->GetPipeline()), "Pipeline not known to window");
+  switch (current_row_) {
+    case CurrentRow::Lhs:
+      return GetRowAttribute(lhs_row_, attr_idx);
+    case CurrentRow::Rhs:
+      return GetRowAttribute(rhs_row_, attr_idx);
+    case CurrentRow::Child: {
+      return OperatorTranslator::GetChildOutput(context, child_idx, attr_idx);
+    }
+  }
+  UNREACHABLE("Impossible output row option");
+}
+
+}  // namespace terrier::execution::compiler
@@ -4,6 +4,7 @@
 #include "common/thread_context.h"
 #include "execution/sql/value.h"
 #include "metrics/metrics_store.h"
+#include "metrics/query_trace.h"
 #include "parser/expression/constant_value_expression.h"
 
 namespace terrier::execution::exec {
@@ -44,6 +45,8 @@ void ExecutionContext::EndResourceTracker(const char *name, uint32_t len) {
 void ExecutionContext::StartPipelineTracker(pipeline_id_t pipeline_id) {
   constexpr metrics::MetricsComponent component = metrics::MetricsComponent::EXECUTION_PIPELINE;
 
+  if (query_trace_id_ != 0) pipeline_start_us_ = metrics::MetricsUtil::Now();
+
   if (common::thread_context.metrics_store_ != nullptr &&
       common::thread_context.metrics_store_->ComponentToRecord(component)) {
     // Start the resource tracker.
@@ -57,6 +60,11 @@ void ExecutionContext::StartPipelineTracker(pipeline_id_t pipeline_id) {
 }
 
 void ExecutionContext::EndPipelineTracker(query_id_t query_id, pipeline_id_t pipeline_id) {
+  if (query_trace_id_ != 0) {
+    metrics::QueryTrace::Record(metrics::TraceSpan::EXECUTE_PIPELINE, trace_connection_id_, query_trace_id_,
+                                pipeline_start_us_, pipeline_id.UnderlyingValue());
+  }
+
   if (common::thread_context.metrics_store_ != nullptr && common::thread_context.resource_tracker_.IsRunning()) {
     common::thread_context.resource_tracker_.Stop();
     auto mem_size = mem_tracker_->GetAllocatedSize();
@@ -2,11 +2,12 @@
 
 #include "execution/sql/value.h"
 #include "loggers/execution_logger.h"
+#include "network/network_io_wrapper.h"
 #include "network/postgres/postgres_packet_writer.h"
 
 namespace terrier::execution::exec {
 
-OutputBuffer::~OutputBuffer() { memory_pool_->Deallocate(tuples_, BATCH_SIZE * tuple_size_); }
+OutputBuffer::~OutputBuffer() { memory_pool_->Deallocate(tuples_, batch_size_ * tuple_size_); }
 
 void OutputBuffer::Finalize() {
   if (num_tuples_ > 0) {
@@ -101,10 +102,8 @@ void OutputPrinter::operator()(byte *tuples, uint32_t num_tuples, uint32_t tuple
 
 void OutputWriter::operator()(byte *tuples, uint32_t num_tuples, uint32_t tuple_size) {
   // Write out the rows for this batch
-  for (uint32_t row = 0; row < num_tuples; row++) {
-    const byte *const tuple = tuples + row * tuple_size;
-    out_->WriteDataRow(tuple, schema_->GetColumns(), field_formats_);
-    num_rows_++;
-  }
+  out_->WriteDataRows(tuples, num_tuples, tuple_size, schema_->GetColumns(), field_formats_);
+  num_rows_ += num_tuples;
+  if (transport_ != nullptr) transport_->ApplyBackPressure();
 }
 }  // namespace terrier::execution::exec
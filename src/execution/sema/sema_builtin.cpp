@@ -2144,6 +2144,105 @@ void Sema::CheckBuiltinSorterIterCall(ast::CallExpr *call, ast::Builtin builtin)
   }
 }
 
+void Sema::CheckBuiltinWindowEvaluatorCall(ast::CallExpr *call, ast::Builtin builtin) {
+  if (!CheckArgCountAtLeast(call, 1)) {
+    return;
+  }
+
+  const auto &args = call->Arguments();
+
+  // First argument must be a pointer to a WindowEvaluator
+  const auto window_kind = ast::BuiltinType::WindowEvaluator;
+  if (!IsPointerToSpecificBuiltin(args[0]->GetType(), window_kind)) {
+    ReportIncorrectCallArg(call, 0, GetBuiltinType(window_kind)->PointerTo());
+    return;
+  }
+
+  // Coerce the integer argument at the given position to the given type
+  const auto check_integer_arg = [&](uint32_t idx, ast::BuiltinType::Kind kind) {
+    ast::Type *int_type = GetBuiltinType(kind);
+    if (!call->Arguments()[idx]->GetType()->IsIntegerType()) {
+      ReportIncorrectCallArg(call, idx, int_type);
+      return false;
+    }
+    if (call->Arguments()[idx]->GetType() != int_type) {
+      call->SetArgument(idx, ImplCastExprToType(call->Arguments()[idx], int_type, ast::CastKind::IntegralCast));
+    }
+    return true;
+  };
+
+  switch (builtin) {
+    case ast::Builtin::WindowEvaluatorInit: {
+      if (!CheckArgCount(call, 3)) {
+        return;
+      }
+      // Second and third arguments are the partition and peer equality functions
+      for (uint32_t idx = 1; idx < 3; idx++) {
+        auto *const eq_type = args[idx]->GetType()->SafeAs<ast::FunctionType>();
+        if (eq_type == nullptr || eq_type->GetNumParams() != 2 ||
+            !eq_type->GetReturnType()->IsSpecificBuiltin(ast::BuiltinType::Bool) ||
+            !eq_type->GetParams()[0].type_->IsPointerType() || !eq_type->GetParams()[1].type_->IsPointerType()) {
+          GetErrorReporter()->Report(call->Position(), ErrorMessages::kBadKeyEqualityFunctionForWindow,
+                                     args[idx]->GetType());
+          return;
+        }
+      }
+      break;
+    }
+    case ast::Builtin::WindowEvaluatorAddFunction: {
+      // (function, type, argument offset, result offset, LAG/LEAD offset)
+      if (!CheckArgCount(call, 6)) {
+        return;
+      }
+      for (uint32_t idx = 1; idx < 5; idx++) {
+        if (!check_integer_arg(idx, ast::BuiltinType::Uint32)) {
+          return;
+        }
+      }
+      if (!check_integer_arg(5, ast::BuiltinType::Int64)) {
+        return;
+      }
+      break;
+    }
+    case ast::Builtin::WindowEvaluatorSetFrame: {
+      // (frame type, start, start offset, end, end offset)
+      if (!CheckArgCount(call, 6)) {
+        return;
+      }
+      if (!check_integer_arg(1, ast::BuiltinType::Uint32) || !check_integer_arg(2, ast::BuiltinType::Uint32) ||
+          !check_integer_arg(3, ast::BuiltinType::Int64) || !check_integer_arg(4, ast::BuiltinType::Uint32) ||
+          !check_integer_arg(5, ast::BuiltinType::Int64)) {
+        return;
+      }
+      break;
+    }
+    case ast::Builtin::WindowEvaluatorEvaluate: {
+      if (!CheckArgCount(call, 2)) {
+        return;
+      }
+      // The second argument is the sorted input
+      const auto sorter_kind = ast::BuiltinType::Sorter;
+      if (!IsPointerToSpecificBuiltin(args[1]->GetType(), sorter_kind)) {
+        ReportIncorrectCallArg(call, 1, GetBuiltinType(sorter_kind)->PointerTo());
+        return;
+      }
+      break;
+    }
+    case ast::Builtin::WindowEvaluatorFree: {
+      if (!CheckArgCount(call, 1)) {
+        return;
+      }
+      break;
+    }
+    default: {
+      UNREACHABLE("Impossible window evaluator call");
+    }
+  }
+
+  // All window evaluator calls return nothing
+  call->SetType(GetBuiltinType(ast::BuiltinType::Nil));
+}
+
 void Sema::CheckBuiltinIndexIteratorInit(execution::ast::CallExpr *call, ast::Builtin builtin) {
   // First argument must be a pointer to a IndexIterator
   const auto index_kind = ast::BuiltinType::IndexIterator;
@@ -3313,6 +3412,14 @@ void Sema::CheckBuiltinCall(ast::CallExpr *call) {
       CheckBuiltinSorterIterCall(call, builtin);
       break;
     }
+    case ast::Builtin::WindowEvaluatorInit:
+    case ast::Builtin::WindowEvaluatorAddFunction:
+    case ast::Builtin::WindowEvaluatorSetFrame:
+    case ast::Builtin::WindowEvaluatorEvaluate:
+    case ast::Builtin::WindowEvaluatorFree: {
+      CheckBuiltinWindowEvaluatorCall(call, builtin);
+      break;
+    }
     case ast::Builtin::ResultBufferAllocOutRow:
     case ast::Builtin::ResultBufferFinalize: {
       CheckResultBufferCall(call, builtin);
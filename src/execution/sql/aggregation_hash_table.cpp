@@ -1,7 +1,5 @@
 #include "execution/sql/aggregation_hash_table.h"
 
-#include <tbb/parallel_for_each.h>
-
 #include <algorithm>
 #include <memory>
 #include <numeric>
@@ -18,6 +16,7 @@
 #include "execution/sql/vector_projection_iterator.h"
 #include "execution/util/bit_util.h"
 #include "execution/util/cpu_info.h"
+#include "execution/util/morsel_scheduler.h"
 #include "execution/util/timer.h"
 #include "libcount/hll.h"
 #include "loggers/execution_logger.h"
@@ -658,7 +657,7 @@ void AggregationHashTable::ExecuteParallelPartitionedScan(void *query_state, Thr
   util::Timer<std::milli> timer;
   timer.Start();
 
-  tbb::parallel_for_each(nonempty_parts, [&](const uint32_t part_idx) {
+  util::MorselScheduler::Instance()->ParallelForEach(nonempty_parts, [&](const uint32_t part_idx) {
     // Build a hash table over the given partition
     auto agg_table_partition = GetOrBuildTableOverPartition(query_state, part_idx);
 
@@ -694,8 +693,8 @@ void AggregationHashTable::BuildAllPartitions(void *query_state) {
   }
 
   // For each valid partition, build a hash table over its contents.
-  tbb::parallel_for_each(nonempty_parts,
-                         [&](const uint32_t part_idx) { GetOrBuildTableOverPartition(query_state, part_idx); });
+  util::MorselScheduler::Instance()->ParallelForEach(
+      nonempty_parts, [&](const uint32_t part_idx) { GetOrBuildTableOverPartition(query_state, part_idx); });
 }
 
 void AggregationHashTable::Repartition() {
@@ -709,7 +708,8 @@ void AggregationHashTable::Repartition() {
   }
 
   // First, flush all hash table partitions to their own overflow buckets.
-  tbb::parallel_for_each(nonempty_tables, [&](auto table) { table->FlushToOverflowPartitions(); });
+  util::MorselScheduler::Instance()->ParallelForEach(nonempty_tables,
+                                                     [&](auto table) { table->FlushToOverflowPartitions(); });
 
   // Now, transfer each hash table partition's overflow buckets to us.
   for (auto *table : nonempty_tables) {
@@ -744,7 +744,7 @@ void AggregationHashTable::MergePartitions(AggregationHashTable *target, void *q
   }
 
   // Merge overflow data into the appropriate partitioned table in the target.
-  tbb::parallel_for_each(nonempty_parts, [&](const uint32_t part_idx) {
+  util::MorselScheduler::Instance()->ParallelForEach(nonempty_parts, [&](const uint32_t part_idx) {
     // Get the partitioned hash table from the target.
     auto agg_table_partition = target->GetOrBuildTableOverPartition(query_state, part_idx);
 
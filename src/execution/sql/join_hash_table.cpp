@@ -1,7 +1,6 @@
 #include "execution/sql/join_hash_table.h"
 
 #include <llvm/ADT/STLExtras.h>
-#include <tbb/parallel_for_each.h>
 
 #include <algorithm>
 #include <limits>
@@ -14,6 +13,7 @@
 #include "execution/sql/vector_operations/unary_operation_executor.h"
 #include "execution/util/cpu_info.h"
 #include "execution/util/memory.h"
+#include "execution/util/morsel_scheduler.h"
 #include "execution/util/timer.h"
 #include "libcount/hll.h"
 #include "loggers/execution_logger.h"
@@ -578,7 +578,8 @@ void JoinHashTable::MergeParallel(const ThreadStateContainer *thread_state_conta
   } else {
     EXECUTION_LOG_TRACE("JHT: Estimated {} elements >= {} element parallel threshold. Using parallel merge.",
                         num_elem_estimate, DEFAULT_MIN_SIZE_FOR_PARALLEL_MERGE);
-    tbb::parallel_for_each(tl_join_tables, [this](auto source) { MergeIncomplete<true>(source); });
+    util::MorselScheduler::Instance()->ParallelForEach(tl_join_tables,
+                                                       [this](auto source) { MergeIncomplete<true>(source); });
   }
 
   timer.Stop();
@@ -1,6 +1,12 @@
 #include "execution/sql/operators/like_operators.h"
 
+#include <immintrin.h>
+
+#include <algorithm>
+#include <cstring>
+
 #include "common/macros.h"
+#include "execution/util/bit_util.h"
 
 namespace terrier::execution::sql {
 
@@ -48,12 +54,10 @@ bool Like::Impl(const char *str, size_t str_len, const char *pattern, size_t pat
         return true;
       }
 
-      if (*p == escape) {
-        NextByte(p, plen);
-        TERRIER_ASSERT(*p != 0, "LIKE pattern must not end with an escape character");
-        if (plen == 0) {
-          return false;
-        }
+      // A pattern ending in an escape character never matches. Otherwise, the escape is left in place so that the
+      // recursive call below matches the escaped character literally.
+      if (*p == escape && plen == 1) {
+        return false;
       }
 
       while (slen > 0) {
@@ -81,4 +85,216 @@ bool Like::Impl(const char *str, size_t str_len, const char *pattern, size_t pat
   return slen == 0 && plen == 0;
 }
 
+#undef NextByte
+
+namespace {
+
+// Find the leftmost occurrence of the needle in the haystack, or nullptr if there is none.
+const char *FindLiteral(const char *haystack, std::size_t haystack_len, const char *needle, std::size_t needle_len) {
+  if (needle_len == 0) {
+    return haystack;
+  }
+  if (haystack_len < needle_len) {
+    return nullptr;
+  }
+  if (needle_len == 1) {
+    return static_cast<const char *>(std::memchr(haystack, needle[0], haystack_len));
+  }
+
+  // The last position the needle can start at.
+  const std::size_t last = haystack_len - needle_len;
+  std::size_t i = 0;
+
+#if defined(__AVX2__)
+  // Compare 32 candidate positions at a time against the first and last character of the needle, and only compare the
+  // remaining characters at positions where both match.
+  const __m256i first = _mm256_set1_epi8(needle[0]);
+  const __m256i final = _mm256_set1_epi8(needle[needle_len - 1]);
+  for (; i + 32 <= last + 1; i += 32) {
+    const auto block_first = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(haystack + i));
+    const auto block_final = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(haystack + i + needle_len - 1));
+    const auto eq = _mm256_and_si256(_mm256_cmpeq_epi8(first, block_first), _mm256_cmpeq_epi8(final, block_final));
+    auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(eq));
+    while (mask != 0) {
+      const auto pos = i + util::BitUtil::CountTrailingZeros(mask);
+      if (std::memcmp(haystack + pos + 1, needle + 1, needle_len - 2) == 0) {
+        return haystack + pos;
+      }
+      mask &= mask - 1;
+    }
+  }
+#endif
+
+  // Use memchr() to skip to candidate positions in whatever remains.
+  while (i <= last) {
+    const auto *candidate = static_cast<const char *>(std::memchr(haystack + i, needle[0], last - i + 1));
+    if (candidate == nullptr) {
+      return nullptr;
+    }
+    if (std::memcmp(candidate + 1, needle + 1, needle_len - 1) == 0) {
+      return candidate;
+    }
+    i = candidate - haystack + 1;
+  }
+  return nullptr;
+}
+
+}  // namespace
+
+LikePattern::LikePattern(const char *pattern, std::size_t pattern_len, char escape)
+    : kind_(Kind::General),
+      pattern_(pattern, pattern_len),
+      escape_(escape),
+      anchored_start_(true),
+      anchored_end_(true),
+      min_len_(0),
+      prefix_bytes_(0),
+      prefix_mask_(0) {
+  // Patterns whose escape character is a wildcard are ambiguous. Leave them to the general matcher.
+  if (escape == '%' || escape == '_') {
+    return;
+  }
+
+  // Split the pattern on '%'. Empty segments between consecutive '%' are dropped.
+  bool has_wildcard = false;
+  Segment segment;
+  for (std::size_t i = 0; i < pattern_len; i++) {
+    char c = pattern[i];
+    if (c == '%') {
+      has_wildcard = true;
+      anchored_start_ = anchored_start_ && i != 0;
+      anchored_end_ = false;
+      if (!segment.chars_.empty()) {
+        segments_.emplace_back(std::move(segment));
+        segment = Segment();
+      }
+      continue;
+    }
+    anchored_end_ = true;
+    if (c == escape) {
+      if (++i == pattern_len) {
+        // A pattern ending in an escape never matches. Leave it to the general matcher.
+        segments_.clear();
+        return;
+      }
+      c = pattern[i];
+      segment.chars_.push_back(c);
+      segment.any_.push_back(false);
+    } else {
+      segment.chars_.push_back(c);
+      segment.any_.push_back(c == '_');
+      segment.has_any_ |= c == '_';
+    }
+  }
+  if (!segment.chars_.empty() || !has_wildcard) {
+    segments_.emplace_back(std::move(segment));
+  }
+
+  for (const auto &seg : segments_) {
+    min_len_ += seg.chars_.size();
+  }
+
+  // Classify.
+  if (!has_wildcard) {
+    kind_ = Kind::Exact;
+  } else if (segments_.empty()) {
+    kind_ = Kind::Contains;
+  } else if (segments_.size() == 1) {
+    if (anchored_start_) {
+      kind_ = Kind::Prefix;
+    } else if (anchored_end_) {
+      kind_ = Kind::Suffix;
+    } else {
+      kind_ = Kind::Contains;
+    }
+  } else {
+    kind_ = Kind::MultiContains;
+  }
+
+  // Collect the leading literal characters of an anchored pattern to check against the prefix of VarlenEntry values.
+  if (anchored_start_ && !segments_.empty()) {
+    const auto &first = segments_.front();
+    const auto n = std::min<std::size_t>(first.chars_.size(), storage::VarlenEntry::PrefixSize());
+    auto *bytes = reinterpret_cast<uint8_t *>(&prefix_bytes_);
+    auto *mask = reinterpret_cast<uint8_t *>(&prefix_mask_);
+    for (std::size_t i = 0; i < n && !first.any_[i]; i++) {
+      bytes[i] = static_cast<uint8_t>(first.chars_[i]);
+      mask[i] = 0xff;
+    }
+  }
+}
+
+bool LikePattern::MatchAt(const Segment &segment, const char *str) {
+  if (!segment.has_any_) {
+    return std::memcmp(str, segment.chars_.data(), segment.chars_.size()) == 0;
+  }
+  for (std::size_t i = 0; i < segment.chars_.size(); i++) {
+    if (!segment.any_[i] && str[i] != segment.chars_[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+const char *LikePattern::Find(const Segment &segment, const char *str, std::size_t str_len) {
+  const auto len = segment.chars_.size();
+  if (!segment.has_any_) {
+    return FindLiteral(str, str_len, segment.chars_.data(), len);
+  }
+  for (std::size_t i = 0; i + len <= str_len; i++) {
+    if (MatchAt(segment, str + i)) {
+      return str + i;
+    }
+  }
+  return nullptr;
+}
+
+bool LikePattern::Matches(const char *str, std::size_t str_len) const {
+  if (str_len < min_len_) {
+    return false;
+  }
+
+  switch (kind_) {
+    case Kind::Exact:
+      return str_len == min_len_ && MatchAt(segments_[0], str);
+    case Kind::Prefix:
+      return MatchAt(segments_[0], str);
+    case Kind::Suffix:
+      return MatchAt(segments_[0], str + str_len - min_len_);
+    case Kind::Contains:
+      return segments_.empty() || Find(segments_[0], str, str_len) != nullptr;
+    case Kind::MultiContains: {
+      // The anchored segments are pinned to either end. Since the string is at least as long as all segments
+      // combined, they cannot overlap. The remaining segments are placed at their leftmost match between them.
+      auto begin = segments_.begin(), end = segments_.end();
+      const char *s = str, *s_end = str + str_len;
+      if (anchored_start_) {
+        if (!MatchAt(*begin, s)) {
+          return false;
+        }
+        s += begin->chars_.size();
+        ++begin;
+      }
+      if (anchored_end_) {
+        --end;
+        s_end -= end->chars_.size();
+        if (!MatchAt(*end, s_end)) {
+          return false;
+        }
+      }
+      for (; begin != end; ++begin) {
+        const char *pos = Find(*begin, s, s_end - s);
+        if (pos == nullptr) {
+          return false;
+        }
+        s = pos + begin->chars_.size();
+      }
+      return true;
+    }
+    case Kind::General:
+      return Like::Impl(str, str_len, pattern_.data(), pattern_.size(), escape_);
+  }
+  UNREACHABLE("Impossible LIKE pattern kind");
+}
+
 }  // namespace terrier::execution::sql
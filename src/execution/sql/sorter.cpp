@@ -1,8 +1,6 @@
 #include "execution/sql/sorter.h"
 
 #include <llvm/ADT/STLExtras.h>
-#include <tbb/parallel_for_each.h>
-#include <tbb/task_scheduler_init.h>
 
 #include <algorithm>
 #include <queue>
@@ -10,6 +8,7 @@
 #include <vector>
 
 #include "execution/sql/thread_state_container.h"
+#include "execution/util/morsel_scheduler.h"
 #include "execution/util/stage_timer.h"
 #include "ips4o/ips4o.hpp"
 #include "loggers/execution_logger.h"
@@ -211,8 +210,7 @@ void Sorter::SortParallel(const ThreadStateContainer *thread_state_container, co
   util::StageTimer<std::milli> timer;
   timer.EnterStage("Parallel Sort Thread-Local Instances");
 
-  tbb::task_scheduler_init sched;
-  tbb::parallel_for_each(tl_sorters, [](Sorter *sorter) { sorter->Sort(); });
+  util::MorselScheduler::Instance()->ParallelForEach(tl_sorters, [](Sorter *sorter) { sorter->Sort(); });
 
   timer.ExitStage();
 
@@ -318,7 +316,7 @@ void Sorter::SortParallel(const ThreadStateContainer *thread_state_container, co
     return cmp_fn_(*l.first, *r.first) >= 0;
   };
 
-  tbb::parallel_for_each(merge_work, [&heap_cmp](const MergeWork<SeqTypeIter> &work) {
+  util::MorselScheduler::Instance()->ParallelForEach(merge_work, [&heap_cmp](const MergeWork<SeqTypeIter> &work) {
     std::priority_queue<MergeWorkType::Range, std::vector<MergeWorkType::Range>, decltype(heap_cmp)> heap(
         heap_cmp, work.input_ranges_);
     SeqTypeIter dest = work.destination_;
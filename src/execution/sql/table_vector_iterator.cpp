@@ -1,9 +1,6 @@
 #include "execution/sql/table_vector_iterator.h"
 
-#include <tbb/parallel_for.h>
-#include <tbb/partitioner.h>
-#include <tbb/task_arena.h>
-
+#include <algorithm>
 #include <limits>
 #include <numeric>
 #include <utility>
@@ -13,6 +10,7 @@
 #include "execution/exec/execution_context.h"
 #include "execution/exec/execution_settings.h"
 #include "execution/sql/thread_state_container.h"
+#include "execution/util/morsel_scheduler.h"
 #include "execution/util/timer.h"
 #include "loggers/execution_logger.h"
 
@@ -82,48 +80,6 @@ bool TableVectorIterator::Advance() {
   return true;
 }
 
-namespace {
-
-class ScanTask {
- public:
-  ScanTask(uint32_t table_oid, uint32_t *col_oids, uint32_t num_oids, void *const query_state,
-           exec::ExecutionContext *exec_ctx, TableVectorIterator::ScanFn scanner)
-      : exec_ctx_(exec_ctx),
-        table_oid_(table_oid),
-        col_oids_(col_oids),
-        num_oids_(num_oids),
-        query_state_(query_state),
-        thread_state_container_(exec_ctx->GetThreadStateContainer()),
-        scanner_(scanner) {}
-
-  void operator()(const tbb::blocked_range<uint32_t> &block_range) const {
-    // Create the iterator over the specified block range
-    TableVectorIterator iter{exec_ctx_, table_oid_, col_oids_, num_oids_};
-
-    // Initialize it
-    if (!iter.Init(block_range.begin(), block_range.end())) {
-      return;
-    }
-
-    // Pull out the thread-local state
-    byte *const thread_state = thread_state_container_->AccessCurrentThreadState();
-
-    // Call scanning function
-    scanner_(query_state_, thread_state, &iter);
-  }
-
- private:
-  exec::ExecutionContext *exec_ctx_;
-  uint32_t table_oid_;
-  uint32_t *col_oids_;
-  uint32_t num_oids_;
-  void *const query_state_;
-  ThreadStateContainer *const thread_state_container_;
-  TableVectorIterator::ScanFn scanner_;
-};
-
-}  // namespace
-
 bool TableVectorIterator::ParallelScan(uint32_t table_oid, uint32_t *col_oids, uint32_t num_oids,
                                        void *const query_state, exec::ExecutionContext *exec_ctx,
                                        const TableVectorIterator::ScanFn scan_fn, const uint32_t min_grain_size) {
@@ -137,17 +93,27 @@ bool TableVectorIterator::ParallelScan(uint32_t table_oid, uint32_t *col_oids, u
   util::Timer<std::milli> timer;
   timer.Start();
 
-  const int num_threads = exec_ctx->GetExecutionSettings().GetNumberofThreads();
-  const bool is_static_partitioned = exec_ctx->GetExecutionSettings().GetIsStaticPartitionerEnabled();
-  tbb::task_arena limited_arena(num_threads);
-  tbb::blocked_range<uint32_t> block_range(0, table->table_.data_table_->GetNumBlocks(), min_grain_size);
-
-  limited_arena.execute(
-      [&block_range, &table_oid, &col_oids, &num_oids, &query_state, &exec_ctx, &scan_fn, is_static_partitioned] {
-        is_static_partitioned
-            ? tbb::parallel_for(block_range, ScanTask(table_oid, col_oids, num_oids, query_state, exec_ctx, scan_fn),
-                                tbb::static_partitioner())
-            : tbb::parallel_for(block_range, ScanTask(table_oid, col_oids, num_oids, query_state, exec_ctx, scan_fn));
+  // Each morsel is a range of blocks that is scanned by its own iterator into the thread-local state of the thread
+  // that claimed it. Morsels are dispatched through the process-wide scheduler shared by all running queries.
+  const auto &settings = exec_ctx->GetExecutionSettings();
+  ThreadStateContainer *const thread_state_container = exec_ctx->GetThreadStateContainer();
+  util::MorselScheduler::Instance()->ParallelFor(
+      0, table->table_.data_table_->GetNumBlocks(), std::max(min_grain_size, 1u), settings.GetNumberofThreads(),
+      settings.GetQueryPriority(), !settings.GetIsStaticPartitionerEnabled(),
+      [&](const uint32_t block_start, const uint32_t block_end) {
+        // Create the iterator over the specified block range
+        TableVectorIterator iter{exec_ctx, table_oid, col_oids, num_oids};
+
+        // Initialize it
+        if (!iter.Init(block_start, block_end)) {
+          return;
+        }
+
+        // Pull out the thread-local state
+        byte *const thread_state = thread_state_container->AccessCurrentThreadState();
+
+        // Call scanning function
+        scan_fn(query_state, thread_state, &iter);
       });
 
   timer.Stop();
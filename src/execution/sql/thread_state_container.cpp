@@ -1,13 +1,13 @@
 #include "execution/sql/thread_state_container.h"
 
 #include <tbb/enumerable_thread_specific.h>
-#include <tbb/parallel_for_each.h>
 
 #include <memory>
 #include <vector>
 
 #include "common/constants.h"
 #include "execution/exec/execution_settings.h"
+#include "execution/util/morsel_scheduler.h"
 
 namespace terrier::execution::sql {
 
@@ -111,7 +111,9 @@ void ThreadStateContainer::IterateStates(void *const ctx, ThreadStateContainer::
 }
 
 void ThreadStateContainer::IterateStatesParallel(void *const ctx, ThreadStateContainer::IterateFn iterate_fn) const {
-  tbb::parallel_for_each(impl_->states_, [&](auto &tls_handle) { iterate_fn(ctx, tls_handle.State()); });
+  std::vector<byte *> states;
+  CollectThreadLocalStates(&states);
+  util::MorselScheduler::Instance()->ParallelForEach(states, [&](byte *state) { iterate_fn(ctx, state); });
 }
 
 uint32_t ThreadStateContainer::GetThreadStateCount() const { return impl_->states_.size(); }
@@ -0,0 +1,395 @@
+#include "execution/sql/window_evaluator.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "execution/sql/sorter.h"
+#include "execution/sql/value.h"
+#include "execution/util/morsel_scheduler.h"
+#include "execution/util/timer.h"
+#include "loggers/execution_logger.h"
+
+namespace terrier::execution::sql {
+
+namespace {
+
+// The size of a SQL value of the given type.
+std::size_t ValueSize(const TypeId type) {
+  switch (type) {
+    case TypeId::Boolean:
+      return sizeof(BoolVal);
+    case TypeId::TinyInt:
+    case TypeId::SmallInt:
+    case TypeId::Integer:
+    case TypeId::BigInt:
+      return sizeof(Integer);
+    case TypeId::Float:
+    case TypeId::Double:
+      return sizeof(Real);
+    case TypeId::Date:
+      return sizeof(DateVal);
+    case TypeId::Timestamp:
+      return sizeof(TimestampVal);
+    case TypeId::Varchar:
+    case TypeId::Varbinary:
+      return sizeof(StringVal);
+    case TypeId::FixedDecimal:
+      return sizeof(DecimalVal);
+    default:
+      UNREACHABLE("Window functions do not support values of this type.");
+  }
+}
+
+bool IsFloatingPoint(const TypeId type) { return type == TypeId::Float || type == TypeId::Double; }
+
+// Access the slot at the given offset of a sorter row. Sorter rows are only exposed as const bytes, but the result
+// slots belong to the evaluator.
+byte *SlotAt(const byte *row, const uint32_t offset) { return const_cast<byte *>(row) + offset; }
+
+// The running state of an aggregate over the non-NULL values of a frame.
+template <typename T>
+struct Accumulator {
+  int64_t count_ = 0;
+  T sum_ = 0;
+  T min_ = 0;
+  T max_ = 0;
+
+  void Add(const T val) {
+    min_ = count_ == 0 ? val : std::min(min_, val);
+    max_ = count_ == 0 ? val : std::max(max_, val);
+    sum_ += val;
+    count_++;
+  }
+
+  // Only the count and the sum can be undone.
+  void Remove(const T val) {
+    sum_ -= val;
+    count_--;
+  }
+
+  void Merge(const Accumulator &other) {
+    if (other.count_ == 0) return;
+    if (count_ == 0) {
+      *this = other;
+      return;
+    }
+    min_ = std::min(min_, other.min_);
+    max_ = std::max(max_, other.max_);
+    sum_ += other.sum_;
+    count_ += other.count_;
+  }
+};
+
+// A segment tree over the accumulators of individual rows, answering aggregates over arbitrary ranges of rows.
+template <typename T>
+class SegmentTree {
+ public:
+  explicit SegmentTree(std::vector<Accumulator<T>> &&leaves) : num_leaves_(leaves.size()), nodes_(2 * num_leaves_) {
+    std::move(leaves.begin(), leaves.end(), nodes_.begin() + num_leaves_);
+    for (uint64_t i = num_leaves_ - 1; i > 0; i--) {
+      nodes_[i] = nodes_[2 * i];
+      nodes_[i].Merge(nodes_[2 * i + 1]);
+    }
+  }
+
+  // Aggregate the rows in the range [begin, end).
+  Accumulator<T> Query(uint64_t begin, uint64_t end) const {
+    Accumulator<T> result;
+    for (begin += num_leaves_, end += num_leaves_; begin < end; begin /= 2, end /= 2) {
+      if (begin & 1) result.Merge(nodes_[begin++]);
+      if (end & 1) result.Merge(nodes_[--end]);
+    }
+    return result;
+  }
+
+ private:
+  uint64_t num_leaves_;
+  std::vector<Accumulator<T>> nodes_;
+};
+
+}  // namespace
+
+WindowEvaluator::WindowEvaluator(KeyEqualFn same_partition_fn, KeyEqualFn same_peer_fn)
+    : same_partition_fn_(same_partition_fn), same_peer_fn_(same_peer_fn), num_partitions_(0) {}
+
+void WindowEvaluator::AddFunction(WindowFunction function, TypeId type, uint32_t arg_offset, uint32_t result_offset,
+                                  int64_t offset) {
+  TERRIER_ASSERT(offset >= 0, "LAG and LEAD offsets must not be negative");
+  functions_.push_back(Function{function, type, arg_offset, result_offset, static_cast<uint64_t>(offset),
+                                WindowFrameType::Range, WindowFrameBound::UnboundedPreceding, 0,
+                                WindowFrameBound::CurrentRow, 0});
+}
+
+void WindowEvaluator::SetFrame(WindowFrameType type, WindowFrameBound start, int64_t start_offset,
+                               WindowFrameBound end, int64_t end_offset) {
+  TERRIER_ASSERT(!functions_.empty(), "No window function to set the frame of");
+  TERRIER_ASSERT(start_offset >= 0 && end_offset >= 0, "Frame offsets must not be negative");
+  TERRIER_ASSERT(type == WindowFrameType::Rows || (start != WindowFrameBound::Preceding &&
+                                                   start != WindowFrameBound::Following &&
+                                                   end != WindowFrameBound::Preceding &&
+                                                   end != WindowFrameBound::Following),
+                 "RANGE frames with offsets are not supported");
+  auto &func = functions_.back();
+  func.frame_type_ = type;
+  func.frame_start_ = start;
+  func.frame_start_offset_ = static_cast<uint64_t>(start_offset);
+  func.frame_end_ = end;
+  func.frame_end_offset_ = static_cast<uint64_t>(end_offset);
+}
+
+std::pair<uint64_t, uint64_t> WindowEvaluator::ComputeFrame(const Function &func, const uint64_t row,
+                                                            const uint64_t num_rows, const PartitionState &state) {
+  const bool is_range = func.frame_type_ == WindowFrameType::Range;
+
+  uint64_t begin = 0;
+  switch (func.frame_start_) {
+    case WindowFrameBound::UnboundedPreceding:
+      begin = 0;
+      break;
+    case WindowFrameBound::Preceding:
+      begin = row >= func.frame_start_offset_ ? row - func.frame_start_offset_ : 0;
+      break;
+    case WindowFrameBound::CurrentRow:
+      begin = is_range ? state.peer_begin_[row] : row;
+      break;
+    case WindowFrameBound::Following:
+      begin = func.frame_start_offset_ >= num_rows - row ? num_rows : row + func.frame_start_offset_;
+      break;
+    case WindowFrameBound::UnboundedFollowing:
+      begin = num_rows;
+      break;
+  }
+
+  uint64_t end = 0;
+  switch (func.frame_end_) {
+    case WindowFrameBound::UnboundedPreceding:
+      end = 0;
+      break;
+    case WindowFrameBound::Preceding:
+      end = row + 1 >= func.frame_end_offset_ ? row + 1 - func.frame_end_offset_ : 0;
+      break;
+    case WindowFrameBound::CurrentRow:
+      end = is_range ? state.peer_end_[row] : row + 1;
+      break;
+    case WindowFrameBound::Following:
+      end = func.frame_end_offset_ >= num_rows - row - 1 ? num_rows : row + 1 + func.frame_end_offset_;
+      break;
+    case WindowFrameBound::UnboundedFollowing:
+      end = num_rows;
+      break;
+  }
+
+  return {begin, std::max(begin, end)};
+}
+
+std::vector<uint64_t> WindowEvaluator::FindPartitions(const byte *const *rows, const uint64_t num_rows) const {
+  // Flag the first row of each partition. Flags are bytes so that threads never write to the same word.
+  std::vector<uint8_t> is_first(num_rows, 0);
+  is_first[0] = 1;
+  util::MorselScheduler::Instance()->ParallelFor(
+      1, static_cast<uint32_t>(num_rows), ROWS_PER_MORSEL, -1, util::MorselScheduler::DEFAULT_PRIORITY, true,
+      [&](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; i++) {
+          is_first[i] = static_cast<uint8_t>(!same_partition_fn_(rows[i - 1], rows[i]));
+        }
+      });
+
+  std::vector<uint64_t> partitions;
+  for (uint64_t i = 0; i < num_rows; i++) {
+    if (is_first[i] != 0) partitions.push_back(i);
+  }
+  partitions.push_back(num_rows);
+  return partitions;
+}
+
+template <typename T>
+void WindowEvaluator::EvaluateAggregate(const Function &func, const byte *const *rows, const uint64_t num_rows,
+                                        const PartitionState &state) const {
+  using ValueType = std::conditional_t<std::is_floating_point_v<T>, Real, Integer>;
+
+  // COUNT(*) is the size of the frame.
+  if (func.function_ == WindowFunction::CountStar) {
+    for (uint64_t row = 0; row < num_rows; row++) {
+      const auto [begin, end] = ComputeFrame(func, row, num_rows, state);
+      *reinterpret_cast<Integer *>(SlotAt(rows[row], func.result_offset_)) = Integer(static_cast<int64_t>(end - begin));
+    }
+    return;
+  }
+
+  // Fold the argument of the given row into the accumulator, or remove it again.
+  const auto is_null = [&](uint64_t row) {
+    return reinterpret_cast<const Val *>(rows[row] + func.arg_offset_)->is_null_;
+  };
+  const auto value = [&](uint64_t row) -> T {
+    if (func.function_ == WindowFunction::Count) return T{0};
+    return reinterpret_cast<const ValueType *>(rows[row] + func.arg_offset_)->val_;
+  };
+
+  const auto write_result = [&](uint64_t row, const Accumulator<T> &acc) {
+    byte *result = SlotAt(rows[row], func.result_offset_);
+    if (func.function_ == WindowFunction::Count) {
+      *reinterpret_cast<Integer *>(result) = Integer(acc.count_);
+    } else if (func.function_ == WindowFunction::Avg) {
+      *reinterpret_cast<Real *>(result) =
+          acc.count_ == 0 ? Real::Null() : Real(static_cast<double>(acc.sum_) / static_cast<double>(acc.count_));
+    } else if (acc.count_ == 0) {
+      *reinterpret_cast<ValueType *>(result) = ValueType::Null();
+    } else if (func.function_ == WindowFunction::Sum) {
+      *reinterpret_cast<ValueType *>(result) = ValueType(acc.sum_);
+    } else if (func.function_ == WindowFunction::Min) {
+      *reinterpret_cast<ValueType *>(result) = ValueType(acc.min_);
+    } else {
+      *reinterpret_cast<ValueType *>(result) = ValueType(acc.max_);
+    }
+  };
+
+  // Frames never move backwards. If values can be removed from the aggregate exactly, or the frame always starts at
+  // the beginning of the partition, slide the frame along with the current row.
+  const bool invertible = func.function_ == WindowFunction::Count ||
+                          ((func.function_ == WindowFunction::Sum || func.function_ == WindowFunction::Avg) &&
+                           !std::is_floating_point_v<T>);
+  if (invertible || func.frame_start_ == WindowFrameBound::UnboundedPreceding) {
+    Accumulator<T> acc;
+    uint64_t frame_begin = 0, frame_end = 0;
+    for (uint64_t row = 0; row < num_rows; row++) {
+      const auto [begin, end] = ComputeFrame(func, row, num_rows, state);
+      for (; frame_end < end; frame_end++) {
+        if (!is_null(frame_end)) acc.Add(value(frame_end));
+      }
+      for (; frame_begin < begin; frame_begin++) {
+        if (!is_null(frame_begin)) acc.Remove(value(frame_begin));
+      }
+      write_result(row, acc);
+    }
+    return;
+  }
+
+  // Otherwise, answer each frame from a segment tree.
+  std::vector<Accumulator<T>> leaves(num_rows);
+  for (uint64_t row = 0; row < num_rows; row++) {
+    if (!is_null(row)) leaves[row].Add(value(row));
+  }
+  SegmentTree<T> tree(std::move(leaves));
+  for (uint64_t row = 0; row < num_rows; row++) {
+    const auto [begin, end] = ComputeFrame(func, row, num_rows, state);
+    write_result(row, tree.Query(begin, end));
+  }
+}
+
+void WindowEvaluator::EvaluatePartition(const byte *const *rows, const uint64_t num_rows,
+                                        PartitionState *state) const {
+  // Compute peer groups if any function needs them.
+  const bool needs_peers = std::any_of(functions_.begin(), functions_.end(), [](const Function &func) {
+    return func.function_ == WindowFunction::Rank || func.function_ == WindowFunction::DenseRank ||
+           (func.frame_type_ == WindowFrameType::Range &&
+            (func.frame_start_ == WindowFrameBound::CurrentRow || func.frame_end_ == WindowFrameBound::CurrentRow));
+  });
+  if (needs_peers) {
+    state->peer_begin_.resize(num_rows);
+    state->peer_end_.resize(num_rows);
+    state->peer_begin_[0] = 0;
+    for (uint64_t row = 1; row < num_rows; row++) {
+      state->peer_begin_[row] = same_peer_fn_(rows[row - 1], rows[row]) ? state->peer_begin_[row - 1] : row;
+    }
+    state->peer_end_[num_rows - 1] = num_rows;
+    for (uint64_t row = num_rows - 1; row > 0; row--) {
+      state->peer_end_[row - 1] =
+          state->peer_begin_[row - 1] == state->peer_begin_[row] ? state->peer_end_[row] : row;
+    }
+  }
+
+  for (const auto &func : functions_) {
+    switch (func.function_) {
+      case WindowFunction::RowNumber: {
+        for (uint64_t row = 0; row < num_rows; row++) {
+          *reinterpret_cast<Integer *>(SlotAt(rows[row], func.result_offset_)) = Integer(static_cast<int64_t>(row + 1));
+        }
+        break;
+      }
+      case WindowFunction::Rank: {
+        for (uint64_t row = 0; row < num_rows; row++) {
+          const auto rank = static_cast<int64_t>(state->peer_begin_[row] + 1);
+          *reinterpret_cast<Integer *>(SlotAt(rows[row], func.result_offset_)) = Integer(rank);
+        }
+        break;
+      }
+      case WindowFunction::DenseRank: {
+        int64_t rank = 0;
+        for (uint64_t row = 0; row < num_rows; row++) {
+          if (state->peer_begin_[row] == row) rank++;
+          *reinterpret_cast<Integer *>(SlotAt(rows[row], func.result_offset_)) = Integer(rank);
+        }
+        break;
+      }
+      case WindowFunction::Lag:
+      case WindowFunction::Lead: {
+        const std::size_t value_size = ValueSize(func.type_);
+        const bool is_lag = func.function_ == WindowFunction::Lag;
+        for (uint64_t row = 0; row < num_rows; row++) {
+          byte *result = SlotAt(rows[row], func.result_offset_);
+          if (is_lag ? row >= func.offset_ : func.offset_ < num_rows - row) {
+            const uint64_t source = is_lag ? row - func.offset_ : row + func.offset_;
+            std::memcpy(result, rows[source] + func.arg_offset_, value_size);
+          } else {
+            reinterpret_cast<Val *>(result)->is_null_ = true;
+          }
+        }
+        break;
+      }
+      case WindowFunction::CountStar:
+      case WindowFunction::Count: {
+        EvaluateAggregate<int64_t>(func, rows, num_rows, *state);
+        break;
+      }
+      case WindowFunction::Sum:
+      case WindowFunction::Min:
+      case WindowFunction::Max:
+      case WindowFunction::Avg: {
+        if (IsFloatingPoint(func.type_)) {
+          EvaluateAggregate<double>(func, rows, num_rows, *state);
+        } else {
+          EvaluateAggregate<int64_t>(func, rows, num_rows, *state);
+        }
+        break;
+      }
+    }
+  }
+}
+
+void WindowEvaluator::Evaluate(Sorter *sorter) {
+  num_partitions_ = 0;
+
+  const uint64_t num_rows = sorter->GetTupleCount();
+  if (num_rows == 0) {
+    return;
+  }
+  TERRIER_ASSERT(num_rows <= std::numeric_limits<uint32_t>::max(), "Too many rows for a window");
+
+  util::Timer<std::milli> timer;
+  timer.Start();
+
+  // Find partitions, then evaluate them in parallel.
+  const byte *const *rows = sorter->tuples_.data();
+  const std::vector<uint64_t> partitions = FindPartitions(rows, num_rows);
+  num_partitions_ = partitions.size() - 1;
+
+  util::MorselScheduler::Instance()->ParallelFor(
+      0, static_cast<uint32_t>(num_partitions_), PARTITIONS_PER_MORSEL, -1, util::MorselScheduler::DEFAULT_PRIORITY,
+      true, [&](uint32_t begin, uint32_t end) {
+        PartitionState state;
+        for (uint32_t partition = begin; partition < end; partition++) {
+          const uint64_t first_row = partitions[partition];
+          EvaluatePartition(rows + first_row, partitions[partition + 1] - first_row, &state);
+        }
+      });
+
+  timer.Stop();
+  EXECUTION_LOG_DEBUG("Evaluated {} window functions over {} rows in {} partitions in {} ms", functions_.size(),
+                      num_rows, num_partitions_, timer.GetElapsed());
+}
+
+}  // namespace terrier::execution::sql
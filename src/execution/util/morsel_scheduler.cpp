@@ -0,0 +1,254 @@
+#include "execution/util/morsel_scheduler.h"
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+#include "common/constants.h"
+#include "execution/util/cpu_info.h"
+#include "loggers/execution_logger.h"
+
+namespace terrier::execution::util {
+
+/**
+ * A single parallel operation submitted to the scheduler. Jobs live on the stack of the submitting thread.
+ */
+struct MorselScheduler::Job {
+  // A contiguous sub-range of the job's range. Morsels are claimed from the front of a partition by incrementing
+  // its next_ index. Each partition is on its own cache line to avoid false sharing between participants.
+  struct alignas(common::Constants::CACHELINE_SIZE) Partition {
+    std::atomic<uint64_t> next_{0};
+    uint64_t end_{0};
+
+    bool HasWork() const { return next_.load(std::memory_order_relaxed) < end_; }
+  };
+
+  Job(const MorselFn *morsel_fn, uint32_t morsel_size, uint32_t max_participants, uint32_t priority,
+      bool work_stealing)
+      : morsel_fn_(morsel_fn),
+        morsel_size_(morsel_size),
+        max_participants_(max_participants),
+        stride_(1.0 / priority),
+        work_stealing_(work_stealing),
+        partitions_(max_participants) {}
+
+  // Claim a morsel from the given partition. Returns false if the partition has no more morsels.
+  bool Claim(uint32_t partition, uint32_t *morsel_begin, uint32_t *morsel_end) {
+    Partition &part = partitions_[partition];
+    if (!part.HasWork() || cancelled_.load(std::memory_order_relaxed)) {
+      return false;
+    }
+    const uint64_t start = part.next_.fetch_add(morsel_size_, std::memory_order_relaxed);
+    if (start >= part.end_) {
+      return false;
+    }
+    *morsel_begin = static_cast<uint32_t>(start);
+    *morsel_end = static_cast<uint32_t>(std::min(start + morsel_size_, part.end_));
+    return true;
+  }
+
+  // Return the index of some partition with unclaimed morsels, preferring the given one. Returns the number of
+  // partitions if there is none.
+  uint32_t FindPartitionWithWork(uint32_t preferred) const {
+    const auto num_partitions = static_cast<uint32_t>(partitions_.size());
+    for (uint32_t i = 0; i < num_partitions; i++) {
+      const uint32_t idx = (preferred + i) % num_partitions;
+      if (partitions_[idx].HasWork()) return idx;
+    }
+    return num_partitions;
+  }
+
+  // The function to invoke on every morsel.
+  const MorselFn *const morsel_fn_;
+  // The maximum number of elements per morsel.
+  const uint32_t morsel_size_;
+  // The maximum number of concurrent participants, including the owner.
+  const uint32_t max_participants_;
+  // Stride scheduling: the pass is advanced by the stride every time a worker joins the job.
+  const double stride_;
+  double pass_{0.0};
+  // Whether background workers may steal from partitions other than their home.
+  const bool work_stealing_;
+  // The partitions. Partition 0 is the home of the submitting thread.
+  std::vector<Partition> partitions_;
+  // Round-robin assignment of home partitions to joining workers.
+  uint32_t next_home_{1};
+  // The number of background workers currently participating.
+  std::atomic<uint32_t> num_workers_{0};
+  // Set when a morsel throws. No new morsels are claimed afterwards.
+  std::atomic<bool> cancelled_{false};
+  // Protects error_, and is used to wait for participating workers.
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::exception_ptr error_{nullptr};
+};
+
+MorselScheduler::MorselScheduler(const uint32_t num_workers) {
+  workers_.reserve(num_workers);
+  for (uint32_t i = 0; i < num_workers; i++) {
+    workers_.emplace_back([this] { WorkerLoop(); });
+  }
+}
+
+MorselScheduler::~MorselScheduler() {
+  TERRIER_ASSERT(jobs_.empty(), "Destroying a morsel scheduler with jobs in flight");
+  {
+    std::lock_guard<std::mutex> lock(latch_);
+    shutdown_ = true;
+  }
+  work_cv_.notify_all();
+  for (auto &worker : workers_) {
+    worker.join();
+  }
+}
+
+MorselScheduler *MorselScheduler::Instance() {
+  // The submitting thread always participates, so one worker less than the number of cores is enough.
+  static MorselScheduler instance(std::max(CpuInfo::Instance()->GetNumLogicalCores(), 1u) - 1);
+  return &instance;
+}
+
+MorselScheduler::Job *MorselScheduler::PickJob() {
+  Job *best = nullptr;
+  for (auto *job : jobs_) {
+    // Skip jobs that are full, or have nothing left for a newcomer.
+    if (job->num_workers_.load(std::memory_order_relaxed) + 1 >= job->max_participants_) continue;
+    if (job->FindPartitionWithWork(0) == job->partitions_.size()) continue;
+    if (best == nullptr || job->pass_ < best->pass_) best = job;
+  }
+  if (best != nullptr) {
+    global_pass_ = best->pass_;
+    best->pass_ += best->stride_;
+    best->num_workers_.fetch_add(1, std::memory_order_relaxed);
+  }
+  return best;
+}
+
+void MorselScheduler::RunMorsels(Job *const job, const uint32_t home, const bool is_owner) {
+  const bool may_steal = is_owner || job->work_stealing_;
+  uint32_t partition = home;
+  while (true) {
+    uint32_t morsel_begin, morsel_end;
+    if (!job->Claim(partition, &morsel_begin, &morsel_end)) {
+      if (!may_steal) return;
+      partition = job->FindPartitionWithWork(partition);
+      if (partition == job->partitions_.size() || job->cancelled_.load(std::memory_order_relaxed)) return;
+      continue;
+    }
+
+    try {
+      (*job->morsel_fn_)(morsel_begin, morsel_end);
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(job->mutex_);
+      if (job->error_ == nullptr) job->error_ = std::current_exception();
+      job->cancelled_ = true;
+    }
+    num_morsels_processed_.fetch_add(1, std::memory_order_relaxed);
+
+    // Background workers return to the scheduler between morsels when other queries are waiting, so that the
+    // pool is shared according to job priorities.
+    if (!is_owner && num_jobs_.load(std::memory_order_relaxed) > 1) return;
+  }
+}
+
+void MorselScheduler::WorkerLoop() {
+  std::unique_lock<std::mutex> lock(latch_);
+  while (!shutdown_) {
+    Job *job = PickJob();
+    if (job == nullptr) {
+      work_cv_.wait(lock);
+      continue;
+    }
+
+    // Pick a home partition. Partition 0 belongs to the owner, so workers are assigned the others round-robin.
+    uint32_t home = 0;
+    const auto num_partitions = static_cast<uint32_t>(job->partitions_.size());
+    if (num_partitions > 1) {
+      home = 1 + (job->next_home_++ - 1) % (num_partitions - 1);
+    }
+    home = job->FindPartitionWithWork(home);
+    lock.unlock();
+
+    if (home != num_partitions) {
+      RunMorsels(job, home, false);
+    }
+
+    // Leave the job. The job may be destroyed by its owner as soon as the worker count drops to zero, so we must not
+    // touch it after releasing its latch.
+    {
+      std::lock_guard<std::mutex> job_lock(job->mutex_);
+      if (job->num_workers_.fetch_sub(1, std::memory_order_relaxed) == 1) job->cv_.notify_all();
+    }
+
+    lock.lock();
+  }
+}
+
+void MorselScheduler::ParallelFor(const uint32_t begin, const uint32_t end, const uint32_t morsel_size,
+                                  const int32_t max_threads, const uint32_t priority, const bool work_stealing,
+                                  const MorselFn &morsel_fn) {
+  TERRIER_ASSERT(morsel_size > 0, "Morsels must contain at least one element");
+  TERRIER_ASSERT(priority > 0, "Priority must be positive");
+  if (begin >= end) {
+    return;
+  }
+
+  // Determine the number of participants, which is also the number of partitions.
+  const uint64_t num_morsels = (static_cast<uint64_t>(end - begin) + morsel_size - 1) / morsel_size;
+  uint64_t max_participants = GetNumWorkers() + 1;
+  if (max_threads > 0) max_participants = std::min<uint64_t>(max_participants, max_threads);
+  max_participants = std::min(max_participants, num_morsels);
+
+  // Serial execution if there is no one to share the work with.
+  if (max_participants <= 1) {
+    for (uint32_t morsel_begin = begin; morsel_begin < end;) {
+      const uint32_t morsel_end = static_cast<uint32_t>(std::min<uint64_t>(uint64_t{morsel_begin} + morsel_size, end));
+      morsel_fn(morsel_begin, morsel_end);
+      morsel_begin = morsel_end;
+      num_morsels_processed_.fetch_add(1, std::memory_order_relaxed);
+    }
+    return;
+  }
+
+  // Split the range into contiguous, morsel-aligned partitions.
+  Job job(&morsel_fn, morsel_size, static_cast<uint32_t>(max_participants), priority, work_stealing);
+  const uint64_t morsels_per_partition = num_morsels / max_participants;
+  const uint64_t leftover_morsels = num_morsels % max_participants;
+  uint64_t part_begin = begin;
+  for (uint64_t i = 0; i < max_participants; i++) {
+    const uint64_t part_morsels = morsels_per_partition + (i < leftover_morsels ? 1 : 0);
+    const uint64_t part_end = std::min<uint64_t>(part_begin + part_morsels * morsel_size, end);
+    job.partitions_[i].next_ = part_begin;
+    job.partitions_[i].end_ = part_end;
+    part_begin = part_end;
+  }
+
+  // Publish the job, work on it, and retract it once there is nothing left to claim.
+  {
+    std::lock_guard<std::mutex> lock(latch_);
+    job.pass_ = global_pass_;
+    jobs_.push_back(&job);
+    num_jobs_.fetch_add(1, std::memory_order_relaxed);
+  }
+  work_cv_.notify_all();
+
+  RunMorsels(&job, 0, true);
+
+  {
+    std::lock_guard<std::mutex> lock(latch_);
+    jobs_.erase(std::find(jobs_.begin(), jobs_.end(), &job));
+    num_jobs_.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  // Wait for workers still processing morsels of this job.
+  {
+    std::unique_lock<std::mutex> lock(job.mutex_);
+    job.cv_.wait(lock, [&] { return job.num_workers_.load(std::memory_order_relaxed) == 0; });
+  }
+
+  if (job.error_ != nullptr) {
+    std::rethrow_exception(job.error_);
+  }
+}
+
+}  // namespace terrier::execution::util
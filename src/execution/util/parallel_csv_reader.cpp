@@ -0,0 +1,288 @@
+#include "execution/util/parallel_csv_reader.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <utility>
+
+#include "common/allocator.h"
+#include "common/error/exception.h"
+#include "execution/util/morsel_scheduler.h"
+#include "execution/util/value_parser.h"
+#include "loggers/execution_logger.h"
+#include "spdlog/fmt/fmt.h"
+#include "storage/storage_defs.h"
+
+namespace terrier::execution::util {
+
+ParallelCSVReader::ParallelCSVReader(std::string path, std::vector<type::TypeId> col_types,
+                                     std::vector<uint16_t> col_offsets, const char delimiter, const char quote,
+                                     const char escape, std::string null_string, const bool header)
+    : path_(std::move(path)),
+      col_types_(std::move(col_types)),
+      col_offsets_(std::move(col_offsets)),
+      delimiter_(delimiter),
+      quote_char_(quote),
+      escape_char_(escape),
+      null_string_(std::move(null_string)),
+      header_(header) {
+  TERRIER_ASSERT(col_types_.size() == col_offsets_.size(), "Every field needs a type and an output column");
+}
+
+ParallelCSVReader::~ParallelCSVReader() {
+  if (data_ != nullptr) munmap(const_cast<char *>(data_), size_);
+}
+
+bool ParallelCSVReader::Initialize() {
+  const int fd = open(path_.c_str(), O_RDONLY);
+  if (fd < 0) {
+    EXECUTION_LOG_ERROR("Unable to open CSV file {}: {}", path_, std::strerror(errno));
+    return false;
+  }
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0) {
+    EXECUTION_LOG_ERROR("Unable to stat CSV file {}: {}", path_, std::strerror(errno));
+    close(fd);
+    return false;
+  }
+  size_ = static_cast<std::size_t>(file_stat.st_size);
+  if (size_ > 0) {
+    void *const data = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) {
+      EXECUTION_LOG_ERROR("Unable to map CSV file {}: {}", path_, std::strerror(errno));
+      close(fd);
+      return false;
+    }
+    // Every chunk is read front to back by its morsel
+    madvise(data, size_, MADV_SEQUENTIAL);
+    data_ = static_cast<const char *>(data);
+  }
+  // The mapping stays valid after the descriptor is closed
+  close(fd);
+  return true;
+}
+
+uint64_t ParallelCSVReader::CountQuotes(const std::size_t begin, const std::size_t end) const {
+  if (quote_char_ == escape_char_) {
+    // An escaped quote is a doubled quote, which does not change the parity of the count
+    return static_cast<uint64_t>(std::count(data_ + begin, data_ + end, quote_char_));
+  }
+  uint64_t num_quotes = 0;
+  for (const char *ptr = ValueParser::FindAny(data_ + begin, data_ + end, quote_char_, quote_char_, quote_char_);
+       ptr < data_ + end; ptr = ValueParser::FindAny(ptr + 1, data_ + end, quote_char_, quote_char_, quote_char_)) {
+    // A quote is escaped if it is preceded by an odd number of escape characters, which may be in an earlier chunk
+    std::size_t num_escapes = 0;
+    while (ptr - num_escapes > data_ && *(ptr - num_escapes - 1) == escape_char_) num_escapes++;
+    if (num_escapes % 2 == 0) num_quotes++;
+  }
+  return num_quotes;
+}
+
+std::size_t ParallelCSVReader::NextRecordBoundary(std::size_t offset, bool quoted) const {
+  const char *const end = data_ + size_;
+  const char *ptr = data_ + offset;
+  if (quoted && escape_char_ != quote_char_) {
+    // Skip the character escaped right before the offset
+    std::size_t num_escapes = 0;
+    while (ptr - num_escapes > data_ && *(ptr - num_escapes - 1) == escape_char_) num_escapes++;
+    if (num_escapes % 2 == 1 && ptr < end) ptr++;
+  }
+  while (true) {
+    ptr = ValueParser::FindAny(ptr, end, '\n', quote_char_, escape_char_);
+    if (ptr == end) return size_;
+    if (*ptr == '\n' && !quoted) return ptr + 1 - data_;
+    if (quoted && escape_char_ != quote_char_ && *ptr == escape_char_) {
+      ptr += 2;
+      continue;
+    }
+    if (*ptr == quote_char_) quoted = !quoted;
+    ptr++;
+  }
+}
+
+std::vector<ParallelCSVReader::Chunk> ParallelCSVReader::Split(const std::size_t chunk_size) const {
+  std::vector<Chunk> chunks;
+  if (size_ == 0) return chunks;
+
+  const std::size_t start = header_ ? NextRecordBoundary(0, false) : 0;
+  const std::size_t num_pieces = std::max<std::size_t>(1, (size_ - start + chunk_size - 1) / chunk_size);
+
+  // Count the quotes of every piece to find out which piece boundaries are inside quoted fields
+  std::vector<uint64_t> num_quotes(num_pieces);
+  std::vector<std::size_t> boundaries(num_pieces);
+  MorselScheduler::Instance()->ParallelFor(0, static_cast<uint32_t>(num_pieces), [&](const uint32_t piece) {
+    const auto begin = std::min(size_, start + piece * chunk_size);
+    num_quotes[piece] = CountQuotes(begin, std::min(size_, begin + chunk_size));
+  });
+  MorselScheduler::Instance()->ParallelFor(1, static_cast<uint32_t>(num_pieces), [&](const uint32_t piece) {
+    uint64_t num_quotes_before = 0;
+    for (std::size_t i = 0; i < piece; i++) num_quotes_before += num_quotes[i];
+    boundaries[piece] = NextRecordBoundary(std::min(size_, start + piece * chunk_size), num_quotes_before % 2 == 1);
+  });
+
+  // A record may span several pieces, in which case some chunks are empty
+  std::size_t begin = start;
+  for (std::size_t piece = 1; piece < num_pieces; piece++) {
+    if (boundaries[piece] > begin) {
+      chunks.push_back({begin, boundaries[piece]});
+      begin = boundaries[piece];
+    }
+  }
+  if (begin < size_) chunks.push_back({begin, size_});
+  return chunks;
+}
+
+uint64_t ParallelCSVReader::Read(const storage::ProjectedColumnsInitializer &initializer, const BatchFn &batch_fn,
+                                 const std::size_t chunk_size) const {
+  TERRIER_ASSERT(data_ != nullptr || size_ == 0, "The file must be initialized first");
+  const auto chunks = Split(chunk_size);
+  std::atomic<uint64_t> num_records{0};
+
+  MorselScheduler::Instance()->ParallelFor(0, static_cast<uint32_t>(chunks.size()), [&](const uint32_t chunk_idx) {
+    const std::unique_ptr<byte[]> buffer(common::AllocationUtil::AllocateAligned(initializer.ProjectedColumnsSize()));
+    auto *const columns = initializer.Initialize(buffer.get());
+    num_records += ParseChunk(chunks[chunk_idx], columns, batch_fn);
+  });
+
+  EXECUTION_LOG_DEBUG("Read {} records in {} chunks from CSV file {}", num_records.load(), chunks.size(), path_);
+  return num_records.load();
+}
+
+uint64_t ParallelCSVReader::ParseChunk(const Chunk &chunk, storage::ProjectedColumns *const columns,
+                                       const BatchFn &batch_fn) const {
+  const char *ptr = data_ + chunk.begin_;
+  const char *const end = data_ + chunk.end_;
+  const auto num_fields = col_types_.size();
+  uint64_t num_records = 0;
+  uint32_t row = 0;
+  Cell cell;
+
+  while (ptr < end) {
+    // Skip empty lines
+    if (*ptr == '\n') {
+      ptr++;
+      continue;
+    }
+    if (*ptr == '\r' && (ptr + 1 == end || ptr[1] == '\n')) {
+      ptr += 2;
+      continue;
+    }
+
+    const char *const record = ptr;
+    for (std::size_t field = 0;; field++) {
+      if (field == num_fields) {
+        throw EXECUTION_EXCEPTION(fmt::format("CSV record at byte {} has more than {} fields", record - data_,
+                                              num_fields),
+                                  common::ErrorCode::ERRCODE_BAD_COPY_FILE_FORMAT);
+      }
+      ptr = ParseCell(ptr, end, &cell);
+      WriteCell(cell, col_types_[field], columns, col_offsets_[field], row);
+      if (ptr == end || *ptr == '\n') {
+        if (field + 1 != num_fields) {
+          throw EXECUTION_EXCEPTION(fmt::format("CSV record at byte {} has {} fields, expected {}", record - data_,
+                                                field + 1, num_fields),
+                                    common::ErrorCode::ERRCODE_BAD_COPY_FILE_FORMAT);
+        }
+        break;
+      }
+      // Skip the delimiter
+      ptr++;
+    }
+    // Skip the new line
+    ptr++;
+    num_records++;
+
+    if (++row == columns->MaxTuples()) {
+      columns->SetNumTuples(row);
+      batch_fn(columns);
+      row = 0;
+    }
+  }
+
+  if (row > 0) {
+    columns->SetNumTuples(row);
+    batch_fn(columns);
+  }
+  return num_records;
+}
+
+const char *ParallelCSVReader::ParseCell(const char *ptr, const char *const end, Cell *const cell) const {
+  cell->escaped_ = false;
+
+  if (ptr < end && *ptr == quote_char_) {
+    // Quoted cells can contain delimiters and new lines, and end at the first quote that is not escaped
+    cell->quoted_ = true;
+    cell->ptr_ = ++ptr;
+    while (true) {
+      ptr = ValueParser::FindAny(ptr, end, quote_char_, escape_char_, quote_char_);
+      if (ptr == end) {
+        throw EXECUTION_EXCEPTION(fmt::format("unterminated quoted CSV field at byte {}", cell->ptr_ - 1 - data_),
+                                  common::ErrorCode::ERRCODE_BAD_COPY_FILE_FORMAT);
+      }
+      const bool escapes_next = escape_char_ != quote_char_ || (ptr + 1 < end && ptr[1] == quote_char_);
+      if (*ptr == escape_char_ && escapes_next) {
+        cell->escaped_ = true;
+        ptr += 2;
+        continue;
+      }
+      break;
+    }
+    cell->len_ = ptr - cell->ptr_;
+    ptr++;
+    if (ptr < end && *ptr == '\r' && (ptr + 1 == end || ptr[1] == '\n')) ptr++;
+    if (ptr < end && *ptr != delimiter_ && *ptr != '\n') {
+      throw EXECUTION_EXCEPTION(fmt::format("unexpected character after quoted CSV field at byte {}", ptr - data_),
+                                common::ErrorCode::ERRCODE_BAD_COPY_FILE_FORMAT);
+    }
+    return ptr;
+  }
+
+  cell->quoted_ = false;
+  cell->ptr_ = ptr;
+  ptr = ValueParser::FindAny(ptr, end, delimiter_, '\n', delimiter_);
+  cell->len_ = ptr - cell->ptr_;
+  // Strip the carriage return of a "\r\n" line ending
+  if (cell->len_ > 0 && cell->ptr_[cell->len_ - 1] == '\r' && (ptr == end || *ptr == '\n')) cell->len_--;
+  return ptr;
+}
+
+void ParallelCSVReader::WriteCell(const Cell &cell, const type::TypeId type, storage::ProjectedColumns *const columns,
+                                  const uint16_t col_offset, const uint32_t row) const {
+  auto *const nulls = columns->ColumnNullBitmap(col_offset);
+  if (!cell.quoted_ && cell.len_ == null_string_.size() &&
+      std::memcmp(cell.ptr_, null_string_.data(), cell.len_) == 0) {
+    nulls->Set(row, false);
+    return;
+  }
+  nulls->Set(row, true);
+  byte *const value = columns->ColumnStart(col_offset) + columns->AttrSizeForColumn(col_offset) * row;
+
+  if (!cell.escaped_ || (type != type::TypeId::VARCHAR && type != type::TypeId::VARBINARY)) {
+    // Strings are copied straight out of the mapped file
+    ValueParser::ParseText(cell.ptr_, cell.len_, type, value);
+    return;
+  }
+
+  // The table takes ownership of the content once the tuple is inserted
+  auto *const varlen = reinterpret_cast<storage::VarlenEntry *>(value);
+  byte *const content = common::AllocationUtil::AllocateAligned(cell.len_);
+  uint32_t size = 0;
+  for (std::size_t i = 0; i < cell.len_; i++) {
+    if (cell.ptr_[i] == escape_char_) i++;
+    content[size++] = static_cast<byte>(cell.ptr_[i]);
+  }
+  if (size <= storage::VarlenEntry::InlineThreshold()) {
+    *varlen = storage::VarlenEntry::CreateInline(content, size);
+    delete[] content;
+  } else {
+    *varlen = storage::VarlenEntry::Create(content, size, true);
+  }
+}
+
+}  // namespace terrier::execution::util
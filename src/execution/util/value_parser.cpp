@@ -0,0 +1,147 @@
+#include "execution/util/value_parser.h"
+
+#include <immintrin.h>
+
+#include <cctype>
+#include <cstring>
+#include <limits>
+#include <string>
+
+#include "common/allocator.h"
+#include "common/error/exception.h"
+#include "execution/sql/runtime_types.h"
+#include "execution/util/fast_double_parser.h"
+#include "spdlog/fmt/fmt.h"
+#include "storage/storage_defs.h"
+#include "type/type_util.h"
+
+namespace terrier::execution::util {
+
+namespace {
+
+// Parse a base-10 integer that must span the whole text
+bool ParseInteger(const char *ptr, const char *const end, int64_t *const out) {
+  const bool negative = ptr < end && *ptr == '-';
+  if (ptr < end && (*ptr == '-' || *ptr == '+')) ptr++;
+  if (ptr == end) return false;
+  uint64_t value = 0;
+  for (; ptr < end; ptr++) {
+    const auto digit = static_cast<uint8_t>(*ptr - '0');
+    if (digit > 9 || value > (std::numeric_limits<uint64_t>::max() - digit) / 10) return false;
+    value = value * 10 + digit;
+  }
+  const auto limit = static_cast<uint64_t>(std::numeric_limits<int64_t>::max()) + (negative ? 1 : 0);
+  if (value > limit) return false;
+  *out = negative ? static_cast<int64_t>(~value + 1) : static_cast<int64_t>(value);
+  return true;
+}
+
+[[noreturn]] void ThrowInvalidValue(const char *ptr, const std::size_t len, const type::TypeId type) {
+  throw EXECUTION_EXCEPTION(fmt::format("invalid input for type {}: \"{}\"", type::TypeUtil::TypeIdToString(type),
+                                        std::string(ptr, len)),
+                            common::ErrorCode::ERRCODE_INVALID_TEXT_REPRESENTATION);
+}
+
+template <typename T>
+void WriteInteger(const char *ptr, const std::size_t len, const type::TypeId type, byte *const value) {
+  int64_t parsed;
+  if (!ParseInteger(ptr, ptr + len, &parsed) || parsed < std::numeric_limits<T>::min() ||
+      parsed > std::numeric_limits<T>::max()) {
+    ThrowInvalidValue(ptr, len, type);
+  }
+  *reinterpret_cast<T *>(value) = static_cast<T>(parsed);
+}
+
+}  // namespace
+
+const char *ValueParser::FindAny(const char *ptr, const char *const end, const char c0, const char c1,
+                                 const char c2) {
+#if defined(__AVX2__)
+  // The input may have no tail padding, so only whole vectors are compared and the tail is searched serially
+  const __m256i v0 = _mm256_set1_epi8(c0);
+  const __m256i v1 = _mm256_set1_epi8(c1);
+  const __m256i v2 = _mm256_set1_epi8(c2);
+  for (; ptr + sizeof(__m256i) <= end; ptr += sizeof(__m256i)) {
+    const __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(ptr));
+    const __m256i hits = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(data, v0), _mm256_cmpeq_epi8(data, v1)),
+                                         _mm256_cmpeq_epi8(data, v2));
+    const auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(hits));
+    if (mask != 0) return ptr + __builtin_ctz(mask);
+  }
+#endif
+  for (; ptr < end; ptr++) {
+    if (*ptr == c0 || *ptr == c1 || *ptr == c2) return ptr;
+  }
+  return end;
+}
+
+void ValueParser::ParseText(const char *const ptr, const std::size_t len, const type::TypeId type,
+                            byte *const value) {
+  switch (type) {
+    case type::TypeId::BOOLEAN: {
+      if (len == 0) ThrowInvalidValue(ptr, len, type);
+      const char first = static_cast<char>(std::tolower(ptr[0]));
+      if (first != 't' && first != 'f' && first != 'y' && first != 'n' && first != '1' && first != '0') {
+        ThrowInvalidValue(ptr, len, type);
+      }
+      *reinterpret_cast<bool *>(value) = first == 't' || first == 'y' || first == '1';
+      break;
+    }
+    case type::TypeId::TINYINT:
+      WriteInteger<int8_t>(ptr, len, type, value);
+      break;
+    case type::TypeId::SMALLINT:
+      WriteInteger<int16_t>(ptr, len, type, value);
+      break;
+    case type::TypeId::INTEGER:
+      WriteInteger<int32_t>(ptr, len, type, value);
+      break;
+    case type::TypeId::BIGINT:
+      WriteInteger<int64_t>(ptr, len, type, value);
+      break;
+    case type::TypeId::DECIMAL: {
+      // The parser reads until the first character that cannot be part of a number, which may be past the end of the
+      // input for the last value, or a delimiter that it accepts as part of a number. It gets a terminated copy.
+      char number[64];
+      double parsed;
+      if (len == 0 || len >= sizeof(number) - 1) ThrowInvalidValue(ptr, len, type);
+      std::memcpy(number, ptr, len);
+      number[len] = ' ';
+      number[len + 1] = '\0';
+      if (!FastDoubleParser::ParseNumberDecimalSeparatorDot(number, &parsed)) {
+        ThrowInvalidValue(ptr, len, type);
+      }
+      *reinterpret_cast<double *>(value) = parsed;
+      break;
+    }
+    case type::TypeId::DATE: {
+      const auto date = sql::Date::FromString(ptr, len).ToNative();
+      std::memcpy(value, &date, sizeof(date));
+      break;
+    }
+    case type::TypeId::TIMESTAMP: {
+      const auto timestamp = sql::Timestamp::FromString(ptr, len).ToNative();
+      std::memcpy(value, &timestamp, sizeof(timestamp));
+      break;
+    }
+    case type::TypeId::VARCHAR:
+    case type::TypeId::VARBINARY: {
+      auto *const varlen = reinterpret_cast<storage::VarlenEntry *>(value);
+      if (len <= storage::VarlenEntry::InlineThreshold()) {
+        *varlen = storage::VarlenEntry::CreateInline(reinterpret_cast<const byte *>(ptr), static_cast<uint32_t>(len));
+        break;
+      }
+      // The table takes ownership of the content once the tuple is inserted
+      byte *const content = common::AllocationUtil::AllocateAligned(len);
+      std::memcpy(content, ptr, len);
+      *varlen = storage::VarlenEntry::Create(content, static_cast<uint32_t>(len), true);
+      break;
+    }
+    default:
+      throw EXECUTION_EXCEPTION(
+          fmt::format("loading type {} from text is not supported", type::TypeUtil::TypeIdToString(type)),
+          common::ErrorCode::ERRCODE_FEATURE_NOT_SUPPORTED);
+  }
+}
+
+}  // namespace terrier::execution::util
@@ -0,0 +1,126 @@
+#include "execution/vm/background_compiler.h"
+
+#include <algorithm>
+#include <exception>
+#include <utility>
+#include <vector>
+
+#include "common/constants.h"
+#include "loggers/execution_logger.h"
+
+namespace terrier::execution::vm {
+
+BackgroundCompiler::BackgroundCompiler(const uint32_t num_threads) {
+  threads_.reserve(num_threads);
+  for (uint32_t i = 0; i < num_threads; i++) {
+    threads_.emplace_back([this] { ThreadLoop(); });
+  }
+}
+
+BackgroundCompiler::~BackgroundCompiler() {
+  {
+    std::lock_guard<std::mutex> lock(latch_);
+    shutdown_ = true;
+    queue_.clear();
+  }
+  work_cv_.notify_all();
+  for (auto &thread : threads_) {
+    thread.join();
+  }
+}
+
+BackgroundCompiler *BackgroundCompiler::Instance() {
+  static BackgroundCompiler instance(std::max(common::Constants::NUM_JIT_COMPILE_THREADS, 1u));
+  return &instance;
+}
+
+BackgroundCompiler::TaskId BackgroundCompiler::Submit(std::function<void()> task) {
+  TaskId id;
+  {
+    std::lock_guard<std::mutex> lock(latch_);
+    id = next_id_++;
+    queue_.emplace_back(id, std::move(task));
+  }
+  work_cv_.notify_one();
+  return id;
+}
+
+bool BackgroundCompiler::CancelOrWait(const TaskId id) {
+  std::unique_lock<std::mutex> lock(latch_);
+  const auto iter = std::find_if(queue_.begin(), queue_.end(), [&](const auto &entry) { return entry.first == id; });
+  if (iter != queue_.end()) {
+    queue_.erase(iter);
+    return true;
+  }
+  done_cv_.wait(lock, [&] { return running_.count(id) == 0; });
+  return false;
+}
+
+void BackgroundCompiler::RunConcurrently(std::vector<std::function<void()>> &&tasks) {
+  if (tasks.empty()) {
+    return;
+  }
+
+  // Offer all but the first task to the pool; the first one is ours.
+  std::vector<std::pair<TaskId, std::function<void()> *>> submitted;
+  submitted.reserve(tasks.size() - 1);
+  for (std::size_t i = 1; i < tasks.size(); i++) {
+    submitted.emplace_back(Submit([task = &tasks[i]] { (*task)(); }), &tasks[i]);
+  }
+
+  // Tasks that are still queued when we get to them are reclaimed and run here. Every submitted task must be done
+  // before returning, even if one of ours throws, since the pool refers to the tasks.
+  std::exception_ptr error;
+  const auto run_here = [&](const std::function<void()> &task) {
+    try {
+      task();
+    } catch (...) {
+      if (error == nullptr) {
+        error = std::current_exception();
+      }
+    }
+  };
+  run_here(tasks[0]);
+  for (const auto &[id, task] : submitted) {
+    if (CancelOrWait(id)) {
+      run_here(*task);
+    }
+  }
+
+  if (error != nullptr) {
+    std::rethrow_exception(error);
+  }
+}
+
+void BackgroundCompiler::WaitIdle() {
+  std::unique_lock<std::mutex> lock(latch_);
+  done_cv_.wait(lock, [&] { return queue_.empty() && running_.empty(); });
+}
+
+void BackgroundCompiler::ThreadLoop() {
+  std::unique_lock<std::mutex> lock(latch_);
+  while (true) {
+    work_cv_.wait(lock, [&] { return shutdown_ || !queue_.empty(); });
+    if (shutdown_) {
+      return;
+    }
+
+    auto [id, task] = std::move(queue_.front());
+    queue_.pop_front();
+    running_.insert(id);
+    lock.unlock();
+
+    try {
+      task();
+    } catch (const std::exception &e) {
+      EXECUTION_LOG_ERROR("Background compilation task {} failed: {}", id, e.what());
+    }
+    num_completed_.fetch_add(1, std::memory_order_relaxed);
+
+    lock.lock();
+    running_.erase(id);
+    done_cv_.notify_all();
+  }
+}
+
+}  // namespace terrier::execution::vm
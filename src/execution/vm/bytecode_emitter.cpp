@@ -337,6 +337,11 @@ void BytecodeEmitter::EmitSorterInit(Bytecode bytecode, LocalVar sorter, LocalVa
   EmitAll(bytecode, sorter, region, cmp_fn, tuple_size);
 }
 
+void BytecodeEmitter::EmitWindowEvaluatorInit(LocalVar evaluator, FunctionId same_partition_fn,
+                                              FunctionId same_peer_fn) {
+  EmitAll(Bytecode::WindowEvaluatorInit, evaluator, same_partition_fn, same_peer_fn);
+}
+
 #if 0
 void BytecodeEmitter::EmitCSVReaderInit(LocalVar reader, LocalVar file_name, uint32_t file_name_len) {
   EmitAll(Bytecode::CSVReaderInit, reader, file_name, file_name_len);
@@ -13,6 +13,7 @@
 #include "execution/sql/sql_def.h"
 #include "execution/vm/bytecode_label.h"
 #include "execution/vm/bytecode_module.h"
+#include "execution/vm/bytecode_optimizer.h"
 #include "execution/vm/control_flow_builders.h"
 #include "loggers/execution_logger.h"
 #include "spdlog/fmt/fmt.h"
@@ -1559,6 +1560,45 @@ void BytecodeGenerator::VisitBuiltinSorterIterCall(ast::CallExpr *call, ast::Bui
   }
 }
 
+void BytecodeGenerator::VisitBuiltinWindowEvaluatorCall(ast::CallExpr *call, ast::Builtin builtin) {
+  // The first argument to all calls is the window evaluator instance
+  const LocalVar evaluator = VisitExpressionForRValue(call->Arguments()[0]);
+
+  switch (builtin) {
+    case ast::Builtin::WindowEvaluatorInit: {
+      // Like the sorter's comparison function, the key equality functions must be listed by name.
+      const std::string same_partition_name = call->Arguments()[1]->As<ast::IdentifierExpr>()->Name().GetData();
+      const std::string same_peer_name = call->Arguments()[2]->As<ast::IdentifierExpr>()->Name().GetData();
+      GetEmitter()->EmitWindowEvaluatorInit(evaluator, LookupFuncIdByName(same_partition_name),
+                                            LookupFuncIdByName(same_peer_name));
+      break;
+    }
+    case ast::Builtin::WindowEvaluatorAddFunction:
+    case ast::Builtin::WindowEvaluatorSetFrame: {
+      LocalVar args[5];
+      for (uint32_t i = 0; i < 5; i++) {
+        args[i] = VisitExpressionForRValue(call->Arguments()[i + 1]);
+      }
+      const auto bytecode = builtin == ast::Builtin::WindowEvaluatorAddFunction ? Bytecode::WindowEvaluatorAddFunction
+                                                                                 : Bytecode::WindowEvaluatorSetFrame;
+      GetEmitter()->Emit(bytecode, evaluator, args[0], args[1], args[2], args[3], args[4]);
+      break;
+    }
+    case ast::Builtin::WindowEvaluatorEvaluate: {
+      LocalVar sorter = VisitExpressionForRValue(call->Arguments()[1]);
+      GetEmitter()->Emit(Bytecode::WindowEvaluatorEvaluate, evaluator, sorter);
+      break;
+    }
+    case ast::Builtin::WindowEvaluatorFree: {
+      GetEmitter()->Emit(Bytecode::WindowEvaluatorFree, evaluator);
+      break;
+    }
+    default: {
+      UNREACHABLE("Impossible bytecode");
+    }
+  }
+}
+
 void BytecodeGenerator::VisitResultBufferCall(ast::CallExpr *call, ast::Builtin builtin) {
   LocalVar exec_ctx = VisitExpressionForRValue(call->Arguments()[0]);
   switch (builtin) {
@@ -2724,6 +2764,14 @@ void BytecodeGenerator::VisitBuiltinCallExpr(ast::CallExpr *call) {
       VisitBuiltinSorterIterCall(call, builtin);
       break;
     }
+    case ast::Builtin::WindowEvaluatorInit:
+    case ast::Builtin::WindowEvaluatorAddFunction:
+    case ast::Builtin::WindowEvaluatorSetFrame:
+    case ast::Builtin::WindowEvaluatorEvaluate:
+    case ast::Builtin::WindowEvaluatorFree: {
+      VisitBuiltinWindowEvaluatorCall(call, builtin);
+      break;
+    }
     case ast::Builtin::ResultBufferAllocOutRow:
     case ast::Builtin::ResultBufferFinalize: {
       VisitResultBufferCall(call, builtin);
@@ -3102,11 +3150,20 @@ void BytecodeGenerator::VisitLitExpr(ast::LitExpr *node) {
       break;
     }
     case ast::LitExpr::LitKind::Int: {
-      if (static_cast<int64_t>(std::numeric_limits<int>::lowest()) <= node->Int64Val() &&
-          node->Int64Val() <= static_cast<int64_t>(std::numeric_limits<int>::max())) {
-        GetEmitter()->EmitAssignImm4(target, node->Int64Val());
-      } else {
-        GetEmitter()->EmitAssignImm8(target, node->Int64Val());
+      // The immediate must cover the whole target; frames aren't zeroed.
+      switch (node->GetType()->GetSize()) {
+        case 1:
+          GetEmitter()->EmitAssignImm1(target, static_cast<int8_t>(node->Int64Val()));
+          break;
+        case 2:
+          GetEmitter()->EmitAssignImm2(target, static_cast<int16_t>(node->Int64Val()));
+          break;
+        case 4:
+          GetEmitter()->EmitAssignImm4(target, static_cast<int32_t>(node->Int64Val()));
+          break;
+        default:
+          GetEmitter()->EmitAssignImm8(target, node->Int64Val());
+          break;
       }
       GetExecutionResult()->SetDestination(target.ValueOf());
       break;
@@ -3723,10 +3780,17 @@ Bytecode BytecodeGenerator::GetFloatTypedBytecode(Bytecode bytecode, ast::Type *
 }
 
 // static
-std::unique_ptr<BytecodeModule> BytecodeGenerator::Compile(ast::AstNode *root, const std::string &name) {
+std::unique_ptr<BytecodeModule> BytecodeGenerator::Compile(ast::AstNode *root, const std::string &name,
+                                                           const bool optimize) {
   BytecodeGenerator generator{};
   generator.Visit(root);
 
+  if (optimize) {
+    const auto stats = BytecodeOptimizer::Optimize(&generator.code_, &generator.functions_);
+    EXECUTION_LOG_TRACE("Bytecode optimizer: {} fused, {} forwarded, {} removed, {} -> {} bytes", stats.num_fused_,
+                        stats.num_forwarded_, stats.num_removed_, stats.size_before_, stats.size_after_);
+  }
+
   // Create the bytecode module. Note that we move the bytecode and functions
   // array from the generator into the module.
   return std::make_unique<BytecodeModule>(name, std::move(generator.code_), std::move(generator.data_),
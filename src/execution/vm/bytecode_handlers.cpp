@@ -161,6 +161,38 @@ void OpSorterIteratorInit(terrier::execution::sql::SorterIterator *iter, terrier
 
 void OpSorterIteratorFree(terrier::execution::sql::SorterIterator *iter) { iter->~SorterIterator(); }
 
+// ---------------------------------------------------------
+// Window functions
+// ---------------------------------------------------------
+
+void OpWindowEvaluatorInit(terrier::execution::sql::WindowEvaluator *evaluator,
+                           const terrier::execution::sql::WindowEvaluator::KeyEqualFn same_partition_fn,
+                           const terrier::execution::sql::WindowEvaluator::KeyEqualFn same_peer_fn) {
+  new (evaluator) terrier::execution::sql::WindowEvaluator(same_partition_fn, same_peer_fn);
+}
+
+void OpWindowEvaluatorAddFunction(terrier::execution::sql::WindowEvaluator *evaluator, const uint32_t function,
+                                  const uint32_t type, const uint32_t arg_offset, const uint32_t result_offset,
+                                  const int64_t offset) {
+  evaluator->AddFunction(static_cast<terrier::execution::sql::WindowFunction>(function),
+                         static_cast<terrier::execution::sql::TypeId>(type), arg_offset, result_offset, offset);
+}
+
+void OpWindowEvaluatorSetFrame(terrier::execution::sql::WindowEvaluator *evaluator, const uint32_t frame_type,
+                               const uint32_t start, const int64_t start_offset, const uint32_t end,
+                               const int64_t end_offset) {
+  evaluator->SetFrame(static_cast<terrier::execution::sql::WindowFrameType>(frame_type),
+                      static_cast<terrier::execution::sql::WindowFrameBound>(start), start_offset,
+                      static_cast<terrier::execution::sql::WindowFrameBound>(end), end_offset);
+}
+
+void OpWindowEvaluatorEvaluate(terrier::execution::sql::WindowEvaluator *evaluator,
+                               terrier::execution::sql::Sorter *sorter) {
+  evaluator->Evaluate(sorter);
+}
+
+void OpWindowEvaluatorFree(terrier::execution::sql::WindowEvaluator *evaluator) { evaluator->~WindowEvaluator(); }
+
 // ---------------------------------------------------------
 // CSV Reader
 // ---------------------------------------------------------
@@ -0,0 +1,470 @@
+#include "execution/vm/bytecode_optimizer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "execution/vm/bytecode_iterator.h"
+#include "execution/vm/bytecodes.h"
+
+namespace terrier::execution::vm {
+
+namespace {
+
+// Primitive arithmetic, bitwise and comparison operations are the first bytecodes in the list.
+static_assert(static_cast<uint32_t>(Bytecode::Neg_int8_t) == 0, "Primitive operations must come first");
+
+// The fused compare-and-branch bytecodes are laid out exactly like the comparisons they fuse.
+static_assert(static_cast<uint32_t>(Bytecode::NotEqual_double) - static_cast<uint32_t>(Bytecode::GreaterThan_bool) ==
+                  static_cast<uint32_t>(Bytecode::NotEqualJumpIfFalse_double) -
+                      static_cast<uint32_t>(Bytecode::GreaterThanJumpIfFalse_bool),
+              "Comparisons and fused compare-and-branch bytecodes must be parallel");
+
+// Is the bytecode a primitive comparison?
+bool IsComparison(const Bytecode bytecode) {
+  return bytecode >= Bytecode::GreaterThan_bool && bytecode <= Bytecode::NotEqual_double;
+}
+
+// Does the bytecode do nothing but write its first operand, using only its other operands as input?
+bool IsPureProducer(const Bytecode bytecode) {
+  if (bytecode <= Bytecode::NotEqual_double) {
+    return true;
+  }
+  switch (bytecode) {
+    case Bytecode::Not:
+    case Bytecode::IsNullPtr:
+    case Bytecode::IsNotNullPtr:
+    case Bytecode::Deref1:
+    case Bytecode::Deref2:
+    case Bytecode::Deref4:
+    case Bytecode::Deref8:
+    case Bytecode::Assign1:
+    case Bytecode::Assign2:
+    case Bytecode::Assign4:
+    case Bytecode::Assign8:
+    case Bytecode::AssignImm1:
+    case Bytecode::AssignImm2:
+    case Bytecode::AssignImm4:
+    case Bytecode::AssignImm8:
+    case Bytecode::AssignImm4F:
+    case Bytecode::AssignImm8F:
+    case Bytecode::Lea:
+    case Bytecode::LeaScaled:
+    case Bytecode::LoadField1:
+    case Bytecode::LoadField2:
+    case Bytecode::LoadField4:
+    case Bytecode::LoadField8:
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool IsAssign(const Bytecode bytecode) {
+  return bytecode == Bytecode::Assign1 || bytecode == Bytecode::Assign2 || bytecode == Bytecode::Assign4 ||
+         bytecode == Bytecode::Assign8;
+}
+
+// The number of bytes written by a fixed-width move, or zero if the bytecode writes a value of its operand type.
+uint32_t WriteWidth(const Bytecode bytecode) {
+  switch (bytecode) {
+    case Bytecode::Assign1:
+    case Bytecode::AssignImm1:
+    case Bytecode::Deref1:
+    case Bytecode::LoadField1:
+      return 1;
+    case Bytecode::Assign2:
+    case Bytecode::AssignImm2:
+    case Bytecode::Deref2:
+    case Bytecode::LoadField2:
+      return 2;
+    case Bytecode::Assign4:
+    case Bytecode::AssignImm4:
+    case Bytecode::AssignImm4F:
+    case Bytecode::Deref4:
+    case Bytecode::LoadField4:
+      return 4;
+    case Bytecode::Assign8:
+    case Bytecode::AssignImm8:
+    case Bytecode::AssignImm8F:
+    case Bytecode::Deref8:
+    case Bytecode::LoadField8:
+      return 8;
+    default:
+      return 0;
+  }
+}
+
+// Map a Deref to the LoadField with the same width.
+Bytecode DerefToLoadField(const Bytecode bytecode) {
+  switch (bytecode) {
+    case Bytecode::Deref1:
+      return Bytecode::LoadField1;
+    case Bytecode::Deref2:
+      return Bytecode::LoadField2;
+    case Bytecode::Deref4:
+      return Bytecode::LoadField4;
+    case Bytecode::Deref8:
+      return Bytecode::LoadField8;
+    default:
+      return Bytecode::LoadFieldN;
+  }
+}
+
+// Encodes a single instruction.
+class InstructionWriter {
+ public:
+  explicit InstructionWriter(const Bytecode bytecode) { Write(Bytecodes::ToByte(bytecode)); }
+
+  InstructionWriter &Write(const LocalVar local) { return Write(local.Encode()); }
+
+  template <typename T>
+  InstructionWriter &Write(const T val) {
+    static_assert(std::is_arithmetic_v<T>, "Only scalars can be written");
+    bytes_.resize(bytes_.size() + sizeof(T));
+    std::memcpy(&bytes_[bytes_.size() - sizeof(T)], &val, sizeof(T));
+    return *this;
+  }
+
+  std::vector<uint8_t> Finish() { return std::move(bytes_); }
+
+ private:
+  std::vector<uint8_t> bytes_;
+};
+
+// An instruction in the function being optimized.
+struct Instruction {
+  // The position of the original instruction, relative to the start of the function.
+  std::size_t pos_;
+  // The encoded instruction. Jump offsets in here are stale; they're patched when the function is emitted.
+  std::vector<uint8_t> bytes_;
+  // If the instruction is a jump, the position of its target in the original function.
+  std::size_t jump_target_;
+  // Has the instruction been removed?
+  bool removed_;
+
+  // Decode the instruction.
+  BytecodeIterator Decode() const { return BytecodeIterator(bytes_); }
+};
+
+// Optimizes a single function.
+class FunctionOptimizer {
+ public:
+  FunctionOptimizer(const std::vector<uint8_t> &code, const FunctionInfo &func, BytecodeOptimizer::Stats *stats)
+      : stats_(stats) {
+    for (const auto &local : func.GetLocals()) {
+      if (local.IsParameter()) {
+        params_.insert(local.GetOffset());
+      }
+    }
+
+    const auto [start, end] = func.GetBytecodeRange();
+    for (BytecodeIterator iter(code, start, end); !iter.Done(); iter.Advance()) {
+      const auto pos = iter.GetPosition(), size = std::size_t{iter.CurrentBytecodeSize()};
+      Instruction instr{pos, std::vector<uint8_t>(&code[start + pos], &code[start + pos + size]), 0, false};
+      const Bytecode bytecode = iter.CurrentBytecode();
+      if (Bytecodes::IsJump(bytecode)) {
+        const auto offset_idx = Bytecodes::GetJumpOffsetOperandIndex(bytecode);
+        instr.jump_target_ =
+            pos + Bytecodes::GetNthOperandOffset(bytecode, offset_idx) + iter.GetJumpOffsetOperand(offset_idx);
+        jump_targets_.insert(instr.jump_target_);
+      }
+      CountReferences(instr, 1);
+      instrs_.emplace_back(std::move(instr));
+    }
+  }
+
+  // Rewrite the instructions.
+  void Run() {
+    for (std::size_t i = 0; i < instrs_.size();) {
+      const std::size_t next = NextLive(i);
+      if (instrs_[i].removed_ || next == instrs_.size() || jump_targets_.count(instrs_[next].pos_) != 0) {
+        i++;
+        continue;
+      }
+      // The rewritten instruction may start another sequence, so look at it again.
+      if (TryFuseCompareAndJump(i, next) || TryFuseTruthAndJump(i, next) || TryFuseLoadField(i, next)) {
+        stats_->num_fused_++;
+        Remove(next);
+        continue;
+      }
+      if (TryForwardMove(i, next)) {
+        stats_->num_forwarded_++;
+        Remove(next);
+        continue;
+      }
+      i++;
+    }
+
+    for (std::size_t i = 0; i < instrs_.size(); i++) {
+      if (!instrs_[i].removed_ && (IsSelfAssign(instrs_[i]) || IsDeadStore(instrs_[i]))) {
+        stats_->num_removed_++;
+        Remove(i);
+      }
+    }
+  }
+
+  // Append the optimized function to the given code.
+  void Emit(std::vector<uint8_t> *code) const {
+    const std::size_t start = code->size();
+
+    // Removed instructions map to the position of the next instruction that remains.
+    std::vector<std::size_t> new_pos(instrs_.size() + 1);
+    for (std::size_t i = 0; i < instrs_.size(); i++) {
+      new_pos[i] = code->size() - start;
+      if (!instrs_[i].removed_) {
+        code->insert(code->end(), instrs_[i].bytes_.begin(), instrs_[i].bytes_.end());
+      }
+    }
+    new_pos[instrs_.size()] = code->size() - start;
+
+    const auto relocate = [&](const std::size_t old_pos) {
+      const auto iter = std::lower_bound(instrs_.begin(), instrs_.end(), old_pos,
+                                         [](const Instruction &instr, std::size_t pos) { return instr.pos_ < pos; });
+      return new_pos[iter - instrs_.begin()];
+    };
+
+    for (std::size_t i = 0; i < instrs_.size(); i++) {
+      const Bytecode bytecode = instrs_[i].Decode().CurrentBytecode();
+      if (instrs_[i].removed_ || !Bytecodes::IsJump(bytecode)) {
+        continue;
+      }
+      const auto offset_idx = Bytecodes::GetJumpOffsetOperandIndex(bytecode);
+      const auto operand_pos = new_pos[i] + Bytecodes::GetNthOperandOffset(bytecode, offset_idx);
+      const auto offset = static_cast<int32_t>(static_cast<int64_t>(relocate(instrs_[i].jump_target_)) -
+                                               static_cast<int64_t>(operand_pos));
+      std::memcpy(&(*code)[start + operand_pos], &offset, sizeof(offset));
+    }
+  }
+
+ private:
+  // Adjust the reference counts of all locals referenced by the given instruction.
+  void CountReferences(const Instruction &instr, const int32_t delta) {
+    const auto iter = instr.Decode();
+    const Bytecode bytecode = iter.CurrentBytecode();
+    for (uint32_t i = 0; i < Bytecodes::NumOperands(bytecode); i++) {
+      switch (Bytecodes::GetNthOperandType(bytecode, i)) {
+        case OperandType::Local:
+          refs_[iter.GetLocalOperand(i).GetOffset()] += delta;
+          break;
+        case OperandType::LocalCount: {
+          std::vector<LocalVar> locals;
+          iter.GetLocalCountOperand(i, &locals);
+          for (const auto local : locals) {
+            refs_[local.GetOffset()] += delta;
+          }
+          break;
+        }
+        default:
+          break;
+      }
+    }
+  }
+
+  // Does the instruction reference the local at the given offset in any way?
+  static bool References(const Instruction &instr, const uint32_t offset) {
+    const auto iter = instr.Decode();
+    const Bytecode bytecode = iter.CurrentBytecode();
+    for (uint32_t i = 0; i < Bytecodes::NumOperands(bytecode); i++) {
+      if (Bytecodes::GetNthOperandType(bytecode, i) == OperandType::Local &&
+          iter.GetLocalOperand(i).GetOffset() == offset) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Is the given local a temporary that is written exactly once and read exactly once?
+  bool IsSingleUseTemp(const LocalVar local) const {
+    const auto iter = refs_.find(local.GetOffset());
+    return params_.count(local.GetOffset()) == 0 && iter != refs_.end() && iter->second == 2;
+  }
+
+  // The index of the first instruction after the given one that hasn't been removed.
+  std::size_t NextLive(std::size_t idx) const {
+    do {
+      idx++;
+    } while (idx < instrs_.size() && instrs_[idx].removed_);
+    return idx;
+  }
+
+  void Remove(const std::size_t idx) {
+    CountReferences(instrs_[idx], -1);
+    instrs_[idx].removed_ = true;
+  }
+
+  void Replace(const std::size_t idx, std::vector<uint8_t> &&bytes) {
+    CountReferences(instrs_[idx], -1);
+    instrs_[idx].bytes_ = std::move(bytes);
+    CountReferences(instrs_[idx], 1);
+  }
+
+  // Is the instruction at the given index a JumpIfFalse on the value of the given local?
+  bool IsJumpIfFalseOn(const std::size_t idx, const LocalVar local) const {
+    const auto iter = instrs_[idx].Decode();
+    return iter.CurrentBytecode() == Bytecode::JumpIfFalse && iter.GetLocalOperand(0) == local.ValueOf();
+  }
+
+  // cmp tmp, lhs, rhs ; JumpIfFalse tmp => cmpJumpIfFalse lhs, rhs
+  bool TryFuseCompareAndJump(const std::size_t idx, const std::size_t next) {
+    const auto iter = instrs_[idx].Decode();
+    const Bytecode bytecode = iter.CurrentBytecode();
+    if (!IsComparison(bytecode)) {
+      return false;
+    }
+    const LocalVar tmp = iter.GetLocalOperand(0);
+    if (tmp.GetAddressMode() != LocalVar::AddressMode::Address || !IsSingleUseTemp(tmp) ||
+        !IsJumpIfFalseOn(next, tmp)) {
+      return false;
+    }
+    const auto cmp_idx = Bytecodes::ToByte(bytecode) - Bytecodes::ToByte(Bytecode::GreaterThan_bool);
+    const auto fused = Bytecodes::FromByte(Bytecodes::ToByte(Bytecode::GreaterThanJumpIfFalse_bool) + cmp_idx);
+    const LocalVar lhs = iter.GetLocalOperand(1), rhs = iter.GetLocalOperand(2);
+    instrs_[idx].jump_target_ = instrs_[next].jump_target_;
+    Replace(idx, InstructionWriter(fused).Write(lhs).Write(rhs).Write(int32_t{0}).Finish());
+    return true;
+  }
+
+  // ForceBoolTruth tmp, sql_bool ; JumpIfFalse tmp => ForceBoolTruthJumpIfFalse sql_bool
+  bool TryFuseTruthAndJump(const std::size_t idx, const std::size_t next) {
+    const auto iter = instrs_[idx].Decode();
+    if (iter.CurrentBytecode() != Bytecode::ForceBoolTruth) {
+      return false;
+    }
+    const LocalVar tmp = iter.GetLocalOperand(0);
+    if (tmp.GetAddressMode() != LocalVar::AddressMode::Address || !IsSingleUseTemp(tmp) ||
+        !IsJumpIfFalseOn(next, tmp)) {
+      return false;
+    }
+    const LocalVar sql_bool = iter.GetLocalOperand(1);
+    instrs_[idx].jump_target_ = instrs_[next].jump_target_;
+    Replace(idx, InstructionWriter(Bytecode::ForceBoolTruthJumpIfFalse).Write(sql_bool).Write(int32_t{0}).Finish());
+    return true;
+  }
+
+  // Lea tmp, base, offset ; Deref dest, tmp => LoadField dest, base, offset
+  bool TryFuseLoadField(const std::size_t idx, const std::size_t next) {
+    const auto lea = instrs_[idx].Decode();
+    if (lea.CurrentBytecode() != Bytecode::Lea) {
+      return false;
+    }
+    const LocalVar tmp = lea.GetLocalOperand(0);
+    if (tmp.GetAddressMode() != LocalVar::AddressMode::Address || !IsSingleUseTemp(tmp)) {
+      return false;
+    }
+    const auto deref = instrs_[next].Decode();
+    const Bytecode bytecode = deref.CurrentBytecode();
+    if (bytecode != Bytecode::Deref1 && bytecode != Bytecode::Deref2 && bytecode != Bytecode::Deref4 &&
+        bytecode != Bytecode::Deref8 && bytecode != Bytecode::DerefN) {
+      return false;
+    }
+    if (!(deref.GetLocalOperand(1) == tmp.ValueOf())) {
+      return false;
+    }
+    InstructionWriter writer(DerefToLoadField(bytecode));
+    writer.Write(deref.GetLocalOperand(0))
+        .Write(lea.GetLocalOperand(1))
+        .Write(static_cast<int32_t>(lea.GetImmediateIntegerOperand(2)));
+    if (bytecode == Bytecode::DerefN) {
+      writer.Write(static_cast<uint32_t>(deref.GetUnsignedImmediateIntegerOperand(2)));
+    }
+    Replace(idx, writer.Finish());
+    return true;
+  }
+
+  // op tmp, ... ; Assign dest, tmp => op dest, ...
+  bool TryForwardMove(const std::size_t idx, const std::size_t next) {
+    const auto producer = instrs_[idx].Decode();
+    if (!IsPureProducer(producer.CurrentBytecode())) {
+      return false;
+    }
+    const LocalVar tmp = producer.GetLocalOperand(0);
+    if (tmp.GetAddressMode() != LocalVar::AddressMode::Address || !IsSingleUseTemp(tmp)) {
+      return false;
+    }
+    const auto assign = instrs_[next].Decode();
+    if (!IsAssign(assign.CurrentBytecode()) || !(assign.GetLocalOperand(1) == tmp.ValueOf())) {
+      return false;
+    }
+    // The generator writes small integer literals into wider locals with AssignImm4. Forwarding such a write would
+    // leave the upper bytes of the destination untouched.
+    const uint32_t width = WriteWidth(producer.CurrentBytecode());
+    if (width != 0 && width != WriteWidth(assign.CurrentBytecode())) {
+      return false;
+    }
+    // The producer must not read the destination, directly or through a pointer held in it.
+    const LocalVar dest = assign.GetLocalOperand(0);
+    if (References(instrs_[idx], dest.GetOffset())) {
+      return false;
+    }
+    auto bytes = instrs_[idx].bytes_;
+    const auto encoded = dest.Encode();
+    std::memcpy(&bytes[Bytecodes::GetNthOperandOffset(producer.CurrentBytecode(), 0)], &encoded, sizeof(encoded));
+    Replace(idx, std::move(bytes));
+    return true;
+  }
+
+  // Assign x, x
+  static bool IsSelfAssign(const Instruction &instr) {
+    const auto iter = instr.Decode();
+    if (!IsAssign(iter.CurrentBytecode())) {
+      return false;
+    }
+    const LocalVar dest = iter.GetLocalOperand(0), src = iter.GetLocalOperand(1);
+    return dest.GetAddressMode() == LocalVar::AddressMode::Address && src == dest.ValueOf();
+  }
+
+  // A side-effect free write to a temporary that's never read.
+  bool IsDeadStore(const Instruction &instr) const {
+    const auto iter = instr.Decode();
+    if (!IsPureProducer(iter.CurrentBytecode())) {
+      return false;
+    }
+    const LocalVar dest = iter.GetLocalOperand(0);
+    const auto refs = refs_.find(dest.GetOffset());
+    return dest.GetAddressMode() == LocalVar::AddressMode::Address && params_.count(dest.GetOffset()) == 0 &&
+           refs != refs_.end() && refs->second == 1;
+  }
+
+ private:
+  // Where the statistics go.
+  BytecodeOptimizer::Stats *stats_;
+  // The instructions of the function, in their original order.
+  std::vector<Instruction> instrs_;
+  // The original positions that are targets of some jump.
+  std::unordered_set<std::size_t> jump_targets_;
+  // The frame offsets of the parameters.
+  std::unordered_set<uint32_t> params_;
+  // The number of references to each local, keyed by frame offset.
+  std::unordered_map<uint32_t, int32_t> refs_;
+};
+
+}  // namespace
+
+// static
+BytecodeOptimizer::Stats BytecodeOptimizer::Optimize(std::vector<uint8_t> *code, std::vector<FunctionInfo> *functions) {
+  Stats stats;
+  stats.size_before_ = code->size();
+
+  std::vector<uint8_t> optimized;
+  optimized.reserve(code->size());
+  for (auto &func : *functions) {
+    if (func.GetBytecodeRange().first == func.GetBytecodeRange().second) {
+      continue;
+    }
+    FunctionOptimizer optimizer(*code, func, &stats);
+    optimizer.Run();
+    const std::size_t start = optimized.size();
+    optimizer.Emit(&optimized);
+    func.SetBytecodeRange(start, optimized.size());
+  }
+
+  *code = std::move(optimized);
+  stats.size_after_ = code->size();
+  return stats;
+}
+
+}  // namespace terrier::execution::vm
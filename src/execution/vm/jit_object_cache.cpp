@@ -0,0 +1,261 @@
+#include "execution/vm/jit_object_cache.h"
+
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/Path.h>
+#include <llvm/Support/raw_ostream.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "common/hash_util.h"
+#include "execution/ast/type.h"
+#include "execution/vm/bytecode_module.h"
+#include "loggers/execution_logger.h"
+#include "spdlog/fmt/fmt.h"
+
+namespace terrier::execution::vm {
+
+namespace {
+
+// The extension of cache entries.
+constexpr const char *K_ENTRY_EXTENSION = ".to";
+
+// Every entry starts with this header.
+struct EntryHeader {
+  // Identifies the file as a cache entry.
+  uint64_t magic_;
+  // The key the entry was stored under. Guards against renamed files.
+  uint64_t key_;
+  // The version of the code generator.
+  uint64_t version_;
+  // The size of the fingerprint of the module following the header.
+  uint64_t fingerprint_size_;
+  // The size of the object file following the fingerprint.
+  uint64_t object_size_;
+};
+
+constexpr uint64_t K_ENTRY_MAGIC = 0x324843434f4c5054;  // "TPLOCCH2"
+
+// Append a value to a fingerprint.
+template <typename T>
+void AppendValue(const T value, std::string *fingerprint) {
+  fingerprint->append(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+// Append bytes to a fingerprint, preceded by their number so that consecutive fields can't run into each other.
+void AppendBytes(const void *data, const std::size_t size, std::string *fingerprint) {
+  AppendValue<uint64_t>(size, fingerprint);
+  fingerprint->append(reinterpret_cast<const char *>(data), size);
+}
+
+// Parse the key out of the name of an entry. Returns false if the name doesn't belong to an entry.
+bool ParseEntryName(llvm::StringRef file_name, JitObjectCache::Key *key) {
+  if (!file_name.consume_back(K_ENTRY_EXTENSION)) {
+    return false;
+  }
+  return !file_name.getAsInteger(16, *key);
+}
+
+}  // namespace
+
+std::atomic<JitObjectCache *> JitObjectCache::instance{nullptr};
+
+JitObjectCache::JitObjectCache(std::string directory, const uint64_t max_size_bytes)
+    : directory_(std::move(directory)), max_size_bytes_(max_size_bytes) {
+  std::lock_guard<std::mutex> lock(latch_);
+
+  if (std::error_code error = llvm::sys::fs::create_directories(directory_)) {
+    EXECUTION_LOG_ERROR("JIT cache: Unable to create directory '{}': {}", directory_, error.message());
+    return;
+  }
+
+  // Pick up the entries of previous runs. The least recently used entries are the oldest files.
+  std::vector<std::pair<llvm::sys::TimePoint<>, Key>> found;
+  std::error_code error;
+  for (llvm::sys::fs::directory_iterator iter(directory_, error), end; iter != end && !error; iter.increment(error)) {
+    Key key;
+    auto status = iter->status();
+    if (!status || !ParseEntryName(llvm::sys::path::filename(iter->path()), &key)) {
+      continue;
+    }
+    entries_[key] = Entry{status->getSize(), 0};
+    total_size_ += status->getSize();
+    found.emplace_back(status->getLastModificationTime(), key);
+  }
+  std::sort(found.begin(), found.end());
+  for (const auto &[_, key] : found) {
+    entries_[key].last_use_ = ++clock_;
+  }
+
+  EXECUTION_LOG_INFO("JIT cache: Opened '{}' with {} entries ({:.2f} MB)", directory_, entries_.size(),
+                     total_size_ / 1024.0 / 1024.0);
+
+  EvictIfNeeded();
+}
+
+std::string JitObjectCache::ComputeFingerprint(const BytecodeModule &module) {
+  // The generated code depends on the bytecode, the layout of each function's frame and the types of its locals
+  // (which determine the LLVM types), the function symbols, and the static data baked into the object.
+  std::string fingerprint;
+  AppendBytes(module.code_.data(), module.code_.size(), &fingerprint);
+  AppendBytes(module.data_.data(), module.data_.size(), &fingerprint);
+  AppendValue<uint64_t>(module.GetFunctionCount(), &fingerprint);
+  for (const auto &func : module.GetFunctionsInfo()) {
+    AppendBytes(func.GetName().data(), func.GetName().size(), &fingerprint);
+    AppendValue<uint64_t>(func.GetBytecodeRange().first, &fingerprint);
+    AppendValue<uint64_t>(func.GetBytecodeRange().second, &fingerprint);
+    AppendValue<uint32_t>(func.GetParamsCount(), &fingerprint);
+    AppendValue<uint64_t>(func.GetLocals().size(), &fingerprint);
+    for (const auto &local : func.GetLocals()) {
+      const std::string type = local.GetType()->ToString();
+      AppendValue<uint32_t>(local.GetOffset(), &fingerprint);
+      AppendBytes(type.data(), type.size(), &fingerprint);
+    }
+  }
+  AppendValue<uint64_t>(module.GetStaticLocalsInfo().size(), &fingerprint);
+  for (const auto &local : module.GetStaticLocalsInfo()) {
+    AppendValue<uint32_t>(local.GetOffset(), &fingerprint);
+    AppendValue<uint32_t>(local.GetSize(), &fingerprint);
+  }
+  return fingerprint;
+}
+
+JitObjectCache::Key JitObjectCache::ComputeKey(const std::string_view fingerprint) {
+  return common::HashUtil::Hash(fingerprint);
+}
+
+std::string JitObjectCache::EntryPath(const Key key) const {
+  llvm::SmallString<128> path(directory_);
+  llvm::sys::path::append(path, fmt::format("{:016x}{}", key, K_ENTRY_EXTENSION));
+  return path.str().str();
+}
+
+std::unique_ptr<llvm::MemoryBuffer> JitObjectCache::Lookup(const Key key, const std::string_view fingerprint,
+                                                           const uint64_t version) {
+  const std::string path = EntryPath(key);
+
+  std::lock_guard<std::mutex> lock(latch_);
+
+  auto iter = entries_.find(key);
+  if (iter == entries_.end()) {
+    num_misses_.fetch_add(1, std::memory_order_relaxed);
+    return nullptr;
+  }
+
+  auto file = llvm::MemoryBuffer::getFile(path, -1, false);
+  if (std::error_code error = file.getError()) {
+    // Removed behind our back, e.g., by another process sharing the directory.
+    EXECUTION_LOG_DEBUG("JIT cache: Unable to read '{}': {}", path, error.message());
+    total_size_ -= iter->second.size_;
+    entries_.erase(iter);
+    num_misses_.fetch_add(1, std::memory_order_relaxed);
+    return nullptr;
+  }
+
+  const auto &buffer = *file.get();
+  EntryHeader header{};
+  if (buffer.getBufferSize() >= sizeof(header)) {
+    std::memcpy(&header, buffer.getBufferStart(), sizeof(header));
+  }
+  const bool valid = header.magic_ == K_ENTRY_MAGIC && header.key_ == key &&
+                     header.fingerprint_size_ <= buffer.getBufferSize() - sizeof(header) &&
+                     header.object_size_ == buffer.getBufferSize() - sizeof(header) - header.fingerprint_size_;
+  if (!valid || header.version_ != version) {
+    // Corrupt, or produced by another build or for another CPU. It will never be of use.
+    EXECUTION_LOG_DEBUG("JIT cache: Dropping {} entry '{}'", valid ? "stale" : "invalid", path);
+    RemoveEntry(key);
+    num_misses_.fetch_add(1, std::memory_order_relaxed);
+    return nullptr;
+  }
+  if (std::string_view(buffer.getBufferStart() + sizeof(header), header.fingerprint_size_) != fingerprint) {
+    // Another module whose key collides. Its entry stays until this module's object replaces it.
+    EXECUTION_LOG_DEBUG("JIT cache: Entry '{}' belongs to another module", path);
+    num_misses_.fetch_add(1, std::memory_order_relaxed);
+    return nullptr;
+  }
+
+  // Record the use, also in the file system so the order survives restarts.
+  iter->second.last_use_ = ++clock_;
+  ::utimes(path.c_str(), nullptr);
+  num_hits_.fetch_add(1, std::memory_order_relaxed);
+
+  // The object must be suitably aligned for the object file reader, so copy it out rather than returning a slice.
+  return llvm::MemoryBuffer::getMemBufferCopy(
+      llvm::StringRef(buffer.getBufferStart() + sizeof(header) + header.fingerprint_size_, header.object_size_), path);
+}
+
+void JitObjectCache::Insert(const Key key, const std::string_view fingerprint, const uint64_t version,
+                            const llvm::MemoryBuffer &object) {
+  const std::string path = EntryPath(key);
+  // Unique across threads and processes that may be inserting the same entry.
+  const std::string tmp_path = fmt::format("{}.{}.{}.tmp", path, ::getpid(), reinterpret_cast<uintptr_t>(&object));
+
+  const EntryHeader header{K_ENTRY_MAGIC, key, version, fingerprint.size(), object.getBufferSize()};
+  {
+    std::error_code error;
+    llvm::raw_fd_ostream out(tmp_path, error, llvm::sys::fs::F_None);
+    if (error) {
+      EXECUTION_LOG_ERROR("JIT cache: Unable to create '{}': {}", tmp_path, error.message());
+      return;
+    }
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    out.write(fingerprint.data(), fingerprint.size());
+    out.write(object.getBufferStart(), object.getBufferSize());
+    out.close();
+    if (out.has_error()) {
+      EXECUTION_LOG_ERROR("JIT cache: Unable to write '{}'", tmp_path);
+      out.clear_error();
+      llvm::sys::fs::remove(tmp_path);
+      return;
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(latch_);
+
+  if (std::error_code error = llvm::sys::fs::rename(tmp_path, path)) {
+    EXECUTION_LOG_ERROR("JIT cache: Unable to install '{}': {}", path, error.message());
+    llvm::sys::fs::remove(tmp_path);
+    return;
+  }
+
+  const uint64_t size = sizeof(header) + fingerprint.size() + object.getBufferSize();
+  auto &entry = entries_[key];
+  total_size_ = total_size_ - entry.size_ + size;
+  entry = Entry{size, ++clock_};
+
+  EvictIfNeeded();
+}
+
+void JitObjectCache::Clear() {
+  std::lock_guard<std::mutex> lock(latch_);
+  while (!entries_.empty()) {
+    RemoveEntry(entries_.begin()->first);
+  }
+}
+
+void JitObjectCache::RemoveEntry(const Key key) {
+  const auto iter = entries_.find(key);
+  TERRIER_ASSERT(iter != entries_.end(), "Removing unknown entry");
+  llvm::sys::fs::remove(EntryPath(key));
+  total_size_ -= iter->second.size_;
+  entries_.erase(iter);
+}
+
+void JitObjectCache::EvictIfNeeded() {
+  while (total_size_ > max_size_bytes_ && !entries_.empty()) {
+    const auto victim = std::min_element(entries_.begin(), entries_.end(), [](const auto &a, const auto &b) {
+      return a.second.last_use_ < b.second.last_use_;
+    });
+    EXECUTION_LOG_DEBUG("JIT cache: Evicting {:016x} ({} bytes)", victim->first, victim->second.size_);
+    RemoveEntry(victim->first);
+    num_evictions_.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+}  // namespace terrier::execution::vm
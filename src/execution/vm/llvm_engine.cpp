@@ -1,5 +1,6 @@
 #include "execution/vm/llvm_engine.h"
 
+#include <llvm/ADT/DenseSet.h>
 #include <llvm/ADT/StringMap.h>
 #include <llvm/Analysis/TargetLibraryInfo.h>
 #include <llvm/Analysis/TargetTransformInfo.h>
@@ -7,6 +8,7 @@
 #include <llvm/ExecutionEngine/RuntimeDyld.h>
 #include <llvm/ExecutionEngine/SectionMemoryManager.h>
 #include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/InstIterator.h>
 #include <llvm/IR/LLVMContext.h>
 #include <llvm/IR/LegacyPassManager.h>
 #include <llvm/IR/Verifier.h>
@@ -23,14 +25,17 @@
 
 #include <map>
 #include <memory>
+#include <mutex>  // NOLINT
 #include <string>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
+#include "common/hash_util.h"
 #include "execution/ast/type.h"
 #include "execution/vm/bytecode_module.h"
 #include "execution/vm/bytecode_traits.h"
+#include "execution/vm/jit_object_cache.h"
 #include "loggers/execution_logger.h"
 
 extern void *__dso_handle __attribute__((__visibility__("hidden")));  // NOLINT
@@ -49,6 +54,50 @@ bool FunctionHasDirectReturn(const ast::FunctionType *func_type) {
   return (!ret_type->IsNilType() && ret_type->GetSize() <= sizeof(int64_t));
 }
 
+// The pre-compiled bytecode handlers, shared by all compilations in the process.
+struct BytecodeHandlers {
+  // The raw bitcode. Each compilation lazily parses the functions it needs out of it, into its own LLVM context.
+  std::unique_ptr<llvm::MemoryBuffer> bitcode_;
+  // The version of the code generator: generated code depends on the handlers and on the target machine.
+  uint64_t version_;
+};
+
+// Load the bytecode handlers in the given file. The handlers don't change while the process runs, so each file is only
+// read once.
+const BytecodeHandlers &GetBytecodeHandlers(const std::string &path) {
+  static std::mutex latch;
+  static std::unordered_map<std::string, BytecodeHandlers> handlers;
+
+  std::lock_guard<std::mutex> lock(latch);
+  if (const auto iter = handlers.find(path); iter != handlers.end()) {
+    return iter->second;
+  }
+
+  auto file = llvm::MemoryBuffer::getFile(path);
+  if (auto error = file.getError()) {
+    EXECUTION_LOG_ERROR("There was an error loading the handler bytecode: {}", error.message());
+    throw std::runtime_error(error.message());
+  }
+
+  auto hash = common::HashUtil::Hash(llvm::sys::getProcessTriple());
+  hash = common::HashUtil::CombineHashes(hash, common::HashUtil::Hash(llvm::sys::getHostCPUName().str()));
+  llvm::StringMap<bool> feature_map;
+  llvm::sys::getHostCPUFeatures(feature_map);
+  std::map<std::string, bool> features;  // Ordered, unlike the StringMap.
+  for (const auto &entry : feature_map) {
+    features.emplace(entry.getKey().str(), entry.getValue());
+  }
+  for (const auto &[feature, enabled] : features) {
+    hash = common::HashUtil::CombineHashes(hash, common::HashUtil::Hash(feature));
+    hash = common::HashUtil::CombineHashes(hash, common::HashUtil::Hash(enabled));
+  }
+  const auto &buffer = *file.get();
+  const auto *data = reinterpret_cast<const uint8_t *>(buffer.getBufferStart());
+  hash = common::HashUtil::CombineHashes(hash, common::HashUtil::Hash(data, buffer.getBufferSize()));
+
+  return handlers.emplace(path, BytecodeHandlers{std::move(file.get()), hash}).first->second;
+}
+
 }  // namespace
 
 // ---------------------------------------------------------
@@ -369,6 +418,10 @@ class LLVMEngine::CompiledModuleBuilder {
   // declarations before they can be defined.
   void DefineFunctions();
 
+  // Materialize the bodies of all handler functions used by the generated functions, and drop all others.
+  // DefineFunctions() must have been called.
+  void MaterializeUsedHandlers();
+
   // Verify that all generated code is good
   void Verify();
 
@@ -478,12 +531,10 @@ LLVMEngine::CompiledModuleBuilder::CompiledModuleBuilder(const CompilerOptions &
   //
 
   {
-    auto memory_buffer = llvm::MemoryBuffer::getFile(options.GetBytecodeHandlersBcPath());
-    if (auto error = memory_buffer.getError()) {
-      EXECUTION_LOG_ERROR("There was an error loading the handler bytecode: {}", error.message());
-    }
-
-    auto module = llvm::parseBitcodeFile(*(memory_buffer.get()), *context_);
+    // Only the module's types and declarations are parsed here. Function bodies are materialized on demand, once the
+    // functions we generate reveal which handlers are actually used.
+    const auto &bitcode = GetBytecodeHandlers(options.GetBytecodeHandlersBcPath()).bitcode_;
+    auto module = llvm::getLazyBitcodeModule(bitcode->getMemBufferRef(), *context_);
     if (!module) {
       auto error = llvm::toString(module.takeError());
       EXECUTION_LOG_ERROR("{}", error);
@@ -601,8 +652,9 @@ void LLVMEngine::CompiledModuleBuilder::BuildSimpleCFG(const FunctionInfo &func_
           (*blocks)[fallthrough_pos] = nullptr;
         }
 
-        std::size_t branch_target_pos =
-            iter.GetPosition() + Bytecodes::GetNthOperandOffset(bytecode, 1) + iter.GetJumpOffsetOperand(1);
+        const uint32_t offset_idx = Bytecodes::GetJumpOffsetOperandIndex(bytecode);
+        std::size_t branch_target_pos = iter.GetPosition() + Bytecodes::GetNthOperandOffset(bytecode, offset_idx) +
+                                        iter.GetJumpOffsetOperand(offset_idx);
 
         if (blocks->find(branch_target_pos) == blocks->end()) {
           bb_begin_positions.push_back(branch_target_pos);
@@ -892,7 +944,22 @@ void LLVMEngine::CompiledModuleBuilder::DefineFunction(const FunctionInfo &func_
       default: {
         // In the default case, each bytecode makes a function call into its bytecode handler
         llvm::Function *handler = LookupBytecodeHandler(bytecode);
-        issue_call(handler, args);
+        llvm::Value *result = issue_call(handler, args);
+
+        // Fused conditional jumps return whether the jump is taken.
+        if (Bytecodes::IsFusedConditionalJump(bytecode)) {
+          const uint32_t offset_idx = Bytecodes::GetJumpOffsetOperandIndex(bytecode);
+          std::size_t fallthrough_bb_pos = iter.GetPosition() + iter.CurrentBytecodeSize();
+          std::size_t branch_target_bb_pos = iter.GetPosition() + Bytecodes::GetNthOperandOffset(bytecode, offset_idx) +
+                                             iter.GetJumpOffsetOperand(offset_idx);
+          TERRIER_ASSERT(blocks[fallthrough_bb_pos] != nullptr, "Branch fallthrough does not point to valid block");
+          TERRIER_ASSERT(blocks[branch_target_bb_pos] != nullptr, "Branch target does not point to valid block");
+
+          if (!result->getType()->isIntegerTy(1)) {
+            result = ir_builder->CreateICmpNE(result, llvm::ConstantInt::get(result->getType(), 0));
+          }
+          ir_builder->CreateCondBr(result, blocks[branch_target_bb_pos], blocks[fallthrough_bb_pos]);
+        }
         break;
       }
     }
@@ -919,6 +986,73 @@ void LLVMEngine::CompiledModuleBuilder::DefineFunctions() {
   }
 }
 
+void LLVMEngine::CompiledModuleBuilder::MaterializeUsedHandlers() {
+  // Walk everything reachable from the functions we generated. Handlers call other functions in the bitcode, and may
+  // refer to functions and global variables through constants.
+  llvm::DenseSet<const llvm::Constant *> visited;
+  llvm::SmallVector<llvm::Function *, 64> worklist;
+  llvm::SmallVector<const llvm::Constant *, 64> constants;
+
+  const auto visit_constant = [&](const llvm::Constant *constant) {
+    constants.push_back(constant);
+    while (!constants.empty()) {
+      const llvm::Constant *next = constants.pop_back_val();
+      if (!visited.insert(next).second) {
+        continue;
+      }
+      if (const auto *func = llvm::dyn_cast<llvm::Function>(next)) {
+        worklist.push_back(const_cast<llvm::Function *>(func));  // NOLINT
+      } else if (const auto *global = llvm::dyn_cast<llvm::GlobalVariable>(next)) {
+        if (global->hasInitializer()) {
+          constants.push_back(global->getInitializer());
+        }
+      } else if (const auto *alias = llvm::dyn_cast<llvm::GlobalAlias>(next)) {
+        constants.push_back(alias->getAliasee());
+      } else {
+        for (const auto &operand : next->operands()) {
+          constants.push_back(llvm::cast<llvm::Constant>(operand));
+        }
+      }
+    }
+  };
+
+  for (const auto &func_info : tpl_module_.GetFunctionsInfo()) {
+    visit_constant(llvm_module_->getFunction(func_info.GetName()));
+  }
+
+  while (!worklist.empty()) {
+    llvm::Function *func = worklist.pop_back_val();
+    if (auto error = func->materialize()) {
+      auto message = llvm::toString(std::move(error));
+      EXECUTION_LOG_ERROR("Unable to materialize '{}': {}", func->getName().str(), message);
+      throw std::runtime_error(message);
+    }
+    if (func->hasPersonalityFn()) {
+      visit_constant(func->getPersonalityFn());
+    }
+    for (const auto &inst : llvm::instructions(func)) {
+      for (const auto &operand : inst.operands()) {
+        if (const auto *constant = llvm::dyn_cast<llvm::Constant>(operand)) {
+          visit_constant(constant);
+        }
+      }
+    }
+  }
+
+  // Everything that's still materializable is unused; turn it into a declaration so it is never parsed. Unused
+  // declarations are removed by Simplify().
+  for (auto &func : *llvm_module_) {
+    if (func.isMaterializable()) {
+      func.deleteBody();
+    }
+  }
+  if (auto error = llvm_module_->materializeAll()) {
+    auto message = llvm::toString(std::move(error));
+    EXECUTION_LOG_ERROR("Unable to materialize the handler module: {}", message);
+    throw std::runtime_error(message);
+  }
+}
+
 void LLVMEngine::CompiledModuleBuilder::Verify() {
   std::string result;
   llvm::raw_string_ostream ostream(result);
@@ -1145,6 +1279,26 @@ void LLVMEngine::Shutdown() { llvm::llvm_shutdown(); }
 
 std::unique_ptr<LLVMEngine::CompiledModule> LLVMEngine::Compile(const BytecodeModule &module,
                                                                 const CompilerOptions &options) {
+  // Try loading a module compiled earlier, possibly by a previous process. This skips parsing the handlers, all
+  // optimization passes and code generation.
+  JitObjectCache *const cache = options.GetObjectCache();
+  std::string fingerprint;
+  JitObjectCache::Key key = 0;
+  uint64_t version = 0;
+  if (cache != nullptr) {
+    fingerprint = JitObjectCache::ComputeFingerprint(module);
+    key = JitObjectCache::ComputeKey(fingerprint);
+    version = GetBytecodeHandlers(options.GetBytecodeHandlersBcPath()).version_;
+    if (auto object = cache->Lookup(key, fingerprint, version)) {
+      auto compiled_module = std::make_unique<CompiledModule>(std::move(object));
+      compiled_module->Load(module);
+      if (compiled_module->IsLoaded()) {
+        EXECUTION_LOG_DEBUG("LLVMEngine: Loaded module '{}' from the JIT cache", module.GetName());
+        return compiled_module;
+      }
+    }
+  }
+
   CompiledModuleBuilder builder(options, module);
 
   builder.DeclareStaticLocals();
@@ -1153,6 +1307,8 @@ std::unique_ptr<LLVMEngine::CompiledModule> LLVMEngine::Compile(const BytecodeMo
 
   builder.DefineFunctions();
 
+  builder.MaterializeUsedHandlers();
+
   builder.Simplify();
 
   builder.Verify();
@@ -1163,6 +1319,10 @@ std::unique_ptr<LLVMEngine::CompiledModule> LLVMEngine::Compile(const BytecodeMo
 
   compiled_module->Load(module);
 
+  if (cache != nullptr && compiled_module->IsLoaded()) {
+    cache->Insert(key, fingerprint, version, compiled_module->GetModuleObjectCode());
+  }
+
   return compiled_module;
 }
 
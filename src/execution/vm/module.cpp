@@ -1,12 +1,11 @@
 #include "execution/vm/module.h"
 
-#include <tbb/task.h>  // NOLINT
-
 #include <memory>
 #include <mutex>  // NOLINT
 #include <string>
 #include <utility>
 
+#include "execution/vm/jit_object_cache.h"
 #include "loggers/execution_logger.h"
 
 #define XBYAK_NO_OP_NAMES
@@ -14,28 +13,6 @@
 
 namespace terrier::execution::vm {
 
-// ---------------------------------------------------------
-// Async Compile Task
-// ---------------------------------------------------------
-
-// This class encapsulates the ability to asynchronously JIT compile a module.
-class Module::AsyncCompileTask : public tbb::task {
- public:
-  // Construct an asynchronous compilation task to compile the the module
-  explicit AsyncCompileTask(Module *module) : module_(module) {}
-
-  // Execute
-  tbb::task *execute() override {
-    // This simply invokes Module::CompileToMachineCode() asynchronously.
-    module_->CompileToMachineCode();
-    // Done. There's no next task, so return null.
-    return nullptr;
-  }
-
- private:
-  Module *module_;
-};
-
 // ---------------------------------------------------------
 // Module
 // ---------------------------------------------------------
@@ -65,6 +42,14 @@ Module::Module(std::unique_ptr<BytecodeModule> bytecode_module, std::unique_ptr<
       auto func_info = bytecode_module_->GetFuncInfoById(idx);
       functions_[idx] = jit_module_->GetFunctionPointer(func_info->GetName());
     }
+    compiled_ = true;
+  }
+}
+
+Module::~Module() {
+  // A pending compilation task holds a pointer to this module. Make sure it never runs, or has finished.
+  if (async_compile_requested_.load()) {
+    BackgroundCompiler::Instance()->CancelOrWait(async_compile_task_);
   }
 }
 
@@ -272,6 +257,7 @@ void Module::CompileToMachineCode() {
 
     // JIT the module.
     LLVMEngine::CompilerOptions options;
+    options.SetObjectCache(JitObjectCache::Instance());
     jit_module_ = LLVMEngine::Compile(*bytecode_module_, options);
 
     // JIT completed successfully. For each function in the module, pull out its
@@ -280,14 +266,17 @@ void Module::CompileToMachineCode() {
     for (const auto &func_info : bytecode_module_->GetFunctionsInfo()) {
       auto *jit_function = jit_module_->GetFunctionPointer(func_info.GetName());
       TERRIER_ASSERT(jit_function != nullptr, "Missing function in compiled module!");
-      functions_[func_info.GetId()].store(jit_function, std::memory_order_relaxed);
+      functions_[func_info.GetId()].store(jit_function, std::memory_order_release);
     }
+    compiled_.store(true, std::memory_order_release);
   });
 }
 
 void Module::CompileToMachineCodeAsync() {
-  auto *compile_task = new (tbb::task::allocate_root()) AsyncCompileTask(this);
-  tbb::task::enqueue(*compile_task);
+  if (IsCompiled() || async_compile_requested_.exchange(true)) {
+    return;
+  }
+  async_compile_task_ = BackgroundCompiler::Instance()->Submit([this] { CompileToMachineCode(); });
 }
 
 }  // namespace terrier::execution::vm
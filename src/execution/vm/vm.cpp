@@ -356,6 +356,41 @@ void VM::Interpret(const uint8_t *ip, Frame *frame) {  // NOLINT
     DISPATCH_NEXT();
   }
 
+#define DO_GEN_COMPARE_JUMP(op, type)                 \
+  OP(op##JumpIfFalse##_##type) : {                    \
+    auto lhs = frame->LocalAt<type>(READ_LOCAL_ID()); \
+    auto rhs = frame->LocalAt<type>(READ_LOCAL_ID()); \
+    auto skip = PEEK_JMP_OFFSET();                    \
+    if (Op##op##JumpIfFalse##_##type(lhs, rhs)) {     \
+      ip += skip;                                     \
+    } else {                                          \
+      READ_JMP_OFFSET();                              \
+    }                                                 \
+    DISPATCH_NEXT();                                  \
+  }
+#define GEN_COMPARE_JUMP_TYPES(type, ...)     \
+  DO_GEN_COMPARE_JUMP(GreaterThan, type)      \
+  DO_GEN_COMPARE_JUMP(GreaterThanEqual, type) \
+  DO_GEN_COMPARE_JUMP(Equal, type)            \
+  DO_GEN_COMPARE_JUMP(LessThan, type)         \
+  DO_GEN_COMPARE_JUMP(LessThanEqual, type)    \
+  DO_GEN_COMPARE_JUMP(NotEqual, type)
+
+  ALL_TYPES(GEN_COMPARE_JUMP_TYPES)
+#undef GEN_COMPARE_JUMP_TYPES
+#undef DO_GEN_COMPARE_JUMP
+
+  OP(ForceBoolTruthJumpIfFalse) : {
+    auto *sql_bool = frame->LocalAt<sql::BoolVal *>(READ_LOCAL_ID());
+    auto skip = PEEK_JMP_OFFSET();
+    if (OpForceBoolTruthJumpIfFalse(sql_bool)) {
+      ip += skip;
+    } else {
+      READ_JMP_OFFSET();
+    }
+    DISPATCH_NEXT();
+  }
+
   // -------------------------------------------------------
   // Low-level memory operations
   // -------------------------------------------------------
@@ -443,6 +478,29 @@ void VM::Interpret(const uint8_t *ip, Frame *frame) {  // NOLINT
     DISPATCH_NEXT();
   }
 
+#define GEN_LOAD_FIELD(type, size)                        \
+  OP(LoadField##size) : {                                 \
+    auto *dest = frame->LocalAt<type *>(READ_LOCAL_ID()); \
+    auto *base = frame->LocalAt<byte *>(READ_LOCAL_ID()); \
+    auto offset = READ_UIMM4();                           \
+    OpLoadField##size(dest, base, offset);                \
+    DISPATCH_NEXT();                                      \
+  }
+  GEN_LOAD_FIELD(int8_t, 1);
+  GEN_LOAD_FIELD(int16_t, 2);
+  GEN_LOAD_FIELD(int32_t, 4);
+  GEN_LOAD_FIELD(int64_t, 8);
+#undef GEN_LOAD_FIELD
+
+  OP(LoadFieldN) : {
+    auto *dest = frame->LocalAt<byte *>(READ_LOCAL_ID());
+    auto *base = frame->LocalAt<byte *>(READ_LOCAL_ID());
+    auto offset = READ_UIMM4();
+    auto len = READ_UIMM4();
+    OpLoadFieldN(dest, base, offset, len);
+    DISPATCH_NEXT();
+  }
+
   OP(Call) : {
     ip = ExecuteCall(ip, frame);
     DISPATCH_NEXT();
@@ -1752,6 +1810,58 @@ void VM::Interpret(const uint8_t *ip, Frame *frame) {  // NOLINT
     DISPATCH_NEXT();
   }
 
+  // -------------------------------------------------------
+  // Window functions
+  // -------------------------------------------------------
+
+  OP(WindowEvaluatorInit) : {
+    auto *evaluator = frame->LocalAt<sql::WindowEvaluator *>(READ_LOCAL_ID());
+    auto same_partition_func_id = READ_FUNC_ID();
+    auto same_peer_func_id = READ_FUNC_ID();
+
+    auto same_partition_fn =
+        reinterpret_cast<sql::WindowEvaluator::KeyEqualFn>(module_->GetRawFunctionImpl(same_partition_func_id));
+    auto same_peer_fn =
+        reinterpret_cast<sql::WindowEvaluator::KeyEqualFn>(module_->GetRawFunctionImpl(same_peer_func_id));
+    OpWindowEvaluatorInit(evaluator, same_partition_fn, same_peer_fn);
+    DISPATCH_NEXT();
+  }
+
+  OP(WindowEvaluatorAddFunction) : {
+    auto *evaluator = frame->LocalAt<sql::WindowEvaluator *>(READ_LOCAL_ID());
+    auto function = frame->LocalAt<uint32_t>(READ_LOCAL_ID());
+    auto type = frame->LocalAt<uint32_t>(READ_LOCAL_ID());
+    auto arg_offset = frame->LocalAt<uint32_t>(READ_LOCAL_ID());
+    auto result_offset = frame->LocalAt<uint32_t>(READ_LOCAL_ID());
+    auto offset = frame->LocalAt<int64_t>(READ_LOCAL_ID());
+    OpWindowEvaluatorAddFunction(evaluator, function, type, arg_offset, result_offset, offset);
+    DISPATCH_NEXT();
+  }
+
+  OP(WindowEvaluatorSetFrame) : {
+    auto *evaluator = frame->LocalAt<sql::WindowEvaluator *>(READ_LOCAL_ID());
+    auto frame_type = frame->LocalAt<uint32_t>(READ_LOCAL_ID());
+    auto start = frame->LocalAt<uint32_t>(READ_LOCAL_ID());
+    auto start_offset = frame->LocalAt<int64_t>(READ_LOCAL_ID());
+    auto end = frame->LocalAt<uint32_t>(READ_LOCAL_ID());
+    auto end_offset = frame->LocalAt<int64_t>(READ_LOCAL_ID());
+    OpWindowEvaluatorSetFrame(evaluator, frame_type, start, start_offset, end, end_offset);
+    DISPATCH_NEXT();
+  }
+
+  OP(WindowEvaluatorEvaluate) : {
+    auto *evaluator = frame->LocalAt<sql::WindowEvaluator *>(READ_LOCAL_ID());
+    auto *sorter = frame->LocalAt<sql::Sorter *>(READ_LOCAL_ID());
+    OpWindowEvaluatorEvaluate(evaluator, sorter);
+    DISPATCH_NEXT();
+  }
+
+  OP(WindowEvaluatorFree) : {
+    auto *evaluator = frame->LocalAt<sql::WindowEvaluator *>(READ_LOCAL_ID());
+    OpWindowEvaluatorFree(evaluator);
+    DISPATCH_NEXT();
+  }
+
   // -------------------------------------------------------
   // Output
   // -------------------------------------------------------
@@ -113,5 +113,30 @@ struct Constants {
    * Flag indicating if static partitioner is used
    */
   static constexpr const bool IS_STATIC_PARTITIONER_ENABLED = false;
+
+  /**
+   * Scheduling priority of a query's parallel pipelines relative to other concurrently running queries
+   */
+  static constexpr const uint32_t QUERY_PRIORITY = 1;
+
+  /**
+   * Number of threads dedicated to compiling hot queries in the background
+   */
+  static constexpr const uint32_t NUM_JIT_COMPILE_THREADS = 2;
+
+  /**
+   * Number of interpreted executions after which a tiered query is compiled to machine code
+   */
+  static constexpr const uint64_t JIT_EXECUTION_THRESHOLD = 8;
+
+  /**
+   * Total interpreted execution time (in microseconds) after which a tiered query is compiled to machine code
+   */
+  static constexpr const uint64_t JIT_TIME_THRESHOLD_US = 50000;
+
+  /**
+   * Number of result rows the execution engine buffers before they are serialized for the client together
+   */
+  static constexpr const uint32_t OUTPUT_BATCH_SIZE = 2048;
 };
 }  // namespace terrier::common
@@ -191,6 +191,13 @@ namespace terrier::execution::ast {
   F(SorterIterGetRow, sorterIterGetRow)                                 \
   F(SorterIterClose, sorterIterClose)                                   \
                                                                         \
+  /* Window functions */                                                \
+  F(WindowEvaluatorInit, windowInit)                                    \
+  F(WindowEvaluatorAddFunction, windowAddFunction)                      \
+  F(WindowEvaluatorSetFrame, windowSetFrame)                            \
+  F(WindowEvaluatorEvaluate, windowEvaluate)                            \
+  F(WindowEvaluatorFree, windowFree)                                    \
+                                                                        \
   /* Output */                                                          \
   F(ResultBufferAllocOutRow, resultBufferAllocRow)                      \
   F(ResultBufferFinalize, resultBufferFinalize)                         \
@@ -73,6 +73,7 @@ class Context;
   NON_PRIM(TupleIdList, terrier::execution::sql::TupleIdList)                                   \
   NON_PRIM(VectorProjection, terrier::execution::sql::VectorProjection)                         \
   NON_PRIM(VectorProjectionIterator, terrier::execution::sql::VectorProjectionIterator)         \
+  NON_PRIM(WindowEvaluator, terrier::execution::sql::WindowEvaluator)                           \
   NON_PRIM(IndexIterator, terrier::execution::sql::IndexIterator)                               \
                                                                                                 \
   /* SQL Aggregate types (if you add, remember to update BuiltinType) */                        \
@@ -17,6 +17,7 @@
 #include "execution/ast/type.h"
 #include "execution/sql/runtime_types.h"
 #include "execution/sql/sql.h"
+#include "execution/sql/window_evaluator.h"
 #include "parser/expression_defs.h"
 #include "planner/plannodes/plan_node_defs.h"
 
@@ -1236,6 +1237,14 @@ class CodeGen {
    */
   [[nodiscard]] ast::Expr *SorterIterSkipRows(ast::Expr *iter, uint32_t n);
 
+  /**
+   * Call \@sorterIterSkipRows(). Skips a runtime-computed number of rows in the provided sorter iterator.
+   * @param iter The iterator.
+   * @param n The integer expression computing the number of rows to skip.
+   * @return The call expression.
+   */
+  [[nodiscard]] ast::Expr *SorterIterSkipRows(ast::Expr *iter, ast::Expr *n);
+
   /**
    * Call \@sorterIterGetRow(). Retrieves a pointer to the current iterator row casted to the
    * provided row type.
@@ -1252,6 +1261,65 @@ class CodeGen {
    */
   [[nodiscard]] ast::Expr *SorterIterClose(ast::Expr *iter);
 
+  // -------------------------------------------------------
+  //
+  // Window functions
+  //
+  // -------------------------------------------------------
+
+  /**
+   * Call \@windowInit(). Initialize the provided window evaluator with the functions that check if two sorted rows
+   * belong to the same partition, and if they are peers.
+   * @param evaluator The window evaluator instance.
+   * @param same_partition_fn_name The name of the partition key equality function.
+   * @param same_peer_fn_name The name of the ordering key equality function.
+   * @return The call.
+   */
+  [[nodiscard]] ast::Expr *WindowInit(ast::Expr *evaluator, ast::Identifier same_partition_fn_name,
+                                      ast::Identifier same_peer_fn_name);
+
+  /**
+   * Call \@windowAddFunction(). Add a window function to the provided window evaluator.
+   * @param evaluator The window evaluator instance.
+   * @param function The window function.
+   * @param type The SQL type of the function's argument.
+   * @param arg_offset The offset of the argument in the sorted row.
+   * @param result_offset The offset of the result in the sorted row.
+   * @param offset The offset of LAG and LEAD.
+   * @return The call.
+   */
+  [[nodiscard]] ast::Expr *WindowAddFunction(ast::Expr *evaluator, sql::WindowFunction function, sql::TypeId type,
+                                             ast::Expr *arg_offset, ast::Expr *result_offset, int64_t offset);
+
+  /**
+   * Call \@windowSetFrame(). Set the frame of the last function added to the provided window evaluator.
+   * @param evaluator The window evaluator instance.
+   * @param type The unit of the frame bounds.
+   * @param start The start of the frame.
+   * @param start_offset The offset of the start of the frame.
+   * @param end The end of the frame.
+   * @param end_offset The offset of the end of the frame.
+   * @return The call.
+   */
+  [[nodiscard]] ast::Expr *WindowSetFrame(ast::Expr *evaluator, sql::WindowFrameType type,
+                                          sql::WindowFrameBound start, int64_t start_offset, sql::WindowFrameBound end,
+                                          int64_t end_offset);
+
+  /**
+   * Call \@windowEvaluate(). Compute all window functions over the rows of the provided sorter.
+   * @param evaluator The window evaluator instance.
+   * @param sorter The sorter whose rows are ordered on the partition keys and then the ordering keys.
+   * @return The call.
+   */
+  [[nodiscard]] ast::Expr *WindowEvaluate(ast::Expr *evaluator, ast::Expr *sorter);
+
+  /**
+   * Call \@windowFree(). Destroy the provided window evaluator.
+   * @param evaluator The window evaluator instance.
+   * @return The call.
+   */
+  [[nodiscard]] ast::Expr *WindowFree(ast::Expr *evaluator);
+
   /**
    * Call \@like(). Implements the SQL LIKE() operation.
    * @param str The input string.
@@ -85,6 +85,16 @@ class ExecutableQuery {
      */
     bool IsCompiled() const { return module_ != nullptr; }
 
+    /**
+     * Compile this fragment's module to machine code. This is a blocking call.
+     */
+    void CompileToMachineCode() const;
+
+    /**
+     * @return True if this fragment's module has been compiled to machine code.
+     */
+    bool IsCompiledToMachineCode() const;
+
    private:
     // The functions that must be run (in the provided order) to execute this
     // query fragment.
@@ -126,6 +136,13 @@ class ExecutableQuery {
 
   /**
    * Execute the query.
+   *
+   * In adaptive mode, the query is tiered: it is interpreted until it becomes hot, i.e., until it has been executed a
+   * number of times or has spent a total amount of time in the interpreter as configured by the execution settings of
+   * the context. Then, all fragments are compiled on the background compiler pool while execution continues in the
+   * interpreter. Once compilation finishes, subsequent executions run the compiled code. Because an executable query
+   * may be shared by many sessions through the statement cache, all of them benefit from a single compilation.
+   *
    * @param exec_ctx The context in which to execute the query.
    * @param mode The execution mode to use when running the query. By default, its interpreted.
    */
@@ -159,6 +176,28 @@ class ExecutableQuery {
   /** @return The SQL query string */
   common::ManagedPointer<const std::string> GetQueryText() { return query_text_; }
 
+  /** @return True if this query has been tiered up to compiled code in adaptive mode. */
+  bool IsTieredUp() const;
+
+ private:
+  // State of the tiered (i.e., adaptive) execution of this query.
+  struct TieringState;
+
+  // Run all fragments in the given mode.
+  void RunFragments(common::ManagedPointer<exec::ExecutionContext> exec_ctx, vm::ExecutionMode mode);
+
+  // Run in the interpreter until the query is hot and compiled, then run the compiled code.
+  void RunTiered(common::ManagedPointer<exec::ExecutionContext> exec_ctx);
+
+  // Compile all fragments to machine code, concurrently on the background compiler pool and the calling thread.
+  void CompileFragmentsToMachineCode() const;
+
+  // Compile all fragments for tiering up. Invoked on the background compiler pool.
+  void CompileFragments();
+
+  // Report the compilation latency and the speedup of the first compiled execution.
+  void ReportTierUp(uint64_t compiled_us) const;
+
  private:
   // The plan.
   const planner::AbstractPlanNode &plan_;
@@ -178,6 +217,9 @@ class ExecutableQuery {
   // The pipeline operating units that were generated as part of this query.
   std::unique_ptr<brain::PipelineOperatingUnits> pipeline_operating_units_;
 
+  // State of the tiered execution.
+  std::unique_ptr<TieringState> tiering_;
+
   // For mini_runners.cpp
 
   /** Legacy constructor that creates a hardcoded fragment with main(ExecutionContext*)->int32. */
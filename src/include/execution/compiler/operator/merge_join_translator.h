@@ -0,0 +1,136 @@
+#pragma once
+
+#include <vector>
+
+#include "execution/compiler/operator/operator_translator.h"
+#include "execution/compiler/pipeline.h"
+
+namespace terrier::parser {
+class AbstractExpression;
+}  // namespace terrier::parser
+
+namespace terrier::planner {
+class MergeJoinPlanNode;
+}  // namespace terrier::planner
+
+namespace terrier::execution::compiler {
+
+class FunctionBuilder;
+
+/**
+ * A translator for sort-merge joins over two inputs that are already sorted ascending on their join keys.
+ *
+ * The left input is materialized, in arrival order, into a sorter that is never sorted. The right input is streamed
+ * through the join: for every right tuple, we scan the materialized rows starting at a cursor that marks the first
+ * left row whose key is not smaller than the previous right tuple's key. Rows with a smaller key are skipped for good
+ * by advancing the cursor, rows with an equal key produce output, and the scan stops at the first larger key. Since
+ * both inputs must stay in order, both pipelines are serial.
+ */
+class MergeJoinTranslator : public OperatorTranslator {
+ public:
+  /**
+   * Create a new translator for the given merge join plan. The compilation occurs within the
+   * provided compilation context and the operator is participating in the provided pipeline.
+   * @param plan The plan.
+   * @param compilation_context The context of compilation this translation is occurring in.
+   * @param pipeline The pipeline this operator is participating in.
+   */
+  MergeJoinTranslator(const planner::MergeJoinPlanNode &plan, CompilationContext *compilation_context,
+                      Pipeline *pipeline);
+
+  /**
+   * Declare the row struct used to materialize tuples from the left side of the join.
+   * @param decls The top-level declarations for the query.
+   */
+  void DefineHelperStructs(util::RegionVector<ast::StructDecl *> *decls) override;
+
+  /**
+   * Declare the comparison function the materialization sorter is initialized with.
+   * @param decls The top-level declarations for the query.
+   */
+  void DefineHelperFunctions(util::RegionVector<ast::FunctionDecl *> *decls) override;
+
+  /**
+   * Initialize the materialization sorter and the merge cursor.
+   */
+  void InitializeQueryState(FunctionBuilder *function) const override;
+
+  /**
+   * Tear-down the materialization sorter.
+   */
+  void TearDownQueryState(FunctionBuilder *function) const override;
+
+  /**
+   * Implement main join logic. If the context is coming from the left pipeline, the input tuples
+   * are materialized. If the context is coming from the right pipeline, the input tuples are
+   * merged with the materialized left tuples.
+   * @param ctx The context of the work.
+   * @param function The pipeline generating function.
+   */
+  void PerformPipelineWork(WorkContext *ctx, FunctionBuilder *function) const override;
+
+  /**
+   * @return The value (vector) of the attribute at the given index (@em attr_idx) produced by the
+   *         child at the given index (@em child_idx).
+   */
+  ast::Expr *GetChildOutput(WorkContext *context, uint32_t child_idx, uint32_t attr_idx) const override;
+
+  /**
+   * Merge-joins do not produce columns from base tables.
+   */
+  ast::Expr *GetTableColumn(catalog::col_oid_t col_oid) const override {
+    UNREACHABLE("Merge-joins do not produce columns from base tables.");
+  }
+
+ private:
+  // The row that left-child attributes are read from in the left pipeline.
+  enum class CurrentRow { Child, Lhs, Rhs };
+
+  // Is the given pipeline this join's left pipeline?
+  bool IsLeftPipeline(const Pipeline &pipeline) const { return &left_pipeline_ == &pipeline; }
+
+  // Is the given pipeline this join's right pipeline?
+  bool IsRightPipeline(const Pipeline &pipeline) const { return GetPipeline() == &pipeline; }
+
+  // Access an attribute at the given index in the provided materialized row.
+  ast::Expr *GetLeftRowAttribute(ast::Identifier row, uint32_t attr_idx) const;
+
+  // Generate the body of the comparison function over the left join keys.
+  void GenerateComparisonFunction(FunctionBuilder *function);
+
+  // Build an expression that is true if none of the given keys are NULL.
+  ast::Expr *KeysNotNull(WorkContext *ctx,
+                         const std::vector<common::ManagedPointer<parser::AbstractExpression>> &keys) const;
+
+  // Compare the left keys of the current materialized row against the right keys of the input
+  // tuple, starting at the given key, and store -1, 0, or 1 into the given variable.
+  void CompareKeys(WorkContext *ctx, FunctionBuilder *function, ast::Identifier cmp, std::size_t key_idx) const;
+
+  // Materialize the tuple in the provided context.
+  void MaterializeLeftRow(WorkContext *ctx, FunctionBuilder *function) const;
+
+  // Merge the input tuple with the materialized left rows.
+  void MergeRightRow(WorkContext *ctx, FunctionBuilder *function) const;
+
+ private:
+  // The name and type of the materialized left row.
+  ast::Identifier left_row_var_;
+  ast::Identifier left_row_type_;
+  // The comparison function and its arguments.
+  ast::Identifier lhs_row_;
+  ast::Identifier rhs_row_;
+  ast::Identifier compare_func_;
+
+  // The left materialization pipeline.
+  Pipeline left_pipeline_;
+
+  // The sorter holding the materialized left rows, and the index of the first row that may still
+  // match a right tuple.
+  StateDescriptor::Entry left_rows_;
+  StateDescriptor::Entry cursor_;
+
+  // Where left-child attributes are read from when generating the comparison function.
+  CurrentRow current_row_;
+};
+
+}  // namespace terrier::execution::compiler
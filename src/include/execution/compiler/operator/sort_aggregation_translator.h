@@ -0,0 +1,165 @@
+#pragma once
+
+#include "execution/compiler/operator/operator_translator.h"
+#include "execution/compiler/pipeline.h"
+#include "execution/compiler/pipeline_driver.h"
+
+namespace terrier::brain {
+class OperatingUnitRecorder;
+}  // namespace terrier::brain
+
+namespace terrier::planner {
+class AggregatePlanNode;
+}  // namespace terrier::planner
+
+namespace terrier::execution::compiler {
+
+class FunctionBuilder;
+
+/**
+ * A translator for sort-based aggregations. The input must arrive sorted on the grouping terms, so
+ * all rows of a group are adjacent. The build pipeline keeps a single open group and advances its
+ * aggregates until a row with different grouping keys arrives, at which point a new group is opened.
+ * Finished groups are appended in order to a sorter that is never sorted, and the produce pipeline
+ * scans them in that order once the input is exhausted. Like the hash aggregation, this is a
+ * pipeline breaker that buffers every group, but no key is hashed or probed, and the output
+ * preserves the input order.
+ */
+class SortAggregationTranslator : public OperatorTranslator, public PipelineDriver {
+ public:
+  /**
+   * Create a new translator for the given aggregation plan.
+   * @param plan The plan.
+   * @param compilation_context The context of compilation this translation is occurring in.
+   * @param pipeline The pipeline this operator is participating in.
+   */
+  SortAggregationTranslator(const planner::AggregatePlanNode &plan, CompilationContext *compilation_context,
+                            Pipeline *pipeline);
+
+  /**
+   * Define the aggregation row structure.
+   * @param decls Where the defined structure will be registered.
+   */
+  void DefineHelperStructs(util::RegionVector<ast::StructDecl *> *decls) override;
+
+  /**
+   * Define the key-check and group comparison functions.
+   * @param decls Where the defined functions will be registered.
+   */
+  void DefineHelperFunctions(util::RegionVector<ast::FunctionDecl *> *decls) override;
+
+  /**
+   * Initialize the group buffer and the current group.
+   */
+  void InitializeQueryState(FunctionBuilder *function) const override;
+
+  /**
+   * Destroy the group buffer.
+   */
+  void TearDownQueryState(FunctionBuilder *function) const override;
+
+  /**
+   * If the context pipeline is for the build-side, we'll fold the input into the current group,
+   * opening a new one when the grouping keys change. Otherwise, we'll scan all groups.
+   * @param context The context.
+   * @param function The pipeline generating function.
+   */
+  void PerformPipelineWork(WorkContext *context, FunctionBuilder *function) const override;
+
+  /**
+   * Record the build and iteration statistics of the aggregation.
+   * @param pipeline Current pipeline.
+   * @param function The pipeline generating function.
+   */
+  void FinishPipelineWork(const Pipeline &pipeline, FunctionBuilder *function) const override;
+
+  /**
+   * Sort-based aggregations are never launched in parallel, so this should never occur.
+   */
+  util::RegionVector<ast::FieldDecl *> GetWorkerParams() const override { UNREACHABLE("Impossible"); }
+
+  /**
+   * Sort-based aggregations are never launched in parallel, so this should never occur.
+   */
+  void LaunchWork(FunctionBuilder *function, ast::Identifier work_func_name) const override {
+    UNREACHABLE("Impossible");
+  }
+
+  /**
+   * @return The value (vector) of the attribute at the given index (@em attr_idx) produced by the
+   *         child at the given index (@em child_idx).
+   */
+  ast::Expr *GetChildOutput(WorkContext *context, uint32_t child_idx, uint32_t attr_idx) const override;
+
+  /**
+   * Sort-based aggregations do not produce columns from base tables.
+   */
+  ast::Expr *GetTableColumn(catalog::col_oid_t col_oid) const override {
+    UNREACHABLE("Sort-based aggregations do not produce columns from base tables.");
+  }
+
+ private:
+  friend class brain::OperatingUnitRecorder;
+
+  // Access the plan.
+  const planner::AggregatePlanNode &GetAggPlan() const { return GetPlanAs<planner::AggregatePlanNode>(); }
+
+  // Check if the input pipeline is either the build-side or producer-side.
+  bool IsBuildPipeline(const Pipeline &pipeline) const { return &build_pipeline_ == &pipeline; }
+  bool IsProducePipeline(const Pipeline &pipeline) const { return GetPipeline() == &pipeline; }
+
+  // Declare the payload and input structures. Called from DefineHelperStructs().
+  ast::StructDecl *GeneratePayloadStruct();
+  ast::StructDecl *GenerateInputValuesStruct();
+
+  // Generate the helper functions. Called from DefineHelperFunctions().
+  ast::FunctionDecl *GenerateKeyCheckFunction();
+  ast::FunctionDecl *GenerateCompareFunction();
+
+  // Access an attribute at the given index in the provided aggregate row.
+  ast::Expr *GetGroupByTerm(ast::Identifier agg_row, uint32_t attr_idx) const;
+  ast::Expr *GetAggregateTerm(ast::Identifier agg_row, uint32_t attr_idx) const;
+  ast::Expr *GetAggregateTermPtr(ast::Identifier agg_row, uint32_t attr_idx) const;
+
+  // Fill the input values of the aggregation from the given context.
+  ast::Identifier FillInputValues(FunctionBuilder *function, WorkContext *ctx) const;
+
+  // Fold the input row into the current group.
+  void UpdateAggregates(WorkContext *context, FunctionBuilder *function) const;
+
+  // Scan all finished groups.
+  void ScanGroups(WorkContext *context, FunctionBuilder *function) const;
+
+  // For minirunners.
+  ast::StructDecl *GetStructDecl() const { return struct_decl_; }
+
+ private:
+  // The name of the variable used to:
+  // 1. Refer to the current group when folding in an input row.
+  // 2. Read from an iterator when iterating over all groups.
+  ast::Identifier agg_row_var_;
+  // The names of the payload and input values struct.
+  ast::Identifier agg_payload_type_;
+  ast::Identifier agg_values_type_;
+  // The names of the key-check and group comparison functions.
+  ast::Identifier key_check_fn_;
+  ast::Identifier compare_fn_;
+
+  // The build pipeline.
+  Pipeline build_pipeline_;
+
+  // The buffer of groups in input order, and the group currently being aggregated.
+  StateDescriptor::Entry groups_;
+  StateDescriptor::Entry current_group_;
+
+  // For minirunners
+  ast::StructDecl *struct_decl_;
+
+  // The number of input rows to the aggregation.
+  StateDescriptor::Entry num_agg_inputs_;
+
+  // The number of output rows from the aggregation.
+  StateDescriptor::Entry num_agg_outputs_;
+};
+
+}  // namespace terrier::execution::compiler
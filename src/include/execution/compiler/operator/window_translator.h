@@ -0,0 +1,165 @@
+#pragma once
+
+#include <vector>
+
+#include "execution/compiler/operator/operator_translator.h"
+#include "execution/compiler/pipeline.h"
+#include "execution/compiler/pipeline_driver.h"
+#include "execution/sql/window_evaluator.h"
+
+namespace terrier::planner {
+class WindowPlanNode;
+struct WindowTerm;
+}  // namespace terrier::planner
+
+namespace terrier::execution::compiler {
+
+class FunctionBuilder;
+
+/**
+ * A translator for window plans. The build pipeline materializes every input row, together with the arguments of
+ * all window functions, into a sorter. Once the build completes, the rows are sorted on the partitioning keys followed
+ * by the window's ordering keys, and a runtime WindowEvaluator computes the window functions in place, evaluating
+ * independent partitions in parallel. The produce pipeline then scans the sorted rows and their results in order.
+ */
+class WindowTranslator : public OperatorTranslator, public PipelineDriver {
+ public:
+  /**
+   * Create a translator for the given window plan node.
+   * @param plan The plan.
+   * @param compilation_context The context this translator belongs to.
+   * @param pipeline The pipeline this translator is participating in.
+   */
+  WindowTranslator(const planner::WindowPlanNode &plan, CompilationContext *compilation_context, Pipeline *pipeline);
+
+  /**
+   * Define the row structure that's materialized in the sorter.
+   * @param decls The top-level declarations.
+   */
+  void DefineHelperStructs(util::RegionVector<ast::StructDecl *> *decls) override;
+
+  /**
+   * Define the comparison function used to sort, and the key equality functions used to find partitions and peers.
+   * @param decls The top-level declarations.
+   */
+  void DefineHelperFunctions(util::RegionVector<ast::FunctionDecl *> *decls) override;
+
+  /**
+   * Initialize the sorter and the window evaluator, and register all window functions with the evaluator.
+   */
+  void InitializeQueryState(FunctionBuilder *function) const override;
+
+  /**
+   * Tear-down the sorter and the window evaluator.
+   */
+  void TearDownQueryState(FunctionBuilder *function) const override;
+
+  /**
+   * If the given pipeline is for the build-side and is parallel, initialize the thread-local sorter.
+   * @param pipeline The current pipeline.
+   * @param function The pipeline generating function.
+   */
+  void InitializePipelineState(const Pipeline &pipeline, FunctionBuilder *function) const override;
+
+  /**
+   * If the given pipeline is for the build-side and is parallel, destroy the thread-local sorter.
+   * @param pipeline The current pipeline.
+   * @param function The pipeline generating function.
+   */
+  void TearDownPipelineState(const Pipeline &pipeline, FunctionBuilder *function) const override;
+
+  /**
+   * Implement either the build-side or scan-side of the window depending on the pipeline in the context.
+   * @param ctx The context of the work.
+   * @param function The pipeline function generator.
+   */
+  void PerformPipelineWork(WorkContext *ctx, FunctionBuilder *function) const override;
+
+  /**
+   * If the given pipeline is for the build-side, sort the materialized rows and evaluate the window functions.
+   * @param pipeline The current pipeline.
+   * @param function The pipeline generating function.
+   */
+  void FinishPipelineWork(const Pipeline &pipeline, FunctionBuilder *function) const override;
+
+  /**
+   * Windows are never launched in parallel, so this should never occur.
+   */
+  util::RegionVector<ast::FieldDecl *> GetWorkerParams() const override { UNREACHABLE("Impossible"); }
+
+  /**
+   * Windows are never launched in parallel, so this should never occur.
+   */
+  void LaunchWork(FunctionBuilder *function, ast::Identifier work_func_name) const override {
+    UNREACHABLE("Impossible");
+  }
+
+  /**
+   * @return The value of the attribute at the given index (@em attr_idx) of the child at the given index
+   *         (@em child_idx). In the produce pipeline, child 0 refers to the input columns and child 1 refers to the
+   *         results of the window functions.
+   */
+  ast::Expr *GetChildOutput(WorkContext *context, uint32_t child_idx, uint32_t attr_idx) const override;
+
+  /**
+   * Window operators do not produce columns from base tables.
+   */
+  ast::Expr *GetTableColumn(catalog::col_oid_t col_oid) const override {
+    UNREACHABLE("Window operators do not produce columns from base tables");
+  }
+
+ private:
+  // Check if the given pipelines are build or scan.
+  bool IsBuildPipeline(const Pipeline &pipeline) const { return &build_pipeline_ == &pipeline; }
+  bool IsScanPipeline(const Pipeline &pipeline) const { return GetPipeline() == &pipeline; }
+
+  // The SQL type of the result of the given window term.
+  static sql::TypeId GetResultType(const planner::WindowTerm &term);
+
+  // Throw if the given window term can't be evaluated.
+  static void CheckWindowTerm(const planner::WindowTerm &term);
+
+  // Access the input attribute, function argument or function result at the given index within the provided row.
+  ast::Expr *GetRowAttribute(ast::Identifier row, uint32_t attr_idx) const;
+  ast::Expr *GetRowArgument(ast::Identifier row, uint32_t term_idx) const;
+  ast::Expr *GetRowResult(ast::Identifier row, uint32_t term_idx) const;
+
+  // Generate the comparison function that sorts rows on the partitioning keys, then on the ordering keys.
+  ast::FunctionDecl *GenerateComparisonFunction();
+
+  // Generate a function checking if two rows are equal on the given keys.
+  ast::FunctionDecl *GenerateKeyEqualityFunction(
+      ast::Identifier name, const std::vector<common::ManagedPointer<parser::AbstractExpression>> &keys);
+
+  // Initialize and destroy the given sorter.
+  void InitializeSorter(FunctionBuilder *function, ast::Expr *sorter_ptr) const;
+  void TearDownSorter(FunctionBuilder *function, ast::Expr *sorter_ptr) const;
+
+  // Called to insert the tuple in the context into the sorter instance.
+  void InsertIntoSorter(WorkContext *ctx, FunctionBuilder *function) const;
+
+  // Called to scan the global sorter instance.
+  void ScanSorter(WorkContext *ctx, FunctionBuilder *function) const;
+
+ private:
+  // The name of the materialized row when inserting into sorter or pulling from an iterator.
+  ast::Identifier row_var_;
+  ast::Identifier row_type_;
+  ast::Identifier lhs_row_, rhs_row_;
+  ast::Identifier compare_func_;
+  ast::Identifier same_partition_func_;
+  ast::Identifier same_peer_func_;
+
+  // Build-side pipeline.
+  Pipeline build_pipeline_;
+
+  // Where the global and thread-local sorter instances are, and where the evaluator is.
+  StateDescriptor::Entry global_sorter_;
+  StateDescriptor::Entry local_sorter_;
+  StateDescriptor::Entry evaluator_;
+
+  enum class CurrentRow { Child, Lhs, Rhs };
+  CurrentRow current_row_;
+};
+
+}  // namespace terrier::execution::compiler
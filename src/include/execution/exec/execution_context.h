@@ -7,6 +7,7 @@
 #include "brain/brain_defs.h"
 #include "brain/operating_unit.h"
 #include "common/managed_pointer.h"
+#include "execution/exec/execution_settings.h"
 #include "execution/exec/output.h"
 #include "execution/exec_defs.h"
 #include "execution/sql/memory_tracker.h"
@@ -52,7 +53,8 @@ class EXPORT ExecutionContext {
         mem_pool_(std::make_unique<sql::MemoryPool>(common::ManagedPointer<sql::MemoryTracker>(mem_tracker_))),
         buffer_(schema == nullptr ? nullptr
                                   : std::make_unique<OutputBuffer>(mem_pool_.get(), schema->GetColumns().size(),
-                                                                   ComputeTupleSize(schema), callback)),
+                                                                   ComputeTupleSize(schema),
+                                                                   exec_settings.GetOutputBatchSize(), callback)),
         thread_state_container_(std::make_unique<sql::ThreadStateContainer>(mem_pool_.get())),
         accessor_(accessor) {}
 
@@ -167,6 +169,16 @@ class EXPORT ExecutionContext {
     params_ = params;
   }
 
+  /**
+   * Set the trace of the request that runs the query, whose pipelines are recorded as spans of it
+   * @param connection_id the connection of the request
+   * @param query_trace_id the id of the trace of the request, 0 if it's not traced
+   */
+  void SetQueryTrace(const uint32_t connection_id, const uint64_t query_trace_id) {
+    trace_connection_id_ = connection_id;
+    query_trace_id_ = query_trace_id;
+  }
+
   /**
    * @param param_idx index of parameter to access
    * @return immutable parameter at provided index
@@ -223,5 +235,9 @@ class EXPORT ExecutionContext {
 
   bool memory_use_override_ = false;
   uint32_t memory_use_override_value_ = 0;
+
+  uint32_t trace_connection_id_ = 0;
+  uint64_t query_trace_id_ = 0;
+  uint64_t pipeline_start_us_ = 0;
 };
 }  // namespace terrier::execution::exec
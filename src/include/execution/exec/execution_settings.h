@@ -39,6 +39,21 @@ class EXPORT ExecutionSettings {
   /** @return True if static partitioner is enabled. */
   constexpr bool GetIsStaticPartitionerEnabled() const { return is_static_partitioner_enabled_; }
 
+  /** @return The priority of this query's parallel work relative to other queries sharing the worker pool. */
+  constexpr uint32_t GetQueryPriority() const { return query_priority_; }
+
+  /** @return The number of interpreted executions after which a tiered query is compiled to machine code. */
+  constexpr uint64_t GetJitExecutionThreshold() const { return jit_execution_threshold_; }
+
+  /** @return The total interpreted time, in microseconds, after which a tiered query is compiled to machine code. */
+  constexpr uint64_t GetJitTimeThresholdUs() const { return jit_time_threshold_us_; }
+
+  /** @return The number of output rows that are buffered before they are handed to the output callback together. */
+  constexpr uint32_t GetOutputBatchSize() const { return output_batch_size_; }
+
+  /** @param output_batch_size The number of output rows that are buffered before they are handed to the callback. */
+  void SetOutputBatchSize(const uint32_t output_batch_size) { output_batch_size_ = output_batch_size; }
+
  private:
   double select_opt_threshold_{common::Constants::SELECT_OPT_THRESHOLD};
   double arithmetic_full_compute_opt_threshold_{common::Constants::ARITHMETIC_FULL_COMPUTE_THRESHOLD};
@@ -47,6 +62,10 @@ class EXPORT ExecutionSettings {
   bool is_parallel_execution_enabled_{common::Constants::IS_PARALLEL_EXECUTION_ENABLED};
   int number_of_threads_{common::Constants::NUM_THREADS};
   bool is_static_partitioner_enabled_{common::Constants::IS_STATIC_PARTITIONER_ENABLED};
+  uint32_t query_priority_{common::Constants::QUERY_PRIORITY};
+  uint64_t jit_execution_threshold_{common::Constants::JIT_EXECUTION_THRESHOLD};
+  uint64_t jit_time_threshold_us_{common::Constants::JIT_TIME_THRESHOLD_US};
+  uint32_t output_batch_size_{common::Constants::OUTPUT_BATCH_SIZE};
 
   // MiniRunners needs to set query_identifier and pipeline_operating_units_.
   friend class terrier::runner::MiniRunners;
@@ -14,6 +14,7 @@
 #include "parser/parser_defs.h"
 
 namespace terrier::network {
+class NetworkIoWrapper;
 class PostgresPacketWriter;
 }  // namespace terrier::network
 
@@ -32,31 +33,29 @@ using OutputCallback = std::function<void(byte *, uint32_t, uint32_t)>;
  */
 class EXPORT OutputBuffer {
  public:
-  /**
-   * Batch size
-   */
-  static constexpr uint32_t BATCH_SIZE = 32;
-
   /**
    * Constructor
    * @param memory_pool memory pool to use for buffer allocation
    * @param num_cols number of columns in output tuples
    * @param tuple_size size of output tuples
+   * @param batch_size number of tuples handed to the callback at once
    * @param callback upper layer callback
    */
-  explicit OutputBuffer(sql::MemoryPool *memory_pool, uint16_t num_cols, uint32_t tuple_size, OutputCallback callback)
+  OutputBuffer(sql::MemoryPool *memory_pool, uint16_t num_cols, uint32_t tuple_size, uint32_t batch_size,
+               OutputCallback callback)
       : memory_pool_(memory_pool),
         num_tuples_(0),
         tuple_size_(tuple_size),
+        batch_size_(batch_size),
         tuples_(
-            reinterpret_cast<byte *>(memory_pool->AllocateAligned(BATCH_SIZE * tuple_size, alignof(uint64_t), true))),
+            reinterpret_cast<byte *>(memory_pool->AllocateAligned(batch_size * tuple_size, alignof(uint64_t), true))),
         callback_(std::move(callback)) {}
 
   /**
    * @return an output slot to be written to.
    */
   byte *AllocOutputSlot() {
-    if (num_tuples_ == BATCH_SIZE) {
+    if (num_tuples_ == batch_size_) {
       callback_(tuples_, num_tuples_, tuple_size_);
       num_tuples_ = 0;
     }
@@ -84,6 +83,7 @@ class EXPORT OutputBuffer {
   sql::MemoryPool *memory_pool_;
   uint32_t num_tuples_;
   uint32_t tuple_size_;
+  uint32_t batch_size_;
   byte *tuples_;
   OutputCallback callback_;
 };
@@ -114,7 +114,9 @@ class OutputPrinter {
 };
 
 /**
- * Output handler for execution engine that writes results to PostgresPacketWriter
+ * Output handler for execution engine that writes results to PostgresPacketWriter. If it knows the transport of the
+ * client, a large result is flushed while it's written, so that a slow client holds the query back instead of letting
+ * the result pile up in memory.
  */
 class OutputWriter {
  public:
@@ -122,11 +124,13 @@ class OutputWriter {
    * @param schema final schema to output for this query
    * @param out packet writer to use
    * @param field_formats reference to the field formats for this query
+   * @param transport transport of the client that the packet writer writes to, nullptr if unknown
    */
   OutputWriter(const common::ManagedPointer<planner::OutputSchema> schema,
                const common::ManagedPointer<network::PostgresPacketWriter> out,
-               const std::vector<network::FieldFormat> &field_formats)
-      : schema_(schema), out_(out), field_formats_(field_formats) {}
+               const std::vector<network::FieldFormat> &field_formats,
+               const common::ManagedPointer<network::NetworkIoWrapper> transport = nullptr)
+      : schema_(schema), out_(out), field_formats_(field_formats), transport_(transport) {}
 
   /**
    * Callback that prints a batch of tuples to std out.
@@ -146,6 +150,7 @@ class OutputWriter {
   const common::ManagedPointer<planner::OutputSchema> schema_;
   const common::ManagedPointer<network::PostgresPacketWriter> out_;
   const std::vector<network::FieldFormat> &field_formats_;
+  const common::ManagedPointer<network::NetworkIoWrapper> transport_;
 };
 
 /**
@@ -68,6 +68,8 @@ namespace sema {
   F(InvalidDeclaration, "non-declaration outside function", ())                                                       \
   F(BadComparisonFunctionForSorter,                                                                                   \
     "sorterInit requires a comparison function of type (*,*)->int32. Received type '%0'", (ast::Type *))              \
+  F(BadKeyEqualityFunctionForWindow,                                                                                  \
+    "windowInit requires key equality functions of type (*,*)->bool. Received type '%0'", (ast::Type *))              \
   F(BadArgToPtrCast, "ptrCast() expects (compile-time *Type, Expr) arguments. Received type '%0' in position %1",     \
     (ast::Type *, uint32_t))                                                                                          \
   F(BadHashArg, "cannot hash type '%0'", (ast::Type *))                                                               \
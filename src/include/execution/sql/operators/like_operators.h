@@ -1,13 +1,124 @@
 #pragma once
 
+#include <cstdint>
 #include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
 
 #include "execution/sql/runtime_types.h"
+#include "execution/util/execution_common.h"
 
 namespace terrier::execution::sql {
 
 static constexpr const char DEFAULT_ESCAPE = '\\';
 
+/**
+ * A LIKE pattern that has been analyzed once so that it can be matched against many strings quickly. On construction,
+ * the pattern is split on its '%' wildcards into fixed-length segments of literal characters and '_' wildcards, and
+ * classified by the position of these segments:
+ *  - Exact: 'abc', the string must match a single segment exactly.
+ *  - Prefix: 'abc%', the string must begin with a single segment.
+ *  - Suffix: '%abc', the string must end with a single segment.
+ *  - Contains: '%abc%', the string must contain a single segment. '%' is a Contains pattern with no segments.
+ *  - MultiContains: 'a%b%c' and the like, where segments are located from left to right.
+ *  - General: patterns whose escape character is itself a wildcard, or that end in a dangling escape. These fall back
+ *    to Like::Impl().
+ *
+ * Segments without '_' are located with a vectorized substring search. Since segments have a fixed length, placing
+ * each segment at its leftmost match never prevents the following segments from matching, so matching never
+ * backtracks. When matching VarlenEntry values, strings that are too short are rejected without touching their
+ * contents, as are strings whose inlined prefix doesn't match the pattern's leading characters.
+ */
+class EXPORT LikePattern {
+ public:
+  /**
+   * The class of a pattern.
+   */
+  enum class Kind : uint8_t { Exact, Prefix, Suffix, Contains, MultiContains, General };
+
+  /**
+   * Analyze the given pattern.
+   * @param pattern The pattern.
+   * @param pattern_len The length of the pattern, in bytes.
+   * @param escape The escape character.
+   */
+  LikePattern(const char *pattern, std::size_t pattern_len, char escape = DEFAULT_ESCAPE);
+
+  /**
+   * Analyze the given pattern.
+   * @param pattern The pattern.
+   * @param escape The escape character.
+   */
+  explicit LikePattern(const storage::VarlenEntry &pattern, char escape = DEFAULT_ESCAPE)
+      : LikePattern(reinterpret_cast<const char *>(pattern.Content()), pattern.Size(), escape) {}
+
+  /**
+   * @return The class of this pattern.
+   */
+  Kind GetKind() const noexcept { return kind_; }
+
+  /**
+   * @return The minimum length of a string matching this pattern.
+   */
+  std::size_t GetMinLength() const noexcept { return min_len_; }
+
+  /**
+   * @return True if the given string is LIKE this pattern.
+   */
+  bool Matches(const char *str, std::size_t str_len) const;
+
+  /**
+   * @return True if the given string is LIKE this pattern.
+   */
+  bool Matches(const storage::VarlenEntry &str) const {
+    if (str.Size() < min_len_) {
+      return false;
+    }
+    // The prefix is stored inline, regardless of the size of the string.
+    uint32_t prefix;
+    std::memcpy(&prefix, str.Prefix(), sizeof(prefix));
+    if ((prefix & prefix_mask_) != prefix_bytes_) {
+      return false;
+    }
+    return Matches(reinterpret_cast<const char *>(str.Content()), str.Size());
+  }
+
+ private:
+  // A run of literal characters and '_' wildcards between two '%' wildcards.
+  struct Segment {
+    // The characters of the segment. Positions of '_' wildcards hold an arbitrary byte.
+    std::string chars_;
+    // For each character, true if it is a '_' wildcard.
+    std::vector<bool> any_;
+    // True if the segment contains at least one '_' wildcard.
+    bool has_any_{false};
+  };
+
+  // Check if the segment matches the string at the given position.
+  static bool MatchAt(const Segment &segment, const char *str);
+
+  // Find the leftmost position of the segment in the given string, or nullptr if it does not occur.
+  static const char *Find(const Segment &segment, const char *str, std::size_t str_len);
+
+ private:
+  // The class of the pattern.
+  Kind kind_;
+  // The original pattern and escape character, used if the pattern is General.
+  std::string pattern_;
+  char escape_;
+  // The segments in the pattern, in order.
+  std::vector<Segment> segments_;
+  // Whether the first segment is anchored at the start of the string, and the last at the end.
+  bool anchored_start_;
+  bool anchored_end_;
+  // The total length of all segments.
+  std::size_t min_len_;
+  // The leading literal characters of an anchored pattern, and a mask selecting them from a string's prefix.
+  uint32_t prefix_bytes_;
+  uint32_t prefix_mask_;
+};
+
 /**
  * Functor implementing the SQL LIKE() operator
  */
@@ -22,6 +133,9 @@ struct Like {
     return Impl(reinterpret_cast<const char *>(str.Content()), str.Size(),
                 reinterpret_cast<const char *>(pattern.Content()), pattern.Size(), escape);
   }
+
+  /** @return True if str is LIKE the analyzed pattern. */
+  bool operator()(const storage::VarlenEntry &str, const LikePattern &pattern) const { return pattern.Matches(str); }
 };
 
 /**
@@ -33,6 +147,9 @@ struct NotLike {
                   char escape = DEFAULT_ESCAPE) const {
     return !Like{}(str, pattern, escape);  // NOLINT
   }
+
+  /** @return True if str is NOT LIKE the analyzed pattern. */
+  bool operator()(const storage::VarlenEntry &str, const LikePattern &pattern) const { return !pattern.Matches(str); }
 };
 
 }  // namespace terrier::execution::sql
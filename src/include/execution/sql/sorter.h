@@ -176,6 +176,7 @@ class EXPORT Sorter {
  private:
   friend class SorterIterator;
   friend class SorterVectorIterator;
+  friend class WindowEvaluator;
 
   // Memory pool
   MemoryPool *memory_;
@@ -100,7 +100,8 @@ class EXPORT TableVectorIterator {
    * Perform a parallel scan over the table with ID @em table_id using the callback function
    * @em scanner on each input vector projection from the source table. This call is blocking,
    * meaning that it only returns after the whole table has been scanned. Iteration order is
-   * non-deterministic.
+   * non-deterministic. The scan is split into morsels of @em min_grain_size blocks that are dispatched through the
+   * process-wide util::MorselScheduler.
    * @param table_oid The ID of the table to scan.
    * @param col_oids The column OIDs of the table to scan.
    * @param num_oids The number of column OIDs provided in col_oids.
@@ -110,7 +111,7 @@ class EXPORT TableVectorIterator {
    *                 container has been configured for size, construction, and destruction
    *                 before this invocation.
    * @param scan_fn The callback function invoked for vectors of table input.
-   * @param min_grain_size The minimum number of blocks to give a scan task.
+   * @param min_grain_size The number of blocks in a morsel.
    */
   static bool ParallelScan(uint32_t table_oid, uint32_t *col_oids, uint32_t num_oids, void *query_state,
                            exec::ExecutionContext *exec_ctx, ScanFn scan_fn,
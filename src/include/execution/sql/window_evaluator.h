@@ -0,0 +1,156 @@
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "common/macros.h"
+#include "execution/sql/sql.h"
+#include "execution/util/execution_common.h"
+
+namespace terrier::execution::sql {
+
+class Sorter;
+
+/**
+ * Window functions supported by the evaluator.
+ */
+enum class WindowFunction : uint8_t { RowNumber, Rank, DenseRank, Lag, Lead, CountStar, Count, Sum, Min, Max, Avg };
+
+/**
+ * The unit of a window frame's bounds. ROWS bounds count physical rows, RANGE bounds are peer groups.
+ */
+enum class WindowFrameType : uint8_t { Rows, Range };
+
+/**
+ * The kind of a window frame bound.
+ */
+enum class WindowFrameBound : uint8_t { UnboundedPreceding, Preceding, CurrentRow, Following, UnboundedFollowing };
+
+/**
+ * A WindowEvaluator computes window functions over the contents of a sorter whose rows are ordered on the window's
+ * partitioning keys, followed by its ordering keys. Each row of the sorter stores the arguments of all window
+ * functions and reserves a slot for each function's result; the evaluator reads the former and writes the latter at
+ * the byte offsets it is configured with. Once Evaluate() returns, the results can be read by iterating the sorter.
+ *
+ * Partition boundaries are found in parallel, after which partitions are evaluated independently and in parallel on
+ * the process-wide morsel scheduler. Within a partition, all frames are monotonic, i.e., neither the start nor the end
+ * of the frame moves backwards from one row to the next. Hence, aggregates that can be undone (COUNT, and SUM and AVG
+ * over integers), as well as any aggregate whose frame starts at the beginning of the partition, are maintained over
+ * a sliding frame with O(1) amortized work per row. Other aggregates (MIN, MAX, and floating-point SUM and AVG, whose
+ * running sum would accumulate rounding errors if values were subtracted) are answered from a segment tree over the
+ * partition in O(log n) per row.
+ *
+ * RANGE frames only support UNBOUNDED and CURRENT ROW bounds.
+ */
+class EXPORT WindowEvaluator {
+ public:
+  /**
+   * Function to check if two rows are equal on a set of keys.
+   */
+  using KeyEqualFn = bool (*)(const void *lhs, const void *rhs);
+
+  /**
+   * The number of partitions evaluated in one morsel.
+   */
+  static constexpr uint32_t PARTITIONS_PER_MORSEL = 32;
+
+  /**
+   * The number of rows scanned for partition boundaries in one morsel.
+   */
+  static constexpr uint32_t ROWS_PER_MORSEL = 16384;
+
+  /**
+   * Create an evaluator without any functions.
+   * @param same_partition_fn Function that returns true if two rows belong to the same partition.
+   * @param same_peer_fn Function that returns true if two rows of a partition are equal on all ordering keys.
+   */
+  WindowEvaluator(KeyEqualFn same_partition_fn, KeyEqualFn same_peer_fn);
+
+  /**
+   * This class cannot be copied or moved.
+   */
+  DISALLOW_COPY_AND_MOVE(WindowEvaluator);
+
+  /**
+   * Add a window function to compute. The function is evaluated over the default frame, i.e., from the start of the
+   * partition to the last peer of the current row, unless SetFrame() is called.
+   * @param function The window function.
+   * @param type The type of the function's argument. Ignored for functions without arguments.
+   * @param arg_offset The offset of the argument in each row. Ignored for functions without arguments.
+   * @param result_offset The offset of the result slot in each row.
+   * @param offset The offset of LAG and LEAD, in rows. Ignored for other functions.
+   */
+  void AddFunction(WindowFunction function, TypeId type, uint32_t arg_offset, uint32_t result_offset, int64_t offset);
+
+  /**
+   * Set the frame of the most recently added window function.
+   * @param type The unit of the frame bounds.
+   * @param start The start of the frame.
+   * @param start_offset The offset of the start if it is Preceding or Following.
+   * @param end The end of the frame.
+   * @param end_offset The offset of the end if it is Preceding or Following.
+   */
+  void SetFrame(WindowFrameType type, WindowFrameBound start, int64_t start_offset, WindowFrameBound end,
+                int64_t end_offset);
+
+  /**
+   * Compute all window functions for every row in the given sorter.
+   * @param sorter The sorter. Its rows must be ordered on the partitioning keys, then on the ordering keys.
+   */
+  void Evaluate(Sorter *sorter);
+
+  /**
+   * @return The number of partitions found by the last call to Evaluate().
+   */
+  uint64_t GetPartitionCount() const noexcept { return num_partitions_; }
+
+ private:
+  // A window function with its frame.
+  struct Function {
+    WindowFunction function_;
+    TypeId type_;
+    uint32_t arg_offset_;
+    uint32_t result_offset_;
+    uint64_t offset_;
+    WindowFrameType frame_type_;
+    WindowFrameBound frame_start_;
+    uint64_t frame_start_offset_;
+    WindowFrameBound frame_end_;
+    uint64_t frame_end_offset_;
+  };
+
+  // Per-thread scratch space for evaluating partitions.
+  struct PartitionState {
+    // For each row, the index of the first peer, and the index one past the last peer.
+    std::vector<uint64_t> peer_begin_;
+    std::vector<uint64_t> peer_end_;
+  };
+
+  // Compute the frame [begin, end) of the given row in a partition with the given number of rows.
+  static std::pair<uint64_t, uint64_t> ComputeFrame(const Function &func, uint64_t row, uint64_t num_rows,
+                                                    const PartitionState &state);
+
+  // Find the start of every partition in the given rows. The last element is the number of rows.
+  std::vector<uint64_t> FindPartitions(const byte *const *rows, uint64_t num_rows) const;
+
+  // Evaluate all functions over the given partition.
+  void EvaluatePartition(const byte *const *rows, uint64_t num_rows, PartitionState *state) const;
+
+  // Evaluate the given aggregate function over the given partition.
+  template <typename T>
+  void EvaluateAggregate(const Function &func, const byte *const *rows, uint64_t num_rows,
+                         const PartitionState &state) const;
+
+ private:
+  // The partitioning key comparison function.
+  KeyEqualFn same_partition_fn_;
+  // The ordering key comparison function.
+  KeyEqualFn same_peer_fn_;
+  // The functions to compute.
+  std::vector<Function> functions_;
+  // The number of partitions in the last evaluation.
+  uint64_t num_partitions_;
+};
+
+}  // namespace terrier::execution::sql
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>  // NOLINT
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "common/macros.h"
+#include "execution/util/execution_common.h"
+
+namespace terrier::execution::util {
+
+/**
+ * A process-wide, morsel-driven scheduler for parallel pipelines.
+ *
+ * The scheduler owns a fixed pool of worker threads that is shared by all concurrently executing queries. A parallel
+ * operation (e.g., a table scan, or a merge of thread-local hash tables) is submitted as a job over an index range
+ * [begin, end). The range is split into small chunks called morsels that workers claim one at a time. Each
+ * participant of a job is given a contiguous "home" partition of the range which it drains first, for locality. When
+ * its home partition is exhausted, a participant steals morsels from the partitions of other participants.
+ *
+ * The thread submitting a job always participates in its execution, and the submission call only returns after all
+ * morsels have been processed. Hence, progress is guaranteed even when all workers are busy with other queries, and
+ * nested submissions cannot deadlock.
+ *
+ * Workers are shared between concurrent jobs using stride scheduling: every job carries a priority, and workers
+ * prefer the job that has received the least service relative to its priority. Workers re-evaluate their choice
+ * after every morsel, so a newly arriving query does not wait for a long-running scan to finish.
+ */
+class EXPORT MorselScheduler {
+ public:
+  /**
+   * Callback invoked for every morsel. The arguments are the [begin, end) range of the morsel.
+   */
+  using MorselFn = std::function<void(uint32_t, uint32_t)>;
+
+  /** The default priority of a job. */
+  static constexpr uint32_t DEFAULT_PRIORITY = 1;
+
+  /**
+   * Create a scheduler with the given number of worker threads. The workers are started immediately.
+   * @param num_workers The number of background worker threads.
+   */
+  explicit MorselScheduler(uint32_t num_workers);
+
+  /**
+   * Stop and join all worker threads. No job may be in flight.
+   */
+  ~MorselScheduler();
+
+  /**
+   * This class cannot be copied or moved.
+   */
+  DISALLOW_COPY_AND_MOVE(MorselScheduler);
+
+  /**
+   * @return The process-wide scheduler instance, sized to the number of logical cores of the machine.
+   */
+  static MorselScheduler *Instance();
+
+  /**
+   * Invoke @em morsel_fn on every morsel of the range [begin, end). This call blocks until the whole range has been
+   * processed. If any invocation throws, the first exception is rethrown on the calling thread after all running
+   * morsels have finished; morsels that have not been started by then are skipped.
+   * @param begin The start of the range.
+   * @param end The end of the range, non-inclusive.
+   * @param morsel_size The maximum number of elements in a single morsel.
+   * @param max_threads The maximum number of threads (including the calling thread) that may work on this job
+   *                    concurrently. A non-positive value means no limit.
+   * @param priority The priority of the job. A job with priority P receives P times the worker share of a job with
+   *                 priority 1 while both are running.
+   * @param work_stealing If false, background workers only process their home partition. The calling thread still
+   *                      processes any leftover morsels.
+   * @param morsel_fn The callback invoked on every morsel.
+   */
+  void ParallelFor(uint32_t begin, uint32_t end, uint32_t morsel_size, int32_t max_threads, uint32_t priority,
+                   bool work_stealing, const MorselFn &morsel_fn);
+
+  /**
+   * Invoke @em fn on every element in the range [begin, end) with one element per morsel, at default priority.
+   * @param begin The start of the range.
+   * @param end The end of the range, non-inclusive.
+   * @param fn The callback invoked on every element.
+   */
+  void ParallelFor(uint32_t begin, uint32_t end, const std::function<void(uint32_t)> &fn) {
+    ParallelFor(begin, end, 1, -1, DEFAULT_PRIORITY, true, [&](uint32_t morsel_begin, uint32_t morsel_end) {
+      for (uint32_t i = morsel_begin; i < morsel_end; i++) {
+        fn(i);
+      }
+    });
+  }
+
+  /**
+   * Invoke @em fn on every element of the given container, in parallel, with one element per morsel.
+   * @tparam Container The type of the container. Must support random access.
+   * @tparam F The type of the callback.
+   * @param container The container.
+   * @param fn The callback.
+   */
+  template <typename Container, typename F>
+  void ParallelForEach(Container &container, const F &fn) {  // NOLINT
+    ParallelFor(0, static_cast<uint32_t>(container.size()), [&](uint32_t idx) { fn(container[idx]); });
+  }
+
+  /** @return The number of background worker threads. */
+  uint32_t GetNumWorkers() const { return static_cast<uint32_t>(workers_.size()); }
+
+  /** @return The total number of morsels processed by this scheduler. */
+  uint64_t GetNumMorselsProcessed() const { return num_morsels_processed_.load(std::memory_order_relaxed); }
+
+ private:
+  struct Job;
+
+  // Main loop of a background worker.
+  void WorkerLoop();
+
+  // Select the runnable job with the lowest pass value, and join it. Must hold the scheduler latch.
+  Job *PickJob();
+
+  // Run morsels of the given job as the participant with the given home partition. Returns when there is nothing
+  // left to claim, or, for background workers, when other jobs are waiting and the worker should re-evaluate.
+  void RunMorsels(Job *job, uint32_t home, bool is_owner);
+
+ private:
+  // The background workers.
+  std::vector<std::thread> workers_;
+  // Protects the job list and the shutdown flag.
+  std::mutex latch_;
+  // Signalled when a new job is submitted, or on shutdown.
+  std::condition_variable work_cv_;
+  // All jobs that may still have unclaimed morsels.
+  std::vector<Job *> jobs_;
+  // The number of jobs in jobs_, readable without the latch.
+  std::atomic<uint32_t> num_jobs_{0};
+  // The minimum pass value over all active jobs, used to initialize new jobs.
+  double global_pass_{0.0};
+  // True when shutting down.
+  bool shutdown_{false};
+  // Statistics.
+  std::atomic<uint64_t> num_morsels_processed_{0};
+};
+
+}  // namespace terrier::execution::util
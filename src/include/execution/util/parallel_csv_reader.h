@@ -0,0 +1,150 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "common/constants.h"
+#include "common/macros.h"
+#include "storage/projected_columns.h"
+#include "type/type_id.h"
+
+namespace terrier::execution::util {
+
+/**
+ * A CSV reader for bulk loads that parses a file on all cores. The file is mapped into memory and split into chunks
+ * of roughly equal size that begin and end at record boundaries. Every chunk is parsed on a morsel of the
+ * MorselScheduler, directly into the column vectors of a ProjectedColumns batch that can be inserted into a table
+ * without any intermediate per-row representation. Cells are located with SIMD searches for the special characters,
+ * strings that fit into a VarlenEntry are copied straight out of the mapped file and numbers are converted in place.
+ *
+ * Splitting the file needs to know whether a chunk boundary is inside a quoted cell, which may contain new lines. The
+ * quote characters of every chunk are counted in parallel first; the parity of the quotes before a boundary tells
+ * whether it is quoted. Records must be terminated by '\n' (optionally preceded by '\r').
+ *
+ * General usage pattern:
+ *
+ * @code
+ * ParallelCSVReader reader(path, col_types, col_offsets);
+ * if (!reader.Initialize()) { ... ERROR ... }
+ * reader.Read(initializer, [&](storage::ProjectedColumns *batch) { ... called concurrently ... });
+ * @endcode
+ *
+ * Malformed records throw an ExecutionException, which is rethrown on the thread calling Read().
+ */
+class ParallelCSVReader {
+ public:
+  /** The default size of the chunks of the file that are parsed by a single morsel. */
+  static constexpr std::size_t DEFAULT_CHUNK_SIZE = 4 * common::Constants::MB;
+
+  /**
+   * A range of complete records in the file.
+   */
+  struct Chunk {
+    /** The offset of the first byte of the chunk. */
+    std::size_t begin_;
+    /** The offset one past the last byte of the chunk. */
+    std::size_t end_;
+  };
+
+  /**
+   * Callback receiving a batch of parsed records. It is invoked concurrently from multiple threads, and the batch may
+   * only be used until the callback returns.
+   */
+  using BatchFn = std::function<void(storage::ProjectedColumns *)>;
+
+  /**
+   * Constructor.
+   * @param path Accessible path to the CSV file.
+   * @param col_types The type of every field of a record, in the order they appear in the file.
+   * @param col_offsets The projection list index in the output batches of every field of a record.
+   * @param delimiter The character that separates fields within a record.
+   * @param quote The character used to quote fields.
+   * @param escape The character escaping a quote character inside a quoted field.
+   * @param null_string The unquoted field content that represents NULL.
+   * @param header True if the first record of the file is a header that should be skipped.
+   */
+  ParallelCSVReader(std::string path, std::vector<type::TypeId> col_types, std::vector<uint16_t> col_offsets,
+                    char delimiter = ',', char quote = '"', char escape = '"', std::string null_string = "\\N",
+                    bool header = false);
+
+  /**
+   * Destructor. Unmaps the file.
+   */
+  ~ParallelCSVReader();
+
+  /**
+   * This class cannot be copied or moved.
+   */
+  DISALLOW_COPY_AND_MOVE(ParallelCSVReader);
+
+  /**
+   * Open and map the file.
+   * @return True if the file was mapped successfully; false otherwise.
+   */
+  bool Initialize();
+
+  /**
+   * Split the file into chunks of complete records.
+   * @param chunk_size The approximate size of every chunk.
+   * @return The non-empty chunks of the file, in file order.
+   */
+  std::vector<Chunk> Split(std::size_t chunk_size) const;
+
+  /**
+   * Parse the whole file in parallel.
+   * @param initializer The initializer of the output batches, which must project every field of a record.
+   * @param batch_fn The callback receiving the batches.
+   * @param chunk_size The approximate size of the chunk of the file that is parsed by a single morsel.
+   * @return The number of records parsed.
+   */
+  uint64_t Read(const storage::ProjectedColumnsInitializer &initializer, const BatchFn &batch_fn,
+                std::size_t chunk_size = DEFAULT_CHUNK_SIZE) const;
+
+  /**
+   * @return The size of the file in bytes.
+   */
+  std::size_t GetSize() const { return size_; }
+
+ private:
+  // A single field of a record, pointing into the mapped file
+  struct Cell {
+    const char *ptr_;
+    std::size_t len_;
+    bool quoted_;
+    bool escaped_;
+  };
+
+  // Return the offset of the first record boundary at or after the given offset, given whether it is quoted
+  std::size_t NextRecordBoundary(std::size_t offset, bool quoted) const;
+
+  // Count the quote characters in [begin, end) that open or close a quoted field
+  uint64_t CountQuotes(std::size_t begin, std::size_t end) const;
+
+  // Parse all records of a chunk, passing every full batch to the callback
+  uint64_t ParseChunk(const Chunk &chunk, storage::ProjectedColumns *columns, const BatchFn &batch_fn) const;
+
+  // Parse the next cell starting at ptr and return the position of the character terminating it
+  const char *ParseCell(const char *ptr, const char *end, Cell *cell) const;
+
+  // Convert a cell and write it into the given row of the batch
+  void WriteCell(const Cell &cell, type::TypeId type, storage::ProjectedColumns *columns, uint16_t col_offset,
+                 uint32_t row) const;
+
+ private:
+  const std::string path_;
+  const std::vector<type::TypeId> col_types_;
+  const std::vector<uint16_t> col_offsets_;
+  const char delimiter_;
+  const char quote_char_;
+  const char escape_char_;
+  const std::string null_string_;
+  const bool header_;
+
+  // The mapped file
+  const char *data_{nullptr};
+  std::size_t size_{0};
+};
+
+}  // namespace terrier::execution::util
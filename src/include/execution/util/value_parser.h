@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+
+#include "common/strong_typedef.h"
+#include "type/type_id.h"
+
+namespace terrier::execution::util {
+
+/**
+ * Conversions from the text representation of values, as found in CSV files and COPY streams, to the storage format
+ * of their SQL type. They are shared by the readers of bulk loads, which find the values in their input and then write
+ * them straight into the column vectors of a ProjectedColumns batch.
+ */
+class ValueParser {
+ public:
+  /**
+   * Search for any of three characters, comparing a whole vector of characters at once where possible.
+   * @param ptr The first character to search.
+   * @param end One past the last character to search. Nothing at or after end is read.
+   * @param c0 The first character to search for.
+   * @param c1 The second character to search for.
+   * @param c2 The third character to search for.
+   * @return The first position in [ptr, end) holding one of the characters, or end if there is none.
+   */
+  static const char *FindAny(const char *ptr, const char *end, char c0, char c1, char c2);
+
+  /**
+   * Convert the text representation of a value and write it in storage format. Strings that do not fit into a
+   * VarlenEntry are copied into a buffer owned by the entry, so the text may be discarded afterwards.
+   * @param ptr The first character of the text.
+   * @param len The length of the text, which is not terminated.
+   * @param type The SQL type of the value.
+   * @param[out] value The attribute the value is written to.
+   * @throw ExecutionException if the text is not a valid value of the type, or the type is not supported.
+   */
+  static void ParseText(const char *ptr, std::size_t len, type::TypeId type, byte *value);
+};
+
+}  // namespace terrier::execution::util
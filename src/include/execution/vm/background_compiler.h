@@ -0,0 +1,113 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>  // NOLINT
+#include <deque>
+#include <functional>
+#include <mutex>  // NOLINT
+#include <thread>  // NOLINT
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "common/macros.h"
+#include "execution/util/execution_common.h"
+
+namespace terrier::execution::vm {
+
+/**
+ * A process-wide pool of threads dedicated to JIT-compiling modules in the background.
+ *
+ * Compilation is kept off the morsel scheduler's workers on purpose: a compilation runs for milliseconds to seconds
+ * and cannot be split into morsels, so it would hold a worker hostage while queries wait. Tasks are run in the order
+ * in which they were submitted. A task that has not started yet can be cancelled; this is how the owner of a module
+ * that is being destroyed makes sure no task will touch it afterwards.
+ */
+class EXPORT BackgroundCompiler {
+ public:
+  /**
+   * A handle to a submitted task.
+   */
+  using TaskId = uint64_t;
+
+  /**
+   * Create a compiler pool with the given number of threads. The threads are started immediately.
+   * @param num_threads The number of compilation threads.
+   */
+  explicit BackgroundCompiler(uint32_t num_threads);
+
+  /**
+   * Stop and join all threads. Tasks that have not been started are discarded.
+   */
+  ~BackgroundCompiler();
+
+  /**
+   * This class cannot be copied or moved.
+   */
+  DISALLOW_COPY_AND_MOVE(BackgroundCompiler);
+
+  /**
+   * @return The process-wide compiler pool.
+   */
+  static BackgroundCompiler *Instance();
+
+  /**
+   * Enqueue a task. Exceptions thrown by the task are logged and swallowed.
+   * @param task The task.
+   * @return A handle to the task.
+   */
+  TaskId Submit(std::function<void()> task);
+
+  /**
+   * Make sure the given task will not run after this call returns. If the task is still queued it is removed,
+   * otherwise this call blocks until the task has finished.
+   * @param id The handle of the task.
+   * @return True if the task was removed before it started.
+   */
+  bool CancelOrWait(TaskId id);
+
+  /**
+   * Run the given tasks concurrently on the pool and the calling thread, and return once all of them have finished.
+   * The calling thread runs every task that no compilation thread has picked up, so this never waits on a busy pool,
+   * and may also be called from a task running on the pool.
+   * @param tasks The tasks. Exceptions thrown by tasks run on the calling thread are propagated.
+   */
+  void RunConcurrently(std::vector<std::function<void()>> &&tasks);
+
+  /**
+   * Block until all submitted tasks have finished.
+   */
+  void WaitIdle();
+
+  /** @return The number of compilation threads. */
+  uint32_t GetNumThreads() const { return static_cast<uint32_t>(threads_.size()); }
+
+  /** @return The number of tasks that have run to completion. */
+  uint64_t GetNumCompleted() const { return num_completed_.load(std::memory_order_relaxed); }
+
+ private:
+  // Main loop of a compilation thread.
+  void ThreadLoop();
+
+ private:
+  // The compilation threads.
+  std::vector<std::thread> threads_;
+  // Protects everything below.
+  std::mutex latch_;
+  // Signalled when a task is submitted, or on shutdown.
+  std::condition_variable work_cv_;
+  // Signalled when a task finishes.
+  std::condition_variable done_cv_;
+  // Tasks that have not been started, in submission order.
+  std::deque<std::pair<TaskId, std::function<void()>>> queue_;
+  // Tasks that are running.
+  std::unordered_set<TaskId> running_;
+  // The handle of the next task.
+  TaskId next_id_{1};
+  // True when shutting down.
+  bool shutdown_{false};
+  // Statistics.
+  std::atomic<uint64_t> num_completed_{0};
+};
+
+}  // namespace terrier::execution::vm
@@ -349,6 +349,9 @@ class BytecodeEmitter {
   /** Initialize a sorter instance. */
   void EmitSorterInit(Bytecode bytecode, LocalVar sorter, LocalVar region, FunctionId cmp_fn, LocalVar tuple_size);
 
+  /** Initialize a window evaluator instance. */
+  void EmitWindowEvaluatorInit(LocalVar evaluator, FunctionId same_partition_fn, FunctionId same_peer_fn);
+
   /** Initialize a CSV reader. */
   // void EmitCSVReaderInit(LocalVar creader, LocalVar file_name, uint32_t file_name_len);
 
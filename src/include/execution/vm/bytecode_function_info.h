@@ -289,6 +289,7 @@ class FunctionInfo {
 
  private:
   friend class BytecodeGenerator;
+  friend class BytecodeOptimizer;
 
   // Mark the range of bytecode for this function in its module. This is set
   // by the BytecodeGenerator during code generation after this function's
@@ -49,9 +49,10 @@ class BytecodeGenerator final : public ast::AstVisitor<BytecodeGenerator> {
    * Main entry point to convert a valid (i.e., parsed and type-checked) AST into a bytecode module.
    * @param root The root of the AST.
    * @param name The (optional) name of the program.
+   * @param optimize Whether to run the BytecodeOptimizer over the generated bytecode.
    * @return A compiled bytecode module.
    */
-  static std::unique_ptr<BytecodeModule> Compile(ast::AstNode *root, const std::string &name);
+  static std::unique_ptr<BytecodeModule> Compile(ast::AstNode *root, const std::string &name, bool optimize = true);
 
   /**
    * @return The emitter used by this generator to write bytecode.
@@ -96,6 +97,7 @@ class BytecodeGenerator final : public ast::AstVisitor<BytecodeGenerator> {
   void VisitBuiltinHashTableEntryIteratorCall(ast::CallExpr *call, ast::Builtin builtin);
   void VisitBuiltinSorterCall(ast::CallExpr *call, ast::Builtin builtin);
   void VisitBuiltinSorterIterCall(ast::CallExpr *call, ast::Builtin builtin);
+  void VisitBuiltinWindowEvaluatorCall(ast::CallExpr *call, ast::Builtin builtin);
   void VisitResultBufferCall(ast::CallExpr *call, ast::Builtin builtin);
   void VisitCSVReaderCall(ast::CallExpr *call, ast::Builtin builtin);
   void VisitExecutionContextCall(ast::CallExpr *call, ast::Builtin builtin);
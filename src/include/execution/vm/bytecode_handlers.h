@@ -25,6 +25,7 @@
 #include "execution/sql/table_vector_iterator.h"
 #include "execution/sql/thread_state_container.h"
 #include "execution/sql/vector_filter_executor.h"
+#include "execution/sql/window_evaluator.h"
 #include "parser/expression/constant_value_expression.h"
 
 // #include "execution/util/csv_reader.h" Fix later.
@@ -186,12 +187,45 @@ VM_OP_HOT void OpLeaScaled(terrier::byte **dest, terrier::byte *base, uint32_t i
   *dest = base + (scale * index) + offset;
 }
 
+VM_OP_HOT void OpLoadField1(int8_t *dest, const terrier::byte *base, uint32_t offset) {
+  *dest = *reinterpret_cast<const int8_t *>(base + offset);
+}
+
+VM_OP_HOT void OpLoadField2(int16_t *dest, const terrier::byte *base, uint32_t offset) {
+  *dest = *reinterpret_cast<const int16_t *>(base + offset);
+}
+
+VM_OP_HOT void OpLoadField4(int32_t *dest, const terrier::byte *base, uint32_t offset) {
+  *dest = *reinterpret_cast<const int32_t *>(base + offset);
+}
+
+VM_OP_HOT void OpLoadField8(int64_t *dest, const terrier::byte *base, uint32_t offset) {
+  *dest = *reinterpret_cast<const int64_t *>(base + offset);
+}
+
+VM_OP_HOT void OpLoadFieldN(terrier::byte *dest, const terrier::byte *base, uint32_t offset, uint32_t len) {
+  std::memcpy(dest, base + offset, len);
+}
+
 VM_OP_HOT bool OpJump() { return true; }
 
 VM_OP_HOT bool OpJumpIfTrue(bool cond) { return cond; }
 
 VM_OP_HOT bool OpJumpIfFalse(bool cond) { return !cond; }
 
+// Fused compare-and-branch. Each returns true if the jump is taken, i.e., if the comparison is false.
+#define COMPARE_JUMPS(type, ...)                                                                      \
+  VM_OP_HOT bool OpGreaterThanJumpIfFalse##_##type(type lhs, type rhs) { return !(lhs > rhs); }       \
+  VM_OP_HOT bool OpGreaterThanEqualJumpIfFalse##_##type(type lhs, type rhs) { return !(lhs >= rhs); } \
+  VM_OP_HOT bool OpEqualJumpIfFalse##_##type(type lhs, type rhs) { return !(lhs == rhs); }            \
+  VM_OP_HOT bool OpLessThanJumpIfFalse##_##type(type lhs, type rhs) { return !(lhs < rhs); }          \
+  VM_OP_HOT bool OpLessThanEqualJumpIfFalse##_##type(type lhs, type rhs) { return !(lhs <= rhs); }    \
+  VM_OP_HOT bool OpNotEqualJumpIfFalse##_##type(type lhs, type rhs) { return !(lhs != rhs); }
+
+ALL_TYPES(COMPARE_JUMPS);
+
+#undef COMPARE_JUMPS
+
 VM_OP_HOT void OpCall(UNUSED_ATTRIBUTE uint16_t func_id, UNUSED_ATTRIBUTE uint16_t num_args) {}
 
 VM_OP_HOT void OpReturn() {}
@@ -538,6 +572,8 @@ VM_OP_HOT void OpForceBoolTruth(bool *result, terrier::execution::sql::BoolVal *
   *result = input->ForceTruth();
 }
 
+VM_OP_HOT bool OpForceBoolTruthJumpIfFalse(terrier::execution::sql::BoolVal *input) { return !input->ForceTruth(); }
+
 VM_OP_HOT void OpInitSqlNull(terrier::execution::sql::Val *result) { *result = terrier::execution::sql::Val(true); }
 
 VM_OP_HOT void OpInitBool(terrier::execution::sql::BoolVal *result, bool input) {
@@ -1536,6 +1572,25 @@ VM_OP_WARM void OpSorterIteratorSkipRows(terrier::execution::sql::SorterIterator
 
 VM_OP void OpSorterIteratorFree(terrier::execution::sql::SorterIterator *iter);
 
+// ---------------------------------------------------------
+// Window functions
+// ---------------------------------------------------------
+
+VM_OP void OpWindowEvaluatorInit(terrier::execution::sql::WindowEvaluator *evaluator,
+                                 terrier::execution::sql::WindowEvaluator::KeyEqualFn same_partition_fn,
+                                 terrier::execution::sql::WindowEvaluator::KeyEqualFn same_peer_fn);
+
+VM_OP void OpWindowEvaluatorAddFunction(terrier::execution::sql::WindowEvaluator *evaluator, uint32_t function,
+                                        uint32_t type, uint32_t arg_offset, uint32_t result_offset, int64_t offset);
+
+VM_OP void OpWindowEvaluatorSetFrame(terrier::execution::sql::WindowEvaluator *evaluator, uint32_t frame_type,
+                                     uint32_t start, int64_t start_offset, uint32_t end, int64_t end_offset);
+
+VM_OP void OpWindowEvaluatorEvaluate(terrier::execution::sql::WindowEvaluator *evaluator,
+                                     terrier::execution::sql::Sorter *sorter);
+
+VM_OP void OpWindowEvaluatorFree(terrier::execution::sql::WindowEvaluator *evaluator);
+
 // ---------------------------------------------------------
 // Output
 // ---------------------------------------------------------
@@ -118,6 +118,7 @@ class BytecodeModule {
  private:
   friend class VM;
   friend class LLVMEngine;
+  friend class JitObjectCache;
 
   // Access the raw bytecode for the given function. Unlike the public
   // GetBytecodeForFunction(), this function doesn't return an iterator. It
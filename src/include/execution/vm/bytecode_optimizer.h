@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "execution/vm/bytecode_function_info.h"
+
+namespace terrier::execution::vm {
+
+/**
+ * A peephole optimizer that runs over freshly generated bytecode, before it is packaged into a BytecodeModule.
+ *
+ * The BytecodeGenerator is a straightforward tree-walker: every sub-expression materializes its result into a
+ * temporary, and the consumer of the expression reads it back out. In the interpreter each of these round-trips costs
+ * a full dispatch. The optimizer scans each function for short instruction sequences that communicate only through a
+ * temporary and replaces them with a single, equivalent instruction:
+ *
+ * - A primitive comparison followed by a JumpIfFalse on its result becomes a fused compare-and-branch.
+ * - A ForceBoolTruth followed by a JumpIfFalse on its result becomes a fused SQL-boolean branch.
+ * - A Lea followed by a Deref of the computed address becomes a LoadField.
+ * - A side-effect free instruction whose result is only moved into another location writes the location directly.
+ * - Self-assignments and side-effect free writes to temporaries that are never read are removed.
+ *
+ * A sequence is only rewritten if the temporary is referenced nowhere else in the function, and if no jump lands in
+ * the middle of it. Jump offsets are relocated after rewriting.
+ */
+class BytecodeOptimizer {
+ public:
+  /**
+   * Statistics about a single optimization run.
+   */
+  struct Stats {
+    /** The number of superinstructions created. */
+    uint32_t num_fused_{0};
+    /** The number of moves that were forwarded into their producer. */
+    uint32_t num_forwarded_{0};
+    /** The number of instructions that were removed outright. */
+    uint32_t num_removed_{0};
+    /** The size of the bytecode before optimizing. */
+    std::size_t size_before_{0};
+    /** The size of the bytecode after optimizing. */
+    std::size_t size_after_{0};
+  };
+
+  /**
+   * Optimize all functions in the given bytecode, in place. The bytecode ranges of the functions are updated.
+   * @param code The bytecode of all functions in a module.
+   * @param functions The functions in the module.
+   * @return Statistics about what was optimized.
+   */
+  static Stats Optimize(std::vector<uint8_t> *code, std::vector<FunctionInfo> *functions);
+};
+
+}  // namespace terrier::execution::vm
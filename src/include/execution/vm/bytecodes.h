@@ -71,6 +71,15 @@ namespace terrier::execution::vm {
   F(Jump, OperandType::JumpOffset)                                                                                    \
   F(JumpIfTrue, OperandType::Local, OperandType::JumpOffset)                                                          \
   F(JumpIfFalse, OperandType::Local, OperandType::JumpOffset)                                                         \
+  /* Fused compare-and-branch, produced by the BytecodeOptimizer. Each jumps if the condition is false. */            \
+  CREATE_FOR_ALL_TYPES(F, GreaterThanJumpIfFalse, OperandType::Local, OperandType::Local, OperandType::JumpOffset)    \
+  CREATE_FOR_ALL_TYPES(F, GreaterThanEqualJumpIfFalse, OperandType::Local, OperandType::Local,                        \
+                       OperandType::JumpOffset)                                                                       \
+  CREATE_FOR_ALL_TYPES(F, EqualJumpIfFalse, OperandType::Local, OperandType::Local, OperandType::JumpOffset)          \
+  CREATE_FOR_ALL_TYPES(F, LessThanJumpIfFalse, OperandType::Local, OperandType::Local, OperandType::JumpOffset)       \
+  CREATE_FOR_ALL_TYPES(F, LessThanEqualJumpIfFalse, OperandType::Local, OperandType::Local, OperandType::JumpOffset)  \
+  CREATE_FOR_ALL_TYPES(F, NotEqualJumpIfFalse, OperandType::Local, OperandType::Local, OperandType::JumpOffset)       \
+  F(ForceBoolTruthJumpIfFalse, OperandType::Local, OperandType::JumpOffset)                                           \
                                                                                                                       \
   /* Memory/pointer operations */                                                                                     \
   F(IsNullPtr, OperandType::Local, OperandType::Local)                                                                \
@@ -92,6 +101,12 @@ namespace terrier::execution::vm {
   F(AssignImm8F, OperandType::Local, OperandType::Imm8F)                                                              \
   F(Lea, OperandType::Local, OperandType::Local, OperandType::Imm4)                                                   \
   F(LeaScaled, OperandType::Local, OperandType::Local, OperandType::Local, OperandType::Imm4, OperandType::Imm4)      \
+  /* Fused Lea+Deref, produced by the BytecodeOptimizer */                                                            \
+  F(LoadField1, OperandType::Local, OperandType::Local, OperandType::Imm4)                                            \
+  F(LoadField2, OperandType::Local, OperandType::Local, OperandType::Imm4)                                            \
+  F(LoadField4, OperandType::Local, OperandType::Local, OperandType::Imm4)                                            \
+  F(LoadField8, OperandType::Local, OperandType::Local, OperandType::Imm4)                                            \
+  F(LoadFieldN, OperandType::Local, OperandType::Local, OperandType::Imm4, OperandType::UImm4)                        \
                                                                                                                       \
   /* Function calls */                                                                                                \
   F(Call, OperandType::FunctionId, OperandType::LocalCount)                                                           \
@@ -503,6 +518,15 @@ namespace terrier::execution::vm {
   F(SorterIteratorSkipRows, OperandType::Local, OperandType::Local)                                                   \
   F(SorterIteratorFree, OperandType::Local)                                                                           \
                                                                                                                       \
+  /* Window functions */                                                                                              \
+  F(WindowEvaluatorInit, OperandType::Local, OperandType::FunctionId, OperandType::FunctionId)                        \
+  F(WindowEvaluatorAddFunction, OperandType::Local, OperandType::Local, OperandType::Local, OperandType::Local,        \
+    OperandType::Local, OperandType::Local)                                                                           \
+  F(WindowEvaluatorSetFrame, OperandType::Local, OperandType::Local, OperandType::Local, OperandType::Local,           \
+    OperandType::Local, OperandType::Local)                                                                           \
+  F(WindowEvaluatorEvaluate, OperandType::Local, OperandType::Local)                                                  \
+  F(WindowEvaluatorFree, OperandType::Local)                                                                          \
+                                                                                                                      \
   /* Output */                                                                                                        \
   F(ResultBufferAllocOutputRow, OperandType::Local, OperandType::Local)                                               \
   F(ResultBufferFinalize, OperandType::Local)                                                                         \
@@ -798,7 +822,24 @@ class Bytecodes {
    * @return True if the bytecode @em bytecode is a conditional jump; false otherwise.
    */
   static constexpr bool IsConditionalJump(Bytecode bytecode) {
-    return bytecode == Bytecode::JumpIfFalse || bytecode == Bytecode::JumpIfTrue;
+    return bytecode == Bytecode::JumpIfFalse || bytecode == Bytecode::JumpIfTrue || IsFusedConditionalJump(bytecode);
+  }
+
+  /**
+   * @return True if the bytecode @em bytecode is a superinstruction that evaluates a condition and
+   *         jumps if it is false. Its handler returns true if the jump is taken.
+   */
+  static constexpr bool IsFusedConditionalJump(Bytecode bytecode) {
+    return bytecode >= Bytecode::GreaterThanJumpIfFalse_bool && bytecode <= Bytecode::ForceBoolTruthJumpIfFalse;
+  }
+
+  /**
+   * @return The index of the jump offset operand of the jump bytecode @em bytecode. The jump
+   *         offset is always the last operand.
+   */
+  static uint32_t GetJumpOffsetOperandIndex(Bytecode bytecode) {
+    TERRIER_ASSERT(IsJump(bytecode), "Bytecode is not a jump");
+    return NumOperands(bytecode) - 1;
   }
 
   /**
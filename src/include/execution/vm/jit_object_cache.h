@@ -0,0 +1,165 @@
+#pragma once
+
+#include <llvm/Support/MemoryBuffer.h>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "common/macros.h"
+#include "execution/util/execution_common.h"
+
+namespace terrier::execution::vm {
+
+class BytecodeModule;
+
+/**
+ * A persistent, size-bounded cache of JIT-compiled object files, shared by all modules in the process.
+ *
+ * Machine code generation dominates the cost of compiling a module, and a server that is restarted recompiles the same
+ * few hundred statements. Each entry holds the object file the LLVMEngine produced for one bytecode module. The
+ * fingerprint of a module serializes everything the generated code depends on: the module's bytecode, function
+ * signatures, frame layouts and static data. Entries are keyed by a hash of the fingerprint and store the fingerprint
+ * itself, so a module whose key collides with another one's never gets its object. Each entry also records the version
+ * of the code generator, i.e., a hash of the bytecode handlers bitcode and of the target CPU and its features. An entry
+ * produced by a different version is never returned; it is deleted when it is found.
+ *
+ * Each entry is a file in the cache directory. New entries are written to a temporary file and renamed, so concurrent
+ * processes sharing a directory only ever observe complete files. When the total size of all entries exceeds the
+ * configured limit, the least recently used entries are evicted.
+ */
+class EXPORT JitObjectCache {
+ public:
+  /**
+   * The key of a cache entry.
+   */
+  using Key = uint64_t;
+
+  /**
+   * Open a cache in the given directory, creating the directory if needed. Existing entries are kept.
+   * @param directory The directory holding the cache entries.
+   * @param max_size_bytes The maximum total size of all entries.
+   */
+  JitObjectCache(std::string directory, uint64_t max_size_bytes);
+
+  /**
+   * This class cannot be copied or moved.
+   */
+  DISALLOW_COPY_AND_MOVE(JitObjectCache);
+
+  /**
+   * @return The process-wide cache, or null if JIT results are not cached.
+   */
+  static JitObjectCache *Instance() { return instance.load(std::memory_order_acquire); }
+
+  /**
+   * Make the given cache the process-wide cache. The caller retains ownership.
+   * @param cache The cache, or null to disable caching.
+   */
+  static void SetInstance(JitObjectCache *cache) { instance.store(cache, std::memory_order_release); }
+
+  /**
+   * Compute the fingerprint of the given bytecode module.
+   * @param module The module.
+   * @return Everything the module's object file depends on, serialized.
+   */
+  static std::string ComputeFingerprint(const BytecodeModule &module);
+
+  /**
+   * Compute the key of a module.
+   * @param fingerprint The fingerprint of the module.
+   * @return The key under which the module's object file is cached.
+   */
+  static Key ComputeKey(std::string_view fingerprint);
+
+  /**
+   * Find the object file stored under the given key.
+   * @param key The key.
+   * @param fingerprint The fingerprint of the module the object file must belong to.
+   * @param version The version of the code generator.
+   * @return The object file, or null if there is no such entry, or if it belongs to another module or version.
+   */
+  std::unique_ptr<llvm::MemoryBuffer> Lookup(Key key, std::string_view fingerprint, uint64_t version);
+
+  /**
+   * Store an object file under the given key, replacing any existing entry. Evicts entries as needed.
+   * @param key The key.
+   * @param fingerprint The fingerprint of the module the object file belongs to.
+   * @param version The version of the code generator that produced the object.
+   * @param object The object file.
+   */
+  void Insert(Key key, std::string_view fingerprint, uint64_t version, const llvm::MemoryBuffer &object);
+
+  /**
+   * Remove all entries.
+   */
+  void Clear();
+
+  /** @return The directory holding the cache entries. */
+  const std::string &GetDirectory() const { return directory_; }
+
+  /** @return The total size of all entries, in bytes. */
+  uint64_t GetSizeInBytes() const {
+    std::lock_guard<std::mutex> lock(latch_);
+    return total_size_;
+  }
+
+  /** @return The number of entries. */
+  std::size_t GetNumEntries() const {
+    std::lock_guard<std::mutex> lock(latch_);
+    return entries_.size();
+  }
+
+  /** @return The number of successful lookups. */
+  uint64_t GetNumHits() const { return num_hits_.load(std::memory_order_relaxed); }
+
+  /** @return The number of failed lookups. */
+  uint64_t GetNumMisses() const { return num_misses_.load(std::memory_order_relaxed); }
+
+  /** @return The number of entries evicted to stay within the size limit. */
+  uint64_t GetNumEvictions() const { return num_evictions_.load(std::memory_order_relaxed); }
+
+ private:
+  struct Entry {
+    // The size of the file, in bytes.
+    uint64_t size_;
+    // The logical time of the last use, for LRU eviction.
+    uint64_t last_use_;
+  };
+
+  // The path of the file holding the entry with the given key.
+  std::string EntryPath(Key key) const;
+
+  // Forget and delete the entry with the given key. Requires the latch.
+  void RemoveEntry(Key key);
+
+  // Evict entries until the total size is within the limit. Requires the latch.
+  void EvictIfNeeded();
+
+ private:
+  // The process-wide cache.
+  static std::atomic<JitObjectCache *> instance;
+
+  // The directory holding the cache entries.
+  const std::string directory_;
+  // The maximum total size of all entries.
+  const uint64_t max_size_bytes_;
+  // Protects everything below.
+  mutable std::mutex latch_;
+  // All known entries.
+  std::unordered_map<Key, Entry> entries_;
+  // The total size of all entries.
+  uint64_t total_size_{0};
+  // The logical clock used to order uses of entries.
+  uint64_t clock_{0};
+  // Statistics.
+  std::atomic<uint64_t> num_hits_{0};
+  std::atomic<uint64_t> num_misses_{0};
+  std::atomic<uint64_t> num_evictions_{0};
+};
+
+}  // namespace terrier::execution::vm
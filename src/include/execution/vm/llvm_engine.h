@@ -17,6 +17,7 @@ namespace terrier::execution::vm {
 
 class BytecodeModule;
 class FunctionInfo;
+class JitObjectCache;
 class LocalVar;
 
 /**
@@ -50,7 +51,8 @@ class LLVMEngine {
   static void Shutdown();
 
   /**
-   * JIT compile a TPL bytecode module to native code
+   * JIT compile a TPL bytecode module to native code. If the options provide an object cache, a previously compiled
+   * object for an identical module is loaded instead, and newly compiled objects are added to the cache.
    * @param module The module to compile
    * @param options The compiler options
    * @return The JIT compiled module
@@ -117,6 +119,21 @@ class LLVMEngine {
      */
     const std::string &GetOutputObjectFileName() const { return output_file_name_; }
 
+    /**
+     * Set the cache to look up compiled modules in, and to store them into.
+     * @param cache The cache, or null to always compile from scratch.
+     * @return the updated object
+     */
+    CompilerOptions &SetObjectCache(JitObjectCache *cache) {
+      object_cache_ = cache;
+      return *this;
+    }
+
+    /**
+     * @return the cache of compiled modules, or null if none is used.
+     */
+    JitObjectCache *GetObjectCache() const { return object_cache_; }
+
     /**
      * @return the path to the bytecode handlers bitcode file.
      */
@@ -126,6 +143,7 @@ class LLVMEngine {
     bool debug_{false};
     bool write_obj_file_{false};
     std::string output_file_name_;
+    JitObjectCache *object_cache_{nullptr};
   };
 
   // -------------------------------------------------------
@@ -173,6 +191,11 @@ class LLVMEngine {
      */
     std::size_t GetModuleObjectCodeSizeInBytes() const { return object_code_->getBufferSize(); }
 
+    /**
+     * Return the module's object code.
+     */
+    const llvm::MemoryBuffer &GetModuleObjectCode() const { return *object_code_; }
+
     /**
      * Load the given module @em module into memory. If this module has already
      * been loaded, it will not be reloaded.
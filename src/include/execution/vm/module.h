@@ -9,6 +9,7 @@
 #include <utility>
 
 #include "execution/ast/type.h"
+#include "execution/vm/background_compiler.h"
 #include "execution/vm/bytecode_module.h"
 #include "execution/vm/llvm_engine.h"
 #include "execution/vm/vm_defs.h"
@@ -42,6 +43,11 @@ class Module {
    */
   Module(std::unique_ptr<BytecodeModule> bytecode_module, std::unique_ptr<LLVMEngine::CompiledModule> llvm_module);
 
+  /**
+   * Destructor. Cancels or waits for a pending background compilation of this module.
+   */
+  ~Module();
+
   /**
    * This class cannot be copied or moved.
    */
@@ -91,7 +97,7 @@ class Module {
    */
   void *GetRawFunctionImpl(const FunctionId func_id) const {
     TERRIER_ASSERT(func_id < bytecode_module_->GetFunctionCount(), "Out-of-bounds function access");
-    return functions_[func_id].load(std::memory_order_relaxed);
+    return functions_[func_id].load(std::memory_order_acquire);
   }
 
   /**
@@ -99,13 +105,28 @@ class Module {
    */
   const BytecodeModule *GetBytecodeModule() const { return bytecode_module_.get(); }
 
+  /**
+   * @return True if machine code for this module is available, and has been swapped into the function table.
+   */
+  bool IsCompiled() const { return compiled_.load(std::memory_order_acquire); }
+
+  /**
+   * Compile this module into machine code and atomically swap the compiled functions into the function table. This
+   * is a blocking call. If the module is already compiled, or compilation is in progress on another thread, this
+   * call returns once compilation has finished.
+   */
+  void CompileToMachineCode();
+
+  /**
+   * Trigger compilation of this module into machine code on the background compiler pool. This is a non-blocking
+   * call. Only the first call has an effect.
+   */
+  void CompileToMachineCodeAsync();
+
  private:
   friend class VM;                            // For the VM to access raw bytecode.
   friend class test::BytecodeTrampolineTest;  // For the tests to check private methods.
 
-  // This class encapsulates the ability to asynchronously JIT compile a module.
-  class AsyncCompileTask;
-
   // A trampoline is a stub function that serves as a landing point for all
   // functions executed in interpreted mode. The purpose of the trampoline is
   // to arrange and adjust call arguments from the C/C++ ABI to the TPL ABI.
@@ -143,13 +164,6 @@ class Module {
     return jit_module_->GetFunctionPointer(func_info->GetName());
   }
 
-  // Compile this module into machine code. This is a blocking call.
-  void CompileToMachineCode();
-
-  // Compile this module into machine code. This is a non-blocking call that
-  // triggers a compilation in the background.
-  void CompileToMachineCodeAsync();
-
  private:
   // The module containing all TBC (i.e., bytecode) for the TPL program.
   std::unique_ptr<BytecodeModule> bytecode_module_;
@@ -168,6 +182,13 @@ class Module {
 
   // Flag to indicate if the JIT compilation has occurred.
   std::once_flag compiled_flag_;
+
+  // Set once the compiled functions have been swapped into the function table.
+  std::atomic<bool> compiled_{false};
+
+  // Set once an asynchronous compilation has been requested, and the handle of the background task.
+  std::atomic<bool> async_compile_requested_{false};
+  BackgroundCompiler::TaskId async_compile_task_{0};
 };
 
 // ---------------------------------------------------------
@@ -208,8 +229,15 @@ inline bool Module::GetFunction(const std::string &name, const ExecutionMode exe
 
   switch (exec_mode) {
     case ExecutionMode::Adaptive: {
+      // Start compiling in the background, and call through the function table so that compiled functions are picked
+      // up as soon as they are swapped in. Until then, the table points at the bytecode trampolines.
       CompileToMachineCodeAsync();
-      FALLTHROUGH;
+      *func = [this, func_info](ArgTypes... args) -> Ret {
+        void *raw_func = functions_[func_info->GetId()].load(std::memory_order_acquire);
+        auto *f = reinterpret_cast<Ret (*)(ArgTypes...)>(raw_func);
+        return f(args...);
+      };
+      break;
     }
     case ExecutionMode::Interpret: {
       *func = [this, func_info](ArgTypes... args) -> Ret {
@@ -239,7 +267,7 @@ inline bool Module::GetFunction(const std::string &name, const ExecutionMode exe
     case ExecutionMode::Compiled: {
       CompileToMachineCode();
       *func = [this, func_info](ArgTypes... args) -> Ret {
-        void *raw_func = functions_[func_info->GetId()].load(std::memory_order_relaxed);
+        void *raw_func = functions_[func_info->GetId()].load(std::memory_order_acquire);
         auto *jit_f = reinterpret_cast<Ret (*)(ArgTypes...)>(raw_func);
         return jit_f(args...);
       };
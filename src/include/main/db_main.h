@@ -7,8 +7,12 @@
 
 #include "catalog/catalog.h"
 #include "common/action_context.h"
+#include "common/constants.h"
 #include "common/managed_pointer.h"
+#include "execution/vm/jit_object_cache.h"
 #include "metrics/metrics_thread.h"
+#include "network/itp/itp_command_factory.h"
+#include "network/itp/itp_protocol_interpreter.h"
 #include "network/postgres/postgres_command_factory.h"
 #include "network/postgres/postgres_protocol_interpreter.h"
 #include "network/terrier_server.h"
@@ -16,6 +20,8 @@
 #include "settings/settings_manager.h"
 #include "settings/settings_param.h"
 #include "storage/garbage_collector_thread.h"
+#include "storage/recovery/recovery_manager.h"
+#include "storage/recovery/replication_log_provider.h"
 #include "transaction/deferred_action_manager.h"
 #include "transaction/transaction_manager.h"
 
@@ -230,17 +236,43 @@ class DBMain {
      * @param port argument to TerrierServer
      * @param connection_thread_count argument to TerrierServer
      * @param socket_directory argument to TerrierServer
+     * @param execution_thread_count number of workers executing the commands, 0 to execute them on the connection
+     * handler threads
+     * @param vectored_writes argument to the ConnectionHandleFactory
+     * @param shared_memory_ring_size argument to the ConnectionHandleFactory
+     * @param write_queue_limit argument to the ConnectionHandleFactory
+     * @param write_timeout argument to the ConnectionHandleFactory
+     * @param statement_cache_size argument to the PostgresProtocolInterpreter::Provider
+     * @param replication_port port of the TerrierServer that receives the logs of the primary over ITP, 0 if this is
+     * not a replica
      */
     NetworkLayer(const common::ManagedPointer<common::DedicatedThreadRegistry> thread_registry,
                  const common::ManagedPointer<trafficcop::TrafficCop> traffic_cop, const uint16_t port,
-                 const uint16_t connection_thread_count, const std::string socket_directory) {
-      connection_handle_factory_ = std::make_unique<network::ConnectionHandleFactory>(traffic_cop);
+                 const uint16_t connection_thread_count, const std::string socket_directory,
+                 const uint16_t execution_thread_count, const bool vectored_writes,
+                 const uint32_t shared_memory_ring_size, const uint64_t write_queue_limit,
+                 const uint32_t write_timeout, const uint32_t statement_cache_size,
+                 const uint16_t replication_port) {
+      connection_handle_factory_ = std::make_unique<network::ConnectionHandleFactory>(
+          traffic_cop, vectored_writes, shared_memory_ring_size, write_queue_limit, write_timeout);
       command_factory_ = std::make_unique<network::PostgresCommandFactory>();
-      provider_ =
-          std::make_unique<network::PostgresProtocolInterpreter::Provider>(common::ManagedPointer(command_factory_));
+      if (execution_thread_count > 0) {
+        execution_pool_ = std::make_unique<network::ExecutionPool>(thread_registry, execution_thread_count);
+      }
+      provider_ = std::make_unique<network::PostgresProtocolInterpreter::Provider>(
+          common::ManagedPointer(command_factory_), common::ManagedPointer(execution_pool_), statement_cache_size);
       server_ = std::make_unique<network::TerrierServer>(
           common::ManagedPointer(provider_), common::ManagedPointer(connection_handle_factory_), thread_registry, port,
-          connection_thread_count, socket_directory);
+          connection_thread_count, socket_directory, common::ManagedPointer(execution_pool_));
+      if (replication_port != 0) {
+        // The primary opens a single connection, over which the commands are applied in order
+        itp_command_factory_ = std::make_unique<network::ITPCommandFactory>();
+        itp_provider_ =
+            std::make_unique<network::ITPProtocolInterpreter::Provider>(common::ManagedPointer(itp_command_factory_));
+        replication_server_ = std::make_unique<network::TerrierServer>(
+            common::ManagedPointer(itp_provider_), common::ManagedPointer(connection_handle_factory_), thread_registry,
+            replication_port, 1, socket_directory, nullptr);
+      }
     }
 
     /**
@@ -248,22 +280,108 @@ class DBMain {
      */
     common::ManagedPointer<network::TerrierServer> GetServer() const { return common::ManagedPointer(server_); }
 
+    /**
+     * @return ManagedPointer to the server that receives the logs of the primary, can be nullptr if not a replica
+     */
+    common::ManagedPointer<network::TerrierServer> GetReplicationServer() const {
+      return common::ManagedPointer(replication_server_);
+    }
+
    private:
     // Order matters here for destruction order
     std::unique_ptr<network::ConnectionHandleFactory> connection_handle_factory_;
     std::unique_ptr<network::PostgresCommandFactory> command_factory_;
+    std::unique_ptr<network::ExecutionPool> execution_pool_;
     std::unique_ptr<network::ProtocolInterpreter::Provider> provider_;
     std::unique_ptr<network::TerrierServer> server_;
+    std::unique_ptr<network::ITPCommandFactory> itp_command_factory_;
+    std::unique_ptr<network::ProtocolInterpreter::Provider> itp_provider_;
+    std::unique_ptr<network::TerrierServer> replication_server_;
+  };
+
+  /**
+   * The replica side of the replication of the WAL: a RecoveryManager that applies the logs that the
+   * ReplicationLogProvider receives from the primary, from construction until destruction
+   */
+  class ReplicationLayer {
+   public:
+    /**
+     * @param thread_registry argument to the RecoveryManager
+     * @param txn_layer argument to the RecoveryManager
+     * @param storage_layer argument to the RecoveryManager
+     * @param catalog_layer argument to the RecoveryManager
+     */
+    ReplicationLayer(const common::ManagedPointer<common::DedicatedThreadRegistry> thread_registry,
+                     const common::ManagedPointer<TransactionLayer> txn_layer,
+                     const common::ManagedPointer<StorageLayer> storage_layer,
+                     const common::ManagedPointer<CatalogLayer> catalog_layer)
+        : log_provider_(std::make_unique<storage::ReplicationLogProvider>()) {
+      recovery_manager_ = std::make_unique<storage::RecoveryManager>(
+          common::ManagedPointer<storage::AbstractLogProvider>(log_provider_.get()), catalog_layer->GetCatalog(),
+          txn_layer->GetTransactionManager(), txn_layer->GetDeferredActionManager(), thread_registry,
+          storage_layer->GetBlockStore());
+      recovery_manager_->StartRecovery();
+    }
+
+    /**
+     * Applies the logs that arrived and stops the RecoveryManager
+     */
+    ~ReplicationLayer() {
+      log_provider_->EndReplication();
+      if (!replication_ended_) recovery_manager_->WaitForRecoveryToFinish();
+    }
+
+    /**
+     * Blocks until the primary ended the replication and the RecoveryManager applied all of its logs
+     */
+    void WaitForReplicationToEnd() {
+      recovery_manager_->WaitForRecoveryToFinish();
+      replication_ended_ = true;
+    }
+
+    /**
+     * @return ManagedPointer to the component
+     */
+    common::ManagedPointer<storage::ReplicationLogProvider> GetLogProvider() const {
+      return common::ManagedPointer(log_provider_);
+    }
+
+    /**
+     * @return ManagedPointer to the component
+     */
+    common::ManagedPointer<storage::RecoveryManager> GetRecoveryManager() const {
+      return common::ManagedPointer(recovery_manager_);
+    }
+
+   private:
+    // Order matters here for destruction order
+    std::unique_ptr<storage::ReplicationLogProvider> log_provider_;
+    std::unique_ptr<storage::RecoveryManager> recovery_manager_;
+    bool replication_ended_ = false;
   };
 
   /**
-   * Currently doesn't hold any objects. The constructor and destructor are just used to orchestrate the setup and
-   * teardown for TPL.
+   * The constructor and destructor orchestrate the setup and teardown for TPL. Optionally owns the process-wide cache
+   * of JIT-compiled modules.
    */
   class ExecutionLayer {
    public:
-    ExecutionLayer();
+    /**
+     * @param jit_object_cache_directory where to persist JIT-compiled modules, empty to not cache them
+     * @param jit_object_cache_size maximum total size of the cached modules, in bytes
+     */
+    ExecutionLayer(const std::string &jit_object_cache_directory, uint64_t jit_object_cache_size);
     ~ExecutionLayer();
+
+    /**
+     * @return ManagedPointer to the JIT cache, can be nullptr if disabled
+     */
+    common::ManagedPointer<execution::vm::JitObjectCache> GetJitObjectCache() const {
+      return common::ManagedPointer(jit_object_cache_);
+    }
+
+   private:
+    std::unique_ptr<execution::vm::JitObjectCache> jit_object_cache_;
   };
 
   /**
@@ -307,6 +425,10 @@ class DBMain {
             wal_file_path_, wal_num_buffers_, std::chrono::microseconds{wal_serialization_interval_},
             std::chrono::microseconds{wal_persist_interval_}, wal_persist_threshold_,
             common::ManagedPointer(buffer_segment_pool), common::ManagedPointer(thread_registry));
+        if (!replication_replica_address_.empty()) {
+          log_manager->ReplicateTo(replication_replica_address_, replication_replica_port_,
+                                   replication_synchronous_commit_, std::chrono::milliseconds{replication_timeout_});
+        }
         log_manager->Start();
       }
 
@@ -341,7 +463,17 @@ class DBMain {
 
       std::unique_ptr<ExecutionLayer> execution_layer = DISABLED;
       if (use_execution_) {
-        execution_layer = std::make_unique<ExecutionLayer>();
+        execution_layer = std::make_unique<ExecutionLayer>(jit_object_cache_directory_, jit_object_cache_size_);
+      }
+
+      std::unique_ptr<ReplicationLayer> replication_layer = DISABLED;
+      if (replication_listen_port_ != 0) {
+        TERRIER_ASSERT(use_catalog_ && !create_default_database_,
+                       "A replica needs a CatalogLayer without a default database, it receives one from the primary.");
+        TERRIER_ASSERT(use_network_, "A replica receives the logs of the primary through the NetworkLayer.");
+        replication_layer = std::make_unique<ReplicationLayer>(
+            common::ManagedPointer(thread_registry), common::ManagedPointer(txn_layer),
+            common::ManagedPointer(storage_layer), common::ManagedPointer(catalog_layer));
       }
 
       std::unique_ptr<trafficcop::TrafficCop> traffic_cop = DISABLED;
@@ -351,9 +483,11 @@ class DBMain {
         TERRIER_ASSERT(use_stats_storage_ && stats_storage != DISABLED, "TrafficCopLayer needs StatsStorage.");
         TERRIER_ASSERT(use_execution_ && execution_layer != DISABLED, "TrafficCopLayer needs ExecutionLayer.");
         traffic_cop = std::make_unique<trafficcop::TrafficCop>(
-            txn_layer->GetTransactionManager(), catalog_layer->GetCatalog(), DISABLED,
+            txn_layer->GetTransactionManager(), catalog_layer->GetCatalog(),
+            replication_layer != DISABLED ? replication_layer->GetLogProvider() : DISABLED,
             common::ManagedPointer(settings_manager), common::ManagedPointer(stats_storage), optimizer_timeout_,
-            use_query_cache_, execution_mode_);
+            use_query_cache_, execution_mode_, plan_cache_size_, auto_parameterization_, point_query_fast_path_,
+            stats_cost_model_, analyze_sample_blocks_, auto_analyze_threshold_, output_batch_size_);
       }
 
       std::unique_ptr<NetworkLayer> network_layer = DISABLED;
@@ -361,7 +495,11 @@ class DBMain {
         TERRIER_ASSERT(use_traffic_cop_ && traffic_cop != DISABLED, "NetworkLayer needs TrafficCopLayer.");
         network_layer =
             std::make_unique<NetworkLayer>(common::ManagedPointer(thread_registry), common::ManagedPointer(traffic_cop),
-                                           network_port_, connection_thread_count_, uds_file_directory_);
+                                           network_port_, connection_thread_count_, uds_file_directory_,
+                                           execution_thread_count_, network_vectored_writes_,
+                                           network_shared_memory_ring_size_, network_write_queue_limit_,
+                                           network_write_timeout_, network_statement_cache_size_,
+                                           replication_listen_port_);
       }
 
       db_main->settings_manager_ = std::move(settings_manager);
@@ -376,6 +514,7 @@ class DBMain {
       db_main->gc_thread_ = std::move(gc_thread);
       db_main->stats_storage_ = std::move(stats_storage);
       db_main->execution_layer_ = std::move(execution_layer);
+      db_main->replication_layer_ = std::move(replication_layer);
       db_main->traffic_cop_ = std::move(traffic_cop);
       db_main->network_layer_ = std::move(network_layer);
 
@@ -553,6 +692,98 @@ class DBMain {
       return *this;
     }
 
+    /**
+     * @param value whether the connections flush their writes with a single writev
+     * @return self reference for chaining
+     */
+    Builder &SetNetworkVectoredWrites(const bool value) {
+      network_vectored_writes_ = value;
+      return *this;
+    }
+
+    /**
+     * @param value size of the rings of the clients that switch over to shared memory, 0 to disable it
+     * @return self reference for chaining
+     */
+    Builder &SetNetworkSharedMemoryRingSize(const uint32_t value) {
+      network_shared_memory_ring_size_ = value;
+      return *this;
+    }
+
+    /**
+     * @param value number of bytes of results that are queued before a query waits for its client, 0 to queue the
+     * whole result
+     * @return self reference for chaining
+     */
+    Builder &SetNetworkWriteQueueLimit(const uint64_t value) {
+      network_write_queue_limit_ = value;
+      return *this;
+    }
+
+    /**
+     * @param value number of milliseconds a query waits for its client to read the queued results before it fails, 0
+     * to wait indefinitely
+     * @return self reference for chaining
+     */
+    Builder &SetNetworkWriteTimeout(const uint32_t value) {
+      network_write_timeout_ = value;
+      return *this;
+    }
+
+    /**
+     * @param value number of statements that each connection caches once nothing refers to them anymore
+     * @return self reference for chaining
+     */
+    Builder &SetNetworkStatementCacheSize(const uint32_t value) {
+      network_statement_cache_size_ = value;
+      return *this;
+    }
+
+    /**
+     * @param value host name or address of the replica to stream the WAL to, empty to not replicate it
+     * @return self reference for chaining
+     */
+    Builder &SetReplicationReplicaAddress(const std::string &value) {
+      replication_replica_address_ = value;
+      return *this;
+    }
+
+    /**
+     * @param value port on which the replica listens for the WAL
+     * @return self reference for chaining
+     */
+    Builder &SetReplicationReplicaPort(const uint16_t value) {
+      replication_replica_port_ = value;
+      return *this;
+    }
+
+    /**
+     * @param value whether transactions only commit once their logs arrived at the replica
+     * @return self reference for chaining
+     */
+    Builder &SetReplicationSynchronousCommit(const bool value) {
+      replication_synchronous_commit_ = value;
+      return *this;
+    }
+
+    /**
+     * @param value number of milliseconds to wait for the replica before dropping the connection to it
+     * @return self reference for chaining
+     */
+    Builder &SetReplicationTimeout(const uint32_t value) {
+      replication_timeout_ = value;
+      return *this;
+    }
+
+    /**
+     * @param value port on which this replica listens for the WAL of its primary, 0 if this is not a replica
+     * @return self reference for chaining
+     */
+    Builder &SetReplicationListenPort(const uint16_t value) {
+      replication_listen_port_ = value;
+      return *this;
+    }
+
     /**
      * @param value RecordBufferSegmentPool argument
      * @return self reference for chaining
@@ -625,6 +856,87 @@ class DBMain {
       return *this;
     }
 
+    /**
+     * @param value ExecutionLayer argument
+     * @return self reference for chaining
+     */
+    Builder &SetJitObjectCacheDirectory(const std::string &value) {
+      jit_object_cache_directory_ = value;
+      return *this;
+    }
+
+    /**
+     * @param value ExecutionLayer argument
+     * @return self reference for chaining
+     */
+    Builder &SetJitObjectCacheSize(const uint64_t value) {
+      jit_object_cache_size_ = value;
+      return *this;
+    }
+
+    /**
+     * @param value TrafficCop argument
+     * @return self reference for chaining
+     */
+    Builder &SetPlanCacheSize(const uint64_t value) {
+      plan_cache_size_ = value;
+      return *this;
+    }
+
+    /**
+     * @param value TrafficCop argument
+     * @return self reference for chaining
+     */
+    Builder &SetAutoParameterization(const bool value) {
+      auto_parameterization_ = value;
+      return *this;
+    }
+
+    /**
+     * @param value TrafficCop argument
+     * @return self reference for chaining
+     */
+    Builder &SetPointQueryFastPath(const bool value) {
+      point_query_fast_path_ = value;
+      return *this;
+    }
+
+    /**
+     * @param value TrafficCop argument
+     * @return self reference for chaining
+     */
+    Builder &SetStatsCostModel(const bool value) {
+      stats_cost_model_ = value;
+      return *this;
+    }
+
+    /**
+     * @param value TrafficCop argument
+     * @return self reference for chaining
+     */
+    Builder &SetAnalyzeSampleBlocks(const uint32_t value) {
+      analyze_sample_blocks_ = value;
+      return *this;
+    }
+
+    /**
+     * @param value TrafficCop argument
+     * @return self reference for chaining
+     */
+    Builder &SetAutoAnalyzeThreshold(const uint64_t value) {
+      auto_analyze_threshold_ = value;
+      return *this;
+    }
+
+    /**
+     * @param value TrafficCop argument
+     * @return self reference for chaining
+     */
+    Builder &SetOutputBatchSize(const uint32_t value) {
+      output_batch_size_ = value;
+      return *this;
+    }
+
    private:
     std::unordered_map<settings::Param, settings::ParamInfo> param_map_;
 
@@ -642,6 +954,9 @@ class DBMain {
     bool metrics_gc_ = false;
     bool metrics_bind_command_ = false;
     bool metrics_execute_command_ = false;
+    bool metrics_optimizer_ = false;
+    bool metrics_query_trace_ = false;
+    uint32_t metrics_query_trace_sample_interval_ = 9;
     uint64_t record_buffer_segment_size_ = 1e5;
     uint64_t record_buffer_segment_reuse_ = 1e4;
     std::string wal_file_path_ = "wal.log";
@@ -663,10 +978,30 @@ class DBMain {
     uint64_t optimizer_timeout_ = 5000;
     bool use_query_cache_ = true;
     execution::vm::ExecutionMode execution_mode_ = execution::vm::ExecutionMode::Interpret;
+    std::string jit_object_cache_directory_;
+    uint64_t jit_object_cache_size_ = static_cast<uint64_t>(256) << 20;
+    uint64_t plan_cache_size_ = 1024;
+    bool auto_parameterization_ = true;
+    bool point_query_fast_path_ = true;
+    bool stats_cost_model_ = false;
+    uint32_t analyze_sample_blocks_ = 1024;
+    uint64_t auto_analyze_threshold_ = 0;
+    uint32_t output_batch_size_ = common::Constants::OUTPUT_BATCH_SIZE;
     uint16_t network_port_ = 15721;
     std::string uds_file_directory_ = "/tmp/";
     uint16_t connection_thread_count_ = 4;
+    uint16_t execution_thread_count_ = 4;
+    bool network_vectored_writes_ = true;
+    uint32_t network_shared_memory_ring_size_ = 1 << 20;
+    uint64_t network_write_queue_limit_ = 1 << 23;
+    uint32_t network_write_timeout_ = 60000;
+    uint32_t network_statement_cache_size_ = 1024;
     bool use_network_ = false;
+    std::string replication_replica_address_;
+    uint16_t replication_replica_port_ = 15722;
+    bool replication_synchronous_commit_ = true;
+    uint32_t replication_timeout_ = 10000;
+    uint16_t replication_listen_port_ = 0;
 
     /**
      * Instantiates the SettingsManager and reads all of the settings to override the Builder's settings.
@@ -692,8 +1027,18 @@ class DBMain {
         wal_persist_interval_ = settings_manager->GetInt(settings::Param::wal_persist_interval);
         wal_persist_threshold_ =
             static_cast<uint64_t>(settings_manager->GetInt64(settings::Param::wal_persist_threshold));
+        replication_replica_address_ = settings_manager->GetString(settings::Param::replication_replica_address);
+        replication_replica_port_ =
+            static_cast<uint16_t>(settings_manager->GetInt(settings::Param::replication_replica_port));
+        replication_synchronous_commit_ = settings_manager->GetBool(settings::Param::replication_synchronous_commit);
+        replication_timeout_ = static_cast<uint32_t>(settings_manager->GetInt(settings::Param::replication_timeout));
       }
 
+      replication_listen_port_ =
+          static_cast<uint16_t>(settings_manager->GetInt(settings::Param::replication_listen_port));
+      // A replica receives the whole catalog from its primary
+      if (replication_listen_port_ != 0) create_default_database_ = false;
+
       use_metrics_ = use_metrics_thread_ = settings_manager->GetBool(settings::Param::metrics);
 
       gc_interval_ = settings_manager->GetInt(settings::Param::gc_interval);
@@ -702,12 +1047,37 @@ class DBMain {
       network_port_ = static_cast<uint16_t>(settings_manager->GetInt(settings::Param::port));
       connection_thread_count_ =
           static_cast<uint16_t>(settings_manager->GetInt(settings::Param::connection_thread_count));
+      execution_thread_count_ =
+          static_cast<uint16_t>(settings_manager->GetInt(settings::Param::execution_thread_count));
+      network_vectored_writes_ = settings_manager->GetBool(settings::Param::network_vectored_writes);
+      network_shared_memory_ring_size_ =
+          static_cast<uint32_t>(settings_manager->GetInt(settings::Param::network_shared_memory_ring_size));
+      network_write_queue_limit_ =
+          static_cast<uint64_t>(settings_manager->GetInt64(settings::Param::network_write_queue_limit));
+      network_write_timeout_ = static_cast<uint32_t>(settings_manager->GetInt(settings::Param::network_write_timeout));
+      network_statement_cache_size_ =
+          static_cast<uint32_t>(settings_manager->GetInt(settings::Param::network_statement_cache_size));
       optimizer_timeout_ = static_cast<uint64_t>(settings_manager->GetInt(settings::Param::task_execution_timeout));
       use_query_cache_ = settings_manager->GetBool(settings::Param::use_query_cache);
 
-      execution_mode_ = settings_manager->GetBool(settings::Param::compiled_query_execution)
-                            ? execution::vm::ExecutionMode::Compiled
-                            : execution::vm::ExecutionMode::Interpret;
+      if (settings_manager->GetBool(settings::Param::compiled_query_execution)) {
+        execution_mode_ = execution::vm::ExecutionMode::Compiled;
+      } else if (settings_manager->GetBool(settings::Param::tiered_query_execution)) {
+        execution_mode_ = execution::vm::ExecutionMode::Adaptive;
+      } else {
+        execution_mode_ = execution::vm::ExecutionMode::Interpret;
+      }
+      jit_object_cache_directory_ = settings_manager->GetString(settings::Param::jit_object_cache_directory);
+      jit_object_cache_size_ = static_cast<uint64_t>(settings_manager->GetInt(settings::Param::jit_object_cache_size))
+                               << 20;
+      plan_cache_size_ = static_cast<uint64_t>(settings_manager->GetInt(settings::Param::plan_cache_size));
+      auto_parameterization_ = settings_manager->GetBool(settings::Param::auto_parameterization);
+      point_query_fast_path_ = settings_manager->GetBool(settings::Param::point_query_fast_path);
+      stats_cost_model_ = settings_manager->GetBool(settings::Param::stats_cost_model);
+      analyze_sample_blocks_ = static_cast<uint32_t>(settings_manager->GetInt(settings::Param::analyze_sample_blocks));
+      auto_analyze_threshold_ =
+          static_cast<uint64_t>(settings_manager->GetInt64(settings::Param::auto_analyze_threshold));
+      output_batch_size_ = static_cast<uint32_t>(settings_manager->GetInt(settings::Param::output_batch_size));
 
       metrics_pipeline_ = settings_manager->GetBool(settings::Param::metrics_pipeline);
       metrics_transaction_ = settings_manager->GetBool(settings::Param::metrics_transaction);
@@ -715,6 +1085,10 @@ class DBMain {
       metrics_gc_ = settings_manager->GetBool(settings::Param::metrics_gc);
       metrics_bind_command_ = settings_manager->GetBool(settings::Param::metrics_bind_command);
       metrics_execute_command_ = settings_manager->GetBool(settings::Param::metrics_execute_command);
+      metrics_optimizer_ = settings_manager->GetBool(settings::Param::metrics_optimizer);
+      metrics_query_trace_ = settings_manager->GetBool(settings::Param::metrics_query_trace);
+      metrics_query_trace_sample_interval_ =
+          static_cast<uint32_t>(settings_manager->GetInt(settings::Param::metrics_query_trace_sample_interval));
 
       return settings_manager;
     }
@@ -731,6 +1105,10 @@ class DBMain {
       if (metrics_gc_) metrics_manager->EnableMetric(metrics::MetricsComponent::GARBAGECOLLECTION, 0);
       if (metrics_bind_command_) metrics_manager->EnableMetric(metrics::MetricsComponent::BIND_COMMAND, 0);
       if (metrics_execute_command_) metrics_manager->EnableMetric(metrics::MetricsComponent::EXECUTE_COMMAND, 0);
+      if (metrics_optimizer_) metrics_manager->EnableMetric(metrics::MetricsComponent::OPTIMIZER, 0);
+      if (metrics_query_trace_) {
+        metrics_manager->EnableMetric(metrics::MetricsComponent::QUERY_TRACE, metrics_query_trace_sample_interval_);
+      }
 
       return metrics_manager;
     }
@@ -798,6 +1176,13 @@ class DBMain {
     return common::ManagedPointer(gc_thread_);
   }
 
+  /**
+   * @return ManagedPointer to the component, can be nullptr if not a replica
+   */
+  common::ManagedPointer<ReplicationLayer> GetReplicationLayer() const {
+    return common::ManagedPointer(replication_layer_);
+  }
+
   /**
    * @return ManagedPointer to the component, can be nullptr if disabled
    */
@@ -835,6 +1220,7 @@ class DBMain {
       gc_thread_;  // thread needs to die before manual invocations of GC in CatalogLayer and others
   std::unique_ptr<optimizer::StatsStorage> stats_storage_;
   std::unique_ptr<ExecutionLayer> execution_layer_;
+  std::unique_ptr<ReplicationLayer> replication_layer_;
   std::unique_ptr<trafficcop::TrafficCop> traffic_cop_;
   std::unique_ptr<NetworkLayer> network_layer_;
 };
@@ -51,6 +51,7 @@ class BindCommandMetricRawData : public AbstractRawData {
     for (auto &data : bind_command_data_) {
       outfile << (data.param_num_) << ", ";
       outfile << (data.query_text_size_) << ", ";
+      outfile << (data.num_allocations_) << ", ";
 
       data.resource_metrics_.ToCSV(outfile);
       outfile << std::endl;
@@ -66,24 +67,28 @@ class BindCommandMetricRawData : public AbstractRawData {
   /**
    * Columns to use for writing to CSV.
    */
-  static constexpr std::array<std::string_view, 2> FEATURE_COLUMNS = {"param_num, query_text_size"};
+  static constexpr std::array<std::string_view, 2> FEATURE_COLUMNS = {"param_num, query_text_size, num_allocations"};
 
  private:
   friend class BindCommandMetric;
   struct BindCommandData;
 
-  void RecordBindCommandData(uint64_t param_num, uint64_t query_text_size,
+  void RecordBindCommandData(uint64_t param_num, uint64_t query_text_size, uint64_t num_allocations,
                              const common::ResourceTracker::Metrics &resource_metrics) {
-    bind_command_data_.emplace_front(param_num, query_text_size, resource_metrics);
+    bind_command_data_.emplace_front(param_num, query_text_size, num_allocations, resource_metrics);
   }
 
   struct BindCommandData {
-    BindCommandData(uint64_t param_num, uint64_t query_text_size,
+    BindCommandData(uint64_t param_num, uint64_t query_text_size, uint64_t num_allocations,
                     const common::ResourceTracker::Metrics &resource_metrics)
-        : param_num_(param_num), query_text_size_(query_text_size), resource_metrics_(resource_metrics) {}
+        : param_num_(param_num),
+          query_text_size_(query_text_size),
+          num_allocations_(num_allocations),
+          resource_metrics_(resource_metrics) {}
 
     const uint64_t param_num_;
     const uint64_t query_text_size_;
+    const uint64_t num_allocations_;
     const common::ResourceTracker::Metrics resource_metrics_;
   };
 
@@ -97,9 +102,9 @@ class BindCommandMetric : public AbstractMetric<BindCommandMetricRawData> {
  private:
   friend class MetricsStore;
 
-  void RecordBindCommandData(uint64_t param_num, uint64_t query_text_size,
+  void RecordBindCommandData(uint64_t param_num, uint64_t query_text_size, uint64_t num_allocations,
                              const common::ResourceTracker::Metrics &resource_metrics) {
-    GetRawData()->RecordBindCommandData(param_num, query_text_size, resource_metrics);
+    GetRawData()->RecordBindCommandData(param_num, query_text_size, num_allocations, resource_metrics);
   }
 };
 }  // namespace terrier::metrics
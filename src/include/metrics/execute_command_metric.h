@@ -50,6 +50,7 @@ class ExecuteCommandMetricRawData : public AbstractRawData {
 
     for (auto &data : execute_command_data_) {
       outfile << (data.portal_name_size_) << ", ";
+      outfile << (data.num_allocations_) << ", ";
 
       data.resource_metrics_.ToCSV(outfile);
       outfile << std::endl;
@@ -65,21 +66,24 @@ class ExecuteCommandMetricRawData : public AbstractRawData {
   /**
    * Columns to use for writing to CSV.
    */
-  static constexpr std::array<std::string_view, 1> FEATURE_COLUMNS = {"protal_name_size"};
+  static constexpr std::array<std::string_view, 1> FEATURE_COLUMNS = {"protal_name_size, num_allocations"};
 
  private:
   friend class ExecuteCommandMetric;
   struct ExecuteCommandData;
 
-  void RecordExecuteCommandData(uint64_t portal_name_size, const common::ResourceTracker::Metrics &resource_metrics) {
-    execute_command_data_.emplace_front(portal_name_size, resource_metrics);
+  void RecordExecuteCommandData(uint64_t portal_name_size, uint64_t num_allocations,
+                                const common::ResourceTracker::Metrics &resource_metrics) {
+    execute_command_data_.emplace_front(portal_name_size, num_allocations, resource_metrics);
   }
 
   struct ExecuteCommandData {
-    ExecuteCommandData(uint64_t portal_name_size, const common::ResourceTracker::Metrics &resource_metrics)
-        : portal_name_size_(portal_name_size), resource_metrics_(resource_metrics) {}
+    ExecuteCommandData(uint64_t portal_name_size, uint64_t num_allocations,
+                       const common::ResourceTracker::Metrics &resource_metrics)
+        : portal_name_size_(portal_name_size), num_allocations_(num_allocations), resource_metrics_(resource_metrics) {}
 
     const uint64_t portal_name_size_;
+    const uint64_t num_allocations_;
     const common::ResourceTracker::Metrics resource_metrics_;
   };
 
@@ -93,8 +97,9 @@ class ExecuteCommandMetric : public AbstractMetric<ExecuteCommandMetricRawData>
  private:
   friend class MetricsStore;
 
-  void RecordExecuteCommandData(uint64_t portal_name_size, const common::ResourceTracker::Metrics &resource_metrics) {
-    GetRawData()->RecordExecuteCommandData(portal_name_size, resource_metrics);
+  void RecordExecuteCommandData(uint64_t portal_name_size, uint64_t num_allocations,
+                                const common::ResourceTracker::Metrics &resource_metrics) {
+    GetRawData()->RecordExecuteCommandData(portal_name_size, num_allocations, resource_metrics);
   }
 };
 }  // namespace terrier::metrics
@@ -13,8 +13,10 @@ enum class MetricsComponent : uint8_t {
   EXECUTION_PIPELINE,
   BIND_COMMAND,
   EXECUTE_COMMAND,
+  OPTIMIZER,
+  QUERY_TRACE,
 };
 
-constexpr uint8_t NUM_COMPONENTS = 7;
+constexpr uint8_t NUM_COMPONENTS = 9;
 
 }  // namespace terrier::metrics
@@ -18,7 +18,9 @@
 #include "metrics/garbage_collection_metric.h"
 #include "metrics/logging_metric.h"
 #include "metrics/metrics_defs.h"
+#include "metrics/optimizer_metric.h"
 #include "metrics/pipeline_metric.h"
+#include "metrics/query_trace_metric.h"
 #include "metrics/transaction_metric.h"
 
 namespace terrier::metrics {
@@ -150,29 +152,82 @@ class MetricsStore {
     pipeline_metric_->RecordPipelineData(query_id, pipeline_id, execution_mode, std::move(features), resource_metrics);
   }
 
+  /**
+   * Record the outcome of compiling a tiered query in the background
+   * @param query_id id of the query
+   * @param interpreted_runs the number of interpreted executions before compiled code was used
+   * @param interpreted_avg_us the average time of an interpreted execution (microseconds)
+   * @param compiled_us the time of the first compiled execution (microseconds)
+   * @param compile_metrics Metrics of the compilation
+   */
+  void RecordPipelineJitData(execution::query_id_t query_id, uint64_t interpreted_runs, uint64_t interpreted_avg_us,
+                             uint64_t compiled_us, const common::ResourceTracker::Metrics &compile_metrics) {
+    if (!ComponentEnabled(MetricsComponent::EXECUTION_PIPELINE))
+      METRICS_LOG_WARN("RecordPipelineJitData() called without pipepline metrics enabled.");
+    TERRIER_ASSERT(pipeline_metric_ != nullptr, "PipelineMetric not allocated. Check MetricsStore constructor.");
+    pipeline_metric_->RecordPipelineJitData(query_id, interpreted_runs, interpreted_avg_us, compiled_us,
+                                            compile_metrics);
+  }
+
   /**
    * Record metrics for the bind command
    * @param param_num the number of bind parameters
    * @param query_text_size the size of the query text
+   * @param num_allocations the number of portals and vectors allocated to bind the portal
    * @param resource_metrics Metrics
    */
-  void RecordBindCommandData(uint64_t param_num, uint64_t query_text_size,
+  void RecordBindCommandData(uint64_t param_num, uint64_t query_text_size, uint64_t num_allocations,
                              const common::ResourceTracker::Metrics &resource_metrics) {
     TERRIER_ASSERT(ComponentEnabled(MetricsComponent::BIND_COMMAND), "BindCommandMetric not enabled.");
     TERRIER_ASSERT(bind_command_metric_ != nullptr, "BindCommandMetric not allocated. Check MetricsStore constructor.");
-    bind_command_metric_->RecordBindCommandData(param_num, query_text_size, resource_metrics);
+    bind_command_metric_->RecordBindCommandData(param_num, query_text_size, num_allocations, resource_metrics);
   }
 
   /**
    * Record metrics for the execute command
    * @param portal_name_size the size of the portal name
+   * @param num_allocations the number of execution contexts allocated to execute the portal
    * @param resource_metrics Metrics
    */
-  void RecordExecuteCommandData(uint64_t portal_name_size, const common::ResourceTracker::Metrics &resource_metrics) {
+  void RecordExecuteCommandData(uint64_t portal_name_size, uint64_t num_allocations,
+                                const common::ResourceTracker::Metrics &resource_metrics) {
     TERRIER_ASSERT(ComponentEnabled(MetricsComponent::EXECUTE_COMMAND), "ExecuteCommandMetric not enabled.");
     TERRIER_ASSERT(execute_command_metric_ != nullptr,
                    "ExecuteCommandMetric not allocated. Check MetricsStore constructor.");
-    execute_command_metric_->RecordExecuteCommandData(portal_name_size, resource_metrics);
+    execute_command_metric_->RecordExecuteCommandData(portal_name_size, num_allocations, resource_metrics);
+  }
+
+  /**
+   * Record metrics for building a query plan
+   * @param num_groups the number of groups in the memo
+   * @param num_group_expressions the number of group expressions explored
+   * @param num_join_relations the number of relations in the largest inner join whose order was enumerated
+   * @param greedy_join_order whether a join order was chosen greedily, because there were too many relations
+   * @param timed_out whether the search was cut short by the optimizer timeout
+   * @param resource_metrics Metrics
+   */
+  void RecordOptimizeData(uint64_t num_groups, uint64_t num_group_expressions, uint64_t num_join_relations,
+                          bool greedy_join_order, bool timed_out,
+                          const common::ResourceTracker::Metrics &resource_metrics) {
+    TERRIER_ASSERT(ComponentEnabled(MetricsComponent::OPTIMIZER), "OptimizerMetric not enabled.");
+    TERRIER_ASSERT(optimizer_metric_ != nullptr, "OptimizerMetric not allocated. Check MetricsStore constructor.");
+    optimizer_metric_->RecordOptimizeData(num_groups, num_group_expressions, num_join_relations, greedy_join_order,
+                                          timed_out, resource_metrics);
+  }
+
+  /**
+   * Record a span of a traced request
+   * @param span the step of the request
+   * @param connection_id the connection of the request
+   * @param query_id the id that links the spans of the request, 0 for spans that are not part of one request
+   * @param start_us start of the span (microseconds)
+   * @param end_us end of the span (microseconds)
+   * @param detail id of the pipeline of an EXECUTE_PIPELINE span
+   */
+  void RecordQueryTraceData(TraceSpan span, uint32_t connection_id, uint64_t query_id, uint64_t start_us,
+                            uint64_t end_us, uint64_t detail) {
+    TERRIER_ASSERT(query_trace_metric_ != nullptr, "QueryTraceMetric not allocated. Check MetricsStore constructor.");
+    query_trace_metric_->RecordQueryTraceData(span, connection_id, query_id, start_us, end_us, detail);
   }
 
   /**
@@ -221,6 +276,8 @@ class MetricsStore {
   std::unique_ptr<PipelineMetric> pipeline_metric_;
   std::unique_ptr<BindCommandMetric> bind_command_metric_;
   std::unique_ptr<ExecuteCommandMetric> execute_command_metric_;
+  std::unique_ptr<OptimizerMetric> optimizer_metric_;
+  std::unique_ptr<QueryTraceMetric> query_trace_metric_;
 
   const std::bitset<NUM_COMPONENTS> &enabled_metrics_;
   const std::array<uint32_t, NUM_COMPONENTS> &sample_interval_;
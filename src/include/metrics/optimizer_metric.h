@@ -0,0 +1,115 @@
+#pragma once
+
+#include <algorithm>
+#include <fstream>
+#include <list>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/resource_tracker.h"
+#include "metrics/abstract_metric.h"
+#include "metrics/metrics_util.h"
+
+namespace terrier::metrics {
+
+/**
+ * Raw data object for holding stats collected for building query plans
+ */
+class OptimizerMetricRawData : public AbstractRawData {
+ public:
+  void Aggregate(AbstractRawData *const other) override {
+    auto other_db_metric = dynamic_cast<OptimizerMetricRawData *>(other);
+    if (!other_db_metric->optimize_data_.empty()) {
+      optimize_data_.splice(optimize_data_.cend(), other_db_metric->optimize_data_);
+    }
+  }
+
+  /**
+   * @return the type of the metric this object is holding the data for
+   */
+  MetricsComponent GetMetricType() const override { return MetricsComponent::OPTIMIZER; }
+
+  /**
+   * Writes the data out to ofstreams
+   * @param outfiles vector of ofstreams to write to that have been opened by the MetricsManager
+   */
+  void ToCSV(std::vector<std::ofstream> *const outfiles) final {
+    TERRIER_ASSERT(outfiles->size() == FILES.size(), "Number of files passed to metric is wrong.");
+    TERRIER_ASSERT(std::count_if(outfiles->cbegin(), outfiles->cend(),
+                                 [](const std::ofstream &outfile) { return !outfile.is_open(); }) == 0,
+                   "Not all files are open.");
+
+    auto &outfile = (*outfiles)[0];
+
+    for (auto &data : optimize_data_) {
+      outfile << data.num_groups_ << ", ";
+      outfile << data.num_group_expressions_ << ", ";
+      outfile << data.num_join_relations_ << ", ";
+      outfile << data.greedy_join_order_ << ", ";
+      outfile << data.timed_out_ << ", ";
+
+      data.resource_metrics_.ToCSV(outfile);
+      outfile << std::endl;
+    }
+    optimize_data_.clear();
+  }
+
+  /**
+   * Files to use for writing to CSV.
+   */
+  static constexpr std::array<std::string_view, 1> FILES = {"./optimizer.csv"};
+
+  /**
+   * Columns to use for writing to CSV.
+   */
+  static constexpr std::array<std::string_view, 1> FEATURE_COLUMNS = {
+      "num_groups, num_group_expressions, num_join_relations, greedy_join_order, timed_out"};
+
+ private:
+  friend class OptimizerMetric;
+  struct OptimizeData;
+
+  void RecordOptimizeData(uint64_t num_groups, uint64_t num_group_expressions, uint64_t num_join_relations,
+                          bool greedy_join_order, bool timed_out,
+                          const common::ResourceTracker::Metrics &resource_metrics) {
+    optimize_data_.emplace_front(num_groups, num_group_expressions, num_join_relations, greedy_join_order, timed_out,
+                                 resource_metrics);
+  }
+
+  struct OptimizeData {
+    OptimizeData(uint64_t num_groups, uint64_t num_group_expressions, uint64_t num_join_relations,
+                 bool greedy_join_order, bool timed_out, const common::ResourceTracker::Metrics &resource_metrics)
+        : num_groups_(num_groups),
+          num_group_expressions_(num_group_expressions),
+          num_join_relations_(num_join_relations),
+          greedy_join_order_(greedy_join_order),
+          timed_out_(timed_out),
+          resource_metrics_(resource_metrics) {}
+
+    const uint64_t num_groups_;
+    const uint64_t num_group_expressions_;
+    const uint64_t num_join_relations_;
+    const bool greedy_join_order_;
+    const bool timed_out_;
+    const common::ResourceTracker::Metrics resource_metrics_;
+  };
+
+  std::list<OptimizeData> optimize_data_;
+};
+
+/**
+ * Metrics for the optimizer, collected for every plan it builds
+ */
+class OptimizerMetric : public AbstractMetric<OptimizerMetricRawData> {
+ private:
+  friend class MetricsStore;
+
+  void RecordOptimizeData(uint64_t num_groups, uint64_t num_group_expressions, uint64_t num_join_relations,
+                          bool greedy_join_order, bool timed_out,
+                          const common::ResourceTracker::Metrics &resource_metrics) {
+    GetRawData()->RecordOptimizeData(num_groups, num_group_expressions, num_join_relations, greedy_join_order,
+                                     timed_out, resource_metrics);
+  }
+};
+}  // namespace terrier::metrics
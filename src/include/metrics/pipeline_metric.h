@@ -29,6 +29,9 @@ class PipelineMetricRawData : public AbstractRawData {
     if (!other_db_metric->pipeline_data_.empty()) {
       pipeline_data_.splice(pipeline_data_.cend(), other_db_metric->pipeline_data_);
     }
+    if (!other_db_metric->jit_data_.empty()) {
+      jit_data_.splice(jit_data_.cend(), other_db_metric->jit_data_);
+    }
   }
 
   /**
@@ -65,20 +68,31 @@ class PipelineMetricRawData : public AbstractRawData {
       outfile << std::endl;
     }
     pipeline_data_.clear();
+
+    auto &jit_outfile = (*outfiles)[1];
+    for (const auto &data : jit_data_) {
+      jit_outfile << data.query_id_.UnderlyingValue() << ", " << data.interpreted_runs_ << ", "
+                  << data.interpreted_avg_us_ << ", " << data.compiled_us_ << ", " << data.GetSpeedup() << ", ";
+      data.resource_metrics_.ToCSV(jit_outfile);
+      jit_outfile << std::endl;
+    }
+    jit_data_.clear();
   }
 
   /**
    * Files to use for writing to CSV.
    */
-  static constexpr std::array<std::string_view, 1> FILES = {"./pipeline.csv"};
+  static constexpr std::array<std::string_view, 2> FILES = {"./pipeline.csv", "./pipeline_jit.csv"};
 
   /**
    * Columns to use for writing to CSV.
-   * Note: This includes the columns for the input feature, but not the output (resource counters)
+   * Note: This includes the columns for the input feature, but not the output (resource counters). The resource
+   * counters of pipeline_jit.csv are those of the background compilation.
    */
-  static constexpr std::array<std::string_view, 1> FEATURE_COLUMNS = {
+  static constexpr std::array<std::string_view, 2> FEATURE_COLUMNS = {
       "query_id, pipeline_id, exec_mode, num_features, features, est_output_rows, key_sizes, num_keys, "
-      "est_cardinalities, mem_factor, num_loops"};
+      "est_cardinalities, mem_factor, num_loops",
+      "query_id, interpreted_runs, interpreted_avg_us, compiled_us, speedup"};
 
  private:
   friend class PipelineMetric;
@@ -90,6 +104,33 @@ class PipelineMetricRawData : public AbstractRawData {
     pipeline_data_.emplace_back(query_id, pipeline_id, execution_mode, std::move(features), resource_metrics);
   }
 
+  void RecordPipelineJitData(execution::query_id_t query_id, uint64_t interpreted_runs, uint64_t interpreted_avg_us,
+                             uint64_t compiled_us, const common::ResourceTracker::Metrics &compile_metrics) {
+    jit_data_.emplace_back(query_id, interpreted_runs, interpreted_avg_us, compiled_us, compile_metrics);
+  }
+
+  // The outcome of tiering a query up from the interpreter to compiled code.
+  struct JitData {
+    JitData(execution::query_id_t query_id, uint64_t interpreted_runs, uint64_t interpreted_avg_us,
+            uint64_t compiled_us, const common::ResourceTracker::Metrics &resource_metrics)
+        : query_id_(query_id),
+          interpreted_runs_(interpreted_runs),
+          interpreted_avg_us_(interpreted_avg_us),
+          compiled_us_(compiled_us),
+          resource_metrics_(resource_metrics) {}
+
+    // The average interpreted time over the first compiled time.
+    double GetSpeedup() const {
+      return compiled_us_ == 0 ? 0.0 : static_cast<double>(interpreted_avg_us_) / static_cast<double>(compiled_us_);
+    }
+
+    const execution::query_id_t query_id_;
+    const uint64_t interpreted_runs_;
+    const uint64_t interpreted_avg_us_;
+    const uint64_t compiled_us_;
+    const common::ResourceTracker::Metrics resource_metrics_;
+  };
+
   struct PipelineData {
     PipelineData(execution::query_id_t query_id, execution::pipeline_id_t pipeline_id, uint8_t execution_mode,
                  std::vector<brain::ExecutionOperatingUnitFeature> &&features,
@@ -177,6 +218,7 @@ class PipelineMetricRawData : public AbstractRawData {
   };
 
   std::list<PipelineData> pipeline_data_;
+  std::list<JitData> jit_data_;
 };
 
 /**
@@ -191,5 +233,10 @@ class PipelineMetric : public AbstractMetric<PipelineMetricRawData> {
                           const common::ResourceTracker::Metrics &resource_metrics) {
     GetRawData()->RecordPipelineData(query_id, pipeline_id, execution_mode, std::move(features), resource_metrics);
   }
+
+  void RecordPipelineJitData(execution::query_id_t query_id, uint64_t interpreted_runs, uint64_t interpreted_avg_us,
+                             uint64_t compiled_us, const common::ResourceTracker::Metrics &compile_metrics) {
+    GetRawData()->RecordPipelineJitData(query_id, interpreted_runs, interpreted_avg_us, compiled_us, compile_metrics);
+  }
 };
 }  // namespace terrier::metrics
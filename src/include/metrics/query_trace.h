@@ -0,0 +1,72 @@
+#pragma once
+
+#include "common/macros.h"
+#include "metrics/metrics_util.h"
+#include "metrics/query_trace_metric.h"
+
+namespace terrier::metrics {
+
+/**
+ * Records the spans of the traced requests into the MetricsStore of the calling thread. A request is sampled when it is
+ * read, and the id of its trace is handed along with the request to the threads that work on it. The spans are only
+ * recorded if the thread is registered with the MetricsManager.
+ */
+struct QueryTrace {
+  QueryTrace() = delete;
+
+  /**
+   * @return true if the thread records spans
+   */
+  static bool Enabled();
+
+  /**
+   * @return true if the next request should be traced according to the sample interval
+   */
+  static bool Sample();
+
+  /**
+   * Record a span that ends now
+   * @param span the step of the request
+   * @param connection_id the connection of the request
+   * @param query_id the id of the trace of the request, 0 for spans that are not part of one request
+   * @param start_us start of the span (microseconds)
+   * @param detail id of the pipeline of an EXECUTE_PIPELINE span
+   */
+  static void Record(TraceSpan span, uint32_t connection_id, uint64_t query_id, uint64_t start_us,
+                     uint64_t detail = 0);
+};
+
+/**
+ * Records a span of a traced request from its construction to its destruction. Nothing is recorded, and the clock is
+ * not read, if the request is not traced.
+ */
+class ScopedQueryTraceSpan {
+ public:
+  /**
+   * @param span the step of the request
+   * @param connection_id the connection of the request
+   * @param query_id the id of the trace of the request, 0 if it's not traced
+   */
+  ScopedQueryTraceSpan(const TraceSpan span, const uint32_t connection_id, const uint64_t query_id)
+      : span_(span),
+        connection_id_(connection_id),
+        query_id_(query_id),
+        start_us_(query_id == 0 ? 0 : MetricsUtil::Now()) {}
+
+  /**
+   * Records the span
+   */
+  ~ScopedQueryTraceSpan() {
+    if (query_id_ != 0) QueryTrace::Record(span_, connection_id_, query_id_, start_us_);
+  }
+
+  DISALLOW_COPY_AND_MOVE(ScopedQueryTraceSpan)
+
+ private:
+  const TraceSpan span_;
+  const uint32_t connection_id_;
+  const uint64_t query_id_;
+  const uint64_t start_us_;
+};
+
+}  // namespace terrier::metrics
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <string_view>
+#include <vector>
+
+#include "common/macros.h"
+#include "metrics/abstract_metric.h"
+
+namespace terrier::metrics {
+
+/**
+ * The steps of a request whose time is traced
+ */
+enum class TraceSpan : uint8_t {
+  NETWORK_READ,
+  PARSE,
+  BIND,
+  OPTIMIZE,
+  COMPILE,
+  EXECUTE,
+  EXECUTE_PIPELINE,
+  COMMIT,
+  WAL_WAIT,
+  RESULT_FLUSH,
+  WAL_SERIALIZE,
+  WAL_FSYNC,
+};
+
+/**
+ * Raw data object for holding the spans of the traced requests. The spans of a thread are kept in a ring buffer, so
+ * the oldest spans of a thread are overwritten if it records more of them than the ring holds until the next
+ * aggregation.
+ */
+class QueryTraceMetricRawData : public AbstractRawData {
+ public:
+  void Aggregate(AbstractRawData *const other) override {
+    auto other_db_metric = dynamic_cast<QueryTraceMetricRawData *>(other);
+    // The events are sorted by their timestamps by the trace viewer, so the order of the ring doesn't matter
+    trace_data_.insert(trace_data_.end(), other_db_metric->trace_data_.cbegin(), other_db_metric->trace_data_.cend());
+    num_overwritten_ += other_db_metric->num_overwritten_;
+    other_db_metric->trace_data_.clear();
+  }
+
+  /**
+   * @return the type of the metric this object is holding the data for
+   */
+  MetricsComponent GetMetricType() const override { return MetricsComponent::QUERY_TRACE; }
+
+  /**
+   * Writes the spans out as events in Chrome's trace format (chrome://tracing or Perfetto). Spans of a request are
+   * shown on the track of its connection, spans of the log threads on a track of their own.
+   * @param outfiles vector of ofstreams to write to that have been opened by the MetricsManager
+   */
+  void ToCSV(std::vector<std::ofstream> *const outfiles) final {
+    TERRIER_ASSERT(outfiles->size() == FILES.size(), "Number of files passed to metric is wrong.");
+    TERRIER_ASSERT(std::count_if(outfiles->cbegin(), outfiles->cend(),
+                                 [](const std::ofstream &outfile) { return !outfile.is_open(); }) == 0,
+                   "Not all files are open.");
+
+    auto &outfile = (*outfiles)[0];
+
+    for (const auto &data : trace_data_) {
+      const bool request_span = data.query_id_ != 0;
+      outfile << R"({"name":")" << SPAN_NAMES[static_cast<uint8_t>(data.span_)] << R"(","cat":"query","ph":"X",)";
+      outfile << R"("ts":)" << data.start_us_ << R"(,"dur":)" << data.duration_us_ << ",";
+      outfile << R"("pid":)" << (request_span ? 1 : 2) << R"(,"tid":)";
+      outfile << (request_span ? data.connection_id_ : static_cast<uint32_t>(data.span_));
+      outfile << R"(,"args":{"query_id":)" << data.query_id_;
+      if (data.span_ == TraceSpan::EXECUTE_PIPELINE) outfile << R"(,"pipeline_id":)" << data.detail_;
+      outfile << "}}," << std::endl;
+    }
+    trace_data_.clear();
+    num_overwritten_ = 0;
+  }
+
+  /**
+   * Files to use for writing the trace. The array of events is left open, which the trace viewers accept, so that
+   * the events of every dump can be appended.
+   */
+  static constexpr std::array<std::string_view, 1> FILES = {"./query_trace.json"};
+
+  /**
+   * Names of the spans in the trace
+   */
+  static constexpr std::array<std::string_view, 12> SPAN_NAMES = {
+      "network_read", "parse",  "bind",     "optimize",     "compile",       "execute",
+      "pipeline",     "commit", "wal_wait", "result_flush", "wal_serialize", "wal_fsync"};
+
+  /**
+   * Maximum number of spans a thread keeps between two aggregations
+   */
+  static constexpr uint32_t RING_CAPACITY = 1 << 14;
+
+ private:
+  friend class QueryTraceMetric;
+  FRIEND_TEST(MetricsTests, QueryTraceTest);
+  struct QueryTraceData;
+
+  void RecordQueryTraceData(TraceSpan span, uint32_t connection_id, uint64_t query_id, uint64_t start_us,
+                            uint64_t end_us, uint64_t detail) {
+    const QueryTraceData data{span, connection_id, query_id, start_us, end_us - std::min(start_us, end_us), detail};
+    if (trace_data_.size() < RING_CAPACITY) {
+      trace_data_.push_back(data);
+    } else {
+      trace_data_[num_overwritten_++ % RING_CAPACITY] = data;
+    }
+  }
+
+  struct QueryTraceData {
+    TraceSpan span_;
+    uint32_t connection_id_;
+    // 0 for the spans that are not part of a request
+    uint64_t query_id_;
+    uint64_t start_us_;
+    uint64_t duration_us_;
+    uint64_t detail_;
+  };
+
+  std::vector<QueryTraceData> trace_data_;
+  uint64_t num_overwritten_ = 0;
+};
+
+/**
+ * Spans of the requests that are sampled for tracing, from the read of the request to the flush of its results
+ */
+class QueryTraceMetric : public AbstractMetric<QueryTraceMetricRawData> {
+ private:
+  friend class MetricsStore;
+
+  void RecordQueryTraceData(TraceSpan span, uint32_t connection_id, uint64_t query_id, uint64_t start_us,
+                            uint64_t end_us, uint64_t detail) {
+    GetRawData()->RecordQueryTraceData(span, connection_id, query_id, start_us, end_us, detail);
+  }
+};
+}  // namespace terrier::metrics
@@ -1,16 +1,23 @@
 #pragma once
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "catalog/catalog_accessor.h"
 #include "catalog/catalog_cache.h"
 #include "catalog/catalog_defs.h"
 #include "network/network_defs.h"
+#include "network/network_io_wrapper.h"
 #include "transaction/transaction_context.h"
 
+namespace terrier::trafficcop {
+class ResultCursor;
+}  // namespace terrier::trafficcop
+
 namespace terrier::network {
 
 /**
@@ -33,9 +40,14 @@ class ConnectionContext {
     db_name_.clear();
     temp_namespace_oid_ = catalog::INVALID_NAMESPACE_OID;
     txn_ = nullptr;
+    txn_changed_catalog_ = false;
     accessor_ = nullptr;
     callback_ = nullptr;
     callback_arg_ = nullptr;
+    io_wrapper_ = nullptr;
+    cursors_.clear();
+    query_trace_id_ = 0;
+    read_start_us_ = 0;
     catalog_cache_.Reset(transaction::INITIAL_TXN_TIMESTAMP);
   }
 
@@ -56,7 +68,7 @@ class ConnectionContext {
   catalog::db_oid_t GetDatabaseOid() const { return db_oid_; }
 
   /**
-   * @return temporary namespace OID that was generated at connection, or INVALID_NAMESPACE_OID in the event of failure
+   * @return temporary namespace OID of the connection, or INVALID_NAMESPACE_OID if it was not created yet
    */
   catalog::namespace_oid_t GetTempNamespaceOid() const { return temp_namespace_oid_; }
 
@@ -67,8 +79,8 @@ class ConnectionContext {
   void SetDatabaseOid(const catalog::db_oid_t db_oid) { db_oid_ = db_oid; }
 
   /**
-   * @param ns_oid temporary namespace OID that was generated at connection
-   * @warning only to be used by the protocol interpreter during startup
+   * @param ns_oid temporary namespace OID that was created on first use
+   * @warning only to be used by the traffic cop when it creates the temporary namespace
    */
   void SetTempNamespaceOid(const catalog::namespace_oid_t ns_oid) { temp_namespace_oid_ = ns_oid; }
 
@@ -120,7 +132,21 @@ class ConnectionContext {
    * @warning this should only be used by TrafficCop::BeginTransaction and TrafficCop::EndTransaction
    * @warning it should match the txn used for this ConnectionContext's current CatalogAccessor
    */
-  void SetTransaction(const common::ManagedPointer<transaction::TransactionContext> txn) { txn_ = txn; }
+  void SetTransaction(const common::ManagedPointer<transaction::TransactionContext> txn) {
+    txn_ = txn;
+    txn_changed_catalog_ = false;
+  }
+
+  /**
+   * @return true if the current txn ran DDL. The plans it builds may depend on its uncommitted catalog changes, so they
+   * must not be shared with other connections.
+   */
+  bool TransactionChangedCatalog() const { return txn_changed_catalog_; }
+
+  /**
+   * Mark the current txn as having run DDL
+   */
+  void SetTransactionChangedCatalog() { txn_changed_catalog_ = true; }
 
   /**
    * @return current CatalogAccesor for connection
@@ -151,16 +177,73 @@ class ConnectionContext {
 
   /**
    * @return handle to the ConnectionHandle callback to issue a libevent wakeup in the event of WAIT_ON_TERRIER
-   * state. Currently not used, but may in the future for asynchronous execution.
+   * state. Called by the execution worker that ran the command of the connection.
    */
   network::NetworkCallback Callback() const { return callback_; }
 
   /**
    * @return args to the ConnectionHandle callback to issue a libevent wakeup in the event of WAIT_ON_TERRIER
-   * state. Currently not used, but may in the future for asynchronous execution.
+   * state
    */
   void *CallbackArg() const { return callback_arg_; }
 
+  /**
+   * @param io_wrapper the transport of the connection
+   * @warning only to be used by the ConnectionHandle
+   */
+  void SetIoWrapper(const common::ManagedPointer<NetworkIoWrapper> io_wrapper) { io_wrapper_ = io_wrapper; }
+
+  /**
+   * @return the transport of the connection, which the protocol interpreter switches over to shared memory if a
+   * client on the same host asks for it during startup
+   */
+  common::ManagedPointer<NetworkIoWrapper> IoWrapper() const { return io_wrapper_; }
+
+  /**
+   * @param cursor cursor whose query runs in the current txn until the cursor is closed
+   * @warning only to be used by the ResultCursor
+   */
+  void RegisterCursor(const common::ManagedPointer<trafficcop::ResultCursor> cursor) { cursors_.push_back(cursor); }
+
+  /**
+   * @param cursor cursor that is destroyed
+   * @warning only to be used by the ResultCursor
+   */
+  void UnregisterCursor(const common::ManagedPointer<trafficcop::ResultCursor> cursor) {
+    cursors_.erase(std::remove(cursors_.begin(), cursors_.end(), cursor), cursors_.end());
+  }
+
+  /**
+   * @return the cursors whose queries run in the current txn, which are closed before it ends
+   */
+  const std::vector<common::ManagedPointer<trafficcop::ResultCursor>> &Cursors() const { return cursors_; }
+
+  /**
+   * @return id that links the spans of the request that is being processed, 0 if it's not traced
+   */
+  uint64_t QueryTraceId() const { return query_trace_id_; }
+
+  /**
+   * Trace the request that is being processed, until its results are flushed to the client
+   */
+  void StartQueryTrace() { query_trace_id_ = ++num_query_traces_; }
+
+  /**
+   * Stop tracing once the results of the traced request are flushed
+   */
+  void EndQueryTrace() { query_trace_id_ = 0; }
+
+  /**
+   * @return time at which the connection started to read the current request (microseconds)
+   */
+  uint64_t ReadStartTime() const { return read_start_us_; }
+
+  /**
+   * @param read_start_us time at which the connection started to read the current request (microseconds)
+   * @warning only to be used by the ConnectionHandle
+   */
+  void SetReadStartTime(const uint64_t read_start_us) { read_start_us_ = read_start_us; }
+
   /**
    * @return CatalogCache to be injected into requests for CatalogAcessors
    */
@@ -200,6 +283,7 @@ class ConnectionContext {
    * transfer ownership to the TransactionManager (via the TrafficCop) at commit or abort.
    */
   common::ManagedPointer<transaction::TransactionContext> txn_ = nullptr;
+  bool txn_changed_catalog_ = false;
 
   /**
    * The ConnectionContext owns this, and I don't expect that should ever change. It's life cycle dominates objects
@@ -208,11 +292,28 @@ class ConnectionContext {
   std::unique_ptr<catalog::CatalogAccessor> accessor_ = nullptr;
 
   /**
-   * ConnectionHandle callback stuff to issue a libevent wakeup in the event of WAIT_ON_TERRIER state. Currently
-   * not used, but may in the future for asynchronous execution.
+   * ConnectionHandle callback stuff to issue a libevent wakeup in the event of WAIT_ON_TERRIER state, once an
+   * execution worker finished the command of the connection.
    */
   network::NetworkCallback callback_;
   void *callback_arg_;
+  /**
+   * The ConnectionHandle owns the transport of the connection
+   */
+  common::ManagedPointer<NetworkIoWrapper> io_wrapper_ = nullptr;
+
+  /**
+   * The portals own the cursors, which run queries in the txn of the connection
+   */
+  std::vector<common::ManagedPointer<trafficcop::ResultCursor>> cursors_;
+
+  /**
+   * Tracing state of the request that is being processed. The ids are only unique within the connection, which the
+   * spans are recorded with.
+   */
+  uint64_t query_trace_id_ = 0;
+  uint64_t num_query_traces_ = 0;
+  uint64_t read_start_us_ = 0;
 
   catalog::CatalogCache catalog_cache_;
 };
@@ -46,16 +46,23 @@ class ConnectionHandle {
    * @param handler The handler responsible for this handle
    * @param tcop The pointer to the traffic cop
    * @param interpreter protocol interpreter to use for this connection handle
+   * @param vectored_writes whether to flush the writes to the client with a single writev
+   * @param shared_memory_ring_size size of the rings of a client that switches over to shared memory, 0 to disable it
+   * @param write_queue_limit number of bytes of results that are queued before the query waits for the client
+   * @param write_timeout number of milliseconds the query waits for the client before it fails
    */
   ConnectionHandle(int sock_fd, common::ManagedPointer<ConnectionHandlerTask> handler,
                    common::ManagedPointer<trafficcop::TrafficCop> tcop,
-                   std::unique_ptr<ProtocolInterpreter> interpreter)
-      : io_wrapper_(std::make_unique<NetworkIoWrapper>(sock_fd)),
+                   std::unique_ptr<ProtocolInterpreter> interpreter, bool vectored_writes,
+                   uint32_t shared_memory_ring_size, uint64_t write_queue_limit, uint32_t write_timeout)
+      : io_wrapper_(std::make_unique<NetworkIoWrapper>(sock_fd, vectored_writes, shared_memory_ring_size,
+                                                       write_queue_limit, write_timeout)),
         conn_handler_(handler),
         traffic_cop_(tcop),
         protocol_interpreter_(std::move(interpreter)) {
     context_.SetCallback(Callback, this);
     context_.SetConnectionID(static_cast<connection_id_t>(sock_fd));
+    context_.SetIoWrapper(common::ManagedPointer(io_wrapper_));
   }
 
   ~ConnectionHandle() { context_.Reset(); }
@@ -100,17 +107,13 @@ class ConnectionHandle {
    * @brief Tries to read from the event port onto the read buffer
    * @return The transition to trigger in the state machine after
    */
-  Transition TryRead() { return io_wrapper_->FillReadBuffer(); }
+  Transition TryRead();
 
   /**
    * @brief Flushes the write buffer to the client if needed
    * @return The transition to trigger in the state machine after
    */
-  Transition TryWrite() {
-    if (io_wrapper_->ShouldFlush()) return io_wrapper_->FlushAllWrites();
-
-    return Transition::PROCEED;
-  }
+  Transition TryWrite();
 
   /**
    * @brief Processes the client's input that has been fed into the ReadBuffer
@@ -154,6 +157,8 @@ class ConnectionHandle {
       conn_handler_->UpdateEvent(network_event_, io_wrapper_->GetSocketFd(), flags,
                                  METHOD_AS_CALLBACK(ConnectionHandle, HandleEvent), this);
     }
+    // The socket of a client on shared memory only carries wakeups, so a wait that is already over ends right away
+    if ((flags & EV_READ) != 0 && !io_wrapper_->PrepareToWait()) event_active(network_event_, EV_READ, 0);
   }
 
   /**
@@ -238,6 +243,8 @@ class ConnectionHandle {
 
   StateMachine state_machine_{};
   struct event *network_event_ = nullptr, *workpool_event_ = nullptr;
+  // Start of the flush of the results of a traced request, which may take several writes
+  uint64_t flush_start_us_ = 0;
 
   // TODO(Tianyu): Do we want to flatten this struct out into connection handle, or is this current separation
   // sensible?
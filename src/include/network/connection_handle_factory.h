@@ -31,8 +31,19 @@ class ConnectionHandleFactory {
   /**
    * Builds a new connection handle factory.
    * @param tcop The pointer to the traffic cop
+   * @param vectored_writes whether the connections flush their writes with a single writev
+   * @param shared_memory_ring_size size of the rings of the clients that switch over to shared memory, 0 to disable it
+   * @param write_queue_limit number of bytes of results that are queued before a query waits for its client, 0 to
+   * queue the whole result
+   * @param write_timeout number of milliseconds a query waits for its client before it fails, 0 to wait indefinitely
    */
-  explicit ConnectionHandleFactory(common::ManagedPointer<trafficcop::TrafficCop> tcop) : traffic_cop_(tcop) {}
+  ConnectionHandleFactory(common::ManagedPointer<trafficcop::TrafficCop> tcop, bool vectored_writes,
+                          uint32_t shared_memory_ring_size, uint64_t write_queue_limit, uint32_t write_timeout)
+      : traffic_cop_(tcop),
+        vectored_writes_(vectored_writes),
+        shared_memory_ring_size_(shared_memory_ring_size),
+        write_queue_limit_(write_queue_limit),
+        write_timeout_(write_timeout) {}
 
   /**
    * @brief Creates or re-purpose a NetworkIoWrapper object for new use.
@@ -54,5 +65,9 @@ class ConnectionHandleFactory {
   common::SpinLatch reusable_handles_latch_;
   std::unordered_map<int, ConnectionHandle> reusable_handles_;
   common::ManagedPointer<trafficcop::TrafficCop> traffic_cop_;
+  const bool vectored_writes_;
+  const uint32_t shared_memory_ring_size_;
+  const uint64_t write_queue_limit_;
+  const uint32_t write_timeout_;
 };
 }  // namespace terrier::network
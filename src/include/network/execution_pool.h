@@ -0,0 +1,111 @@
+#pragma once
+
+#include <condition_variable>  // NOLINT
+#include <functional>
+#include <mutex>  // NOLINT
+#include <queue>
+#include <vector>
+
+#include "common/dedicated_thread_owner.h"
+#include "common/dedicated_thread_task.h"
+#include "common/macros.h"
+#include "common/managed_pointer.h"
+
+namespace terrier::network {
+
+class ExecutionPool;
+
+/**
+ * A dedicated thread of the ExecutionPool, which runs the commands handed off to the pool until the pool is stopped.
+ */
+class ExecutionWorkerTask : public common::DedicatedThreadTask {
+ public:
+  /**
+   * @param pool the pool to take commands from
+   */
+  explicit ExecutionWorkerTask(common::ManagedPointer<ExecutionPool> pool) : pool_(pool) {}
+
+  /**
+   * Run commands until the pool is stopped and no command is left
+   */
+  void RunTask() override;
+
+  /**
+   * Stop the pool. The workers run the commands that were already handed off before they exit.
+   */
+  void Terminate() override;
+
+ private:
+  const common::ManagedPointer<ExecutionPool> pool_;
+};
+
+/**
+ * The execution workers run the commands of the clients, so the connection handler threads only read packets and
+ * write results. A handler hands a command off and stops listening on the connection until the worker that ran the
+ * command wakes it up with the callback of the ConnectionContext. A long query thus only takes up a worker, and the
+ * other connections of its handler thread are served meanwhile.
+ *
+ * The number of workers bounds the number of commands that execute at once. The other commands wait for a worker in
+ * the order they arrived. Every connection has at most one command in flight, so the number of waiting commands is
+ * bounded by the number of connections.
+ */
+class ExecutionPool : public common::DedicatedThreadOwner {
+ public:
+  /**
+   * @param thread_registry where to register the workers
+   * @param num_workers the number of commands that may execute at once
+   */
+  ExecutionPool(common::ManagedPointer<common::DedicatedThreadRegistry> thread_registry, uint32_t num_workers)
+      : DedicatedThreadOwner(thread_registry), num_workers_(num_workers) {}
+
+  ~ExecutionPool() override { TERRIER_ASSERT(workers_.empty(), "ExecutionPool should be stopped before destruction."); }
+
+  /**
+   * This class cannot be copied or moved.
+   */
+  DISALLOW_COPY_AND_MOVE(ExecutionPool);
+
+  /**
+   * Start the workers. Commands are accepted from now on.
+   */
+  void Start();
+
+  /**
+   * Stop accepting commands, and stop the workers once they ran every command that was already handed off. Their
+   * connections must still be able to receive the wakeup, so the pool is stopped before the connection handlers.
+   */
+  void Stop();
+
+  /**
+   * Hand a command off to the workers.
+   * @param command the command, which calls its connection back when it is done
+   * @return true if a worker will run the command, false if the pool is stopped and the caller has to run it
+   */
+  bool Submit(std::function<void()> command);
+
+  /**
+   * @return the number of commands that may execute at once
+   */
+  uint32_t NumWorkers() const { return num_workers_; }
+
+ private:
+  friend class ExecutionWorkerTask;
+
+  // Run commands until the pool is stopped and no command is left
+  void RunWorker();
+
+  // Wake up the workers to exit once no command is left
+  void Terminate();
+
+  bool OnThreadRemoval(common::ManagedPointer<common::DedicatedThreadTask> task) override { return true; }
+
+  const uint32_t num_workers_;
+  std::vector<common::ManagedPointer<ExecutionWorkerTask>> workers_;
+
+  std::mutex latch_;
+  std::condition_variable commands_cv_;
+  std::queue<std::function<void()>> commands_;
+  bool running_ = false;
+};
+
+}  // namespace terrier::network
@@ -27,7 +27,9 @@ class ITPPacketWriter : public PacketWriter {
    * bytes to the packet and call EndReplicationCommand when we want to finish the current command.
    * @param message_id message id
    */
-  void BeginReplicationCommand(uint64_t message_id) { BeginPacket(NetworkMessageType::ITP_REPLICATION_COMMAND); }
+  void BeginReplicationCommand(uint64_t message_id) {
+    BeginPacket(NetworkMessageType::ITP_REPLICATION_COMMAND).AppendValue<uint64_t>(message_id);
+  }
 
   /**
    * End the Replication command
@@ -41,8 +43,14 @@ class ITPPacketWriter : public PacketWriter {
 
   /**
    * Tells the client that the command is complete.
+   * -----------------------------------------------
+   * | message type (char) | message id (uint64_t) |
+   * -----------------------------------------------
+   * @param message_id id of the message that carried the command
    */
-  void WriteCommandComplete() { BeginPacket(NetworkMessageType::ITP_COMMAND_COMPLETE).EndPacket(); }
+  void WriteCommandComplete(uint64_t message_id) {
+    BeginPacket(NetworkMessageType::ITP_COMMAND_COMPLETE).AppendValue<uint64_t>(message_id).EndPacket();
+  }
 };
 
 }  // namespace terrier::network
@@ -68,8 +68,9 @@ class ITPProtocolInterpreter : public ProtocolInterpreter {
   /**
    * Writes result to the client
    * @param out WriteQueue to flush message to client
+   * @return transition::PROCEED
    */
-  void GetResult(common::ManagedPointer<WriteQueue> out) override;
+  Transition GetResult(common::ManagedPointer<WriteQueue> out) override;
 
  protected:
   /**
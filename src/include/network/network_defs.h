@@ -71,15 +71,23 @@ enum class NetworkMessageType : unsigned char {
   PG_PARAMETER_DESCRIPTION = 't',
   PG_ROW_DESCRIPTION = 'T',
   PG_DATA_ROW = 'D',
+  PG_PORTAL_SUSPENDED = 's',
+  PG_COPY_IN_RESPONSE = 'G',
+  PG_COPY_OUT_RESPONSE = 'H',
+  // Sent in both directions
+  PG_COPY_DATA = 'd',
+  PG_COPY_DONE = 'c',
   // Commands
   PG_EXECUTE_COMMAND = 'E',
   PG_SYNC_COMMAND = 'S',
+  PG_FLUSH_COMMAND = 'H',
   PG_TERMINATE_COMMAND = 'X',
   PG_DESCRIBE_COMMAND = 'D',
   PG_BIND_COMMAND = 'B',
   PG_PARSE_COMMAND = 'P',
   PG_SIMPLE_QUERY_COMMAND = 'Q',
   PG_CLOSE_COMMAND = 'C',
+  PG_COPY_FAIL_COMMAND = 'f',
 
   ////////////////////////
   // ITP message types  //
@@ -1,16 +1,20 @@
 #pragma once
 #include <arpa/inet.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
 #include <algorithm>
+#include <array>
 #include <cstring>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "common/error/exception.h"
 #include "common/managed_pointer.h"
 #include "network/network_defs.h"
+#include "network/shared_memory_channel.h"
 #include "util/portable_endian.h"
 
 namespace terrier::network {
@@ -207,6 +211,17 @@ class ReadBufferView {
     return result;
   }
 
+  /**
+   * Read the rest of the view without copying it, advancing the cursor to the end
+   * @return bytes at head of read buffer, which are only valid as long as the underlying buffer is
+   */
+  std::string_view ReadRemaining() {
+    if (offset_ == size_) return {};
+    std::string_view result(reinterpret_cast<const char *>(&*(begin_ + offset_)), size_ - offset_);
+    offset_ = size_;
+    return result;
+  }
+
   /**
    * Read a value of type T off of the buffer, advancing cursor by appropriate
    * amount. Does NOT convert from network bytes order. It is the caller's
@@ -247,6 +262,17 @@ class ReadBuffer : public Buffer {
     return static_cast<int>(bytes_read);
   }
 
+  /**
+   * Read as many bytes as possible that the client sent through shared memory
+   * @param channel the channel to read from
+   * @return the number of bytes read
+   */
+  size_t FillBufferFrom(const common::ManagedPointer<SharedMemoryChannel> channel) {
+    const size_t bytes_read = channel->Receive(&buf_[size_], Capacity() - size_);
+    size_ += bytes_read;
+    return bytes_read;
+  }
+
   /**
    * Read the specified amount of bytes off from a ReadBufferView. The bytes
    * will be consumed (cursor moved) on the view and appended to the end
@@ -333,6 +359,17 @@ class WriteBuffer : public Buffer {
     return static_cast<int>(bytes_written);
   }
 
+  /**
+   * Write as many bytes as possible to the client through shared memory
+   * @param channel the channel to write to
+   * @return the number of bytes written
+   */
+  size_t WriteOutTo(const common::ManagedPointer<SharedMemoryChannel> channel) {
+    const size_t bytes_written = channel->Send(&buf_[offset_], size_ - offset_);
+    offset_ += bytes_written;
+    return bytes_written;
+  }
+
   /**
    * The remaining capacity of this buffer. This value is equal to the
    * maximum capacity minus the capacity already in use.
@@ -437,6 +474,11 @@ class WriteQueue {
    */
   bool ShouldFlush() { return flush_ || buffers_.size() > 1; }
 
+  /**
+   * @return upper bound of the number of bytes that are queued and not written out yet
+   */
+  size_t QueuedBytes() const { return (buffers_.size() - offset_) * SOCKET_BUFFER_CAPACITY; }
+
   /**
    * Write len many bytes starting from src into the write queue, allocating
    * a new buffer if need be. The write is split up between two buffers
@@ -472,8 +514,37 @@ class WriteQueue {
     BufferWriteRaw(&val, sizeof(T), breakup);
   }
 
+  /**
+   * Write as many bytes as possible from the buffers that are not flushed yet using a single Posix writev to fd,
+   * instead of one write per buffer. The buffers that were written out completely are marked as flushed, so the queue
+   * is flushed once FlushHead returns nullptr.
+   * @param fd File descriptor to write out to
+   * @return return value of Posix writev
+   */
+  int WriteOutTo(int fd) {
+    std::array<iovec, MAX_WRITE_VECTORS> vectors;
+    size_t num_vectors = 0;
+    for (size_t i = offset_; i < buffers_.size() && num_vectors < vectors.size(); i++) {
+      WriteBuffer &buffer = *buffers_[i];
+      vectors[num_vectors++] = {&buffer.buf_[buffer.offset_], buffer.size_ - buffer.offset_};
+    }
+    ssize_t bytes_written = writev(fd, vectors.data(), static_cast<int>(num_vectors));
+    auto remaining = static_cast<size_t>(std::max<ssize_t>(bytes_written, 0));
+    for (; offset_ < buffers_.size(); offset_++) {
+      WriteBuffer &buffer = *buffers_[offset_];
+      const size_t written = std::min(remaining, buffer.size_ - buffer.offset_);
+      buffer.Skip(written);
+      remaining -= written;
+      if (buffer.HasMore()) break;
+    }
+    return static_cast<int>(bytes_written);
+  }
+
  private:
   friend class PacketWriter;
+  // Number of buffers that are gathered by a single writev
+  static constexpr size_t MAX_WRITE_VECTORS = 64;
+
   std::vector<std::unique_ptr<WriteBuffer>> buffers_;
   size_t offset_ = 0;
   bool flush_ = false;
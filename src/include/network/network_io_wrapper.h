@@ -7,6 +7,7 @@
 #include "common/utility.h"
 #include "network/network_io_utils.h"
 #include "network/network_types.h"
+#include "network/shared_memory_channel.h"
 
 namespace terrier::network {
 
@@ -14,7 +15,12 @@ namespace terrier::network {
  * A network io wrapper implements an interface for interacting with a client
  * connection.
  *
- * Underneath the hood the wrapper buffers read and write, and supports posix reads and writes to the socket.
+ * Underneath the hood the wrapper buffers read and write, and supports posix reads and writes to the socket. The
+ * queued writes are either gathered into a single writev, or written out one buffer at a time. A client on the same
+ * host can switch over to a SharedMemoryChannel instead, after which the socket only carries the wakeups.
+ *
+ * A query that writes out a large result flushes the queued writes itself once they exceed a limit, waiting for a slow
+ * client to read them, so that the result is never held in memory as a whole.
  *
  * Because the buffers are large and expensive to allocate on fly, they are
  * reused. Consequently, initialization of this class is handled by a factory
@@ -31,9 +37,23 @@ class NetworkIoWrapper {
   /**
    * @brief Constructor for a PosixSocketIoWrapper
    * @param sock_fd The fd this IoWrapper communicates on
+   * @param vectored_writes whether to flush all the queued writes with a single writev instead of one write per buffer
+   * @param shared_memory_ring_size size of the rings of the shared memory of a client on the same host, 0 to keep
+   * every client on its socket
+   * @param write_queue_limit number of bytes of results that are queued before the query waits for the client to read
+   * them, 0 to queue the whole result
+   * @param write_timeout number of milliseconds the query waits for the client to read them before it fails, 0 to
+   * wait indefinitely
    */
-  explicit NetworkIoWrapper(const int sock_fd)
-      : sock_fd_(sock_fd), in_(std::make_unique<ReadBuffer>()), out_(std::make_unique<WriteQueue>()) {
+  NetworkIoWrapper(const int sock_fd, const bool vectored_writes, const uint32_t shared_memory_ring_size,
+                   const uint64_t write_queue_limit, const uint32_t write_timeout)
+      : sock_fd_(sock_fd),
+        vectored_writes_(vectored_writes),
+        shared_memory_ring_size_(shared_memory_ring_size),
+        write_queue_limit_(write_queue_limit),
+        write_timeout_(write_timeout),
+        in_(std::make_unique<ReadBuffer>()),
+        out_(std::make_unique<WriteQueue>()) {
     RestartState();
   }
 
@@ -60,15 +80,44 @@ class NetworkIoWrapper {
    */
   Transition FlushAllWrites();
 
+  /**
+   * Called by a command while it writes out its result, after a complete message. If more than the limit of bytes are
+   * queued, they are flushed, blocking the command until the client read enough of them. The rest of the result of a
+   * client that went away is dropped, the connection notices that it is closed once the command is done.
+   * @throw ExecutionException if the client doesn't read the queued bytes within the write timeout
+   */
+  void ApplyBackPressure() {
+    if (write_queue_limit_ != 0 && out_->QueuedBytes() > write_queue_limit_) FlushAllWritesAndWait();
+  }
+
   /**
    * @brief Closes this IOWrapper
    * @return The next transition for this client's state machine
    */
   Transition Close() {
+    shared_memory_.reset();
     TerrierClose(sock_fd_);
     return Transition::PROCEED;
   }
 
+  /**
+   * Switches a client on the Unix domain socket over to shared memory, if it is enabled. The segment is sent to the
+   * client along with the answer to its request, and every byte after the answer goes through the segment.
+   * @param answer the byte that tells the client to use the segment
+   * @return whether the client got the segment, otherwise it keeps using the socket
+   */
+  bool StartSharedMemory(uchar answer);
+
+  /**
+   * Called before the connection sleeps until its socket is readable. A client on shared memory only writes to the
+   * socket once it knows that the server sleeps.
+   * @return whether the connection may sleep, false if the bytes or the room it waits for are already there
+   */
+  bool PrepareToWait() {
+    if (shared_memory_ == nullptr) return true;
+    return waiting_for_space_ ? shared_memory_->PrepareToWaitForSpace() : shared_memory_->PrepareToWaitForData();
+  }
+
   /**
    * @brief Restarts this IOWrapper
    */
@@ -92,11 +141,36 @@ class NetworkIoWrapper {
  private:
   // The file descriptor associated with this NetworkIoWrapper
   const int sock_fd_;
+  // Whether the queued writes are gathered into a single writev
+  const bool vectored_writes_;
+  // Size of the rings of a client on shared memory, 0 if it is disabled
+  const uint32_t shared_memory_ring_size_;
+  // Number of bytes of results that are queued before the query waits for the client, 0 if it never waits
+  const uint64_t write_queue_limit_;
+  // Number of milliseconds a query waits for the client to read the queued results, 0 if it waits indefinitely
+  const uint32_t write_timeout_;
+  // The shared memory the client switched over to, nullptr if it uses the socket
+  std::unique_ptr<SharedMemoryChannel> shared_memory_;
+  // Whether the writes to shared memory wait for the client to make room
+  bool waiting_for_space_ = false;
   // The ReadBuffer associated with this NetworkIoWrapper
   std::unique_ptr<ReadBuffer> in_;
   // The WriteQueue associated with this NetworkIoWrapper
   std::unique_ptr<WriteQueue> out_;
 
   void RestartState();
+
+  // The transition after a write that failed with errno, or PROCEED if the write should be retried
+  static Transition WriteFailed();
+
+  Transition FillReadBufferFromSharedMemory();
+  Transition FlushAllWritesToSharedMemory();
+  // Flushes all writes, waiting until the socket or the shared memory has room whenever it is full. Throws an
+  // ExecutionException if that takes longer than the write timeout.
+  void FlushAllWritesAndWait();
+  // Reads the wakeups that the client on shared memory sent, TERMINATE if it closed the connection
+  Transition DrainWakeups();
+  // Wakes the client on shared memory up if it sleeps although it can make progress
+  void WakeUpPeer();
 };
 }  // namespace terrier::network
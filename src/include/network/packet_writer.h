@@ -35,6 +35,12 @@ class PacketWriter {
    */
   bool IsPacketEmpty() { return curr_packet_len_ == nullptr; }
 
+  /**
+   * Make sure everything written so far is sent to the client once the current command completes, even if the
+   * command does not flush on completion.
+   */
+  void ForceFlush() { queue_->ForceFlush(); }
+
   /**
    * Write out a single type
    * @param type to write to the queue
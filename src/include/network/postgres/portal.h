@@ -5,9 +5,11 @@
 #include <vector>
 
 #include "common/managed_pointer.h"
+#include "execution/exec/execution_context.h"
 #include "network/postgres/postgres_defs.h"
 #include "network/postgres/statement.h"
 #include "parser/expression/constant_value_expression.h"
+#include "traffic_cop/result_cursor.h"
 
 namespace terrier::planner {
 class AbstractPlanNode;
@@ -19,7 +21,8 @@ namespace terrier::network {
  * Portal is a postgres concept (see the Extended Query documentation:
  * https://www.postgresql.org/docs/current/protocol-flow.html#PROTOCOL-FLOW-EXT-QUERY)
  * It encapsulates a reference to its originating statement, the parameters (if any), the output formats, and the
- * optimized physical plan. It represents a query ready to be executed.
+ * optimized physical plan. It represents a query ready to be executed. A SELECT portal that the client executes with a
+ * maximum number of rows keeps its suspended execution in a cursor, which the next Execute continues.
  */
 class Portal {
  public:
@@ -59,13 +62,89 @@ class Portal {
    * @return params for this query
    */
   common::ManagedPointer<const std::vector<parser::ConstantValueExpression>> Parameters() {
-    return common::ManagedPointer(&params_);
+    return common::ManagedPointer<const std::vector<parser::ConstantValueExpression>>(&params_);
   }
 
+  /**
+   * Binds the portal to new params of the same statement. The portal keeps its execution context, so a client that
+   * binds and executes the same statement again and again doesn't pay for setting up the execution every time. The
+   * previous params and output formats are swapped out rather than freed, so that the caller can reuse their memory.
+   * @param params params for this query, replaced by the previous params
+   * @param result_formats output formats for this query, replaced by the previous output formats
+   */
+  void Rebind(const common::ManagedPointer<std::vector<parser::ConstantValueExpression>> params,
+              const common::ManagedPointer<std::vector<FieldFormat>> result_formats) {
+    cursor_ = nullptr;
+    params_.swap(*params);
+    result_formats_.swap(*result_formats);
+  }
+
+  /**
+   * Binds a recycled portal to another statement
+   * @param statement statement that this Portal refers to
+   * @param params params for this query, replaced by the previous params
+   * @param result_formats output formats for this query, replaced by the previous output formats
+   */
+  void Rebind(const common::ManagedPointer<Statement> statement,
+              const common::ManagedPointer<std::vector<parser::ConstantValueExpression>> params,
+              const common::ManagedPointer<std::vector<FieldFormat>> result_formats) {
+    Rebind(params, result_formats);
+    statement_ = statement;
+    exec_ctx_ = nullptr;
+  }
+
+  /**
+   * Releases what the portal refers to once it's closed, keeping the memory of its params and output formats for the
+   * next Bind that recycles it
+   */
+  void Recycle() {
+    cursor_ = nullptr;
+    statement_ = nullptr;
+    exec_ctx_ = nullptr;
+    params_.clear();
+    result_formats_.clear();
+  }
+
+  /**
+   * @param txn the transaction the portal executes in
+   * @return the execution context of the previous execution of this portal in txn, nullptr if there is none
+   */
+  common::ManagedPointer<execution::exec::ExecutionContext> GetExecutionContext(
+      const common::ManagedPointer<transaction::TransactionContext> txn) const {
+    if (exec_ctx_ != nullptr && exec_ctx_->GetTxn() == txn) return common::ManagedPointer(exec_ctx_);
+    return nullptr;
+  }
+
+  /**
+   * @return settings of the execution context kept in the portal, which refers to them
+   */
+  execution::exec::ExecutionSettings &GetExecutionSettings() { return exec_settings_; }
+
+  /**
+   * @param exec_ctx execution context for the following executions of this portal in its transaction
+   */
+  void SetExecutionContext(std::unique_ptr<execution::exec::ExecutionContext> &&exec_ctx) {
+    exec_ctx_ = std::move(exec_ctx);
+  }
+
+  /**
+   * @return the suspended execution of this portal, nullptr if the portal wasn't executed with a maximum number of rows
+   */
+  common::ManagedPointer<trafficcop::ResultCursor> GetCursor() const { return common::ManagedPointer(cursor_); }
+
+  /**
+   * @param cursor the execution of this portal that the following Executes continue
+   */
+  void SetCursor(std::unique_ptr<trafficcop::ResultCursor> &&cursor) { cursor_ = std::move(cursor); }
+
  private:
-  const common::ManagedPointer<network::Statement> statement_;
-  const std::vector<parser::ConstantValueExpression> params_;
-  const std::vector<FieldFormat> result_formats_;
+  common::ManagedPointer<network::Statement> statement_;
+  std::vector<parser::ConstantValueExpression> params_;
+  std::vector<FieldFormat> result_formats_;
+  execution::exec::ExecutionSettings exec_settings_;
+  std::unique_ptr<execution::exec::ExecutionContext> exec_ctx_;
+  // Declared last, so that its query is done before what it refers to is destroyed
+  std::unique_ptr<trafficcop::ResultCursor> cursor_;
 };
 
 }  // namespace terrier::network
@@ -41,15 +41,19 @@ class PostgresNetworkCommand : public NetworkCommand {
   PostgresNetworkCommand(const common::ManagedPointer<InputPacket> in, bool flush) : NetworkCommand(in, flush) {}
 };
 
-// Set all to force flush for now
+// The messages of the Extended Query protocol only flush on Sync and Flush, so pipelined messages are answered together
 DEFINE_POSTGRES_COMMAND(SimpleQueryCommand, true);
 DEFINE_POSTGRES_COMMAND(ParseCommand, false);
 DEFINE_POSTGRES_COMMAND(BindCommand, false);
 DEFINE_POSTGRES_COMMAND(DescribeCommand, false);
 DEFINE_POSTGRES_COMMAND(ExecuteCommand, false);
 DEFINE_POSTGRES_COMMAND(SyncCommand, true);
-DEFINE_POSTGRES_COMMAND(CloseCommand, true);
+DEFINE_POSTGRES_COMMAND(FlushCommand, true);
+DEFINE_POSTGRES_COMMAND(CloseCommand, false);
 DEFINE_POSTGRES_COMMAND(TerminateCommand, true);
+DEFINE_POSTGRES_COMMAND(CopyDataCommand, false);
+DEFINE_POSTGRES_COMMAND(CopyDoneCommand, true);
+DEFINE_POSTGRES_COMMAND(CopyFailCommand, true);
 DEFINE_POSTGRES_COMMAND(EmptyCommand, true);  // (Matt): This seems to be only for testing? Not a big fan of that.
 
 }  // namespace terrier::network
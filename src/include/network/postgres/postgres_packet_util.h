@@ -25,9 +25,11 @@ class PostgresPacketUtil {
   /**
    * Given a read buffer that starts at the format codes for a Parse or Bind message, reads the values out
    * @param read_buffer incoming postgres packet with next fields as format codes
-   * @return vector of format codes for the attributes
+   * @param[out] formats vector to replace the contents of with the format codes for the attributes, so that its memory
+   * can be reused
    */
-  static std::vector<FieldFormat> ReadFormatCodes(common::ManagedPointer<ReadBufferView> read_buffer);
+  static void ReadFormatCodes(common::ManagedPointer<ReadBufferView> read_buffer,
+                              common::ManagedPointer<std::vector<FieldFormat>> formats);
 
   /**
    * Given a read buffer that starts at the parameter types for a Parse message, reads the values out
@@ -61,11 +63,13 @@ class PostgresPacketUtil {
    * @param read_buffer incoming postgres packet with next fields as parameter types
    * @param param_types
    * @param param_formats
-   * @return vector of internal types for the parameters
+   * @param[out] params vector to replace the contents of with the values of the parameters, so that its memory can be
+   * reused
    */
-  static std::vector<parser::ConstantValueExpression> ReadParameters(common::ManagedPointer<ReadBufferView> read_buffer,
-                                                                     const std::vector<type::TypeId> &param_types,
-                                                                     const std::vector<FieldFormat> &param_formats);
+  static void ReadParameters(common::ManagedPointer<ReadBufferView> read_buffer,
+                             const std::vector<type::TypeId> &param_types,
+                             const std::vector<FieldFormat> &param_formats,
+                             common::ManagedPointer<std::vector<parser::ConstantValueExpression>> params);
 };
 
 }  // namespace terrier::network
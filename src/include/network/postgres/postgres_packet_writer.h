@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "common/managed_pointer.h"
@@ -162,6 +163,12 @@ class PostgresPacketWriter : public PacketWriter {
    */
   void WriteBindComplete();
 
+  /**
+   * Tells the client that the portal produced the number of rows it asked for, and that the rest is fetched by the
+   * next Execute of the portal.
+   */
+  void WritePortalSuspended();
+
   /**
    * Write a data row from the execution engine back to the client
    * @param tuple pointer to the start of the row
@@ -171,6 +178,50 @@ class PostgresPacketWriter : public PacketWriter {
   void WriteDataRow(const byte *tuple, const std::vector<planner::OutputSchema::Column> &columns,
                     const std::vector<FieldFormat> &field_formats);
 
+  /**
+   * Write a batch of data rows from the execution engine back to the client. The offset, type and format of every
+   * column are resolved once for the whole batch, and numbers are formatted without allocating.
+   * @param tuples pointer to the start of the first row
+   * @param num_tuples number of rows in the batch
+   * @param tuple_size distance between the starts of two consecutive rows
+   * @param columns OutputSchema describing the tuples
+   * @param field_formats vector formats for the attributes to write
+   */
+  void WriteDataRows(const byte *tuples, uint32_t num_tuples, uint32_t tuple_size,
+                     const std::vector<planner::OutputSchema::Column> &columns,
+                     const std::vector<FieldFormat> &field_formats);
+
+  /**
+   * Tells the client to send the rows of a COPY FROM STDIN in CopyData messages.
+   * @param format format of the rows, which is the same for all columns
+   * @param num_columns number of columns of every row
+   */
+  void WriteCopyInResponse(FieldFormat format, uint16_t num_columns);
+
+  /**
+   * Tells the client that the rows of a COPY TO STDOUT follow in CopyData messages.
+   * @param format format of the rows, which is the same for all columns
+   * @param num_columns number of columns of every row
+   */
+  void WriteCopyOutResponse(FieldFormat format, uint16_t num_columns);
+
+  /**
+   * Write the next part of a COPY data stream. It does not have to align with the rows.
+   * @param data bytes of the stream
+   */
+  void WriteCopyData(std::string_view data);
+
+  /**
+   * Tells the other side that a COPY data stream is complete.
+   */
+  void WriteCopyDone();
+
+  /**
+   * Tells the server that the client aborted a COPY FROM STDIN.
+   * @param message the reason of the failure
+   */
+  void WriteCopyFail(const std::string &message);
+
  private:
   template <class native_type, class val_type>
   void WriteBinaryVal(const execution::sql::Val *val, type::TypeId type);
@@ -187,6 +238,13 @@ class PostgresPacketWriter : public PacketWriter {
    * @param columns OutputSchema describing the tuple
    */
   uint32_t WriteTextAttribute(const execution::sql::Val *val, type::TypeId type);
+
+  /**
+   * Write the length and the text of an attribute that was formatted into a buffer on the stack
+   * @param first start of the text
+   * @param last end of the text
+   */
+  void WriteTextField(const char *first, const char *last);
 };
 
 }  // namespace terrier::network
@@ -4,10 +4,12 @@
 #include <string>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "loggers/network_logger.h"
 #include "network/connection_context.h"
 #include "network/connection_handle.h"
+#include "network/execution_pool.h"
 #include "network/postgres/portal.h"
 #include "network/postgres/postgres_command_factory.h"
 #include "network/postgres/postgres_network_commands.h"
@@ -15,13 +17,10 @@
 #include "network/postgres/statement.h"
 #include "network/postgres/statement_cache.h"
 #include "network/protocol_interpreter.h"
+#include "traffic_cop/bulk_copy.h"
 
 namespace terrier::network {
 
-constexpr uint32_t INITIAL_BACKOFF_TIME = 2;
-constexpr uint32_t BACKOFF_FACTOR = 2;
-constexpr uint32_t MAX_BACKOFF_TIME = 20;
-
 /**
  * Interprets the network protocol for postgres clients. Any state/logic that is Postgres protocol-specific should live
  * at this layer.
@@ -36,27 +35,38 @@ class PostgresProtocolInterpreter : public ProtocolInterpreter {
     /**
      * Constructs a new provider
      * @param command_factory The command factory to use for the constructed protocol interpreters
+     * @param execution_pool The workers to run the commands of the constructed protocol interpreters, nullptr to run
+     * them on the connection handler threads
+     * @param statement_cache_size The number of statements that each constructed protocol interpreter caches
      */
-    explicit Provider(common::ManagedPointer<PostgresCommandFactory> command_factory)
-        : command_factory_(command_factory) {}
+    Provider(common::ManagedPointer<PostgresCommandFactory> command_factory,
+             common::ManagedPointer<ExecutionPool> execution_pool, size_t statement_cache_size)
+        : command_factory_(command_factory),
+          execution_pool_(execution_pool),
+          statement_cache_size_(statement_cache_size) {}
 
     /**
      * @return an instance of the protocol interpreter
      */
     std::unique_ptr<ProtocolInterpreter> Get() override {
-      return std::make_unique<PostgresProtocolInterpreter>(command_factory_);
+      return std::make_unique<PostgresProtocolInterpreter>(command_factory_, execution_pool_, statement_cache_size_);
     }
 
    private:
     common::ManagedPointer<PostgresCommandFactory> command_factory_;
+    common::ManagedPointer<ExecutionPool> execution_pool_;
+    size_t statement_cache_size_;
   };
 
   /**
    * Creates the interpreter for Postgres
    * @param command_factory to convert packet into commands
+   * @param execution_pool workers to run the commands that execute queries, nullptr to run them in Process
+   * @param statement_cache_size maximum number of statements cached once nothing refers to them anymore
    */
-  explicit PostgresProtocolInterpreter(common::ManagedPointer<PostgresCommandFactory> command_factory)
-      : command_factory_(command_factory) {}
+  PostgresProtocolInterpreter(common::ManagedPointer<PostgresCommandFactory> command_factory,
+                              common::ManagedPointer<ExecutionPool> execution_pool, size_t statement_cache_size)
+      : command_factory_(command_factory), execution_pool_(execution_pool), cache_(statement_cache_size) {}
 
   /**
    * @see ProtocolIntepreter::Process
@@ -81,22 +91,24 @@ class PostgresProtocolInterpreter : public ProtocolInterpreter {
                 common::ManagedPointer<trafficcop::TrafficCop> t_cop,
                 common::ManagedPointer<ConnectionContext> context) override;
 
-  // TODO(Tianyu): Fill in the following documentation at some point
   /**
-   * (Matt): I think this was used in Peloton for asynchronous execution, after a callback wakeup the ConnectionHandle
-   * would call to the protocol interpreter to get the state of the asynchronous query after the output was already
-   * complete.
-   * @param out
+   * Finishes the commands that Process handed off to the execution workers, after their worker woke the connection
+   * up. The worker already wrote the results of the commands.
+   * @param out buffer the results were written to
+   * @return the transition returned by the last command
    */
-  void GetResult(const common::ManagedPointer<WriteQueue> out) override {}
+  Transition GetResult(common::ManagedPointer<WriteQueue> out) override;
 
   /**
-   * Used to clear the waiting for sync, explicit txn block, and portals. Call whenever a transaction is ended.
+   * Used to clear the waiting for sync, explicit txn block, portals, and COPY in progress. Call whenever a transaction
+   * is ended. The portals are recycled for the Binds of the following transactions.
    */
   void ResetTransactionState() {
     waiting_for_sync_ = false;
     explicit_txn_block_ = false;
+    for (auto &portal : portals_) RecyclePortal(std::move(portal.second));
     portals_.clear();
+    copy_in_.reset();
   }
 
   /**
@@ -148,6 +160,31 @@ class PostgresProtocolInterpreter : public ProtocolInterpreter {
     waiting_for_sync_ = false;
   }
 
+  /**
+   * @return the COPY ... FROM STDIN whose data the client is sending, nullptr if there is none
+   */
+  common::ManagedPointer<trafficcop::CopyIn> GetCopyIn() const { return common::ManagedPointer(copy_in_); }
+
+  /**
+   * Enters the copy-in mode of the protocol, in which the client sends the data of a COPY ... FROM STDIN
+   * @param copy_in the load the data is fed to
+   */
+  void SetCopyIn(std::unique_ptr<trafficcop::CopyIn> copy_in) { copy_in_ = std::move(copy_in); }
+
+  /**
+   * Leaves the copy-in mode and ends the Simple Query of the COPY. Writes the result of the COPY, ends the transaction
+   * unless it is in an explicit transaction block, and tells the client that it is ready for the next query.
+   * @param out packet writer for the results
+   * @param t_cop traffic cop to end the transaction with
+   * @param connection context of the connection
+   * @param result the number of rows loaded, or the error that ended the COPY
+   * @return transition::PROCEED
+   */
+  Transition FinishCopyIn(common::ManagedPointer<PostgresPacketWriter> out,
+                          common::ManagedPointer<trafficcop::TrafficCop> t_cop,
+                          common::ManagedPointer<ConnectionContext> connection,
+                          const trafficcop::TrafficCopResult &result);
+
   /**
    * @param name statement to look up
    * @return managed pointer to statement if it exists, nullptr otherwise
@@ -167,16 +204,19 @@ class PostgresProtocolInterpreter : public ProtocolInterpreter {
    * @param query_text key to look up
    * @return Statement if it exists in the cache, otherwise nullptr
    */
-  common::ManagedPointer<network::Statement> LookupStatementInCache(const std::string &query_text) const {
+  common::ManagedPointer<network::Statement> LookupStatementInCache(const std::string &query_text) {
     return cache_.Lookup(query_text);
   }
 
   /**
    * @param name key
-   * @param statement statement to create a mapping to for this name
+   * @param statement cached statement to create a mapping to for this name
    */
   void SetStatement(const std::string &name, const common::ManagedPointer<network::Statement> statement) {
-    statements_[name] = statement;
+    cache_.Pin(statement);
+    auto &named_statement = statements_[name];
+    if (named_statement != nullptr) cache_.Unpin(named_statement);
+    named_statement = statement;
   }
 
   /**
@@ -188,6 +228,7 @@ class PostgresProtocolInterpreter : public ProtocolInterpreter {
     const auto it = statements_.find(name);
     if (it != statements_.end()) {
       ClosePortalsConstructedFromStatement(common::ManagedPointer(it->second));
+      cache_.Unpin(it->second);
       statements_.erase(it);
     }
   }
@@ -203,18 +244,68 @@ class PostgresProtocolInterpreter : public ProtocolInterpreter {
   }
 
   /**
+   * @return vector for a Bind message to read its params into, which the portal it binds takes over
+   */
+  common::ManagedPointer<std::vector<parser::ConstantValueExpression>> BindParams() {
+    return common::ManagedPointer(&bind_params_);
+  }
+
+  /**
+   * @return vector for a Bind message to read its parameter formats into
+   */
+  common::ManagedPointer<std::vector<FieldFormat>> BindParamFormats() {
+    return common::ManagedPointer(&bind_param_formats_);
+  }
+
+  /**
+   * @return vector for a Bind message to read its output formats into, which the portal it binds takes over
+   */
+  common::ManagedPointer<std::vector<FieldFormat>> BindResultFormats() {
+    return common::ManagedPointer(&bind_result_formats_);
+  }
+
+  /**
+   * Binds a portal to a statement with the params and output formats that were read into BindParams and
+   * BindResultFormats. A portal that is bound again is reused rather than replaced, e.g., the unnamed portal of a
+   * client that pipelines Bind/Execute pairs for a batch of rows, and new portals are taken from the ones recycled at
+   * the end of previous transactions. The vectors of the params and output formats are swapped with the ones of the
+   * portal, so that their memory is reused by the next Bind.
    * @param name key
-   * @param portal portal to take ownership of
+   * @param statement cached statement that the portal refers to
+   * @return true if a portal had to be allocated, false if one was reused
    */
-  void SetPortal(const std::string &name, std::unique_ptr<network::Portal> &&portal) {
-    portals_[name] = std::move(portal);
+  bool BindPortal(const std::string &name, const common::ManagedPointer<network::Statement> statement) {
+    auto &portal = portals_[name];
+    if (portal != nullptr && portal->GetStatement() == statement) {
+      portal->Rebind(BindParams(), BindResultFormats());
+      return false;
+    }
+
+    cache_.Pin(statement);
+    if (portal != nullptr) cache_.Unpin(portal->GetStatement());
+    const bool allocated = portal == nullptr && free_portals_.empty();
+    if (allocated) {
+      portal = std::make_unique<Portal>(statement, std::vector<parser::ConstantValueExpression>{},
+                                        std::vector<FieldFormat>{});
+    } else if (portal == nullptr) {
+      portal = std::move(free_portals_.back());
+      free_portals_.pop_back();
+    }
+    portal->Rebind(statement, BindParams(), BindResultFormats());
+    return allocated;
   }
 
   /**
    * close a Portal. We don't care about return value since it's not an error to call Close on non-existent portal
    * @param name portal to be removed
    */
-  void ClosePortal(const std::string &name) { portals_.erase(name); }
+  void ClosePortal(const std::string &name) {
+    const auto it = portals_.find(name);
+    if (it != portals_.end()) {
+      RecyclePortal(std::move(it->second));
+      portals_.erase(it);
+    }
+  }
 
  protected:
   /**
@@ -230,20 +321,49 @@ class PostgresProtocolInterpreter : public ProtocolInterpreter {
   void SetPacketMessageType(common::ManagedPointer<ReadBuffer> in) override;
 
  private:
+  /**
+   * Runs the command of the current packet, once the startup is done
+   * @param out buffer to send results back out on
+   * @param t_cop non-owning pointer to the traffic cop to pass down to the command layer
+   * @param context connection-specific (not protocol) state
+   * @return next transition for ConnectionHandle's state machine
+   */
+  Transition ProcessPacket(common::ManagedPointer<WriteQueue> out, common::ManagedPointer<trafficcop::TrafficCop> t_cop,
+                           common::ManagedPointer<ConnectionContext> context);
+
+  // maximum number of closed portals kept for the following Binds
+  static constexpr size_t MAX_FREE_PORTALS = 16;
+
   bool startup_ = true;
   bool waiting_for_sync_ = false;
   bool explicit_txn_block_ = false;
 
   common::ManagedPointer<PostgresCommandFactory> command_factory_;
+  common::ManagedPointer<ExecutionPool> execution_pool_;
+
+  // whether the packets are being processed by an execution worker, and their last transition once it is done
+  bool pending_ = false;
+  Transition pending_result_ = Transition::NONE;
 
   StatementCache cache_;
 
+  // Vectors that the Bind messages read into, which keep the memory of the portals' previous params and output formats
+  std::vector<parser::ConstantValueExpression> bind_params_;
+  std::vector<FieldFormat> bind_param_formats_;
+  std::vector<FieldFormat> bind_result_formats_;
+
   // name to statement
   std::unordered_map<std::string, common::ManagedPointer<network::Statement>> statements_;
 
   // name to portal
   std::unordered_map<std::string, std::unique_ptr<network::Portal>> portals_;
 
+  // closed portals kept for the following Binds
+  std::vector<std::unique_ptr<network::Portal>> free_portals_;
+
+  // the COPY ... FROM STDIN in progress
+  std::unique_ptr<trafficcop::CopyIn> copy_in_;
+
   /**
    * close all Portals constructed from a Statement. We don't care about return value since it's not an error to call
    * Close on non-existent statement
@@ -252,12 +372,25 @@ class PostgresProtocolInterpreter : public ProtocolInterpreter {
   void ClosePortalsConstructedFromStatement(const common::ManagedPointer<Statement> statement) {
     for (auto it = portals_.begin(); it != portals_.end();) {
       if (it->second->GetStatement() == statement) {
+        RecyclePortal(std::move(it->second));
         it = portals_.erase(it);
       } else {
         it++;
       }
     }
   }
+
+  /**
+   * Releases the statement of a closed portal and keeps the portal for the following Binds, unless enough are kept
+   * @param portal closed portal
+   */
+  void RecyclePortal(std::unique_ptr<network::Portal> &&portal) {
+    cache_.Unpin(portal->GetStatement());
+    if (free_portals_.size() < MAX_FREE_PORTALS) {
+      portal->Recycle();
+      free_portals_.emplace_back(std::move(portal));
+    }
+  }
 };
 
 }  // namespace terrier::network
@@ -10,6 +10,8 @@
 #include "network/postgres/statement.h"
 #include "parser/postgresparser.h"
 #include "planner/plannodes/abstract_plan_node.h"
+#include "traffic_cop/plan_cache.h"
+#include "traffic_cop/point_query.h"
 #include "traffic_cop/traffic_cop_util.h"
 #include "type/type_id.h"
 
@@ -21,9 +23,11 @@ namespace terrier::network {
  * It owns the original query text that came across in the message parsed statement, the output from the Parser, and the
  * parameter types (if any).
  *
- * For caching purposes, it also takes ownership of the physical plan and the ExecutableQuery after code generation.
+ * For caching purposes, it also holds on to the physical plan and the ExecutableQuery after code generation.
  * This allows for a single fingerprint to reference this prepared statement be bound and executed with different
- * parameters multiple times.
+ * parameters multiple times. The plan and the ExecutableQuery may be shared with other statements of the same text
+ * through the server-wide PlanCache. Point queries (see PointQuery) skip optimization and code generation, and hold on
+ * to their PointQuery instead.
  */
 class Statement {
  public:
@@ -80,14 +84,45 @@ class Statement {
    * @return the optimized physical plan for this query
    */
   common::ManagedPointer<planner::AbstractPlanNode> PhysicalPlan() const {
-    return common::ManagedPointer(physical_plan_);
+    return common::ManagedPointer(physical_plan_.get());
   }
 
   /**
    * @return the compiled executable query
    */
   common::ManagedPointer<execution::compiler::ExecutableQuery> GetExecutableQuery() const {
-    return common::ManagedPointer(executable_query_);
+    return common::ManagedPointer(executable_query_.get());
+  }
+
+  /**
+   * @return the point query this statement runs as, nullptr if it goes through optimization and code generation
+   */
+  common::ManagedPointer<trafficcop::PointQuery> GetPointQuery() const {
+    return common::ManagedPointer(point_query_.get());
+  }
+
+  /**
+   * @param point_query point query recognized after binding this statement, or nullptr
+   */
+  void SetPointQuery(std::shared_ptr<trafficcop::PointQuery> point_query) { point_query_ = std::move(point_query); }
+
+  /**
+   * @return the schema of the rows this query outputs, from its point query or its physical plan
+   */
+  common::ManagedPointer<planner::OutputSchema> GetOutputSchema() const {
+    return point_query_ != nullptr ? point_query_->GetOutputSchema() : physical_plan_->GetOutputSchema();
+  }
+
+  /**
+   * @return the optimized physical plan for this query, to be shared through the PlanCache
+   */
+  const std::shared_ptr<planner::AbstractPlanNode> &SharedPhysicalPlan() const { return physical_plan_; }
+
+  /**
+   * @return the compiled executable query, to be shared through the PlanCache
+   */
+  const std::shared_ptr<execution::compiler::ExecutableQuery> &SharedExecutableQuery() const {
+    return executable_query_;
   }
 
   /**
@@ -104,6 +139,34 @@ class Statement {
     executable_query_ = std::move(executable_query);
   }
 
+  /**
+   * @return the plan shared through the PlanCache that this statement uses, nullptr if its plan is its own
+   */
+  const std::shared_ptr<trafficcop::CachedPlan> &GetCachedPlan() const { return cached_plan_; }
+
+  /**
+   * Use a plan from the PlanCache, instead of binding, optimizing and compiling this statement
+   * @param cached_plan plan shared by all statements with the same query text
+   */
+  void SetCachedPlan(std::shared_ptr<trafficcop::CachedPlan> cached_plan) {
+    physical_plan_ = cached_plan->GetPhysicalPlan();
+    executable_query_ = cached_plan->GetExecutableQuery();
+    point_query_ = cached_plan->GetPointQuery();
+    desired_param_types_ = cached_plan->GetDesiredParamTypes();
+    cached_plan_ = std::move(cached_plan);
+  }
+
+  /**
+   * @return generation of the PlanCache before this statement was bound, a plan generated for it may only be cached
+   * if it's still the same
+   */
+  uint64_t GetPlanCacheGeneration() const { return plan_cache_generation_; }
+
+  /**
+   * @param plan_cache_generation generation of the PlanCache before this statement is bound
+   */
+  void SetPlanCacheGeneration(const uint64_t plan_cache_generation) { plan_cache_generation_ = plan_cache_generation; }
+
   /**
    * Stash desired parameter types to avoid having to do a full binding pass for prepared statements
    * @param desired_param_types output from the binder if Statement has parameters to fast-path convert for future
@@ -126,8 +189,10 @@ class Statement {
    * DDL change related to this statement.
    */
   void ClearCachedObjects() {
-    physical_plan_ = nullptr;
+    cached_plan_ = nullptr;
+    point_query_ = nullptr;
     executable_query_ = nullptr;
+    physical_plan_ = nullptr;
     desired_param_types_ = {};
   }
 
@@ -141,9 +206,13 @@ class Statement {
   // The following objects can be "cached" in Statement objects for future statement invocations. Though they don't
   // relate to the Postgres Statement concept, these objects should be compatible with future queries that match the
   // same query text. The exception to this that DDL changes can break these cached objects.
-  std::unique_ptr<planner::AbstractPlanNode> physical_plan_ = nullptr;                // generated in the Bind phase
-  std::unique_ptr<execution::compiler::ExecutableQuery> executable_query_ = nullptr;  // generated in the Execute phase
+  // The executable query refers to the plan, so it is declared after it, and destroyed first.
+  std::shared_ptr<planner::AbstractPlanNode> physical_plan_ = nullptr;                // generated in the Bind phase
+  std::shared_ptr<execution::compiler::ExecutableQuery> executable_query_ = nullptr;  // generated in the Execute phase
+  std::shared_ptr<trafficcop::PointQuery> point_query_ = nullptr;                    // generated in the Bind phase
   std::vector<type::TypeId> desired_param_types_;                                     // generated in the Bind phase
+  std::shared_ptr<trafficcop::CachedPlan> cached_plan_ = nullptr;  // adopted or published in the Bind/Execute phase
+  uint64_t plan_cache_generation_ = 0;                              // taken in the Bind phase
 };
 
 }  // namespace terrier::network
@@ -1,10 +1,13 @@
 #pragma once
 
+#include <list>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <utility>
 
+#include "common/macros.h"
 #include "common/managed_pointer.h"
 #include "network/postgres/statement.h"
 #include "xxHash/xxh3.h"
@@ -12,40 +15,102 @@
 namespace terrier::network {
 
 /**
- * Simple statement cache. It contains a map from query string to Statement objects, allowing for reuse of bound parser
- * result, physical plan, and codegen'd executable query if appropriate. Can be extended in the future to have a maximum
- * size, replacement policy, etc.
+ * Statement cache of a connection. It contains a map from query string to Statement objects, allowing for reuse of
+ * bound parser result, physical plan, and codegen'd executable query if appropriate.
+ *
+ * The cache holds at most a fixed number of statements and evicts the least recently used ones when it grows beyond
+ * that. Statements that a prepared statement name or a portal refers to are pinned and never evicted, so the cache
+ * may temporarily hold more statements than its capacity.
  */
 class StatementCache {
  public:
   /**
-   * Check if a Statement for a query string exists
+   * @param capacity maximum number of statements that are kept once nothing refers to them anymore
+   */
+  explicit StatementCache(const size_t capacity) : capacity_(capacity) {}
+
+  DISALLOW_COPY_AND_MOVE(StatementCache)
+
+  /**
+   * Check if a Statement for a query string exists, and mark it as the most recently used one if it does
    * @param query_text key to look up
    * @return pointer to Statement object if it already exists, nullptr otherwise
    */
-  common::ManagedPointer<Statement> Lookup(const std::string &query_text) const {
-    const auto it = cache_.find(query_text);
-    if (it != cache_.end()) return common::ManagedPointer(it->second);
-    return nullptr;
+  common::ManagedPointer<Statement> Lookup(const std::string &query_text) {
+    const auto it = index_.find(query_text);
+    if (it == index_.end()) return nullptr;
+    entries_.splice(entries_.begin(), entries_, it->second);
+    return common::ManagedPointer(it->second->statement_);
   }
 
   /**
-   * Transfer ownership of a Statement to the cache
+   * Transfer ownership of a Statement to the cache, evicting the least recently used statements that are not pinned if
+   * the cache is full
    * @param statement object to take ownership of
    */
   void Add(std::unique_ptr<network::Statement> &&statement) {
-    cache_[statement->GetQueryText()] = std::move(statement);
+    TERRIER_ASSERT(index_.count(statement->GetQueryText()) == 0, "Statement is already cached.");
+    entries_.emplace_front(std::move(statement));
+    // The key refers to the query text of the statement, which lives as long as the entry
+    index_.emplace(entries_.front().statement_->GetQueryText(), entries_.begin());
+    Evict();
+  }
+
+  /**
+   * Protect a cached statement from eviction while a prepared statement name or a portal refers to it
+   * @param statement statement that is referred to
+   */
+  void Pin(const common::ManagedPointer<Statement> statement) { FindEntry(statement)->pins_++; }
+
+  /**
+   * Release a reference that protected a cached statement from eviction
+   * @param statement statement that is not referred to anymore
+   */
+  void Unpin(const common::ManagedPointer<Statement> statement) {
+    auto entry = FindEntry(statement);
+    TERRIER_ASSERT(entry->pins_ > 0, "Statement is not pinned.");
+    entry->pins_--;
   }
 
+  /**
+   * @return number of statements in the cache
+   */
+  size_t Size() const { return entries_.size(); }
+
  private:
   /**
    * We'll use xxHash for the keys since it's a fast hash algorithm for strings.
    */
   struct FastStringHasher {
-    std::size_t operator()(const std::string &key) const { return XXH3_64bits(key.data(), key.length()); }
+    std::size_t operator()(const std::string_view key) const { return XXH3_64bits(key.data(), key.length()); }
+  };
+
+  struct Entry {
+    explicit Entry(std::unique_ptr<Statement> &&statement) : statement_(std::move(statement)) {}
+    std::unique_ptr<Statement> statement_;
+    uint32_t pins_ = 0;
   };
 
-  std::unordered_map<std::string, std::unique_ptr<Statement>, FastStringHasher> cache_;
+  std::list<Entry>::iterator FindEntry(const common::ManagedPointer<Statement> statement) {
+    const auto it = index_.find(statement->GetQueryText());
+    TERRIER_ASSERT(it != index_.end() && it->second->statement_.get() == statement.Get(), "Statement is not cached.");
+    return it->second;
+  }
+
+  void Evict() {
+    // The statement that was just added is the most recently used one, and is never evicted
+    auto it = entries_.end();
+    while (entries_.size() > capacity_ && --it != entries_.begin()) {
+      if (it->pins_ > 0) continue;
+      index_.erase(it->statement_->GetQueryText());
+      it = entries_.erase(it);
+    }
+  }
+
+  const size_t capacity_;
+  // most recently used statement first
+  std::list<Entry> entries_;
+  std::unordered_map<std::string_view, std::list<Entry>::iterator, FastStringHasher> index_;
 };
 
 }  // namespace terrier::network
@@ -57,10 +57,11 @@ class ProtocolInterpreter {
                         common::ManagedPointer<ConnectionContext> context) = 0;
 
   /**
-   * Sends a result
+   * Sends a result, once the connection is woken up after Process returned NEED_RESULT
    * @param out The WriteQueue to communicate with the client through
+   * @return The next transition for the client's associated state machine
    */
-  virtual void GetResult(common::ManagedPointer<WriteQueue> out) = 0;
+  virtual Transition GetResult(common::ManagedPointer<WriteQueue> out) = 0;
 
   /**
    * Default destructor for ProtocolInterpreter
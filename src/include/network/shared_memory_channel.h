@@ -0,0 +1,134 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "common/macros.h"
+#include "common/strong_typedef.h"
+
+namespace terrier::network {
+
+/**
+ * A pair of ring buffers in a shared memory segment, through which the server and a client on the same host exchange
+ * the bytes of the protocol instead of through their Unix domain socket. The server creates the segment and sends its
+ * file descriptor to the client over the socket.
+ *
+ * Each ring has a single producer and a single consumer. An endpoint that finds its inbound ring empty, or its
+ * outbound ring full, announces that it is going to sleep on the socket. Its peer writes a byte to the socket to wake
+ * it up once it made progress, so no byte goes through the socket while both endpoints keep busy.
+ */
+class SharedMemoryChannel {
+ public:
+  DISALLOW_COPY_AND_MOVE(SharedMemoryChannel);
+
+  /**
+   * Creates a new segment, the server's end of the channel
+   * @param ring_size size of each of the rings in bytes, rounded up to a power of two
+   * @return the channel, nullptr if the segment could not be created
+   */
+  static std::unique_ptr<SharedMemoryChannel> Create(uint32_t ring_size);
+
+  /**
+   * Maps a segment that the server created, the client's end of the channel
+   * @param fd file descriptor of the segment, which the channel takes ownership of
+   * @return the channel, nullptr if fd is not a segment of a channel
+   */
+  static std::unique_ptr<SharedMemoryChannel> Attach(int fd);
+
+  /**
+   * Unmaps the segment, which is destroyed once both ends are gone
+   */
+  ~SharedMemoryChannel();
+
+  /**
+   * @return file descriptor of the segment
+   */
+  int GetFd() const { return fd_; }
+
+  /**
+   * @return size of each of the rings in bytes
+   */
+  uint32_t RingSize() const { return ring_size_; }
+
+  /**
+   * Takes as many bytes as possible that the peer sent
+   * @param dest where to copy the bytes to
+   * @param size maximum number of bytes to take
+   * @return number of bytes taken, 0 if the inbound ring is empty
+   * @throw NetworkProcessException if the peer corrupted the counters of the ring
+   */
+  size_t Receive(void *dest, size_t size);
+
+  /**
+   * Sends as many bytes as the outbound ring has room for
+   * @param src bytes to send
+   * @param size number of bytes to send
+   * @return number of bytes sent, 0 if the outbound ring is full
+   * @throw NetworkProcessException if the peer corrupted the counters of the ring
+   */
+  size_t Send(const void *src, size_t size);
+
+  /**
+   * Announces that this end sleeps until the peer sends something
+   * @return true if the end may sleep, false if bytes arrived in the meantime
+   */
+  bool PrepareToWaitForData();
+
+  /**
+   * Announces that this end sleeps until the peer makes room in the outbound ring
+   * @return true if the end may sleep, false if room was made in the meantime
+   */
+  bool PrepareToWaitForSpace();
+
+  /**
+   * Checks whether the peer sleeps although it can make progress now, after this end sent or received bytes. The
+   * caller then has to wake the peer up.
+   * @return true if the peer has to be woken up
+   */
+  bool PeerWaiting();
+
+ private:
+  FRIEND_TEST(SharedMemoryChannelTests, CorruptCountersTest);
+
+  // The state of a ring, each of the counters on its own cache line
+  struct Ring {
+    // Total number of bytes received
+    alignas(64) std::atomic<uint64_t> head_;
+    // Total number of bytes sent
+    alignas(64) std::atomic<uint64_t> tail_;
+    // Whether the receiver sleeps until bytes are sent
+    alignas(64) std::atomic<bool> receiver_waiting_;
+    // Whether the sender sleeps until bytes are received
+    std::atomic<bool> sender_waiting_;
+  };
+
+  // The beginning of a segment, which is followed by the bytes of the client's ring and then of the server's ring
+  struct Header {
+    uint64_t magic_;
+    uint32_t ring_size_;
+    Ring rings_[2];
+  };
+
+  static constexpr uint64_t MAGIC = 0x746572726965726dULL;
+
+  SharedMemoryChannel(int fd, void *segment, uint32_t ring_size, bool server);
+
+  static size_t SegmentSize(uint32_t ring_size) { return sizeof(Header) + 2 * static_cast<size_t>(ring_size); }
+
+  // The peer can write anything to the counters, so they are checked to hold no more bytes than fit into the ring
+  void CheckCounters(uint64_t head, uint64_t tail) const;
+
+  const int fd_;
+  void *const segment_;
+  const uint32_t ring_size_;
+  // The ring this end receives from and its bytes
+  Ring *const in_;
+  byte *const in_bytes_;
+  // The ring this end sends to and its bytes
+  Ring *const out_;
+  byte *const out_bytes_;
+};
+
+}  // namespace terrier::network
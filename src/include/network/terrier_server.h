@@ -22,6 +22,7 @@
 #include "common/notifiable_task.h"
 #include "network/connection_dispatcher_task.h"
 #include "network/connection_handle_factory.h"
+#include "network/execution_pool.h"
 #include "network/network_types.h"
 
 namespace terrier::network {
@@ -38,11 +39,14 @@ class TerrierServer : public common::DedicatedThreadOwner {
  public:
   /**
    * @brief Constructs a new TerrierServer instance.
+   * @param execution_pool the workers that run the commands of the clients, nullptr to run them on the connection
+   * handler threads. The server starts and stops the pool along with itself.
    */
   TerrierServer(common::ManagedPointer<ProtocolInterpreter::Provider> protocol_provider,
                 common::ManagedPointer<ConnectionHandleFactory> connection_handle_factory,
                 common::ManagedPointer<common::DedicatedThreadRegistry> thread_registry, uint16_t port,
-                uint16_t connection_thread_count, std::string socket_directory);
+                uint16_t connection_thread_count, std::string socket_directory,
+                common::ManagedPointer<ExecutionPool> execution_pool);
 
   ~TerrierServer() override = default;
 
@@ -104,5 +108,6 @@ class TerrierServer : public common::DedicatedThreadOwner {
   common::ManagedPointer<ConnectionHandleFactory> connection_handle_factory_;
   common::ManagedPointer<ProtocolInterpreter::Provider> provider_;
   common::ManagedPointer<ConnectionDispatcherTask> dispatcher_task_;
+  common::ManagedPointer<ExecutionPool> execution_pool_;
 };
 }  // namespace terrier::network
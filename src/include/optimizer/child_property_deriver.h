@@ -140,6 +140,12 @@ class ChildPropertyDeriver : public OperatorVisitor {
    */
   void Visit(const OuterHashJoin *op) override;
 
+  /**
+   * Visitor function for InnerMergeJoin
+   * @param op InnerMergeJoin operator to visit
+   */
+  void Visit(const InnerMergeJoin *op) override;
+
   /**
    * Visitor function for Insert
    * @param op Insert operator to visit
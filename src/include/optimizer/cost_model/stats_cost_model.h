@@ -0,0 +1,249 @@
+#pragma once
+
+#include "catalog/catalog_defs.h"
+#include "common/macros.h"
+#include "common/managed_pointer.h"
+#include "optimizer/cost_model/abstract_cost_model.h"
+#include "optimizer/optimizer_defs.h"
+
+namespace terrier::optimizer {
+
+class Memo;
+class GroupExpression;
+class StatsStorage;
+
+/**
+ * A cost model based on the cardinalities estimated from table statistics. The cost of an operator is the CPU time
+ * it spends on its input and output rows, plus the memory it needs to materialize rows in hash tables or sort buffers,
+ * both in units of the time it takes to produce a single row.
+ *
+ * The number of rows of a group comes from the stats derived for it (see StatsCalculator), the size of a base table
+ * from its TableStats. Without stats, tables are assumed to have DEFAULT_NUM_ROWS rows, and every predicate to keep
+ * DEFAULT_SELECTIVITY of them, which still favors index scans over sequential scans for selective predicates.
+ *
+ * Hash joins build a hash table over their left input and probe it with their right one, so commuting a hash join
+ * changes its cost. Merge joins and sort-based aggregations do not sort their inputs themselves, the cost of the sort
+ * enforced below them is added by the optimizer.
+ */
+class StatsCostModel : public AbstractCostModel {
+ public:
+  /** The cost of producing a row. */
+  static constexpr double TUPLE_CPU_COST = 1.0;
+
+  /** The cost of evaluating a predicate on a row. */
+  static constexpr double PREDICATE_CPU_COST = 0.25;
+
+  /** The additional cost of reading a row through an index. */
+  static constexpr double INDEX_TUPLE_CPU_COST = 0.5;
+
+  /** The cost of descending one level of an index. */
+  static constexpr double INDEX_PROBE_CPU_COST = 2.0;
+
+  /** The cost of inserting a row into a hash table. */
+  static constexpr double HASH_BUILD_CPU_COST = 2.0;
+
+  /** The cost of probing a hash table with a row. */
+  static constexpr double HASH_PROBE_CPU_COST = 1.0;
+
+  /** The cost of comparing two rows. */
+  static constexpr double COMPARE_CPU_COST = 0.5;
+
+  /** The cost of keeping a row in memory, in a hash table or a sort buffer. */
+  static constexpr double MEMORY_TUPLE_COST = 0.5;
+
+  /** The number of rows of a table without stats. */
+  static constexpr double DEFAULT_NUM_ROWS = 1000;
+
+  /** The fraction of rows kept by a predicate without stats. */
+  static constexpr double DEFAULT_SELECTIVITY = 0.1;
+
+  /**
+   * Constructor
+   * @param stats_storage StatsStorage holding the stats of the base tables
+   * @param db_oid database the costed queries run in
+   */
+  StatsCostModel(common::ManagedPointer<StatsStorage> stats_storage, catalog::db_oid_t db_oid)
+      : stats_storage_(stats_storage), db_oid_(db_oid) {}
+
+  /**
+   * Costs a GroupExpression
+   * @param txn TransactionContext that query is generated under
+   * @param accessor CatalogAccessor
+   * @param memo Memo object containing all relevant groups
+   * @param gexpr GroupExpression to calculate cost for
+   */
+  double CalculateCost(transaction::TransactionContext *txn, catalog::CatalogAccessor *accessor, Memo *memo,
+                       GroupExpression *gexpr) override;
+
+  /**
+   * Visit a SeqScan operator
+   * @param op operator
+   */
+  void Visit(const SeqScan *op) override;
+
+  /**
+   * Visit a IndexScan operator
+   * @param op operator
+   */
+  void Visit(const IndexScan *op) override;
+
+  /**
+   * Visit a QueryDerivedScan operator
+   * @param op operator
+   */
+  void Visit(UNUSED_ATTRIBUTE const QueryDerivedScan *op) override { output_cost_ = 0.f; }
+
+  /**
+   * Visit a OrderBy operator
+   * @param op operator
+   */
+  void Visit(const OrderBy *op) override;
+
+  /**
+   * Visit a Limit operator
+   * @param op operator
+   */
+  void Visit(const Limit *op) override;
+
+  /**
+   * Visit a InnerIndexJoin operator
+   * @param op operator
+   */
+  void Visit(const InnerIndexJoin *op) override;
+
+  /**
+   * Visit a InnerNLJoin operator
+   * @param op operator
+   */
+  void Visit(const InnerNLJoin *op) override;
+
+  /**
+   * Visit a LeftNLJoin operator
+   * @param op operator
+   */
+  void Visit(UNUSED_ATTRIBUTE const LeftNLJoin *op) override { CostNLJoin(1); }
+
+  /**
+   * Visit a RightNLJoin operator
+   * @param op operator
+   */
+  void Visit(UNUSED_ATTRIBUTE const RightNLJoin *op) override { CostNLJoin(1); }
+
+  /**
+   * Visit a OuterNLJoin operator
+   * @param op operator
+   */
+  void Visit(UNUSED_ATTRIBUTE const OuterNLJoin *op) override { CostNLJoin(1); }
+
+  /**
+   * Visit a InnerHashJoin operator
+   * @param op operator
+   */
+  void Visit(UNUSED_ATTRIBUTE const InnerHashJoin *op) override { CostHashJoin(); }
+
+  /**
+   * Visit a InnerMergeJoin operator
+   * @param op operator
+   */
+  void Visit(const InnerMergeJoin *op) override;
+
+  /**
+   * Visit a LeftHashJoin operator
+   * @param op operator
+   */
+  void Visit(UNUSED_ATTRIBUTE const LeftHashJoin *op) override { CostHashJoin(); }
+
+  /**
+   * Visit a RightHashJoin operator
+   * @param op operator
+   */
+  void Visit(UNUSED_ATTRIBUTE const RightHashJoin *op) override { CostHashJoin(); }
+
+  /**
+   * Visit a OuterHashJoin operator
+   * @param op operator
+   */
+  void Visit(UNUSED_ATTRIBUTE const OuterHashJoin *op) override { CostHashJoin(); }
+
+  /**
+   * Visit a HashGroupBy operator
+   * @param op operator
+   */
+  void Visit(const HashGroupBy *op) override;
+
+  /**
+   * Visit a SortGroupBy operator
+   * @param op operator
+   */
+  void Visit(const SortGroupBy *op) override;
+
+  /**
+   * Visit a Aggregate operator
+   * @param op operator
+   */
+  void Visit(UNUSED_ATTRIBUTE const Aggregate *op) override { output_cost_ = GetChildRows(0) * TUPLE_CPU_COST; }
+
+ private:
+  /**
+   * @param group_id ID of the group
+   * @returns the estimated number of rows of the group, or -1 if no stats were derived for it
+   */
+  double GetNumRows(group_id_t group_id) const;
+
+  /**
+   * @param idx index of the child
+   * @returns the estimated number of rows of the given child of the costed GroupExpression
+   */
+  double GetChildRows(int idx) const;
+
+  /**
+   * @param table_oid the table
+   * @returns the number of rows of the table
+   */
+  double GetTableRows(catalog::table_oid_t table_oid) const;
+
+  /**
+   * @param table_rows the number of rows of the scanned table
+   * @param num_predicates the number of predicates of the scan
+   * @returns the estimated number of rows the costed scan produces
+   */
+  double GetScanRows(double table_rows, size_t num_predicates) const;
+
+  /**
+   * Cost a nested loop join, which evaluates its predicates on every pair of rows
+   * @param num_predicates the number of join predicates
+   */
+  void CostNLJoin(size_t num_predicates);
+
+  /**
+   * Cost a hash join, which builds a hash table over its left input and probes it with its right one
+   */
+  void CostHashJoin();
+
+  /**
+   * StatsStorage holding the stats of the base tables
+   */
+  common::ManagedPointer<StatsStorage> stats_storage_;
+
+  /**
+   * Database the costed queries run in
+   */
+  catalog::db_oid_t db_oid_;
+
+  /**
+   * GroupExpression to cost
+   */
+  GroupExpression *gexpr_;
+
+  /**
+   * Memo table to use
+   */
+  Memo *memo_;
+
+  /**
+   * Computed output cost
+   */
+  double output_cost_ = 0;
+};
+
+}  // namespace terrier::optimizer
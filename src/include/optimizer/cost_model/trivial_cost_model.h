@@ -108,6 +108,13 @@ class TrivialCostModel : public AbstractCostModel {
    */
   void Visit(UNUSED_ATTRIBUTE const InnerHashJoin *op) override { output_cost_ = NLJOIN_COST + 1.0f; }
 
+  /**
+   * Visit a InnerMergeJoin operator. Priced above the hash join so that existing plans do not change until a
+   * cardinality-aware cost model can tell when both inputs are already sorted.
+   * @param op operator
+   */
+  void Visit(UNUSED_ATTRIBUTE const InnerMergeJoin *op) override { output_cost_ = NLJOIN_COST + 2.0f; }
+
   /**
    * Visit a LeftHashJoin operator
    * @param op operator
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "common/macros.h"
+
+namespace terrier::optimizer {
+
+/**
+ * Finds the cheapest order to join a cluster of relations connected by inner joins. Relations are identified by their
+ * index, sets of relations by a bitmask of their indexes.
+ *
+ * Up to a threshold, join orders are enumerated by dynamic programming over the connected subgraph/complement pairs of
+ * the join graph (DPccp, Moerkotte and Neumann, VLDB 2006). It considers every bushy join tree without cross products,
+ * but nothing more, so it runs in time proportional to the number of such pairs. Above the threshold, or if the join
+ * graph is not connected, relations are joined greedily, always picking the pair of subtrees with the smallest result.
+ *
+ * A plan is costed by the sum of the cardinalities of its intermediate results (C_out). The cardinality of a set of
+ * relations is the product of their cardinalities and the selectivities of the predicates between them.
+ */
+class JoinOrderEnumerator {
+ public:
+  /** The maximum number of relations in a cluster. */
+  static constexpr uint32_t MAX_RELATIONS = 64;
+
+  /** By default, clusters of more relations are ordered greedily. */
+  static constexpr uint32_t DEFAULT_DP_THRESHOLD = 12;
+
+  /**
+   * Create an enumerator.
+   * @param dp_threshold the maximum number of relations to enumerate by dynamic programming
+   */
+  explicit JoinOrderEnumerator(uint32_t dp_threshold = DEFAULT_DP_THRESHOLD) : dp_threshold_(dp_threshold) {}
+
+  /**
+   * This class cannot be copied or moved.
+   */
+  DISALLOW_COPY_AND_MOVE(JoinOrderEnumerator);
+
+  /**
+   * Add a relation.
+   * @param cardinality the estimated number of rows of the relation
+   * @return the index of the relation
+   */
+  uint32_t AddRelation(double cardinality);
+
+  /**
+   * Add a predicate. A predicate between two relations connects them in the join graph, one referring to more relations
+   * is only applied once all of them are joined.
+   * @param relations the relations the predicate refers to
+   * @param selectivity the estimated fraction of rows the predicate retains
+   */
+  void AddPredicate(uint64_t relations, double selectivity);
+
+  /**
+   * Find the cheapest join order of all relations.
+   * @return true if the order was found by dynamic programming, false if it was found greedily
+   */
+  bool Enumerate();
+
+  /** @return the set of all relations */
+  uint64_t GetAllRelations() const { return all_relations_; }
+
+  /**
+   * @param relations a set of relations joined by the chosen plan, at least two
+   * @return the relations of the left input of the join
+   */
+  uint64_t GetLeft(uint64_t relations) const { return plans_.at(relations).left_; }
+
+  /**
+   * @param relations a set of relations joined by the chosen plan, at least two
+   * @return the relations of the right input of the join
+   */
+  uint64_t GetRight(uint64_t relations) const { return plans_.at(relations).right_; }
+
+  /**
+   * @param relations a set of relations joined by the chosen plan
+   * @return the estimated cardinality of the join of the relations
+   */
+  double GetCardinality(uint64_t relations) const { return plans_.at(relations).cardinality_; }
+
+  /**
+   * @param relations a set of relations joined by the chosen plan
+   * @return the cost of the plan for the relations
+   */
+  double GetCost(uint64_t relations) const { return plans_.at(relations).cost_; }
+
+  /** @return the number of connected subgraph/complement pairs considered by the last enumeration */
+  uint64_t GetNumPairs() const { return num_pairs_; }
+
+ private:
+  // The cheapest plan found for a set of relations. A base relation has no inputs.
+  struct Plan {
+    double cardinality_;
+    double cost_;
+    uint64_t left_;
+    uint64_t right_;
+  };
+
+  // The relations adjacent to any of the given relations in the join graph.
+  uint64_t Neighbors(uint64_t relations) const;
+
+  // The cardinality of the join of two disjoint sets of relations, each of which already has a plan.
+  double JoinCardinality(uint64_t left, uint64_t right) const;
+
+  // Consider joining the plans of two disjoint sets of relations.
+  void ConsiderJoin(uint64_t left, uint64_t right);
+
+  // DPccp, see the paper for the derivation.
+  void EnumerateCsgRec(uint64_t subgraph, uint64_t excluded, std::vector<std::pair<uint64_t, uint64_t>> *pairs) const;
+  void EmitCsg(uint64_t subgraph, std::vector<std::pair<uint64_t, uint64_t>> *pairs) const;
+  void EnumerateCmpRec(uint64_t subgraph, uint64_t complement, uint64_t excluded,
+                       std::vector<std::pair<uint64_t, uint64_t>> *pairs) const;
+  bool EnumerateDynamic();
+
+  void EnumerateGreedy();
+
+  const uint32_t dp_threshold_;
+  uint32_t num_relations_ = 0;
+  uint64_t all_relations_ = 0;
+  std::vector<double> cardinalities_;
+  // For every relation, the relations it is connected to by a predicate between the two.
+  std::vector<uint64_t> neighbors_;
+  std::vector<std::pair<uint64_t, double>> predicates_;
+  std::unordered_map<uint64_t, Plan> plans_;
+  uint64_t num_pairs_ = 0;
+};
+
+}  // namespace terrier::optimizer
@@ -117,6 +117,16 @@ class Memo {
     groups_[idx]->EraseLogicalExpression();
   }
 
+  /**
+   * @returns the number of groups in the memo
+   */
+  size_t GetNumGroups() const { return groups_.size(); }
+
+  /**
+   * @returns the number of distinct GroupExpressions in the memo, i.e., the size of the explored search space
+   */
+  size_t GetNumGroupExpressions() const { return group_expressions_.size(); }
+
  private:
   /**
    * Creates a new group
@@ -16,6 +16,7 @@ class LeftNLJoin;
 class RightNLJoin;
 class OuterNLJoin;
 class InnerHashJoin;
+class InnerMergeJoin;
 class LeftHashJoin;
 class RightHashJoin;
 class OuterHashJoin;
@@ -167,6 +168,12 @@ class OperatorVisitor {
    */
   virtual void Visit(const InnerHashJoin *inner_hash_join) {}
 
+  /**
+   * Visit a InnerMergeJoin operator
+   * @param inner_merge_join operator
+   */
+  virtual void Visit(const InnerMergeJoin *inner_merge_join) {}
+
   /**
    * Visit a LeftHashJoin operator
    * @param left_hash_join operator
@@ -66,6 +66,16 @@ class Optimizer : public AbstractOptimizer {
    */
   void Reset() override;
 
+  /**
+   * @returns the number of relations in the largest inner join whose order was enumerated by the last BuildPlanTree
+   */
+  uint64_t GetNumJoinRelations() const { return num_join_relations_; }
+
+  /**
+   * @returns whether the last BuildPlanTree ordered a join greedily, because it joined too many relations
+   */
+  bool IsJoinOrderGreedy() const { return greedy_join_order_; }
+
  private:
   /**
    * Invoke a single optimization pass through the entire query.
@@ -75,6 +85,14 @@ class Optimizer : public AbstractOptimizer {
    */
   void OptimizeLoop(group_id_t root_group_id, PropertySet *required_props);
 
+  /**
+   * Find the clusters of inner joins below the given group, and seed the group of each cluster with the join order
+   * chosen by the JoinOrderEnumerator, based on the stats derived for the joined relations.
+   * @param group_id Group to begin searching at
+   * @param optimization_context OptimizationContext to derive the stats of new expressions with
+   */
+  void EnumerateJoinOrders(group_id_t group_id, OptimizationContext *optimization_context);
+
   /**
    * Retrieve the lowest cost execution plan with the given properties
    *
@@ -104,6 +122,8 @@ class Optimizer : public AbstractOptimizer {
   std::unique_ptr<AbstractCostModel> cost_model_;
   std::unique_ptr<OptimizerContext> context_;
   const uint64_t task_execution_timeout_;
+  uint64_t num_join_relations_ = 0;
+  bool greedy_join_order_ = false;
 };
 
 }  // namespace optimizer
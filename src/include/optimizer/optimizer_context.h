@@ -117,6 +117,17 @@ class OptimizerContext {
    */
   void SetStatsStorage(StatsStorage *storage) { stats_storage_ = storage; }
 
+  /**
+   * Marks the join orders of the memo as enumerated by the JoinOrderEnumerator, which makes exploring them
+   * through transformation rules redundant.
+   */
+  void SetJoinOrdersEnumerated() { join_orders_enumerated_ = true; }
+
+  /**
+   * @returns whether the join orders of the memo were enumerated by the JoinOrderEnumerator
+   */
+  bool HasEnumeratedJoinOrders() const { return join_orders_enumerated_; }
+
   /**
    * Set the task pool tracked by the OptimizerContext.
    * Function passes ownership over task_pool
@@ -198,6 +209,7 @@ class OptimizerContext {
   StatsStorage *stats_storage_{};
   transaction::TransactionContext *txn_{};
   std::vector<OptimizationContext *> track_list_;
+  bool join_orders_enumerated_ = false;
 };
 
 }  // namespace optimizer
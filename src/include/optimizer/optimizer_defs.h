@@ -100,6 +100,7 @@ enum class OpType {
   LEFTHASHJOIN,
   RIGHTHASHJOIN,
   OUTERHASHJOIN,
+  INNERMERGEJOIN,
   INSERT,
   INSERTSELECT,
   DELETE,
@@ -726,6 +726,63 @@ class InnerHashJoin : public OperatorNodeContents<InnerHashJoin> {
   std::vector<AnnotatedExpression> join_predicates_;
 };
 
+/**
+ * Physical operator for inner sort-merge join. Both children must be sorted in ascending order on their join keys.
+ */
+class InnerMergeJoin : public OperatorNodeContents<InnerMergeJoin> {
+ public:
+  /**
+   * @param join_predicates predicates for join
+   * @param left_keys left keys to join
+   * @param right_keys right keys to join
+   * @return an InnerMergeJoin operator
+   */
+  static Operator Make(std::vector<AnnotatedExpression> &&join_predicates,
+                       std::vector<common::ManagedPointer<parser::AbstractExpression>> &&left_keys,
+                       std::vector<common::ManagedPointer<parser::AbstractExpression>> &&right_keys);
+
+  /**
+   * Copy
+   * @returns copy of this
+   */
+  BaseOperatorNodeContents *Copy() const override;
+
+  bool operator==(const BaseOperatorNodeContents &r) override;
+
+  common::hash_t Hash() const override;
+
+  /**
+   * @return Left join keys
+   */
+  const std::vector<common::ManagedPointer<parser::AbstractExpression>> &GetLeftKeys() const { return left_keys_; }
+
+  /**
+   * @return Right join keys
+   */
+  const std::vector<common::ManagedPointer<parser::AbstractExpression>> &GetRightKeys() const { return right_keys_; }
+
+  /**
+   * @return Predicates for the Join
+   */
+  const std::vector<AnnotatedExpression> &GetJoinPredicates() const { return join_predicates_; }
+
+ private:
+  /**
+   * Left join keys
+   */
+  std::vector<common::ManagedPointer<parser::AbstractExpression>> left_keys_;
+
+  /**
+   * Right join keys
+   */
+  std::vector<common::ManagedPointer<parser::AbstractExpression>> right_keys_;
+
+  /**
+   * Predicate for join
+   */
+  std::vector<AnnotatedExpression> join_predicates_;
+};
+
 /**
  * Physical operator for left outer hash join
  */
@@ -314,6 +314,35 @@ class LogicalGroupByToPhysicalHashGroupBy : public Rule {
                  OptimizationContext *context) const override;
 };
 
+/**
+ * Rule transforms LogicalGroupBy -> SortGroupBy
+ */
+class LogicalGroupByToPhysicalSortGroupBy : public Rule {
+ public:
+  /**
+   * Constructor
+   */
+  LogicalGroupByToPhysicalSortGroupBy();
+
+  /**
+   * Checks whether the given rule can be applied
+   * @param plan AbstractOptimizerNode to check
+   * @param context Current OptimizationContext executing under
+   * @returns Whether the input AbstractOptimizerNode passes the check
+   */
+  bool Check(common::ManagedPointer<AbstractOptimizerNode> plan, OptimizationContext *context) const override;
+
+  /**
+   * Transforms the input expression using the given rule
+   * @param input Input AbstractOptimizerNode to transform
+   * @param transformed Vector of transformed AbstractOptimizerNodes
+   * @param context Current OptimizationContext executing under
+   */
+  void Transform(common::ManagedPointer<AbstractOptimizerNode> input,
+                 std::vector<std::unique_ptr<AbstractOptimizerNode>> *transformed,
+                 OptimizationContext *context) const override;
+};
+
 /**
  * Rule transforms LogicalAggregate -> Aggregate
  */
@@ -430,6 +459,35 @@ class LogicalInnerJoinToPhysicalInnerHashJoin : public Rule {
                  OptimizationContext *context) const override;
 };
 
+/**
+ * Rule transforms Logical Inner Join to InnerMergeJoin
+ */
+class LogicalInnerJoinToPhysicalInnerMergeJoin : public Rule {
+ public:
+  /**
+   * Constructor
+   */
+  LogicalInnerJoinToPhysicalInnerMergeJoin();
+
+  /**
+   * Checks whether the given rule can be applied
+   * @param plan AbstractOptimizerNode to check
+   * @param context Current OptimizationContext executing under
+   * @returns Whether the input AbstractOptimizerNode passes the check
+   */
+  bool Check(common::ManagedPointer<AbstractOptimizerNode> plan, OptimizationContext *context) const override;
+
+  /**
+   * Transforms the input expression using the given rule
+   * @param input Input AbstractOptimizerNode to transform
+   * @param transformed Vector of transformed AbstractOptimizerNodes
+   * @param context Current OptimizationContext executing under
+   */
+  void Transform(common::ManagedPointer<AbstractOptimizerNode> input,
+                 std::vector<std::unique_ptr<AbstractOptimizerNode>> *transformed,
+                 OptimizationContext *context) const override;
+};
+
 /**
  * Rule transforms LogicalLimit -> Limit
  */
@@ -71,6 +71,12 @@ class ColumnStats {
    */
   double &GetCardinality() { return this->cardinality_; }
 
+  /**
+   * Gets the fraction of NULL values in the column
+   * @return the fraction of NULL values
+   */
+  double GetFracNull() const { return frac_null_; }
+
   /**
    * Gets the histogram bounds
    * @return histogram bounds
@@ -145,6 +145,16 @@ class CountMinSketch {
    */
   size_t GetTotalCount() const { return total_count_; }
 
+  /**
+   * Add the counts of another sketch to this sketch.
+   * @param other the sketch to merge, which must have the same width
+   */
+  void Merge(const CountMinSketch<KeyType> &other) {
+    TERRIER_ASSERT(GetWidth() == other.GetWidth(), "Only sketches with the same width can be merged");
+    sketch_.merge(other.sketch_);
+    total_count_ += other.total_count_;
+  }
+
  private:
   /**
    * Simple counter of the approximate number of entries we have stored.
@@ -148,6 +148,23 @@ class Histogram {
     }
   }
 
+  /**
+   * Merge another histogram into this histogram, so that it represents the union of both sets.
+   * This is the merge procedure (Algorithm 2) in the JMLR10 paper.
+   * @param other the histogram to merge
+   */
+  void Merge(const Histogram<KeyType> &other) {
+    for (const auto &bin : other.bins_) {
+      InsertBin(bin);
+    }
+    while (bins_.size() > max_bins_) {
+      MergeTwoBinsWithMinGap();
+    }
+    // The points of merged bins are averages, the extremes of the other histogram may be further out
+    minimum_ = std::min(minimum_, other.minimum_);
+    maximum_ = std::max(maximum_, other.maximum_);
+  }
+
   /**
    * For the given key point (where p1 < b < pB), return an estimate
    * of the number of points in the interval [-Inf, b]
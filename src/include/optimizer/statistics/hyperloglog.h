@@ -59,6 +59,16 @@ class HyperLogLog {
    */
   uint64_t EstimateCardinality() const { return hll_->Estimate(); }
 
+  /**
+   * Merge the keys seen by another HLL into this HLL, e.g., to combine the HLLs of parts of a table that
+   * were scanned in parallel.
+   * @param other the HLL to merge, which must have the same precision
+   */
+  void Merge(const HyperLogLog<KeyType> &other) {
+    TERRIER_ASSERT(precision_ == other.precision_, "Only HLLs with the same precision can be merged");
+    hll_->Merge(other.hll_);
+  }
+
   /**
    * Estimate relative error for HLL.
    * @return
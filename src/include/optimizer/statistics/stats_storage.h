@@ -9,9 +9,14 @@
 #include "common/hash_util.h"
 #include "common/macros.h"
 #include "common/managed_pointer.h"
+#include "common/shared_latch.h"
 #include "optimizer/statistics/column_stats.h"
 #include "optimizer/statistics/table_stats.h"
 
+namespace terrier::transaction {
+class TransactionContext;
+}  // namespace terrier::transaction
+
 namespace terrier::optimizer {
 /**
  * Hashable type for database and table oid pair
@@ -63,6 +68,12 @@ namespace terrier::optimizer {
  */
 class StatsStorage {
  public:
+  /**
+   * A table is analyzed automatically once the number of its rows modified since it was last analyzed exceeds this
+   * fraction of its rows, plus a fixed threshold.
+   */
+  static constexpr double AUTO_ANALYZE_SCALE_FACTOR = 0.1;
+
   /**
    * Using given database and table ids,
    * select a pointer to the TableStats objects in the table stats storage map.
@@ -72,6 +83,30 @@ class StatsStorage {
    */
   common::ManagedPointer<TableStats> GetTableStats(catalog::db_oid_t database_id, catalog::table_oid_t table_id);
 
+  /**
+   * Replaces the TableStats object of a table, e.g., with the stats collected by ANALYZE. The new stats
+   * become visible when the given transaction commits and are discarded if it aborts. The old stats are
+   * freed once no running transaction can still be using them.
+   * @param database_id - oid of database
+   * @param table_id - oid of table
+   * @param table_stats - the new stats of the table
+   * @param txn - the transaction that collected the stats
+   */
+  void UpdateTableStats(catalog::db_oid_t database_id, catalog::table_oid_t table_id,
+                        std::unique_ptr<TableStats> table_stats, transaction::TransactionContext *txn);
+
+  /**
+   * Counts rows modified in a table towards its next automatic ANALYZE. The table must be analyzed once more than
+   * threshold rows plus AUTO_ANALYZE_SCALE_FACTOR of its rows were modified since it was last analyzed.
+   * @param database_id - oid of database
+   * @param table_id - oid of table
+   * @param num_rows - number of inserted, updated or deleted rows
+   * @param threshold - the fixed number of rows that must be modified
+   * @return whether the caller must analyze the table now, in which case the count is reset
+   */
+  bool AddModifiedRows(catalog::db_oid_t database_id, catalog::table_oid_t table_id, uint64_t num_rows,
+                       uint64_t threshold);
+
  protected:
   /**
    * If there is no corresponding pointer to a TableStats object
@@ -107,5 +142,15 @@ class StatsStorage {
    * TableStats pointers. This represents the storage for TableStats objects.
    */
   std::unordered_map<StatsStorageKey, std::unique_ptr<TableStats>> table_stats_storage_;
+
+  /**
+   * The number of rows of every table modified since the table was last analyzed
+   */
+  std::unordered_map<StatsStorageKey, uint64_t> modified_rows_;
+
+  /**
+   * Protects the maps above. Stored TableStats objects are replaced by UpdateTableStats rather than modified.
+   */
+  mutable common::SharedLatch latch_;
 };
 }  // namespace terrier::optimizer
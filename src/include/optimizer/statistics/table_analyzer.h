@@ -0,0 +1,126 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "catalog/catalog_defs.h"
+#include "catalog/schema.h"
+#include "common/managed_pointer.h"
+#include "optimizer/statistics/histogram.h"
+#include "optimizer/statistics/hyperloglog.h"
+#include "optimizer/statistics/table_stats.h"
+#include "optimizer/statistics/top_k_elements.h"
+#include "storage/storage_defs.h"
+
+namespace terrier::storage {
+class ProjectedColumns;
+class SqlTable;
+}  // namespace terrier::storage
+
+namespace terrier::transaction {
+class TransactionContext;
+}  // namespace terrier::transaction
+
+namespace terrier::optimizer {
+
+/**
+ * Collects the statistics of a table for ANALYZE. The blocks of the table are scanned in parallel, every morsel of
+ * blocks feeding its rows into its own sketches: a HyperLogLog for the number of distinct values of every column and,
+ * for numeric columns, a TopKElements for the most common values and a Histogram for the histogram bounds. The sketches
+ * of all morsels are then merged into the ColumnStats of the table.
+ *
+ * Tables with more blocks than a given maximum are sampled, only blocks spread evenly over the table are scanned and
+ * the counts are scaled up to the whole table.
+ */
+class TableAnalyzer {
+ public:
+  /** The precision of the HyperLogLogs, 2^12 registers give an error of about 1.6%. */
+  static constexpr int HLL_PRECISION = 12;
+
+  /** The number of most common values kept for every column. */
+  static constexpr size_t NUM_MOST_COMMON_VALUES = 10;
+
+  /** The width of the sketches counting the most common values. */
+  static constexpr uint64_t TOP_K_SKETCH_WIDTH = 1024;
+
+  /** The number of bins of the histograms, and so the number of histogram bounds of every column. */
+  static constexpr uint8_t NUM_HISTOGRAM_BINS = 64;
+
+  /** The number of blocks scanned by a single morsel. */
+  static constexpr uint32_t MORSEL_SIZE = 4;
+
+  /**
+   * A column is assumed to be unique if this fraction of the values in the sample are distinct.
+   */
+  static constexpr double UNIQUE_FRACTION = 0.95;
+
+  /**
+   * @param db_oid the database of the table
+   * @param table_oid the table to analyze
+   * @param table the storage of the table
+   * @param schema the schema of the table
+   * @param col_oids the columns to collect stats for
+   * @param max_sample_blocks the maximum number of blocks to scan, 0 to scan the whole table
+   */
+  TableAnalyzer(catalog::db_oid_t db_oid, catalog::table_oid_t table_oid,
+                common::ManagedPointer<storage::SqlTable> table, const catalog::Schema &schema, std::vector<catalog::col_oid_t> col_oids, uint32_t max_sample_blocks);
+
+  /**
+   * Scan the table and collect its stats
+   * @param txn the transaction to scan the table in
+   * @return the stats of the table, with a ColumnStats object for every analyzed column
+   */
+  std::unique_ptr<TableStats> Analyze(common::ManagedPointer<transaction::TransactionContext> txn);
+
+  /** @return the number of blocks scanned by the last call to Analyze */
+  uint32_t GetNumSampledBlocks() const { return num_sampled_blocks_; }
+
+ private:
+  /**
+   * The sketches of a column, either of a single morsel or merged over all morsels
+   */
+  struct ColumnSketches {
+    explicit ColumnSketches(bool numeric);
+
+    void Merge(const ColumnSketches &other);
+
+    uint64_t num_values_ = 0;
+    uint64_t num_nulls_ = 0;
+    std::unique_ptr<HyperLogLog<double>> distinct_values_;
+    // Only for numeric columns
+    std::unique_ptr<TopKElements<double>> top_k_;
+    std::unique_ptr<Histogram<double>> histogram_;
+  };
+
+  /**
+   * Feed the rows of a batch into the sketches of a morsel
+   * @param columns the scanned rows
+   * @param sketches the sketches of the morsel, one per analyzed column
+   */
+  void AddRows(storage::ProjectedColumns *columns, std::vector<ColumnSketches> *sketches) const;
+
+  /** @return new empty sketches, one per analyzed column */
+  std::vector<ColumnSketches> CreateSketches() const;
+
+  /**
+   * Build the stats of a column from its merged sketches
+   * @param col_idx the index of the column in col_oids_
+   * @param sketches the sketches of the column
+   * @param num_rows the estimated number of rows of the table
+   * @param scale_factor the number of rows of the table for every row scanned
+   * @return the stats of the column
+   */
+  ColumnStats BuildColumnStats(size_t col_idx, const ColumnSketches &sketches, size_t num_rows,
+                               double scale_factor) const;
+
+  const catalog::db_oid_t db_oid_;
+  const catalog::table_oid_t table_oid_;
+  const common::ManagedPointer<storage::SqlTable> table_;
+  const std::vector<catalog::col_oid_t> col_oids_;
+  std::vector<type::TypeId> col_types_;
+  storage::ProjectionMap projection_map_;
+  const uint32_t max_sample_blocks_;
+  uint32_t num_sampled_blocks_ = 0;
+};
+
+}  // namespace terrier::optimizer
@@ -250,6 +250,36 @@ class TopKElements {
    */
   size_t GetSize() const { return entries_.size(); }
 
+  /**
+   * Merge the keys counted by another top-k object into this one. The top-k keys of the merged set are taken from the
+   * top-k keys of either object, ranked by their counts in the merged sketch. A key that was among the top-k of
+   * neither object is only counted in the sketch.
+   * @param other the top-k object to merge, whose sketch must have the same width
+   */
+  void Merge(const TopKElements<KeyType> &other) {
+    sketch_->Merge(*other.sketch_);
+
+    std::vector<KeyCountPair> candidates;
+    candidates.reserve(entries_.size() + other.entries_.size());
+    for (const auto &entry : entries_) {
+      candidates.emplace_back(entry.first, sketch_->EstimateItemCount(entry.first));
+    }
+    for (const auto &entry : other.entries_) {
+      if (entries_.count(entry.first) == 0) {
+        candidates.emplace_back(entry.first, sketch_->EstimateItemCount(entry.first));
+      }
+    }
+    std::sort(candidates.begin(), candidates.end(),
+              [](const KeyCountPair &left, const KeyCountPair &right) { return left.second > right.second; });
+    if (candidates.size() > numk_) candidates.resize(numk_);
+
+    entries_.clear();
+    for (const auto &candidate : candidates) {
+      entries_[candidate.first] = candidate.second;
+    }
+    if (!entries_.empty()) ComputeNewMinKey();
+  }
+
   /**
    * Generate a vector of the top-k keys sorted by their current counts
    * @return the vector of the top-k keys
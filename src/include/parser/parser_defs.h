@@ -64,7 +64,7 @@ enum class IndexType {
 
 enum class InsertType { INVALID = INVALID_TYPE_ID, VALUES = 1, SELECT = 2 };
 
-enum class ExternalFileFormat { CSV, BINARY };
+enum class ExternalFileFormat { CSV, BINARY, TEXT };
 
 // CREATE FUNCTION helpers
 
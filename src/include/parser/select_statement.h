@@ -372,6 +372,9 @@ class SelectStatement : public SQLStatement {
   /** @return select limit */
   common::ManagedPointer<LimitDescription> GetSelectLimit() { return common::ManagedPointer(limit_); }
 
+  /** @return select statement this one is unioned with */
+  common::ManagedPointer<SelectStatement> GetUnionSelect() { return common::ManagedPointer(union_select_); }
+
   /** @return depth of the select statement */
   int GetDepth() { return depth_; }
 
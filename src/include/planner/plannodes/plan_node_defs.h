@@ -34,6 +34,7 @@ enum class PlanNodeType {
   NESTLOOP,
   HASHJOIN,
   INDEXNLJOIN,
+  MERGEJOIN,
 
   // Mutator Nodes
   UPDATE,
@@ -64,6 +65,7 @@ enum class PlanNodeType {
   DISTINCT,
   HASH,
   SETOP,
+  WINDOW,
 
   // Utility
   EXPORT_EXTERNAL_FILE,
@@ -99,6 +101,36 @@ enum class LogicalJoinType {
   RIGHT_ANTI = 9              // Right anti join
 };
 
+//===--------------------------------------------------------------------===//
+// Window Functions
+//===--------------------------------------------------------------------===//
+enum class WindowFunctionType {
+  INVALID = INVALID_TYPE_ID,
+  ROW_NUMBER = 1,
+  RANK = 2,
+  DENSE_RANK = 3,
+  LAG = 4,   // value of the argument the given number of rows before the current row
+  LEAD = 5,  // value of the argument the given number of rows after the current row
+  COUNT_STAR = 6,
+  COUNT = 7,
+  SUM = 8,
+  MIN = 9,
+  MAX = 10,
+  AVG = 11
+};
+
+/** The unit of a window frame's bounds: physical rows, or peer groups of the window's sort keys. */
+enum class WindowFrameType { ROWS = 1, RANGE = 2 };
+
+/** The kind of a window frame bound. PRECEDING and FOLLOWING carry an offset. */
+enum class WindowFrameBoundType {
+  UNBOUNDED_PRECEDING = 1,
+  PRECEDING = 2,
+  CURRENT_ROW = 3,
+  FOLLOWING = 4,
+  UNBOUNDED_FOLLOWING = 5
+};
+
 /**
  * @return A string representation for the provided node type.
  */
@@ -0,0 +1,236 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "optimizer/optimizer_defs.h"
+#include "planner/plannodes/abstract_plan_node.h"
+#include "planner/plannodes/order_by_plan_node.h"
+#include "planner/plannodes/plan_node_defs.h"
+#include "planner/plannodes/plan_visitor.h"
+
+namespace terrier::planner {
+
+/**
+ * A single window function invocation, e.g., SUM(x) OVER (... ROWS BETWEEN 2 PRECEDING AND CURRENT ROW). All terms
+ * of a window plan node share the plan's partitioning and sort keys, but each term has its own frame.
+ */
+struct WindowTerm {
+  /**
+   * The window function.
+   */
+  WindowFunctionType type_ = WindowFunctionType::INVALID;
+
+  /**
+   * The argument of the function. Null for ROW_NUMBER, RANK, DENSE_RANK and COUNT_STAR.
+   */
+  common::ManagedPointer<parser::AbstractExpression> argument_ = nullptr;
+
+  /**
+   * The number of rows to look back or ahead for LAG and LEAD.
+   */
+  int64_t offset_ = 1;
+
+  /**
+   * The unit of the frame bounds.
+   */
+  WindowFrameType frame_type_ = WindowFrameType::RANGE;
+
+  /**
+   * The start of the frame. The default frame runs from the start of the partition to the last peer of the current
+   * row, as in SQL.
+   */
+  WindowFrameBoundType frame_start_ = WindowFrameBoundType::UNBOUNDED_PRECEDING;
+
+  /**
+   * The offset of the start of the frame, if it is PRECEDING or FOLLOWING.
+   */
+  int64_t frame_start_offset_ = 0;
+
+  /**
+   * The end of the frame.
+   */
+  WindowFrameBoundType frame_end_ = WindowFrameBoundType::CURRENT_ROW;
+
+  /**
+   * The offset of the end of the frame, if it is PRECEDING or FOLLOWING.
+   */
+  int64_t frame_end_offset_ = 0;
+
+  /**
+   * @return True if this term evaluates an aggregate over a frame.
+   */
+  bool IsAggregate() const {
+    return type_ == WindowFunctionType::COUNT_STAR || type_ == WindowFunctionType::COUNT ||
+           type_ == WindowFunctionType::SUM || type_ == WindowFunctionType::MIN || type_ == WindowFunctionType::MAX ||
+           type_ == WindowFunctionType::AVG;
+  }
+
+  /**
+   * @return the hashed value of this window term
+   */
+  common::hash_t Hash() const;
+
+  /**
+   * Logical equality check.
+   * @param rhs other
+   * @return true if the two window terms are logically equal
+   */
+  bool operator==(const WindowTerm &rhs) const;
+
+  /**
+   * Logical inequality check.
+   * @param rhs other
+   * @return true if the two window terms are not logically equal
+   */
+  bool operator!=(const WindowTerm &rhs) const { return !operator==(rhs); }
+};
+
+/**
+ * Plan node for window functions. The input is grouped into partitions on the partition-by terms and ordered within
+ * each partition on the sort keys. Every input row is produced once, together with the value of each window term for
+ * that row. In the output schema, derived values with tuple index 0 refer to the child's columns and derived values
+ * with tuple index 1 refer to window terms.
+ */
+class WindowPlanNode : public AbstractPlanNode {
+ public:
+  /**
+   * Builder for a window plan node
+   */
+  class Builder : public AbstractPlanNode::Builder<Builder> {
+   public:
+    Builder() = default;
+
+    /**
+     * Don't allow builder to be copied or moved
+     */
+    DISALLOW_COPY_AND_MOVE(Builder);
+
+    /**
+     * @param term expression of a PARTITION BY term
+     * @return builder object
+     */
+    Builder &AddPartitionByTerm(common::ManagedPointer<parser::AbstractExpression> term) {
+      partition_by_terms_.push_back(term);
+      return *this;
+    }
+
+    /**
+     * @param key expression of an ORDER BY term of the window
+     * @param ordering ordering (ASC or DESC) for key
+     * @return builder object
+     */
+    Builder &AddSortKey(common::ManagedPointer<parser::AbstractExpression> key,
+                        optimizer::OrderByOrderingType ordering) {
+      sort_keys_.emplace_back(key, ordering);
+      return *this;
+    }
+
+    /**
+     * @param term window term to compute
+     * @return builder object
+     */
+    Builder &AddWindowTerm(const WindowTerm &term) {
+      window_terms_.push_back(term);
+      return *this;
+    }
+
+    /**
+     * Build the window plan node
+     * @return plan node
+     */
+    std::unique_ptr<WindowPlanNode> Build() {
+      return std::unique_ptr<WindowPlanNode>(new WindowPlanNode(std::move(children_), std::move(output_schema_),
+                                                                std::move(partition_by_terms_), std::move(sort_keys_),
+                                                                std::move(window_terms_)));
+    }
+
+   protected:
+    /**
+     * Expressions the input is partitioned on
+     */
+    std::vector<common::ManagedPointer<parser::AbstractExpression>> partition_by_terms_;
+    /**
+     * Keys and ordering type ([ASC] or [DESC]) used (in order) to sort rows within a partition
+     */
+    std::vector<SortKey> sort_keys_;
+    /**
+     * Window functions to compute
+     */
+    std::vector<WindowTerm> window_terms_;
+  };
+
+ private:
+  /**
+   * @param children child plan nodes
+   * @param output_schema Schema representing the structure of the output of this plan node
+   * @param partition_by_terms expressions the input is partitioned on
+   * @param sort_keys keys used to sort rows within a partition
+   * @param window_terms window functions to compute
+   */
+  WindowPlanNode(std::vector<std::unique_ptr<AbstractPlanNode>> &&children, std::unique_ptr<OutputSchema> output_schema,
+                 std::vector<common::ManagedPointer<parser::AbstractExpression>> &&partition_by_terms,
+                 std::vector<SortKey> &&sort_keys, std::vector<WindowTerm> &&window_terms)
+      : AbstractPlanNode(std::move(children), std::move(output_schema)),
+        partition_by_terms_(std::move(partition_by_terms)),
+        sort_keys_(std::move(sort_keys)),
+        window_terms_(std::move(window_terms)) {}
+
+ public:
+  /**
+   * Default constructor used for deserialization
+   */
+  WindowPlanNode() = default;
+
+  DISALLOW_COPY_AND_MOVE(WindowPlanNode)
+
+  /**
+   * @return the expressions the input is partitioned on
+   */
+  const std::vector<common::ManagedPointer<parser::AbstractExpression>> &GetPartitionByTerms() const {
+    return partition_by_terms_;
+  }
+
+  /**
+   * @return keys to sort on within a partition
+   */
+  const std::vector<SortKey> &GetSortKeys() const { return sort_keys_; }
+
+  /**
+   * @return the window functions to compute
+   */
+  const std::vector<WindowTerm> &GetWindowTerms() const { return window_terms_; }
+
+  /**
+   * @return the type of this plan node
+   */
+  PlanNodeType GetPlanNodeType() const override { return PlanNodeType::WINDOW; }
+
+  /**
+   * @return the hashed value of this plan node
+   */
+  common::hash_t Hash() const override;
+
+  bool operator==(const AbstractPlanNode &rhs) const override;
+
+  void Accept(common::ManagedPointer<PlanVisitor> v) const override { v->Visit(this); }
+
+  nlohmann::json ToJson() const override;
+  std::vector<std::unique_ptr<parser::AbstractExpression>> FromJson(const nlohmann::json &j) override;
+
+ private:
+  /* Expressions the input is partitioned on */
+  std::vector<common::ManagedPointer<parser::AbstractExpression>> partition_by_terms_;
+
+  /* Keys and ordering type used to sort rows within a partition */
+  std::vector<SortKey> sort_keys_;
+
+  /* Window functions to compute */
+  std::vector<WindowTerm> window_terms_;
+};
+
+DEFINE_JSON_HEADER_DECLARATIONS(WindowPlanNode);
+
+}  // namespace terrier::planner
@@ -147,5 +147,25 @@ class Callbacks {
    */
   static void MetricsExecuteCommand(void *old_value, void *new_value, DBMain *db_main,
                                     common::ManagedPointer<common::ActionContext> action_context);
+
+  /**
+   * Enable or disable metrics collection for the optimizer
+   * @param old_value old settings value
+   * @param new_value new settings value
+   * @param db_main pointer to db_main
+   * @param action_context pointer to the action context for this settings change
+   */
+  static void MetricsOptimizer(void *old_value, void *new_value, DBMain *db_main,
+                               common::ManagedPointer<common::ActionContext> action_context);
+
+  /**
+   * Enable or disable the tracing of requests
+   * @param old_value old settings value
+   * @param new_value new settings value
+   * @param db_main pointer to db_main
+   * @param action_context pointer to the action context for this settings change
+   */
+  static void MetricsQueryTrace(void *old_value, void *new_value, DBMain *db_main,
+                                common::ManagedPointer<common::ActionContext> action_context);
 };
 }  // namespace terrier::settings
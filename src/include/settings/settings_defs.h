@@ -22,6 +22,70 @@ SETTING_int(
     terrier::settings::Callbacks::NoOp
 )
 
+// Worker threads executing the commands of the clients, 0 to execute them on the connection handler threads
+SETTING_int(
+    execution_thread_count,
+    "Worker threads that execute the commands of the clients, which bounds the number of commands executing at once. 0 executes them on the connection handler threads (default: 4)",
+    4,
+    0,
+    256,
+    false,
+    terrier::settings::Callbacks::NoOp
+)
+
+// Whether the writes to a client are flushed with a single writev
+SETTING_bool(
+    network_vectored_writes,
+    "Whether all the buffered writes to a client are flushed with a single writev instead of one write per buffer (default: true)",
+    true,
+    false,
+    terrier::settings::Callbacks::NoOp
+)
+
+// Size of the rings through which a client on the same host exchanges messages over shared memory
+SETTING_int(
+    network_shared_memory_ring_size,
+    "Size in bytes of each of the two ring buffers through which a client on the Unix domain socket exchanges messages once it switched over to shared memory, rounded up to a power of two. 0 keeps every client on its socket (default: 1048576)",
+    1048576,
+    0,
+    1073741824,
+    false,
+    terrier::settings::Callbacks::NoOp
+)
+
+// Number of bytes of results that are queued for a client before the query waits for it
+SETTING_int64(
+    network_write_queue_limit,
+    "The number of bytes of query results that are queued for a client before the query waits for the client to read them, so that large results are streamed in bounded memory. 0 queues the whole result (default: 8388608)",
+    8388608,
+    0,
+    INT64_MAX,
+    false,
+    terrier::settings::Callbacks::NoOp
+)
+
+// Time a query waits for its client to read the queued results
+SETTING_int(
+    network_write_timeout,
+    "The number of milliseconds a query waits for its client to read the queued results before the query fails. 0 waits indefinitely (default: 60000)",
+    60000,
+    0,
+    INT32_MAX,
+    false,
+    terrier::settings::Callbacks::NoOp
+)
+
+// Number of prepared statements that each connection caches
+SETTING_int(
+    network_statement_cache_size,
+    "The maximum number of statements that each connection caches once no prepared statement or portal refers to them anymore, evicting the least recently used ones (default: 1024)",
+    1024,
+    0,
+    1000000,
+    false,
+    terrier::settings::Callbacks::NoOp
+)
+
 // Path to socket file for Unix domain sockets
 SETTING_string(
     uds_file_directory,
@@ -163,6 +227,57 @@ SETTING_int64(
     terrier::settings::Callbacks::NoOp
 )
 
+// Address of the replica the WAL is streamed to
+SETTING_string(
+    replication_replica_address,
+    "Host name or address of the replica the WAL is streamed to over ITP. Empty to not replicate the WAL (default: empty)",
+    "",
+    false,
+    terrier::settings::Callbacks::NoOp
+)
+
+// Port of the replica the WAL is streamed to
+SETTING_int(
+    replication_replica_port,
+    "Port on which the replica listens for the WAL (default: 15722)",
+    15722,
+    1024,
+    65535,
+    false,
+    terrier::settings::Callbacks::NoOp
+)
+
+// Whether commits wait for their logs to arrive at the replica
+SETTING_bool(
+    replication_synchronous_commit,
+    "Whether transactions only commit once their logs arrived at the connected replica, as well as persisted (default: true)",
+    true,
+    false,
+    terrier::settings::Callbacks::NoOp
+)
+
+// Time the primary waits for the replica before it drops the connection
+SETTING_int(
+    replication_timeout,
+    "The number of milliseconds the primary waits for the replica to accept or acknowledge logs before it drops the connection and stops replicating (default: 10000)",
+    10000,
+    1,
+    INT32_MAX,
+    false,
+    terrier::settings::Callbacks::NoOp
+)
+
+// Port on which a replica listens for the WAL of its primary
+SETTING_int(
+    replication_listen_port,
+    "Port on which this server listens for the WAL of its primary over ITP, as a read-only replica. 0 for a primary (default: 0)",
+    0,
+    0,
+    65535,
+    false,
+    terrier::settings::Callbacks::NoOp
+)
+
 SETTING_int(
     extra_float_digits,
     "Sets the number of digits displayed for floating-point values. (default : 1)",
@@ -237,6 +352,32 @@ SETTING_bool(
     terrier::settings::Callbacks::MetricsExecuteCommand
 )
 
+SETTING_bool(
+    metrics_optimizer,
+    "Metrics collection for building query plans: planning time and the size of the search space.",
+    false,
+    true,
+    terrier::settings::Callbacks::MetricsOptimizer
+)
+
+SETTING_bool(
+    metrics_query_trace,
+    "Trace the time of requests from their read to the flush of their results, written out in Chrome's trace format (default: false).",
+    false,
+    true,
+    terrier::settings::Callbacks::MetricsQueryTrace
+)
+
+SETTING_int(
+    metrics_query_trace_sample_interval,
+    "Number of requests that are not traced between two traced requests (default: 9)",
+    9,
+    0,
+    INT32_MAX,
+    false,
+    terrier::settings::Callbacks::NoOp
+)
+
 SETTING_bool(
     use_query_cache,
     "Extended Query protocol caches physical plans and generated code after first execution. Warning: bugs with DDL changes.",
@@ -253,6 +394,96 @@ SETTING_bool(
     terrier::settings::Callbacks::NoOp
 )
 
+SETTING_bool(
+    tiered_query_execution,
+    "Interpret cached queries at first, and compile them to native machine code in the background once they are hot. Ignored if compiled_query_execution is set (default: false).",
+    false,
+    false,
+    terrier::settings::Callbacks::NoOp
+)
+
+SETTING_string(
+    jit_object_cache_directory,
+    "The directory in which JIT-compiled queries are cached across restarts. Empty to disable the cache (default: empty)",
+    "",
+    false,
+    terrier::settings::Callbacks::NoOp
+)
+
+SETTING_int(
+    jit_object_cache_size,
+    "The maximum total size of the JIT cache in MB, least recently used entries are evicted beyond it (default: 256)",
+    256,
+    1,
+    65536,
+    false,
+    terrier::settings::Callbacks::NoOp
+)
+
+SETTING_int(
+    plan_cache_size,
+    "The maximum number of plans shared by all connections through the plan cache, 0 to disable it (default: 1024)",
+    1024,
+    0,
+    1000000,
+    false,
+    terrier::settings::Callbacks::NoOp
+)
+
+SETTING_bool(
+    auto_parameterization,
+    "Replace the literals of simple queries by parameters so that they share cached plans (default: true)",
+    true,
+    false,
+    terrier::settings::Callbacks::NoOp
+)
+
+SETTING_bool(
+    point_query_fast_path,
+    "Run single-row SELECTs and UPDATEs by unique key without optimization and code generation (default: true)",
+    true,
+    false,
+    terrier::settings::Callbacks::NoOp
+)
+
+SETTING_bool(
+    stats_cost_model,
+    "Cost plans by the cardinalities estimated from table statistics instead of fixed costs per operator (default: false)",
+    false,
+    false,
+    terrier::settings::Callbacks::NoOp
+)
+
+SETTING_int(
+    analyze_sample_blocks,
+    "The maximum number of blocks ANALYZE scans in a table, sampled evenly over larger tables, 0 to scan all blocks (default: 1024)",
+    1024,
+    0,
+    INT32_MAX,
+    false,
+    terrier::settings::Callbacks::NoOp
+)
+
+SETTING_int64(
+    auto_analyze_threshold,
+    "The number of rows that must be modified in a table, on top of 10% of its rows, before it is analyzed automatically, 0 to disable auto-analyze (default: 0)",
+    0,
+    0,
+    INT64_MAX,
+    false,
+    terrier::settings::Callbacks::NoOp
+)
+
+SETTING_int(
+    output_batch_size,
+    "The number of result rows the execution engine buffers before they are serialized for the client together (default: 2048)",
+    2048,
+    1,
+    65536,
+    false,
+    terrier::settings::Callbacks::NoOp
+)
+
 SETTING_string(
     application_name,
     "The name of the application (default: NO_NAME)",
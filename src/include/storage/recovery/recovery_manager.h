@@ -106,6 +106,7 @@ class RecoveryManager : public common::DedicatedThreadOwner {
 
  private:
   FRIEND_TEST(RecoveryTests, DoubleRecoveryTest);
+  FRIEND_TEST(RecoveryTests, ReplicationTest);
   friend class RecoveryTests;
   friend class terrier::RecoveryBenchmark;
 
@@ -1,20 +1,62 @@
 #pragma once
 
+#include <condition_variable>  // NOLINT
 #include <memory>
+#include <mutex>  // NOLINT
+#include <queue>
 
+#include "network/network_io_utils.h"
 #include "storage/recovery/abstract_log_provider.h"
 
 namespace terrier::storage {
 
 /**
- * TODO(Tianlei/Gus): Replace this file with Gus's version
+ * @brief Log provider for logs streamed from a primary
+ * Provides logs to the recovery manager of a replica from the buffers that arrive over the replication connection. The
+ * buffers are read as if they were one contiguous log, so a record may span buffers. Reads block until the primary
+ * shipped enough bytes or ended the replication.
  */
-class ReplicationLogProvider {
+class ReplicationLogProvider : public AbstractLogProvider {
  public:
   /**
-   * Passes the content of the buffer to traffic cop
-   * @param buffer content to pass to traffic cop
+   * Passes the logs that arrived from the primary to the recovery manager
+   * @param buffer logs shipped by the primary
    */
-  virtual void HandBufferToReplication(std::unique_ptr<network::ReadBuffer> buffer);
+  void HandBufferToReplication(std::unique_ptr<network::ReadBuffer> buffer);
+
+  /**
+   * Tells the recovery manager that no more logs arrive once it applied the buffers it was handed
+   */
+  void EndReplication();
+
+ private:
+  std::mutex latch_;
+  // Notified when a buffer arrives or the replication ends
+  std::condition_variable buffers_cv_;
+  // Buffers that arrived and were not read yet
+  std::queue<std::unique_ptr<network::ReadBuffer>> buffers_;
+  bool replication_ended_ = false;
+  // The buffer being read, only touched by the recovery manager
+  std::unique_ptr<network::ReadBuffer> curr_buffer_;
+
+  /**
+   * Blocks until the next buffer arrives, unless the current buffer has bytes left
+   * @return false if the replication ended and all the bytes were read
+   */
+  bool WaitForBytes();
+
+  /**
+   * @return true if the primary shipped more records, false once the replication ended and all records were read
+   */
+  bool HasMoreRecords() override { return WaitForBytes(); }
+
+  /**
+   * Read data that arrived from the primary into the destination provided, waiting for more buffers as needed
+   * @param dest pointer to location to read into
+   * @param size number of bytes to read
+   * @return true if we read the given number of bytes
+   */
+  bool Read(void *dest, uint32_t size) override;
 };
+
 }  // namespace terrier::storage
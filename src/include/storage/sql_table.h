@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstring>
 #include <list>
 #include <set>
 #include <string>
@@ -118,6 +119,37 @@ class SqlTable {
     return slot;
   }
 
+  /**
+   * Inserts every tuple of a batch of columns, staging a write for each of them so that the inserts are logged. The
+   * tuples are copied column by column straight from the batch into the redo records.
+   *
+   * @param txn the calling transaction
+   * @param db_oid the database of this table, for the redo records
+   * @param table_oid the oid of this table, for the redo records
+   * @param initializer initializer of the redo records, which must project the same columns as the batch
+   * @param columns the tuples to insert. The slots of the inserted tuples are written to its TupleSlots().
+   */
+  void InsertBatch(const common::ManagedPointer<transaction::TransactionContext> txn, const catalog::db_oid_t db_oid,
+                   const catalog::table_oid_t table_oid, const ProjectedRowInitializer &initializer,
+                   ProjectedColumns *const columns) const {
+    const auto num_cols = columns->NumColumns();
+    for (uint32_t row = 0; row < columns->NumTuples(); row++) {
+      auto *const redo = txn->StageWrite(db_oid, table_oid, initializer);
+      auto *const delta = redo->Delta();
+      TERRIER_ASSERT(delta->NumColumns() == num_cols, "The redo records must project the columns of the batch.");
+      for (uint16_t col = 0; col < num_cols; col++) {
+        TERRIER_ASSERT(delta->ColumnIds()[col] == columns->ColumnIds()[col], "Columns must be in the same order.");
+        if (!columns->ColumnNullBitmap(col)->Test(row)) {
+          delta->SetNull(col);
+          continue;
+        }
+        const auto attr_size = columns->AttrSizeForColumn(col);
+        std::memcpy(delta->AccessForceNotNull(col), columns->ColumnStart(col) + attr_size * row, attr_size);
+      }
+      columns->TupleSlots()[row] = Insert(txn, redo);
+    }
+  }
+
   /**
    * Deletes the given TupleSlot. StageDelete must have been called as well in order for the operation to be logged.
    * @param txn the calling transaction
@@ -185,6 +217,9 @@ class SqlTable {
     return table_.data_table_->GetBlockedSlotIterator(start_block, end_block);
   }
 
+  /** @return The number of blocks of the underlying DataTable. */
+  uint32_t GetNumBlocks() const { return table_.data_table_->GetNumBlocks(); }
+
   /**
    * @return one past the last tuple slot contained in the underlying DataTable
    */
@@ -6,11 +6,14 @@
 #include "common/container/concurrent_blocking_queue.h"
 #include "common/container/concurrent_queue.h"
 #include "common/dedicated_thread_task.h"
+#include "common/managed_pointer.h"
 #include "storage/storage_defs.h"
 #include "storage/write_ahead_log/log_io.h"
 
 namespace terrier::storage {
 
+class ReplicationLogConsumerTask;
+
 /**
  * A DiskLogConsumerTask is responsible for writing serialized log records out to disk by processing buffers in the log
  * manager's filled buffer queue
@@ -24,18 +27,22 @@ class DiskLogConsumerTask : public common::DedicatedThreadTask {
    * @param buffers pointer to list of all buffers used by log manager, used to persist log file
    * @param empty_buffer_queue pointer to queue to push empty buffers to
    * @param filled_buffer_queue pointer to queue to pop filled buffers from
+   * @param replication_task task to hand the logs to before they are written to the log file, nullptr if the logs are
+   *                         not replicated
    */
   explicit DiskLogConsumerTask(const std::chrono::microseconds persist_interval, uint64_t persist_threshold,
                                std::vector<BufferedLogWriter> *buffers,
                                common::ConcurrentBlockingQueue<BufferedLogWriter *> *empty_buffer_queue,
-                               common::ConcurrentQueue<storage::SerializedLogs> *filled_buffer_queue)
+                               common::ConcurrentQueue<storage::SerializedLogs> *filled_buffer_queue,
+                               common::ManagedPointer<ReplicationLogConsumerTask> replication_task)
       : run_task_(false),
         persist_interval_(persist_interval),
         persist_threshold_(persist_threshold),
         current_data_written_(0),
         buffers_(buffers),
         empty_buffer_queue_(empty_buffer_queue),
-        filled_buffer_queue_(filled_buffer_queue) {}
+        filled_buffer_queue_(filled_buffer_queue),
+        replication_task_(replication_task) {}
 
   /**
    * Runs main disk log writer loop. Called by thread registry upon initialization of thread
@@ -67,6 +74,10 @@ class DiskLogConsumerTask : public common::DedicatedThreadTask {
   common::ConcurrentBlockingQueue<BufferedLogWriter *> *empty_buffer_queue_;
   // The queue containing filled buffers. Task should dequeue filled buffers from this queue to flush
   common::ConcurrentQueue<SerializedLogs> *filled_buffer_queue_;
+  // The task that ships the logs to a replica, nullptr if the logs are not replicated
+  const common::ManagedPointer<ReplicationLogConsumerTask> replication_task_;
+  // Id of the message that shipped the last logs written to the log file
+  uint64_t last_replication_message_id_ = 0;
 
   // Flag used by the serializer thread to signal the disk log consumer task thread to persist the data on disk
   volatile bool do_persist_;
@@ -91,7 +102,7 @@ class DiskLogConsumerTask : public common::DedicatedThreadTask {
 
   /*
    * Persists the log file on disk by calling fsync, as well as calling callbacks for all committed transactions that
-   * were persisted
+   * were persisted. With synchronous replication, the callbacks also wait for the logs to arrive at the replica
    * @return number of buffers persisted, used for metrics
    */
   uint64_t PersistLogFile();
@@ -149,6 +149,16 @@ class BufferedLogWriter {
    */
   bool IsBufferFull() { return buffer_size_ == common::Constants::LOG_BUFFER_SIZE; }
 
+  /**
+   * @return the buffered writes that were not flushed yet
+   */
+  const char *GetBuffer() const { return buffer_; }
+
+  /**
+   * @return number of bytes of the buffered writes
+   */
+  uint32_t GetBufferSize() const { return buffer_size_; }
+
  private:
   int out_;  // fd of the output files
   char buffer_[common::Constants::LOG_BUFFER_SIZE];
@@ -21,6 +21,7 @@ namespace terrier::storage {
 
 class LogSerializerTask;
 class DiskLogConsumerTask;
+class ReplicationLogConsumerTask;
 
 /**
  * A LogManager is responsible for serializing log records out and keeping track of whether changes from a transaction
@@ -31,7 +32,8 @@ class DiskLogConsumerTask;
  * and hand them over to the consumer queue (filled_buffer_queue_). The reason this is done in the background and not as
  * soon as logs are received is to reduce the amount of time a transaction spends interacting with the log manager
  *      3. When a buffer of logs is handed over to a consumer, the consumer will wake up and process the logs. In the
- * case of the DiskLogConsumerTask, this means writing it to the log file.
+ * case of the DiskLogConsumerTask, this means writing it to the log file. If the logs are replicated, the
+ * DiskLogConsumerTask first hands them to the ReplicationLogConsumerTask, which ships them to the replica.
  *      4. The DiskLogConsumer task will persist the log file when:
  *          a) Someone calls ForceFlush on the LogManager, or
  *          b) Periodically
@@ -66,11 +68,29 @@ class LogManager : public common::DedicatedThreadOwner {
         serialization_interval_(serialization_interval),
         persist_interval_(persist_interval),
         persist_threshold_(persist_threshold) {}
+  /**
+   * Streams the logs to a replica from the next Start() on
+   * @param replica_address host name or address of the replica
+   * @param replica_port port the replica listens for logs on
+   * @param synchronous_commit whether the callbacks of committed transactions are only invoked once their logs arrived
+   *                           at the replica, as well as persisted
+   * @param timeout time to wait for the replica before the connection to it is dropped
+   */
+  void ReplicateTo(std::string replica_address, uint16_t replica_port, bool synchronous_commit,
+                   std::chrono::milliseconds timeout) {
+    TERRIER_ASSERT(!run_log_manager_, "Replication has to be set up before the LogManager starts");
+    replica_address_ = std::move(replica_address);
+    replica_port_ = replica_port;
+    synchronous_replication_ = synchronous_commit;
+    replication_timeout_ = timeout;
+  }
+
   /**
    * Starts log manager. Does the following in order:
    *    1. Initialize buffers to pass serialized logs to log consumers
-   *    2. Starts up DiskLogConsumerTask
-   *    3. Starts up LogSerializerTask
+   *    2. Starts up ReplicationLogConsumerTask, if the logs are replicated
+   *    3. Starts up DiskLogConsumerTask
+   *    4. Starts up LogSerializerTask
    */
   void Start();
 
@@ -86,7 +106,8 @@ class LogManager : public common::DedicatedThreadOwner {
    * Persists all unpersisted logs and stops the log manager. Does what Start() does in reverse order:
    *    1. Stops LogSerializerTask
    *    2. Stops DiskLogConsumerTask
-   *    3. Closes all open buffers
+   *    3. Stops ReplicationLogConsumerTask, if the logs are replicated
+   *    4. Closes all open buffers
    * @note Start() can be called to run the log manager again, a new log manager does not need to be initialized.
    */
   void PersistAndStop();
@@ -161,6 +182,17 @@ class LogManager : public common::DedicatedThreadOwner {
   // Threshold used by disk consumer task
   uint64_t persist_threshold_;
 
+  // The log consumer task which ships the logs to a replica, nullptr if they are not replicated
+  common::ManagedPointer<ReplicationLogConsumerTask> replication_task_ =
+      common::ManagedPointer<ReplicationLogConsumerTask>(nullptr);
+  // Replica to ship the logs to, empty if they are not replicated
+  std::string replica_address_;
+  uint16_t replica_port_ = 0;
+  // Whether commits wait for their logs to arrive at the replica
+  bool synchronous_replication_ = false;
+  // Time to wait for the replica before the connection to it is dropped
+  std::chrono::milliseconds replication_timeout_{0};
+
   /**
    * If the central registry wants to removes our thread used for the disk log consumer task, we only allow removal if
    * we are in shut down, else we need to keep the task, so we reject the removal
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <chrono>              // NOLINT
+#include <condition_variable>  // NOLINT
+#include <deque>
+#include <mutex>  // NOLINT
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/dedicated_thread_task.h"
+#include "network/network_io_utils.h"
+
+namespace terrier::storage {
+
+/**
+ * A ReplicationLogConsumerTask streams the serialized log records that the DiskLogConsumerTask writes to the log file
+ * to a replica over ITP. Every buffer of logs is a message that the replica acknowledges once it arrived, and the
+ * messages that are handed over while the task ships the previous ones are shipped together in the next batch.
+ *
+ * The task connects to the replica when it starts and holds on to the logs until the replica accepts the connection,
+ * so that the replica gets the whole log from the bootstrap of the catalog on. If the connection is lost, the replica
+ * missed logs and can't continue, so the task stops replicating. A replica that doesn't take or acknowledge logs within
+ * the timeout is treated as lost as well, so that it doesn't hold back the commits that wait for it.
+ */
+class ReplicationLogConsumerTask : public common::DedicatedThreadTask {
+ public:
+  /**
+   * Constructs a new ReplicationLogConsumerTask
+   * @param replica_address host name or address of the replica
+   * @param replica_port port the replica listens for logs on
+   * @param synchronous_commit whether transactions only commit once their logs arrived at the replica
+   * @param timeout time to wait for the replica to take or acknowledge logs before the connection to it is dropped
+   */
+  ReplicationLogConsumerTask(std::string replica_address, uint16_t replica_port, bool synchronous_commit,
+                             std::chrono::milliseconds timeout)
+      : replica_address_(std::move(replica_address)),
+        replica_port_(replica_port),
+        synchronous_commit_(synchronous_commit),
+        timeout_(timeout) {}
+
+  /**
+   * Connects to the replica and ships the logs until the task is terminated. Called by thread registry upon
+   * initialization of thread
+   */
+  void RunTask() override;
+
+  /**
+   * Signals task to stop once it shipped the logs it was handed. Called by thread registry upon termination of thread
+   */
+  void Terminate() override;
+
+  /**
+   * Copies a buffer of serialized logs to ship them to the replica
+   * @param data the serialized logs
+   * @param size number of bytes of logs
+   * @return id of the message that ships the logs
+   */
+  uint64_t HandBuffer(const char *data, uint32_t size);
+
+  /**
+   * Blocks until the replica acknowledged the message and all messages before it, if the commits are synchronous and
+   * the replica is connected
+   * @param message_id id of the message
+   */
+  void WaitForAcknowledgement(uint64_t message_id);
+
+ private:
+  enum class State : uint8_t { CONNECTING, STREAMING, STOPPED };
+
+  // Maximum number of messages shipped before their acknowledgements are read, so that neither side fills up the
+  // socket buffers while the other one does not read
+  static constexpr uint32_t MAX_BATCH_SIZE = 64;
+  // Bounds of the time between two attempts to connect to the replica
+  static constexpr std::chrono::milliseconds INITIAL_BACKOFF_TIME{10};
+  static constexpr std::chrono::milliseconds MAX_BACKOFF_TIME{1000};
+
+  const std::string replica_address_;
+  const uint16_t replica_port_;
+  const bool synchronous_commit_;
+  const std::chrono::milliseconds timeout_;
+
+  std::mutex latch_;
+  // Notified when logs are handed over or the task is terminated
+  std::condition_variable task_cv_;
+  // Notified when messages are acknowledged or the replication stops
+  std::condition_variable ack_cv_;
+  State state_ = State::CONNECTING;
+  bool run_task_ = true;
+  // Messages that were not shipped yet, with their ids
+  std::deque<std::pair<uint64_t, std::vector<char>>> pending_;
+  uint64_t next_message_id_ = 1;
+  uint64_t last_acknowledged_ = 0;
+
+  // Socket connected to the replica, only used by the task thread
+  int socket_fd_ = -1;
+  network::ReadBuffer acknowledgements_;
+
+  /**
+   * Tries to connect to the replica until it accepts the connection, backing off between the attempts
+   * @return false if the task was terminated before the replica accepted the connection
+   */
+  bool Connect();
+
+  /**
+   * Ships a batch of messages and waits for their acknowledgements
+   * @param batch messages to ship
+   * @return false if the connection to the replica was lost or the replica timed out
+   */
+  bool ShipBatch(const std::vector<std::pair<uint64_t, std::vector<char>>> &batch);
+
+  /**
+   * Reads the next acknowledgement from the replica
+   * @param[out] message_id id of the acknowledged message
+   * @return false if the connection to the replica was lost or the replica timed out
+   */
+  bool ReadAcknowledgement(uint64_t *message_id);
+
+  /**
+   * Closes the connection to the replica and stops the replication
+   * @param end_replication whether to tell the replica that no more logs follow, false if the connection was lost
+   */
+  void Stop(bool end_replication);
+};
+}  // namespace terrier::storage
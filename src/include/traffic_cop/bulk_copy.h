@@ -0,0 +1,267 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "catalog/catalog_defs.h"
+#include "common/macros.h"
+#include "common/managed_pointer.h"
+#include "parser/parser_defs.h"
+#include "storage/projected_columns.h"
+#include "storage/projected_row.h"
+#include "type/type_id.h"
+
+namespace terrier::catalog {
+class IndexSchema;
+class Schema;
+}  // namespace terrier::catalog
+
+namespace terrier::network {
+class NetworkIoWrapper;
+class PostgresPacketWriter;
+}  // namespace terrier::network
+
+namespace terrier::storage {
+class SqlTable;
+namespace index {
+class Index;
+}  // namespace index
+}  // namespace terrier::storage
+
+namespace terrier::transaction {
+class TransactionContext;
+}  // namespace terrier::transaction
+
+namespace terrier::trafficcop {
+
+/**
+ * The format of the data stream of a COPY. Text and CSV follow the rules of Postgres: text escapes special characters
+ * with backslashes and writes NULL as \N, CSV quotes special characters and writes NULL as an unquoted empty field.
+ * Binary is Postgres' binary COPY format, with every value in the binary format of its Postgres type.
+ */
+struct CopyFormat {
+  /** Text, CSV or binary */
+  parser::ExternalFileFormat format_;
+  /** The character separating fields in text and CSV */
+  char delimiter_;
+  /** The character quoting fields in CSV */
+  char quote_;
+  /** The character escaping a quote character inside a quoted field in CSV */
+  char escape_;
+};
+
+/**
+ * The load of a COPY ... FROM STDIN. The client sends the rows in CopyData messages whose boundaries are arbitrary, so
+ * every message is parsed in place up to its last complete row, and only the incomplete tail is kept until the next
+ * message arrives. Values are converted straight into the column vectors of a ProjectedColumns batch. Every full batch
+ * is inserted into the table at once, and then into each index of the table in turn.
+ *
+ * The tuples are inserted by the transaction of the COPY statement. Nothing is undone on errors, which abort the
+ * transaction instead. Only indexes on plain columns are supported.
+ */
+class CopyIn {
+ public:
+  /**
+   * Prepare the load of a table.
+   * @param txn The transaction of the COPY statement.
+   * @param db_oid The database of the table.
+   * @param table_oid The table to load.
+   * @param table The storage of the table.
+   * @param schema The schema of the table. Every row has a field for each of its columns, in order.
+   * @param indexes The indexes of the table.
+   * @param format The format of the data stream.
+   * @throw ExecutionException if the type of a column or an index is not supported.
+   */
+  CopyIn(common::ManagedPointer<transaction::TransactionContext> txn, catalog::db_oid_t db_oid,
+         catalog::table_oid_t table_oid, common::ManagedPointer<storage::SqlTable> table, const catalog::Schema &schema,
+         const std::vector<std::pair<common::ManagedPointer<storage::index::Index>, const catalog::IndexSchema &>>
+             &indexes,
+         CopyFormat format);
+
+  /**
+   * Destructor. Frees the strings of the rows that were parsed but not inserted.
+   */
+  ~CopyIn();
+
+  /**
+   * This class cannot be copied or moved.
+   */
+  DISALLOW_COPY_AND_MOVE(CopyIn);
+
+  /**
+   * Load the rows of the next part of the data stream.
+   * @param data The bytes of the next CopyData message, which only have to remain valid during the call.
+   * @throw ExecutionException if the data is malformed, or a row violates a constraint.
+   */
+  void Consume(std::string_view data);
+
+  /**
+   * Load the rest of the data stream, after the client sent all of it.
+   * @return The number of rows loaded.
+   * @throw ExecutionException if the data is malformed, or a row violates a constraint.
+   */
+  uint64_t Finish();
+
+  /**
+   * @return The table that is loaded.
+   */
+  catalog::table_oid_t GetTableOid() const { return table_oid_; }
+
+  /**
+   * @return The format of the data stream.
+   */
+  parser::ExternalFileFormat GetFormat() const { return format_.format_; }
+
+  /**
+   * @return The number of fields of every row.
+   */
+  uint16_t NumColumns() const { return static_cast<uint16_t>(col_types_.size()); }
+
+ private:
+  // A key column of an index and the column of the batch it is taken from
+  struct KeyColumn {
+    uint16_t key_offset_;
+    uint16_t batch_offset_;
+  };
+
+  // An index that is maintained by the load
+  struct IndexInfo {
+    common::ManagedPointer<storage::index::Index> index_;
+    bool unique_;
+    std::unique_ptr<byte[]> key_buffer_;
+    storage::ProjectedRow *key_;
+    std::vector<KeyColumn> key_columns_;
+  };
+
+  // A field of a row. The text of a field with escapes points to the unescaped copy in scratch_.
+  struct Field {
+    const char *ptr_;
+    std::size_t len_;
+    bool null_;
+  };
+
+  // Parse all complete rows in the given text or CSV data and return the number of bytes consumed. The last row does
+  // not need to be terminated if the data is the end of the stream.
+  std::size_t ParseRows(const char *data, std::size_t size, bool end_of_stream);
+
+  // Parse all complete tuples in the given binary data and return the number of bytes consumed
+  std::size_t ParseTuples(const char *data, std::size_t size);
+
+  // Return the position of the new line terminating the row that starts at ptr, or nullptr if there is none yet
+  const char *FindRowEnd(const char *ptr, const char *end) const;
+
+  // Parse the next field of a text row starting at ptr and return the position of the character terminating it
+  const char *ParseTextField(const char *ptr, const char *end, Field *field);
+
+  // Parse the next field of a CSV row starting at ptr and return the position of the character terminating it
+  const char *ParseCSVField(const char *ptr, const char *end, Field *field);
+
+  // Write NULL into a column of the current row, or return where its value goes
+  byte *PrepareField(uint16_t col_idx, bool null);
+
+  // Convert a text field and write it into the current row of the batch
+  void WriteField(const Field &field, uint16_t col_idx);
+
+  // Convert a binary field and write it into the current row of the batch
+  void WriteBinaryField(const char *ptr, int32_t len, uint16_t col_idx);
+
+  // Count the current row of the batch, and insert the batch if it is full
+  void FinishRow();
+
+  // Insert the rows of the batch into the table and the indexes
+  void InsertBatch();
+
+  // Free the strings owned by the first num_fields fields of a row of the batch
+  void FreeStrings(uint32_t row, uint16_t num_fields);
+
+  [[noreturn]] void ThrowBadFormat(const std::string &message) const;
+
+  const common::ManagedPointer<transaction::TransactionContext> txn_;
+  const catalog::db_oid_t db_oid_;
+  const catalog::table_oid_t table_oid_;
+  const common::ManagedPointer<storage::SqlTable> table_;
+  const CopyFormat format_;
+
+  // The type, name, nullability and batch offset of every column, in the order of the fields of a row
+  std::vector<type::TypeId> col_types_;
+  std::vector<std::string> col_names_;
+  std::vector<bool> col_nullable_;
+  std::vector<uint16_t> col_offsets_;
+
+  std::vector<IndexInfo> indexes_;
+
+  // The redo records of the inserts project the same columns as the batch
+  storage::ProjectedRowInitializer row_initializer_;
+  std::unique_ptr<byte[]> batch_buffer_;
+  storage::ProjectedColumns *batch_;
+  // The row of the batch that is parsed next
+  uint32_t row_ = 0;
+  // The number of fields of the current row that were written so far
+  uint16_t num_fields_ = 0;
+
+  // The incomplete tail of the last message, if any
+  std::string pending_;
+  // The number of bytes pending_ needs before another binary tuple can be complete
+  std::size_t num_needed_ = 0;
+  // The unescaped text of the last field with escapes
+  std::string scratch_;
+
+  // The number of rows read so far, and whether the end of the data was reached
+  uint64_t num_rows_ = 0;
+  bool binary_header_read_ = false;
+  bool end_of_data_ = false;
+};
+
+/**
+ * A COPY ... TO STDOUT of a table. The table is scanned in batches and every row is converted straight from the
+ * column vectors of a batch into CopyData messages, without materializing the result of the scan.
+ */
+class CopyOut {
+ public:
+  /**
+   * Prepare the copy of a table.
+   * @param txn The transaction of the COPY statement.
+   * @param table The storage of the table.
+   * @param schema The schema of the table. Every row has a field for each of its columns, in order.
+   * @param format The format of the data stream.
+   * @throw ExecutionException if the type of a column is not supported.
+   */
+  CopyOut(common::ManagedPointer<transaction::TransactionContext> txn, common::ManagedPointer<storage::SqlTable> table,
+          const catalog::Schema &schema, CopyFormat format);
+
+  /**
+   * Send the table to the client, starting with the CopyOutResponse and ending with the CopyDone message. If the
+   * transport of the client is known, the rows are flushed as they are scanned, so a large table isn't queued whole.
+   * @param out The writer of the client's connection.
+   * @param transport The transport of the client that the writer writes to, nullptr if unknown.
+   * @return The number of rows sent.
+   * @throw ExecutionException if the client doesn't read the rows within the write timeout.
+   */
+  uint64_t Write(common::ManagedPointer<network::PostgresPacketWriter> out,
+                 common::ManagedPointer<network::NetworkIoWrapper> transport = nullptr) const;
+
+ private:
+  // Append the fields of a row to the data stream
+  void AppendRow(storage::ProjectedColumns *batch, uint32_t row, std::string *buffer) const;
+
+  // Append a value in text format, not yet escaped or quoted, to the buffer
+  static void AppendText(const byte *value, type::TypeId type, std::string *buffer);
+
+  // Append a value in binary format, preceded by its length, to the buffer
+  static void AppendBinary(const byte *value, type::TypeId type, std::string *buffer);
+
+  // Append text to the buffer, escaped for the text format or quoted for CSV where needed
+  void AppendEscaped(std::string_view text, std::string *buffer) const;
+
+  const common::ManagedPointer<transaction::TransactionContext> txn_;
+  const common::ManagedPointer<storage::SqlTable> table_;
+  const CopyFormat format_;
+  std::vector<catalog::col_oid_t> col_oids_;
+  std::vector<type::TypeId> col_types_;
+  std::vector<uint16_t> col_offsets_;
+};
+
+}  // namespace terrier::trafficcop
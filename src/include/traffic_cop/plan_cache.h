@@ -0,0 +1,219 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "catalog/catalog_defs.h"
+#include "common/hash_util.h"
+#include "common/macros.h"
+#include "common/spin_latch.h"
+#include "type/type_id.h"
+
+namespace terrier::execution::compiler {
+class ExecutableQuery;
+}  // namespace terrier::execution::compiler
+
+namespace terrier::planner {
+class AbstractPlanNode;
+}  // namespace terrier::planner
+
+namespace terrier::trafficcop {
+
+class PointQuery;
+
+/**
+ * A physical plan and the executable query generated for it, or a point query, shared by all statements with the same
+ * text through the PlanCache. A cached plan is immutable. Statements that adopted it hold on to it, and check IsValid()
+ * before every execution, since DDL changes invalidate it.
+ */
+class CachedPlan {
+ public:
+  /**
+   * Create a cached plan. The tables it depends on are collected from the plan.
+   * @param physical_plan The physical plan.
+   * @param executable_query The executable query generated for the plan.
+   * @param desired_param_types The types the binder wants the parameters to be promoted to.
+   */
+  CachedPlan(std::shared_ptr<planner::AbstractPlanNode> physical_plan,
+             std::shared_ptr<execution::compiler::ExecutableQuery> executable_query,
+             std::vector<type::TypeId> desired_param_types);
+
+  /**
+   * Create a cached point query, which needs neither a physical plan nor an executable query.
+   * @param point_query The point query.
+   * @param desired_param_types The types the binder wants the parameters to be promoted to.
+   */
+  CachedPlan(std::shared_ptr<PointQuery> point_query, std::vector<type::TypeId> desired_param_types);
+
+  /**
+   * This class cannot be copied or moved.
+   */
+  DISALLOW_COPY_AND_MOVE(CachedPlan);
+
+  /** @return The physical plan. */
+  const std::shared_ptr<planner::AbstractPlanNode> &GetPhysicalPlan() const { return physical_plan_; }
+
+  /** @return The executable query. */
+  const std::shared_ptr<execution::compiler::ExecutableQuery> &GetExecutableQuery() const { return executable_query_; }
+
+  /** @return The point query, or nullptr if this is a physical plan. */
+  const std::shared_ptr<PointQuery> &GetPointQuery() const { return point_query_; }
+
+  /** @return The types the binder wants the parameters to be promoted to. */
+  const std::vector<type::TypeId> &GetDesiredParamTypes() const { return desired_param_types_; }
+
+  /** @return The tables the plan reads or writes. */
+  const std::vector<catalog::table_oid_t> &GetTableOids() const { return table_oids_; }
+
+  /** @return False if a DDL change invalidated this plan. */
+  bool IsValid() const { return valid_.load(std::memory_order_acquire); }
+
+ private:
+  friend class PlanCache;
+
+  // The executable query refers to the plan, so it must be destroyed first.
+  const std::shared_ptr<planner::AbstractPlanNode> physical_plan_;
+  const std::shared_ptr<execution::compiler::ExecutableQuery> executable_query_;
+  const std::shared_ptr<PointQuery> point_query_;
+  const std::vector<type::TypeId> desired_param_types_;
+  std::vector<catalog::table_oid_t> table_oids_;
+  std::atomic<bool> valid_{true};
+};
+
+/**
+ * A server-wide cache of physical plans and executable queries, shared by all connections. Entries are keyed by the
+ * database, the query text and the parameter types. Combined with auto-parameterization (see QueryNormalizer), all
+ * statements that only differ in their literals share a single plan, and are bound, optimized and compiled once.
+ *
+ * The cache is split into shards, each protected by its own latch and bounded in size. When a shard is full, its least
+ * recently used entry is evicted.
+ *
+ * DDL changes invalidate the entries depending on the changed tables. Invalidation begins when the DDL statement is
+ * executed and ends when its transaction commits or aborts. Until then, no plan is added to the cache, because
+ * transactions planning concurrently may or may not see the change. A plan is also rejected if an invalidation began
+ * after its binding started, as it may have been planned against the old catalog.
+ */
+class PlanCache {
+ public:
+  /**
+   * Create a cache.
+   * @param max_entries The maximum number of entries.
+   */
+  explicit PlanCache(uint64_t max_entries);
+
+  /**
+   * This class cannot be copied or moved.
+   */
+  DISALLOW_COPY_AND_MOVE(PlanCache);
+
+  /**
+   * @return The generation of the cache. It changes whenever an invalidation begins or ends. Take it before binding a
+   * statement, and pass it to Insert().
+   */
+  uint64_t GetGeneration() const { return generation_.load(); }
+
+  /**
+   * Find the plan for a statement.
+   * @param db_oid The database the statement runs in.
+   * @param query_text The (normalized) query text.
+   * @param param_types The types of the statement's parameters.
+   * @return The cached plan, or null if there is none.
+   */
+  std::shared_ptr<CachedPlan> Lookup(catalog::db_oid_t db_oid, const std::string &query_text,
+                                     const std::vector<type::TypeId> &param_types);
+
+  /**
+   * Add the plan for a statement, unless there already is one, or the plan may be stale.
+   * @param db_oid The database the statement runs in.
+   * @param query_text The (normalized) query text.
+   * @param param_types The types of the statement's parameters.
+   * @param plan The plan.
+   * @param generation The generation of the cache before the statement was bound.
+   * @return True if the plan was added.
+   */
+  bool Insert(catalog::db_oid_t db_oid, const std::string &query_text, const std::vector<type::TypeId> &param_types,
+              std::shared_ptr<CachedPlan> plan, uint64_t generation);
+
+  /**
+   * Begin invalidating the plans that depend on the given table. Must be followed by EndInvalidation().
+   * @param db_oid The database.
+   * @param table_oid The table, or INVALID_TABLE_OID to invalidate all plans in the database.
+   */
+  void BeginInvalidation(catalog::db_oid_t db_oid, catalog::table_oid_t table_oid);
+
+  /**
+   * End invalidating the plans that depend on the given table, once the DDL change is committed or aborted.
+   * @param db_oid The database.
+   * @param table_oid The table, or INVALID_TABLE_OID to invalidate all plans in the database.
+   */
+  void EndInvalidation(catalog::db_oid_t db_oid, catalog::table_oid_t table_oid);
+
+  /**
+   * Remove all entries.
+   */
+  void Clear();
+
+  /** @return The number of entries. */
+  uint64_t GetNumEntries() const;
+
+  /** @return The number of successful lookups. */
+  uint64_t GetNumHits() const { return num_hits_.load(std::memory_order_relaxed); }
+
+  /** @return The number of failed lookups. */
+  uint64_t GetNumMisses() const { return num_misses_.load(std::memory_order_relaxed); }
+
+  /** @return The number of plans added. */
+  uint64_t GetNumInsertions() const { return num_insertions_.load(std::memory_order_relaxed); }
+
+  /** @return The number of entries evicted to stay within the size limit. */
+  uint64_t GetNumEvictions() const { return num_evictions_.load(std::memory_order_relaxed); }
+
+  /** @return The number of entries removed by DDL changes. */
+  uint64_t GetNumInvalidations() const { return num_invalidations_.load(std::memory_order_relaxed); }
+
+ private:
+  static constexpr uint32_t K_NUM_SHARDS = 16;
+
+  struct Entry {
+    // The key. Entries are found by the hash of the key, so a hash collision is resolved by comparing it.
+    catalog::db_oid_t db_oid_;
+    std::string query_text_;
+    std::vector<type::TypeId> param_types_;
+    std::shared_ptr<CachedPlan> plan_;
+    // The position in the shard's LRU list.
+    std::list<common::hash_t>::iterator lru_position_;
+  };
+
+  struct Shard {
+    mutable common::SpinLatch latch_;
+    std::unordered_map<common::hash_t, Entry> entries_;
+    // The hashes of all entries, the most recently used first.
+    std::list<common::hash_t> lru_;
+  };
+
+  static common::hash_t Hash(catalog::db_oid_t db_oid, const std::string &query_text,
+                             const std::vector<type::TypeId> &param_types);
+
+  Shard *GetShard(common::hash_t hash) { return &shards_[hash % K_NUM_SHARDS]; }
+
+  // Remove the plans that depend on the given table, and bump the generation.
+  void Invalidate(catalog::db_oid_t db_oid, catalog::table_oid_t table_oid);
+
+  std::array<Shard, K_NUM_SHARDS> shards_;
+  const uint64_t max_entries_per_shard_;
+  std::atomic<uint64_t> generation_{0};
+  std::atomic<uint64_t> num_pending_invalidations_{0};
+  // Statistics.
+  std::atomic<uint64_t> num_hits_{0};
+  std::atomic<uint64_t> num_misses_{0};
+  std::atomic<uint64_t> num_insertions_{0};
+  std::atomic<uint64_t> num_evictions_{0};
+  std::atomic<uint64_t> num_invalidations_{0};
+};
+
+}  // namespace terrier::trafficcop
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "catalog/catalog_defs.h"
+#include "common/macros.h"
+#include "common/managed_pointer.h"
+#include "network/network_defs.h"
+#include "parser/expression/constant_value_expression.h"
+#include "planner/plannodes/output_schema.h"
+#include "storage/projected_row.h"
+#include "traffic_cop/traffic_cop_defs.h"
+#include "type/type_id.h"
+
+namespace terrier::catalog {
+class CatalogAccessor;
+}  // namespace terrier::catalog
+
+namespace terrier::network {
+class PostgresPacketWriter;
+}  // namespace terrier::network
+
+namespace terrier::parser {
+class AbstractExpression;
+class SQLStatement;
+}  // namespace terrier::parser
+
+namespace terrier::transaction {
+class TransactionContext;
+}  // namespace terrier::transaction
+
+namespace terrier::trafficcop {
+
+/**
+ * A SELECT or UPDATE of at most one row, identified by equality predicates on all columns of a unique index, e.g.,
+ * SELECT a, b FROM t WHERE pk = $1 or UPDATE t SET a = $1 WHERE pk = $2. For such statements, optimization, code
+ * generation and the VM dominate the cost of the index lookup itself, so they are recognized after binding and run
+ * directly against the index and the table instead.
+ *
+ * Eligible are statements on a single table, without DISTINCT, GROUP BY, ORDER BY, LIMIT or UNION, selecting plain
+ * columns, and with a WHERE clause that is a conjunction of column = value predicates, where the columns are exactly
+ * the key columns of a unique index. An UPDATE may only set columns that are not part of any index, so no index has to
+ * be maintained. Values must be constants or parameters of the column's type. Everything else takes the regular path.
+ *
+ * A point query is immutable once created, and may be shared by statements through the PlanCache.
+ */
+class PointQuery {
+ public:
+  /**
+   * Recognize a point query.
+   * @param accessor The catalog accessor of the binding transaction.
+   * @param statement The bound statement.
+   * @return The point query, or nullptr if the statement isn't one.
+   */
+  static std::unique_ptr<PointQuery> Create(common::ManagedPointer<catalog::CatalogAccessor> accessor,
+                                            common::ManagedPointer<parser::SQLStatement> statement);
+
+  /**
+   * This class cannot be copied or moved.
+   */
+  DISALLOW_COPY_AND_MOVE(PointQuery);
+
+  /** @return The table the query reads or writes. */
+  catalog::table_oid_t GetTableOid() const { return table_oid_; }
+
+  /** @return The index the row is looked up in. */
+  catalog::index_oid_t GetIndexOid() const { return index_oid_; }
+
+  /** @return The schema of the rows the query outputs. Empty for an UPDATE. */
+  common::ManagedPointer<planner::OutputSchema> GetOutputSchema() const {
+    return common::ManagedPointer(output_schema_);
+  }
+
+  /**
+   * Run the query. A SELECT writes its row to the client, if the row exists and is visible. A failed UPDATE, i.e., a
+   * write-write conflict, marks the transaction as must-abort.
+   * @param txn The transaction to run in.
+   * @param accessor The catalog accessor of the transaction.
+   * @param db_oid The database the transaction runs in.
+   * @param params The values of the parameters, promoted to the types the binder wants.
+   * @param out The writer for the result rows.
+   * @param result_formats The output formats of the result columns.
+   * @return COMPLETE with the number of rows selected or updated, or ERROR.
+   */
+  TrafficCopResult Execute(common::ManagedPointer<transaction::TransactionContext> txn,
+                           common::ManagedPointer<catalog::CatalogAccessor> accessor, catalog::db_oid_t db_oid,
+                           const std::vector<parser::ConstantValueExpression> &params,
+                           common::ManagedPointer<network::PostgresPacketWriter> out,
+                           const std::vector<network::FieldFormat> &result_formats) const;
+
+ private:
+  // A constant, or a reference to a parameter.
+  struct Value {
+    // The index of the parameter, or -1 for a constant.
+    int32_t param_idx_ = -1;
+    parser::ConstantValueExpression constant_{type::TypeId::INVALID};
+  };
+
+  // A key column of the index and the value it is looked up with.
+  struct KeyColumn {
+    catalog::indexkeycol_oid_t oid_;
+    type::TypeId type_;
+    Value value_;
+  };
+
+  // A column of the table, and its offset in the projected row the query reads or writes.
+  struct TableColumn {
+    catalog::col_oid_t oid_;
+    type::TypeId type_;
+    bool nullable_;
+    uint16_t pr_offset_;
+    // The value an UPDATE sets the column to.
+    Value value_;
+  };
+
+  PointQuery() = default;
+
+  // Recognize the conjunction of equality predicates in a WHERE clause, and the unique index they identify a row in.
+  bool BindKey(common::ManagedPointer<catalog::CatalogAccessor> accessor,
+               common::ManagedPointer<parser::AbstractExpression> where);
+
+  static const parser::ConstantValueExpression &Resolve(const Value &value,
+                                                        const std::vector<parser::ConstantValueExpression> &params);
+
+  bool is_update_ = false;
+  catalog::table_oid_t table_oid_ = catalog::INVALID_TABLE_OID;
+  catalog::index_oid_t index_oid_ = catalog::INVALID_INDEX_OID;
+  std::vector<KeyColumn> key_columns_;
+  // For a SELECT, the columns it reads. For an UPDATE, the columns it sets.
+  std::vector<TableColumn> columns_;
+  std::unique_ptr<storage::ProjectedRowInitializer> pr_initializer_;
+  // For a SELECT, the column of each output column.
+  std::vector<uint16_t> output_columns_;
+  // For a SELECT, the layout of an output row as the PostgresPacketWriter expects it.
+  std::vector<uint32_t> output_offsets_;
+  uint32_t output_row_size_ = 0;
+  std::unique_ptr<planner::OutputSchema> output_schema_;
+};
+
+}  // namespace terrier::trafficcop
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace terrier::parser {
+class ConstantValueExpression;
+}  // namespace terrier::parser
+
+namespace terrier::trafficcop {
+
+/**
+ * Auto-parameterization of query strings. Statements that only differ in their literals, e.g., point lookups with
+ * different keys, are normalized to the same text with the literals replaced by parameters, so that they share a single
+ * cached plan and executable query.
+ *
+ * This works on the text rather than the parse tree, so a cache hit costs no more than a scan of the query string. It
+ * is deliberately conservative: only SELECT, INSERT, UPDATE and DELETE statements are normalized, and only integer and
+ * string literals are replaced, and only where a parameter means the same thing, i.e., as an operand of a comparison,
+ * arithmetic or boolean operator, in a VALUES or IN list, in the select list, or after THEN and ELSE. Literals that
+ * are part of the statement's shape stay: LIMIT and OFFSET counts, ORDER BY and GROUP BY positions, function and
+ * aggregate arguments, typed literals (e.g., DATE '2020-01-01'), casts, and signed numbers.
+ */
+class QueryNormalizer {
+ public:
+  QueryNormalizer() = delete;
+
+  /**
+   * Replace the literals of the given query by parameters $1, $2, ... In the normalized text, runs of whitespace and
+   * comments are collapsed to a single space.
+   * @param query_text The query text as sent by the client.
+   * @param[out] normalized_text The normalized query text.
+   * @param[out] parameters The replaced literals, in the order of their parameters.
+   * @return True if at least one literal was replaced. Otherwise, the outputs are left untouched.
+   */
+  static bool Normalize(const std::string &query_text, std::string *normalized_text,
+                        std::vector<parser::ConstantValueExpression> *parameters);
+};
+
+}  // namespace terrier::trafficcop
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <condition_variable>  // NOLINT
+#include <functional>
+#include <mutex>  // NOLINT
+#include <optional>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "common/macros.h"
+#include "common/managed_pointer.h"
+#include "execution/exec/output.h"
+#include "network/network_defs.h"
+#include "traffic_cop/traffic_cop_defs.h"
+
+namespace terrier::network {
+class ConnectionContext;
+class PostgresPacketWriter;
+}  // namespace terrier::network
+
+namespace terrier::planner {
+class OutputSchema;
+}  // namespace terrier::planner
+
+namespace terrier::trafficcop {
+
+/**
+ * A ResultCursor runs the query of a portal that the client executes with a maximum number of rows, and hands the rows
+ * out as the client fetches them. The rows that the client didn't fetch yet are not produced yet, so the result set is
+ * streamed in bounded memory however large it is.
+ *
+ * The execution engine can't suspend a query, so the cursor runs it on its own thread and holds it in the output
+ * callback once it produced the rows of a fetch, until the next fetch. The query only runs while the connection waits
+ * for a fetch, so the two never use the txn at the same time. The query must be done before its txn ends, so the
+ * cursor registers with the ConnectionContext, and the TrafficCop closes it before it ends the txn. Closing the cursor
+ * cancels the rest of the query rather than running it to its end.
+ */
+class ResultCursor {
+ public:
+  /**
+   * Runs the query, handing its output to the callback
+   */
+  using QueryRunner = std::function<TrafficCopResult(const execution::exec::OutputCallback &)>;
+
+  /**
+   * @param connection_ctx connection whose txn the query runs in
+   * @param run_query runs the query, it's only called on the thread of the cursor
+   * @param schema output schema of the query
+   * @param field_formats formats of the columns, which outlive the cursor
+   */
+  ResultCursor(common::ManagedPointer<network::ConnectionContext> connection_ctx, QueryRunner run_query,
+               common::ManagedPointer<planner::OutputSchema> schema,
+               const std::vector<network::FieldFormat> &field_formats);
+
+  /**
+   * Closes the cursor if it's still open
+   */
+  ~ResultCursor();
+
+  DISALLOW_COPY_AND_MOVE(ResultCursor)
+
+  /**
+   * Lets the query produce the next rows, and blocks until they are written out
+   * @param out packet writer to write the rows to
+   * @param max_rows number of rows to fetch
+   * @return the result of the query, with the number of rows of this fetch, once it's done. std::nullopt if it produced
+   * max_rows rows and may produce more
+   */
+  std::optional<TrafficCopResult> Fetch(common::ManagedPointer<network::PostgresPacketWriter> out, uint32_t max_rows);
+
+  /**
+   * Cancels the rest of the query, and waits for it to stop
+   */
+  void Close();
+
+ private:
+  // Body of the thread of the cursor
+  void RunQuery();
+
+  // Fails the query with the message, and marks its txn as must-abort
+  TrafficCopResult Failed(const char *message) const;
+
+  // Output callback of the query on the thread of the cursor
+  void WriteRows(byte *tuples, uint32_t num_tuples, uint32_t tuple_size);
+
+  const common::ManagedPointer<network::ConnectionContext> connection_ctx_;
+  const QueryRunner run_query_;
+  const common::ManagedPointer<planner::OutputSchema> schema_;
+  const std::vector<network::FieldFormat> &field_formats_;
+
+  std::thread thread_;
+  std::mutex latch_;
+  // Notified when a fetch asks for rows, when the rows of a fetch are written, and when the query is done
+  std::condition_variable cv_;
+  // Packet writer of the current fetch, nullptr while the query is held
+  common::ManagedPointer<network::PostgresPacketWriter> out_ = nullptr;
+  // Number of rows the current fetch still asks for
+  uint32_t remaining_rows_ = 0;
+  // Number of rows written in the current fetch
+  uint32_t num_rows_ = 0;
+  bool closed_ = false;
+  bool done_ = false;
+  TrafficCopResult result_;
+};
+
+}  // namespace terrier::trafficcop
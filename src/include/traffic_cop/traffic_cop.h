@@ -1,6 +1,7 @@
 #pragma once
 #include <memory>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <variant>
 #include <vector>
@@ -9,10 +10,13 @@
 #include "common/managed_pointer.h"
 #include "execution/vm/vm_defs.h"
 #include "network/network_defs.h"
+#include "traffic_cop/plan_cache.h"
+#include "traffic_cop/result_cursor.h"
 #include "traffic_cop/traffic_cop_defs.h"
 
 namespace terrier::catalog {
 class Catalog;
+class CatalogAccessor;
 }  // namespace terrier::catalog
 
 namespace terrier::network {
@@ -47,6 +51,7 @@ class ReplicationLogProvider;
 }  // namespace terrier::storage
 
 namespace terrier::transaction {
+class TransactionContext;
 class TransactionManager;
 }  // namespace terrier::transaction
 
@@ -56,6 +61,8 @@ class ErrorData;
 
 namespace terrier::trafficcop {
 
+class CopyIn;
+
 /**
  * The TrafficCop acts as a translation layer between protocol implementations at at the front-end and execution of
  * queries in the back-end. We strive to encapsulate protocol-agnostic behavior at this layer (i.e. nothing
@@ -67,19 +74,36 @@ class TrafficCop {
   /**
    * @param txn_manager the transaction manager of the system
    * @param catalog the catalog of the system
-   * @param replication_log_provider if given, the tcop will forward replication logs to this provider
+   * @param replication_log_provider if given, the tcop will forward replication logs to this provider and only serve
+   *                                 read-only queries
    * @param settings_manager the settings manager
    * @param stats_storage for optimizer calls
    * @param optimizer_timeout for optimizer calls
    * @param use_query_cache whether to cache physical plans and generated code for Extended Query protocol
-   * @param execution_mode how to run executable queries after code generation
+   * @param execution_mode how to run executable queries after code generation. In adaptive mode, cached queries are
+   *                       interpreted until hot, then compiled in the background
+   * @param plan_cache_size maximum number of plans shared by all connections through the PlanCache, 0 to only cache
+   *                        plans per statement. Ignored if use_query_cache is false
+   * @param auto_parameterization whether to replace the literals of Simple Query protocol statements by parameters, so
+   *                              that statements that only differ in their literals share a cached plan
+   * @param point_query_fast_path whether to run single-row SELECTs and UPDATEs by unique key directly against the index
+   *                              and the table, without optimization and code generation
+   * @param stats_cost_model whether to cost plans by the cardinalities estimated from table statistics, rather than
+   *                         with fixed costs per operator
+   * @param analyze_sample_blocks maximum number of blocks ANALYZE scans in a table, sampled evenly over the table, 0 to
+   *                              scan all blocks
+   * @param auto_analyze_threshold number of rows that must be modified in a table, on top of a fraction of its rows,
+   *                               before it is analyzed automatically, 0 to disable auto-analyze
+   * @param output_batch_size number of result rows the execution engine buffers before they are serialized together
    */
   TrafficCop(common::ManagedPointer<transaction::TransactionManager> txn_manager,
              common::ManagedPointer<catalog::Catalog> catalog,
              common::ManagedPointer<storage::ReplicationLogProvider> replication_log_provider,
              common::ManagedPointer<settings::SettingsManager> settings_manager,
              common::ManagedPointer<optimizer::StatsStorage> stats_storage, uint64_t optimizer_timeout,
-             bool use_query_cache, const execution::vm::ExecutionMode execution_mode)
+             bool use_query_cache, const execution::vm::ExecutionMode execution_mode, uint64_t plan_cache_size,
+             bool auto_parameterization, bool point_query_fast_path, bool stats_cost_model,
+             uint32_t analyze_sample_blocks, uint64_t auto_analyze_threshold, uint32_t output_batch_size)
       : txn_manager_(txn_manager),
         catalog_(catalog),
         replication_log_provider_(replication_log_provider),
@@ -87,7 +111,14 @@ class TrafficCop {
         stats_storage_(stats_storage),
         optimizer_timeout_(optimizer_timeout),
         use_query_cache_(use_query_cache),
-        execution_mode_(execution_mode) {}
+        execution_mode_(execution_mode),
+        plan_cache_(use_query_cache && plan_cache_size > 0 ? std::make_unique<PlanCache>(plan_cache_size) : nullptr),
+        auto_parameterization_(auto_parameterization && plan_cache_ != nullptr),
+        point_query_fast_path_(point_query_fast_path),
+        stats_cost_model_(stats_cost_model),
+        analyze_sample_blocks_(analyze_sample_blocks),
+        auto_analyze_threshold_(auto_analyze_threshold),
+        output_batch_size_(output_batch_size) {}
 
   virtual ~TrafficCop() = default;
 
@@ -97,14 +128,38 @@ class TrafficCop {
    */
   void HandBufferToReplication(std::unique_ptr<network::ReadBuffer> buffer);
 
+  /**
+   * Tells replication that the primary shipped all of its logs
+   */
+  void EndReplication();
+
+  /**
+   * @return whether this is a replica, which only serves read-only queries while it applies the logs of its primary
+   */
+  bool ReadOnly() const { return replication_log_provider_ != DISABLED; }
+
+  /**
+   * @param database_name the name of the database a connection wants to access
+   * @return the OID of the database, INVALID_DATABASE_OID if it doesn't exist
+   */
+  catalog::db_oid_t GetDatabaseOid(const std::string &database_name);
+
   /**
    * Create a temporary namespace for a connection
    * @param connection_id the unique connection ID to use for the namespace name
-   * @param database_name the name of the database the connection is accessing
-   * @return a pair of OIDs for the database and the temporary namespace
+   * @param db_oid the OID of the database the connection is accessing
+   * @return the OID of the temporary namespace, INVALID_NAMESPACE_OID if a concurrent DDL change got in the way
+   */
+  catalog::namespace_oid_t CreateTempNamespace(network::connection_id_t connection_id, catalog::db_oid_t db_oid);
+
+  /**
+   * Connections don't create their temporary namespace when they start up, since most never use it and the DDL change
+   * would dominate the cost of connecting. Instead, it's created the first time it's asked for.
+   * @param connection_ctx context of the connection
+   * @return the OID of the temporary namespace of the connection, INVALID_NAMESPACE_OID if it couldn't be created yet
+   * because of a concurrent DDL change, in which case the caller may retry
    */
-  std::pair<catalog::db_oid_t, catalog::namespace_oid_t> CreateTempNamespace(network::connection_id_t connection_id,
-                                                                             const std::string &database_name);
+  catalog::namespace_oid_t GetTempNamespace(common::ManagedPointer<network::ConnectionContext> connection_ctx);
 
   /**
    * Drop the temporary namespace for a connection and all enclosing database objects
@@ -141,9 +196,11 @@ class TrafficCop {
    * Calls to txn manager to end txn, and updates ConnectionContext state
    * @param connection_ctx context to release its txn
    * @param query_type if the txn is being ended with COMMIT or ROLLBACK
+   * @return ERROR if a COMMIT rolled the txn back instead, because the query of one of its cursors failed as it was
+   * closed, COMPLETE otherwise
    */
-  void EndTransaction(common::ManagedPointer<network::ConnectionContext> connection_ctx,
-                      network::QueryType query_type) const;
+  TrafficCopResult EndTransaction(common::ManagedPointer<network::ConnectionContext> connection_ctx,
+                                  network::QueryType query_type) const;
 
   /**
    * Contains the logic to reason about BEGIN, COMMIT, ROLLBACK execution. Responsible for outputting results, since we
@@ -177,6 +234,48 @@ class TrafficCop {
   TrafficCopResult ExecuteSetStatement(common::ManagedPointer<network::ConnectionContext> connection_ctx,
                                        common::ManagedPointer<network::Statement> statement) const;
 
+  /**
+   * Collects the stats of a table for ANALYZE and stores them in the StatsStorage when the txn commits.
+   * @param connection_ctx context to be used to access the internal txn
+   * @param statement the ANALYZE statement to be executed
+   * @return result of the operation
+   */
+  TrafficCopResult ExecuteAnalyzeStatement(common::ManagedPointer<network::ConnectionContext> connection_ctx,
+                                           common::ManagedPointer<network::Statement> statement) const;
+
+  /**
+   * Starts a COPY ... FROM STDIN, or runs a COPY ... TO STDOUT. Only whole tables can be copied, from and to the
+   * client.
+   * @param connection_ctx context to be used to access the internal txn
+   * @param out packet writer for the rows of a COPY TO
+   * @param statement the COPY statement to be executed
+   * @param[out] copy_in the load of a COPY FROM, which is fed the data the client sends next
+   * @return QUEUING if the client sends the rows next, otherwise the result of the operation
+   */
+  TrafficCopResult ExecuteCopyStatement(common::ManagedPointer<network::ConnectionContext> connection_ctx,
+                                        common::ManagedPointer<network::PostgresPacketWriter> out,
+                                        common::ManagedPointer<network::Statement> statement,
+                                        std::unique_ptr<CopyIn> *copy_in) const;
+
+  /**
+   * Loads the rows of a CopyData message of a COPY ... FROM STDIN.
+   * @param connection_ctx context to be used to access the internal txn
+   * @param copy_in the load of the COPY
+   * @param data the contents of the message
+   * @return QUEUING if the COPY continues, otherwise the error that ended it
+   */
+  TrafficCopResult CopyInData(common::ManagedPointer<network::ConnectionContext> connection_ctx,
+                              common::ManagedPointer<CopyIn> copy_in, std::string_view data) const;
+
+  /**
+   * Finishes a COPY ... FROM STDIN after the client sent all its data.
+   * @param connection_ctx context to be used to access the internal txn
+   * @param copy_in the load of the COPY
+   * @return result of the operation, with the number of rows loaded
+   */
+  TrafficCopResult EndCopyIn(common::ManagedPointer<network::ConnectionContext> connection_ctx,
+                             common::ManagedPointer<CopyIn> copy_in) const;
+
   /**
    * Contains the logic to reason about CREATE execution.
    * @param connection_ctx context to be used to access the internal txn
@@ -212,7 +311,7 @@ class TrafficCop {
                                        common::ManagedPointer<network::Portal> portal) const;
   /**
    * Contains the logic to reason about DML execution. Responsible for outputting results because we don't want to
-   * (can't) stick it in TrafficCopResult.
+   * (can't) stick it in TrafficCopResult. The execution context is reused across the executions of an INSERT portal.
    * @param connection_ctx context to be used to access the internal txn
    * @param out packet writer to return results
    * @param portal to be executed, may contain parameters
@@ -222,6 +321,27 @@ class TrafficCop {
                                       common::ManagedPointer<network::PostgresPacketWriter> out,
                                       common::ManagedPointer<network::Portal> portal) const;
 
+  /**
+   * Sets up the execution of a SELECT whose rows the client fetches a limited number at a time. The query only runs
+   * while the cursor is fetched from.
+   * @param connection_ctx context to be used to access the internal txn
+   * @param portal to be executed, its executable query must be generated already
+   * @return cursor to fetch the rows from
+   */
+  std::unique_ptr<ResultCursor> OpenCursor(common::ManagedPointer<network::ConnectionContext> connection_ctx,
+                                           common::ManagedPointer<network::Portal> portal) const;
+
+  /**
+   * Run a statement recognized as a PointQuery during binding. Responsible for outputting results.
+   * @param connection_ctx context to be used to access the internal txn
+   * @param out packet writer to return results
+   * @param portal to be executed, may contain parameters
+   * @return result of the operation
+   */
+  TrafficCopResult RunPointQuery(common::ManagedPointer<network::ConnectionContext> connection_ctx,
+                                 common::ManagedPointer<network::PostgresPacketWriter> out,
+                                 common::ManagedPointer<network::Portal> portal) const;
+
   /**
    * Adjust the TrafficCop's optimizer timeout value (for use by SettingsManager)
    * @param optimizer_timeout time in ms to spend on a task @see optimizer::Optimizer constructor
@@ -229,11 +349,49 @@ class TrafficCop {
   void SetOptimizerTimeout(const uint64_t optimizer_timeout) { optimizer_timeout_ = optimizer_timeout; }
 
   /**
-   * @return true if query caching enabled, false otherwise
+   * @return true if query caching enabled, false otherwise. A replica doesn't cache queries, since the DDL it replays
+   * doesn't invalidate them.
+   */
+  bool UseQueryCache() const { return use_query_cache_ && !ReadOnly(); }
+
+  /**
+   * @return true if the literals of Simple Query protocol statements are replaced by parameters
+   */
+  bool UseAutoParameterization() const { return auto_parameterization_; }
+
+  /**
+   * @return the plans shared by all connections, nullptr if disabled
    */
-  bool UseQueryCache() const { return use_query_cache_; }
+  common::ManagedPointer<PlanCache> GetPlanCache() const { return common::ManagedPointer(plan_cache_); }
 
  private:
+  // Tiering only pays off if the executable query outlives this execution, i.e., if it is cached.
+  execution::vm::ExecutionMode QueryExecutionMode() const {
+    return execution_mode_ == execution::vm::ExecutionMode::Adaptive && !UseQueryCache()
+               ? execution::vm::ExecutionMode::Interpret
+               : execution_mode_;
+  }
+
+  // True if the statements of the connection's current txn may use and publish shared plans
+  bool UsePlanCache(common::ManagedPointer<network::ConnectionContext> connection_ctx) const;
+
+  // True if all tables a shared plan reads or writes are visible to the connection's current txn
+  static bool TablesVisible(common::ManagedPointer<network::ConnectionContext> connection_ctx,
+                            const CachedPlan &cached_plan);
+
+  // Invalidate the cached plans depending on the given table (or all tables of the database) changed by DDL
+  void InvalidateCachedPlans(common::ManagedPointer<network::ConnectionContext> connection_ctx,
+                             catalog::db_oid_t db_oid, catalog::table_oid_t table_oid) const;
+
+  // Scan the given columns of a table and store their stats when the txn commits
+  void AnalyzeTable(common::ManagedPointer<transaction::TransactionContext> txn,
+                    common::ManagedPointer<catalog::CatalogAccessor> accessor, catalog::db_oid_t db_oid,
+                    catalog::table_oid_t table_oid, std::vector<catalog::col_oid_t> col_oids) const;
+
+  // Count rows modified by DML towards the next automatic ANALYZE of the table, and analyze it once enough were
+  void CountModifiedRows(common::ManagedPointer<network::ConnectionContext> connection_ctx,
+                         catalog::table_oid_t table_oid, uint64_t num_rows) const;
+
   common::ManagedPointer<transaction::TransactionManager> txn_manager_;
   common::ManagedPointer<catalog::Catalog> catalog_;
   // Hands logs off to replication component. TCop should forward these logs through this provider.
@@ -243,6 +401,13 @@ class TrafficCop {
   uint64_t optimizer_timeout_;
   const bool use_query_cache_;
   const execution::vm::ExecutionMode execution_mode_;
+  const std::unique_ptr<PlanCache> plan_cache_;
+  const bool auto_parameterization_;
+  const bool point_query_fast_path_;
+  const bool stats_cost_model_;
+  const uint32_t analyze_sample_blocks_;
+  const uint64_t auto_analyze_threshold_;
+  const uint32_t output_batch_size_;
 };
 
 }  // namespace terrier::trafficcop
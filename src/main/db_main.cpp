@@ -12,7 +12,9 @@ namespace terrier {
 void DBMain::Run() {
   TERRIER_ASSERT(network_layer_ != DISABLED, "Trying to run without a NetworkLayer.");
   const auto server = network_layer_->GetServer();
+  const auto replication_server = network_layer_->GetReplicationServer();
   try {
+    if (replication_server != nullptr) replication_server->RunServer();
     server->RunServer();
   } catch (NetworkProcessException &e) {
     return;
@@ -27,12 +29,29 @@ void DBMain::ForceShutdown() {
   if (network_layer_ != DISABLED && network_layer_->GetServer()->Running()) {
     network_layer_->GetServer()->StopServer();
   }
+  if (network_layer_ != DISABLED && network_layer_->GetReplicationServer() != nullptr &&
+      network_layer_->GetReplicationServer()->Running()) {
+    network_layer_->GetReplicationServer()->StopServer();
+  }
 }
 
 DBMain::~DBMain() { ForceShutdown(); }
 
-DBMain::ExecutionLayer::ExecutionLayer() { execution::ExecutionUtil::InitTPL(); }
+DBMain::ExecutionLayer::ExecutionLayer(const std::string &jit_object_cache_directory,
+                                       const uint64_t jit_object_cache_size) {
+  execution::ExecutionUtil::InitTPL();
+  if (!jit_object_cache_directory.empty()) {
+    jit_object_cache_ =
+        std::make_unique<execution::vm::JitObjectCache>(jit_object_cache_directory, jit_object_cache_size);
+    execution::vm::JitObjectCache::SetInstance(jit_object_cache_.get());
+  }
+}
 
-DBMain::ExecutionLayer::~ExecutionLayer() { execution::ExecutionUtil::ShutdownTPL(); }
+DBMain::ExecutionLayer::~ExecutionLayer() {
+  if (jit_object_cache_ != nullptr) {
+    execution::vm::JitObjectCache::SetInstance(nullptr);
+  }
+  execution::ExecutionUtil::ShutdownTPL();
+}
 
 }  // namespace terrier
@@ -32,6 +32,19 @@ void OpenFiles(std::vector<std::ofstream> *outfiles) {
   }
 }
 
+template <typename abstract_raw_data>
+void OpenTraceFiles(std::vector<std::ofstream> *outfiles) {
+  const auto num_files = abstract_raw_data::FILES.size();
+  outfiles->reserve(num_files);
+  for (size_t file = 0; file < num_files; file++) {
+    const auto file_name = std::string(abstract_raw_data::FILES[file]);
+    const auto file_existed = FileExists(file_name);
+    outfiles->emplace_back(file_name, std::ios_base::out | std::ios_base::app);
+    // the closing bracket of the array of events is optional in Chrome's trace format, so it is left out
+    if (!file_existed) outfiles->back() << "[" << std::endl;
+  }
+}
+
 void MetricsManager::Aggregate() {
   common::SpinLatch::ScopedSpinLatch guard(&latch_);
   for (const auto &metrics_store : stores_map_) {
@@ -86,6 +99,16 @@ void MetricsManager::ResetMetric(const MetricsComponent component) const {
         metric->Swap();
         break;
       }
+      case MetricsComponent::OPTIMIZER: {
+        const auto &metric = metrics_store.second->optimizer_metric_;
+        metric->Swap();
+        break;
+      }
+      case MetricsComponent::QUERY_TRACE: {
+        const auto &metric = metrics_store.second->query_trace_metric_;
+        metric->Swap();
+        break;
+      }
     }
   }
 }
@@ -146,6 +169,14 @@ void MetricsManager::ToCSV() const {
           OpenFiles<ExecuteCommandMetricRawData>(&outfiles);
           break;
         }
+        case MetricsComponent::OPTIMIZER: {
+          OpenFiles<OptimizerMetricRawData>(&outfiles);
+          break;
+        }
+        case MetricsComponent::QUERY_TRACE: {
+          OpenTraceFiles<QueryTraceMetricRawData>(&outfiles);
+          break;
+        }
       }
       aggregated_metrics_[component]->ToCSV(&outfiles);
       for (auto &file : outfiles) {
@@ -0,0 +1,26 @@
+#include "metrics/query_trace.h"
+
+#include "common/thread_context.h"
+#include "metrics/metrics_store.h"
+
+namespace terrier::metrics {
+
+bool QueryTrace::Enabled() {
+  return common::thread_context.metrics_store_ != nullptr &&
+         common::thread_context.metrics_store_->ComponentEnabled(MetricsComponent::QUERY_TRACE);
+}
+
+bool QueryTrace::Sample() {
+  return common::thread_context.metrics_store_ != nullptr &&
+         common::thread_context.metrics_store_->ComponentToRecord(MetricsComponent::QUERY_TRACE);
+}
+
+void QueryTrace::Record(const TraceSpan span, const uint32_t connection_id, const uint64_t query_id,
+                        const uint64_t start_us, const uint64_t detail) {
+  // The component may have been disabled since the request was sampled
+  if (!Enabled()) return;
+  common::thread_context.metrics_store_->RecordQueryTraceData(span, connection_id, query_id, start_us,
+                                                              MetricsUtil::Now(), detail);
+}
+
+}  // namespace terrier::metrics
@@ -7,6 +7,7 @@
 #include <utility>
 
 #include "common/utility.h"
+#include "metrics/query_trace.h"
 #include "network/connection_dispatcher_task.h"
 #include "network/connection_handle_factory.h"
 #include "network/terrier_server.h"
@@ -160,11 +161,34 @@ END_DEF
   }
 }
 
+Transition ConnectionHandle::TryRead() {
+  // The network read of a request starts with the read of its first bytes
+  if (!io_wrapper_->GetReadBuffer()->HasMore() && metrics::QueryTrace::Enabled()) {
+    context_.SetReadStartTime(metrics::MetricsUtil::Now());
+  }
+  return io_wrapper_->FillReadBuffer();
+}
+
+Transition ConnectionHandle::TryWrite() {
+  if (!io_wrapper_->ShouldFlush()) return Transition::PROCEED;
+
+  const uint64_t query_trace_id = context_.QueryTraceId();
+  if (query_trace_id != 0 && flush_start_us_ == 0) flush_start_us_ = metrics::MetricsUtil::Now();
+  const Transition result = io_wrapper_->FlushAllWrites();
+  if (query_trace_id != 0 && result != Transition::NEED_WRITE) {
+    // The trace of a request ends once its results reached the client
+    metrics::QueryTrace::Record(metrics::TraceSpan::RESULT_FLUSH, context_.GetConnectionID().UnderlyingValue(),
+                                query_trace_id, flush_start_us_);
+    context_.EndQueryTrace();
+    flush_start_us_ = 0;
+  }
+  return result;
+}
+
 Transition ConnectionHandle::GetResult() {
   EventUtil::EventAdd(network_event_, nullptr);
-  protocol_interpreter_->GetResult(io_wrapper_->GetWriteQueue());
   NETWORK_LOG_TRACE("GetResult");
-  return Transition::PROCEED;
+  return protocol_interpreter_->GetResult(io_wrapper_->GetWriteQueue());
 }
 
 Transition ConnectionHandle::TryCloseConnection() {
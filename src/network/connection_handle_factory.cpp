@@ -17,7 +17,9 @@ ConnectionHandle &ConnectionHandleFactory::NewConnectionHandle(int conn_fd,
 
     it = reusable_handles_.find(conn_fd);
     if (it == reusable_handles_.end()) {
-      auto ret = reusable_handles_.try_emplace(conn_fd, conn_fd, handler, traffic_cop_, std::move(interpreter));
+      auto ret = reusable_handles_.try_emplace(conn_fd, conn_fd, handler, traffic_cop_, std::move(interpreter),
+                                                 vectored_writes_, shared_memory_ring_size_, write_queue_limit_,
+                                                 write_timeout_);
       TERRIER_ASSERT(ret.second, "ret.second false");
       return ret.first->second;
     }
@@ -31,7 +33,10 @@ ConnectionHandle &ConnectionHandleFactory::NewConnectionHandle(int conn_fd,
   reused_handle.protocol_interpreter_ = std::move(interpreter);
   reused_handle.state_machine_ = ConnectionHandle::StateMachine();
   reused_handle.context_.Reset();
+  reused_handle.flush_start_us_ = 0;
+  reused_handle.context_.SetCallback(ConnectionHandle::Callback, &reused_handle);
   reused_handle.context_.SetConnectionID(static_cast<connection_id_t>(conn_fd));
+  reused_handle.context_.SetIoWrapper(common::ManagedPointer(reused_handle.io_wrapper_));
   TERRIER_ASSERT(reused_handle.network_event_ == nullptr, "network_event_ != nullptr");
   TERRIER_ASSERT(reused_handle.workpool_event_ == nullptr, "network_event_ != nullptr");
   return reused_handle;
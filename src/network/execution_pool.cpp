@@ -0,0 +1,69 @@
+#include "network/execution_pool.h"
+
+#include <utility>
+
+#include "common/dedicated_thread_registry.h"
+
+namespace terrier::network {
+
+void ExecutionWorkerTask::RunTask() { pool_->RunWorker(); }
+
+void ExecutionWorkerTask::Terminate() { pool_->Terminate(); }
+
+void ExecutionPool::Start() {
+  TERRIER_ASSERT(workers_.empty(), "ExecutionPool is already started.");
+  {
+    std::lock_guard<std::mutex> guard(latch_);
+    running_ = true;
+  }
+  workers_.reserve(num_workers_);
+  for (uint32_t i = 0; i < num_workers_; i++) {
+    workers_.emplace_back(thread_registry_->RegisterDedicatedThread<ExecutionWorkerTask>(
+        this /* requester */, common::ManagedPointer(this)));
+  }
+}
+
+void ExecutionPool::Stop() {
+  Terminate();
+  for (const auto worker : workers_) {
+    const bool result UNUSED_ATTRIBUTE =
+        thread_registry_->StopTask(this, worker.CastManagedPointerTo<common::DedicatedThreadTask>());
+    TERRIER_ASSERT(result, "Failed to stop ExecutionWorkerTask.");
+  }
+  workers_.clear();
+}
+
+bool ExecutionPool::Submit(std::function<void()> command) {
+  {
+    std::lock_guard<std::mutex> guard(latch_);
+    if (!running_) return false;
+    commands_.emplace(std::move(command));
+  }
+  commands_cv_.notify_one();
+  return true;
+}
+
+void ExecutionPool::RunWorker() {
+  while (true) {
+    std::function<void()> command;
+    {
+      std::unique_lock<std::mutex> lock(latch_);
+      commands_cv_.wait(lock, [&] { return !commands_.empty() || !running_; });
+      // Commands that were accepted are still run after the pool is stopped, since their connections wait for them
+      if (commands_.empty()) return;
+      command = std::move(commands_.front());
+      commands_.pop();
+    }
+    command();
+  }
+}
+
+void ExecutionPool::Terminate() {
+  {
+    std::lock_guard<std::mutex> guard(latch_);
+    running_ = false;
+  }
+  commands_cv_.notify_all();
+}
+
+}  // namespace terrier::network
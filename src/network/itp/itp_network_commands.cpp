@@ -16,9 +16,19 @@ Transition ReplicationCommand::Exec(common::ManagedPointer<ProtocolInterpreter>
                                     common::ManagedPointer<ITPPacketWriter> out,
                                     common::ManagedPointer<trafficcop::TrafficCop> t_cop,
                                     common::ManagedPointer<ConnectionContext> connection) {
-  std::unique_ptr<ReadBuffer> buffer;
-  buffer->FillBufferFrom(in_, in_len_);
+  // The logs follow the message id and their size
+  const size_t header_size = 2 * sizeof(uint64_t);
+  const auto message_id = in_len_ >= header_size ? in_.ReadValue<uint64_t>() : 0;
+  if (in_len_ < header_size || in_.ReadValue<uint64_t>() != in_len_ - header_size) {
+    NETWORK_LOG_ERROR("Malformed replication command of {0} bytes", in_len_);
+    return Transition::TERMINATE;
+  }
+  const size_t data_size = in_len_ - header_size;
+  auto buffer = std::make_unique<ReadBuffer>(data_size);
+  buffer->FillBufferFrom(in_, data_size);
   t_cop->HandBufferToReplication(std::move(buffer));
+  // The primary may count the logs as replicated once they arrived, before they are applied
+  out->WriteCommandComplete(message_id);
   return Transition::PROCEED;
 }
 
@@ -26,8 +36,9 @@ Transition StopReplicationCommand::Exec(common::ManagedPointer<ProtocolInterpret
                                         common::ManagedPointer<ITPPacketWriter> out,
                                         common::ManagedPointer<trafficcop::TrafficCop> t_cop,
                                         common::ManagedPointer<ConnectionContext> connection) {
-  // TODO(Tianlei): modify this implementation for the complete ITP protocol
-  return Transition::PROCEED;
+  // The primary shuts down, and the logs it shipped so far are all the replica gets
+  t_cop->EndReplication();
+  return Transition::TERMINATE;
 }
 
 }  // namespace terrier::network
@@ -15,7 +15,8 @@ Transition ITPProtocolInterpreter::Process(common::ManagedPointer<ReadBuffer> in
                                            common::ManagedPointer<trafficcop::TrafficCop> t_cop,
                                            common::ManagedPointer<ConnectionContext> context) {
   try {
-    if (!TryBuildPacket(in)) return Transition::NEED_READ_TIMEOUT;
+    // The primary has nothing to ship while it does not write, so the connection does not time out
+    if (!TryBuildPacket(in)) return Transition::NEED_READ;
   } catch (std::exception &e) {
     NETWORK_LOG_ERROR("Encountered exception {0} when parsing packet", e.what());
     return Transition::TERMINATE;
@@ -29,9 +30,9 @@ Transition ITPProtocolInterpreter::Process(common::ManagedPointer<ReadBuffer> in
   return ret;
 }
 
-void ITPProtocolInterpreter::GetResult(const common::ManagedPointer<WriteQueue> out) {
-  ITPPacketWriter writer(out);
-  writer.WriteCommandComplete();
+Transition ITPProtocolInterpreter::GetResult(const common::ManagedPointer<WriteQueue> out) {
+  // Every command completes before Exec returns and acknowledges its message itself
+  return Transition::PROCEED;
 }
 
 size_t ITPProtocolInterpreter::GetPacketHeaderSize() { return 1 + sizeof(uint32_t); }
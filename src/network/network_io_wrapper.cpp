@@ -2,18 +2,37 @@
 
 #include <arpa/inet.h>
 #include <netinet/tcp.h>
+#include <poll.h>
 #include <sys/file.h>
+#include <sys/socket.h>
 
+#include <algorithm>
+#include <chrono>  //NOLINT
+#include <cstring>
 #include <memory>
+#include <utility>
 
 #include "network/terrier_server.h"
 
 namespace terrier::network {
 Transition NetworkIoWrapper::FlushAllWrites() {
-  for (auto flush_head = out_->FlushHead(); flush_head != nullptr; out_->MarkHeadFlushed()) {
+  if (shared_memory_ != nullptr) return FlushAllWritesToSharedMemory();
+  if (vectored_writes_) {
+    while (out_->FlushHead() != nullptr) {
+      if (out_->WriteOutTo(sock_fd_) < 0) {
+        const auto result = WriteFailed();
+        if (result != Transition::PROCEED) return result;
+      }
+    }
+    out_->Reset();
+    return Transition::PROCEED;
+  }
+
+  // A buffer is only marked as flushed once it is written out completely, so a flush that would block resumes there
+  for (auto flush_head = out_->FlushHead(); flush_head != nullptr; flush_head = out_->FlushHead()) {
     const auto result = FlushWriteBuffer(flush_head);
     if (result != Transition::PROCEED) return result;
-    flush_head = out_->FlushHead();
+    out_->MarkHeadFlushed();
   }
   out_->Reset();
   return Transition::PROCEED;
@@ -22,11 +41,14 @@ Transition NetworkIoWrapper::FlushAllWrites() {
 Transition NetworkIoWrapper::FillReadBuffer() {
   if (!in_->HasMore()) in_->Reset();
   if (in_->HasMore() && in_->Full()) in_->MoveContentToHead();
+  if (shared_memory_ != nullptr) return FillReadBufferFromSharedMemory();
   Transition result = Transition::NEED_READ;
   // Normal mode
   while (!in_->Full()) {
     auto bytes_read = in_->FillBufferFrom(sock_fd_);
     if (bytes_read > 0) {
+      // A read that leaves room in the buffer drained the socket, so reading again would only return EAGAIN
+      if (!in_->Full()) return Transition::PROCEED;
       result = Transition::PROCEED;
     } else {
       if (bytes_read == 0) {
@@ -52,24 +74,146 @@ Transition NetworkIoWrapper::FlushWriteBuffer(const common::ManagedPointer<Write
   while (wbuf->HasMore()) {
     auto bytes_written = wbuf->WriteOutTo(sock_fd_);
     if (bytes_written < 0) {
-      switch (errno) {
-        case EINTR:
-          continue;
-        case EAGAIN:
-          return Transition::NEED_WRITE;
-        case EPIPE:
-          NETWORK_LOG_TRACE("Client closed during write");
-          return Transition::TERMINATE;
-        default:
-          NETWORK_LOG_ERROR("Error writing: %s", strerror(errno));
-          throw NETWORK_PROCESS_EXCEPTION("Fatal error during write");
-      }
+      const auto result = WriteFailed();
+      if (result != Transition::PROCEED) return result;
     }
   }
   wbuf->Reset();
   return Transition::PROCEED;
 }
 
+Transition NetworkIoWrapper::WriteFailed() {
+  switch (errno) {
+    case EINTR:
+      return Transition::PROCEED;
+    case EAGAIN:
+      return Transition::NEED_WRITE;
+    case EPIPE:
+      NETWORK_LOG_TRACE("Client closed during write");
+      return Transition::TERMINATE;
+    default:
+      NETWORK_LOG_ERROR("Error writing: %s", strerror(errno));
+      throw NETWORK_PROCESS_EXCEPTION("Fatal error during write");
+  }
+}
+
+bool NetworkIoWrapper::StartSharedMemory(uchar answer) {
+  sockaddr_storage addr;
+  socklen_t addr_len = sizeof(addr);
+  if (shared_memory_ring_size_ == 0 || getsockname(sock_fd_, reinterpret_cast<sockaddr *>(&addr), &addr_len) != 0 ||
+      addr.ss_family != AF_UNIX) {
+    return false;
+  }
+  auto shared_memory = SharedMemoryChannel::Create(shared_memory_ring_size_);
+  if (shared_memory == nullptr) return false;
+
+  // The answer is the only byte on the socket, so it is sent right away
+  iovec data{&answer, 1};
+  alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))] = {};
+  msghdr message{};
+  message.msg_iov = &data;
+  message.msg_iovlen = 1;
+  message.msg_control = control;
+  message.msg_controllen = sizeof(control);
+  cmsghdr *const fd_message = CMSG_FIRSTHDR(&message);
+  fd_message->cmsg_level = SOL_SOCKET;
+  fd_message->cmsg_type = SCM_RIGHTS;
+  fd_message->cmsg_len = CMSG_LEN(sizeof(int));
+  const int fd = shared_memory->GetFd();
+  std::memcpy(CMSG_DATA(fd_message), &fd, sizeof(int));
+  if (sendmsg(sock_fd_, &message, 0) != 1) {
+    NETWORK_LOG_ERROR("Failed to send shared memory segment: {0}", strerror(errno));
+    return false;
+  }
+  shared_memory_ = std::move(shared_memory);
+  return true;
+}
+
+Transition NetworkIoWrapper::FillReadBufferFromSharedMemory() {
+  const Transition result = DrainWakeups();
+  if (result != Transition::PROCEED) return result;
+  if (in_->FillBufferFrom(common::ManagedPointer(shared_memory_)) == 0) return Transition::NEED_READ;
+  WakeUpPeer();
+  return Transition::PROCEED;
+}
+
+Transition NetworkIoWrapper::FlushAllWritesToSharedMemory() {
+  const Transition result = DrainWakeups();
+  if (result != Transition::PROCEED) return result;
+  auto flush_head = out_->FlushHead();
+  for (; flush_head != nullptr; flush_head = out_->FlushHead()) {
+    flush_head->WriteOutTo(common::ManagedPointer(shared_memory_));
+    if (flush_head->HasMore()) break;
+    out_->MarkHeadFlushed();
+  }
+  WakeUpPeer();
+  // The client makes room as it reads, and wakes the connection up through the socket if it sleeps
+  waiting_for_space_ = flush_head != nullptr;
+  if (waiting_for_space_) return Transition::NEED_READ;
+  out_->Reset();
+  return Transition::PROCEED;
+}
+
+void NetworkIoWrapper::FlushAllWritesAndWait() {
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(write_timeout_);
+  while (true) {
+    const Transition result = FlushAllWrites();
+    if (result == Transition::PROCEED) break;
+    if (result == Transition::TERMINATE) {
+      out_->Reset();
+      break;
+    }
+    // A full socket becomes writable once the client read from it. A client on shared memory makes room in the ring
+    // and then wakes the connection up through the socket.
+    if (result == Transition::NEED_READ && !PrepareToWait()) continue;
+    pollfd fd{sock_fd_, static_cast<int16_t>(result == Transition::NEED_WRITE ? POLLOUT : POLLIN), 0};
+    int ready;
+    do {
+      int timeout = -1;
+      if (write_timeout_ != 0) {
+        const auto remaining =
+            std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+        timeout = static_cast<int>(std::max<int64_t>(remaining, 0));
+      }
+      ready = poll(&fd, 1, timeout);
+    } while (ready < 0 && errno == EINTR);
+    if (ready == 0) {
+      // The worker is given back, and the queued bytes are flushed whenever the client reads them
+      out_->ForceFlush();
+      throw EXECUTION_EXCEPTION("Client did not read the query results within network_write_timeout",
+                                common::ErrorCode::ERRCODE_QUERY_CANCELED);
+    }
+  }
+  // The queue was due for a flush, so the rest of the result is flushed as soon as the command is done as well
+  out_->ForceFlush();
+}
+
+Transition NetworkIoWrapper::DrainWakeups() {
+  char wakeups[64];
+  while (true) {
+    const ssize_t bytes_read = read(sock_fd_, wakeups, sizeof(wakeups));
+    if (bytes_read > 0) continue;
+    if (bytes_read == 0) return Transition::TERMINATE;
+    switch (errno) {
+      case EAGAIN:
+        return Transition::PROCEED;
+      case EINTR:
+        continue;
+      default:
+        NETWORK_LOG_ERROR("Error reading: {0}", strerror(errno));
+        throw NETWORK_PROCESS_EXCEPTION("Error when reading wakeups");
+    }
+  }
+}
+
+void NetworkIoWrapper::WakeUpPeer() {
+  if (!shared_memory_->PeerWaiting()) return;
+  const char wakeup = 0;
+  // A full socket already holds wakeups the client has yet to read, and a closed one is noticed by the next read
+  while (write(sock_fd_, &wakeup, 1) < 0 && errno == EINTR) {
+  }
+}
+
 void NetworkIoWrapper::RestartState() {
   // Set Non Blocking
   auto flags = fcntl(sock_fd_, F_GETFL);
@@ -83,6 +227,8 @@ void NetworkIoWrapper::RestartState() {
 
   in_->Reset();
   out_->Reset();
+  shared_memory_.reset();
+  waiting_for_space_ = false;
 }
 
 void NetworkIoWrapper::Restart() { RestartState(); }
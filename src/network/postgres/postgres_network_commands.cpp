@@ -1,8 +1,11 @@
 #include "network/postgres/postgres_network_commands.h"
 
+#include <array>
 #include <memory>
 #include <string>
+#include <utility>
 #include <variant>
+#include <vector>
 
 #include "common/thread_context.h"
 #include "metrics/metrics_store.h"
@@ -10,6 +13,7 @@
 #include "network/postgres/postgres_packet_util.h"
 #include "network/postgres/postgres_protocol_interpreter.h"
 #include "network/postgres/statement.h"
+#include "traffic_cop/query_normalizer.h"
 #include "traffic_cop/traffic_cop.h"
 
 namespace terrier::network {
@@ -20,6 +24,43 @@ static Transition FinishSimpleQueryCommand(const common::ManagedPointer<Postgres
   return Transition::PROCEED;
 }
 
+static void ExecuteAnalyze(const common::ManagedPointer<network::ConnectionContext> connection_ctx,
+                           const common::ManagedPointer<network::Statement> statement,
+                           const common::ManagedPointer<network::PostgresPacketWriter> out,
+                           const common::ManagedPointer<trafficcop::TrafficCop> t_cop) {
+  const auto result = t_cop->ExecuteAnalyzeStatement(connection_ctx, statement);
+  if (result.type_ == trafficcop::ResultType::COMPLETE) {
+    out->WriteCommandComplete(network::QueryType::QUERY_ANALYZE, 0);
+  } else {
+    TERRIER_ASSERT(std::holds_alternative<common::ErrorData>(result.extra_), "We're expecting a message here.");
+    out->WriteError(std::get<common::ErrorData>(result.extra_));
+  }
+}
+
+// Returns true if the client sends the rows of a COPY ... FROM STDIN next
+static bool ExecuteCopy(const common::ManagedPointer<network::ConnectionContext> connection_ctx,
+                        const common::ManagedPointer<network::Statement> statement,
+                        const common::ManagedPointer<network::PostgresPacketWriter> out,
+                        const common::ManagedPointer<trafficcop::TrafficCop> t_cop,
+                        const common::ManagedPointer<network::PostgresProtocolInterpreter> postgres_interpreter) {
+  std::unique_ptr<trafficcop::CopyIn> copy_in;
+  const auto result = t_cop->ExecuteCopyStatement(connection_ctx, out, statement, &copy_in);
+  if (result.type_ == trafficcop::ResultType::QUEUING) {
+    const auto format =
+        copy_in->GetFormat() == parser::ExternalFileFormat::BINARY ? FieldFormat::binary : FieldFormat::text;
+    out->WriteCopyInResponse(format, copy_in->NumColumns());
+    postgres_interpreter->SetCopyIn(std::move(copy_in));
+    return true;
+  }
+  if (result.type_ == trafficcop::ResultType::COMPLETE) {
+    out->WriteCommandComplete(network::QueryType::QUERY_COPY, std::get<uint32_t>(result.extra_));
+  } else {
+    TERRIER_ASSERT(std::holds_alternative<common::ErrorData>(result.extra_), "We're expecting a message here.");
+    out->WriteError(std::get<common::ErrorData>(result.extra_));
+  }
+  return false;
+}
+
 static void ExecutePortal(const common::ManagedPointer<network::ConnectionContext> connection_ctx,
                           const common::ManagedPointer<Portal> portal,
                           const common::ManagedPointer<network::PostgresPacketWriter> out,
@@ -31,12 +72,17 @@ static void ExecutePortal(const common::ManagedPointer<network::ConnectionContex
 
   // This logic relies on ordering of values in the enum's definition and is documented there as well.
   if (NetworkUtil::DMLQueryType(query_type)) {
-    // DML query to put through codegen
-    result = t_cop->CodegenPhysicalPlan(connection_ctx, out, portal);
+    if (portal->GetStatement()->GetPointQuery() != nullptr) {
+      // single-row lookup or update by unique key, run directly against the index
+      result = t_cop->RunPointQuery(connection_ctx, out, portal);
+    } else {
+      // DML query to put through codegen
+      result = t_cop->CodegenPhysicalPlan(connection_ctx, out, portal);
 
-    // TODO(Matt): do something with result here in case codegen fails
+      // TODO(Matt): do something with result here in case codegen fails
 
-    result = t_cop->RunExecutableQuery(connection_ctx, out, portal);
+      result = t_cop->RunExecutableQuery(connection_ctx, out, portal);
+    }
   } else if (NetworkUtil::CreateQueryType(query_type)) {
     if (explicit_txn_block && query_type == network::QueryType::QUERY_CREATE_DB) {
       out->WriteError({common::ErrorSeverity::ERROR, "CREATE DATABASE cannot run inside a transaction block",
@@ -72,6 +118,29 @@ static void ExecutePortal(const common::ManagedPointer<network::ConnectionContex
   }
 }
 
+// Fetch the next rows of a SELECT portal, continuing its suspended execution if it was executed before
+static void FetchFromPortal(const common::ManagedPointer<network::ConnectionContext> connection_ctx,
+                            const common::ManagedPointer<Portal> portal,
+                            const common::ManagedPointer<network::PostgresPacketWriter> out,
+                            const common::ManagedPointer<trafficcop::TrafficCop> t_cop, const uint32_t max_rows) {
+  if (portal->GetCursor() == nullptr) {
+    // TODO(Matt): do something with result here in case codegen fails
+    t_cop->CodegenPhysicalPlan(connection_ctx, out, portal);
+    portal->SetCursor(t_cop->OpenCursor(connection_ctx, portal));
+  }
+
+  const auto result = portal->GetCursor()->Fetch(out, max_rows);
+  if (!result.has_value()) {
+    // The client executes the portal again for the following rows
+    out->WritePortalSuspended();
+  } else if (result->type_ == trafficcop::ResultType::COMPLETE) {
+    out->WriteCommandComplete(network::QueryType::QUERY_SELECT, std::get<uint32_t>(result->extra_));
+  } else {
+    TERRIER_ASSERT(result->type_ == trafficcop::ResultType::ERROR, "A query only completes or fails.");
+    out->WriteError(std::get<common::ErrorData>(result->extra_));
+  }
+}
+
 Transition SimpleQueryCommand::Exec(const common::ManagedPointer<ProtocolInterpreter> interpreter,
                                     const common::ManagedPointer<PostgresPacketWriter> out,
                                     const common::ManagedPointer<trafficcop::TrafficCop> t_cop,
@@ -87,7 +156,18 @@ Transition SimpleQueryCommand::Exec(const common::ManagedPointer<ProtocolInterpr
 
   auto query_text = in_.ReadString();
 
-  auto parse_result = t_cop->ParseQuery(query_text, connection);
+  // Replace the literals by parameters, so that statements differing only in their literals share a cached plan
+  std::string normalized_text;
+  std::vector<parser::ConstantValueExpression> params;
+  const bool normalized =
+      t_cop->UseAutoParameterization() && trafficcop::QueryNormalizer::Normalize(query_text, &normalized_text, &params);
+
+  auto parse_result = t_cop->ParseQuery(normalized ? normalized_text : query_text, connection);
+  if (normalized && std::holds_alternative<common::ErrorData>(parse_result)) {
+    // the normalizer got it wrong, report errors against what the client sent
+    params.clear();
+    parse_result = t_cop->ParseQuery(query_text, connection);
+  }
 
   if (std::holds_alternative<common::ErrorData>(parse_result)) {
     out->WriteError(std::get<common::ErrorData>(parse_result));
@@ -98,8 +178,14 @@ Transition SimpleQueryCommand::Exec(const common::ManagedPointer<ProtocolInterpr
     return FinishSimpleQueryCommand(out, connection);
   }
 
-  const auto statement = std::make_unique<network::Statement>(
-      std::move(query_text), std::move(std::get<std::unique_ptr<parser::ParseResult>>(parse_result)));
+  std::vector<type::TypeId> param_types;
+  param_types.reserve(params.size());
+  for (const auto &param : params) {
+    param_types.push_back(param.GetReturnValueType());
+  }
+  auto statement = std::make_unique<network::Statement>(
+      std::move(params.empty() ? query_text : normalized_text),
+      std::move(std::get<std::unique_ptr<parser::ParseResult>>(parse_result)), std::move(param_types));
 
   // TODO(Matt:) Clients may send multiple statements in a single SimpleQuery packet/string. Handling that would
   // probably exist here, looping over all of the elements in the ParseResult. It's not clear to me how the binder would
@@ -159,23 +245,42 @@ Transition SimpleQueryCommand::Exec(const common::ManagedPointer<ProtocolInterpr
   }
 
   // This logic relies on ordering of values in the enum's definition and is documented there as well.
-  if (NetworkUtil::UnsupportedQueryType(query_type)) {
+  if (query_type == network::QueryType::QUERY_ANALYZE) {
+    ExecuteAnalyze(connection, common::ManagedPointer(statement), out, t_cop);
+  } else if (query_type == network::QueryType::QUERY_COPY) {
+    if (ExecuteCopy(connection, common::ManagedPointer(statement), out, t_cop, postgres_interpreter)) {
+      // The client sends the rows next, and the statement ends with them
+      return Transition::PROCEED;
+    }
+  } else if (NetworkUtil::UnsupportedQueryType(query_type)) {
     out->WriteError({common::ErrorSeverity::NOTICE, "we don't yet support that query type.",
                      common::ErrorCode::ERRCODE_FEATURE_NOT_SUPPORTED});
     out->WriteCommandComplete(query_type, 0);
   } else {
     // Try to bind the parsed statement
-    const auto bind_result = t_cop->BindQuery(connection, common::ManagedPointer(statement), nullptr);
+    auto bind_result = t_cop->BindQuery(connection, common::ManagedPointer(statement), common::ManagedPointer(&params));
+    if (bind_result.type_ == trafficcop::ResultType::ERROR && !params.empty()) {
+      // a literal may have been replaced where the binder can't deal with a parameter, try again as the client sent it
+      auto original_parse_result = t_cop->ParseQuery(query_text, connection);
+      if (std::holds_alternative<std::unique_ptr<parser::ParseResult>>(original_parse_result)) {
+        params.clear();
+        statement = std::make_unique<network::Statement>(
+            std::move(query_text), std::move(std::get<std::unique_ptr<parser::ParseResult>>(original_parse_result)));
+        bind_result = t_cop->BindQuery(connection, common::ManagedPointer(statement), common::ManagedPointer(&params));
+      }
+    }
     if (bind_result.type_ == trafficcop::ResultType::COMPLETE) {
-      // Binding succeeded, optimize to generate a physical plan and then execute
-      auto physical_plan = t_cop->OptimizeBoundQuery(connection, statement->ParseResult());
-
-      statement->SetPhysicalPlan(std::move(physical_plan));
+      if (statement->PhysicalPlan() == nullptr && statement->GetPointQuery() == nullptr) {
+        // Binding succeeded and there's no cached plan, optimize to generate a physical plan and then execute
+        auto physical_plan = t_cop->OptimizeBoundQuery(connection, statement->ParseResult());
+        statement->SetPhysicalPlan(std::move(physical_plan));
+      }
 
-      const auto portal = std::make_unique<Portal>(common::ManagedPointer(statement));
+      const auto portal = std::make_unique<Portal>(common::ManagedPointer(statement), std::move(params),
+                                                   std::vector<FieldFormat>{FieldFormat::text});
 
       if (query_type == network::QueryType::QUERY_SELECT) {
-        out->WriteRowDescription(portal->PhysicalPlan()->GetOutputSchema()->GetColumns(), portal->ResultFormats());
+        out->WriteRowDescription(statement->GetOutputSchema()->GetColumns(), portal->ResultFormats());
       }
 
       ExecutePortal(connection, common::ManagedPointer(portal), out, t_cop,
@@ -229,48 +334,50 @@ Transition ParseCommand::Exec(const common::ManagedPointer<ProtocolInterpreter>
   }
 
   auto query_text = in_.ReadString();
-  auto parse_result = t_cop->ParseQuery(query_text, connection);
 
-  if (std::holds_alternative<common::ErrorData>(parse_result)) {
-    out->WriteError(std::get<common::ErrorData>(parse_result));
-    if (connection->TransactionState() == network::NetworkTransactionStateType::BLOCK) {
-      // failing to parse fails a transaction in postgres
-      connection->Transaction()->SetMustAbort();
+  // A client that prepares the same query again, e.g., on every transaction, reuses the statement parsed before
+  auto cached_statement = postgres_interpreter->LookupStatementInCache(query_text);
+  if (cached_statement == nullptr) {
+    auto parse_result = t_cop->ParseQuery(query_text, connection);
+
+    if (std::holds_alternative<common::ErrorData>(parse_result)) {
+      out->WriteError(std::get<common::ErrorData>(parse_result));
+      if (connection->TransactionState() == network::NetworkTransactionStateType::BLOCK) {
+        // failing to parse fails a transaction in postgres
+        connection->Transaction()->SetMustAbort();
+      }
+      postgres_interpreter->SetWaitingForSync();
+      return FinishSimpleQueryCommand(out, connection);
     }
-    postgres_interpreter->SetWaitingForSync();
-    return FinishSimpleQueryCommand(out, connection);
-  }
 
-  auto param_types = PostgresPacketUtil::ReadParamTypes(common::ManagedPointer(&in_));
+    auto param_types = PostgresPacketUtil::ReadParamTypes(common::ManagedPointer(&in_));
 
-  auto statement = std::make_unique<network::Statement>(
-      std::move(query_text), std::move(std::get<std::unique_ptr<parser::ParseResult>>(parse_result)),
-      std::move(param_types));
+    auto statement = std::make_unique<network::Statement>(
+        std::move(query_text), std::move(std::get<std::unique_ptr<parser::ParseResult>>(parse_result)),
+        std::move(param_types));
 
-  // Extended Query protocol doesn't allow for more than one statement per query string
-  if (statement->ParseResult()->NumStatements() > 1) {
-    out->WriteError({common::ErrorSeverity::ERROR, "extended query only allows one statement per query",
-                     common::ErrorCode::ERRCODE_SYNTAX_ERROR});
-    if (connection->TransactionState() == network::NetworkTransactionStateType::BLOCK) {
-      // failing to parse fails a transaction in postgres
-      connection->Transaction()->SetMustAbort();
+    // Extended Query protocol doesn't allow for more than one statement per query string
+    if (statement->ParseResult()->NumStatements() > 1) {
+      out->WriteError({common::ErrorSeverity::ERROR, "extended query only allows one statement per query",
+                       common::ErrorCode::ERRCODE_SYNTAX_ERROR});
+      if (connection->TransactionState() == network::NetworkTransactionStateType::BLOCK) {
+        // failing to parse fails a transaction in postgres
+        connection->Transaction()->SetMustAbort();
+      }
+      postgres_interpreter->SetWaitingForSync();
+      return Transition::PROCEED;
     }
-    postgres_interpreter->SetWaitingForSync();
-    return Transition::PROCEED;
-  }
-
-  if (NetworkUtil::UnsupportedQueryType(statement->GetQueryType())) {
-    out->WriteError({common::ErrorSeverity::NOTICE, "we don't yet support that query type.",
-                     common::ErrorCode::ERRCODE_FEATURE_NOT_SUPPORTED});
-  }
 
-  auto cached_statement = postgres_interpreter->LookupStatementInCache(statement->GetQueryText());
-  if (cached_statement == nullptr) {
     // Not in the cache, add to cache
     cached_statement = common::ManagedPointer(statement);
     postgres_interpreter->AddStatementToCache(std::move(statement));
   }
 
+  if (NetworkUtil::UnsupportedQueryType(cached_statement->GetQueryType())) {
+    out->WriteError({common::ErrorSeverity::NOTICE, "we don't yet support that query type.",
+                     common::ErrorCode::ERRCODE_FEATURE_NOT_SUPPORTED});
+  }
+
   postgres_interpreter->SetStatement(statement_name, cached_statement);
 
   out->WriteParseComplete();
@@ -321,20 +428,29 @@ Transition BindCommand::Exec(const common::ManagedPointer<ProtocolInterpreter> i
     return Transition::PROCEED;
   }
 
+  // The vectors are reused across the Binds of this connection, so they only allocate when they have to grow
+  const auto param_formats = postgres_interpreter->BindParamFormats();
+  const auto params = postgres_interpreter->BindParams();
+  const auto result_formats = postgres_interpreter->BindResultFormats();
+  const std::array<size_t, 3> capacities = {param_formats->capacity(), params->capacity(), result_formats->capacity()};
+
   // read out the parameter formats
-  const auto param_formats = PostgresPacketUtil::ReadFormatCodes(common::ManagedPointer(&in_));
-  TERRIER_ASSERT(param_formats.size() == 1 || param_formats.size() == statement->ParamTypes().size(),
+  PostgresPacketUtil::ReadFormatCodes(common::ManagedPointer(&in_), param_formats);
+  TERRIER_ASSERT(param_formats->size() == 1 || param_formats->size() == statement->ParamTypes().size(),
                  "Incorrect number of parameter format codes. Should either be 1 (all the same) or the number of "
                  "parameters required for this statement.");
   // TODO(Matt): probably shouldn't be an assert, but rather an error response
 
   // read the params
-  auto params =
-      PostgresPacketUtil::ReadParameters(common::ManagedPointer(&in_), statement->ParamTypes(), param_formats);
-  uint64_t param_num = params.size();
+  PostgresPacketUtil::ReadParameters(common::ManagedPointer(&in_), statement->ParamTypes(), *param_formats, params);
+  uint64_t param_num = params->size();
 
   // read out the result formats
-  auto result_formats = PostgresPacketUtil::ReadFormatCodes(common::ManagedPointer(&in_));
+  PostgresPacketUtil::ReadFormatCodes(common::ManagedPointer(&in_), result_formats);
+
+  uint64_t num_allocations = static_cast<uint64_t>(param_formats->capacity() != capacities[0]) +
+                             static_cast<uint64_t>(params->capacity() != capacities[1]) +
+                             static_cast<uint64_t>(result_formats->capacity() != capacities[2]);
   // TODO(Matt): would like to assert here that this is 0 (all text), 1 (all the same), or the number of output columns
   // but we can't do that without an OutputSchema yet this early in the pipeline
 
@@ -357,10 +473,10 @@ Transition BindCommand::Exec(const common::ManagedPointer<ProtocolInterpreter> i
 
   // This logic relies on ordering of values in the enum's definition and is documented there as well.
   // TODO(Matt): maybe this check against SET eventually encompasses a class of non-transactional query types
-  if (NetworkUtil::TransactionalQueryType(query_type) || query_type == QueryType::QUERY_SET) {
+  if (NetworkUtil::TransactionalQueryType(query_type) || query_type == QueryType::QUERY_SET ||
+      query_type == QueryType::QUERY_ANALYZE) {
     // Don't bind or optimize this statement
-    postgres_interpreter->SetPortal(portal_name,
-                                    std::make_unique<Portal>(statement, std::move(params), std::move(result_formats)));
+    num_allocations += static_cast<uint64_t>(postgres_interpreter->BindPortal(portal_name, statement));
     out->WriteBindComplete();
     return Transition::PROCEED;
   }
@@ -368,8 +484,7 @@ Transition BindCommand::Exec(const common::ManagedPointer<ProtocolInterpreter> i
   if (NetworkUtil::UnsupportedQueryType(query_type)) {
     // Don't begin an implicit txn in this case, and don't bind or optimize this statement. Just noop with a Notice (not
     // an Error) and proceed to reading more messages.
-    postgres_interpreter->SetPortal(portal_name,
-                                    std::make_unique<Portal>(statement, std::move(params), std::move(result_formats)));
+    num_allocations += static_cast<uint64_t>(postgres_interpreter->BindPortal(portal_name, statement));
     out->WriteError({common::ErrorSeverity::NOTICE, "we don't yet support that query type.",
                      common::ErrorCode::ERRCODE_FEATURE_NOT_SUPPORTED});
     out->WriteBindComplete();
@@ -381,17 +496,16 @@ Transition BindCommand::Exec(const common::ManagedPointer<ProtocolInterpreter> i
   }
 
   // Bind it, plan it
-  const auto bind_result = t_cop->BindQuery(connection, statement, common::ManagedPointer(&params));
+  const auto bind_result = t_cop->BindQuery(connection, statement, params);
   if (LIKELY(bind_result.type_ == trafficcop::ResultType::COMPLETE)) {
     // Binding succeeded, optimize to generate a physical plan
-    if (statement->PhysicalPlan() == nullptr || !t_cop->UseQueryCache()) {
-      // it's not cached, optimize it
+    if (statement->GetPointQuery() == nullptr && (statement->PhysicalPlan() == nullptr || !t_cop->UseQueryCache())) {
+      // it's not cached and not a point query, optimize it
       auto physical_plan = t_cop->OptimizeBoundQuery(connection, statement->ParseResult());
       statement->SetPhysicalPlan(std::move(physical_plan));
     }
 
-    postgres_interpreter->SetPortal(portal_name,
-                                    std::make_unique<Portal>(statement, std::move(params), std::move(result_formats)));
+    num_allocations += static_cast<uint64_t>(postgres_interpreter->BindPortal(portal_name, statement));
     out->WriteBindComplete();
   } else if (UNLIKELY(bind_result.type_ == trafficcop::ResultType::NOTICE)) {
     // Binding generated a NOTICE, i.e. IF EXISTS failed, so we're not going to generate a physical plan of nullptr and
@@ -399,8 +513,7 @@ Transition BindCommand::Exec(const common::ManagedPointer<ProtocolInterpreter> i
     // execution
     statement->ClearCachedObjects();
     TERRIER_ASSERT(std::holds_alternative<common::ErrorData>(bind_result.extra_), "We're expecting a message here.");
-    postgres_interpreter->SetPortal(portal_name,
-                                    std::make_unique<Portal>(statement, std::move(params), std::move(result_formats)));
+    num_allocations += static_cast<uint64_t>(postgres_interpreter->BindPortal(portal_name, statement));
     out->WriteError(std::get<common::ErrorData>(bind_result.extra_));
     out->WriteBindComplete();
   } else {
@@ -419,7 +532,7 @@ Transition BindCommand::Exec(const common::ManagedPointer<ProtocolInterpreter> i
     common::thread_context.resource_tracker_.Stop();
     auto &resource_metrics = common::thread_context.resource_tracker_.GetMetrics();
     common::thread_context.metrics_store_->RecordBindCommandData(param_num, statement->GetQueryText().size(),
-                                                                 resource_metrics);
+                                                                 num_allocations, resource_metrics);
   }
 
   return Transition::PROCEED;
@@ -443,7 +556,7 @@ Transition DescribeCommand::Exec(const common::ManagedPointer<ProtocolInterprete
       out->WriteError({common::ErrorSeverity::ERROR, "Portal does not exist for Describe message.",
                        common::ErrorCode::ERRCODE_PROTOCOL_VIOLATION});
     } else if (portal->GetStatement()->GetQueryType() == network::QueryType::QUERY_SELECT) {
-      out->WriteRowDescription(portal->PhysicalPlan()->GetOutputSchema()->GetColumns(), portal->ResultFormats());
+      out->WriteRowDescription(portal->GetStatement()->GetOutputSchema()->GetColumns(), portal->ResultFormats());
     } else {
       out->WriteNoData();
     }
@@ -487,9 +600,8 @@ Transition ExecuteCommand::Exec(const common::ManagedPointer<ProtocolInterpreter
                  "caught at the protocol interpreter Process() level.");
 
   const auto portal_name = in_.ReadString();
-  const auto max_rows UNUSED_ATTRIBUTE = in_.ReadValue<int32_t>();
-  // TODO(Matt): here's where you would reason about PortalSuspend with max_rows. Maybe just the OutputWriter would
-  // buffer the results, since I'm not sure if we can actually pause execution engine
+  // 0 asks for all rows
+  const auto max_rows = in_.ReadValue<int32_t>();
 
   const auto portal = postgres_interpreter->GetPortal(portal_name);
 
@@ -532,19 +644,43 @@ Transition ExecuteCommand::Exec(const common::ManagedPointer<ProtocolInterpreter
     return Transition::PROCEED;
   }
 
+  if (query_type == network::QueryType::QUERY_ANALYZE) {
+    ExecuteAnalyze(connection, statement, out, t_cop);
+    if (connection->TransactionState() == NetworkTransactionStateType::FAIL) {
+      postgres_interpreter->SetWaitingForSync();
+    }
+    return Transition::PROCEED;
+  }
+
   if (NetworkUtil::UnsupportedQueryType(query_type)) {
     // We don't yet support query types with values greater than this
     out->WriteCommandComplete(query_type, 0);
     return Transition::PROCEED;
   }
 
+  const bool runs_plan = portal->PhysicalPlan() != nullptr && statement->GetPointQuery() == nullptr;
+  const bool fetches = portal->GetCursor() != nullptr ||
+                       (max_rows > 0 && query_type == network::QueryType::QUERY_SELECT && runs_plan);
+  // Decided before the portal runs: a plan gets a new execution context, unless its cursor was opened by an earlier
+  // Execute or it is an INSERT that kept the context of an earlier execution in this txn
+  const uint64_t num_allocations = static_cast<uint64_t>(
+      fetches ? portal->GetCursor() == nullptr
+              : runs_plan && (query_type != network::QueryType::QUERY_INSERT ||
+                              portal->GetExecutionContext(connection->Transaction()) == nullptr));
+
   if (execute_command_metrics_enabled) {
     common::thread_context.resource_tracker_.Stop();
     auto &resource_metrics = common::thread_context.resource_tracker_.GetMetrics();
-    common::thread_context.metrics_store_->RecordExecuteCommandData(portal_name.size(), resource_metrics);
+    common::thread_context.metrics_store_->RecordExecuteCommandData(portal_name.size(), num_allocations,
+                                                                    resource_metrics);
   }
 
-  if (portal->PhysicalPlan() != nullptr) {
+  if (fetches) {
+    FetchFromPortal(connection, portal, out, t_cop, max_rows > 0 ? static_cast<uint32_t>(max_rows) : UINT32_MAX);
+    if (connection->TransactionState() == NetworkTransactionStateType::FAIL) {
+      postgres_interpreter->SetWaitingForSync();
+    }
+  } else if (portal->PhysicalPlan() != nullptr || portal->GetStatement()->GetPointQuery() != nullptr) {
     ExecutePortal(connection, portal, out, t_cop, postgres_interpreter->ExplicitTransactionBlock());
     if (connection->TransactionState() == NetworkTransactionStateType::FAIL) {
       postgres_interpreter->SetWaitingForSync();
@@ -564,8 +700,11 @@ Transition SyncCommand::Exec(common::ManagedPointer<ProtocolInterpreter> interpr
   const auto postgres_interpreter = interpreter.CastManagedPointerTo<network::PostgresProtocolInterpreter>();
   if (!postgres_interpreter->ExplicitTransactionBlock() &&
       !(connection->TransactionState() == network::NetworkTransactionStateType::IDLE)) {
-    t_cop->EndTransaction(connection, connection->Transaction()->MustAbort() ? network::QueryType::QUERY_ROLLBACK
-                                                                             : network::QueryType::QUERY_COMMIT);
+    // The implicit txn may hold the cursors of portals that the client executed with a maximum number of rows
+    const auto result = t_cop->EndTransaction(connection, connection->Transaction()->MustAbort()
+                                                              ? network::QueryType::QUERY_ROLLBACK
+                                                              : network::QueryType::QUERY_COMMIT);
+    if (result.type_ == trafficcop::ResultType::ERROR) out->WriteError(std::get<common::ErrorData>(result.extra_));
     postgres_interpreter->ResetTransactionState();
   } else if (postgres_interpreter->WaitingForSync()) {
     postgres_interpreter->ResetWaitingForSync();
@@ -574,6 +713,14 @@ Transition SyncCommand::Exec(common::ManagedPointer<ProtocolInterpreter> interpr
   return Transition::PROCEED;
 }
 
+Transition FlushCommand::Exec(common::ManagedPointer<ProtocolInterpreter> interpreter,
+                              common::ManagedPointer<PostgresPacketWriter> out,
+                              common::ManagedPointer<trafficcop::TrafficCop> t_cop,
+                              common::ManagedPointer<ConnectionContext> connection) {
+  // The client asks for the results written so far, which is done by flushing on completion
+  return Transition::PROCEED;
+}
+
 Transition CloseCommand::Exec(const common::ManagedPointer<ProtocolInterpreter> interpreter,
                               const common::ManagedPointer<PostgresPacketWriter> out,
                               const common::ManagedPointer<trafficcop::TrafficCop> t_cop,
@@ -608,6 +755,46 @@ Transition TerminateCommand::Exec(const common::ManagedPointer<ProtocolInterpret
   return Transition::TERMINATE;
 }
 
+Transition CopyDataCommand::Exec(const common::ManagedPointer<ProtocolInterpreter> interpreter,
+                                 const common::ManagedPointer<PostgresPacketWriter> out,
+                                 const common::ManagedPointer<trafficcop::TrafficCop> t_cop,
+                                 const common::ManagedPointer<ConnectionContext> connection) {
+  const auto postgres_interpreter = interpreter.CastManagedPointerTo<network::PostgresProtocolInterpreter>();
+  const auto copy_in = postgres_interpreter->GetCopyIn();
+  // The rest of the data of a failed COPY is discarded
+  if (copy_in == nullptr) return Transition::PROCEED;
+
+  const auto result = t_cop->CopyInData(connection, copy_in, in_.ReadRemaining());
+  if (result.type_ == trafficcop::ResultType::QUEUING) return Transition::PROCEED;
+  return postgres_interpreter->FinishCopyIn(out, t_cop, connection, result);
+}
+
+Transition CopyDoneCommand::Exec(const common::ManagedPointer<ProtocolInterpreter> interpreter,
+                                 const common::ManagedPointer<PostgresPacketWriter> out,
+                                 const common::ManagedPointer<trafficcop::TrafficCop> t_cop,
+                                 const common::ManagedPointer<ConnectionContext> connection) {
+  const auto postgres_interpreter = interpreter.CastManagedPointerTo<network::PostgresProtocolInterpreter>();
+  const auto copy_in = postgres_interpreter->GetCopyIn();
+  if (copy_in == nullptr) return Transition::PROCEED;
+  return postgres_interpreter->FinishCopyIn(out, t_cop, connection, t_cop->EndCopyIn(connection, copy_in));
+}
+
+Transition CopyFailCommand::Exec(const common::ManagedPointer<ProtocolInterpreter> interpreter,
+                                 const common::ManagedPointer<PostgresPacketWriter> out,
+                                 const common::ManagedPointer<trafficcop::TrafficCop> t_cop,
+                                 const common::ManagedPointer<ConnectionContext> connection) {
+  const auto postgres_interpreter = interpreter.CastManagedPointerTo<network::PostgresProtocolInterpreter>();
+  if (postgres_interpreter->GetCopyIn() == nullptr) return Transition::PROCEED;
+
+  // The client gave up on the COPY, so whatever it loaded is rolled back
+  connection->Transaction()->SetMustAbort();
+  return postgres_interpreter->FinishCopyIn(
+      out, t_cop, connection,
+      {trafficcop::ResultType::ERROR,
+       common::ErrorData(common::ErrorSeverity::ERROR, "COPY from stdin failed: " + in_.ReadString(),
+                         common::ErrorCode::ERRCODE_QUERY_CANCELED)});
+}
+
 // (Matt): this seems to only exist for testing
 Transition EmptyCommand::Exec(common::ManagedPointer<ProtocolInterpreter> interpreter,
                               common::ManagedPointer<PostgresPacketWriter> out,
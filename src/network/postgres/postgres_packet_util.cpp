@@ -14,19 +14,20 @@
 
 namespace terrier::network {
 
-std::vector<FieldFormat> PostgresPacketUtil::ReadFormatCodes(const common::ManagedPointer<ReadBufferView> read_buffer) {
+void PostgresPacketUtil::ReadFormatCodes(const common::ManagedPointer<ReadBufferView> read_buffer,
+                                         const common::ManagedPointer<std::vector<FieldFormat>> formats) {
   const auto num_formats = read_buffer->ReadValue<int16_t>();
+  formats->clear();
 
   if (num_formats == 0) {
-    return {FieldFormat::text};
+    formats->emplace_back(FieldFormat::text);
+    return;
   }
 
-  std::vector<FieldFormat> formats;
-  formats.reserve(num_formats);
+  formats->reserve(num_formats);
   for (uint16_t i = 0; i < num_formats; i++) {
-    formats.emplace_back(static_cast<FieldFormat>(read_buffer->ReadValue<int16_t>()));
+    formats->emplace_back(static_cast<FieldFormat>(read_buffer->ReadValue<int16_t>()));
   }
-  return formats;
 }
 
 std::vector<type::TypeId> PostgresPacketUtil::ReadParamTypes(const common::ManagedPointer<ReadBufferView> read_buffer) {
@@ -145,25 +146,25 @@ parser::ConstantValueExpression PostgresPacketUtil::BinaryValueToInternalValue(
   }
 }
 
-std::vector<parser::ConstantValueExpression> PostgresPacketUtil::ReadParameters(
+void PostgresPacketUtil::ReadParameters(
     const common::ManagedPointer<ReadBufferView> read_buffer, const std::vector<type::TypeId> &param_types,
-    const std::vector<FieldFormat> &param_formats) {
+    const std::vector<FieldFormat> &param_formats,
+    const common::ManagedPointer<std::vector<parser::ConstantValueExpression>> params) {
   const auto num_params = static_cast<size_t>(read_buffer->ReadValue<int16_t>());
   TERRIER_ASSERT(num_params == param_types.size(),
                  "We don't support type inference on parameters yet, so the size of param_types should equal the "
                  "number of parameters.");
-  std::vector<parser::ConstantValueExpression> params;
-  params.reserve(num_params);
+  params->clear();
+  params->reserve(num_params);
   for (uint16_t i = 0; i < num_params; i++) {
     const auto param_size = read_buffer->ReadValue<int32_t>();
 
-    const auto param_format = param_formats[i <= param_formats.size() ? i : 0];
+    const auto param_format = param_formats[i < param_formats.size() ? i : 0];
 
-    params.emplace_back(param_format == FieldFormat::text
-                            ? TextValueToInternalValue(read_buffer, param_size, param_types[i])
-                            : BinaryValueToInternalValue(read_buffer, param_size, param_types[i]));
+    params->emplace_back(param_format == FieldFormat::text
+                             ? TextValueToInternalValue(read_buffer, param_size, param_types[i])
+                             : BinaryValueToInternalValue(read_buffer, param_size, param_types[i]));
   }
-  return params;
 }
 
 }  // namespace terrier::network
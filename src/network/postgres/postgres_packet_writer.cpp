@@ -1,5 +1,11 @@
 #include "network/postgres/postgres_packet_writer.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string_view>
+
 #include "common/error/error_data.h"
 #include "execution/sql/value.h"
 #include "network/postgres/postgres_defs.h"
@@ -7,6 +13,47 @@
 
 namespace terrier::network {
 
+namespace {
+
+// Long enough for the text of any integer, and of any double with 17 significant digits
+constexpr std::size_t MAX_NUMBER_TEXT_LENGTH = 32;
+
+// Format an integer in decimal, returning the end of the text
+char *FormatInteger(char *const first, const int64_t value) {
+  // The magnitude is computed unsigned, so that the most negative value doesn't overflow
+  uint64_t magnitude = value < 0 ? 0 - static_cast<uint64_t>(value) : static_cast<uint64_t>(value);
+  char digits[MAX_NUMBER_TEXT_LENGTH];
+  char *const digits_end = digits + sizeof(digits);
+  char *digit = digits_end;
+  do {
+    *--digit = static_cast<char>('0' + magnitude % 10);
+    magnitude /= 10;
+  } while (magnitude != 0);
+
+  char *out = first;
+  if (value < 0) *out++ = '-';
+  return std::copy(digit, digits_end, out);
+}
+
+// Format a double like Postgres does: with 15 significant digits, or 17 if that is needed to read back the same value,
+// in scientific notation only if its decimal exponent is below -4 or at least the precision
+char *FormatReal(char *const first, char *const last, const double value) {
+  std::string_view special;
+  if (std::isnan(value)) {
+    special = "NaN";
+  } else if (std::isinf(value)) {
+    special = value > 0 ? "Infinity" : "-Infinity";
+  }
+  if (!special.empty()) return std::copy(special.begin(), special.end(), first);
+
+  const auto size = static_cast<std::size_t>(last - first);
+  auto length = std::snprintf(first, size, "%.15g", value);
+  if (std::strtod(first, nullptr) != value) length = std::snprintf(first, size, "%.17g", value);
+  return first + length;
+}
+
+}  // namespace
+
 void PostgresPacketWriter::WriteReadyForQuery(NetworkTransactionStateType txn_status) {
   BeginPacket(NetworkMessageType::PG_READY_FOR_QUERY).AppendRawValue(txn_status).EndPacket();
 }
@@ -161,6 +208,12 @@ void PostgresPacketWriter::WriteCommandComplete(const QueryType query_type, cons
     case QueryType::QUERY_SET:
       WriteCommandComplete("SET");
       break;
+    case QueryType::QUERY_ANALYZE:
+      WriteCommandComplete("ANALYZE");
+      break;
+    case QueryType::QUERY_COPY:
+      WriteCommandComplete("COPY ", num_rows);
+      break;
     default:
       WriteCommandComplete("This QueryType needs a completion message!");
       break;
@@ -232,31 +285,81 @@ void PostgresPacketWriter::WriteCloseComplete() { BeginPacket(NetworkMessageType
 
 void PostgresPacketWriter::WriteBindComplete() { BeginPacket(NetworkMessageType::PG_BIND_COMPLETE).EndPacket(); }
 
+void PostgresPacketWriter::WritePortalSuspended() {
+  BeginPacket(NetworkMessageType::PG_PORTAL_SUSPENDED).EndPacket();
+}
+
 void PostgresPacketWriter::WriteDataRow(const byte *const tuple,
                                         const std::vector<planner::OutputSchema::Column> &columns,
                                         const std::vector<FieldFormat> &field_formats) {
-  BeginPacket(NetworkMessageType::PG_DATA_ROW).AppendValue<int16_t>(static_cast<int16_t>(columns.size()));
+  WriteDataRows(tuple, 1, 0, columns, field_formats);
+}
+
+void PostgresPacketWriter::WriteDataRows(const byte *const tuples, const uint32_t num_tuples, const uint32_t tuple_size,
+                                         const std::vector<planner::OutputSchema::Column> &columns,
+                                         const std::vector<FieldFormat> &field_formats) {
+  // Every row of the batch has the same layout, so the attributes are located once rather than for every row
+  struct Attribute {
+    uint32_t offset_;
+    type::TypeId type_;
+    FieldFormat format_;
+  };
+  std::vector<Attribute> attributes;
+  attributes.reserve(columns.size());
   uint32_t curr_offset = 0;
   for (uint32_t i = 0; i < columns.size(); i++) {
-    // Reinterpret to a base value type first and check if it's NULL
-    auto alignment = execution::sql::ValUtil::GetSqlAlignment(columns[i].GetType());
+    const auto type = columns[i].GetType();
+    auto alignment = execution::sql::ValUtil::GetSqlAlignment(type);
     if (!common::MathUtil::IsAligned(curr_offset, alignment)) {
       curr_offset = static_cast<uint32_t>(common::MathUtil::AlignTo(curr_offset, alignment));
     }
-    const auto *const val = reinterpret_cast<const execution::sql::Val *const>(tuple + curr_offset);
-
     // Field formats can either be the size of the number of columns, or size 1 where they all use the same format
-    const auto field_format = field_formats[i < field_formats.size() ? i : 0];
-
-    const auto type_size = field_format == FieldFormat::text ? WriteTextAttribute(val, columns[i].GetType())
-                                                             : WriteBinaryAttribute(val, columns[i].GetType());
-
+    attributes.push_back({curr_offset, type, field_formats[i < field_formats.size() ? i : 0]});
     // Advance in the buffer based on the execution engine's type size
-    curr_offset += type_size;
+    curr_offset += execution::sql::ValUtil::GetSqlSize(type);
+  }
+
+  for (uint32_t row = 0; row < num_tuples; row++) {
+    const byte *const tuple = tuples + static_cast<std::size_t>(row) * tuple_size;
+    BeginPacket(NetworkMessageType::PG_DATA_ROW).AppendValue<int16_t>(static_cast<int16_t>(columns.size()));
+    for (const auto &attribute : attributes) {
+      const auto *const val = reinterpret_cast<const execution::sql::Val *const>(tuple + attribute.offset_);
+      if (attribute.format_ == FieldFormat::text) {
+        WriteTextAttribute(val, attribute.type_);
+      } else {
+        WriteBinaryAttribute(val, attribute.type_);
+      }
+    }
+    EndPacket();
   }
+}
+
+void PostgresPacketWriter::WriteCopyInResponse(const FieldFormat format, const uint16_t num_columns) {
+  BeginPacket(NetworkMessageType::PG_COPY_IN_RESPONSE)
+      .AppendValue<int8_t>(static_cast<int8_t>(format))
+      .AppendValue<int16_t>(static_cast<int16_t>(num_columns));
+  for (uint16_t i = 0; i < num_columns; i++) AppendValue<int16_t>(static_cast<int16_t>(format));
   EndPacket();
 }
 
+void PostgresPacketWriter::WriteCopyOutResponse(const FieldFormat format, const uint16_t num_columns) {
+  BeginPacket(NetworkMessageType::PG_COPY_OUT_RESPONSE)
+      .AppendValue<int8_t>(static_cast<int8_t>(format))
+      .AppendValue<int16_t>(static_cast<int16_t>(num_columns));
+  for (uint16_t i = 0; i < num_columns; i++) AppendValue<int16_t>(static_cast<int16_t>(format));
+  EndPacket();
+}
+
+void PostgresPacketWriter::WriteCopyData(const std::string_view data) {
+  BeginPacket(NetworkMessageType::PG_COPY_DATA).AppendStringView(data, false).EndPacket();
+}
+
+void PostgresPacketWriter::WriteCopyDone() { BeginPacket(NetworkMessageType::PG_COPY_DONE).EndPacket(); }
+
+void PostgresPacketWriter::WriteCopyFail(const std::string &message) {
+  BeginPacket(NetworkMessageType::PG_COPY_FAIL_COMMAND).AppendString(message, true).EndPacket();
+}
+
 template <class native_type, class val_type>
 void PostgresPacketWriter::WriteBinaryVal(const execution::sql::Val *const val, const type::TypeId type) {
   const auto *const casted_val = reinterpret_cast<const val_type *const>(val);
@@ -332,7 +435,8 @@ uint32_t PostgresPacketWriter::WriteTextAttribute(const execution::sql::Val *con
     // write a -1 for the length of the column value and continue to the next value
     AppendValue<int32_t>(static_cast<int32_t>(-1));
   } else {
-    // Convert the field to text format
+    // Convert the field to text format. Numbers are formatted on the stack, other types that need it into a string.
+    char number[MAX_NUMBER_TEXT_LENGTH];
     std::string string_value;
     switch (type) {
       case type::TypeId::TINYINT:
@@ -340,8 +444,8 @@ uint32_t PostgresPacketWriter::WriteTextAttribute(const execution::sql::Val *con
       case type::TypeId::BIGINT:
       case type::TypeId::INTEGER: {
         auto *int_val = reinterpret_cast<const execution::sql::Integer *const>(val);
-        string_value = std::to_string(int_val->val_);
-        break;
+        WriteTextField(number, FormatInteger(number, int_val->val_));
+        return execution::sql::ValUtil::GetSqlSize(type);
       }
       case type::TypeId::BOOLEAN: {
         // Don't allocate an actual string for a BOOLEAN, just wrap a std::string_view, write the value directly, and
@@ -354,8 +458,8 @@ uint32_t PostgresPacketWriter::WriteTextAttribute(const execution::sql::Val *con
       }
       case type::TypeId::DECIMAL: {
         auto *real_val = reinterpret_cast<const execution::sql::Real *const>(val);
-        string_value = std::to_string(real_val->val_);
-        break;
+        WriteTextField(number, FormatReal(number, number + sizeof(number), real_val->val_));
+        return execution::sql::ValUtil::GetSqlSize(type);
       }
       case type::TypeId::FIXEDDECIMAL: {
         // TODO(Rohan): Find the best way to write this
@@ -396,4 +500,9 @@ uint32_t PostgresPacketWriter::WriteTextAttribute(const execution::sql::Val *con
   return execution::sql::ValUtil::GetSqlSize(type);
 }
 
+void PostgresPacketWriter::WriteTextField(const char *const first, const char *const last) {
+  const auto length = static_cast<std::size_t>(last - first);
+  AppendValue<int32_t>(static_cast<int32_t>(length)).AppendRaw(first, length);
+}
+
 }  // namespace terrier::network
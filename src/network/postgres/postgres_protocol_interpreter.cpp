@@ -3,17 +3,42 @@
 #include <algorithm>
 #include <memory>
 #include <string>
-#include <thread>  // NOLINT
 #include <utility>
 
+#include "metrics/query_trace.h"
 #include "network/network_defs.h"
 #include "network/postgres/postgres_network_commands.h"
 #include "network/terrier_server.h"
 
 constexpr uint32_t SSL_MESSAGE_VERNO = 80877103;
+// Not part of the Postgres protocol, sent by clients on the same host that want to switch over to shared memory
+constexpr uint32_t SHARED_MEMORY_MESSAGE_VERNO = 80877114;
 #define PROTO_MAJOR_VERSION(x) ((x) >> 16)
 
 namespace terrier::network {
+
+namespace {
+
+// Whether a message may execute a query or end a transaction, which is left to the execution workers. The other
+// messages only look up the state of the connection and are answered right away.
+bool ExecutesOnWorker(const NetworkMessageType msg_type) {
+  switch (msg_type) {
+    case NetworkMessageType::PG_SIMPLE_QUERY_COMMAND:
+    case NetworkMessageType::PG_PARSE_COMMAND:
+    case NetworkMessageType::PG_BIND_COMMAND:
+    case NetworkMessageType::PG_EXECUTE_COMMAND:
+    case NetworkMessageType::PG_SYNC_COMMAND:
+    case NetworkMessageType::PG_COPY_DATA:
+    case NetworkMessageType::PG_COPY_DONE:
+    case NetworkMessageType::PG_COPY_FAIL_COMMAND:
+      return true;
+    default:
+      return false;
+  }
+}
+
+}  // namespace
+
 Transition PostgresProtocolInterpreter::Process(common::ManagedPointer<ReadBuffer> in,
                                                 common::ManagedPointer<WriteQueue> out,
                                                 common::ManagedPointer<trafficcop::TrafficCop> t_cop,
@@ -30,8 +55,76 @@ Transition PostgresProtocolInterpreter::Process(common::ManagedPointer<ReadBuffe
     curr_input_packet_.Clear();
     return ProcessStartup(in, out, t_cop, context);
   }
-  auto command = command_factory_->PacketToCommand(common::ManagedPointer<InputPacket>(&curr_input_packet_));
+
+  if (context->QueryTraceId() == 0 && metrics::QueryTrace::Sample()) {
+    // The request is traced until its results are flushed, through the messages that the client pipelined behind it
+    context->StartQueryTrace();
+    // Tracing may have been enabled after the read started
+    const uint64_t read_start_us =
+        context->ReadStartTime() != 0 ? context->ReadStartTime() : metrics::MetricsUtil::Now();
+    metrics::QueryTrace::Record(metrics::TraceSpan::NETWORK_READ, context->GetConnectionID().UnderlyingValue(),
+                                context->QueryTraceId(), read_start_us);
+  }
+
+  if (execution_pool_ != nullptr && ExecutesOnWorker(curr_input_packet_.msg_type_)) {
+    // The connection stops listening on its socket until the worker calls it back, so the worker has the buffers and
+    // the state of the connection to itself. The worker goes on with the messages that the client pipelined behind
+    // this one, e.g., Bind/Execute pairs up to a Sync, until the results have to be flushed. A whole batch of
+    // messages thus takes a single handoff to the pool.
+    pending_ = true;
+    const bool submitted = execution_pool_->Submit([this, in, out, t_cop, context] {
+      try {
+        Transition result = ProcessPacket(out, t_cop, context);
+        while (result == Transition::PROCEED && !out->ShouldFlush() && TryBuildPacket(in)) {
+          result = ProcessPacket(out, t_cop, context);
+        }
+        pending_result_ = result;
+      } catch (NetworkProcessException &e) {
+        NETWORK_LOG_ERROR("{0}\n", e.what());
+        pending_result_ = Transition::TERMINATE;
+      } catch (std::exception &e) {
+        NETWORK_LOG_ERROR("Encountered exception {0} when parsing packet", e.what());
+        pending_result_ = Transition::TERMINATE;
+      }
+      context->Callback()(context->CallbackArg());
+    });
+    if (submitted) return Transition::NEED_RESULT;
+    // The pool is shutting down, so the command runs here
+    pending_ = false;
+  }
+
+  return ProcessPacket(out, t_cop, context);
+}
+
+Transition PostgresProtocolInterpreter::GetResult(const common::ManagedPointer<WriteQueue> out) {
+  TERRIER_ASSERT(pending_, "No command was handed off to the execution workers.");
+  // The worker cleared the packets it finished, the current one may be the start of a packet still being received
+  pending_ = false;
+  return pending_result_;
+}
+
+Transition PostgresProtocolInterpreter::ProcessPacket(const common::ManagedPointer<WriteQueue> out,
+                                                      const common::ManagedPointer<trafficcop::TrafficCop> t_cop,
+                                                      const common::ManagedPointer<ConnectionContext> context) {
   PostgresPacketWriter writer(out);
+  const auto msg_type = curr_input_packet_.msg_type_;
+  if (copy_in_ != nullptr && msg_type != NetworkMessageType::PG_COPY_DATA &&
+      msg_type != NetworkMessageType::PG_COPY_DONE && msg_type != NetworkMessageType::PG_COPY_FAIL_COMMAND) {
+    // In copy-in mode, Flush and Sync are ignored and any other message fails the COPY
+    curr_input_packet_.Clear();
+    if (msg_type == NetworkMessageType::PG_FLUSH_COMMAND || msg_type == NetworkMessageType::PG_SYNC_COMMAND) {
+      return Transition::PROCEED;
+    }
+    context->Transaction()->SetMustAbort();
+    return FinishCopyIn(common::ManagedPointer(&writer), t_cop, context,
+                        {trafficcop::ResultType::ERROR,
+                         common::ErrorData(common::ErrorSeverity::ERROR,
+                                           fmt::format("unexpected message type 0x{:02x} during COPY from stdin",
+                                                       static_cast<unsigned char>(msg_type)),
+                                           common::ErrorCode::ERRCODE_PROTOCOL_VIOLATION)});
+  }
+
+  auto command = command_factory_->PacketToCommand(common::ManagedPointer<InputPacket>(&curr_input_packet_));
   if (command->FlushOnComplete()) out->ForceFlush();
 
   if (WaitingForSync() && curr_input_packet_.msg_type_ != NetworkMessageType::PG_SYNC_COMMAND) {
@@ -61,6 +154,13 @@ Transition PostgresProtocolInterpreter::ProcessStartup(const common::ManagedPoin
     return Transition::PROCEED;
   }
 
+  if (proto_version == SHARED_MEMORY_MESSAGE_VERNO) {
+    // Like the SSL request, the client waits for the answer before it goes on with the startup. If it gets the
+    // segment, the startup and everything after it goes through shared memory.
+    if (!context->IoWrapper()->StartSharedMemory('S')) writer.WriteType(static_cast<NetworkMessageType>('N'));
+    return Transition::PROCEED;
+  }
+
   // Process startup packet
   if (PROTO_MAJOR_VERSION(proto_version) != 3) {
     NETWORK_LOG_TRACE("Protocol error: only protocol version 3 is supported");
@@ -85,7 +185,8 @@ Transition PostgresProtocolInterpreter::ProcessStartup(const common::ManagedPoin
   in->Skip(1);
   // TODO(Tianyu): Implement authentication. For now we always send AuthOK
 
-  // Create a temp namespace for this connection
+  // Resolve the database this connection accesses. The temp namespace is only created once it's used, which keeps
+  // DDL changes out of the startup of a connection
   std::string db_name = catalog::DEFAULT_DATABASE;
   auto &cmdline_args = context->CommandLineArgs();
   if (cmdline_args.find("database") != cmdline_args.end()) {
@@ -95,38 +196,17 @@ Transition PostgresProtocolInterpreter::ProcessStartup(const common::ManagedPoin
     }
   }
 
-  std::pair<catalog::db_oid_t, catalog::namespace_oid_t> oids;
-
-  uint32_t sleep_time = INITIAL_BACKOFF_TIME;
-
-  // we loop with exponential backoff because in case there are multiple other pg connections also starting
-  // at the same time, creating DDL conflicts when creating the temp namespace
-  do {
-    oids = t_cop->CreateTempNamespace(context->GetConnectionID(), db_name);
-    if (oids.first == catalog::INVALID_DATABASE_OID || oids.second != catalog::INVALID_NAMESPACE_OID) break;
-    std::this_thread::sleep_for(std::chrono::milliseconds{sleep_time});
-    sleep_time *= BACKOFF_FACTOR;
-  } while (sleep_time <= MAX_BACKOFF_TIME);
-
-  if (oids.first == catalog::INVALID_DATABASE_OID) {
+  const auto db_oid = t_cop->GetDatabaseOid(db_name);
+  if (db_oid == catalog::INVALID_DATABASE_OID) {
     // Invalid database name
     writer.WriteError({common::ErrorSeverity::FATAL, fmt::format("Database \"{}\" does not exist", db_name),
                        common::ErrorCode::ERRCODE_UNDEFINED_DATABASE});
     return Transition::TERMINATE;
   }
-  if (oids.second == catalog::INVALID_NAMESPACE_OID) {
-    // Failed to create temporary namespace. Client should retry.
-    writer.WriteError({common::ErrorSeverity::FATAL,
-                       "Failed to create a temporary namespace for this connection. There may be a concurrent "
-                       "DDL change. Please retry.",
-                       common::ErrorCode::ERRCODE_CONNECTION_FAILURE});
-    return Transition::TERMINATE;
-  }
 
-  // Temp namespace creation succeeded, stash some metadata about it in the ConnectionContext
+  // Stash some metadata about the database in the ConnectionContext
   context->SetDatabaseName(std::move(db_name));
-  context->SetDatabaseOid(oids.first);
-  context->SetTempNamespaceOid(oids.second);
+  context->SetDatabaseOid(db_oid);
 
   // All done
   writer.WriteStartupResponse();
@@ -152,15 +232,38 @@ void PostgresProtocolInterpreter::Teardown(const common::ManagedPointer<ReadBuff
     return;
   }
 
-  // It's possible that temporary namespace failed to be
-  // created and we're closing the connection for that reason, in
-  // case there's nothing to drop
+  // The temporary namespace is only created once it's used, so there may be nothing to drop
   if (context->GetTempNamespaceOid() != catalog::INVALID_NAMESPACE_OID) {
     while (!t_cop->DropTempNamespace(context->GetDatabaseOid(), context->GetTempNamespaceOid())) {
     }
   }
 }
 
+Transition PostgresProtocolInterpreter::FinishCopyIn(const common::ManagedPointer<PostgresPacketWriter> out,
+                                                     const common::ManagedPointer<trafficcop::TrafficCop> t_cop,
+                                                     const common::ManagedPointer<ConnectionContext> connection,
+                                                     const trafficcop::TrafficCopResult &result) {
+  TERRIER_ASSERT(copy_in_ != nullptr, "Not in copy-in mode.");
+  copy_in_.reset();
+  // The client waits for the result, even if the message that ended the COPY doesn't flush
+  out->ForceFlush();
+  if (result.type_ == trafficcop::ResultType::COMPLETE) {
+    out->WriteCommandComplete(QueryType::QUERY_COPY, std::get<uint32_t>(result.extra_));
+  } else {
+    TERRIER_ASSERT(result.type_ == trafficcop::ResultType::ERROR, "The COPY should have ended with an error.");
+    out->WriteError(std::get<common::ErrorData>(result.extra_));
+  }
+
+  if (!ExplicitTransactionBlock()) {
+    // The COPY was a single-statement txn
+    t_cop->EndTransaction(connection, connection->Transaction()->MustAbort() ? QueryType::QUERY_ROLLBACK
+                                                                             : QueryType::QUERY_COMMIT);
+    ResetTransactionState();
+  }
+  out->WriteReadyForQuery(connection->TransactionState());
+  return Transition::PROCEED;
+}
+
 size_t PostgresProtocolInterpreter::GetPacketHeaderSize() { return startup_ ? sizeof(uint32_t) : 1 + sizeof(uint32_t); }
 
 void PostgresProtocolInterpreter::SetPacketMessageType(const common::ManagedPointer<ReadBuffer> in) {
@@ -0,0 +1,145 @@
+#include "network/shared_memory_channel.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <new>
+
+#include "common/error/exception.h"
+#include "common/math_util.h"
+#include "loggers/network_logger.h"
+
+namespace terrier::network {
+
+SharedMemoryChannel::SharedMemoryChannel(const int fd, void *const segment, const uint32_t ring_size,
+                                         const bool server)
+    : fd_(fd),
+      segment_(segment),
+      ring_size_(ring_size),
+      in_(&reinterpret_cast<Header *>(segment)->rings_[server ? 0 : 1]),
+      in_bytes_(reinterpret_cast<byte *>(segment) + sizeof(Header) + (server ? 0 : ring_size)),
+      out_(&reinterpret_cast<Header *>(segment)->rings_[server ? 1 : 0]),
+      out_bytes_(reinterpret_cast<byte *>(segment) + sizeof(Header) + (server ? ring_size : 0)) {}
+
+std::unique_ptr<SharedMemoryChannel> SharedMemoryChannel::Create(uint32_t ring_size) {
+  ring_size = static_cast<uint32_t>(common::MathUtil::PowerOf2Ceil(ring_size));
+  const int fd = memfd_create("terrier_connection", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+  if (fd < 0) {
+    NETWORK_LOG_ERROR("Failed to create shared memory segment: {0}", strerror(errno));
+    return nullptr;
+  }
+  const size_t segment_size = SegmentSize(ring_size);
+  void *segment = MAP_FAILED;
+  // The size is sealed before the fd is sent to the client, which could otherwise shrink the segment under the mapping
+  // of the server and have it killed by SIGBUS
+  if (ftruncate(fd, static_cast<off_t>(segment_size)) == 0 &&
+      fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL) == 0) {
+    segment = mmap(nullptr, segment_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  }
+  if (segment == MAP_FAILED) {
+    NETWORK_LOG_ERROR("Failed to map shared memory segment: {0}", strerror(errno));
+    close(fd);
+    return nullptr;
+  }
+
+  // The segment is zeroed, so both rings start out empty with nobody waiting
+  auto *const header = new (segment) Header();
+  header->magic_ = MAGIC;
+  header->ring_size_ = ring_size;
+  return std::unique_ptr<SharedMemoryChannel>(new SharedMemoryChannel(fd, segment, ring_size, true));
+}
+
+std::unique_ptr<SharedMemoryChannel> SharedMemoryChannel::Attach(const int fd) {
+  struct stat stats;
+  if (fstat(fd, &stats) != 0 || static_cast<size_t>(stats.st_size) < sizeof(Header)) {
+    close(fd);
+    return nullptr;
+  }
+  const auto segment_size = static_cast<size_t>(stats.st_size);
+  void *const segment = mmap(nullptr, segment_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (segment == MAP_FAILED) {
+    close(fd);
+    return nullptr;
+  }
+  const auto *const header = reinterpret_cast<const Header *>(segment);
+  if (header->magic_ != MAGIC || SegmentSize(header->ring_size_) != segment_size) {
+    munmap(segment, segment_size);
+    close(fd);
+    return nullptr;
+  }
+  return std::unique_ptr<SharedMemoryChannel>(new SharedMemoryChannel(fd, segment, header->ring_size_, false));
+}
+
+SharedMemoryChannel::~SharedMemoryChannel() {
+  munmap(segment_, SegmentSize(ring_size_));
+  close(fd_);
+}
+
+size_t SharedMemoryChannel::Receive(void *const dest, const size_t size) {
+  const uint64_t head = in_->head_.load(std::memory_order_relaxed);
+  const uint64_t tail = in_->tail_.load(std::memory_order_acquire);
+  CheckCounters(head, tail);
+  const auto bytes = static_cast<size_t>(std::min<uint64_t>(size, tail - head));
+  // The bytes may wrap around the end of the ring
+  const size_t offset = head & (ring_size_ - 1);
+  const size_t first = std::min<size_t>(bytes, ring_size_ - offset);
+  std::memcpy(dest, in_bytes_ + offset, first);
+  std::memcpy(reinterpret_cast<byte *>(dest) + first, in_bytes_, bytes - first);
+  // Sequentially consistent, so that either the sender sees the room or this end sees that the sender waits
+  in_->head_.store(head + bytes);
+  return bytes;
+}
+
+size_t SharedMemoryChannel::Send(const void *const src, const size_t size) {
+  const uint64_t head = out_->head_.load(std::memory_order_acquire);
+  const uint64_t tail = out_->tail_.load(std::memory_order_relaxed);
+  CheckCounters(head, tail);
+  const auto bytes = static_cast<size_t>(std::min<uint64_t>(size, ring_size_ - (tail - head)));
+  const size_t offset = tail & (ring_size_ - 1);
+  const size_t first = std::min<size_t>(bytes, ring_size_ - offset);
+  std::memcpy(out_bytes_ + offset, src, first);
+  std::memcpy(out_bytes_, reinterpret_cast<const byte *>(src) + first, bytes - first);
+  // Sequentially consistent, so that either the receiver sees the bytes or this end sees that the receiver waits
+  out_->tail_.store(tail + bytes);
+  return bytes;
+}
+
+void SharedMemoryChannel::CheckCounters(const uint64_t head, const uint64_t tail) const {
+  // A tail behind the head wraps around to more bytes than the ring holds
+  if (tail - head <= ring_size_) return;
+  NETWORK_LOG_ERROR("Corrupt shared memory ring: head {0}, tail {1}, size {2}", head, tail, ring_size_);
+  throw NETWORK_PROCESS_EXCEPTION("Corrupt shared memory ring");
+}
+
+bool SharedMemoryChannel::PrepareToWaitForData() {
+  in_->receiver_waiting_.store(true);
+  if (in_->tail_.load() == in_->head_.load(std::memory_order_relaxed)) return true;
+  in_->receiver_waiting_.store(false);
+  return false;
+}
+
+bool SharedMemoryChannel::PrepareToWaitForSpace() {
+  out_->sender_waiting_.store(true);
+  if (out_->tail_.load(std::memory_order_relaxed) - out_->head_.load() == ring_size_) return true;
+  out_->sender_waiting_.store(false);
+  return false;
+}
+
+bool SharedMemoryChannel::PeerWaiting() {
+  // A flag is only cleared if the peer can make progress, so that it is woken up once per sleep
+  bool waiting = false;
+  if (out_->receiver_waiting_.load() && out_->tail_.load() != out_->head_.load()) {
+    waiting |= out_->receiver_waiting_.exchange(false);
+  }
+  if (in_->sender_waiting_.load() && in_->tail_.load() - in_->head_.load() < ring_size_) {
+    waiting |= in_->sender_waiting_.exchange(false);
+  }
+  return waiting;
+}
+
+}  // namespace terrier::network
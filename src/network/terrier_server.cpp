@@ -20,14 +20,16 @@ namespace terrier::network {
 TerrierServer::TerrierServer(common::ManagedPointer<ProtocolInterpreter::Provider> protocol_provider,
                              common::ManagedPointer<ConnectionHandleFactory> connection_handle_factory,
                              common::ManagedPointer<common::DedicatedThreadRegistry> thread_registry,
-                             const uint16_t port, const uint16_t connection_thread_count, std::string socket_directory)
+                             const uint16_t port, const uint16_t connection_thread_count, std::string socket_directory,
+                             const common::ManagedPointer<ExecutionPool> execution_pool)
     : DedicatedThreadOwner(thread_registry),
       running_(false),
       port_(port),
       socket_directory_(std::move(socket_directory)),
       max_connections_(connection_thread_count),
       connection_handle_factory_(connection_handle_factory),
-      provider_(protocol_provider) {
+      provider_(protocol_provider),
+      execution_pool_(execution_pool) {
   // For logging purposes
   //  event_enable_debug_mode();
 
@@ -145,6 +147,9 @@ void TerrierServer::RunServer() {
   // Register the Unix domain socket
   RegisterSocket<UNIX_DOMAIN_SOCKET>();
 
+  // Start the workers before any connection can hand a command off to them
+  if (execution_pool_ != nullptr) execution_pool_->Start();
+
   // Create a dispatcher to handle connections to the sockets that have been created.
   dispatcher_task_ = thread_registry_->RegisterDedicatedThread<ConnectionDispatcherTask>(
       this /* requester */, max_connections_, this, common::ManagedPointer(provider_.Get()), connection_handle_factory_,
@@ -159,6 +164,9 @@ void TerrierServer::RunServer() {
 
 void TerrierServer::StopServer() {
   NETWORK_LOG_TRACE("Begin to stop server");
+  // The workers wake up the connections of the commands they finish, so they stop while the handlers are still running
+  if (execution_pool_ != nullptr) execution_pool_->Stop();
+
   const bool result UNUSED_ATTRIBUTE =
       thread_registry_->StopTask(this, dispatcher_task_.CastManagedPointerTo<common::DedicatedThreadTask>());
   TERRIER_ASSERT(result, "Failed to stop ConnectionDispatcherTask.");
@@ -118,6 +118,17 @@ void ChildPropertyDeriver::Visit(UNUSED_ATTRIBUTE const LeftHashJoin *op) {}
 void ChildPropertyDeriver::Visit(UNUSED_ATTRIBUTE const RightHashJoin *op) {}
 void ChildPropertyDeriver::Visit(UNUSED_ATTRIBUTE const OuterHashJoin *op) {}
 
+void ChildPropertyDeriver::Visit(const InnerMergeJoin *op) {
+  // Each child must be sorted ascending on its join keys. The output then comes out in the order of the probe (right)
+  // child's keys, which we advertise so that a parent sort on those keys can be elided.
+  std::vector<OrderByOrderingType> left_ascending(op->GetLeftKeys().size(), OrderByOrderingType::ASC);
+  std::vector<OrderByOrderingType> right_ascending(op->GetRightKeys().size(), OrderByOrderingType::ASC);
+  auto left_set = new PropertySet(std::vector<Property *>{new PropertySort(op->GetLeftKeys(), left_ascending)});
+  auto right_set = new PropertySet(std::vector<Property *>{new PropertySort(op->GetRightKeys(), right_ascending)});
+  auto provided_set = right_set->Copy();
+  output_.emplace_back(provided_set, std::vector<PropertySet *>{left_set, right_set});
+}
+
 void ChildPropertyDeriver::Visit(UNUSED_ATTRIBUTE const Insert *op) {
   std::vector<PropertySet *> child_input_properties;
   output_.emplace_back(requirements_->Copy(), std::move(child_input_properties));
@@ -0,0 +1,125 @@
+#include "optimizer/cost_model/stats_cost_model.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "optimizer/group_expression.h"
+#include "optimizer/memo.h"
+#include "optimizer/physical_operators.h"
+#include "optimizer/statistics/stats_storage.h"
+#include "optimizer/statistics/table_stats.h"
+
+namespace terrier::optimizer {
+
+double StatsCostModel::CalculateCost(UNUSED_ATTRIBUTE transaction::TransactionContext *txn,
+                                     UNUSED_ATTRIBUTE catalog::CatalogAccessor *accessor, Memo *memo,
+                                     GroupExpression *gexpr) {
+  gexpr_ = gexpr;
+  memo_ = memo;
+  output_cost_ = 0;
+  gexpr_->Contents()->Accept(common::ManagedPointer<OperatorVisitor>(this));
+  return output_cost_;
+}
+
+double StatsCostModel::GetNumRows(const group_id_t group_id) const {
+  const auto num_rows = memo_->GetGroupByID(group_id)->GetNumRows();
+  return num_rows >= 0 ? static_cast<double>(num_rows) : -1;
+}
+
+double StatsCostModel::GetChildRows(const int idx) const {
+  const auto num_rows = GetNumRows(gexpr_->GetChildGroupId(idx));
+  return num_rows >= 0 ? num_rows : DEFAULT_NUM_ROWS;
+}
+
+double StatsCostModel::GetTableRows(const catalog::table_oid_t table_oid) const {
+  const auto table_stats = stats_storage_->GetTableStats(db_oid_, table_oid);
+  if (table_stats == nullptr || table_stats->GetNumRows() == 0) {
+    return DEFAULT_NUM_ROWS;
+  }
+  return static_cast<double>(table_stats->GetNumRows());
+}
+
+double StatsCostModel::GetScanRows(const double table_rows, const size_t num_predicates) const {
+  // A scan is in the same group as the LogicalGet it implements, whose stats already account for the predicates
+  const auto num_rows = GetNumRows(gexpr_->GetGroupID());
+  if (num_rows >= 0) {
+    return num_rows;
+  }
+  return table_rows * std::pow(DEFAULT_SELECTIVITY, static_cast<double>(num_predicates));
+}
+
+void StatsCostModel::Visit(const SeqScan *op) {
+  const auto table_rows = GetTableRows(op->GetTableOID());
+  output_cost_ = table_rows * (TUPLE_CPU_COST + static_cast<double>(op->GetPredicates().size()) * PREDICATE_CPU_COST);
+}
+
+void StatsCostModel::Visit(const IndexScan *op) {
+  const auto table_rows = GetTableRows(op->GetTableOID());
+  const auto num_predicates = static_cast<double>(op->GetPredicates().size());
+
+  // Without bounds, the whole index is scanned, e.g., to produce the rows in the order of its keys
+  const auto scanned_rows = op->GetBounds().empty() ? table_rows : GetScanRows(table_rows, op->GetPredicates().size());
+  output_cost_ = INDEX_PROBE_CPU_COST * std::log2(table_rows + 1) +
+                 scanned_rows * (TUPLE_CPU_COST + INDEX_TUPLE_CPU_COST + num_predicates * PREDICATE_CPU_COST);
+}
+
+void StatsCostModel::Visit(UNUSED_ATTRIBUTE const OrderBy *op) {
+  const auto num_rows = GetChildRows(0);
+  output_cost_ = num_rows * std::log2(num_rows + 1) * COMPARE_CPU_COST + num_rows * MEMORY_TUPLE_COST;
+}
+
+void StatsCostModel::Visit(const Limit *op) {
+  output_cost_ = std::min(GetChildRows(0), static_cast<double>(op->GetOffset() + op->GetLimit())) * TUPLE_CPU_COST;
+}
+
+void StatsCostModel::Visit(const InnerIndexJoin *op) {
+  // Every row of the outer input probes the index of the inner table
+  const auto outer_rows = GetChildRows(0);
+  const auto table_rows = GetTableRows(op->GetTableOID());
+  const auto num_rows = GetNumRows(gexpr_->GetGroupID());
+  const auto output_rows = num_rows >= 0 ? num_rows : outer_rows;
+  output_cost_ =
+      outer_rows * INDEX_PROBE_CPU_COST * std::log2(table_rows + 1) +
+      output_rows * (TUPLE_CPU_COST + INDEX_TUPLE_CPU_COST +
+                     static_cast<double>(op->GetJoinPredicates().size()) * PREDICATE_CPU_COST);
+}
+
+void StatsCostModel::Visit(const InnerNLJoin *op) { CostNLJoin(op->GetJoinPredicates().size()); }
+
+void StatsCostModel::Visit(UNUSED_ATTRIBUTE const InnerMergeJoin *op) {
+  // Both inputs are sorted on the join keys, so every row is compared about once
+  const auto num_rows = GetNumRows(gexpr_->GetGroupID());
+  const auto input_rows = GetChildRows(0) + GetChildRows(1);
+  output_cost_ = input_rows * COMPARE_CPU_COST + std::max(num_rows, 0.0) * TUPLE_CPU_COST;
+}
+
+void StatsCostModel::Visit(UNUSED_ATTRIBUTE const HashGroupBy *op) {
+  const auto input_rows = GetChildRows(0);
+  const auto num_rows = GetNumRows(gexpr_->GetGroupID());
+  const auto num_groups = num_rows >= 0 ? num_rows : input_rows;
+  output_cost_ = input_rows * HASH_BUILD_CPU_COST + num_groups * (MEMORY_TUPLE_COST + TUPLE_CPU_COST);
+}
+
+void StatsCostModel::Visit(UNUSED_ATTRIBUTE const SortGroupBy *op) {
+  // The input is sorted on the grouping columns, so groups are aggregated one after the other without a hash table
+  const auto input_rows = GetChildRows(0);
+  const auto num_rows = GetNumRows(gexpr_->GetGroupID());
+  output_cost_ = input_rows * COMPARE_CPU_COST + (num_rows >= 0 ? num_rows : input_rows) * TUPLE_CPU_COST;
+}
+
+void StatsCostModel::CostNLJoin(const size_t num_predicates) {
+  const auto num_rows = GetNumRows(gexpr_->GetGroupID());
+  const auto pairs = GetChildRows(0) * GetChildRows(1);
+  output_cost_ = pairs * static_cast<double>(std::max<size_t>(num_predicates, 1)) * PREDICATE_CPU_COST +
+                 (num_rows >= 0 ? num_rows : pairs) * TUPLE_CPU_COST;
+}
+
+void StatsCostModel::CostHashJoin() {
+  const auto num_rows = GetNumRows(gexpr_->GetGroupID());
+  const auto build_rows = GetChildRows(0);
+  const auto probe_rows = GetChildRows(1);
+  output_cost_ = build_rows * (HASH_BUILD_CPU_COST + MEMORY_TUPLE_COST) + probe_rows * HASH_PROBE_CPU_COST +
+                 (num_rows >= 0 ? num_rows : std::max(build_rows, probe_rows)) * TUPLE_CPU_COST;
+}
+
+}  // namespace terrier::optimizer
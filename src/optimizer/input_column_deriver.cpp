@@ -214,6 +214,8 @@ void InputColumnDeriver::Visit(UNUSED_ATTRIBUTE const OuterNLJoin *op) {
 
 void InputColumnDeriver::Visit(const InnerHashJoin *op) { JoinHelper(op); }
 
+void InputColumnDeriver::Visit(const InnerMergeJoin *op) { JoinHelper(op); }
+
 void InputColumnDeriver::Visit(UNUSED_ATTRIBUTE const LeftHashJoin *op) {
   TERRIER_ASSERT(0, "LeftHashJoin not supported");
 }
@@ -363,6 +365,11 @@ void InputColumnDeriver::JoinHelper(const BaseOperatorNodeContents *op) {
     join_conds = join_op->GetJoinPredicates();
     left_keys = join_op->GetLeftKeys();
     right_keys = join_op->GetRightKeys();
+  } else if (op->GetOpType() == OpType::INNERMERGEJOIN) {
+    auto join_op = reinterpret_cast<const InnerMergeJoin *>(op);
+    join_conds = join_op->GetJoinPredicates();
+    left_keys = join_op->GetLeftKeys();
+    right_keys = join_op->GetRightKeys();
   } else if (op->GetOpType() == OpType::INNERNLJOIN) {
     auto join_op = reinterpret_cast<const InnerNLJoin *>(op);
     join_conds = join_op->GetJoinPredicates();
@@ -0,0 +1,175 @@
+#include "optimizer/join_order_enumerator.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace terrier::optimizer {
+
+namespace {
+
+// The set of relations 0 to i, inclusive.
+uint64_t UpTo(const uint32_t i) { return i >= 63 ? ~uint64_t{0} : (uint64_t{1} << (i + 1)) - 1; }
+
+uint32_t Lowest(const uint64_t relations) { return static_cast<uint32_t>(__builtin_ctzll(relations)); }
+
+uint32_t Highest(const uint64_t relations) { return 63 - static_cast<uint32_t>(__builtin_clzll(relations)); }
+
+bool IsSubset(const uint64_t subset, const uint64_t set) { return (subset & ~set) == 0; }
+
+}  // namespace
+
+uint32_t JoinOrderEnumerator::AddRelation(const double cardinality) {
+  TERRIER_ASSERT(num_relations_ < MAX_RELATIONS, "Too many relations.");
+  const auto relation = num_relations_++;
+  const uint64_t bit = uint64_t{1} << relation;
+  all_relations_ |= bit;
+  cardinalities_.push_back(cardinality);
+  neighbors_.push_back(0);
+  plans_[bit] = Plan{cardinality, 0, 0, 0};
+  return relation;
+}
+
+void JoinOrderEnumerator::AddPredicate(const uint64_t relations, const double selectivity) {
+  TERRIER_ASSERT(relations != 0 && IsSubset(relations, all_relations_), "Predicate refers to unknown relations.");
+  predicates_.emplace_back(relations, selectivity);
+  if (__builtin_popcountll(relations) == 2) {
+    const auto left = Lowest(relations);
+    const auto right = Highest(relations);
+    neighbors_[left] |= uint64_t{1} << right;
+    neighbors_[right] |= uint64_t{1} << left;
+  }
+}
+
+bool JoinOrderEnumerator::Enumerate() {
+  TERRIER_ASSERT(num_relations_ > 0, "Nothing to join.");
+  num_pairs_ = 0;
+  if (num_relations_ <= dp_threshold_ && EnumerateDynamic()) {
+    return true;
+  }
+  EnumerateGreedy();
+  return false;
+}
+
+uint64_t JoinOrderEnumerator::Neighbors(uint64_t relations) const {
+  uint64_t neighbors = 0;
+  for (; relations != 0; relations &= relations - 1) {
+    neighbors |= neighbors_[Lowest(relations)];
+  }
+  return neighbors;
+}
+
+double JoinOrderEnumerator::JoinCardinality(const uint64_t left, const uint64_t right) const {
+  const auto relations = left | right;
+  double cardinality = plans_.at(left).cardinality_ * plans_.at(right).cardinality_;
+  for (const auto &predicate : predicates_) {
+    // Only the predicates that become applicable with this join
+    if (IsSubset(predicate.first, relations) && !IsSubset(predicate.first, left) &&
+        !IsSubset(predicate.first, right)) {
+      cardinality *= predicate.second;
+    }
+  }
+  return cardinality;
+}
+
+void JoinOrderEnumerator::ConsiderJoin(const uint64_t left, const uint64_t right) {
+  const auto cardinality = JoinCardinality(left, right);
+  const auto cost = cardinality + plans_.at(left).cost_ + plans_.at(right).cost_;
+  const auto iter = plans_.find(left | right);
+  if (iter == plans_.end()) {
+    plans_.emplace(left | right, Plan{cardinality, cost, left, right});
+  } else if (cost < iter->second.cost_) {
+    iter->second = Plan{cardinality, cost, left, right};
+  }
+}
+
+void JoinOrderEnumerator::EnumerateCsgRec(const uint64_t subgraph, const uint64_t excluded,
+                                          std::vector<std::pair<uint64_t, uint64_t>> *const pairs) const {
+  const auto neighbors = Neighbors(subgraph) & ~excluded;
+  for (auto subset = neighbors; subset != 0; subset = (subset - 1) & neighbors) {
+    EmitCsg(subgraph | subset, pairs);
+  }
+  for (auto subset = neighbors; subset != 0; subset = (subset - 1) & neighbors) {
+    EnumerateCsgRec(subgraph | subset, excluded | neighbors, pairs);
+  }
+}
+
+void JoinOrderEnumerator::EmitCsg(const uint64_t subgraph,
+                                  std::vector<std::pair<uint64_t, uint64_t>> *const pairs) const {
+  // Complements only contain relations above the lowest one of the subgraph, so every pair is emitted once
+  const auto excluded = subgraph | UpTo(Lowest(subgraph));
+  const auto neighbors = Neighbors(subgraph) & ~excluded;
+  for (auto remaining = neighbors; remaining != 0;) {
+    const auto relation = Highest(remaining);
+    const uint64_t complement = uint64_t{1} << relation;
+    remaining &= ~complement;
+    pairs->emplace_back(subgraph, complement);
+    EnumerateCmpRec(subgraph, complement, excluded | (UpTo(relation) & neighbors), pairs);
+  }
+}
+
+void JoinOrderEnumerator::EnumerateCmpRec(const uint64_t subgraph, const uint64_t complement, const uint64_t excluded,
+                                          std::vector<std::pair<uint64_t, uint64_t>> *const pairs) const {
+  const auto neighbors = Neighbors(complement) & ~excluded;
+  for (auto subset = neighbors; subset != 0; subset = (subset - 1) & neighbors) {
+    pairs->emplace_back(subgraph, complement | subset);
+  }
+  for (auto subset = neighbors; subset != 0; subset = (subset - 1) & neighbors) {
+    EnumerateCmpRec(subgraph, complement | subset, excluded | neighbors, pairs);
+  }
+}
+
+bool JoinOrderEnumerator::EnumerateDynamic() {
+  std::vector<std::pair<uint64_t, uint64_t>> pairs;
+  for (auto relation = static_cast<int32_t>(num_relations_) - 1; relation >= 0; relation--) {
+    const uint64_t subgraph = uint64_t{1} << relation;
+    EmitCsg(subgraph, &pairs);
+    EnumerateCsgRec(subgraph, UpTo(relation), &pairs);
+  }
+  num_pairs_ = pairs.size();
+
+  // The plans of both sides of a pair have to be final before the pair is considered, so go by the size of the result
+  std::stable_sort(pairs.begin(), pairs.end(), [](const auto &lhs, const auto &rhs) {
+    return __builtin_popcountll(lhs.first | lhs.second) < __builtin_popcountll(rhs.first | rhs.second);
+  });
+  for (const auto &pair : pairs) {
+    ConsiderJoin(pair.first, pair.second);
+  }
+
+  // Without a plan for all relations, the join graph isn't connected
+  return plans_.count(all_relations_) != 0;
+}
+
+void JoinOrderEnumerator::EnumerateGreedy() {
+  std::vector<uint64_t> trees;
+  for (uint32_t relation = 0; relation < num_relations_; relation++) {
+    trees.push_back(uint64_t{1} << relation);
+  }
+
+  while (trees.size() > 1) {
+    // Prefer joins over cross products, then the smallest result
+    size_t best_left = 0;
+    size_t best_right = 1;
+    bool best_connected = false;
+    double best_cardinality = 0;
+    for (size_t left = 0; left < trees.size(); left++) {
+      for (size_t right = left + 1; right < trees.size(); right++) {
+        const auto connected = (Neighbors(trees[left]) & trees[right]) != 0;
+        const auto cardinality = JoinCardinality(trees[left], trees[right]);
+        if ((left == 0 && right == 1) || (connected && !best_connected) ||
+            (connected == best_connected && cardinality < best_cardinality)) {
+          best_left = left;
+          best_right = right;
+          best_connected = connected;
+          best_cardinality = cardinality;
+        }
+      }
+    }
+
+    ConsiderJoin(trees[best_left], trees[best_right]);
+    trees[best_left] |= trees[best_right];
+    trees.erase(trees.begin() + best_right);
+  }
+}
+
+}  // namespace terrier::optimizer
@@ -1,13 +1,20 @@
 #include "optimizer/optimizer.h"
 
+#include <algorithm>
 #include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
 #include "common/error/exception.h"
+#include "common/resource_tracker.h"
 #include "common/scoped_timer.h"
+#include "common/thread_context.h"
+#include "metrics/metrics_store.h"
 #include "optimizer/binding.h"
 #include "optimizer/input_column_deriver.h"
+#include "optimizer/join_order_enumerator.h"
+#include "optimizer/logical_operators.h"
 #include "optimizer/operator_visitor.h"
 #include "optimizer/optimization_context.h"
 #include "optimizer/optimizer_task_pool.h"
@@ -15,10 +22,94 @@
 #include "optimizer/properties.h"
 #include "optimizer/property_enforcer.h"
 #include "optimizer/rule.h"
+#include "parser/expression/column_value_expression.h"
 #include "planner/plannodes/abstract_plan_node.h"
 
 namespace terrier::optimizer {
 
+namespace {
+
+// The cardinality assumed for a relation without stats.
+constexpr double DEFAULT_CARDINALITY = 1000;
+
+bool IsInnerJoin(const Group &group) {
+  return group.GetLogicalExpressions()[0]->Contents()->GetOpType() == OpType::LOGICALINNERJOIN;
+}
+
+// Collect the relations and predicates of the cluster of inner joins rooted at the given group. The relations are the
+// children of the cluster's joins which are not inner joins themselves.
+void CollectJoinCluster(const Memo &memo, const group_id_t group_id, std::vector<group_id_t> *relations,
+                        std::vector<AnnotatedExpression> *predicates) {
+  auto *group = memo.GetGroupByID(group_id);
+  if (!IsInnerJoin(*group)) {
+    relations->push_back(group_id);
+    return;
+  }
+  auto *gexpr = group->GetLogicalExpressions()[0];
+  const auto &join_predicates = gexpr->Contents()->GetContentsAs<LogicalInnerJoin>()->GetJoinPredicates();
+  predicates->insert(predicates->end(), join_predicates.begin(), join_predicates.end());
+  for (const auto child_group_id : gexpr->GetChildGroupIDs()) {
+    CollectJoinCluster(memo, child_group_id, relations, predicates);
+  }
+}
+
+// Estimate the selectivity of a join predicate the same way the StatsCalculator does: an equality between two columns
+// retains one row per distinct value of the column with more of them, every other predicate retains all rows.
+double EstimateSelectivity(const Memo &memo, const std::vector<group_id_t> &relations, const uint64_t relation_set,
+                           const AnnotatedExpression &predicate) {
+  const auto expr = predicate.GetExpr();
+  if (expr->GetExpressionType() != parser::ExpressionType::COMPARE_EQUAL ||
+      expr->GetChild(0)->GetExpressionType() != parser::ExpressionType::COLUMN_VALUE ||
+      expr->GetChild(1)->GetExpressionType() != parser::ExpressionType::COLUMN_VALUE) {
+    return 1;
+  }
+
+  double max_distinct = 0;
+  double max_rows = 1;
+  for (uint32_t relation = 0; relation < relations.size(); relation++) {
+    if ((relation_set & (uint64_t{1} << relation)) == 0) continue;
+    auto *group = memo.GetGroupByID(relations[relation]);
+    max_rows = std::max(max_rows, static_cast<double>(group->GetNumRows()));
+    for (size_t idx = 0; idx < 2; idx++) {
+      const auto col_name = expr->GetChild(idx).CastManagedPointerTo<parser::ColumnValueExpression>()->GetFullName();
+      if (group->HasColumnStats(col_name)) {
+        max_distinct = std::max(max_distinct, group->GetStats(col_name)->GetCardinality());
+      }
+    }
+  }
+  return 1 / (max_distinct >= 1 ? max_distinct : max_rows);
+}
+
+// Build the join tree the enumerator chose for the given set of relations. Every predicate is applied by the lowest
+// join that has all the relations it refers to.
+std::unique_ptr<AbstractOptimizerNode> BuildJoinTree(
+    const JoinOrderEnumerator &enumerator, const uint64_t relation_set, const std::vector<group_id_t> &relations,
+    const std::vector<std::pair<uint64_t, AnnotatedExpression>> &predicates, transaction::TransactionContext *txn) {
+  if ((relation_set & (relation_set - 1)) == 0) {
+    const auto relation = static_cast<size_t>(__builtin_ctzll(relation_set));
+    return std::make_unique<OperatorNode>(LeafOperator::Make(relations[relation]).RegisterWithTxnContext(txn),
+                                          std::vector<std::unique_ptr<AbstractOptimizerNode>>{}, txn);
+  }
+
+  const auto left = enumerator.GetLeft(relation_set);
+  const auto right = enumerator.GetRight(relation_set);
+  std::vector<AnnotatedExpression> join_predicates;
+  for (const auto &predicate : predicates) {
+    const auto refers = predicate.first;
+    if ((refers & ~relation_set) == 0 && (refers & ~left) != 0 && (refers & ~right) != 0) {
+      join_predicates.push_back(predicate.second);
+    }
+  }
+
+  std::vector<std::unique_ptr<AbstractOptimizerNode>> children;
+  children.emplace_back(BuildJoinTree(enumerator, left, relations, predicates, txn));
+  children.emplace_back(BuildJoinTree(enumerator, right, relations, predicates, txn));
+  return std::make_unique<OperatorNode>(LogicalInnerJoin::Make(std::move(join_predicates)).RegisterWithTxnContext(txn),
+                                        std::move(children), txn);
+}
+
+}  // namespace
+
 void Optimizer::Reset() { context_ = std::make_unique<OptimizerContext>(common::ManagedPointer(cost_model_)); }
 
 std::unique_ptr<planner::AbstractPlanNode> Optimizer::BuildPlanTree(transaction::TransactionContext *txn,
@@ -28,6 +119,16 @@ std::unique_ptr<planner::AbstractPlanNode> Optimizer::BuildPlanTree(transaction:
   context_->SetTxn(txn);
   context_->SetCatalogAccessor(accessor);
   context_->SetStatsStorage(storage);
+  num_join_relations_ = 0;
+  greedy_join_order_ = false;
+
+  // The tracker is only allocated when needed, as setting up its perf counters is not free
+  std::unique_ptr<common::ResourceTracker> resource_tracker;
+  if (common::thread_context.metrics_store_ != nullptr &&
+      common::thread_context.metrics_store_->ComponentToRecord(metrics::MetricsComponent::OPTIMIZER)) {
+    resource_tracker = std::make_unique<common::ResourceTracker>();
+    resource_tracker->Start();
+  }
 
   // Generate initial operator tree from query tree
   GroupExpression *gexpr = nullptr;
@@ -45,15 +146,25 @@ std::unique_ptr<planner::AbstractPlanNode> Optimizer::BuildPlanTree(transaction:
     output_exprs.push_back(expr);
   }
 
+  bool timed_out = false;
   try {
     OptimizeLoop(root_id, phys_properties);
   } catch (OptimizerException &e) {
     OPTIMIZER_LOG_WARN("Optimize Loop ended prematurely: {0}", e.what());
+    timed_out = true;
   }
 
   try {
     auto best_plan = ChooseBestPlan(txn, accessor, root_id, phys_properties, output_exprs);
 
+    if (resource_tracker != nullptr) {
+      resource_tracker->Stop();
+      const auto &memo = context_->GetMemo();
+      common::thread_context.metrics_store_->RecordOptimizeData(memo.GetNumGroups(), memo.GetNumGroupExpressions(),
+                                                                num_join_relations_, greedy_join_order_, timed_out,
+                                                                resource_tracker->GetMetrics());
+    }
+
     // Reset memo after finishing the optimization
     Reset();
     return best_plan;
@@ -127,16 +238,85 @@ void Optimizer::OptimizeLoop(group_id_t root_group_id, PropertySet *required_pro
   task_stack->Push(new BottomUpRewrite(root_group_id, root_context, RuleSetName::UNNEST_SUBQUERY, false));
   ExecuteTaskStack(task_stack, root_group_id, root_context);
 
-  // Perform optimization after the rewrite
-  Memo &memo = context_->GetMemo();
-  task_stack->Push(new OptimizeGroup(memo.GetGroupByID(root_group_id), root_context));
-
   // Derive stats for the only one logical expression before optimizing
+  Memo &memo = context_->GetMemo();
   task_stack->Push(new DeriveStats(memo.GetGroupByID(root_group_id)->GetLogicalExpression(), ExprSet{}, root_context));
+  ExecuteTaskStack(task_stack, root_group_id, root_context);
 
+  // Seed the memo with the best join orders, using the stats of the joined relations
+  EnumerateJoinOrders(root_group_id, root_context);
+  ExecuteTaskStack(task_stack, root_group_id, root_context);
+
+  // Perform optimization after the rewrite
+  task_stack->Push(new OptimizeGroup(memo.GetGroupByID(root_group_id), root_context));
   ExecuteTaskStack(task_stack, root_group_id, root_context);
 }
 
+void Optimizer::EnumerateJoinOrders(group_id_t group_id, OptimizationContext *optimization_context) {
+  auto &memo = context_->GetMemo();
+  auto *group = memo.GetGroupByID(group_id);
+  if (!IsInnerJoin(*group)) {
+    for (const auto child_group_id : group->GetLogicalExpressions()[0]->GetChildGroupIDs()) {
+      EnumerateJoinOrders(child_group_id, optimization_context);
+    }
+    return;
+  }
+
+  std::vector<group_id_t> relations;
+  std::vector<AnnotatedExpression> join_predicates;
+  CollectJoinCluster(memo, group_id, &relations, &join_predicates);
+
+  // Joins nested below the relations, e.g., in a derived table, form clusters of their own
+  for (const auto relation : relations) {
+    EnumerateJoinOrders(relation, optimization_context);
+  }
+
+  // Two relations have a single join order, up to commutativity, which the rules explore anyway
+  if (relations.size() < 3 || relations.size() > JoinOrderEnumerator::MAX_RELATIONS) {
+    return;
+  }
+
+  JoinOrderEnumerator enumerator;
+  for (const auto relation : relations) {
+    const auto num_rows = memo.GetGroupByID(relation)->GetNumRows();
+    enumerator.AddRelation(std::max(num_rows >= 0 ? static_cast<double>(num_rows) : DEFAULT_CARDINALITY, 1.0));
+  }
+
+  // A predicate whose tables cannot all be attributed to the relations is applied once all of them are joined
+  std::vector<std::pair<uint64_t, AnnotatedExpression>> predicates;
+  for (const auto &predicate : join_predicates) {
+    uint64_t relation_set = 0;
+    for (const auto &alias : predicate.GetTableAliasSet()) {
+      const auto owner = std::find_if(relations.begin(), relations.end(), [&](const group_id_t relation) {
+        return memo.GetGroupByID(relation)->GetTableAliases().count(alias) != 0;
+      });
+      if (owner == relations.end()) {
+        relation_set = enumerator.GetAllRelations();
+        break;
+      }
+      relation_set |= uint64_t{1} << static_cast<uint64_t>(owner - relations.begin());
+    }
+    if (__builtin_popcountll(relation_set) < 2) {
+      relation_set = enumerator.GetAllRelations();
+    }
+    enumerator.AddPredicate(relation_set, EstimateSelectivity(memo, relations, relation_set, predicate));
+    predicates.emplace_back(relation_set, predicate);
+  }
+
+  const auto dynamic = enumerator.Enumerate();
+  num_join_relations_ = std::max<uint64_t>(num_join_relations_, relations.size());
+  greedy_join_order_ = greedy_join_order_ || !dynamic;
+  OPTIMIZER_LOG_DEBUG("Enumerated {0} join pairs of {1} relations, estimated cost {2}", enumerator.GetNumPairs(),
+                      relations.size(), enumerator.GetCost(enumerator.GetAllRelations()));
+
+  auto join_tree = BuildJoinTree(enumerator, enumerator.GetAllRelations(), relations, predicates, context_->GetTxn());
+  GroupExpression *gexpr = nullptr;
+  if (context_->RecordOptimizerNodeIntoGroup(common::ManagedPointer(join_tree), &gexpr, group_id)) {
+    context_->PushTask(new DeriveStats(gexpr, ExprSet{}, optimization_context));
+  }
+  context_->SetJoinOrdersEnumerated();
+}
+
 void Optimizer::ExecuteTaskStack(OptimizerTaskStack *task_stack, group_id_t root_group_id,
                                  OptimizationContext *root_context) {
   auto root_group = context_->GetMemo().GetGroupByID(root_group_id);
@@ -492,6 +492,51 @@ bool InnerHashJoin::operator==(const BaseOperatorNodeContents &r) {
   return true;
 }
 
+//===--------------------------------------------------------------------===//
+// InnerMergeJoin
+//===--------------------------------------------------------------------===//
+BaseOperatorNodeContents *InnerMergeJoin::Copy() const { return new InnerMergeJoin(*this); }
+
+Operator InnerMergeJoin::Make(std::vector<AnnotatedExpression> &&join_predicates,
+                              std::vector<common::ManagedPointer<parser::AbstractExpression>> &&left_keys,
+                              std::vector<common::ManagedPointer<parser::AbstractExpression>> &&right_keys) {
+  auto *join = new InnerMergeJoin();
+  join->join_predicates_ = std::move(join_predicates);
+  join->left_keys_ = std::move(left_keys);
+  join->right_keys_ = std::move(right_keys);
+  return Operator(common::ManagedPointer<BaseOperatorNodeContents>(join));
+}
+
+common::hash_t InnerMergeJoin::Hash() const {
+  common::hash_t hash = BaseOperatorNodeContents::Hash();
+  for (auto &expr : left_keys_) hash = common::HashUtil::CombineHashes(hash, expr->Hash());
+  for (auto &expr : right_keys_) hash = common::HashUtil::CombineHashes(hash, expr->Hash());
+  for (auto &pred : join_predicates_) {
+    auto expr = pred.GetExpr();
+    if (expr)
+      hash = common::HashUtil::SumHashes(hash, expr->Hash());
+    else
+      hash = common::HashUtil::SumHashes(hash, BaseOperatorNodeContents::Hash());
+  }
+  return hash;
+}
+
+bool InnerMergeJoin::operator==(const BaseOperatorNodeContents &r) {
+  if (r.GetOpType() != OpType::INNERMERGEJOIN) return false;
+  const InnerMergeJoin &node = *dynamic_cast<const InnerMergeJoin *>(&r);
+  if (left_keys_.size() != node.left_keys_.size() || right_keys_.size() != node.right_keys_.size() ||
+      join_predicates_.size() != node.join_predicates_.size())
+    return false;
+  if (join_predicates_ != node.join_predicates_) return false;
+  for (size_t i = 0; i < left_keys_.size(); i++) {
+    if (*(left_keys_[i]) != *(node.left_keys_[i])) return false;
+  }
+  for (size_t i = 0; i < right_keys_.size(); i++) {
+    if (*(right_keys_[i]) != *(node.right_keys_[i])) return false;
+  }
+  return true;
+}
+
 //===--------------------------------------------------------------------===//
 // LeftHashJoin
 //===--------------------------------------------------------------------===//
@@ -1328,6 +1373,8 @@ const char *OperatorNodeContents<OuterNLJoin>::name = "OuterNLJoin";
 template <>
 const char *OperatorNodeContents<InnerHashJoin>::name = "InnerHashJoin";
 template <>
+const char *OperatorNodeContents<InnerMergeJoin>::name = "InnerMergeJoin";
+template <>
 const char *OperatorNodeContents<LeftHashJoin>::name = "LeftHashJoin";
 template <>
 const char *OperatorNodeContents<RightHashJoin>::name = "RightHashJoin";
@@ -1406,6 +1453,8 @@ OpType OperatorNodeContents<OuterNLJoin>::type = OpType::OUTERNLJOIN;
 template <>
 OpType OperatorNodeContents<InnerHashJoin>::type = OpType::INNERHASHJOIN;
 template <>
+OpType OperatorNodeContents<InnerMergeJoin>::type = OpType::INNERMERGEJOIN;
+template <>
 OpType OperatorNodeContents<LeftHashJoin>::type = OpType::LEFTHASHJOIN;
 template <>
 OpType OperatorNodeContents<RightHashJoin>::type = OpType::RIGHTHASHJOIN;
@@ -42,6 +42,7 @@
 #include "planner/plannodes/index_scan_plan_node.h"
 #include "planner/plannodes/insert_plan_node.h"
 #include "planner/plannodes/limit_plan_node.h"
+#include "planner/plannodes/merge_join_plan_node.h"
 #include "planner/plannodes/nested_loop_join_plan_node.h"
 #include "planner/plannodes/order_by_plan_node.h"
 #include "planner/plannodes/projection_plan_node.h"
@@ -284,6 +285,9 @@ void PlanGenerator::Visit(const ExternalFileScan *op) {
     case parser::ExternalFileFormat::BINARY: {
       TERRIER_ASSERT(0, "Missing BinaryScanPlanNode");
     }
+    case parser::ExternalFileFormat::TEXT: {
+      TERRIER_ASSERT(0, "Missing TextScanPlanNode");
+    }
   }
 }
 
@@ -626,6 +630,42 @@ void PlanGenerator::Visit(UNUSED_ATTRIBUTE const OuterHashJoin *op) {
   TERRIER_ASSERT(0, "OuterHashJoin not implemented");
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// A mergejoin B (when both inputs already arrive sorted on the join keys)
+///////////////////////////////////////////////////////////////////////////////
+
+void PlanGenerator::Visit(const InnerMergeJoin *op) {
+  auto proj_schema = GenerateProjectionForJoin();
+
+  auto comb_pred = parser::ExpressionUtil::JoinAnnotatedExprs(op->GetJoinPredicates());
+  auto eval_pred =
+      parser::ExpressionUtil::EvaluateExpression(children_expr_map_, common::ManagedPointer(comb_pred.get()));
+  auto join_predicate =
+      parser::ExpressionUtil::ConvertExprCVNodes(common::ManagedPointer(eval_pred.get()), children_expr_map_).release();
+  RegisterPointerCleanup<parser::AbstractExpression>(join_predicate, true, true);
+
+  auto builder = planner::MergeJoinPlanNode::Builder();
+  builder.SetOutputSchema(std::move(proj_schema));
+
+  for (auto &expr : op->GetLeftKeys()) {
+    auto left_key = parser::ExpressionUtil::EvaluateExpression(children_expr_map_, expr).release();
+    RegisterPointerCleanup<parser::AbstractExpression>(left_key, true, true);
+    builder.AddLeftMergeKey(common::ManagedPointer(left_key));
+  }
+
+  for (auto &expr : op->GetRightKeys()) {
+    auto right_key = parser::ExpressionUtil::EvaluateExpression(children_expr_map_, expr).release();
+    RegisterPointerCleanup<parser::AbstractExpression>(right_key, true, true);
+    builder.AddRightMergeKey(common::ManagedPointer(right_key));
+  }
+
+  builder.AddChild(std::move(children_plans_[0]));
+  builder.AddChild(std::move(children_plans_[1]));
+  builder.SetJoinPredicate(common::ManagedPointer(join_predicate));
+  builder.SetJoinType(planner::LogicalJoinType::INNER);
+  output_plan_ = builder.Build();
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // Aggregations (when the groups are greater than individuals)
 ///////////////////////////////////////////////////////////////////////////////
@@ -705,7 +745,6 @@ void PlanGenerator::Visit(const HashGroupBy *op) {
 }
 
 void PlanGenerator::Visit(const SortGroupBy *op) {
-  // Don't think this is ever visited since rule_impls.cpp does not create SortGroupBy
   auto having_predicates = parser::ExpressionUtil::JoinAnnotatedExprs(op->GetHaving());
   BuildAggregatePlan(planner::AggregateStrategyType::SORTED, &op->GetColumns(),
                      common::ManagedPointer(having_predicates.get()));
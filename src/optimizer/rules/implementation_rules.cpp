@@ -414,6 +414,44 @@ void LogicalGroupByToPhysicalHashGroupBy::Transform(common::ManagedPointer<Abstr
   transformed->emplace_back(std::move(result));
 }
 
+///////////////////////////////////////////////////////////////////////////////
+/// LogicalAggregateAndGroupByToSortGroupBy
+///////////////////////////////////////////////////////////////////////////////
+LogicalGroupByToPhysicalSortGroupBy::LogicalGroupByToPhysicalSortGroupBy() {
+  type_ = RuleType::AGGREGATE_TO_SORT_AGGREGATE;
+  match_pattern_ = new Pattern(OpType::LOGICALAGGREGATEANDGROUPBY);
+
+  auto child = new Pattern(OpType::LEAF);
+  match_pattern_->AddChild(child);
+}
+
+bool LogicalGroupByToPhysicalSortGroupBy::Check(common::ManagedPointer<AbstractOptimizerNode> plan,
+                                                OptimizationContext *context) const {
+  (void)context;
+  // A sort-based aggregation needs its input ordered on the grouping columns, so there must be some.
+  const auto agg_op = plan->Contents()->GetContentsAs<LogicalAggregateAndGroupBy>();
+  return !agg_op->GetColumns().empty();
+}
+
+void LogicalGroupByToPhysicalSortGroupBy::Transform(common::ManagedPointer<AbstractOptimizerNode> input,
+                                                    std::vector<std::unique_ptr<AbstractOptimizerNode>> *transformed,
+                                                    UNUSED_ATTRIBUTE OptimizationContext *context) const {
+  const auto agg_op = input->Contents()->GetContentsAs<LogicalAggregateAndGroupBy>();
+  TERRIER_ASSERT(input->GetChildren().size() == 1, "LogicalAggregateAndGroupBy should have 1 child");
+
+  std::vector<common::ManagedPointer<parser::AbstractExpression>> cols = agg_op->GetColumns();
+  std::vector<AnnotatedExpression> having = agg_op->GetHaving();
+
+  std::vector<std::unique_ptr<AbstractOptimizerNode>> c;
+  auto child = input->GetChildren()[0]->Copy();
+  c.emplace_back(std::move(child));
+
+  auto result = std::make_unique<OperatorNode>(SortGroupBy::Make(std::move(cols), std::move(having))
+                                                   .RegisterWithTxnContext(context->GetOptimizerContext()->GetTxn()),
+                                               std::move(c), context->GetOptimizerContext()->GetTxn());
+  transformed->emplace_back(std::move(result));
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 /// LogicalAggregateToPhysicalAggregate
 ///////////////////////////////////////////////////////////////////////////////
@@ -628,6 +666,63 @@ void LogicalInnerJoinToPhysicalInnerHashJoin::Transform(
   }
 }
 
+///////////////////////////////////////////////////////////////////////////////
+/// LogicalInnerJoinToPhysicalInnerMergeJoin
+///////////////////////////////////////////////////////////////////////////////
+LogicalInnerJoinToPhysicalInnerMergeJoin::LogicalInnerJoinToPhysicalInnerMergeJoin() {
+  type_ = RuleType::INNER_JOIN_TO_MERGE_JOIN;
+
+  // Make three node types for pattern matching
+  auto left_child(new Pattern(OpType::LEAF));
+  auto right_child(new Pattern(OpType::LEAF));
+
+  // Initialize a pattern for optimizer to match
+  match_pattern_ = new Pattern(OpType::LOGICALINNERJOIN);
+
+  // Add node - we match join relation R and S as well as the predicate exp
+  match_pattern_->AddChild(left_child);
+  match_pattern_->AddChild(right_child);
+}
+
+bool LogicalInnerJoinToPhysicalInnerMergeJoin::Check(common::ManagedPointer<AbstractOptimizerNode> plan,
+                                                     OptimizationContext *context) const {
+  (void)context;
+  (void)plan;
+  return true;
+}
+
+void LogicalInnerJoinToPhysicalInnerMergeJoin::Transform(
+    common::ManagedPointer<AbstractOptimizerNode> input,
+    std::vector<std::unique_ptr<AbstractOptimizerNode>> *transformed,
+    UNUSED_ATTRIBUTE OptimizationContext *context) const {
+  const auto inner_join = input->Contents()->GetContentsAs<LogicalInnerJoin>();
+
+  auto children = input->GetChildren();
+  TERRIER_ASSERT(children.size() == 2, "Inner Join should have two child");
+  auto left_group_id = children[0]->Contents()->GetContentsAs<LeafOperator>()->GetOriginGroup();
+  auto right_group_id = children[1]->Contents()->GetContentsAs<LeafOperator>()->GetOriginGroup();
+  auto &left_group_alias = context->GetOptimizerContext()->GetMemo().GetGroupByID(left_group_id)->GetTableAliases();
+  auto &right_group_alias = context->GetOptimizerContext()->GetMemo().GetGroupByID(right_group_id)->GetTableAliases();
+  std::vector<common::ManagedPointer<parser::AbstractExpression>> left_keys;
+  std::vector<common::ManagedPointer<parser::AbstractExpression>> right_keys;
+
+  std::vector<AnnotatedExpression> join_preds = inner_join->GetJoinPredicates();
+  OptimizerUtil::ExtractEquiJoinKeys(join_preds, &left_keys, &right_keys, left_group_alias, right_group_alias);
+
+  TERRIER_ASSERT(right_keys.size() == left_keys.size(), "# left/right keys should equal");
+  std::vector<std::unique_ptr<AbstractOptimizerNode>> child;
+  child.emplace_back(children[0]->Copy());
+  child.emplace_back(children[1]->Copy());
+  // Merging requires at least one equi-join key to order both inputs on.
+  if (!left_keys.empty()) {
+    auto result = std::make_unique<OperatorNode>(
+        InnerMergeJoin::Make(std::move(join_preds), std::move(left_keys), std::move(right_keys))
+            .RegisterWithTxnContext(context->GetOptimizerContext()->GetTxn()),
+        std::move(child), context->GetOptimizerContext()->GetTxn());
+    transformed->emplace_back(std::move(result));
+  }
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 /// LogicalLimitToPhysicalLimit
 ///////////////////////////////////////////////////////////////////////////////
@@ -83,9 +83,10 @@ LogicalInnerJoinAssociativity::LogicalInnerJoinAssociativity() {
 
 bool LogicalInnerJoinAssociativity::Check(common::ManagedPointer<AbstractOptimizerNode> plan,
                                           OptimizationContext *context) const {
-  (void)context;
   (void)plan;
-  return true;
+  // The memo already holds the best join order found by the JoinOrderEnumerator, so exploring the others through
+  // associativity would only grow the search space exponentially without finding a cheaper plan.
+  return !context->GetOptimizerContext()->HasEnumeratedJoinOrders();
 }
 
 void LogicalInnerJoinAssociativity::Transform(common::ManagedPointer<AbstractOptimizerNode> input,
@@ -4,11 +4,14 @@
 #include <utility>
 
 #include "loggers/optimizer_logger.h"
+#include "transaction/deferred_action_manager.h"
+#include "transaction/transaction_context.h"
 
 namespace terrier::optimizer {
 common::ManagedPointer<TableStats> StatsStorage::GetTableStats(catalog::db_oid_t database_id,
                                                                catalog::table_oid_t table_id) {
   StatsStorageKey stats_storage_key = std::make_pair(database_id, table_id);
+  common::SharedLatch::ScopedSharedLatch guard(&latch_);
   auto table_it = table_stats_storage_.find(stats_storage_key);
 
   if (table_it != table_stats_storage_.end()) {
@@ -20,6 +23,7 @@ common::ManagedPointer<TableStats> StatsStorage::GetTableStats(catalog::db_oid_t
 bool StatsStorage::InsertTableStats(catalog::db_oid_t database_id, catalog::table_oid_t table_id,
                                     TableStats table_stats) {
   StatsStorageKey stats_storage_key = std::make_pair(database_id, table_id);
+  common::SharedLatch::ScopedExclusiveLatch guard(&latch_);
   auto table_it = table_stats_storage_.find(stats_storage_key);
 
   if (table_it != table_stats_storage_.end()) {
@@ -33,6 +37,7 @@ bool StatsStorage::InsertTableStats(catalog::db_oid_t database_id, catalog::tabl
 
 bool StatsStorage::DeleteTableStats(catalog::db_oid_t database_id, catalog::table_oid_t table_id) {
   StatsStorageKey stats_storage_key = std::make_pair(database_id, table_id);
+  common::SharedLatch::ScopedExclusiveLatch guard(&latch_);
   auto table_it = table_stats_storage_.find(stats_storage_key);
 
   if (table_it != table_stats_storage_.end()) {
@@ -41,4 +46,41 @@ bool StatsStorage::DeleteTableStats(catalog::db_oid_t database_id, catalog::tabl
   }
   return false;
 }
+
+void StatsStorage::UpdateTableStats(catalog::db_oid_t database_id, catalog::table_oid_t table_id,
+                                    std::unique_ptr<TableStats> table_stats, transaction::TransactionContext *txn) {
+  // Transaction end actions must be copyable, so they hand the stats around as a raw pointer
+  auto *const new_stats = table_stats.release();
+  txn->RegisterCommitAction([=](transaction::DeferredActionManager *deferred_action_manager) {
+    StatsStorageKey stats_storage_key = std::make_pair(database_id, table_id);
+    TableStats *old_stats;
+    {
+      common::SharedLatch::ScopedExclusiveLatch guard(&latch_);
+      auto &stored_stats = table_stats_storage_[stats_storage_key];
+      old_stats = stored_stats.release();
+      stored_stats.reset(new_stats);
+      modified_rows_.erase(stats_storage_key);
+    }
+    // Optimizers running concurrently may still be reading the old stats
+    if (old_stats != nullptr) deferred_action_manager->RegisterDeferredAction([=]() { delete old_stats; });
+  });
+  txn->RegisterAbortAction([=]() { delete new_stats; });
+}
+
+bool StatsStorage::AddModifiedRows(catalog::db_oid_t database_id, catalog::table_oid_t table_id, uint64_t num_rows,
+                                   uint64_t threshold) {
+  StatsStorageKey stats_storage_key = std::make_pair(database_id, table_id);
+  common::SharedLatch::ScopedExclusiveLatch guard(&latch_);
+  auto &modified_rows = modified_rows_[stats_storage_key];
+  modified_rows += num_rows;
+
+  auto table_it = table_stats_storage_.find(stats_storage_key);
+  const auto table_rows = table_it != table_stats_storage_.end() ? table_it->second->GetNumRows() : 0;
+  if (static_cast<double>(modified_rows) <=
+      static_cast<double>(threshold) + AUTO_ANALYZE_SCALE_FACTOR * static_cast<double>(table_rows)) {
+    return false;
+  }
+  modified_rows = 0;
+  return true;
+}
 }  // namespace terrier::optimizer
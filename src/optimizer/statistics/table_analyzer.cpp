@@ -0,0 +1,217 @@
+#include "optimizer/statistics/table_analyzer.h"
+
+#include <algorithm>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "common/allocator.h"
+#include "common/constants.h"
+#include "execution/util/morsel_scheduler.h"
+#include "loggers/optimizer_logger.h"
+#include "storage/projected_columns.h"
+#include "storage/sql_table.h"
+#include "transaction/transaction_context.h"
+
+namespace terrier::optimizer {
+
+namespace {
+
+bool IsNumeric(const type::TypeId type) {
+  switch (type) {
+    case type::TypeId::BOOLEAN:
+    case type::TypeId::TINYINT:
+    case type::TypeId::SMALLINT:
+    case type::TypeId::INTEGER:
+    case type::TypeId::BIGINT:
+    case type::TypeId::DECIMAL:
+    case type::TypeId::TIMESTAMP:
+    case type::TypeId::DATE:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Numeric values are compared as doubles by the selectivity estimation, so that is how they are collected as well
+double ReadNumeric(const type::TypeId type, const byte *const column, const uint32_t row) {
+  switch (type) {
+    case type::TypeId::BOOLEAN:
+    case type::TypeId::TINYINT:
+      return reinterpret_cast<const int8_t *>(column)[row];
+    case type::TypeId::SMALLINT:
+      return reinterpret_cast<const int16_t *>(column)[row];
+    case type::TypeId::INTEGER:
+      return reinterpret_cast<const int32_t *>(column)[row];
+    case type::TypeId::BIGINT:
+      return static_cast<double>(reinterpret_cast<const int64_t *>(column)[row]);
+    case type::TypeId::DECIMAL:
+      return reinterpret_cast<const double *>(column)[row];
+    case type::TypeId::TIMESTAMP:
+      return static_cast<double>(reinterpret_cast<const uint64_t *>(column)[row]);
+    case type::TypeId::DATE:
+      return reinterpret_cast<const uint32_t *>(column)[row];
+    default:
+      UNREACHABLE("Not a numeric type.");
+  }
+}
+
+}  // namespace
+
+TableAnalyzer::ColumnSketches::ColumnSketches(const bool numeric)
+    : distinct_values_(std::make_unique<HyperLogLog<double>>(HLL_PRECISION)) {
+  if (numeric) {
+    top_k_ = std::make_unique<TopKElements<double>>(NUM_MOST_COMMON_VALUES, TOP_K_SKETCH_WIDTH);
+    histogram_ = std::make_unique<Histogram<double>>(NUM_HISTOGRAM_BINS);
+  }
+}
+
+void TableAnalyzer::ColumnSketches::Merge(const ColumnSketches &other) {
+  num_values_ += other.num_values_;
+  num_nulls_ += other.num_nulls_;
+  distinct_values_->Merge(*other.distinct_values_);
+  if (top_k_ != nullptr) {
+    top_k_->Merge(*other.top_k_);
+    histogram_->Merge(*other.histogram_);
+  }
+}
+
+TableAnalyzer::TableAnalyzer(const catalog::db_oid_t db_oid, const catalog::table_oid_t table_oid,
+                             const common::ManagedPointer<storage::SqlTable> table, const catalog::Schema &schema,
+                             std::vector<catalog::col_oid_t> col_oids, const uint32_t max_sample_blocks)
+    : db_oid_(db_oid),
+      table_oid_(table_oid),
+      table_(table),
+      col_oids_(std::move(col_oids)),
+      projection_map_(table_->ProjectionMapForOids(col_oids_)),
+      max_sample_blocks_(max_sample_blocks) {
+  col_types_.reserve(col_oids_.size());
+  for (const auto col_oid : col_oids_) {
+    col_types_.emplace_back(schema.GetColumn(col_oid).Type());
+  }
+}
+
+std::vector<TableAnalyzer::ColumnSketches> TableAnalyzer::CreateSketches() const {
+  std::vector<ColumnSketches> sketches;
+  sketches.reserve(col_types_.size());
+  for (const auto type : col_types_) {
+    sketches.emplace_back(IsNumeric(type));
+  }
+  return sketches;
+}
+
+std::unique_ptr<TableStats> TableAnalyzer::Analyze(const common::ManagedPointer<transaction::TransactionContext> txn) {
+  const auto num_blocks = table_->GetNumBlocks();
+  num_sampled_blocks_ = max_sample_blocks_ > 0 ? std::min(num_blocks, max_sample_blocks_) : num_blocks;
+
+  std::vector<ColumnSketches> merged = CreateSketches();
+  uint64_t num_scanned_rows = 0;
+  std::mutex merge_latch;
+
+  execution::util::MorselScheduler::Instance()->ParallelFor(
+      0, num_sampled_blocks_, MORSEL_SIZE, -1, execution::util::MorselScheduler::DEFAULT_PRIORITY, true,
+      [&](const uint32_t sample_begin, const uint32_t sample_end) {
+        std::vector<ColumnSketches> sketches = CreateSketches();
+        uint64_t num_rows = 0;
+
+        const auto initializer =
+            table_->InitializerForProjectedColumns(col_oids_, common::Constants::K_DEFAULT_VECTOR_SIZE);
+        byte *const buffer = common::AllocationUtil::AllocateAligned(initializer.ProjectedColumnsSize());
+        auto *const columns = initializer.Initialize(buffer);
+
+        for (uint32_t sample = sample_begin; sample < sample_end; sample++) {
+          // Without sampling, this is every block
+          const auto block = static_cast<uint32_t>(uint64_t{sample} * num_blocks / num_sampled_blocks_);
+          auto iter = table_->GetBlockedSlotIterator(block, block + 1);
+          while (iter != table_->end() && (*iter).GetBlock() != nullptr) {
+            table_->Scan(txn, &iter, columns);
+            num_rows += columns->NumTuples();
+            AddRows(columns, &sketches);
+          }
+        }
+        delete[] buffer;
+
+        std::lock_guard<std::mutex> guard(merge_latch);
+        num_scanned_rows += num_rows;
+        for (size_t col_idx = 0; col_idx < merged.size(); col_idx++) {
+          merged[col_idx].Merge(sketches[col_idx]);
+        }
+      });
+
+  const double scale_factor =
+      num_sampled_blocks_ > 0 ? static_cast<double>(num_blocks) / static_cast<double>(num_sampled_blocks_) : 1.0;
+  const auto num_rows = static_cast<size_t>(static_cast<double>(num_scanned_rows) * scale_factor);
+  OPTIMIZER_LOG_DEBUG("ANALYZE scanned {} of {} blocks ({} rows) of table {}", num_sampled_blocks_, num_blocks,
+                      num_scanned_rows, table_oid_.UnderlyingValue());
+
+  std::vector<ColumnStats> column_stats;
+  column_stats.reserve(col_oids_.size());
+  for (size_t col_idx = 0; col_idx < col_oids_.size(); col_idx++) {
+    column_stats.emplace_back(BuildColumnStats(col_idx, merged[col_idx], num_rows, scale_factor));
+  }
+  return std::make_unique<TableStats>(db_oid_, table_oid_, num_rows, true, column_stats);
+}
+
+void TableAnalyzer::AddRows(storage::ProjectedColumns *const columns,
+                            std::vector<ColumnSketches> *const sketches) const {
+  const auto num_tuples = columns->NumTuples();
+  for (size_t col_idx = 0; col_idx < col_oids_.size(); col_idx++) {
+    const auto type = col_types_[col_idx];
+    const auto projection_idx = projection_map_.at(col_oids_[col_idx]);
+    const auto *const nulls = columns->ColumnNullBitmap(projection_idx);
+    const byte *const column = columns->ColumnStart(projection_idx);
+    auto &column_sketches = (*sketches)[col_idx];
+
+    for (uint32_t row = 0; row < num_tuples; row++) {
+      // A set bit means the value is present
+      if (!nulls->Test(row)) {
+        column_sketches.num_nulls_++;
+        continue;
+      }
+      column_sketches.num_values_++;
+      if (column_sketches.top_k_ != nullptr) {
+        const auto value = ReadNumeric(type, column, row);
+        column_sketches.distinct_values_->Update(value);
+        column_sketches.top_k_->Increment(value, 1);
+        column_sketches.histogram_->Increment(value);
+      } else {
+        const auto &varlen = reinterpret_cast<const storage::VarlenEntry *>(column)[row];
+        column_sketches.distinct_values_->Update(varlen.Content(), varlen.Size());
+      }
+    }
+  }
+}
+
+ColumnStats TableAnalyzer::BuildColumnStats(const size_t col_idx, const ColumnSketches &sketches,
+                                            const size_t num_rows, const double scale_factor) const {
+  const auto num_scanned = sketches.num_values_ + sketches.num_nulls_;
+  const double frac_null =
+      num_scanned > 0 ? static_cast<double>(sketches.num_nulls_) / static_cast<double>(num_scanned) : 0.0;
+
+  // Every value of the table is assumed to appear in the sample, unless nearly all of the sampled values are distinct,
+  // in which case the column is assumed to be unique
+  const auto num_values = static_cast<double>(sketches.num_values_);
+  auto cardinality = std::min(static_cast<double>(sketches.distinct_values_->EstimateCardinality()), num_values);
+  if (scale_factor > 1.0 && cardinality >= UNIQUE_FRACTION * num_values) cardinality *= scale_factor;
+
+  std::vector<double> most_common_vals;
+  std::vector<double> most_common_freqs;
+  std::vector<double> histogram_bounds;
+  if (sketches.top_k_ != nullptr) {
+    // The top keys come sorted by ascending counts. A value seen only once is not more common than any other
+    const auto top_keys = sketches.top_k_->GetSortedTopKeys();
+    for (auto key = top_keys.rbegin(); key != top_keys.rend(); ++key) {
+      const auto count = sketches.top_k_->EstimateItemCount(*key);
+      if (count <= 1) break;
+      most_common_vals.emplace_back(*key);
+      most_common_freqs.emplace_back(static_cast<double>(count) * scale_factor);
+    }
+    histogram_bounds = sketches.histogram_->Uniform();
+  }
+
+  return ColumnStats(db_oid_, table_oid_, col_oids_[col_idx], num_rows, cardinality, frac_null,
+                     std::move(most_common_vals), std::move(most_common_freqs), std::move(histogram_bounds), true);
+}
+
+}  // namespace terrier::optimizer
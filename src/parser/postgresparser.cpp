@@ -1098,8 +1098,9 @@ std::unique_ptr<CopyStatement> PostgresParser::CopyTransform(ParseResult *parse_
   auto file_path = root->filename_ != nullptr ? root->filename_ : "";
   auto is_from = root->is_from_;
 
-  char delimiter = ',';
-  ExternalFileFormat format = ExternalFileFormat::CSV;
+  // Like Postgres, the default format is text, whose default delimiter is a tab
+  char delimiter = '\0';
+  ExternalFileFormat format = ExternalFileFormat::TEXT;
   char quote = '"';
   char escape = '"';
   if (root->options_ != nullptr) {
@@ -1113,6 +1114,8 @@ std::unique_ptr<CopyStatement> PostgresParser::CopyTransform(ParseResult *parse_
           format = ExternalFileFormat::CSV;
         } else if (strcmp(format_cstr, "binary") == 0) {
           format = ExternalFileFormat::BINARY;
+        } else if (strcmp(format_cstr, "text") == 0) {
+          format = ExternalFileFormat::TEXT;
         }
       }
 
@@ -1130,6 +1133,8 @@ std::unique_ptr<CopyStatement> PostgresParser::CopyTransform(ParseResult *parse_
     }
   }
 
+  if (delimiter == '\0') delimiter = format == ExternalFileFormat::TEXT ? '\t' : ',';
+
   auto result = std::make_unique<CopyStatement>(std::move(table), std::move(select_stmt), file_path, format, is_from,
                                                 delimiter, quote, escape);
   return result;
@@ -27,6 +27,7 @@
 #include "planner/plannodes/index_scan_plan_node.h"
 #include "planner/plannodes/insert_plan_node.h"
 #include "planner/plannodes/limit_plan_node.h"
+#include "planner/plannodes/merge_join_plan_node.h"
 #include "planner/plannodes/nested_loop_join_plan_node.h"
 #include "planner/plannodes/order_by_plan_node.h"
 #include "planner/plannodes/plan_visitor.h"
@@ -35,6 +36,7 @@
 #include "planner/plannodes/seq_scan_plan_node.h"
 #include "planner/plannodes/set_op_plan_node.h"
 #include "planner/plannodes/update_plan_node.h"
+#include "planner/plannodes/window_plan_node.h"
 
 namespace terrier::planner {
 
@@ -186,6 +188,11 @@ JSONDeserializeNodeIntermediate DeserializePlanNode(const nlohmann::json &json)
       break;
     }
 
+    case PlanNodeType::MERGEJOIN: {
+      plan_node = std::make_unique<MergeJoinPlanNode>();
+      break;
+    }
+
     case PlanNodeType::NESTLOOP: {
       plan_node = std::make_unique<NestedLoopJoinPlanNode>();
       break;
@@ -221,6 +228,11 @@ JSONDeserializeNodeIntermediate DeserializePlanNode(const nlohmann::json &json)
       break;
     }
 
+    case PlanNodeType::WINDOW: {
+      plan_node = std::make_unique<WindowPlanNode>();
+      break;
+    }
+
     default:
       throw std::runtime_error("Unknown plan node type during deserialization");
   }
@@ -0,0 +1,158 @@
+#include "planner/plannodes/window_plan_node.h"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "common/json.h"
+
+namespace terrier::planner {
+
+common::hash_t WindowTerm::Hash() const {
+  common::hash_t hash = common::HashUtil::Hash(type_);
+  if (argument_ != nullptr) {
+    hash = common::HashUtil::CombineHashes(hash, argument_->Hash());
+  }
+  hash = common::HashUtil::CombineHashes(hash, common::HashUtil::Hash(offset_));
+  hash = common::HashUtil::CombineHashes(hash, common::HashUtil::Hash(frame_type_));
+  hash = common::HashUtil::CombineHashes(hash, common::HashUtil::Hash(frame_start_));
+  hash = common::HashUtil::CombineHashes(hash, common::HashUtil::Hash(frame_start_offset_));
+  hash = common::HashUtil::CombineHashes(hash, common::HashUtil::Hash(frame_end_));
+  hash = common::HashUtil::CombineHashes(hash, common::HashUtil::Hash(frame_end_offset_));
+  return hash;
+}
+
+bool WindowTerm::operator==(const WindowTerm &rhs) const {
+  if (type_ != rhs.type_) return false;
+  if ((argument_ == nullptr) != (rhs.argument_ == nullptr)) return false;
+  if (argument_ != nullptr && *argument_ != *rhs.argument_) return false;
+  if (offset_ != rhs.offset_) return false;
+  if (frame_type_ != rhs.frame_type_) return false;
+  if (frame_start_ != rhs.frame_start_) return false;
+  if (frame_start_offset_ != rhs.frame_start_offset_) return false;
+  if (frame_end_ != rhs.frame_end_) return false;
+  return frame_end_offset_ == rhs.frame_end_offset_;
+}
+
+common::hash_t WindowPlanNode::Hash() const {
+  common::hash_t hash = AbstractPlanNode::Hash();
+
+  // Partition by terms
+  for (const auto &term : partition_by_terms_) {
+    hash = common::HashUtil::CombineHashes(hash, term->Hash());
+  }
+
+  // Sort keys
+  for (const auto &sort_key : sort_keys_) {
+    hash = common::HashUtil::CombineHashes(hash, sort_key.first->Hash());
+    hash = common::HashUtil::CombineHashes(hash, common::HashUtil::Hash(sort_key.second));
+  }
+
+  // Window terms
+  for (const auto &term : window_terms_) {
+    hash = common::HashUtil::CombineHashes(hash, term.Hash());
+  }
+
+  return hash;
+}
+
+bool WindowPlanNode::operator==(const AbstractPlanNode &rhs) const {
+  if (!AbstractPlanNode::operator==(rhs)) return false;
+
+  const auto &other = static_cast<const WindowPlanNode &>(rhs);
+
+  // Partition by terms
+  if (partition_by_terms_.size() != other.partition_by_terms_.size()) return false;
+  for (size_t i = 0; i < partition_by_terms_.size(); i++) {
+    if (*partition_by_terms_[i] != *other.partition_by_terms_[i]) return false;
+  }
+
+  // Sort keys
+  if (sort_keys_.size() != other.sort_keys_.size()) return false;
+  for (size_t i = 0; i < sort_keys_.size(); i++) {
+    if (sort_keys_[i].second != other.sort_keys_[i].second) return false;
+    if (*sort_keys_[i].first != *other.sort_keys_[i].first) return false;
+  }
+
+  // Window terms
+  return window_terms_ == other.window_terms_;
+}
+
+nlohmann::json WindowPlanNode::ToJson() const {
+  nlohmann::json j = AbstractPlanNode::ToJson();
+
+  j["partition_by_terms"] = partition_by_terms_;
+
+  std::vector<std::pair<nlohmann::json, optimizer::OrderByOrderingType>> sort_keys;
+  sort_keys.reserve(sort_keys_.size());
+  for (const auto &key : sort_keys_) {
+    sort_keys.emplace_back(key.first->ToJson(), key.second);
+  }
+  j["sort_keys"] = sort_keys;
+
+  std::vector<nlohmann::json> window_terms;
+  window_terms.reserve(window_terms_.size());
+  for (const auto &term : window_terms_) {
+    nlohmann::json term_json;
+    term_json["type"] = term.type_;
+    term_json["argument"] = term.argument_ == nullptr ? nlohmann::json(nullptr) : term.argument_->ToJson();
+    term_json["offset"] = term.offset_;
+    term_json["frame_type"] = term.frame_type_;
+    term_json["frame_start"] = term.frame_start_;
+    term_json["frame_start_offset"] = term.frame_start_offset_;
+    term_json["frame_end"] = term.frame_end_;
+    term_json["frame_end_offset"] = term.frame_end_offset_;
+    window_terms.emplace_back(std::move(term_json));
+  }
+  j["window_terms"] = window_terms;
+  return j;
+}
+
+std::vector<std::unique_ptr<parser::AbstractExpression>> WindowPlanNode::FromJson(const nlohmann::json &j) {
+  std::vector<std::unique_ptr<parser::AbstractExpression>> exprs;
+  auto e1 = AbstractPlanNode::FromJson(j);
+  exprs.insert(exprs.end(), std::make_move_iterator(e1.begin()), std::make_move_iterator(e1.end()));
+
+  // Takes ownership of the deserialized expression and returns a pointer to it
+  const auto deserialize = [&exprs](const nlohmann::json &expr_json) {
+    auto deserialized = parser::DeserializeExpression(expr_json);
+    auto expr = common::ManagedPointer(deserialized.result_);
+    exprs.emplace_back(std::move(deserialized.result_));
+    exprs.insert(exprs.end(), std::make_move_iterator(deserialized.non_owned_exprs_.begin()),
+                 std::make_move_iterator(deserialized.non_owned_exprs_.end()));
+    return expr;
+  };
+
+  // Deserialize partition by terms
+  for (const auto &term_json : j.at("partition_by_terms").get<std::vector<nlohmann::json>>()) {
+    partition_by_terms_.push_back(deserialize(term_json));
+  }
+
+  // Deserialize sort keys
+  auto sort_keys = j.at("sort_keys").get<std::vector<std::pair<nlohmann::json, optimizer::OrderByOrderingType>>>();
+  for (const auto &key_json : sort_keys) {
+    sort_keys_.emplace_back(deserialize(key_json.first), key_json.second);
+  }
+
+  // Deserialize window terms
+  for (const auto &term_json : j.at("window_terms").get<std::vector<nlohmann::json>>()) {
+    WindowTerm term;
+    term.type_ = term_json.at("type").get<WindowFunctionType>();
+    if (!term_json.at("argument").is_null()) {
+      term.argument_ = deserialize(term_json.at("argument"));
+    }
+    term.offset_ = term_json.at("offset").get<int64_t>();
+    term.frame_type_ = term_json.at("frame_type").get<WindowFrameType>();
+    term.frame_start_ = term_json.at("frame_start").get<WindowFrameBoundType>();
+    term.frame_start_offset_ = term_json.at("frame_start_offset").get<int64_t>();
+    term.frame_end_ = term_json.at("frame_end").get<WindowFrameBoundType>();
+    term.frame_end_offset_ = term_json.at("frame_end_offset").get<int64_t>();
+    window_terms_.push_back(term);
+  }
+
+  return exprs;
+}
+
+DEFINE_JSON_BODY_DECLARATIONS(WindowPlanNode);
+
+}  // namespace terrier::planner
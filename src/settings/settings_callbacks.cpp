@@ -137,4 +137,30 @@ void Callbacks::MetricsExecuteCommand(void *const old_value, void *const new_val
   action_context->SetState(common::ActionState::SUCCESS);
 }
 
+void Callbacks::MetricsOptimizer(void *const old_value, void *const new_value, DBMain *const db_main,
+                                 common::ManagedPointer<common::ActionContext> action_context) {
+  action_context->SetState(common::ActionState::IN_PROGRESS);
+  bool new_status = *static_cast<bool *>(new_value);
+  if (new_status)
+    db_main->GetMetricsManager()->EnableMetric(metrics::MetricsComponent::OPTIMIZER, 0);
+  else
+    db_main->GetMetricsManager()->DisableMetric(metrics::MetricsComponent::OPTIMIZER);
+  action_context->SetState(common::ActionState::SUCCESS);
+}
+
+void Callbacks::MetricsQueryTrace(void *const old_value, void *const new_value, DBMain *const db_main,
+                                  common::ManagedPointer<common::ActionContext> action_context) {
+  action_context->SetState(common::ActionState::IN_PROGRESS);
+  bool new_status = *static_cast<bool *>(new_value);
+  if (new_status) {
+    const auto sample_interval =
+        db_main->GetSettingsManager()->GetInt(settings::Param::metrics_query_trace_sample_interval);
+    db_main->GetMetricsManager()->EnableMetric(metrics::MetricsComponent::QUERY_TRACE,
+                                               static_cast<uint32_t>(sample_interval));
+  } else {
+    db_main->GetMetricsManager()->DisableMetric(metrics::MetricsComponent::QUERY_TRACE);
+  }
+  action_context->SetState(common::ActionState::SUCCESS);
+}
+
 }  // namespace terrier::settings
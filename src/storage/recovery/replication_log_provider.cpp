@@ -0,0 +1,47 @@
+#include "storage/recovery/replication_log_provider.h"
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+
+namespace terrier::storage {
+
+void ReplicationLogProvider::HandBufferToReplication(std::unique_ptr<network::ReadBuffer> buffer) {
+  {
+    std::unique_lock<std::mutex> lock(latch_);
+    buffers_.push(std::move(buffer));
+  }
+  buffers_cv_.notify_one();
+}
+
+void ReplicationLogProvider::EndReplication() {
+  {
+    std::unique_lock<std::mutex> lock(latch_);
+    replication_ended_ = true;
+  }
+  buffers_cv_.notify_one();
+}
+
+bool ReplicationLogProvider::WaitForBytes() {
+  while (curr_buffer_ == nullptr || !curr_buffer_->HasMore()) {
+    std::unique_lock<std::mutex> lock(latch_);
+    buffers_cv_.wait(lock, [&] { return !buffers_.empty() || replication_ended_; });
+    if (buffers_.empty()) return false;
+    curr_buffer_ = std::move(buffers_.front());
+    buffers_.pop();
+  }
+  return true;
+}
+
+bool ReplicationLogProvider::Read(void *const dest, const uint32_t size) {
+  uint32_t bytes_read = 0;
+  while (bytes_read < size) {
+    if (!WaitForBytes()) return false;
+    const auto read_size = static_cast<uint32_t>(std::min<size_t>(size - bytes_read, curr_buffer_->BytesAvailable()));
+    curr_buffer_->ReadIntoView(read_size).Read(read_size, reinterpret_cast<byte *>(dest) + bytes_read);
+    bytes_read += read_size;
+  }
+  return true;
+}
+
+}  // namespace terrier::storage
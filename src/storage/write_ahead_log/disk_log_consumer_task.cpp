@@ -4,6 +4,8 @@
 #include "common/scoped_timer.h"
 #include "common/thread_context.h"
 #include "metrics/metrics_store.h"
+#include "metrics/query_trace.h"
+#include "storage/write_ahead_log/replication_log_consumer_task.h"
 
 namespace terrier::storage {
 
@@ -29,6 +31,11 @@ void DiskLogConsumerTask::WriteBuffersToLogFile() {
     filled_buffer_queue_->Dequeue(&logs);
     if (logs.first != nullptr) {
       // Need the nullptr check because read-only txns don't serialize any buffers, but generate callbacks to be invoked
+      if (replication_task_ != nullptr && logs.first->GetBufferSize() > 0) {
+        // The buffer is reused once it is flushed, so the replication task ships a copy
+        last_replication_message_id_ =
+            replication_task_->HandBuffer(logs.first->GetBuffer(), logs.first->GetBufferSize());
+      }
       current_data_written_ += logs.first->FlushBuffer();
     }
     commit_callbacks_.insert(commit_callbacks_.end(), logs.second.begin(), logs.second.end());
@@ -47,6 +54,7 @@ uint64_t DiskLogConsumerTask::PersistLogFile() {
     // any buffer.
     buffers_->front().Persist();
   }
+  if (replication_task_ != nullptr) replication_task_->WaitForAcknowledgement(last_replication_message_id_);
   const auto num_buffers = commit_callbacks_.size();
   // Execute the callbacks for the transactions that have been persisted
   for (auto &callback : commit_callbacks_) callback.first(callback.second);
@@ -107,7 +115,11 @@ void DiskLogConsumerTask::DiskLogConsumerTaskLoop() {
 
     if (timeout || current_data_written_ > persist_threshold_ || do_persist_ || !run_task_) {
       std::unique_lock<std::mutex> lock(persist_lock_);
+      const uint64_t persist_start_us = metrics::QueryTrace::Enabled() ? metrics::MetricsUtil::Now() : 0;
       num_buffers = PersistLogFile();
+      if (persist_start_us != 0 && num_buffers > 0 && metrics::QueryTrace::Sample()) {
+        metrics::QueryTrace::Record(metrics::TraceSpan::WAL_FSYNC, 0, 0, persist_start_us);
+      }
       num_bytes = current_data_written_;
       // Reset meta data
       last_persist = std::chrono::high_resolution_clock::now();
@@ -3,6 +3,7 @@
 #include "common/dedicated_thread_registry.h"
 #include "storage/write_ahead_log/disk_log_consumer_task.h"
 #include "storage/write_ahead_log/log_serializer_task.h"
+#include "storage/write_ahead_log/replication_log_consumer_task.h"
 #include "transaction/transaction_context.h"
 
 namespace terrier::storage {
@@ -19,10 +20,16 @@ void LogManager::Start() {
 
   run_log_manager_ = true;
 
+  // Register ReplicationLogConsumerTask
+  if (!replica_address_.empty()) {
+    replication_task_ = thread_registry_->RegisterDedicatedThread<ReplicationLogConsumerTask>(
+        this /* requester */, replica_address_, replica_port_, synchronous_replication_, replication_timeout_);
+  }
+
   // Register DiskLogConsumerTask
   disk_log_writer_task_ = thread_registry_->RegisterDedicatedThread<DiskLogConsumerTask>(
       this /* requester */, persist_interval_, persist_threshold_, &buffers_, &empty_buffer_queue_,
-      &filled_buffer_queue_);
+      &filled_buffer_queue_, replication_task_);
 
   // Register LogSerializerTask
   log_serializer_task_ = thread_registry_->RegisterDedicatedThread<LogSerializerTask>(
@@ -57,6 +64,13 @@ void LogManager::PersistAndStop() {
   TERRIER_ASSERT(result, "DiskLogConsumerTask should have been stopped");
   TERRIER_ASSERT(filled_buffer_queue_.Empty(), "disk log consumer task should have processed all filled buffers\n");
 
+  // The replication task ships the logs the disk log consumer task handed it before it stops
+  if (replication_task_ != nullptr) {
+    result = thread_registry_->StopTask(this, replication_task_.CastManagedPointerTo<common::DedicatedThreadTask>());
+    TERRIER_ASSERT(result, "ReplicationLogConsumerTask should have been stopped");
+    replication_task_ = common::ManagedPointer<ReplicationLogConsumerTask>(nullptr);
+  }
+
   // Close the buffers corresponding to the log file
   for (auto buf : buffers_) {
     buf.Close();
@@ -6,6 +6,7 @@
 #include "common/scoped_timer.h"
 #include "common/thread_context.h"
 #include "metrics/metrics_store.h"
+#include "metrics/query_trace.h"
 #include "transaction/transaction_context.h"
 #include "transaction/transaction_manager.h"
 
@@ -44,7 +45,12 @@ void LogSerializerTask::LogSerializerTaskLoop() {
     // If Process did not find any new buffers, we perform exponential back-off to reduce our rate of polling for new
     // buffers. We cap the maximum back-off, since in the case of large gaps of no txns, we don't want to unboundedly
     // sleep
+    const uint64_t serialize_start_us = metrics::QueryTrace::Enabled() ? metrics::MetricsUtil::Now() : 0;
     std::tie(num_bytes, num_records, num_txns) = Process();
+    if (serialize_start_us != 0 && num_records > 0 && metrics::QueryTrace::Sample()) {
+      // A batch serializes the logs of many txns, so it's not part of the trace of one request
+      metrics::QueryTrace::Record(metrics::TraceSpan::WAL_SERIALIZE, 0, 0, serialize_start_us);
+    }
     curr_sleep = std::min(num_records > 0 ? serialization_interval_ : curr_sleep * 2, max_sleep);
 
     if (logging_metrics_enabled && num_records > 0) {
@@ -0,0 +1,182 @@
+#include "storage/write_ahead_log/replication_log_consumer_task.h"
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "loggers/storage_logger.h"
+#include "network/itp/itp_packet_writer.h"
+
+namespace terrier::storage {
+
+void ReplicationLogConsumerTask::RunTask() {
+  if (!Connect()) {
+    Stop(false);
+    return;
+  }
+
+  std::vector<std::pair<uint64_t, std::vector<char>>> batch;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(latch_);
+      task_cv_.wait(lock, [&] { return !pending_.empty() || !run_task_; });
+      // Only stop once the logs that were handed over before the termination are shipped
+      if (pending_.empty()) break;
+      while (!pending_.empty() && batch.size() < MAX_BATCH_SIZE) {
+        batch.emplace_back(std::move(pending_.front()));
+        pending_.pop_front();
+      }
+    }
+    if (!ShipBatch(batch)) {
+      // Stopping releases the commits that wait for acknowledgements
+      STORAGE_LOG_ERROR("Lost the connection to replica {}:{}, stopped replicating", replica_address_, replica_port_);
+      Stop(false);
+      return;
+    }
+    batch.clear();
+  }
+  Stop(true);
+}
+
+void ReplicationLogConsumerTask::Terminate() {
+  {
+    std::unique_lock<std::mutex> lock(latch_);
+    run_task_ = false;
+  }
+  task_cv_.notify_one();
+}
+
+uint64_t ReplicationLogConsumerTask::HandBuffer(const char *const data, const uint32_t size) {
+  uint64_t message_id;
+  {
+    std::unique_lock<std::mutex> lock(latch_);
+    message_id = next_message_id_++;
+    if (state_ != State::STOPPED) pending_.emplace_back(message_id, std::vector<char>(data, data + size));
+  }
+  task_cv_.notify_one();
+  return message_id;
+}
+
+void ReplicationLogConsumerTask::WaitForAcknowledgement(const uint64_t message_id) {
+  if (!synchronous_commit_) return;
+  std::unique_lock<std::mutex> lock(latch_);
+  // Commits are not held back while there is no replica to wait for
+  ack_cv_.wait(lock, [&] { return last_acknowledged_ >= message_id || state_ != State::STREAMING; });
+}
+
+bool ReplicationLogConsumerTask::Connect() {
+  addrinfo hints{};
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  const std::string port = std::to_string(replica_port_);
+  auto backoff_time = INITIAL_BACKOFF_TIME;
+  while (true) {
+    addrinfo *addresses = nullptr;
+    if (getaddrinfo(replica_address_.c_str(), port.c_str(), &hints, &addresses) == 0) {
+      for (addrinfo *address = addresses; address != nullptr && socket_fd_ < 0; address = address->ai_next) {
+        const int fd = socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+        if (fd < 0) continue;
+        if (connect(fd, address->ai_addr, address->ai_addrlen) == 0) {
+          socket_fd_ = fd;
+        } else {
+          close(fd);
+        }
+      }
+      freeaddrinfo(addresses);
+    }
+
+    std::unique_lock<std::mutex> lock(latch_);
+    if (socket_fd_ >= 0) {
+      // Every batch is written out at once, so don't hold back its last packet
+      int one = 1;
+      setsockopt(socket_fd_, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+      // A replica that hangs without closing the connection fails the reads and writes once they time out, and the
+      // keepalive probes notice a replica whose host went away
+      const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(timeout_);
+      const auto microseconds = std::chrono::duration_cast<std::chrono::microseconds>(timeout_ - seconds);
+      timeval timeout{seconds.count(), microseconds.count()};
+      setsockopt(socket_fd_, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+      setsockopt(socket_fd_, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+      setsockopt(socket_fd_, SOL_SOCKET, SO_KEEPALIVE, &one, sizeof(one));
+      state_ = State::STREAMING;
+      STORAGE_LOG_INFO("Replicating logs to {}:{}", replica_address_, replica_port_);
+      return true;
+    }
+    if (task_cv_.wait_for(lock, backoff_time, [&] { return !run_task_; })) return false;
+    backoff_time = std::min(backoff_time * 2, MAX_BACKOFF_TIME);
+  }
+}
+
+bool ReplicationLogConsumerTask::ShipBatch(const std::vector<std::pair<uint64_t, std::vector<char>>> &batch) {
+  network::WriteQueue queue;
+  network::ITPPacketWriter writer{common::ManagedPointer(&queue)};
+  for (const auto &message : batch) {
+    writer.BeginReplicationCommand(message.first);
+    writer.AppendValue<uint64_t>(message.second.size()).AppendRaw(message.second.data(), message.second.size());
+    writer.EndReplicationCommand();
+  }
+  // The socket blocks, so every write makes progress unless the connection is lost or the replica timed out
+  while (queue.FlushHead() != nullptr) {
+    if (queue.WriteOutTo(socket_fd_) < 0 && errno != EINTR) return false;
+  }
+
+  for (size_t i = 0; i < batch.size(); i++) {
+    uint64_t message_id;
+    if (!ReadAcknowledgement(&message_id)) return false;
+    {
+      std::unique_lock<std::mutex> lock(latch_);
+      last_acknowledged_ = message_id;
+    }
+    ack_cv_.notify_all();
+  }
+  return true;
+}
+
+bool ReplicationLogConsumerTask::ReadAcknowledgement(uint64_t *const message_id) {
+  // Header format: 1 byte message type + 4 byte message size, followed by the id of the message
+  const size_t acknowledgement_size = 1 + sizeof(uint32_t) + sizeof(uint64_t);
+  while (!acknowledgements_.HasMore(acknowledgement_size)) {
+    if (acknowledgements_.HasMore()) {
+      acknowledgements_.MoveContentToHead();
+    } else {
+      acknowledgements_.Reset();
+    }
+    const int bytes_read = acknowledgements_.FillBufferFrom(socket_fd_);
+    if (bytes_read == 0 || (bytes_read < 0 && errno != EINTR)) return false;
+  }
+  const auto type = acknowledgements_.ReadValue<network::NetworkMessageType>();
+  const auto length = acknowledgements_.ReadValue<uint32_t>();
+  *message_id = acknowledgements_.ReadValue<uint64_t>();
+  return type == network::NetworkMessageType::ITP_COMMAND_COMPLETE &&
+         length == sizeof(uint32_t) + sizeof(uint64_t);
+}
+
+void ReplicationLogConsumerTask::Stop(const bool end_replication) {
+  if (socket_fd_ >= 0) {
+    if (end_replication) {
+      network::WriteQueue queue;
+      network::ITPPacketWriter(common::ManagedPointer(&queue)).StopReplicationCommand();
+      while (queue.FlushHead() != nullptr) {
+        if (queue.WriteOutTo(socket_fd_) < 0 && errno != EINTR) break;
+      }
+    }
+    close(socket_fd_);
+    socket_fd_ = -1;
+  }
+  {
+    std::unique_lock<std::mutex> lock(latch_);
+    state_ = State::STOPPED;
+    pending_.clear();
+  }
+  ack_cv_.notify_all();
+}
+
+}  // namespace terrier::storage
@@ -0,0 +1,818 @@
+#include "traffic_cop/bulk_copy.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <type_traits>
+
+#include "catalog/index_schema.h"
+#include "catalog/schema.h"
+#include "common/allocator.h"
+#include "common/error/exception.h"
+#include "execution/sql/runtime_types.h"
+#include "execution/util/value_parser.h"
+#include "network/network_io_wrapper.h"
+#include "network/postgres/postgres_packet_writer.h"
+#include "parser/expression/column_value_expression.h"
+#include "spdlog/fmt/fmt.h"
+#include "storage/index/index.h"
+#include "storage/sql_table.h"
+#include "type/type_util.h"
+#include "util/portable_endian.h"
+
+namespace terrier::trafficcop {
+
+namespace {
+
+// The signature of the binary format. Its last byte is the terminator of the literal.
+constexpr char BINARY_SIGNATURE[] = "PGCOPY\n\377\r\n";
+constexpr std::size_t BINARY_HEADER_SIZE = sizeof(BINARY_SIGNATURE) + 2 * sizeof(int32_t);
+
+std::vector<catalog::col_oid_t> ColumnOids(const catalog::Schema &schema) {
+  std::vector<catalog::col_oid_t> col_oids;
+  col_oids.reserve(schema.GetColumns().size());
+  for (const auto &column : schema.GetColumns()) col_oids.emplace_back(column.Oid());
+  return col_oids;
+}
+
+void CheckSupportedTypes(const catalog::Schema &schema) {
+  for (const auto &column : schema.GetColumns()) {
+    switch (column.Type()) {
+      case type::TypeId::BOOLEAN:
+      case type::TypeId::TINYINT:
+      case type::TypeId::SMALLINT:
+      case type::TypeId::INTEGER:
+      case type::TypeId::BIGINT:
+      case type::TypeId::DECIMAL:
+      case type::TypeId::DATE:
+      case type::TypeId::TIMESTAMP:
+      case type::TypeId::VARCHAR:
+      case type::TypeId::VARBINARY:
+        break;
+      default:
+        throw EXECUTION_EXCEPTION(fmt::format("COPY does not support column \"{}\" of type {}", column.Name(),
+                                              type::TypeUtil::TypeIdToString(column.Type())),
+                                  common::ErrorCode::ERRCODE_FEATURE_NOT_SUPPORTED);
+    }
+  }
+}
+
+// Postgres counts dates and timestamps from 2000-01-01 in its binary format
+int32_t PostgresEpochDate() {
+  static const auto epoch = execution::sql::Date::FromYMD(2000, 1, 1).ToNative();
+  return epoch;
+}
+
+uint64_t PostgresEpochTimestamp() {
+  static const auto epoch = execution::sql::Timestamp::FromYMDHMS(2000, 1, 1, 0, 0, 0).ToNative();
+  return epoch;
+}
+
+// Read a big-endian integer
+template <typename T>
+T ReadInt(const char *const ptr) {
+  std::make_unsigned_t<T> bits;
+  std::memcpy(&bits, ptr, sizeof(bits));
+  if constexpr (sizeof(T) == 2) bits = be16toh(bits);
+  if constexpr (sizeof(T) == 4) bits = be32toh(bits);
+  if constexpr (sizeof(T) == 8) bits = be64toh(bits);
+  return static_cast<T>(bits);
+}
+
+// Append a big-endian integer
+template <typename T>
+void AppendInt(const T value, std::string *const buffer) {
+  auto bits = static_cast<std::make_unsigned_t<T>>(value);
+  if constexpr (sizeof(T) == 2) bits = htobe16(bits);
+  if constexpr (sizeof(T) == 4) bits = htobe32(bits);
+  if constexpr (sizeof(T) == 8) bits = htobe64(bits);
+  buffer->append(reinterpret_cast<const char *>(&bits), sizeof(bits));
+}
+
+int HexDigit(const char c) {
+  return std::isdigit(static_cast<unsigned char>(c)) != 0 ? c - '0' : std::tolower(c) - 'a' + 10;
+}
+
+}  // namespace
+
+CopyIn::CopyIn(const common::ManagedPointer<transaction::TransactionContext> txn, const catalog::db_oid_t db_oid,
+               const catalog::table_oid_t table_oid, const common::ManagedPointer<storage::SqlTable> table,
+               const catalog::Schema &schema,
+               const std::vector<std::pair<common::ManagedPointer<storage::index::Index>, const catalog::IndexSchema &>>
+                   &indexes,
+               const CopyFormat format)
+    : txn_(txn),
+      db_oid_(db_oid),
+      table_oid_(table_oid),
+      table_(table),
+      format_(format),
+      row_initializer_(table->InitializerForProjectedRow(ColumnOids(schema))) {
+  CheckSupportedTypes(schema);
+  const auto col_oids = ColumnOids(schema);
+  const auto projection_map = table_->ProjectionMapForOids(col_oids);
+  for (const auto &column : schema.GetColumns()) {
+    col_types_.emplace_back(column.Type());
+    col_names_.emplace_back(column.Name());
+    col_nullable_.emplace_back(column.Nullable());
+    col_offsets_.emplace_back(projection_map.at(column.Oid()));
+  }
+
+  const auto batch_initializer =
+      table_->InitializerForProjectedColumns(col_oids, common::Constants::K_DEFAULT_VECTOR_SIZE);
+  batch_buffer_.reset(common::AllocationUtil::AllocateAligned(batch_initializer.ProjectedColumnsSize()));
+  batch_ = batch_initializer.Initialize(batch_buffer_.get());
+
+  for (const auto &[index, index_schema] : indexes) {
+    IndexInfo info;
+    info.index_ = index;
+    info.unique_ = index_schema.Unique();
+    const auto &key_initializer = index->GetProjectedRowInitializer();
+    info.key_buffer_.reset(common::AllocationUtil::AllocateAligned(key_initializer.ProjectedRowSize()));
+    info.key_ = key_initializer.InitializeRow(info.key_buffer_.get());
+    const auto &key_offsets = index->GetKeyOidToOffsetMap();
+    for (const auto &key_column : index_schema.GetColumns()) {
+      const auto expr = key_column.StoredExpression();
+      if (expr->GetExpressionType() != parser::ExpressionType::COLUMN_VALUE) {
+        throw EXECUTION_EXCEPTION("COPY FROM does not support indexes on expressions",
+                                  common::ErrorCode::ERRCODE_FEATURE_NOT_SUPPORTED);
+      }
+      const auto col_oid = expr.CastManagedPointerTo<const parser::ColumnValueExpression>()->GetColumnOid();
+      info.key_columns_.push_back({key_offsets.at(key_column.Oid()), projection_map.at(col_oid)});
+    }
+    indexes_.emplace_back(std::move(info));
+  }
+}
+
+CopyIn::~CopyIn() {
+  for (uint32_t row = 0; row < row_; row++) FreeStrings(row, NumColumns());
+  FreeStrings(row_, num_fields_);
+}
+
+void CopyIn::Consume(std::string_view data) {
+  const bool binary = format_.format_ == parser::ExternalFileFormat::BINARY;
+
+  // Complete the row left over from the last message with as few bytes as possible, the rest is parsed in place
+  while (!pending_.empty() && !data.empty() && !end_of_data_) {
+    std::size_t num_bytes = data.size();
+    if (binary) {
+      num_bytes = std::min(num_bytes, std::max(num_needed_, pending_.size() + 1) - pending_.size());
+    } else if (const auto *new_line = std::memchr(data.data(), '\n', data.size()); new_line != nullptr) {
+      num_bytes = static_cast<const char *>(new_line) - data.data() + 1;
+    }
+    pending_.append(data.data(), num_bytes);
+    data.remove_prefix(num_bytes);
+    pending_.erase(0, binary ? ParseTuples(pending_.data(), pending_.size())
+                             : ParseRows(pending_.data(), pending_.size(), false));
+  }
+
+  if (pending_.empty() && !end_of_data_) {
+    const auto consumed =
+        binary ? ParseTuples(data.data(), data.size()) : ParseRows(data.data(), data.size(), false);
+    pending_.assign(data.data() + consumed, data.size() - consumed);
+  }
+}
+
+uint64_t CopyIn::Finish() {
+  if (!pending_.empty() && !end_of_data_) {
+    if (format_.format_ == parser::ExternalFileFormat::BINARY) ThrowBadFormat("unexpected end of file");
+    pending_.erase(0, ParseRows(pending_.data(), pending_.size(), true));
+  }
+  if (row_ > 0) InsertBatch();
+  return num_rows_;
+}
+
+std::size_t CopyIn::ParseRows(const char *const data, const std::size_t size, const bool end_of_stream) {
+  const bool text = format_.format_ == parser::ExternalFileFormat::TEXT;
+  const char *ptr = data;
+  const char *const end = data + size;
+  while (ptr < end && !end_of_data_) {
+    const char *row_end = FindRowEnd(ptr, end);
+    if (row_end == nullptr) {
+      if (!end_of_stream) break;
+      row_end = end;
+    }
+    // Strip the carriage return of a "\r\n" line ending
+    const char *const fields_end = row_end > ptr && row_end[-1] == '\r' ? row_end - 1 : row_end;
+
+    if (fields_end - ptr == 2 && ptr[0] == '\\' && ptr[1] == '.') {
+      // The end-of-data marker, everything after it is ignored
+      end_of_data_ = true;
+    } else {
+      Field field;
+      const char *field_ptr = ptr;
+      for (uint16_t col_idx = 0;; col_idx++) {
+        if (col_idx == NumColumns()) ThrowBadFormat("extra data after last expected column");
+        field_ptr = text ? ParseTextField(field_ptr, fields_end, &field) : ParseCSVField(field_ptr, fields_end, &field);
+        WriteField(field, col_idx);
+        if (field_ptr == fields_end) {
+          if (col_idx + 1 != NumColumns()) {
+            ThrowBadFormat(fmt::format("missing data for column \"{}\"", col_names_[col_idx + 1]));
+          }
+          break;
+        }
+        // Skip the delimiter
+        field_ptr++;
+      }
+      FinishRow();
+    }
+    ptr = row_end == end ? end : row_end + 1;
+  }
+  return ptr - data;
+}
+
+std::size_t CopyIn::ParseTuples(const char *const data, const std::size_t size) {
+  const char *ptr = data;
+  const char *const end = data + size;
+  if (!binary_header_read_) {
+    if (size < BINARY_HEADER_SIZE) {
+      num_needed_ = BINARY_HEADER_SIZE;
+      return 0;
+    }
+    if (std::memcmp(ptr, BINARY_SIGNATURE, sizeof(BINARY_SIGNATURE)) != 0) {
+      ThrowBadFormat("COPY file signature not recognized");
+    }
+    const auto extension_size = ReadInt<int32_t>(ptr + BINARY_HEADER_SIZE - sizeof(int32_t));
+    if (extension_size < 0) ThrowBadFormat("invalid COPY file header");
+    if (size < BINARY_HEADER_SIZE + extension_size) {
+      num_needed_ = BINARY_HEADER_SIZE + extension_size;
+      return 0;
+    }
+    ptr += BINARY_HEADER_SIZE + extension_size;
+    binary_header_read_ = true;
+  }
+
+  while (!end_of_data_) {
+    // Check that the whole tuple is there before writing any of its fields
+    const auto available = static_cast<std::size_t>(end - ptr);
+    std::size_t needed = sizeof(int16_t);
+    if (available < needed) {
+      num_needed_ = needed;
+      break;
+    }
+    const auto num_fields = ReadInt<int16_t>(ptr);
+    if (num_fields == -1) {
+      // The trailer, everything after it is ignored
+      end_of_data_ = true;
+      ptr += needed;
+      break;
+    }
+    if (num_fields != NumColumns()) {
+      ThrowBadFormat(fmt::format("row field count is {}, expected {}", num_fields, NumColumns()));
+    }
+    for (uint16_t col_idx = 0; col_idx < num_fields && needed <= available; col_idx++) {
+      needed += sizeof(int32_t);
+      if (needed > available) break;
+      const auto len = ReadInt<int32_t>(ptr + needed - sizeof(int32_t));
+      if (len < -1) ThrowBadFormat("invalid field size");
+      if (len > 0) needed += len;
+    }
+    if (needed > available) {
+      num_needed_ = needed;
+      break;
+    }
+
+    ptr += sizeof(int16_t);
+    for (uint16_t col_idx = 0; col_idx < num_fields; col_idx++) {
+      const auto len = ReadInt<int32_t>(ptr);
+      ptr += sizeof(int32_t);
+      WriteBinaryField(ptr, len, col_idx);
+      if (len > 0) ptr += len;
+    }
+    FinishRow();
+  }
+  return ptr - data;
+}
+
+const char *CopyIn::FindRowEnd(const char *ptr, const char *const end) const {
+  if (format_.format_ == parser::ExternalFileFormat::TEXT) {
+    // A backslash escapes the next character, even a new line
+    while (true) {
+      ptr = execution::util::ValueParser::FindAny(ptr, end, '\n', '\\', '\n');
+      if (ptr == end) return nullptr;
+      if (*ptr == '\n') return ptr;
+      if (end - ptr < 2) return nullptr;
+      ptr += 2;
+    }
+  }
+
+  // New lines inside quoted fields are part of the field
+  const char quote = format_.quote_;
+  const char escape = format_.escape_;
+  bool quoted = false;
+  while (true) {
+    ptr = execution::util::ValueParser::FindAny(ptr, end, '\n', quote, escape);
+    if (ptr == end) return nullptr;
+    if (*ptr == '\n' && !quoted) return ptr;
+    if (quoted && *ptr == escape && escape != quote) {
+      if (end - ptr < 2) return nullptr;
+      ptr += 2;
+      continue;
+    }
+    // A doubled quote leaves and enters the quoted field again
+    if (*ptr == quote) quoted = !quoted;
+    ptr++;
+  }
+}
+
+const char *CopyIn::ParseTextField(const char *ptr, const char *const end, Field *const field) {
+  const char delimiter = format_.delimiter_;
+  const char *const start = ptr;
+  ptr = execution::util::ValueParser::FindAny(ptr, end, delimiter, '\\', delimiter);
+  if (ptr == end || *ptr == delimiter) {
+    *field = {start, static_cast<std::size_t>(ptr - start), false};
+    return ptr;
+  }
+  // \N is NULL, but only as the whole field
+  if (ptr == start && end - ptr >= 2 && ptr[1] == 'N' && (ptr + 2 == end || ptr[2] == delimiter)) {
+    *field = {start, 0, true};
+    return ptr + 2;
+  }
+
+  // The field has escapes, so it is unescaped into scratch_
+  scratch_.assign(start, ptr);
+  while (ptr < end && *ptr == '\\') {
+    if (++ptr == end) break;
+    const char c = *ptr++;
+    switch (c) {
+      case 'b':
+        scratch_ += '\b';
+        break;
+      case 'f':
+        scratch_ += '\f';
+        break;
+      case 'n':
+        scratch_ += '\n';
+        break;
+      case 'r':
+        scratch_ += '\r';
+        break;
+      case 't':
+        scratch_ += '\t';
+        break;
+      case 'v':
+        scratch_ += '\v';
+        break;
+      case 'x':
+        if (ptr < end && std::isxdigit(static_cast<unsigned char>(*ptr)) != 0) {
+          int value = HexDigit(*ptr++);
+          if (ptr < end && std::isxdigit(static_cast<unsigned char>(*ptr)) != 0) value = value * 16 + HexDigit(*ptr++);
+          scratch_ += static_cast<char>(value);
+        } else {
+          scratch_ += c;
+        }
+        break;
+      default:
+        if (c >= '0' && c <= '7') {
+          int value = c - '0';
+          for (int i = 0; i < 2 && ptr < end && *ptr >= '0' && *ptr <= '7'; i++) value = value * 8 + (*ptr++ - '0');
+          scratch_ += static_cast<char>(value);
+        } else {
+          scratch_ += c;
+        }
+    }
+    const char *const next = execution::util::ValueParser::FindAny(ptr, end, delimiter, '\\', delimiter);
+    scratch_.append(ptr, next);
+    ptr = next;
+  }
+  *field = {scratch_.data(), scratch_.size(), false};
+  return ptr;
+}
+
+const char *CopyIn::ParseCSVField(const char *ptr, const char *const end, Field *const field) {
+  const char delimiter = format_.delimiter_;
+  const char quote = format_.quote_;
+  const char escape = format_.escape_;
+  if (ptr == end || *ptr != quote) {
+    // An unquoted empty field is NULL
+    const char *const start = ptr;
+    ptr = execution::util::ValueParser::FindAny(ptr, end, delimiter, delimiter, delimiter);
+    *field = {start, static_cast<std::size_t>(ptr - start), ptr == start};
+    return ptr;
+  }
+
+  scratch_.clear();
+  ptr++;
+  while (true) {
+    const char *const next = execution::util::ValueParser::FindAny(ptr, end, quote, escape, quote);
+    scratch_.append(ptr, next);
+    if (next == end) ThrowBadFormat("unterminated CSV quoted field");
+    ptr = next;
+    if (*ptr == escape && end - ptr >= 2 && (ptr[1] == quote || ptr[1] == escape)) {
+      scratch_ += ptr[1];
+      ptr += 2;
+    } else if (*ptr == quote) {
+      ptr++;
+      break;
+    } else {
+      // An escape character that escapes nothing is an ordinary character
+      scratch_ += *ptr++;
+    }
+  }
+  if (ptr < end && *ptr != delimiter) ThrowBadFormat("unexpected character after quoted CSV field");
+  *field = {scratch_.data(), scratch_.size(), false};
+  return ptr;
+}
+
+byte *CopyIn::PrepareField(const uint16_t col_idx, const bool null) {
+  const auto offset = col_offsets_[col_idx];
+  if (null && !col_nullable_[col_idx]) {
+    throw EXECUTION_EXCEPTION(
+        fmt::format("null value in column \"{}\" violates not-null constraint", col_names_[col_idx]),
+        common::ErrorCode::ERRCODE_NOT_NULL_VIOLATION);
+  }
+  batch_->ColumnNullBitmap(offset)->Set(row_, !null);
+  return null ? nullptr : batch_->ColumnStart(offset) + batch_->AttrSizeForColumn(offset) * row_;
+}
+
+void CopyIn::WriteField(const Field &field, const uint16_t col_idx) {
+  byte *const value = PrepareField(col_idx, field.null_);
+  if (value != nullptr) execution::util::ValueParser::ParseText(field.ptr_, field.len_, col_types_[col_idx], value);
+  num_fields_++;
+}
+
+void CopyIn::WriteBinaryField(const char *const ptr, const int32_t len, const uint16_t col_idx) {
+  byte *const value = PrepareField(col_idx, len == -1);
+  if (value == nullptr) {
+    num_fields_++;
+    return;
+  }
+
+  const auto type = col_types_[col_idx];
+  const auto check_len = [&](const bool valid) {
+    if (!valid) {
+      throw EXECUTION_EXCEPTION(fmt::format("incorrect binary data format in column \"{}\"", col_names_[col_idx]),
+                                common::ErrorCode::ERRCODE_INVALID_BINARY_REPRESENTATION);
+    }
+  };
+  // Postgres has no one byte integer, so integers of any size are accepted if their value fits the column
+  const auto read_integer = [&](const int64_t min, const int64_t max) {
+    int64_t integer = 0;
+    switch (len) {
+      case 1:
+        integer = static_cast<int8_t>(*ptr);
+        break;
+      case 2:
+        integer = ReadInt<int16_t>(ptr);
+        break;
+      case 4:
+        integer = ReadInt<int32_t>(ptr);
+        break;
+      case 8:
+        integer = ReadInt<int64_t>(ptr);
+        break;
+      default:
+        check_len(false);
+    }
+    if (integer < min || integer > max) {
+      throw EXECUTION_EXCEPTION(fmt::format("value out of range for column \"{}\"", col_names_[col_idx]),
+                                common::ErrorCode::ERRCODE_NUMERIC_VALUE_OUT_OF_RANGE);
+    }
+    return integer;
+  };
+
+  switch (type) {
+    case type::TypeId::BOOLEAN:
+      check_len(len == 1);
+      *reinterpret_cast<bool *>(value) = *ptr != 0;
+      break;
+    case type::TypeId::TINYINT:
+      *reinterpret_cast<int8_t *>(value) = static_cast<int8_t>(read_integer(INT8_MIN, INT8_MAX));
+      break;
+    case type::TypeId::SMALLINT:
+      *reinterpret_cast<int16_t *>(value) = static_cast<int16_t>(read_integer(INT16_MIN, INT16_MAX));
+      break;
+    case type::TypeId::INTEGER:
+      *reinterpret_cast<int32_t *>(value) = static_cast<int32_t>(read_integer(INT32_MIN, INT32_MAX));
+      break;
+    case type::TypeId::BIGINT:
+      *reinterpret_cast<int64_t *>(value) = read_integer(INT64_MIN, INT64_MAX);
+      break;
+    case type::TypeId::DECIMAL: {
+      // float8, or float4
+      check_len(len == 8 || len == 4);
+      double decimal;
+      if (len == 8) {
+        const auto bits = ReadInt<uint64_t>(ptr);
+        std::memcpy(&decimal, &bits, sizeof(decimal));
+      } else {
+        const auto bits = ReadInt<uint32_t>(ptr);
+        float real;
+        std::memcpy(&real, &bits, sizeof(real));
+        decimal = real;
+      }
+      *reinterpret_cast<double *>(value) = decimal;
+      break;
+    }
+    case type::TypeId::DATE: {
+      check_len(len == 4);
+      const auto date = static_cast<int32_t>(ReadInt<int32_t>(ptr) + PostgresEpochDate());
+      std::memcpy(value, &date, sizeof(date));
+      break;
+    }
+    case type::TypeId::TIMESTAMP: {
+      check_len(len == 8);
+      const auto timestamp = static_cast<uint64_t>(ReadInt<int64_t>(ptr)) + PostgresEpochTimestamp();
+      std::memcpy(value, &timestamp, sizeof(timestamp));
+      break;
+    }
+    default:
+      // Strings are the same in text and binary
+      execution::util::ValueParser::ParseText(ptr, len, type, value);
+  }
+  num_fields_++;
+}
+
+void CopyIn::FinishRow() {
+  num_fields_ = 0;
+  num_rows_++;
+  if (++row_ == batch_->MaxTuples()) InsertBatch();
+}
+
+void CopyIn::InsertBatch() {
+  batch_->SetNumTuples(row_);
+  table_->InsertBatch(txn_, db_oid_, table_oid_, row_initializer_, batch_);
+  // The table owns the strings of the rows now
+  row_ = 0;
+
+  for (auto &index : indexes_) {
+    for (uint32_t row = 0; row < batch_->NumTuples(); row++) {
+      for (const auto &key_column : index.key_columns_) {
+        if (!batch_->ColumnNullBitmap(key_column.batch_offset_)->Test(row)) {
+          index.key_->SetNull(key_column.key_offset_);
+          continue;
+        }
+        const auto attr_size = batch_->AttrSizeForColumn(key_column.batch_offset_);
+        std::memcpy(index.key_->AccessForceNotNull(key_column.key_offset_),
+                    batch_->ColumnStart(key_column.batch_offset_) + attr_size * row, attr_size);
+      }
+      const auto slot = batch_->TupleSlots()[row];
+      const bool inserted = index.unique_ ? index.index_->InsertUnique(txn_, *index.key_, slot)
+                                          : index.index_->Insert(txn_, *index.key_, slot);
+      if (!inserted) {
+        throw EXECUTION_EXCEPTION("duplicate key value violates unique constraint",
+                                  common::ErrorCode::ERRCODE_UNIQUE_VIOLATION);
+      }
+    }
+  }
+}
+
+void CopyIn::FreeStrings(const uint32_t row, const uint16_t num_fields) {
+  for (uint16_t col_idx = 0; col_idx < num_fields; col_idx++) {
+    if (col_types_[col_idx] != type::TypeId::VARCHAR && col_types_[col_idx] != type::TypeId::VARBINARY) continue;
+    const auto offset = col_offsets_[col_idx];
+    if (!batch_->ColumnNullBitmap(offset)->Test(row)) continue;
+    const auto &varlen = reinterpret_cast<const storage::VarlenEntry *>(batch_->ColumnStart(offset))[row];
+    if (varlen.NeedReclaim()) delete[] varlen.Content();
+  }
+}
+
+void CopyIn::ThrowBadFormat(const std::string &message) const {
+  throw EXECUTION_EXCEPTION(fmt::format("{} in row {} of the COPY data", message, num_rows_ + 1),
+                            common::ErrorCode::ERRCODE_BAD_COPY_FILE_FORMAT);
+}
+
+CopyOut::CopyOut(const common::ManagedPointer<transaction::TransactionContext> txn,
+                 const common::ManagedPointer<storage::SqlTable> table, const catalog::Schema &schema,
+                 const CopyFormat format)
+    : txn_(txn), table_(table), format_(format), col_oids_(ColumnOids(schema)) {
+  CheckSupportedTypes(schema);
+  const auto projection_map = table_->ProjectionMapForOids(col_oids_);
+  for (const auto &column : schema.GetColumns()) {
+    col_types_.emplace_back(column.Type());
+    col_offsets_.emplace_back(projection_map.at(column.Oid()));
+  }
+}
+
+uint64_t CopyOut::Write(const common::ManagedPointer<network::PostgresPacketWriter> out,
+                        const common::ManagedPointer<network::NetworkIoWrapper> transport) const {
+  const bool binary = format_.format_ == parser::ExternalFileFormat::BINARY;
+  out->WriteCopyOutResponse(binary ? network::FieldFormat::binary : network::FieldFormat::text,
+                            static_cast<uint16_t>(col_types_.size()));
+
+  // Clients read every CopyData message as one row, so the header and the trailer get messages of their own
+  std::string buffer;
+  if (binary) {
+    buffer.append(BINARY_SIGNATURE, sizeof(BINARY_SIGNATURE));
+    AppendInt<int32_t>(0, &buffer);  // Flags
+    AppendInt<int32_t>(0, &buffer);  // Header extension size
+    out->WriteCopyData(buffer);
+  }
+
+  const auto initializer = table_->InitializerForProjectedColumns(col_oids_, common::Constants::K_DEFAULT_VECTOR_SIZE);
+  const std::unique_ptr<byte[]> batch_buffer(
+      common::AllocationUtil::AllocateAligned(initializer.ProjectedColumnsSize()));
+  auto *const batch = initializer.Initialize(batch_buffer.get());
+
+  uint64_t num_rows = 0;
+  auto iter = table_->begin();
+  while (iter != table_->end()) {
+    table_->Scan(txn_, &iter, batch);
+    for (uint32_t row = 0; row < batch->NumTuples(); row++) {
+      buffer.clear();
+      AppendRow(batch, row, &buffer);
+      out->WriteCopyData(buffer);
+    }
+    num_rows += batch->NumTuples();
+    if (transport != nullptr) transport->ApplyBackPressure();
+  }
+
+  if (binary) {
+    buffer.clear();
+    AppendInt<int16_t>(-1, &buffer);
+    out->WriteCopyData(buffer);
+  }
+  out->WriteCopyDone();
+  return num_rows;
+}
+
+void CopyOut::AppendRow(storage::ProjectedColumns *const batch, const uint32_t row, std::string *const buffer) const {
+  const bool binary = format_.format_ == parser::ExternalFileFormat::BINARY;
+  if (binary) AppendInt<int16_t>(static_cast<int16_t>(col_types_.size()), buffer);
+
+  std::string text;
+  for (std::size_t col_idx = 0; col_idx < col_types_.size(); col_idx++) {
+    const auto offset = col_offsets_[col_idx];
+    const auto type = col_types_[col_idx];
+    const bool null = !batch->ColumnNullBitmap(offset)->Test(row);
+    const byte *const value = batch->ColumnStart(offset) + batch->AttrSizeForColumn(offset) * row;
+
+    if (binary) {
+      if (null) {
+        AppendInt<int32_t>(-1, buffer);
+      } else {
+        AppendBinary(value, type, buffer);
+      }
+      continue;
+    }
+
+    if (col_idx > 0) buffer->push_back(format_.delimiter_);
+    if (null) {
+      // NULL is an unquoted empty field in CSV
+      if (format_.format_ == parser::ExternalFileFormat::TEXT) buffer->append("\\N");
+      continue;
+    }
+    if (type == type::TypeId::VARCHAR || type == type::TypeId::VARBINARY) {
+      AppendEscaped(reinterpret_cast<const storage::VarlenEntry *>(value)->StringView(), buffer);
+    } else {
+      text.clear();
+      AppendText(value, type, &text);
+      AppendEscaped(text, buffer);
+    }
+  }
+  if (!binary) buffer->push_back('\n');
+}
+
+void CopyOut::AppendText(const byte *const value, const type::TypeId type, std::string *const buffer) {
+  const auto append_integer = [buffer](const int64_t integer) {
+    const fmt::format_int formatted(integer);
+    buffer->append(formatted.data(), formatted.size());
+  };
+
+  switch (type) {
+    case type::TypeId::BOOLEAN:
+      buffer->push_back(*reinterpret_cast<const bool *>(value) ? 't' : 'f');
+      break;
+    case type::TypeId::TINYINT:
+      append_integer(*reinterpret_cast<const int8_t *>(value));
+      break;
+    case type::TypeId::SMALLINT:
+      append_integer(*reinterpret_cast<const int16_t *>(value));
+      break;
+    case type::TypeId::INTEGER:
+      append_integer(*reinterpret_cast<const int32_t *>(value));
+      break;
+    case type::TypeId::BIGINT:
+      append_integer(*reinterpret_cast<const int64_t *>(value));
+      break;
+    case type::TypeId::DECIMAL: {
+      // The shortest of the usual precisions that reads back as the same value
+      const double decimal = *reinterpret_cast<const double *>(value);
+      char formatted[32];
+      auto len = std::snprintf(formatted, sizeof(formatted), "%.15g", decimal);
+      if (std::strtod(formatted, nullptr) != decimal) {
+        len = std::snprintf(formatted, sizeof(formatted), "%.17g", decimal);
+      }
+      buffer->append(formatted, len);
+      break;
+    }
+    case type::TypeId::DATE: {
+      execution::sql::Date::NativeType date;
+      std::memcpy(&date, value, sizeof(date));
+      buffer->append(execution::sql::Date::FromNative(date).ToString());
+      break;
+    }
+    case type::TypeId::TIMESTAMP: {
+      execution::sql::Timestamp::NativeType timestamp;
+      std::memcpy(&timestamp, value, sizeof(timestamp));
+      buffer->append(execution::sql::Timestamp::FromNative(timestamp).ToString());
+      break;
+    }
+    default:
+      UNREACHABLE("The types of the columns were checked.");
+  }
+}
+
+void CopyOut::AppendBinary(const byte *const value, const type::TypeId type, std::string *const buffer) {
+  switch (type) {
+    case type::TypeId::BOOLEAN:
+      AppendInt<int32_t>(1, buffer);
+      buffer->push_back(*reinterpret_cast<const bool *>(value) ? 1 : 0);
+      break;
+    case type::TypeId::TINYINT:
+      // Postgres has no one byte integer, so it becomes an int2
+      AppendInt<int32_t>(sizeof(int16_t), buffer);
+      AppendInt<int16_t>(*reinterpret_cast<const int8_t *>(value), buffer);
+      break;
+    case type::TypeId::SMALLINT:
+      AppendInt<int32_t>(sizeof(int16_t), buffer);
+      AppendInt<int16_t>(*reinterpret_cast<const int16_t *>(value), buffer);
+      break;
+    case type::TypeId::INTEGER:
+      AppendInt<int32_t>(sizeof(int32_t), buffer);
+      AppendInt<int32_t>(*reinterpret_cast<const int32_t *>(value), buffer);
+      break;
+    case type::TypeId::BIGINT:
+      AppendInt<int32_t>(sizeof(int64_t), buffer);
+      AppendInt<int64_t>(*reinterpret_cast<const int64_t *>(value), buffer);
+      break;
+    case type::TypeId::DECIMAL: {
+      uint64_t bits;
+      std::memcpy(&bits, value, sizeof(bits));
+      AppendInt<int32_t>(sizeof(bits), buffer);
+      AppendInt<uint64_t>(bits, buffer);
+      break;
+    }
+    case type::TypeId::DATE: {
+      int32_t date;
+      std::memcpy(&date, value, sizeof(date));
+      AppendInt<int32_t>(sizeof(date), buffer);
+      AppendInt<int32_t>(date - PostgresEpochDate(), buffer);
+      break;
+    }
+    case type::TypeId::TIMESTAMP: {
+      uint64_t timestamp;
+      std::memcpy(&timestamp, value, sizeof(timestamp));
+      AppendInt<int32_t>(sizeof(timestamp), buffer);
+      AppendInt<int64_t>(static_cast<int64_t>(timestamp - PostgresEpochTimestamp()), buffer);
+      break;
+    }
+    case type::TypeId::VARCHAR:
+    case type::TypeId::VARBINARY: {
+      const auto content = reinterpret_cast<const storage::VarlenEntry *>(value)->StringView();
+      AppendInt<int32_t>(static_cast<int32_t>(content.size()), buffer);
+      buffer->append(content.data(), content.size());
+      break;
+    }
+    default:
+      UNREACHABLE("The types of the columns were checked.");
+  }
+}
+
+void CopyOut::AppendEscaped(const std::string_view text, std::string *const buffer) const {
+  const char delimiter = format_.delimiter_;
+  if (format_.format_ == parser::ExternalFileFormat::TEXT) {
+    for (const char c : text) {
+      switch (c) {
+        case '\\':
+          buffer->append("\\\\");
+          break;
+        case '\n':
+          buffer->append("\\n");
+          break;
+        case '\r':
+          buffer->append("\\r");
+          break;
+        case '\t':
+          buffer->append("\\t");
+          break;
+        default:
+          if (c == delimiter) buffer->push_back('\\');
+          buffer->push_back(c);
+      }
+    }
+    return;
+  }
+
+  // CSV quotes empty strings, which would read back as NULL otherwise, and the end-of-data marker
+  const char quote = format_.quote_;
+  const char escape = format_.escape_;
+  const bool quoted = text.empty() || text == "\\." ||
+                      std::any_of(text.begin(), text.end(), [&](const char c) {
+                        return c == delimiter || c == quote || c == escape || c == '\n' || c == '\r';
+                      });
+  if (!quoted) {
+    buffer->append(text.data(), text.size());
+    return;
+  }
+  buffer->push_back(quote);
+  for (const char c : text) {
+    if (c == quote || c == escape) buffer->push_back(escape);
+    buffer->push_back(c);
+  }
+  buffer->push_back(quote);
+}
+
+}  // namespace terrier::trafficcop
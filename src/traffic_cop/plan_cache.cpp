@@ -0,0 +1,200 @@
+#include "traffic_cop/plan_cache.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "execution/compiler/executable_query.h"
+#include "planner/plannodes/abstract_plan_node.h"
+#include "planner/plannodes/delete_plan_node.h"
+#include "planner/plannodes/index_join_plan_node.h"
+#include "planner/plannodes/index_scan_plan_node.h"
+#include "planner/plannodes/insert_plan_node.h"
+#include "planner/plannodes/seq_scan_plan_node.h"
+#include "planner/plannodes/update_plan_node.h"
+#include "traffic_cop/point_query.h"
+
+namespace terrier::trafficcop {
+
+namespace {
+
+// Collect the tables the given plan reads or writes.
+void CollectTableOids(const planner::AbstractPlanNode &plan, std::vector<catalog::table_oid_t> *table_oids) {
+  switch (plan.GetPlanNodeType()) {
+    case planner::PlanNodeType::SEQSCAN:
+      table_oids->push_back(static_cast<const planner::SeqScanPlanNode &>(plan).GetTableOid());
+      break;
+    case planner::PlanNodeType::INDEXSCAN:
+      table_oids->push_back(static_cast<const planner::IndexScanPlanNode &>(plan).GetTableOid());
+      break;
+    case planner::PlanNodeType::INDEXNLJOIN:
+      table_oids->push_back(static_cast<const planner::IndexJoinPlanNode &>(plan).GetTableOid());
+      break;
+    case planner::PlanNodeType::INSERT:
+      table_oids->push_back(static_cast<const planner::InsertPlanNode &>(plan).GetTableOid());
+      break;
+    case planner::PlanNodeType::UPDATE:
+      table_oids->push_back(static_cast<const planner::UpdatePlanNode &>(plan).GetTableOid());
+      break;
+    case planner::PlanNodeType::DELETE:
+      table_oids->push_back(static_cast<const planner::DeletePlanNode &>(plan).GetTableOid());
+      break;
+    default:
+      break;
+  }
+  for (const auto &child : plan.GetChildren()) {
+    CollectTableOids(*child, table_oids);
+  }
+}
+
+}  // namespace
+
+//===----------------------------------------------------------------------===//
+//
+// Cached Plan
+//
+//===----------------------------------------------------------------------===//
+
+CachedPlan::CachedPlan(std::shared_ptr<planner::AbstractPlanNode> physical_plan,
+                       std::shared_ptr<execution::compiler::ExecutableQuery> executable_query,
+                       std::vector<type::TypeId> desired_param_types)
+    : physical_plan_(std::move(physical_plan)),
+      executable_query_(std::move(executable_query)),
+      desired_param_types_(std::move(desired_param_types)) {
+  CollectTableOids(*physical_plan_, &table_oids_);
+  std::sort(table_oids_.begin(), table_oids_.end());
+  table_oids_.erase(std::unique(table_oids_.begin(), table_oids_.end()), table_oids_.end());
+}
+
+CachedPlan::CachedPlan(std::shared_ptr<PointQuery> point_query, std::vector<type::TypeId> desired_param_types)
+    : point_query_(std::move(point_query)),
+      desired_param_types_(std::move(desired_param_types)),
+      table_oids_{point_query_->GetTableOid()} {}
+
+//===----------------------------------------------------------------------===//
+//
+// Plan Cache
+//
+//===----------------------------------------------------------------------===//
+
+PlanCache::PlanCache(const uint64_t max_entries)
+    : max_entries_per_shard_(std::max<uint64_t>(1, max_entries / K_NUM_SHARDS)) {}
+
+common::hash_t PlanCache::Hash(const catalog::db_oid_t db_oid, const std::string &query_text,
+                               const std::vector<type::TypeId> &param_types) {
+  auto hash = common::HashUtil::CombineHashes(common::HashUtil::Hash(db_oid), common::HashUtil::Hash(query_text));
+  return common::HashUtil::CombineHashInRange(hash, param_types.begin(), param_types.end());
+}
+
+std::shared_ptr<CachedPlan> PlanCache::Lookup(const catalog::db_oid_t db_oid, const std::string &query_text,
+                                              const std::vector<type::TypeId> &param_types) {
+  const auto hash = Hash(db_oid, query_text, param_types);
+  auto *shard = GetShard(hash);
+
+  common::SpinLatch::ScopedSpinLatch guard(&shard->latch_);
+  const auto iter = shard->entries_.find(hash);
+  if (iter == shard->entries_.end() || iter->second.db_oid_ != db_oid || iter->second.query_text_ != query_text ||
+      iter->second.param_types_ != param_types) {
+    num_misses_.fetch_add(1, std::memory_order_relaxed);
+    return nullptr;
+  }
+
+  auto &entry = iter->second;
+  shard->lru_.splice(shard->lru_.begin(), shard->lru_, entry.lru_position_);
+  num_hits_.fetch_add(1, std::memory_order_relaxed);
+  return entry.plan_;
+}
+
+bool PlanCache::Insert(const catalog::db_oid_t db_oid, const std::string &query_text,
+                       const std::vector<type::TypeId> &param_types, std::shared_ptr<CachedPlan> plan,
+                       const uint64_t generation) {
+  const auto hash = Hash(db_oid, query_text, param_types);
+  auto *shard = GetShard(hash);
+
+  // The evicted plan is destroyed outside of the latch, which may have to wait for its background compilation.
+  std::shared_ptr<CachedPlan> victim;
+  {
+    common::SpinLatch::ScopedSpinLatch guard(&shard->latch_);
+
+    // An invalidation increments the number of pending invalidations and bumps the generation before it sweeps the
+    // shards. So either this sees it and backs off, or the sweep sees this plan and removes it.
+    if (num_pending_invalidations_.load() != 0 || generation_.load() != generation) {
+      return false;
+    }
+    if (shard->entries_.count(hash) != 0) {
+      return false;
+    }
+
+    shard->lru_.push_front(hash);
+    shard->entries_.emplace(hash, Entry{db_oid, query_text, param_types, std::move(plan), shard->lru_.begin()});
+    num_insertions_.fetch_add(1, std::memory_order_relaxed);
+
+    if (shard->entries_.size() > max_entries_per_shard_) {
+      const auto victim_iter = shard->entries_.find(shard->lru_.back());
+      victim = std::move(victim_iter->second.plan_);
+      shard->entries_.erase(victim_iter);
+      shard->lru_.pop_back();
+      num_evictions_.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+  return true;
+}
+
+void PlanCache::BeginInvalidation(const catalog::db_oid_t db_oid, const catalog::table_oid_t table_oid) {
+  num_pending_invalidations_.fetch_add(1);
+  Invalidate(db_oid, table_oid);
+}
+
+void PlanCache::EndInvalidation(const catalog::db_oid_t db_oid, const catalog::table_oid_t table_oid) {
+  // Plans added since the invalidation began were planned by the transaction making the change.
+  Invalidate(db_oid, table_oid);
+  TERRIER_ASSERT(num_pending_invalidations_.load() > 0, "Invalidation ended without having begun.");
+  num_pending_invalidations_.fetch_sub(1);
+}
+
+void PlanCache::Invalidate(const catalog::db_oid_t db_oid, const catalog::table_oid_t table_oid) {
+  generation_.fetch_add(1);
+
+  std::vector<std::shared_ptr<CachedPlan>> victims;
+  for (auto &shard : shards_) {
+    common::SpinLatch::ScopedSpinLatch guard(&shard.latch_);
+    for (auto iter = shard.entries_.begin(); iter != shard.entries_.end();) {
+      const auto &entry = iter->second;
+      const auto &table_oids = entry.plan_->GetTableOids();
+      if (entry.db_oid_ == db_oid && (table_oid == catalog::INVALID_TABLE_OID ||
+                                      std::binary_search(table_oids.begin(), table_oids.end(), table_oid))) {
+        entry.plan_->valid_.store(false, std::memory_order_release);
+        victims.push_back(entry.plan_);
+        shard.lru_.erase(entry.lru_position_);
+        iter = shard.entries_.erase(iter);
+      } else {
+        ++iter;
+      }
+    }
+  }
+  num_invalidations_.fetch_add(victims.size(), std::memory_order_relaxed);
+}
+
+void PlanCache::Clear() {
+  for (auto &shard : shards_) {
+    std::unordered_map<common::hash_t, Entry> entries;
+    {
+      common::SpinLatch::ScopedSpinLatch guard(&shard.latch_);
+      entries.swap(shard.entries_);
+      shard.lru_.clear();
+    }
+  }
+}
+
+uint64_t PlanCache::GetNumEntries() const {
+  uint64_t num_entries = 0;
+  for (const auto &shard : shards_) {
+    common::SpinLatch::ScopedSpinLatch guard(&shard.latch_);
+    num_entries += shard.entries_.size();
+  }
+  return num_entries;
+}
+
+}  // namespace terrier::trafficcop
@@ -0,0 +1,385 @@
+#include "traffic_cop/point_query.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "catalog/catalog_accessor.h"
+#include "common/allocator.h"
+#include "common/math_util.h"
+#include "execution/sql/value.h"
+#include "execution/sql/value_util.h"
+#include "network/postgres/postgres_packet_writer.h"
+#include "parser/expression/column_value_expression.h"
+#include "parser/expression/parameter_value_expression.h"
+#include "parser/select_statement.h"
+#include "parser/table_ref.h"
+#include "parser/update_statement.h"
+#include "storage/index/index.h"
+#include "storage/sql_table.h"
+#include "transaction/transaction_context.h"
+
+namespace terrier::trafficcop {
+
+namespace {
+
+// Whether the fast path can read and write values of the given type.
+bool IsSupportedType(const type::TypeId type) {
+  switch (type) {
+    case type::TypeId::BOOLEAN:
+    case type::TypeId::TINYINT:
+    case type::TypeId::SMALLINT:
+    case type::TypeId::INTEGER:
+    case type::TypeId::BIGINT:
+    case type::TypeId::DECIMAL:
+    case type::TypeId::DATE:
+    case type::TypeId::TIMESTAMP:
+    case type::TypeId::VARCHAR:
+    case type::TypeId::VARBINARY:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Write the given value to an attribute of a projected row. Varlens are copied if own is set, otherwise they point into
+// the value.
+void WriteAttribute(const parser::ConstantValueExpression &value, const type::TypeId type, const bool own,
+                    storage::ProjectedRow *const pr, const uint16_t offset) {
+  if (value.IsNull()) {
+    pr->SetNull(offset);
+    return;
+  }
+  byte *const attr = pr->AccessForceNotNull(offset);
+  switch (type) {
+    case type::TypeId::BOOLEAN:
+      *reinterpret_cast<bool *>(attr) = value.GetBoolVal().val_;
+      break;
+    case type::TypeId::TINYINT:
+      *reinterpret_cast<int8_t *>(attr) = static_cast<int8_t>(value.GetInteger().val_);
+      break;
+    case type::TypeId::SMALLINT:
+      *reinterpret_cast<int16_t *>(attr) = static_cast<int16_t>(value.GetInteger().val_);
+      break;
+    case type::TypeId::INTEGER:
+      *reinterpret_cast<int32_t *>(attr) = static_cast<int32_t>(value.GetInteger().val_);
+      break;
+    case type::TypeId::BIGINT:
+      *reinterpret_cast<int64_t *>(attr) = value.GetInteger().val_;
+      break;
+    case type::TypeId::DECIMAL:
+      *reinterpret_cast<double *>(attr) = value.GetReal().val_;
+      break;
+    case type::TypeId::DATE:
+      *reinterpret_cast<uint32_t *>(attr) = value.GetDateVal().val_.ToNative();
+      break;
+    case type::TypeId::TIMESTAMP:
+      *reinterpret_cast<uint64_t *>(attr) = value.GetTimestampVal().val_.ToNative();
+      break;
+    case type::TypeId::VARCHAR:
+    case type::TypeId::VARBINARY:
+      *reinterpret_cast<storage::VarlenEntry *>(attr) =
+          execution::sql::StringVal::CreateVarlen(value.GetStringVal(), own);
+      break;
+    default:
+      UNREACHABLE("Point queries are only created for supported types.");
+  }
+}
+
+// Read an attribute of a projected row into the SQL value the PostgresPacketWriter expects.
+void ReadAttribute(const storage::ProjectedRow &pr, const uint16_t offset, const type::TypeId type, byte *const out) {
+  const byte *const attr = pr.AccessWithNullCheck(offset);
+  if (attr == nullptr) {
+    new (out) execution::sql::Val(true);
+    return;
+  }
+  switch (type) {
+    case type::TypeId::BOOLEAN:
+      new (out) execution::sql::BoolVal(*reinterpret_cast<const bool *>(attr));
+      break;
+    case type::TypeId::TINYINT:
+      new (out) execution::sql::Integer(*reinterpret_cast<const int8_t *>(attr));
+      break;
+    case type::TypeId::SMALLINT:
+      new (out) execution::sql::Integer(*reinterpret_cast<const int16_t *>(attr));
+      break;
+    case type::TypeId::INTEGER:
+      new (out) execution::sql::Integer(*reinterpret_cast<const int32_t *>(attr));
+      break;
+    case type::TypeId::BIGINT:
+      new (out) execution::sql::Integer(*reinterpret_cast<const int64_t *>(attr));
+      break;
+    case type::TypeId::DECIMAL:
+      new (out) execution::sql::Real(*reinterpret_cast<const double *>(attr));
+      break;
+    case type::TypeId::DATE:
+      new (out) execution::sql::DateVal(execution::sql::Date::FromNative(*reinterpret_cast<const uint32_t *>(attr)));
+      break;
+    case type::TypeId::TIMESTAMP:
+      new (out) execution::sql::TimestampVal(
+          execution::sql::Timestamp::FromNative(*reinterpret_cast<const uint64_t *>(attr)));
+      break;
+    case type::TypeId::VARCHAR:
+    case type::TypeId::VARBINARY: {
+      const auto *const varlen = reinterpret_cast<const storage::VarlenEntry *>(attr);
+      new (out) execution::sql::StringVal(reinterpret_cast<const char *>(varlen->Content()), varlen->Size());
+      break;
+    }
+    default:
+      UNREACHABLE("Point queries are only created for supported types.");
+  }
+}
+
+// If the given expression is a constant or a parameter of the given type, return true and set value accordingly.
+template <typename Value>
+bool BindValue(const common::ManagedPointer<parser::AbstractExpression> expr, const type::TypeId type, Value *value) {
+  if (expr->GetReturnValueType() != type) return false;
+  if (expr->GetExpressionType() == parser::ExpressionType::VALUE_PARAMETER) {
+    const auto param_idx = expr.CastManagedPointerTo<parser::ParameterValueExpression>()->GetValueIdx();
+    value->param_idx_ = static_cast<int32_t>(param_idx);
+    return true;
+  }
+  if (expr->GetExpressionType() == parser::ExpressionType::VALUE_CONSTANT) {
+    value->param_idx_ = -1;
+    value->constant_ = *expr.CastManagedPointerTo<parser::ConstantValueExpression>();
+    return true;
+  }
+  return false;
+}
+
+// Collect the column = value predicates of a conjunction. Returns false if it contains anything else.
+template <typename Value>
+bool CollectPredicates(const common::ManagedPointer<parser::AbstractExpression> expr, catalog::table_oid_t *table_oid,
+                       std::vector<std::pair<catalog::col_oid_t, Value>> *predicates) {
+  if (expr->GetExpressionType() == parser::ExpressionType::CONJUNCTION_AND) {
+    const auto children = expr->GetChildren();
+    return std::all_of(children.begin(), children.end(),
+                       [&](const auto &child) { return CollectPredicates(child, table_oid, predicates); });
+  }
+  if (expr->GetExpressionType() != parser::ExpressionType::COMPARE_EQUAL || expr->GetChildrenSize() != 2) {
+    return false;
+  }
+
+  auto column = expr->GetChild(0);
+  auto value = expr->GetChild(1);
+  if (column->GetExpressionType() != parser::ExpressionType::COLUMN_VALUE) std::swap(column, value);
+  if (column->GetExpressionType() != parser::ExpressionType::COLUMN_VALUE) return false;
+
+  const auto column_value = column.CastManagedPointerTo<parser::ColumnValueExpression>();
+  if (*table_oid == catalog::INVALID_TABLE_OID) *table_oid = column_value->GetTableOid();
+  if (column_value->GetTableOid() != *table_oid) return false;
+
+  Value bound_value{};
+  if (!BindValue(value, column->GetReturnValueType(), &bound_value)) return false;
+  const auto col_oid = column_value->GetColumnOid();
+  if (std::any_of(predicates->begin(), predicates->end(), [=](const auto &p) { return p.first == col_oid; })) {
+    return false;
+  }
+  predicates->emplace_back(col_oid, std::move(bound_value));
+  return true;
+}
+
+}  // namespace
+
+std::unique_ptr<PointQuery> PointQuery::Create(const common::ManagedPointer<catalog::CatalogAccessor> accessor,
+                                               const common::ManagedPointer<parser::SQLStatement> statement) {
+  std::unique_ptr<PointQuery> point_query(new PointQuery());
+  common::ManagedPointer<parser::AbstractExpression> where;
+
+  if (statement->GetType() == parser::StatementType::SELECT) {
+    const auto select = statement.CastManagedPointerTo<parser::SelectStatement>();
+    if (select->GetSelectTable() == nullptr ||
+        select->GetSelectTable()->GetTableReferenceType() != parser::TableReferenceType::NAME ||
+        select->IsSelectDistinct() || select->GetSelectGroupBy() != nullptr || select->GetSelectOrderBy() != nullptr ||
+        select->GetSelectLimit() != nullptr || select->GetUnionSelect() != nullptr) {
+      return nullptr;
+    }
+    where = select->GetSelectCondition();
+  } else if (statement->GetType() == parser::StatementType::UPDATE) {
+    point_query->is_update_ = true;
+    where = statement.CastManagedPointerTo<parser::UpdateStatement>()->GetUpdateCondition();
+  } else {
+    return nullptr;
+  }
+
+  if (where == nullptr || !point_query->BindKey(accessor, where)) {
+    return nullptr;
+  }
+
+  const auto table = accessor->GetTable(point_query->table_oid_);
+  const auto &schema = accessor->GetSchema(point_query->table_oid_);
+  auto &columns = point_query->columns_;
+
+  if (point_query->is_update_) {
+    // Only columns outside of all indexes, so that updating in place is all there is to it
+    std::vector<catalog::col_oid_t> indexed_col_oids;
+    for (const auto index_oid : accessor->GetIndexOids(point_query->table_oid_)) {
+      const auto &index_col_oids = accessor->GetIndexSchema(index_oid).GetIndexedColOids();
+      indexed_col_oids.insert(indexed_col_oids.end(), index_col_oids.begin(), index_col_oids.end());
+    }
+    for (const auto &clause : statement.CastManagedPointerTo<parser::UpdateStatement>()->GetUpdateClauses()) {
+      const auto &column = schema.GetColumn(clause->GetColumnName());
+      TableColumn table_column{column.Oid(), column.Type(), column.Nullable(), 0, {}};
+      if (!IsSupportedType(column.Type()) ||
+          std::find(indexed_col_oids.begin(), indexed_col_oids.end(), column.Oid()) != indexed_col_oids.end() ||
+          std::any_of(columns.begin(), columns.end(), [&](const auto &c) { return c.oid_ == column.Oid(); }) ||
+          !BindValue(clause->GetUpdateValue(), column.Type(), &table_column.value_)) {
+        return nullptr;
+      }
+      columns.emplace_back(std::move(table_column));
+    }
+    point_query->output_schema_ = std::make_unique<planner::OutputSchema>();
+  } else {
+    std::vector<planner::OutputSchema::Column> output_columns;
+    for (const auto &expr : statement.CastManagedPointerTo<parser::SelectStatement>()->GetSelectColumns()) {
+      if (expr->GetExpressionType() != parser::ExpressionType::COLUMN_VALUE ||
+          expr.CastManagedPointerTo<parser::ColumnValueExpression>()->GetTableOid() != point_query->table_oid_ ||
+          !IsSupportedType(expr->GetReturnValueType())) {
+        return nullptr;
+      }
+      const auto col_oid = expr.CastManagedPointerTo<parser::ColumnValueExpression>()->GetColumnOid();
+      auto column = std::find_if(columns.begin(), columns.end(), [=](const auto &c) { return c.oid_ == col_oid; });
+      if (column == columns.end()) {
+        columns.push_back({col_oid, expr->GetReturnValueType(), true, 0, {}});
+        column = columns.end() - 1;
+      }
+      point_query->output_columns_.push_back(static_cast<uint16_t>(column - columns.begin()));
+      output_columns.emplace_back(expr->GetExpressionName(), expr->GetReturnValueType(), expr->Copy());
+    }
+    if (columns.empty()) return nullptr;
+
+    // Lay out the output row like the execution engine does
+    for (const auto &column : output_columns) {
+      const auto alignment = execution::sql::ValUtil::GetSqlAlignment(column.GetType());
+      point_query->output_row_size_ =
+          static_cast<uint32_t>(common::MathUtil::AlignTo(point_query->output_row_size_, alignment));
+      point_query->output_offsets_.push_back(point_query->output_row_size_);
+      point_query->output_row_size_ += execution::sql::ValUtil::GetSqlSize(column.GetType());
+    }
+    point_query->output_schema_ = std::make_unique<planner::OutputSchema>(std::move(output_columns));
+  }
+
+  std::vector<catalog::col_oid_t> col_oids;
+  col_oids.reserve(columns.size());
+  for (const auto &column : columns) col_oids.push_back(column.oid_);
+  point_query->pr_initializer_ =
+      std::make_unique<storage::ProjectedRowInitializer>(table->InitializerForProjectedRow(col_oids));
+  const auto projection_map = table->ProjectionMapForOids(col_oids);
+  for (auto &column : columns) column.pr_offset_ = projection_map.at(column.oid_);
+
+  return point_query;
+}
+
+bool PointQuery::BindKey(const common::ManagedPointer<catalog::CatalogAccessor> accessor,
+                         const common::ManagedPointer<parser::AbstractExpression> where) {
+  std::vector<std::pair<catalog::col_oid_t, Value>> predicates;
+  if (!CollectPredicates(where, &table_oid_, &predicates)) return false;
+
+  // Find a unique index whose key columns are exactly the columns of the predicates
+  for (const auto index_oid : accessor->GetIndexOids(table_oid_)) {
+    const auto &index_schema = accessor->GetIndexSchema(index_oid);
+    if (!index_schema.Unique() || index_schema.GetColumns().size() != predicates.size()) continue;
+
+    std::vector<KeyColumn> key_columns;
+    for (const auto &column : index_schema.GetColumns()) {
+      const auto expr = column.StoredExpression();
+      if (expr->GetExpressionType() != parser::ExpressionType::COLUMN_VALUE || !IsSupportedType(column.Type())) break;
+      const auto col_oid = expr.CastManagedPointerTo<const parser::ColumnValueExpression>()->GetColumnOid();
+      const auto predicate =
+          std::find_if(predicates.begin(), predicates.end(), [=](const auto &p) { return p.first == col_oid; });
+      if (predicate == predicates.end() || expr->GetReturnValueType() != column.Type()) break;
+      key_columns.push_back({column.Oid(), column.Type(), predicate->second});
+    }
+
+    if (key_columns.size() == predicates.size()) {
+      index_oid_ = index_oid;
+      key_columns_ = std::move(key_columns);
+      return true;
+    }
+  }
+  return false;
+}
+
+const parser::ConstantValueExpression &PointQuery::Resolve(const Value &value,
+                                                           const std::vector<parser::ConstantValueExpression> &params) {
+  return value.param_idx_ < 0 ? value.constant_ : params[value.param_idx_];
+}
+
+TrafficCopResult PointQuery::Execute(const common::ManagedPointer<transaction::TransactionContext> txn,
+                                     const common::ManagedPointer<catalog::CatalogAccessor> accessor,
+                                     const catalog::db_oid_t db_oid,
+                                     const std::vector<parser::ConstantValueExpression> &params,
+                                     const common::ManagedPointer<network::PostgresPacketWriter> out,
+                                     const std::vector<network::FieldFormat> &result_formats) const {
+  // Look the table and the index up again, as a concurrent transaction may have dropped them
+  const auto table = accessor->GetTable(table_oid_);
+  const auto index = accessor->GetIndex(index_oid_);
+  if (table == nullptr || index == nullptr) {
+    return {ResultType::ERROR, common::ErrorData(common::ErrorSeverity::ERROR, "relation does not exist",
+                                                 common::ErrorCode::ERRCODE_UNDEFINED_TABLE)};
+  }
+
+  // Find the row. NULL is never equal to anything.
+  const auto &key_initializer = index->GetProjectedRowInitializer();
+  byte *const key_buffer = common::AllocationUtil::AllocateAligned(key_initializer.ProjectedRowSize());
+  auto *const key = key_initializer.InitializeRow(key_buffer);
+  const auto &key_offsets = index->GetKeyOidToOffsetMap();
+  bool null_key = false;
+  for (const auto &key_column : key_columns_) {
+    const auto &value = Resolve(key_column.value_, params);
+    null_key = null_key || value.IsNull();
+    WriteAttribute(value, key_column.type_, false, key, key_offsets.at(key_column.oid_));
+  }
+  std::vector<storage::TupleSlot> slots;
+  if (!null_key) {
+    index->ScanKey(*txn, *key, &slots);
+  }
+  delete[] key_buffer;
+
+  if (is_update_) {
+    for (const auto &column : columns_) {
+      if (!column.nullable_ && Resolve(column.value_, params).IsNull()) {
+        txn->SetMustAbort();
+        return {ResultType::ERROR, common::ErrorData(common::ErrorSeverity::ERROR,
+                                                     "null value in column violates not-null constraint",
+                                                     common::ErrorCode::ERRCODE_NOT_NULL_VIOLATION)};
+      }
+    }
+    for (const auto &slot : slots) {
+      auto *const redo = txn->StageWrite(db_oid, table_oid_, *pr_initializer_);
+      for (const auto &column : columns_) {
+        WriteAttribute(Resolve(column.value_, params), column.type_, true, redo->Delta(), column.pr_offset_);
+      }
+      redo->SetTupleSlot(slot);
+      if (!table->Update(txn, redo)) {
+        // A write-write conflict. The table already marked the transaction as must-abort.
+        return {ResultType::ERROR, common::ErrorData(common::ErrorSeverity::ERROR, "transaction aborted",
+                                                     common::ErrorCode::ERRCODE_T_R_SERIALIZATION_FAILURE)};
+      }
+    }
+    return {ResultType::COMPLETE, static_cast<uint32_t>(slots.size())};
+  }
+
+  uint32_t num_rows = 0;
+  if (!slots.empty()) {
+    byte *const row_buffer = common::AllocationUtil::AllocateAligned(pr_initializer_->ProjectedRowSize());
+    auto *const row = pr_initializer_->InitializeRow(row_buffer);
+    byte *const output_row = common::AllocationUtil::AllocateAligned(output_row_size_);
+    for (const auto &slot : slots) {
+      if (!table->Select(txn, slot, row)) continue;
+      for (uint32_t i = 0; i < output_columns_.size(); i++) {
+        const auto &column = columns_[output_columns_[i]];
+        ReadAttribute(*row, column.pr_offset_, column.type_, output_row + output_offsets_[i]);
+      }
+      out->WriteDataRow(output_row, output_schema_->GetColumns(), result_formats);
+      num_rows++;
+    }
+    delete[] output_row;
+    delete[] row_buffer;
+  }
+  return {ResultType::COMPLETE, num_rows};
+}
+
+}  // namespace terrier::trafficcop
@@ -0,0 +1,281 @@
+#include "traffic_cop/query_normalizer.h"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "execution/sql/value.h"
+#include "execution/sql/value_util.h"
+#include "parser/expression/constant_value_expression.h"
+
+namespace terrier::trafficcop {
+
+namespace {
+
+enum class TokenType : uint8_t { IDENTIFIER, QUOTED_IDENTIFIER, STRING, INTEGER, NUMBER, OPERATOR };
+
+struct Token {
+  TokenType type_;
+  // The token's text, including quotes.
+  std::string_view text_;
+  // True if the token is preceded by whitespace or a comment.
+  bool space_before_;
+};
+
+// Statements that are normalized.
+constexpr std::array<std::string_view, 4> K_STATEMENT_KEYWORDS = {"DELETE", "INSERT", "SELECT", "UPDATE"};
+
+// Keywords after which a literal is an operand.
+constexpr std::array<std::string_view, 10> K_OPERAND_KEYWORDS = {"AND",    "BETWEEN", "ELSE", "LIKE", "NOT",
+                                                                  "OR",     "SELECT",  "THEN", "WHEN", "WHERE"};
+
+// Keywords that may directly precede a parenthesis that doesn't open the argument list of a function call.
+constexpr std::array<std::string_view, 14> K_NON_FUNCTION_KEYWORDS = {
+    "AND", "ELSE", "EXISTS", "FROM", "IN", "JOIN", "NOT", "ON", "OR", "SELECT", "THEN", "VALUES", "WHEN", "WHERE"};
+
+// Keywords that end an ORDER BY or GROUP BY list.
+constexpr std::array<std::string_view, 8> K_END_OF_BY_LIST_KEYWORDS = {"EXCEPT", "FOR",   "HAVING", "INTERSECT",
+                                                                        "LIMIT",  "OFFSET", "UNION",  "WINDOW"};
+
+// The last character of operators after which a literal is an operand. Notably excludes + and -, which may be signs.
+constexpr std::string_view K_OPERAND_OPERATORS = "%(*,/<=>|";
+
+bool IsIdentifierStart(const char c) {
+  const auto uc = static_cast<unsigned char>(c);
+  return std::isalpha(uc) != 0 || c == '_' || uc >= 0x80;
+}
+
+bool IsIdentifierChar(const char c) {
+  return IsIdentifierStart(c) || std::isdigit(static_cast<unsigned char>(c)) != 0 || c == '$';
+}
+
+bool IsDigit(const char c) { return std::isdigit(static_cast<unsigned char>(c)) != 0; }
+
+template <std::size_t N>
+bool IsKeyword(const std::array<std::string_view, N> &keywords, const std::string_view upper) {
+  return std::find(keywords.begin(), keywords.end(), upper) != keywords.end();
+}
+
+std::string ToUpper(std::string_view text) {
+  std::string result(text);
+  std::transform(result.begin(), result.end(), result.begin(),
+                 [](const char c) { return static_cast<char>(std::toupper(static_cast<unsigned char>(c))); });
+  return result;
+}
+
+// Skip over a quoted string or identifier starting at pos, in which the quote is escaped by doubling it. Returns the
+// position past the closing quote, or npos if the quote isn't closed.
+std::size_t SkipQuoted(const std::string_view text, std::size_t pos) {
+  const char quote = text[pos++];
+  while (pos < text.size()) {
+    if (text[pos++] == quote) {
+      if (pos < text.size() && text[pos] == quote) {
+        pos++;
+      } else {
+        return pos;
+      }
+    }
+  }
+  return std::string_view::npos;
+}
+
+// Split the given query into tokens. Returns false if the query uses syntax this isn't prepared to deal with.
+bool Tokenize(const std::string_view text, std::vector<Token> *tokens) {
+  std::size_t pos = 0;
+  bool space_before = false;
+  while (pos < text.size()) {
+    const char c = text[pos];
+    const std::size_t begin = pos;
+
+    if (std::isspace(static_cast<unsigned char>(c)) != 0) {
+      pos++;
+      space_before = true;
+      continue;
+    }
+    if (text.compare(pos, 2, "--") == 0) {
+      pos = std::min(text.find('\n', pos), text.size());
+      space_before = true;
+      continue;
+    }
+    if (text.compare(pos, 2, "/*") == 0) {
+      // Block comments nest.
+      uint32_t depth = 0;
+      do {
+        if (pos + 1 >= text.size()) return false;
+        if (text.compare(pos, 2, "/*") == 0) {
+          depth++;
+          pos += 2;
+        } else if (text.compare(pos, 2, "*/") == 0) {
+          depth--;
+          pos += 2;
+        } else {
+          pos++;
+        }
+      } while (depth > 0);
+      space_before = true;
+      continue;
+    }
+
+    TokenType type;
+    if (c == '\'') {
+      // A prefix (E'', B'', X'', U&'') changes the meaning of the string.
+      if (begin > 0 && (IsIdentifierChar(text[begin - 1]) || text[begin - 1] == '&')) return false;
+      if ((pos = SkipQuoted(text, pos)) == std::string_view::npos) return false;
+      type = TokenType::STRING;
+    } else if (c == '"') {
+      if ((pos = SkipQuoted(text, pos)) == std::string_view::npos) return false;
+      type = TokenType::QUOTED_IDENTIFIER;
+    } else if (IsDigit(c) || (c == '.' && pos + 1 < text.size() && IsDigit(text[pos + 1]))) {
+      type = TokenType::INTEGER;
+      while (pos < text.size() && IsDigit(text[pos])) pos++;
+      if (pos < text.size() && text[pos] == '.') {
+        type = TokenType::NUMBER;
+        pos++;
+        while (pos < text.size() && IsDigit(text[pos])) pos++;
+      }
+      if (pos < text.size() && (text[pos] == 'e' || text[pos] == 'E')) {
+        type = TokenType::NUMBER;
+        pos++;
+        if (pos < text.size() && (text[pos] == '+' || text[pos] == '-')) pos++;
+        while (pos < text.size() && IsDigit(text[pos])) pos++;
+      }
+      if (pos < text.size() && IsIdentifierChar(text[pos])) return false;
+    } else if (IsIdentifierStart(c)) {
+      while (pos < text.size() && IsIdentifierChar(text[pos])) pos++;
+      type = TokenType::IDENTIFIER;
+    } else if (c == '$') {
+      // Already parameterized, or a dollar-quoted string.
+      return false;
+    } else {
+      pos += text.compare(pos, 2, "::") == 0 ? 2 : 1;
+      type = TokenType::OPERATOR;
+    }
+
+    tokens->push_back({type, text.substr(begin, pos - begin), space_before});
+    space_before = false;
+  }
+  return true;
+}
+
+// Convert the given literal to a parameter value. Returns false if it's not representable.
+bool ToParameter(const Token &token, std::vector<parser::ConstantValueExpression> *parameters) {
+  if (token.type_ == TokenType::STRING) {
+    std::string value;
+    value.reserve(token.text_.size() - 2);
+    for (std::size_t i = 1; i + 1 < token.text_.size(); i++) {
+      value.push_back(token.text_[i]);
+      if (token.text_[i] == '\'') i++;
+    }
+    auto string_val = execution::sql::ValueUtil::CreateStringVal(std::string_view(value));
+    parameters->emplace_back(type::TypeId::VARCHAR, string_val.first, std::move(string_val.second));
+    return true;
+  }
+
+  // Integers are typed like the parser does: INTEGER if the value fits, BIGINT otherwise.
+  // The token isn't null-terminated, so it's copied for strtoll.
+  const std::string digits(token.text_);
+  char *end;
+  errno = 0;
+  const int64_t value = std::strtoll(digits.c_str(), &end, 10);
+  if (errno == ERANGE || end != digits.c_str() + digits.size()) {
+    return false;
+  }
+  if (value <= std::numeric_limits<int32_t>::max()) {
+    parameters->emplace_back(type::TypeId::INTEGER, execution::sql::Integer(value));
+  } else {
+    parameters->emplace_back(type::TypeId::BIGINT, execution::sql::Integer(value));
+  }
+  return true;
+}
+
+}  // namespace
+
+bool QueryNormalizer::Normalize(const std::string &query_text, std::string *normalized_text,
+                                std::vector<parser::ConstantValueExpression> *parameters) {
+  std::vector<Token> tokens;
+  if (!Tokenize(query_text, &tokens) || tokens.empty() || tokens[0].type_ != TokenType::IDENTIFIER ||
+      !IsKeyword(K_STATEMENT_KEYWORDS, ToUpper(tokens[0].text_))) {
+    return false;
+  }
+
+  std::string result;
+  result.reserve(query_text.size());
+  std::vector<parser::ConstantValueExpression> literals;
+
+  // For each open parenthesis, whether it encloses the arguments of a function call.
+  std::vector<bool> parentheses;
+  // The nesting depth of the ORDER BY or GROUP BY list being scanned, or -1 if not in such a list.
+  int64_t by_list_depth = -1;
+  std::string previous_keyword;
+
+  for (std::size_t i = 0; i < tokens.size(); i++) {
+    const auto &token = tokens[i];
+    const auto depth = static_cast<int64_t>(parentheses.size());
+    if (token.space_before_ && !result.empty()) {
+      result.push_back(' ');
+    }
+
+    switch (token.type_) {
+      case TokenType::IDENTIFIER: {
+        auto keyword = ToUpper(token.text_);
+        if (keyword == "BY" && (previous_keyword == "ORDER" || previous_keyword == "GROUP")) {
+          by_list_depth = depth;
+        } else if (by_list_depth == depth && IsKeyword(K_END_OF_BY_LIST_KEYWORDS, keyword)) {
+          by_list_depth = -1;
+        }
+        previous_keyword = std::move(keyword);
+        break;
+      }
+      case TokenType::OPERATOR: {
+        if (token.text_ == "(") {
+          parentheses.push_back(i > 0 && tokens[i - 1].type_ == TokenType::IDENTIFIER &&
+                                !IsKeyword(K_NON_FUNCTION_KEYWORDS, ToUpper(tokens[i - 1].text_)));
+        } else if (token.text_ == ")") {
+          if (parentheses.empty()) return false;
+          parentheses.pop_back();
+          if (by_list_depth > depth - 1) by_list_depth = -1;
+        } else if (token.text_ == ";" && i + 1 != tokens.size()) {
+          // Multiple statements.
+          return false;
+        }
+        break;
+      }
+      case TokenType::STRING:
+      case TokenType::INTEGER: {
+        const auto *previous = i > 0 ? &tokens[i - 1] : nullptr;
+        const bool is_operand =
+            previous != nullptr &&
+            ((previous->type_ == TokenType::OPERATOR && previous->text_.size() == 1 &&
+              K_OPERAND_OPERATORS.find(previous->text_[0]) != std::string_view::npos) ||
+             (previous->type_ == TokenType::IDENTIFIER && IsKeyword(K_OPERAND_KEYWORDS, ToUpper(previous->text_))));
+        const bool is_cast = i + 1 < tokens.size() && tokens[i + 1].text_ == "::";
+        const bool in_function_call = !parentheses.empty() && parentheses.back();
+        if (is_operand && !is_cast && !in_function_call && by_list_depth < 0 && ToParameter(token, &literals)) {
+          result.push_back('$');
+          result.append(std::to_string(literals.size()));
+          continue;
+        }
+        break;
+      }
+      default:
+        break;
+    }
+    result.append(token.text_);
+  }
+
+  if (literals.empty() || !parentheses.empty()) {
+    return false;
+  }
+  *normalized_text = std::move(result);
+  *parameters = std::move(literals);
+  return true;
+}
+
+}  // namespace terrier::trafficcop
@@ -0,0 +1,106 @@
+#include "traffic_cop/result_cursor.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "common/error/exception.h"
+#include "network/connection_context.h"
+#include "network/postgres/postgres_packet_writer.h"
+#include "planner/plannodes/output_schema.h"
+
+namespace terrier::trafficcop {
+
+ResultCursor::ResultCursor(const common::ManagedPointer<network::ConnectionContext> connection_ctx,
+                           QueryRunner run_query, const common::ManagedPointer<planner::OutputSchema> schema,
+                           const std::vector<network::FieldFormat> &field_formats)
+    : connection_ctx_(connection_ctx),
+      run_query_(std::move(run_query)),
+      schema_(schema),
+      field_formats_(field_formats) {
+  connection_ctx_->RegisterCursor(common::ManagedPointer(this));
+}
+
+ResultCursor::~ResultCursor() {
+  Close();
+  connection_ctx_->UnregisterCursor(common::ManagedPointer(this));
+}
+
+std::optional<TrafficCopResult> ResultCursor::Fetch(const common::ManagedPointer<network::PostgresPacketWriter> out,
+                                                    const uint32_t max_rows) {
+  TERRIER_ASSERT(max_rows > 0, "A fetch without a maximum number of rows doesn't need a cursor.");
+  std::unique_lock<std::mutex> lock(latch_);
+  TERRIER_ASSERT(!closed_, "Fetching from a closed cursor.");
+  num_rows_ = 0;
+  if (!done_) {
+    out_ = out;
+    remaining_rows_ = max_rows;
+    if (thread_.joinable()) {
+      cv_.notify_all();
+    } else {
+      thread_ = std::thread([this] { RunQuery(); });
+    }
+    cv_.wait(lock, [&] { return remaining_rows_ == 0 || done_; });
+    out_ = nullptr;
+    if (!done_) return std::nullopt;
+  }
+  if (result_.type_ != ResultType::COMPLETE) return result_;
+  return TrafficCopResult{ResultType::COMPLETE, num_rows_};
+}
+
+void ResultCursor::Close() {
+  {
+    std::unique_lock<std::mutex> lock(latch_);
+    closed_ = true;
+  }
+  cv_.notify_all();
+  if (thread_.joinable()) thread_.join();
+}
+
+void ResultCursor::RunQuery() {
+  TrafficCopResult result;
+  try {
+    result = run_query_([this](byte *const tuples, const uint32_t num_tuples, const uint32_t tuple_size) {
+      WriteRows(tuples, num_tuples, tuple_size);
+    });
+  } catch (const std::exception &e) {
+    // Nothing may escape the thread of the cursor, so anything the query runner didn't handle fails the txn
+    result = Failed(e.what());
+  } catch (...) {
+    result = Failed("Query of the cursor failed.");
+  }
+  {
+    std::unique_lock<std::mutex> lock(latch_);
+    result_ = result;
+    done_ = true;
+  }
+  cv_.notify_all();
+}
+
+TrafficCopResult ResultCursor::Failed(const char *const message) const {
+  connection_ctx_->Transaction()->SetMustAbort();
+  return {ResultType::ERROR,
+          common::ErrorData(common::ErrorSeverity::ERROR, message, common::ErrorCode::ERRCODE_INTERNAL_ERROR)};
+}
+
+void ResultCursor::WriteRows(byte *const tuples, const uint32_t num_tuples, const uint32_t tuple_size) {
+  std::unique_lock<std::mutex> lock(latch_);
+  uint32_t written = 0;
+  while (true) {
+    // The query is held until the next fetch once it produced the rows of the current one, even if this batch is
+    // written out completely, so that it doesn't run while the connection goes on
+    cv_.wait(lock, [&] { return remaining_rows_ > 0 || closed_; });
+    // The query of a closed cursor is cancelled, which tears its pipelines down without failing the txn
+    if (closed_) throw ABORT_EXCEPTION("Cursor closed.");
+    if (written == num_tuples) return;
+    const auto batch_size = std::min(remaining_rows_, num_tuples - written);
+    out_->WriteDataRows(tuples + written * tuple_size, batch_size, tuple_size, schema_->GetColumns(), field_formats_);
+    written += batch_size;
+    remaining_rows_ -= batch_size;
+    num_rows_ += batch_size;
+    if (connection_ctx_->IoWrapper() != nullptr) connection_ctx_->IoWrapper()->ApplyBackPressure();
+    if (remaining_rows_ == 0) cv_.notify_all();
+  }
+}
+
+}  // namespace terrier::trafficcop
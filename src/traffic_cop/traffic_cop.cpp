@@ -1,7 +1,9 @@
 #include "traffic_cop/traffic_cop.h"
 
+#include <algorithm>
 #include <future>  // NOLINT
 #include <memory>
+#include <stdexcept>
 #include <string>
 #include <utility>
 #include <vector>
@@ -10,6 +12,7 @@
 #include "binder/binder_util.h"
 #include "catalog/catalog.h"
 #include "catalog/catalog_accessor.h"
+#include "catalog/postgres/pg_namespace.h"
 #include "common/error/error_data.h"
 #include "common/error/exception.h"
 #include "execution/compiler/compilation_context.h"
@@ -19,12 +22,15 @@
 #include "execution/exec/output.h"
 #include "execution/sql/ddl_executors.h"
 #include "execution/vm/module.h"
+#include "metrics/query_trace.h"
 #include "network/connection_context.h"
+#include "network/network_util.h"
 #include "network/postgres/portal.h"
 #include "network/postgres/postgres_packet_writer.h"
 #include "network/postgres/postgres_protocol_interpreter.h"
 #include "network/postgres/statement.h"
 #include "optimizer/abstract_optimizer.h"
+#include "optimizer/cost_model/stats_cost_model.h"
 #include "optimizer/cost_model/trivial_cost_model.h"
 #include "optimizer/operator_node.h"
 #include "optimizer/optimizer.h"
@@ -32,12 +38,24 @@
 #include "optimizer/property_set.h"
 #include "optimizer/query_to_operator_transformer.h"
 #include "optimizer/statistics/stats_storage.h"
+#include "optimizer/statistics/table_analyzer.h"
+#include "parser/analyze_statement.h"
+#include "parser/copy_statement.h"
 #include "parser/drop_statement.h"
 #include "parser/postgresparser.h"
 #include "parser/variable_set_statement.h"
 #include "planner/plannodes/abstract_plan_node.h"
+#include "planner/plannodes/create_index_plan_node.h"
+#include "planner/plannodes/create_table_plan_node.h"
+#include "planner/plannodes/delete_plan_node.h"
+#include "planner/plannodes/drop_database_plan_node.h"
+#include "planner/plannodes/drop_table_plan_node.h"
+#include "planner/plannodes/insert_plan_node.h"
+#include "planner/plannodes/update_plan_node.h"
 #include "settings/settings_manager.h"
 #include "storage/recovery/replication_log_provider.h"
+#include "traffic_cop/bulk_copy.h"
+#include "traffic_cop/point_query.h"
 #include "traffic_cop/traffic_cop_defs.h"
 #include "traffic_cop/traffic_cop_util.h"
 #include "transaction/transaction_manager.h"
@@ -49,6 +67,43 @@ static void CommitCallback(void *const callback_arg) {
   promise->set_value(true);
 }
 
+// Resolve a table of a statement that isn't bound
+static catalog::table_oid_t ResolveTable(const common::ManagedPointer<catalog::CatalogAccessor> accessor,
+                                         const common::ManagedPointer<parser::TableRef> table_ref) {
+  if (table_ref->GetNamespaceName().empty()) return accessor->GetTableOid(table_ref->GetTableName());
+  const auto ns_oid = accessor->GetNamespaceOid(table_ref->GetNamespaceName());
+  if (ns_oid == catalog::INVALID_NAMESPACE_OID) return catalog::INVALID_TABLE_OID;
+  return accessor->GetTableOid(ns_oid, table_ref->GetTableName());
+}
+
+static common::ErrorData UndefinedTableError(const common::ManagedPointer<parser::TableRef> table_ref) {
+  return common::ErrorData(common::ErrorSeverity::ERROR,
+                           "relation \"" + table_ref->GetTableName() + "\" does not exist",
+                           common::ErrorCode::ERRCODE_UNDEFINED_TABLE);
+}
+
+// Replicas only apply the writes of their primary
+static common::ErrorData ReadOnlyError() {
+  return common::ErrorData(common::ErrorSeverity::ERROR, "cannot modify the database on a read-only replica",
+                           common::ErrorCode::ERRCODE_READ_ONLY_SQL_TRANSACTION);
+}
+
+// Abort the txn after an ExecutionException and turn it into an error for the client
+static TrafficCopResult ExecutionError(const common::ManagedPointer<network::ConnectionContext> connection_ctx,
+                                       const ExecutionException &e) {
+  connection_ctx->Transaction()->SetMustAbort();
+  auto error = common::ErrorData(common::ErrorSeverity::ERROR, e.what(), e.code_);
+  error.AddField(common::ErrorField::LINE, std::to_string(e.GetLine()));
+  error.AddField(common::ErrorField::FILE, e.GetFile());
+  return {ResultType::ERROR, error};
+}
+
+// Span of a step of the request that the connection is processing, recorded if the request is traced
+static metrics::ScopedQueryTraceSpan TraceStep(
+    const metrics::TraceSpan span, const common::ManagedPointer<network::ConnectionContext> connection_ctx) {
+  return {span, connection_ctx->GetConnectionID().UnderlyingValue(), connection_ctx->QueryTraceId()};
+}
+
 void TrafficCop::BeginTransaction(const common::ManagedPointer<network::ConnectionContext> connection_ctx) const {
   TERRIER_ASSERT(connection_ctx->TransactionState() == network::NetworkTransactionStateType::IDLE,
                  "Invalid ConnectionContext state, already in a transaction.");
@@ -58,19 +113,28 @@ void TrafficCop::BeginTransaction(const common::ManagedPointer<network::Connecti
                                                     connection_ctx->GetCatalogCache()));
 }
 
-void TrafficCop::EndTransaction(const common::ManagedPointer<network::ConnectionContext> connection_ctx,
-                                const network::QueryType query_type) const {
+TrafficCopResult TrafficCop::EndTransaction(const common::ManagedPointer<network::ConnectionContext> connection_ctx,
+                                            const network::QueryType query_type) const {
   TERRIER_ASSERT(query_type == network::QueryType::QUERY_COMMIT || query_type == network::QueryType::QUERY_ROLLBACK,
                  "EndTransaction called with invalid QueryType.");
+  // The queries of the cursors that the client didn't fetch completely are cancelled. One of them may still fail the
+  // txn as it stops, which a COMMIT then rolls back.
+  for (const auto cursor : connection_ctx->Cursors()) cursor->Close();
   const auto txn = connection_ctx->Transaction();
-  if (query_type == network::QueryType::QUERY_COMMIT) {
+  const bool committed = query_type == network::QueryType::QUERY_COMMIT && !txn->MustAbort();
+  if (committed) {
     TERRIER_ASSERT(connection_ctx->TransactionState() == network::NetworkTransactionStateType::BLOCK,
                    "Invalid ConnectionContext state, not in a transaction that can be committed.");
     // Set up a blocking callback. Will be invoked when we can tell the client that commit is complete.
     std::promise<bool> promise;
     auto future = promise.get_future();
     TERRIER_ASSERT(future.valid(), "future must be valid for synchronization to work.");
-    txn_manager_->Commit(txn.Get(), CommitCallback, &promise);
+    {
+      const auto span = TraceStep(metrics::TraceSpan::COMMIT, connection_ctx);
+      txn_manager_->Commit(txn.Get(), CommitCallback, &promise);
+    }
+    // The callback is invoked once the log manager serialized the commit record and persisted it
+    const auto span = TraceStep(metrics::TraceSpan::WAL_WAIT, connection_ctx);
     future.wait();
     TERRIER_ASSERT(future.get(), "Got past the wait() without the value being set to true. That's weird.");
   } else {
@@ -80,6 +144,12 @@ void TrafficCop::EndTransaction(const common::ManagedPointer<network::Connection
   }
   connection_ctx->SetTransaction(nullptr);
   connection_ctx->SetAccessor(nullptr);
+  if (!committed && query_type == network::QueryType::QUERY_COMMIT) {
+    return {ResultType::ERROR, common::ErrorData(common::ErrorSeverity::ERROR,
+                                                 "the transaction was rolled back because the query of a cursor failed",
+                                                 common::ErrorCode::ERRCODE_TRANSACTION_ROLLBACK)};
+  }
+  return {ResultType::COMPLETE, 0};
 }
 
 void TrafficCop::HandBufferToReplication(std::unique_ptr<network::ReadBuffer> buffer) {
@@ -87,6 +157,11 @@ void TrafficCop::HandBufferToReplication(std::unique_ptr<network::ReadBuffer> bu
   replication_log_provider_->HandBufferToReplication(std::move(buffer));
 }
 
+void TrafficCop::EndReplication() {
+  TERRIER_ASSERT(replication_log_provider_ != DISABLED, "Should not end replication if no log provider was given");
+  replication_log_provider_->EndReplication();
+}
+
 void TrafficCop::ExecuteTransactionStatement(const common::ManagedPointer<network::ConnectionContext> connection_ctx,
                                              const common::ManagedPointer<network::PostgresPacketWriter> out,
                                              const bool explicit_txn_block,
@@ -116,7 +191,11 @@ void TrafficCop::ExecuteTransactionStatement(const common::ManagedPointer<networ
         out->WriteCommandComplete(network::QueryType::QUERY_ROLLBACK, 0);
         return;
       }
-      EndTransaction(connection_ctx, network::QueryType::QUERY_COMMIT);
+      const auto result = EndTransaction(connection_ctx, network::QueryType::QUERY_COMMIT);
+      if (result.type_ == ResultType::ERROR) {
+        out->WriteError(std::get<common::ErrorData>(result.extra_));
+        return;
+      }
       break;
     }
     case network::QueryType::QUERY_ROLLBACK: {
@@ -140,9 +219,16 @@ std::unique_ptr<planner::AbstractPlanNode> TrafficCop::OptimizeBoundQuery(
   TERRIER_ASSERT(connection_ctx->TransactionState() == network::NetworkTransactionStateType::BLOCK,
                  "Not in a valid txn. This should have been caught before calling this function.");
 
+  const auto span = TraceStep(metrics::TraceSpan::OPTIMIZE, connection_ctx);
+  std::unique_ptr<optimizer::AbstractCostModel> cost_model;
+  if (stats_cost_model_) {
+    cost_model = std::make_unique<optimizer::StatsCostModel>(stats_storage_, connection_ctx->GetDatabaseOid());
+  } else {
+    cost_model = std::make_unique<optimizer::TrivialCostModel>();
+  }
   return TrafficCopUtil::Optimize(connection_ctx->Transaction(), connection_ctx->Accessor(), query,
-                                  connection_ctx->GetDatabaseOid(), stats_storage_,
-                                  std::make_unique<optimizer::TrivialCostModel>(), optimizer_timeout_);
+                                  connection_ctx->GetDatabaseOid(), stats_storage_, std::move(cost_model),
+                                  optimizer_timeout_);
 }
 
 TrafficCopResult TrafficCop::ExecuteSetStatement(common::ManagedPointer<network::ConnectionContext> connection_ctx,
@@ -173,6 +259,150 @@ TrafficCopResult TrafficCop::ExecuteSetStatement(common::ManagedPointer<network:
   return {ResultType::COMPLETE, 0};
 }
 
+TrafficCopResult TrafficCop::ExecuteAnalyzeStatement(
+    const common::ManagedPointer<network::ConnectionContext> connection_ctx,
+    const common::ManagedPointer<network::Statement> statement) const {
+  TERRIER_ASSERT(connection_ctx->TransactionState() == network::NetworkTransactionStateType::BLOCK,
+                 "Not in a valid txn. This should have been caught before calling this function.");
+  TERRIER_ASSERT(statement->GetQueryType() == network::QueryType::QUERY_ANALYZE,
+                 "ExecuteAnalyzeStatement called with invalid QueryType.");
+
+  const auto analyze_stmt = statement->RootStatement().CastManagedPointerTo<parser::AnalyzeStatement>();
+  const auto table_ref = analyze_stmt->GetAnalyzeTable();
+  if (table_ref == nullptr) {
+    connection_ctx->Transaction()->SetMustAbort();
+    return {ResultType::ERROR, common::ErrorData(common::ErrorSeverity::ERROR, "ANALYZE requires a table name",
+                                                 common::ErrorCode::ERRCODE_FEATURE_NOT_SUPPORTED)};
+  }
+
+  // ANALYZE isn't bound, resolve the table and columns here
+  const auto accessor = connection_ctx->Accessor();
+  const auto table_oid = ResolveTable(accessor, table_ref);
+  if (table_oid == catalog::INVALID_TABLE_OID) {
+    connection_ctx->Transaction()->SetMustAbort();
+    return {ResultType::ERROR, UndefinedTableError(table_ref)};
+  }
+
+  const auto &schema = accessor->GetSchema(table_oid);
+  std::vector<catalog::col_oid_t> col_oids;
+  const auto columns = analyze_stmt->GetColumns();
+  if (columns == nullptr || columns->empty()) {
+    for (const auto &column : schema.GetColumns()) col_oids.emplace_back(column.Oid());
+  } else {
+    for (const auto &name : *columns) {
+      catalog::col_oid_t col_oid;
+      try {
+        col_oid = schema.GetColumn(name).Oid();
+      } catch (const std::out_of_range &e) {
+        connection_ctx->Transaction()->SetMustAbort();
+        return {ResultType::ERROR, common::ErrorData(common::ErrorSeverity::ERROR,
+                                                     "column \"" + name + "\" of relation \"" +
+                                                         table_ref->GetTableName() + "\" does not exist",
+                                                     common::ErrorCode::ERRCODE_UNDEFINED_COLUMN)};
+      }
+      if (std::find(col_oids.begin(), col_oids.end(), col_oid) == col_oids.end()) col_oids.emplace_back(col_oid);
+    }
+  }
+
+  AnalyzeTable(connection_ctx->Transaction(), accessor, connection_ctx->GetDatabaseOid(), table_oid,
+               std::move(col_oids));
+  return {ResultType::COMPLETE, 0};
+}
+
+TrafficCopResult TrafficCop::ExecuteCopyStatement(
+    const common::ManagedPointer<network::ConnectionContext> connection_ctx,
+    const common::ManagedPointer<network::PostgresPacketWriter> out,
+    const common::ManagedPointer<network::Statement> statement, std::unique_ptr<CopyIn> *const copy_in) const {
+  TERRIER_ASSERT(connection_ctx->TransactionState() == network::NetworkTransactionStateType::BLOCK,
+                 "Not in a valid txn. This should have been caught before calling this function.");
+  TERRIER_ASSERT(statement->GetQueryType() == network::QueryType::QUERY_COPY,
+                 "ExecuteCopyStatement called with invalid QueryType.");
+
+  const auto copy_stmt = statement->RootStatement().CastManagedPointerTo<parser::CopyStatement>();
+  const auto table_ref = copy_stmt->GetCopyTable();
+  if (table_ref == nullptr || !copy_stmt->GetFilePath().empty()) {
+    connection_ctx->Transaction()->SetMustAbort();
+    return {ResultType::ERROR,
+            common::ErrorData(common::ErrorSeverity::ERROR, "COPY only supports tables FROM STDIN and TO STDOUT",
+                              common::ErrorCode::ERRCODE_FEATURE_NOT_SUPPORTED)};
+  }
+
+  // COPY isn't bound either
+  const auto accessor = connection_ctx->Accessor();
+  const auto table_oid = ResolveTable(accessor, table_ref);
+  if (table_oid == catalog::INVALID_TABLE_OID) {
+    connection_ctx->Transaction()->SetMustAbort();
+    return {ResultType::ERROR, UndefinedTableError(table_ref)};
+  }
+
+  if (ReadOnly() && copy_stmt->IsFrom()) {
+    connection_ctx->Transaction()->SetMustAbort();
+    return {ResultType::ERROR, ReadOnlyError()};
+  }
+
+  const CopyFormat format{copy_stmt->GetExternalFileFormat(), copy_stmt->GetDelimiter(), copy_stmt->GetQuoteChar(),
+                          copy_stmt->GetEscapeChar()};
+  try {
+    if (copy_stmt->IsFrom()) {
+      *copy_in = std::make_unique<CopyIn>(connection_ctx->Transaction(), connection_ctx->GetDatabaseOid(), table_oid,
+                                          accessor->GetTable(table_oid), accessor->GetSchema(table_oid),
+                                          accessor->GetIndexes(table_oid), format);
+      return {ResultType::QUEUING, 0};
+    }
+    const CopyOut copy_out(connection_ctx->Transaction(), accessor->GetTable(table_oid),
+                           accessor->GetSchema(table_oid), format);
+    return {ResultType::COMPLETE, static_cast<uint32_t>(copy_out.Write(out, connection_ctx->IoWrapper()))};
+  } catch (ExecutionException &e) {
+    return ExecutionError(connection_ctx, e);
+  }
+}
+
+TrafficCopResult TrafficCop::CopyInData(const common::ManagedPointer<network::ConnectionContext> connection_ctx,
+                                        const common::ManagedPointer<CopyIn> copy_in,
+                                        const std::string_view data) const {
+  try {
+    copy_in->Consume(data);
+  } catch (ExecutionException &e) {
+    return ExecutionError(connection_ctx, e);
+  }
+  return {ResultType::QUEUING, 0};
+}
+
+TrafficCopResult TrafficCop::EndCopyIn(const common::ManagedPointer<network::ConnectionContext> connection_ctx,
+                                       const common::ManagedPointer<CopyIn> copy_in) const {
+  uint64_t num_rows;
+  try {
+    num_rows = copy_in->Finish();
+  } catch (ExecutionException &e) {
+    return ExecutionError(connection_ctx, e);
+  }
+  CountModifiedRows(connection_ctx, copy_in->GetTableOid(), num_rows);
+  return {ResultType::COMPLETE, static_cast<uint32_t>(num_rows)};
+}
+
+void TrafficCop::AnalyzeTable(const common::ManagedPointer<transaction::TransactionContext> txn,
+                              const common::ManagedPointer<catalog::CatalogAccessor> accessor,
+                              const catalog::db_oid_t db_oid, const catalog::table_oid_t table_oid,
+                              std::vector<catalog::col_oid_t> col_oids) const {
+  optimizer::TableAnalyzer analyzer(db_oid, table_oid, accessor->GetTable(table_oid), accessor->GetSchema(table_oid),
+                                    std::move(col_oids), analyze_sample_blocks_);
+  stats_storage_->UpdateTableStats(db_oid, table_oid, analyzer.Analyze(txn), txn.Get());
+}
+
+void TrafficCop::CountModifiedRows(const common::ManagedPointer<network::ConnectionContext> connection_ctx,
+                                   const catalog::table_oid_t table_oid, const uint64_t num_rows) const {
+  if (auto_analyze_threshold_ == 0 || table_oid == catalog::INVALID_TABLE_OID || num_rows == 0) return;
+  const auto db_oid = connection_ctx->GetDatabaseOid();
+  if (stats_storage_->AddModifiedRows(db_oid, table_oid, num_rows, auto_analyze_threshold_)) {
+    // The table exists in this txn, which just modified it. The stats include its uncommitted changes, and are stored
+    // only if it commits
+    const auto &schema = connection_ctx->Accessor()->GetSchema(table_oid);
+    std::vector<catalog::col_oid_t> col_oids;
+    for (const auto &column : schema.GetColumns()) col_oids.emplace_back(column.Oid());
+    AnalyzeTable(connection_ctx->Transaction(), connection_ctx->Accessor(), db_oid, table_oid, std::move(col_oids));
+  }
+}
+
 TrafficCopResult TrafficCop::ExecuteCreateStatement(
     const common::ManagedPointer<network::ConnectionContext> connection_ctx,
     const common::ManagedPointer<planner::AbstractPlanNode> physical_plan,
@@ -184,11 +414,16 @@ TrafficCopResult TrafficCop::ExecuteCreateStatement(
           query_type == network::QueryType::QUERY_CREATE_INDEX || query_type == network::QueryType::QUERY_CREATE_DB ||
           query_type == network::QueryType::QUERY_CREATE_VIEW || query_type == network::QueryType::QUERY_CREATE_TRIGGER,
       "ExecuteCreateStatement called with invalid QueryType.");
+  connection_ctx->SetTransactionChangedCatalog();
   switch (query_type) {
     case network::QueryType::QUERY_CREATE_TABLE: {
-      if (execution::sql::DDLExecutors::CreateTableExecutor(
-              physical_plan.CastManagedPointerTo<planner::CreateTablePlanNode>(), connection_ctx->Accessor(),
-              connection_ctx->GetDatabaseOid())) {
+      const auto create_table_plan = physical_plan.CastManagedPointerTo<planner::CreateTablePlanNode>();
+      if (execution::sql::DDLExecutors::CreateTableExecutor(create_table_plan, connection_ctx->Accessor(),
+                                                            connection_ctx->GetDatabaseOid())) {
+        // no plan depends on the new table yet, but none may be published until it's committed or aborted
+        InvalidateCachedPlans(connection_ctx, connection_ctx->GetDatabaseOid(),
+                              connection_ctx->Accessor()->GetTableOid(create_table_plan->GetNamespaceOid(),
+                                                                      create_table_plan->GetTableName()));
         return {ResultType::COMPLETE, 0};
       }
       break;
@@ -201,8 +436,10 @@ TrafficCopResult TrafficCop::ExecuteCreateStatement(
       break;
     }
     case network::QueryType::QUERY_CREATE_INDEX: {
-      if (execution::sql::DDLExecutors::CreateIndexExecutor(
-              physical_plan.CastManagedPointerTo<planner::CreateIndexPlanNode>(), connection_ctx->Accessor())) {
+      const auto create_index_plan = physical_plan.CastManagedPointerTo<planner::CreateIndexPlanNode>();
+      if (execution::sql::DDLExecutors::CreateIndexExecutor(create_index_plan, connection_ctx->Accessor())) {
+        // plans may now use the index, and inserts and updates must maintain it
+        InvalidateCachedPlans(connection_ctx, connection_ctx->GetDatabaseOid(), create_index_plan->GetTableOid());
         return {ResultType::COMPLETE, 0};
       }
       break;
@@ -238,18 +475,21 @@ TrafficCopResult TrafficCop::ExecuteDropStatement(
           query_type == network::QueryType::QUERY_DROP_INDEX || query_type == network::QueryType::QUERY_DROP_DB ||
           query_type == network::QueryType::QUERY_DROP_VIEW || query_type == network::QueryType::QUERY_DROP_TRIGGER,
       "ExecuteDropStatement called with invalid QueryType.");
+  connection_ctx->SetTransactionChangedCatalog();
   switch (query_type) {
     case network::QueryType::QUERY_DROP_TABLE: {
-      if (execution::sql::DDLExecutors::DropTableExecutor(
-              physical_plan.CastManagedPointerTo<planner::DropTablePlanNode>(), connection_ctx->Accessor())) {
+      const auto drop_table_plan = physical_plan.CastManagedPointerTo<planner::DropTablePlanNode>();
+      if (execution::sql::DDLExecutors::DropTableExecutor(drop_table_plan, connection_ctx->Accessor())) {
+        InvalidateCachedPlans(connection_ctx, connection_ctx->GetDatabaseOid(), drop_table_plan->GetTableOid());
         return {ResultType::COMPLETE, 0};
       }
       break;
     }
     case network::QueryType::QUERY_DROP_DB: {
-      if (execution::sql::DDLExecutors::DropDatabaseExecutor(
-              physical_plan.CastManagedPointerTo<planner::DropDatabasePlanNode>(), connection_ctx->Accessor(),
-              connection_ctx->GetDatabaseOid())) {
+      const auto drop_db_plan = physical_plan.CastManagedPointerTo<planner::DropDatabasePlanNode>();
+      if (execution::sql::DDLExecutors::DropDatabaseExecutor(drop_db_plan, connection_ctx->Accessor(),
+                                                             connection_ctx->GetDatabaseOid())) {
+        InvalidateCachedPlans(connection_ctx, drop_db_plan->GetDatabaseOid(), catalog::INVALID_TABLE_OID);
         return {ResultType::COMPLETE, 0};
       }
       break;
@@ -257,6 +497,8 @@ TrafficCopResult TrafficCop::ExecuteDropStatement(
     case network::QueryType::QUERY_DROP_INDEX: {
       if (execution::sql::DDLExecutors::DropIndexExecutor(
               physical_plan.CastManagedPointerTo<planner::DropIndexPlanNode>(), connection_ctx->Accessor())) {
+        // plans don't track the indexes they maintain, so invalidate all of them
+        InvalidateCachedPlans(connection_ctx, connection_ctx->GetDatabaseOid(), catalog::INVALID_TABLE_OID);
         return {ResultType::COMPLETE, 0};
       }
       break;
@@ -264,6 +506,7 @@ TrafficCopResult TrafficCop::ExecuteDropStatement(
     case network::QueryType::QUERY_DROP_SCHEMA: {
       if (execution::sql::DDLExecutors::DropNamespaceExecutor(
               physical_plan.CastManagedPointerTo<planner::DropNamespacePlanNode>(), connection_ctx->Accessor())) {
+        InvalidateCachedPlans(connection_ctx, connection_ctx->GetDatabaseOid(), catalog::INVALID_TABLE_OID);
         return {ResultType::COMPLETE, 0};
       }
       break;
@@ -281,8 +524,36 @@ TrafficCopResult TrafficCop::ExecuteDropStatement(
                                                common::ErrorCode::ERRCODE_DATA_EXCEPTION)};
 }
 
+void TrafficCop::InvalidateCachedPlans(const common::ManagedPointer<network::ConnectionContext> connection_ctx,
+                                       const catalog::db_oid_t db_oid, const catalog::table_oid_t table_oid) const {
+  if (plan_cache_ == nullptr) return;
+  // The plans are invalidated right away, so that later statements of this txn don't use them, and again when the txn
+  // ends, because concurrent txns may have planned against the old catalog in the meantime.
+  plan_cache_->BeginInvalidation(db_oid, table_oid);
+  const auto end_invalidation = [plan_cache = common::ManagedPointer(plan_cache_), db_oid, table_oid] {
+    plan_cache->EndInvalidation(db_oid, table_oid);
+  };
+  connection_ctx->Transaction()->RegisterCommitAction(end_invalidation);
+  connection_ctx->Transaction()->RegisterAbortAction(end_invalidation);
+}
+
+bool TrafficCop::UsePlanCache(const common::ManagedPointer<network::ConnectionContext> connection_ctx) const {
+  // plans built by a txn that ran DDL may depend on its uncommitted changes, and a txn that ran DDL doesn't see the
+  // catalog that other connections planned against. A replica doesn't invalidate plans when it replays DDL.
+  return plan_cache_ != nullptr && !connection_ctx->TransactionChangedCatalog() && !ReadOnly();
+}
+
+bool TrafficCop::TablesVisible(const common::ManagedPointer<network::ConnectionContext> connection_ctx,
+                               const CachedPlan &cached_plan) {
+  // the plan skips binding, so check that the tables it was planned against still exist for this txn
+  const auto accessor = connection_ctx->Accessor();
+  return std::all_of(cached_plan.GetTableOids().cbegin(), cached_plan.GetTableOids().cend(),
+                     [=](const catalog::table_oid_t table_oid) { return accessor->GetTable(table_oid) != nullptr; });
+}
+
 std::variant<std::unique_ptr<parser::ParseResult>, common::ErrorData> TrafficCop::ParseQuery(
     const std::string &query, const common::ManagedPointer<network::ConnectionContext> connection_ctx) const {
+  const auto span = TraceStep(metrics::TraceSpan::PARSE, connection_ctx);
   std::variant<std::unique_ptr<parser::ParseResult>, common::ErrorData> result;
   try {
     auto parse_result = parser::PostgresParser::BuildParseTree(query);
@@ -303,8 +574,32 @@ TrafficCopResult TrafficCop::BindQuery(
   TERRIER_ASSERT(connection_ctx->TransactionState() == network::NetworkTransactionStateType::BLOCK,
                  "Not in a valid txn. This should have been caught before calling this function.");
 
+  if (ReadOnly() && statement->GetQueryType() != network::QueryType::QUERY_SELECT) {
+    return {ResultType::ERROR, ReadOnlyError()};
+  }
+
+  const auto span = TraceStep(metrics::TraceSpan::BIND, connection_ctx);
+  if (statement->GetCachedPlan() != nullptr && !statement->GetCachedPlan()->IsValid()) {
+    // a DDL change invalidated the shared plan, start over
+    statement->ClearCachedObjects();
+  }
+
+  if (statement->PhysicalPlan() == nullptr && statement->GetPointQuery() == nullptr && UsePlanCache(connection_ctx) &&
+      network::NetworkUtil::DMLQueryType(statement->GetQueryType())) {
+    // another statement with the same text may already have been planned and compiled
+    const auto num_params = parameters == nullptr ? 0 : parameters->size();
+    auto cached_plan =
+        plan_cache_->Lookup(connection_ctx->GetDatabaseOid(), statement->GetQueryText(), statement->ParamTypes());
+    if (cached_plan != nullptr && cached_plan->GetDesiredParamTypes().size() == num_params &&
+        TablesVisible(connection_ctx, *cached_plan)) {
+      statement->SetCachedPlan(std::move(cached_plan));
+    } else {
+      statement->SetPlanCacheGeneration(plan_cache_->GetGeneration());
+    }
+  }
+
   try {
-    if (statement->PhysicalPlan() == nullptr || !UseQueryCache()) {
+    if ((statement->PhysicalPlan() == nullptr && statement->GetPointQuery() == nullptr) || !UseQueryCache()) {
       // it's not cached, bind it
       binder::BindNodeVisitor visitor(connection_ctx->Accessor(), connection_ctx->GetDatabaseOid());
       if (parameters != nullptr && !parameters->empty()) {
@@ -315,7 +610,22 @@ TrafficCopResult TrafficCop::BindQuery(
       } else {
         visitor.BindNameToNode(statement->ParseResult(), nullptr, nullptr);
       }
-    } else {
+
+      if (point_query_fast_path_ && !ReadOnly() && network::NetworkUtil::DMLQueryType(statement->GetQueryType())) {
+        // single-row lookups and updates by unique key skip optimization and code generation. A replica doesn't use
+        // them, since they keep pointers to the tables across txns and the DDL it replays may drop them.
+        std::shared_ptr<PointQuery> point_query =
+            PointQuery::Create(connection_ctx->Accessor(), statement->RootStatement());
+        if (point_query != nullptr && UsePlanCache(connection_ctx) && statement->GetCachedPlan() == nullptr) {
+          auto cached_plan = std::make_shared<CachedPlan>(point_query, statement->GetDesiredParamTypes());
+          if (plan_cache_->Insert(connection_ctx->GetDatabaseOid(), statement->GetQueryText(), statement->ParamTypes(),
+                                  cached_plan, statement->GetPlanCacheGeneration())) {
+            statement->SetCachedPlan(std::move(cached_plan));
+          }
+        }
+        statement->SetPointQuery(std::move(point_query));
+      }
+    } else if (parameters != nullptr) {
       // it's cached. use the desired_param_types to fast-path the binding
       binder::BinderUtil::PromoteParameters(parameters, statement->GetDesiredParamTypes());
     }
@@ -344,18 +654,19 @@ TrafficCopResult TrafficCop::CodegenPhysicalPlan(
     const common::ManagedPointer<network::Portal> portal) const {
   TERRIER_ASSERT(connection_ctx->TransactionState() == network::NetworkTransactionStateType::BLOCK,
                  "Not in a valid txn. This should have been caught before calling this function.");
-  const auto query_type UNUSED_ATTRIBUTE = portal->GetStatement()->GetQueryType();
+  const auto query_type = portal->GetStatement()->GetQueryType();
   const auto physical_plan = portal->PhysicalPlan();
   TERRIER_ASSERT(query_type == network::QueryType::QUERY_SELECT || query_type == network::QueryType::QUERY_INSERT ||
                      query_type == network::QueryType::QUERY_CREATE_INDEX ||
                      query_type == network::QueryType::QUERY_UPDATE || query_type == network::QueryType::QUERY_DELETE,
                  "CodegenAndRunPhysicalPlan called with invalid QueryType.");
 
-  if (portal->GetStatement()->GetExecutableQuery() != nullptr && use_query_cache_) {
+  if (portal->GetStatement()->GetExecutableQuery() != nullptr && UseQueryCache()) {
     // We've already codegen'd this, move on...
     return {ResultType::COMPLETE, 0};
   }
 
+  const auto span = TraceStep(metrics::TraceSpan::COMPILE, connection_ctx);
   // TODO(WAN): see #1047
   execution::exec::ExecutionSettings exec_settings{};
   auto exec_query = execution::compiler::CompilationContext::Compile(
@@ -364,11 +675,77 @@ TrafficCopResult TrafficCop::CodegenPhysicalPlan(
       common::ManagedPointer<const std::string>(&portal->GetStatement()->GetQueryText()));
 
   // TODO(Matt): handle code generation failing
-  portal->GetStatement()->SetExecutableQuery(std::move(exec_query));
+  const auto statement = portal->GetStatement();
+  statement->SetExecutableQuery(std::move(exec_query));
+
+  if (UseQueryCache() && UsePlanCache(connection_ctx) && statement->GetCachedPlan() == nullptr &&
+      query_type != network::QueryType::QUERY_CREATE_INDEX) {
+    // share the plan and the generated code with all other statements of the same text
+    auto cached_plan = std::make_shared<CachedPlan>(statement->SharedPhysicalPlan(), statement->SharedExecutableQuery(),
+                                                    statement->GetDesiredParamTypes());
+    if (plan_cache_->Insert(connection_ctx->GetDatabaseOid(), statement->GetQueryText(), statement->ParamTypes(),
+                            cached_plan, statement->GetPlanCacheGeneration())) {
+      statement->SetCachedPlan(std::move(cached_plan));
+    }
+  }
 
   return {ResultType::COMPLETE, 0};
 }
 
+std::unique_ptr<ResultCursor> TrafficCop::OpenCursor(
+    const common::ManagedPointer<network::ConnectionContext> connection_ctx,
+    const common::ManagedPointer<network::Portal> portal) const {
+  TERRIER_ASSERT(connection_ctx->TransactionState() == network::NetworkTransactionStateType::BLOCK,
+                 "Not in a valid txn. This should have been caught before calling this function.");
+  TERRIER_ASSERT(portal->GetStatement()->GetQueryType() == network::QueryType::QUERY_SELECT,
+                 "Only the rows of a SELECT are fetched from a cursor.");
+  // The cursor keeps the plan and the generated code, which a later Bind or Execute of the statement may replace
+  const auto physical_plan = portal->GetStatement()->SharedPhysicalPlan();
+  const auto exec_query = portal->GetStatement()->SharedExecutableQuery();
+  const auto execution_mode = QueryExecutionMode();
+  execution::exec::ExecutionSettings exec_settings{};
+  exec_settings.SetOutputBatchSize(output_batch_size_);
+
+  auto run_query = [=](const execution::exec::OutputCallback &callback) -> TrafficCopResult {
+    execution::exec::ExecutionContext exec_ctx(connection_ctx->GetDatabaseOid(), connection_ctx->Transaction(),
+                                               callback, physical_plan->GetOutputSchema().Get(),
+                                               connection_ctx->Accessor(), exec_settings);
+    exec_ctx.SetParams(portal->Parameters());
+    try {
+      exec_query->Run(common::ManagedPointer(&exec_ctx), execution_mode);
+    } catch (ExecutionException &e) {
+      return ExecutionError(connection_ctx, e);
+    }
+    if (connection_ctx->TransactionState() == network::NetworkTransactionStateType::BLOCK) {
+      // The cursor counts the rows of each fetch
+      return {ResultType::COMPLETE, 0};
+    }
+    return {ResultType::ERROR, common::ErrorData(common::ErrorSeverity::ERROR, "Query failed.",
+                                                 common::ErrorCode::ERRCODE_T_R_SERIALIZATION_FAILURE)};
+  };
+  return std::make_unique<ResultCursor>(connection_ctx, std::move(run_query), physical_plan->GetOutputSchema(),
+                                        portal->ResultFormats());
+}
+
+TrafficCopResult TrafficCop::RunPointQuery(const common::ManagedPointer<network::ConnectionContext> connection_ctx,
+                                           const common::ManagedPointer<network::PostgresPacketWriter> out,
+                                           const common::ManagedPointer<network::Portal> portal) const {
+  TERRIER_ASSERT(connection_ctx->TransactionState() == network::NetworkTransactionStateType::BLOCK,
+                 "Not in a valid txn. This should have been caught before calling this function.");
+  const auto point_query = portal->GetStatement()->GetPointQuery();
+  TERRIER_ASSERT(point_query != nullptr, "RunPointQuery called for a statement that isn't a point query.");
+  const auto span = TraceStep(metrics::TraceSpan::EXECUTE, connection_ctx);
+
+  auto result = point_query->Execute(connection_ctx->Transaction(), connection_ctx->Accessor(),
+                                     connection_ctx->GetDatabaseOid(), *portal->Parameters(), out,
+                                     portal->ResultFormats());
+  const auto query_type = portal->GetStatement()->GetQueryType();
+  if (result.type_ == ResultType::COMPLETE && query_type != network::QueryType::QUERY_SELECT) {
+    CountModifiedRows(connection_ctx, point_query->GetTableOid(), std::get<uint32_t>(result.extra_));
+  }
+  return result;
+}
+
 TrafficCopResult TrafficCop::RunExecutableQuery(const common::ManagedPointer<network::ConnectionContext> connection_ctx,
                                                 const common::ManagedPointer<network::PostgresPacketWriter> out,
                                                 const common::ManagedPointer<network::Portal> portal) const {
@@ -380,19 +757,41 @@ TrafficCopResult TrafficCop::RunExecutableQuery(const common::ManagedPointer<net
                      query_type == network::QueryType::QUERY_CREATE_INDEX ||
                      query_type == network::QueryType::QUERY_UPDATE || query_type == network::QueryType::QUERY_DELETE,
                  "CodegenAndRunPhysicalPlan called with invalid QueryType.");
-  execution::exec::OutputWriter writer(physical_plan->GetOutputSchema(), out, portal->ResultFormats());
+  execution::exec::OutputWriter writer(physical_plan->GetOutputSchema(), out, portal->ResultFormats(),
+                                       connection_ctx->IoWrapper());
 
   execution::exec::ExecutionSettings exec_settings{};
-  auto exec_ctx = std::make_unique<execution::exec::ExecutionContext>(
-      connection_ctx->GetDatabaseOid(), connection_ctx->Transaction(), writer, physical_plan->GetOutputSchema().Get(),
-      connection_ctx->Accessor(), exec_settings);
+  exec_settings.SetOutputBatchSize(output_batch_size_);
+  std::unique_ptr<execution::exec::ExecutionContext> own_exec_ctx;
+  common::ManagedPointer<execution::exec::ExecutionContext> exec_ctx;
+  if (query_type == network::QueryType::QUERY_INSERT) {
+    // An INSERT has no output, so its execution context doesn't refer to this execution and is kept in the portal for
+    // the next execution in this txn
+    exec_ctx = portal->GetExecutionContext(connection_ctx->Transaction());
+    if (exec_ctx == nullptr) {
+      auto &portal_exec_settings = portal->GetExecutionSettings();
+      portal_exec_settings = exec_settings;
+      portal->SetExecutionContext(std::make_unique<execution::exec::ExecutionContext>(
+          connection_ctx->GetDatabaseOid(), connection_ctx->Transaction(), execution::exec::NoOpResultConsumer(),
+          physical_plan->GetOutputSchema().Get(), connection_ctx->Accessor(), portal_exec_settings));
+      exec_ctx = portal->GetExecutionContext(connection_ctx->Transaction());
+    }
+    exec_ctx->RowsAffected() = 0;
+  } else {
+    own_exec_ctx = std::make_unique<execution::exec::ExecutionContext>(
+        connection_ctx->GetDatabaseOid(), connection_ctx->Transaction(), writer, physical_plan->GetOutputSchema().Get(),
+        connection_ctx->Accessor(), exec_settings);
+    exec_ctx = common::ManagedPointer(own_exec_ctx);
+  }
 
   exec_ctx->SetParams(portal->Parameters());
+  exec_ctx->SetQueryTrace(connection_ctx->GetConnectionID().UnderlyingValue(), connection_ctx->QueryTraceId());
 
   const auto exec_query = portal->GetStatement()->GetExecutableQuery();
+  const auto span = TraceStep(metrics::TraceSpan::EXECUTE, connection_ctx);
 
   try {
-    exec_query->Run(common::ManagedPointer(exec_ctx), execution_mode_);
+    exec_query->Run(exec_ctx, QueryExecutionMode());
   } catch (ExecutionException &e) {
     /*
      * An ExecutionException is thrown in the case of some failure caused by a software bug or caused by some data
@@ -415,6 +814,21 @@ TrafficCopResult TrafficCop::RunExecutableQuery(const common::ManagedPointer<net
     }
     // Other queries (INSERT, UPDATE, DELETE) retrieve rows affected from the execution context since other queries
     // might not have any output otherwise
+    auto table_oid = catalog::INVALID_TABLE_OID;
+    switch (physical_plan->GetPlanNodeType()) {
+      case planner::PlanNodeType::INSERT:
+        table_oid = physical_plan.CastManagedPointerTo<planner::InsertPlanNode>()->GetTableOid();
+        break;
+      case planner::PlanNodeType::UPDATE:
+        table_oid = physical_plan.CastManagedPointerTo<planner::UpdatePlanNode>()->GetTableOid();
+        break;
+      case planner::PlanNodeType::DELETE:
+        table_oid = physical_plan.CastManagedPointerTo<planner::DeletePlanNode>()->GetTableOid();
+        break;
+      default:
+        break;
+    }
+    CountModifiedRows(connection_ctx, table_oid, exec_ctx->RowsAffected());
     return {ResultType::COMPLETE, exec_ctx->RowsAffected()};
   }
 
@@ -424,34 +838,48 @@ TrafficCopResult TrafficCop::RunExecutableQuery(const common::ManagedPointer<net
                                                common::ErrorCode::ERRCODE_T_R_SERIALIZATION_FAILURE)};
 }
 
-std::pair<catalog::db_oid_t, catalog::namespace_oid_t> TrafficCop::CreateTempNamespace(
-    const network::connection_id_t connection_id, const std::string &database_name) {
+catalog::db_oid_t TrafficCop::GetDatabaseOid(const std::string &database_name) {
   auto *const txn = txn_manager_->BeginTransaction();
   const auto db_oid = catalog_->GetDatabaseOid(common::ManagedPointer(txn), database_name);
+  txn_manager_->Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+  return db_oid;
+}
 
-  if (db_oid == catalog::INVALID_DATABASE_OID) {
-    // Invalid database name
-    txn_manager_->Abort(txn);
-    return {catalog::INVALID_DATABASE_OID, catalog::INVALID_NAMESPACE_OID};
-  }
+catalog::namespace_oid_t TrafficCop::CreateTempNamespace(const network::connection_id_t connection_id,
+                                                         const catalog::db_oid_t db_oid) {
+  TERRIER_ASSERT(db_oid != catalog::INVALID_DATABASE_OID, "Called CreateTempNamespace() with an invalid database oid.");
+  // Creating a namespace would take an oid that the primary hands out as well
+  if (ReadOnly()) return catalog::postgres::NAMESPACE_DEFAULT_NAMESPACE_OID;
 
+  auto *const txn = txn_manager_->BeginTransaction();
   const auto ns_oid =
       catalog_->GetAccessor(common::ManagedPointer(txn), db_oid, DISABLED)
           ->CreateNamespace(std::string(TEMP_NAMESPACE_PREFIX) + std::to_string(connection_id.UnderlyingValue()));
   if (ns_oid == catalog::INVALID_NAMESPACE_OID) {
     // Failed to create new namespace. Could be a concurrent DDL change and worth retrying
     txn_manager_->Abort(txn);
-    return {db_oid, catalog::INVALID_NAMESPACE_OID};
+    return catalog::INVALID_NAMESPACE_OID;
   }
 
   // Success
   txn_manager_->Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
-  return {db_oid, ns_oid};
+  return ns_oid;
+}
+
+catalog::namespace_oid_t TrafficCop::GetTempNamespace(
+    const common::ManagedPointer<network::ConnectionContext> connection_ctx) {
+  if (connection_ctx->GetTempNamespaceOid() == catalog::INVALID_NAMESPACE_OID) {
+    connection_ctx->SetTempNamespaceOid(
+        CreateTempNamespace(connection_ctx->GetConnectionID(), connection_ctx->GetDatabaseOid()));
+  }
+  return connection_ctx->GetTempNamespaceOid();
 }
 
 bool TrafficCop::DropTempNamespace(const catalog::db_oid_t db_oid, const catalog::namespace_oid_t ns_oid) {
   TERRIER_ASSERT(db_oid != catalog::INVALID_DATABASE_OID, "Called DropTempNamespace() with an invalid database oid.");
   TERRIER_ASSERT(ns_oid != catalog::INVALID_NAMESPACE_OID, "Called DropTempNamespace() with an invalid namespace oid.");
+  // Connections to a replica share the default namespace
+  if (ReadOnly()) return true;
   auto *const txn = txn_manager_->BeginTransaction();
   const auto db_accessor = catalog_->GetAccessor(common::ManagedPointer(txn), db_oid, DISABLED);
 
@@ -1,8 +1,10 @@
 #include "execution/compiler/compiler.h"
 
+#include <array>
 #include <functional>
 #include <limits>
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
@@ -33,12 +35,14 @@
 #include "planner/plannodes/index_scan_plan_node.h"
 #include "planner/plannodes/insert_plan_node.h"
 #include "planner/plannodes/limit_plan_node.h"
+#include "planner/plannodes/merge_join_plan_node.h"
 #include "planner/plannodes/nested_loop_join_plan_node.h"
 #include "planner/plannodes/order_by_plan_node.h"
 #include "planner/plannodes/output_schema.h"
 #include "planner/plannodes/projection_plan_node.h"
 #include "planner/plannodes/seq_scan_plan_node.h"
 #include "planner/plannodes/update_plan_node.h"
+#include "planner/plannodes/window_plan_node.h"
 #include "type/type_id.h"
 
 namespace terrier::execution::compiler::test {
@@ -1378,6 +1382,122 @@ TEST_F(CompilerTest, StaticAggregateHavingTest) {
   multi_checker.CheckCorrectness();
 }
 
+// NOLINTNEXTLINE
+TEST_F(CompilerTest, SortAggregateTest) {
+  // SELECT col2, SUM(col1), COUNT(col1) FROM (SELECT * FROM test_1 WHERE col1 < 1000 ORDER BY col2) GROUP BY col2;
+  // The input is sorted on the grouping key, so the aggregation is sort-based.
+  // Get accessor
+  auto accessor = MakeAccessor();
+  ExpressionMaker expr_maker;
+  auto table_oid = accessor->GetTableOid(NSOid(), "test_1");
+  auto table_schema = accessor->GetSchema(table_oid);
+  std::unique_ptr<planner::AbstractPlanNode> seq_scan;
+  OutputSchemaHelper seq_scan_out{0, &expr_maker};
+  {
+    // OIDs
+    auto cola_oid = table_schema.GetColumn("colA").Oid();
+    auto colb_oid = table_schema.GetColumn("colB").Oid();
+    // Get Table columns
+    auto col1 = expr_maker.CVE(cola_oid, type::TypeId::INTEGER);
+    auto col2 = expr_maker.CVE(colb_oid, type::TypeId::INTEGER);
+    seq_scan_out.AddOutput("col1", col1);
+    seq_scan_out.AddOutput("col2", col2);
+    auto schema = seq_scan_out.MakeSchema();
+    // Make predicate
+    auto predicate = expr_maker.ComparisonLt(col1, expr_maker.Constant(1000));
+    // Build
+    planner::SeqScanPlanNode::Builder builder;
+    seq_scan = builder.SetOutputSchema(std::move(schema))
+                   .SetColumnOids({cola_oid, colb_oid})
+                   .SetScanPredicate(predicate)
+                   .SetIsForUpdateFlag(false)
+                   .SetTableOid(table_oid)
+                   .Build();
+  }
+  // Order By
+  std::unique_ptr<planner::AbstractPlanNode> order_by;
+  OutputSchemaHelper order_by_out{0, &expr_maker};
+  {
+    auto col1 = seq_scan_out.GetOutput("col1");
+    auto col2 = seq_scan_out.GetOutput("col2");
+    order_by_out.AddOutput("col1", col1);
+    order_by_out.AddOutput("col2", col2);
+    auto schema = order_by_out.MakeSchema();
+    // Build
+    planner::OrderByPlanNode::Builder builder;
+    order_by = builder.SetOutputSchema(std::move(schema))
+                   .AddChild(std::move(seq_scan))
+                   .AddSortKey(col2, optimizer::OrderByOrderingType::ASC)
+                   .Build();
+  }
+  // Make the aggregate
+  std::unique_ptr<planner::AbstractPlanNode> agg;
+  OutputSchemaHelper agg_out{0, &expr_maker};
+  {
+    // Read previous output
+    auto col1 = order_by_out.GetOutput("col1");
+    auto col2 = order_by_out.GetOutput("col2");
+    // Add group by term
+    agg_out.AddGroupByTerm("col2", col2);
+    // Add aggregates
+    agg_out.AddAggTerm("sum_col1", expr_maker.AggSum(col1));
+    agg_out.AddAggTerm("count_col1", expr_maker.AggCount(col1));
+    // Make the output expressions
+    agg_out.AddOutput("col2", agg_out.GetGroupByTermForOutput("col2"));
+    agg_out.AddOutput("sum_col1", agg_out.GetAggTermForOutput("sum_col1"));
+    agg_out.AddOutput("count_col1", agg_out.GetAggTermForOutput("count_col1"));
+    auto schema = agg_out.MakeSchema();
+    // Build
+    planner::AggregatePlanNode::Builder builder;
+    agg = builder.SetOutputSchema(std::move(schema))
+              .AddGroupByTerm(agg_out.GetGroupByTerm("col2"))
+              .AddAggregateTerm(agg_out.GetAggTerm("sum_col1"))
+              .AddAggregateTerm(agg_out.GetAggTerm("count_col1"))
+              .AddChild(std::move(order_by))
+              .SetAggregateStrategyType(planner::AggregateStrategyType::SORTED)
+              .SetHavingClausePredicate(nullptr)
+              .Build();
+  }
+  // Checkers:
+  // There should be one output row per value of col2, in ascending order of col2.
+  // The sums and counts of all groups should add up to those of the input.
+  uint32_t num_output_rows{0};
+  int64_t curr_col2{std::numeric_limits<int64_t>::min()};
+  int64_t total_sum{0};
+  int64_t total_count{0};
+  RowChecker row_checker = [&](const std::vector<sql::Val *> &vals) {
+    // Read cols
+    auto col2 = static_cast<sql::Integer *>(vals[0]);
+    auto sum_col1 = static_cast<sql::Integer *>(vals[1]);
+    auto count_col1 = static_cast<sql::Integer *>(vals[2]);
+    ASSERT_FALSE(col2->is_null_ || sum_col1->is_null_ || count_col1->is_null_);
+    // Every group is produced exactly once, in input order
+    ASSERT_LT(curr_col2, col2->val_);
+    curr_col2 = col2->val_;
+    total_sum += sum_col1->val_;
+    total_count += count_col1->val_;
+    num_output_rows++;
+  };
+  CorrectnessFn correctness_fn = [&]() {
+    ASSERT_EQ(num_output_rows, 10);
+    ASSERT_EQ(total_sum, (1000 * 999) / 2);
+    ASSERT_EQ(total_count, 1000);
+  };
+  GenericChecker checker(row_checker, correctness_fn);
+
+  // Compile and Run
+  OutputStore store{&checker, agg->GetOutputSchema().Get()};
+  exec::OutputPrinter printer(agg->GetOutputSchema().Get());
+  MultiOutputCallback callback{std::vector<exec::OutputCallback>{store, printer}};
+  auto exec_ctx = MakeExecCtx(std::move(callback), agg->GetOutputSchema().Get());
+
+  // Run & Check
+  auto executable =
+      execution::compiler::CompilationContext::Compile(*agg, exec_ctx->GetExecutionSettings(), exec_ctx->GetAccessor());
+  executable->Run(common::ManagedPointer(exec_ctx), MODE);
+  checker.CheckCorrectness();
+}
+
 // NOLINTNEXTLINE
 TEST_F(CompilerTest, SimpleHashJoinTest) {
   // SELECT t1.col1, t2.col1, t2.col2, t1.col1 + t2.col2 FROM t1 INNER JOIN t2 ON t1.col1=t2.col1
@@ -1713,6 +1833,146 @@ TEST_F(CompilerTest, MultiWayHashJoinTest) {
   EXPECT_TRUE(CheckFeatureVectorEquality(feature_vec2, exp_vec2));
 }
 
+// NOLINTNEXTLINE
+TEST_F(CompilerTest, SimpleMergeJoinTest) {
+  // SELECT t1.col1, t1.col2, t2.col1, t2.col2
+  // FROM (SELECT * FROM test_1 WHERE col1 < 100 ORDER BY col2) AS t1
+  // INNER JOIN (SELECT * FROM test_1 WHERE col1 < 50 ORDER BY col2) AS t2 ON t1.col2 = t2.col2
+  // col2 only has 10 distinct values, so both sides have many rows with the same key.
+  // Get accessor
+  auto accessor = MakeAccessor();
+  ExpressionMaker expr_maker;
+  auto table_oid = accessor->GetTableOid(NSOid(), "test_1");
+  auto table_schema = accessor->GetSchema(table_oid);
+  auto cola_oid = table_schema.GetColumn("colA").Oid();
+  auto colb_oid = table_schema.GetColumn("colB").Oid();
+
+  // Count the rows of each side per key to know the size of the join.
+  std::array<int64_t, 10> num_left_rows{};
+  std::array<int64_t, 10> num_right_rows{};
+  {
+    OutputSchemaHelper seq_scan_out{0, &expr_maker};
+    auto col1 = expr_maker.CVE(cola_oid, type::TypeId::INTEGER);
+    auto col2 = expr_maker.CVE(colb_oid, type::TypeId::INTEGER);
+    seq_scan_out.AddOutput("col1", col1);
+    seq_scan_out.AddOutput("col2", col2);
+    auto schema = seq_scan_out.MakeSchema();
+    auto predicate = expr_maker.ComparisonLt(col1, expr_maker.Constant(100));
+    planner::SeqScanPlanNode::Builder builder;
+    auto seq_scan = builder.SetOutputSchema(std::move(schema))
+                        .SetColumnOids({cola_oid, colb_oid})
+                        .SetScanPredicate(predicate)
+                        .SetIsForUpdateFlag(false)
+                        .SetTableOid(table_oid)
+                        .Build();
+    RowChecker row_checker = [&](const std::vector<sql::Val *> &vals) {
+      auto col1 = static_cast<sql::Integer *>(vals[0]);
+      auto col2 = static_cast<sql::Integer *>(vals[1]);
+      num_left_rows.at(col2->val_)++;
+      if (col1->val_ < 50) num_right_rows.at(col2->val_)++;
+    };
+    GenericChecker checker(row_checker, [] {});
+    OutputStore store{&checker, seq_scan->GetOutputSchema().Get()};
+    MultiOutputCallback callback{std::vector<exec::OutputCallback>{store}};
+    auto exec_ctx = MakeExecCtx(std::move(callback), seq_scan->GetOutputSchema().Get());
+    auto executable = execution::compiler::CompilationContext::Compile(*seq_scan, exec_ctx->GetExecutionSettings(),
+                                                                       exec_ctx->GetAccessor());
+    executable->Run(common::ManagedPointer(exec_ctx), MODE);
+  }
+
+  // Make both sides: a seq scan sorted on col2.
+  const auto make_side = [&](int32_t limit, OutputSchemaHelper *order_by_out) {
+    OutputSchemaHelper seq_scan_out{0, &expr_maker};
+    auto col1 = expr_maker.CVE(cola_oid, type::TypeId::INTEGER);
+    auto col2 = expr_maker.CVE(colb_oid, type::TypeId::INTEGER);
+    seq_scan_out.AddOutput("col1", col1);
+    seq_scan_out.AddOutput("col2", col2);
+    auto predicate = expr_maker.ComparisonLt(col1, expr_maker.Constant(limit));
+    planner::SeqScanPlanNode::Builder scan_builder;
+    auto seq_scan = scan_builder.SetOutputSchema(seq_scan_out.MakeSchema())
+                        .SetColumnOids({cola_oid, colb_oid})
+                        .SetScanPredicate(predicate)
+                        .SetIsForUpdateFlag(false)
+                        .SetTableOid(table_oid)
+                        .Build();
+    order_by_out->AddOutput("col1", seq_scan_out.GetOutput("col1"));
+    order_by_out->AddOutput("col2", seq_scan_out.GetOutput("col2"));
+    planner::OrderByPlanNode::Builder order_by_builder;
+    return order_by_builder.SetOutputSchema(order_by_out->MakeSchema())
+        .AddChild(std::move(seq_scan))
+        .AddSortKey(seq_scan_out.GetOutput("col2"), optimizer::OrderByOrderingType::ASC)
+        .Build();
+  };
+  OutputSchemaHelper order_by_out1{0, &expr_maker};
+  OutputSchemaHelper order_by_out2{1, &expr_maker};
+  auto order_by1 = make_side(100, &order_by_out1);
+  auto order_by2 = make_side(50, &order_by_out2);
+
+  // Make merge join
+  std::unique_ptr<planner::AbstractPlanNode> merge_join;
+  OutputSchemaHelper merge_join_out{0, &expr_maker};
+  {
+    auto t1_col1 = order_by_out1.GetOutput("col1");
+    auto t1_col2 = order_by_out1.GetOutput("col2");
+    auto t2_col1 = order_by_out2.GetOutput("col1");
+    auto t2_col2 = order_by_out2.GetOutput("col2");
+    // Output Schema
+    merge_join_out.AddOutput("t1.col1", t1_col1);
+    merge_join_out.AddOutput("t1.col2", t1_col2);
+    merge_join_out.AddOutput("t2.col1", t2_col1);
+    merge_join_out.AddOutput("t2.col2", t2_col2);
+    auto schema = merge_join_out.MakeSchema();
+    // Predicate
+    auto predicate = expr_maker.ComparisonEq(t1_col2, t2_col2);
+    // Build
+    planner::MergeJoinPlanNode::Builder builder;
+    merge_join = builder.AddChild(std::move(order_by1))
+                     .AddChild(std::move(order_by2))
+                     .SetOutputSchema(std::move(schema))
+                     .AddLeftMergeKey(t1_col2)
+                     .AddRightMergeKey(t2_col2)
+                     .SetJoinType(planner::LogicalJoinType::INNER)
+                     .SetJoinPredicate(predicate)
+                     .Build();
+  }
+  // Checkers:
+  // Every pair of rows with the same key should be joined exactly once, in ascending order of the key.
+  std::array<int64_t, 10> num_output_rows{};
+  int64_t curr_key{std::numeric_limits<int64_t>::min()};
+  RowChecker row_checker = [&](const std::vector<sql::Val *> &vals) {
+    // Read cols
+    auto t1_col1 = static_cast<sql::Integer *>(vals[0]);
+    auto t1_col2 = static_cast<sql::Integer *>(vals[1]);
+    auto t2_col1 = static_cast<sql::Integer *>(vals[2]);
+    auto t2_col2 = static_cast<sql::Integer *>(vals[3]);
+    ASSERT_FALSE(t1_col1->is_null_ || t1_col2->is_null_ || t2_col1->is_null_ || t2_col2->is_null_);
+    // Check join cols and the order of the output
+    ASSERT_EQ(t1_col2->val_, t2_col2->val_);
+    ASSERT_LE(curr_key, t1_col2->val_);
+    ASSERT_LT(t1_col1->val_, 100);
+    ASSERT_LT(t2_col1->val_, 50);
+    curr_key = t1_col2->val_;
+    num_output_rows.at(curr_key)++;
+  };
+  CorrectnessFn correctness_fn = [&]() {
+    for (uint32_t key = 0; key < num_output_rows.size(); key++) {
+      ASSERT_EQ(num_output_rows[key], num_left_rows[key] * num_right_rows[key]);
+    }
+  };
+  GenericChecker checker(row_checker, correctness_fn);
+
+  OutputStore store{&checker, merge_join->GetOutputSchema().Get()};
+  exec::OutputPrinter printer(merge_join->GetOutputSchema().Get());
+  MultiOutputCallback callback{std::vector<exec::OutputCallback>{store, printer}};
+  auto exec_ctx = MakeExecCtx(std::move(callback), merge_join->GetOutputSchema().Get());
+
+  // Run & Check
+  auto executable = execution::compiler::CompilationContext::Compile(*merge_join, exec_ctx->GetExecutionSettings(),
+                                                                     exec_ctx->GetAccessor());
+  executable->Run(common::ManagedPointer(exec_ctx), MODE);
+  checker.CheckCorrectness();
+}
+
 // NOLINTNEXTLINE
 TEST_F(CompilerTest, SimpleSortTest) {
   // SELECT col1, col2, col1 + col2 FROM test_1 WHERE col1 < 500 ORDER BY col2 ASC, col1 - col2 DESC
@@ -2099,6 +2359,243 @@ TEST_F(CompilerTest, LimitAndOffsetTest) {
   checker.CheckCorrectness();
 }
 
+// NOLINTNEXTLINE
+TEST_F(CompilerTest, WindowPartitionTest) {
+  // SELECT col1, col2, ROW_NUMBER() OVER w, SUM(col1) OVER (w ROWS BETWEEN 1 PRECEDING AND CURRENT ROW),
+  //        COUNT(*) OVER w
+  // FROM test_1 WHERE col1 < 1000 WINDOW w AS (PARTITION BY col2 ORDER BY col1 ASC)
+  // Get accessor
+  auto accessor = MakeAccessor();
+  ExpressionMaker expr_maker;
+  auto table_oid = accessor->GetTableOid(NSOid(), "test_1");
+  auto table_schema = accessor->GetSchema(table_oid);
+  std::unique_ptr<planner::AbstractPlanNode> seq_scan;
+  OutputSchemaHelper seq_scan_out{0, &expr_maker};
+  {
+    // OIDs
+    auto cola_oid = table_schema.GetColumn("colA").Oid();
+    auto colb_oid = table_schema.GetColumn("colB").Oid();
+    // Get Table columns
+    auto col1 = expr_maker.CVE(cola_oid, type::TypeId::INTEGER);
+    auto col2 = expr_maker.CVE(colb_oid, type::TypeId::INTEGER);
+    seq_scan_out.AddOutput("col1", col1);
+    seq_scan_out.AddOutput("col2", col2);
+    auto schema = seq_scan_out.MakeSchema();
+    // Make predicate
+    auto predicate = expr_maker.ComparisonLt(col1, expr_maker.Constant(1000));
+    // Build
+    planner::SeqScanPlanNode::Builder builder;
+    seq_scan = builder.SetOutputSchema(std::move(schema))
+                   .SetColumnOids({cola_oid, colb_oid})
+                   .SetScanPredicate(predicate)
+                   .SetIsForUpdateFlag(false)
+                   .SetTableOid(table_oid)
+                   .Build();
+  }
+  // Window
+  std::unique_ptr<planner::AbstractPlanNode> window;
+  OutputSchemaHelper window_out{0, &expr_maker};
+  {
+    auto col1 = seq_scan_out.GetOutput("col1");
+    auto col2 = seq_scan_out.GetOutput("col2");
+    // Window terms
+    planner::WindowTerm row_number;
+    row_number.type_ = planner::WindowFunctionType::ROW_NUMBER;
+    planner::WindowTerm moving_sum;
+    moving_sum.type_ = planner::WindowFunctionType::SUM;
+    moving_sum.argument_ = col1;
+    moving_sum.frame_type_ = planner::WindowFrameType::ROWS;
+    moving_sum.frame_start_ = planner::WindowFrameBoundType::PRECEDING;
+    moving_sum.frame_start_offset_ = 1;
+    planner::WindowTerm count_star;
+    count_star.type_ = planner::WindowFunctionType::COUNT_STAR;
+    // Output Columns col1, col2 and the window terms
+    window_out.AddOutput("col1", col1);
+    window_out.AddOutput("col2", col2);
+    window_out.AddOutput("row_number", expr_maker.DVE(type::TypeId::BIGINT, 1, 0));
+    window_out.AddOutput("moving_sum", expr_maker.DVE(type::TypeId::INTEGER, 1, 1));
+    window_out.AddOutput("count_star", expr_maker.DVE(type::TypeId::BIGINT, 1, 2));
+    auto schema = window_out.MakeSchema();
+    // Build
+    planner::WindowPlanNode::Builder builder;
+    window = builder.SetOutputSchema(std::move(schema))
+                 .AddChild(std::move(seq_scan))
+                 .AddPartitionByTerm(col2)
+                 .AddSortKey(col1, optimizer::OrderByOrderingType::ASC)
+                 .AddWindowTerm(row_number)
+                 .AddWindowTerm(moving_sum)
+                 .AddWindowTerm(count_star)
+                 .Build();
+  }
+  // Checkers:
+  // There should be 1000 output rows, sorted on col2 and then col1.
+  // The row number restarts at 1 in every partition, the moving sum adds up the current and the previous row of the
+  // partition, and since col1 is unique, every row is only a peer of itself and COUNT(*) equals the row number.
+  uint32_t num_output_rows{0};
+  uint32_t num_expected_rows{1000};
+  int64_t curr_col1{0};
+  int64_t curr_col2{std::numeric_limits<int64_t>::min()};
+  int64_t curr_row_number{0};
+  RowChecker row_checker = [&](const std::vector<sql::Val *> &vals) {
+    // Read cols
+    auto col1 = static_cast<sql::Integer *>(vals[0]);
+    auto col2 = static_cast<sql::Integer *>(vals[1]);
+    auto row_number = static_cast<sql::Integer *>(vals[2]);
+    auto moving_sum = static_cast<sql::Integer *>(vals[3]);
+    auto count_star = static_cast<sql::Integer *>(vals[4]);
+    ASSERT_FALSE(col1->is_null_ || col2->is_null_ || row_number->is_null_ || moving_sum->is_null_ ||
+                 count_star->is_null_);
+    ASSERT_LE(curr_col2, col2->val_);
+    if (curr_col2 == col2->val_) {
+      // Same partition
+      ASSERT_LT(curr_col1, col1->val_);
+      ASSERT_EQ(row_number->val_, curr_row_number + 1);
+      ASSERT_EQ(moving_sum->val_, curr_col1 + col1->val_);
+    } else {
+      // New partition
+      ASSERT_EQ(row_number->val_, 1);
+      ASSERT_EQ(moving_sum->val_, col1->val_);
+    }
+    ASSERT_EQ(count_star->val_, row_number->val_);
+    curr_col1 = col1->val_;
+    curr_col2 = col2->val_;
+    curr_row_number = row_number->val_;
+    num_output_rows++;
+    ASSERT_LE(num_output_rows, num_expected_rows);
+  };
+  CorrectnessFn correctness_fn = [&]() { ASSERT_EQ(num_output_rows, num_expected_rows); };
+  GenericChecker checker(row_checker, correctness_fn);
+
+  // Create exec ctx
+  OutputStore store{&checker, window->GetOutputSchema().Get()};
+  exec::OutputPrinter printer(window->GetOutputSchema().Get());
+  MultiOutputCallback callback{std::vector<exec::OutputCallback>{store, printer}};
+  auto exec_ctx = MakeExecCtx(std::move(callback), window->GetOutputSchema().Get());
+
+  // Run & Check
+  auto executable = execution::compiler::CompilationContext::Compile(*window, exec_ctx->GetExecutionSettings(),
+                                                                     exec_ctx->GetAccessor());
+  executable->Run(common::ManagedPointer(exec_ctx), MODE);
+  checker.CheckCorrectness();
+}
+
+// NOLINTNEXTLINE
+TEST_F(CompilerTest, WindowOrderWithNullsTest) {
+  // SELECT col2, RANK() OVER w, COUNT(*) OVER w FROM test_2 WINDOW w AS (ORDER BY col2 ASC)
+  // SELECT col2, RANK() OVER w, COUNT(*) OVER w FROM test_2 WINDOW w AS (ORDER BY col2 DESC)
+  // col2 has few distinct values and NULLs, so there are many peers. As in Postgres, NULLs sort after all other values
+  // in ascending order, and before them in descending order.
+  // Get accessor
+  auto accessor = MakeAccessor();
+  auto table_oid = accessor->GetTableOid(NSOid(), "test_2");
+  auto table_schema = accessor->GetSchema(table_oid);
+  auto col2_oid = table_schema.GetColumn("col2").Oid();
+
+  for (const auto ordering : {optimizer::OrderByOrderingType::ASC, optimizer::OrderByOrderingType::DESC}) {
+    ExpressionMaker expr_maker;
+    std::unique_ptr<planner::AbstractPlanNode> seq_scan;
+    OutputSchemaHelper seq_scan_out{0, &expr_maker};
+    {
+      auto col2 = expr_maker.CVE(col2_oid, type::TypeId::INTEGER);
+      seq_scan_out.AddOutput("col2", col2);
+      auto schema = seq_scan_out.MakeSchema();
+      // Build
+      planner::SeqScanPlanNode::Builder builder;
+      seq_scan = builder.SetOutputSchema(std::move(schema))
+                     .SetColumnOids({col2_oid})
+                     .SetScanPredicate(nullptr)
+                     .SetIsForUpdateFlag(false)
+                     .SetTableOid(table_oid)
+                     .Build();
+    }
+    // Window
+    std::unique_ptr<planner::AbstractPlanNode> window;
+    OutputSchemaHelper window_out{0, &expr_maker};
+    {
+      auto col2 = seq_scan_out.GetOutput("col2");
+      // Window terms, COUNT(*) uses the default frame from the start of the partition to the last peer
+      planner::WindowTerm rank;
+      rank.type_ = planner::WindowFunctionType::RANK;
+      planner::WindowTerm count_star;
+      count_star.type_ = planner::WindowFunctionType::COUNT_STAR;
+      // Output Columns col2 and the window terms
+      window_out.AddOutput("col2", col2);
+      window_out.AddOutput("rank", expr_maker.DVE(type::TypeId::BIGINT, 1, 0));
+      window_out.AddOutput("count_star", expr_maker.DVE(type::TypeId::BIGINT, 1, 1));
+      auto schema = window_out.MakeSchema();
+      // Build
+      planner::WindowPlanNode::Builder builder;
+      window = builder.SetOutputSchema(std::move(schema))
+                   .AddChild(std::move(seq_scan))
+                   .AddSortKey(col2, ordering)
+                   .AddWindowTerm(rank)
+                   .AddWindowTerm(count_star)
+                   .Build();
+    }
+    // Checkers:
+    // The rows are checked once all of them are produced, since COUNT(*) depends on the last peer of a row.
+    struct Row {
+      std::optional<int64_t> col2_;
+      int64_t rank_;
+      int64_t count_star_;
+    };
+    std::vector<Row> rows;
+    RowChecker row_checker = [&](const std::vector<sql::Val *> &vals) {
+      // Read cols
+      auto col2 = static_cast<sql::Integer *>(vals[0]);
+      auto rank = static_cast<sql::Integer *>(vals[1]);
+      auto count_star = static_cast<sql::Integer *>(vals[2]);
+      ASSERT_FALSE(rank->is_null_ || count_star->is_null_);
+      rows.push_back({col2->is_null_ ? std::nullopt : std::optional<int64_t>(col2->val_), rank->val_,
+                      count_star->val_});
+    };
+    CorrectnessFn correctness_fn = [&]() {
+      ASSERT_EQ(rows.size(), sql::TEST2_SIZE);
+      const bool asc = ordering == optimizer::OrderByOrderingType::ASC;
+      uint32_t num_nulls = 0;
+      for (uint32_t i = 0; i < rows.size(); i++) {
+        const auto &row = rows[i];
+        if (!row.col2_.has_value()) num_nulls++;
+        // Find the first and the last peer of the row
+        uint32_t first_peer = i;
+        while (first_peer > 0 && rows[first_peer - 1].col2_ == row.col2_) first_peer--;
+        uint32_t last_peer = i;
+        while (last_peer + 1 < rows.size() && rows[last_peer + 1].col2_ == row.col2_) last_peer++;
+        ASSERT_EQ(row.rank_, first_peer + 1);
+        ASSERT_EQ(row.count_star_, last_peer + 1);
+        if (i == 0) continue;
+        // Check the order of the rows, with NULLs last in ascending and first in descending order
+        const auto &prev = rows[i - 1];
+        if (!prev.col2_.has_value() || !row.col2_.has_value()) {
+          if (asc) {
+            ASSERT_FALSE(!prev.col2_.has_value() && row.col2_.has_value());
+          } else {
+            ASSERT_FALSE(prev.col2_.has_value() && !row.col2_.has_value());
+          }
+        } else if (asc) {
+          ASSERT_LE(*prev.col2_, *row.col2_);
+        } else {
+          ASSERT_GE(*prev.col2_, *row.col2_);
+        }
+      }
+      // The table has NULLs, so the NULL ordering was actually exercised
+      ASSERT_GT(num_nulls, 0);
+    };
+    GenericChecker checker(row_checker, correctness_fn);
+
+    // Create exec ctx
+    OutputStore store{&checker, window->GetOutputSchema().Get()};
+    MultiOutputCallback callback{std::vector<exec::OutputCallback>{store}};
+    auto exec_ctx = MakeExecCtx(std::move(callback), window->GetOutputSchema().Get());
+
+    // Run & Check
+    auto executable = execution::compiler::CompilationContext::Compile(*window, exec_ctx->GetExecutionSettings(),
+                                                                       exec_ctx->GetAccessor());
+    executable->Run(common::ManagedPointer(exec_ctx), MODE);
+    checker.CheckCorrectness();
+  }
+}
+
 // NOLINTNEXTLINE
 TEST_F(CompilerTest, SimpleNestedLoopJoinTest) {
   // SELECT t1.col1, t2.col1, t2.col2, t1.col1 + t2.col2 FROM t1 INNER JOIN t2 ON t1.col1=t2.col1
@@ -1,4 +1,7 @@
+#include <cstring>
+#include <random>
 #include <string>
+#include <vector>
 
 #include "execution/sql/operators/like_operators.h"
 #include "execution/tpl_test.h"
@@ -80,4 +83,69 @@ TEST_F(LikeOperatorsTests, MultiCharacter_Wildcard) {
   EXPECT_TRUE(Like{}(storage::VarlenEntry::Create(s), storage::VarlenEntry::Create(p)));  // NOLINT
 }
 
+// NOLINTNEXTLINE
+TEST_F(LikeOperatorsTests, PatternClassification) {
+  const auto kind_of = [](const std::string &p) { return LikePattern(p.data(), p.size()).GetKind(); };
+  EXPECT_EQ(LikePattern::Kind::Exact, kind_of(""));
+  EXPECT_EQ(LikePattern::Kind::Exact, kind_of("abc"));
+  EXPECT_EQ(LikePattern::Kind::Exact, kind_of("a_c"));
+  EXPECT_EQ(LikePattern::Kind::Exact, kind_of("a\\%c"));
+  EXPECT_EQ(LikePattern::Kind::Prefix, kind_of("abc%"));
+  EXPECT_EQ(LikePattern::Kind::Prefix, kind_of("ab_%%"));
+  EXPECT_EQ(LikePattern::Kind::Suffix, kind_of("%abc"));
+  EXPECT_EQ(LikePattern::Kind::Suffix, kind_of("%%abc\\%"));
+  EXPECT_EQ(LikePattern::Kind::Contains, kind_of("%abc%"));
+  EXPECT_EQ(LikePattern::Kind::Contains, kind_of("%"));
+  EXPECT_EQ(LikePattern::Kind::MultiContains, kind_of("%a%b%"));
+  EXPECT_EQ(LikePattern::Kind::MultiContains, kind_of("a%b"));
+  EXPECT_EQ(LikePattern::Kind::General, kind_of("abc\\"));
+
+  const std::string p = "ab_d%";
+  EXPECT_EQ(4u, LikePattern(p.data(), p.size()).GetMinLength());
+}
+
+// NOLINTNEXTLINE
+TEST_F(LikeOperatorsTests, PatternMatchesLongStrings) {
+  // Long enough for the vectorized substring search, with the match placed at the very end.
+  std::string s(200, 'x');
+  s.replace(s.size() - 5, 5, "needl");
+  s += "e";
+  const auto str = storage::VarlenEntry::Create(s);
+
+  for (const std::string p : {"%needle", "%needle%", "%xx%needle", "xxx%le", "%x_eedle%"}) {
+    EXPECT_TRUE(LikePattern(p.data(), p.size()).Matches(str)) << p;
+  }
+  for (const std::string p : {"%needles", "%neetle%", "%needle%x", "y%", "%needle_"}) {
+    EXPECT_FALSE(LikePattern(p.data(), p.size()).Matches(str)) << p;
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(LikeOperatorsTests, PatternMatchesGeneralImplementation) {
+  // Compare the analyzed patterns against the general matcher on random strings and patterns over a small alphabet.
+  std::mt19937 gen(std::random_device{}());
+  const auto random_string = [&](const char *alphabet, std::size_t max_len) {
+    std::string result(std::uniform_int_distribution<std::size_t>(0, max_len)(gen), ' ');
+    const auto alphabet_len = std::strlen(alphabet);
+    for (auto &c : result) {
+      c = alphabet[std::uniform_int_distribution<std::size_t>(0, alphabet_len - 1)(gen)];
+    }
+    return result;
+  };
+
+  std::vector<std::string> strings;
+  for (uint32_t i = 0; i < 200; i++) {
+    strings.push_back(random_string("ab%_", i < 100 ? 8 : 80));
+  }
+
+  for (uint32_t i = 0; i < 500; i++) {
+    const auto p = random_string("ab%_\\", 8);
+    const LikePattern pattern(p.data(), p.size());
+    for (const auto &s : strings) {
+      const auto expected = Like::Impl(s.data(), s.size(), p.data(), p.size());
+      EXPECT_EQ(expected, pattern.Matches(storage::VarlenEntry::Create(s))) << "'" << s << "' LIKE '" << p << "'";
+    }
+  }
+}
+
 }  // namespace terrier::execution::sql::test
@@ -0,0 +1,234 @@
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "execution/sql/sorter.h"
+#include "execution/sql/value.h"
+#include "execution/sql/window_evaluator.h"
+#include "execution/sql_test.h"
+
+namespace terrier::execution::sql::test {
+
+class WindowEvaluatorTest : public SqlBasedTest {};
+
+namespace {
+
+struct WindowRow {
+  int32_t part_;
+  int32_t order_;
+  Integer val_;
+  Real real_val_;
+  // Results
+  Integer row_number_;
+  Integer rank_;
+  Integer dense_rank_;
+  Integer running_sum_;
+  Integer running_count_;
+  Integer lag_;
+  Integer lead_;
+  Integer sliding_sum_;
+  Integer sliding_min_;
+  Real sliding_real_sum_;
+  Real sliding_avg_;
+  Integer remaining_count_;
+  Integer ahead_max_;
+};
+
+int32_t CompareRows(const void *lhs, const void *rhs) {
+  const auto *l = reinterpret_cast<const WindowRow *>(lhs);
+  const auto *r = reinterpret_cast<const WindowRow *>(rhs);
+  if (l->part_ != r->part_) return l->part_ < r->part_ ? -1 : 1;
+  if (l->order_ != r->order_) return l->order_ < r->order_ ? -1 : 1;
+  return 0;
+}
+
+bool SamePartition(const void *lhs, const void *rhs) {
+  return reinterpret_cast<const WindowRow *>(lhs)->part_ == reinterpret_cast<const WindowRow *>(rhs)->part_;
+}
+
+bool SamePeer(const void *lhs, const void *rhs) {
+  return reinterpret_cast<const WindowRow *>(lhs)->order_ == reinterpret_cast<const WindowRow *>(rhs)->order_;
+}
+
+// The offset of the given member in a WindowRow. SQL values are not standard-layout, so offsetof() can't be used.
+template <typename T>
+uint32_t OffsetOf(T WindowRow::*member) {
+  alignas(WindowRow) static byte storage[sizeof(WindowRow)];
+  const auto *row = reinterpret_cast<const WindowRow *>(storage);
+  return static_cast<uint32_t>(reinterpret_cast<const byte *>(&(row->*member)) - storage);
+}
+
+// Collect the rows of the sorter, in order.
+std::vector<const WindowRow *> CollectRows(const Sorter &sorter) {
+  std::vector<const WindowRow *> rows;
+  for (SorterIterator iter(sorter); iter.HasNext(); iter.Next()) {
+    rows.push_back(iter.GetRowAs<WindowRow>());
+  }
+  return rows;
+}
+
+void ExpectInteger(const Integer &actual, bool is_null, int64_t val) {
+  EXPECT_EQ(is_null, actual.is_null_);
+  if (!is_null) EXPECT_EQ(val, actual.val_);
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE
+TEST_F(WindowEvaluatorTest, RankingAndDefaultFrame) {
+  MemoryPool memory(nullptr);
+  Sorter sorter(&memory, CompareRows, sizeof(WindowRow));
+
+  // Two partitions, inserted out of order. The first has a tie and a NULL.
+  const std::vector<std::tuple<int32_t, int32_t, bool, int64_t>> input = {
+      {1, 5, false, 7}, {0, 3, false, 40}, {0, 1, false, 20}, {0, 2, true, 0}, {0, 1, false, 10}};
+  for (const auto &[part, order, is_null, val] : input) {
+    auto *row = reinterpret_cast<WindowRow *>(sorter.AllocInputTuple());
+    row->part_ = part;
+    row->order_ = order;
+    row->val_ = is_null ? Integer::Null() : Integer(val);
+  }
+  sorter.Sort();
+
+  const uint32_t val = OffsetOf(&WindowRow::val_);
+  WindowEvaluator evaluator(SamePartition, SamePeer);
+  evaluator.AddFunction(WindowFunction::RowNumber, TypeId::BigInt, 0, OffsetOf(&WindowRow::row_number_), 0);
+  evaluator.AddFunction(WindowFunction::Rank, TypeId::BigInt, 0, OffsetOf(&WindowRow::rank_), 0);
+  evaluator.AddFunction(WindowFunction::DenseRank, TypeId::BigInt, 0, OffsetOf(&WindowRow::dense_rank_), 0);
+  evaluator.AddFunction(WindowFunction::Sum, TypeId::BigInt, val, OffsetOf(&WindowRow::running_sum_), 0);
+  evaluator.AddFunction(WindowFunction::Count, TypeId::BigInt, val, OffsetOf(&WindowRow::running_count_), 0);
+  evaluator.AddFunction(WindowFunction::Lag, TypeId::BigInt, val, OffsetOf(&WindowRow::lag_), 1);
+  evaluator.AddFunction(WindowFunction::Lead, TypeId::BigInt, val, OffsetOf(&WindowRow::lead_), 2);
+  evaluator.Evaluate(&sorter);
+
+  EXPECT_EQ(2, evaluator.GetPartitionCount());
+
+  // Sorted: (0,1,10|20), (0,1,20|10), (0,2,NULL), (0,3,40), (1,5,7). Rows with order 1 may be in any order.
+  const auto rows = CollectRows(sorter);
+  ASSERT_EQ(5, rows.size());
+  const int64_t first = rows[0]->val_.val_, second = rows[1]->val_.val_;
+
+  const std::vector<int64_t> row_numbers = {1, 2, 3, 4, 1}, ranks = {1, 1, 3, 4, 1}, dense_ranks = {1, 1, 2, 3, 1};
+  const std::vector<int64_t> running_sums = {30, 30, 30, 70, 7}, running_counts = {2, 2, 2, 3, 1};
+  for (uint32_t i = 0; i < rows.size(); i++) {
+    ExpectInteger(rows[i]->row_number_, false, row_numbers[i]);
+    ExpectInteger(rows[i]->rank_, false, ranks[i]);
+    ExpectInteger(rows[i]->dense_rank_, false, dense_ranks[i]);
+    ExpectInteger(rows[i]->running_sum_, false, running_sums[i]);
+    ExpectInteger(rows[i]->running_count_, false, running_counts[i]);
+  }
+
+  // LAG(val, 1) and LEAD(val, 2) do not cross partitions, and copy NULLs.
+  ExpectInteger(rows[0]->lag_, true, 0);
+  ExpectInteger(rows[1]->lag_, false, first);
+  ExpectInteger(rows[2]->lag_, false, second);
+  ExpectInteger(rows[3]->lag_, true, 0);
+  ExpectInteger(rows[4]->lag_, true, 0);
+  ExpectInteger(rows[0]->lead_, true, 0);
+  ExpectInteger(rows[1]->lead_, false, 40);
+  ExpectInteger(rows[2]->lead_, true, 0);
+  ExpectInteger(rows[3]->lead_, true, 0);
+  ExpectInteger(rows[4]->lead_, true, 0);
+}
+
+// NOLINTNEXTLINE
+TEST_F(WindowEvaluatorTest, FramesMatchBruteForce) {
+  constexpr uint32_t num_rows = 20000;
+  constexpr int32_t num_parts = 500;
+
+  std::mt19937 generator(42);
+  std::uniform_int_distribution<int32_t> part_dist(0, num_parts - 1), order_dist(0, 20), val_dist(-1000, 1000);
+  std::bernoulli_distribution null_dist(0.1);
+
+  MemoryPool memory(nullptr);
+  Sorter sorter(&memory, CompareRows, sizeof(WindowRow));
+  for (uint32_t i = 0; i < num_rows; i++) {
+    auto *row = reinterpret_cast<WindowRow *>(sorter.AllocInputTuple());
+    row->part_ = part_dist(generator);
+    row->order_ = order_dist(generator);
+    const bool is_null = null_dist(generator);
+    const int32_t value = val_dist(generator);
+    row->val_ = is_null ? Integer::Null() : Integer(value);
+    row->real_val_ = is_null ? Real::Null() : Real(value / 4.0);
+  }
+  sorter.Sort();
+
+  const uint32_t val = OffsetOf(&WindowRow::val_), real_val = OffsetOf(&WindowRow::real_val_);
+  WindowEvaluator evaluator(SamePartition, SamePeer);
+  const auto add_rows_frame = [&](WindowFunction func, TypeId type, uint32_t arg, uint32_t result,
+                                  WindowFrameBound start, int64_t start_offset, WindowFrameBound end,
+                                  int64_t end_offset) {
+    evaluator.AddFunction(func, type, arg, result, 0);
+    evaluator.SetFrame(WindowFrameType::Rows, start, start_offset, end, end_offset);
+  };
+  // ROWS BETWEEN 2 PRECEDING AND 1 FOLLOWING
+  add_rows_frame(WindowFunction::Sum, TypeId::BigInt, val, OffsetOf(&WindowRow::sliding_sum_),
+                 WindowFrameBound::Preceding, 2, WindowFrameBound::Following, 1);
+  add_rows_frame(WindowFunction::Min, TypeId::BigInt, val, OffsetOf(&WindowRow::sliding_min_),
+                 WindowFrameBound::Preceding, 2, WindowFrameBound::Following, 1);
+  add_rows_frame(WindowFunction::Sum, TypeId::Double, real_val, OffsetOf(&WindowRow::sliding_real_sum_),
+                 WindowFrameBound::Preceding, 2, WindowFrameBound::Following, 1);
+  add_rows_frame(WindowFunction::Avg, TypeId::BigInt, val, OffsetOf(&WindowRow::sliding_avg_),
+                 WindowFrameBound::Preceding, 2, WindowFrameBound::Following, 1);
+  // ROWS BETWEEN 1 FOLLOWING AND 3 FOLLOWING
+  add_rows_frame(WindowFunction::Max, TypeId::BigInt, val, OffsetOf(&WindowRow::ahead_max_),
+                 WindowFrameBound::Following, 1, WindowFrameBound::Following, 3);
+  // RANGE BETWEEN CURRENT ROW AND UNBOUNDED FOLLOWING
+  evaluator.AddFunction(WindowFunction::Count, TypeId::BigInt, val, OffsetOf(&WindowRow::remaining_count_), 0);
+  evaluator.SetFrame(WindowFrameType::Range, WindowFrameBound::CurrentRow, 0, WindowFrameBound::UnboundedFollowing, 0);
+  evaluator.Evaluate(&sorter);
+
+  // Check every partition against a brute-force evaluation.
+  const auto rows = CollectRows(sorter);
+  uint64_t num_partitions = 0;
+  for (uint64_t part_begin = 0; part_begin < rows.size();) {
+    uint64_t part_end = part_begin;
+    while (part_end < rows.size() && rows[part_end]->part_ == rows[part_begin]->part_) part_end++;
+    num_partitions++;
+
+    for (uint64_t i = part_begin; i < part_end; i++) {
+      // Rows [i-2, i+1]
+      int64_t sum = 0, min = std::numeric_limits<int64_t>::max(), count = 0;
+      double real_sum = 0;
+      for (uint64_t j = std::max(part_begin, i < 2 ? 0 : i - 2); j < std::min(part_end, i + 2); j++) {
+        if (rows[j]->val_.is_null_) continue;
+        sum += rows[j]->val_.val_;
+        min = std::min(min, rows[j]->val_.val_);
+        real_sum += rows[j]->real_val_.val_;
+        count++;
+      }
+      ExpectInteger(rows[i]->sliding_sum_, count == 0, sum);
+      ExpectInteger(rows[i]->sliding_min_, count == 0, min);
+      EXPECT_EQ(count == 0, rows[i]->sliding_real_sum_.is_null_);
+      EXPECT_EQ(count == 0, rows[i]->sliding_avg_.is_null_);
+      if (count != 0) {
+        EXPECT_DOUBLE_EQ(real_sum, rows[i]->sliding_real_sum_.val_);
+        EXPECT_DOUBLE_EQ(static_cast<double>(sum) / count, rows[i]->sliding_avg_.val_);
+      }
+
+      // Rows [i+1, i+3]
+      int64_t max = std::numeric_limits<int64_t>::min(), ahead_count = 0;
+      for (uint64_t j = i + 1; j < std::min(part_end, i + 4); j++) {
+        if (rows[j]->val_.is_null_) continue;
+        max = std::max(max, rows[j]->val_.val_);
+        ahead_count++;
+      }
+      ExpectInteger(rows[i]->ahead_max_, ahead_count == 0, max);
+
+      // First peer of row i to the end of the partition.
+      int64_t remaining = 0;
+      uint64_t first_peer = i;
+      while (first_peer > part_begin && rows[first_peer - 1]->order_ == rows[i]->order_) first_peer--;
+      for (uint64_t j = first_peer; j < part_end; j++) {
+        if (!rows[j]->val_.is_null_) remaining++;
+      }
+      ExpectInteger(rows[i]->remaining_count_, false, remaining);
+    }
+
+    part_begin = part_end;
+  }
+  EXPECT_EQ(num_partitions, evaluator.GetPartitionCount());
+}
+
+}  // namespace terrier::execution::sql::test
@@ -0,0 +1,88 @@
+#include <atomic>
+#include <stdexcept>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "execution/tpl_test.h"
+#include "execution/util/morsel_scheduler.h"
+
+namespace terrier::execution::util::test {
+
+class MorselSchedulerTest : public TplTest {};
+
+// NOLINTNEXTLINE
+TEST_F(MorselSchedulerTest, EmptyRange) {
+  MorselScheduler scheduler(2);
+  uint32_t count = 0;
+  scheduler.ParallelFor(10, 10, 4, -1, MorselScheduler::DEFAULT_PRIORITY, true,
+                        [&](uint32_t, uint32_t) { count++; });
+  EXPECT_EQ(0u, count);
+}
+
+// NOLINTNEXTLINE
+TEST_F(MorselSchedulerTest, CoversRangeExactlyOnce) {
+  constexpr uint32_t num_elems = 10000;
+  for (const uint32_t num_workers : {0u, 1u, 4u}) {
+    for (const uint32_t morsel_size : {1u, 7u, 64u, 20000u}) {
+      for (const bool work_stealing : {true, false}) {
+        MorselScheduler scheduler(num_workers);
+        std::vector<std::atomic<uint32_t>> hits(num_elems);
+        scheduler.ParallelFor(0, num_elems, morsel_size, -1, MorselScheduler::DEFAULT_PRIORITY, work_stealing,
+                              [&](uint32_t begin, uint32_t end) {
+                                EXPECT_LE(end - begin, morsel_size);
+                                for (uint32_t i = begin; i < end; i++) hits[i]++;
+                              });
+        for (uint32_t i = 0; i < num_elems; i++) {
+          EXPECT_EQ(1u, hits[i].load()) << "element " << i;
+        }
+      }
+    }
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(MorselSchedulerTest, RespectsMaxThreads) {
+  MorselScheduler scheduler(4);
+  std::atomic<uint32_t> active{0}, max_active{0};
+  scheduler.ParallelFor(0, 200, 1, 2, MorselScheduler::DEFAULT_PRIORITY, true, [&](uint32_t, uint32_t) {
+    const uint32_t now = ++active;
+    uint32_t prev = max_active.load();
+    while (now > prev && !max_active.compare_exchange_weak(prev, now)) {
+    }
+    std::this_thread::yield();
+    active--;
+  });
+  EXPECT_LE(max_active.load(), 2u);
+}
+
+// NOLINTNEXTLINE
+TEST_F(MorselSchedulerTest, ConcurrentAndNestedJobs) {
+  MorselScheduler scheduler(3);
+  constexpr uint32_t num_jobs = 4, num_outer = 16, num_inner = 100;
+  std::atomic<uint64_t> sum{0};
+
+  LaunchParallel(num_jobs, [&](auto job_id) {
+    scheduler.ParallelFor(0, num_outer, 1, -1, job_id + 1, true, [&](uint32_t, uint32_t) {
+      // Nested submission from within a morsel must not deadlock.
+      scheduler.ParallelFor(0, num_inner, [&](uint32_t inner) { sum += inner; });
+    });
+  });
+
+  EXPECT_EQ(uint64_t{num_jobs} * num_outer * (num_inner * (num_inner - 1) / 2), sum.load());
+}
+
+// NOLINTNEXTLINE
+TEST_F(MorselSchedulerTest, PropagatesException) {
+  MorselScheduler scheduler(2);
+  EXPECT_THROW(scheduler.ParallelFor(0, 1000, [](uint32_t idx) {
+    if (idx == 500) throw std::runtime_error("morsel failure");
+  }),
+               std::runtime_error);
+
+  // The scheduler is still usable afterwards.
+  std::atomic<uint32_t> count{0};
+  scheduler.ParallelFor(0, 100, [&](uint32_t) { count++; });
+  EXPECT_EQ(100u, count.load());
+}
+
+}  // namespace terrier::execution::util::test
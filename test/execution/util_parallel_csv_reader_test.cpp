@@ -0,0 +1,170 @@
+#include "execution/util/parallel_csv_reader.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "common/error/exception.h"
+#include "execution/tpl_test.h"
+#include "parser/expression/constant_value_expression.h"
+#include "storage/sql_table.h"
+#include "test_util/storage_test_util.h"
+
+namespace terrier::execution::util::test {
+
+class ParallelCSVReaderTest : public TplTest {
+ protected:
+  // A record of the test table
+  using Record = std::tuple<int32_t, std::string, double>;
+
+  void SetUp() override {
+    TplTest::SetUp();
+    std::vector<catalog::Schema::Column> cols;
+    cols.emplace_back("id", type::TypeId::INTEGER, false, parser::ConstantValueExpression(type::TypeId::INTEGER));
+    cols.emplace_back("name", type::TypeId::VARCHAR, 100, true, parser::ConstantValueExpression(type::TypeId::VARCHAR));
+    cols.emplace_back("price", type::TypeId::DECIMAL, true, parser::ConstantValueExpression(type::TypeId::DECIMAL));
+    for (uint32_t i = 0; i < cols.size(); i++) {
+      StorageTestUtil::ForceOid(&cols[i], catalog::col_oid_t(i + 1));
+      col_oids_.emplace_back(i + 1);
+    }
+    table_ = std::make_unique<storage::SqlTable>(common::ManagedPointer(&block_store_), catalog::Schema(cols));
+    const auto projection_map = table_->ProjectionMapForOids(col_oids_);
+    for (const auto col_oid : col_oids_) {
+      col_offsets_.emplace_back(projection_map.at(col_oid));
+    }
+  }
+
+  void TearDown() override {
+    std::remove(FILE_NAME);
+    TplTest::TearDown();
+  }
+
+  static void WriteFile(const std::string &contents) {
+    std::ofstream file(FILE_NAME, std::ios::binary);
+    file << contents;
+  }
+
+  std::unique_ptr<ParallelCSVReader> MakeReader(const bool header = false) {
+    return std::make_unique<ParallelCSVReader>(
+        FILE_NAME, std::vector<type::TypeId>{type::TypeId::INTEGER, type::TypeId::VARCHAR, type::TypeId::DECIMAL},
+        col_offsets_, ',', '"', '"', "\\N", header);
+  }
+
+  // Read the whole file and return its records sorted by id. NULL strings are "NULL", NULL decimals are -1.
+  std::vector<Record> ReadAll(ParallelCSVReader *reader, const std::size_t chunk_size) {
+    std::vector<Record> records;
+    std::mutex latch;
+    const auto initializer =
+        table_->InitializerForProjectedColumns(col_oids_, common::Constants::K_DEFAULT_VECTOR_SIZE);
+    const auto num_records = reader->Read(
+        initializer,
+        [&](storage::ProjectedColumns *batch) {
+          std::lock_guard<std::mutex> guard(latch);
+          for (uint32_t row = 0; row < batch->NumTuples(); row++) {
+            auto view = batch->InterpretAsRow(row);
+            const auto id = *reinterpret_cast<const int32_t *>(view.AccessWithNullCheck(col_offsets_[0]));
+            std::string name = "NULL";
+            if (const auto *varlen = view.AccessWithNullCheck(col_offsets_[1]); varlen != nullptr) {
+              const auto &entry = *reinterpret_cast<const storage::VarlenEntry *>(varlen);
+              name = std::string(entry.StringView());
+              if (entry.NeedReclaim()) delete[] entry.Content();
+            }
+            double price = -1;
+            if (const auto *value = view.AccessWithNullCheck(col_offsets_[2]); value != nullptr) {
+              price = *reinterpret_cast<const double *>(value);
+            }
+            records.emplace_back(id, name, price);
+          }
+        },
+        chunk_size);
+    EXPECT_EQ(num_records, records.size());
+    std::sort(records.begin(), records.end());
+    return records;
+  }
+
+  static constexpr const char *FILE_NAME = "parallel_csv_reader_test.csv";
+
+  storage::BlockStore block_store_{100, 100};
+  std::unique_ptr<storage::SqlTable> table_;
+  std::vector<catalog::col_oid_t> col_oids_;
+  std::vector<uint16_t> col_offsets_;
+};
+
+// NOLINTNEXTLINE
+TEST_F(ParallelCSVReaderTest, ParseValues) {
+  WriteFile(
+      "id,name,price\r\n"
+      "1,short,1.5\r\n"
+      "2,\"a name, longer than a varlen prefix\",0\n"
+      "3,\"Special \"\"quoted\"\" string\",\\N\n"
+      "4,\\N,-2.25e1\n"
+      "\n"
+      "5,\"\",100");
+  auto reader = MakeReader(true);
+  ASSERT_TRUE(reader->Initialize());
+
+  // Every chunk size must give the same records
+  for (const std::size_t chunk_size : {std::size_t{1}, std::size_t{7}, std::size_t{32}, std::size_t{1} << 20}) {
+    const auto records = ReadAll(reader.get(), chunk_size);
+    ASSERT_EQ(5u, records.size());
+    EXPECT_EQ(Record(1, "short", 1.5), records[0]);
+    EXPECT_EQ(Record(2, "a name, longer than a varlen prefix", 0), records[1]);
+    EXPECT_EQ(Record(3, "Special \"quoted\" string", -1), records[2]);
+    EXPECT_EQ(Record(4, "NULL", -22.5), records[3]);
+    EXPECT_EQ(Record(5, "", 100), records[4]);
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(ParallelCSVReaderTest, SplitInsideQuotedFields) {
+  // Quoted fields full of new lines and delimiters, which look like records to a reader that ignores quotes
+  const uint32_t num_records = 1000;
+  std::string contents;
+  for (uint32_t i = 0; i < num_records; i++) {
+    contents += std::to_string(i) + ",\"line\n" + std::to_string(i) + ",\"\"x\"\",1.0\n\"," + std::to_string(i) + "\n";
+  }
+  WriteFile(contents);
+  auto reader = MakeReader();
+  ASSERT_TRUE(reader->Initialize());
+
+  // Every chunk starts at a record
+  const auto chunks = reader->Split(100);
+  EXPECT_GT(chunks.size(), 1u);
+  std::size_t end = 0;
+  for (const auto &chunk : chunks) {
+    EXPECT_EQ(end, chunk.begin_);
+    EXPECT_LT(chunk.begin_, chunk.end_);
+    end = chunk.end_;
+  }
+  EXPECT_EQ(reader->GetSize(), end);
+
+  const auto records = ReadAll(reader.get(), 100);
+  ASSERT_EQ(num_records, records.size());
+  for (uint32_t i = 0; i < num_records; i++) {
+    EXPECT_EQ(Record(i, "line\n" + std::to_string(i) + ",\"x\",1.0\n", i), records[i]);
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(ParallelCSVReaderTest, MalformedRecords) {
+  const auto read = [&](const std::string &contents) {
+    WriteFile(contents);
+    auto reader = MakeReader();
+    ASSERT_TRUE(reader->Initialize());
+    ReadAll(reader.get(), ParallelCSVReader::DEFAULT_CHUNK_SIZE);
+  };
+  EXPECT_THROW(read("1,two\n"), ExecutionException);
+  EXPECT_THROW(read("1,two,3,4\n"), ExecutionException);
+  EXPECT_THROW(read("1,\"two,3\n"), ExecutionException);
+  EXPECT_THROW(read("1,\"two\"x,3\n"), ExecutionException);
+  EXPECT_THROW(read("one,two,3\n"), ExecutionException);
+  EXPECT_THROW(read("99999999999,two,3\n"), ExecutionException);
+}
+
+}  // namespace terrier::execution::util::test
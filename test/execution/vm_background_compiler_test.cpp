@@ -0,0 +1,132 @@
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <functional>
+#include <stdexcept>
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "execution/tpl_test.h"
+#include "execution/vm/background_compiler.h"
+#include "execution/vm/llvm_engine.h"
+#include "execution/vm/module.h"
+#include "execution/vm/module_compiler.h"
+
+namespace terrier::execution::vm::test {
+
+class BackgroundCompilerTest : public TplTest {
+ public:
+  static void SetUpTestSuite() { LLVMEngine::Initialize(); }
+};
+
+// NOLINTNEXTLINE
+TEST_F(BackgroundCompilerTest, RunsAllTasks) {
+  BackgroundCompiler compiler(2);
+  std::atomic<uint32_t> count{0};
+  for (uint32_t i = 0; i < 100; i++) {
+    compiler.Submit([&] { count++; });
+  }
+  compiler.WaitIdle();
+  EXPECT_EQ(100u, count.load());
+  EXPECT_EQ(100u, compiler.GetNumCompleted());
+}
+
+// NOLINTNEXTLINE
+TEST_F(BackgroundCompilerTest, CancelOrWait) {
+  BackgroundCompiler compiler(1);
+
+  // Occupy the only thread until released.
+  std::atomic<bool> started{false}, release{false}, blocker_done{false};
+  const auto blocker = compiler.Submit([&] {
+    started = true;
+    while (!release) std::this_thread::yield();
+    blocker_done = true;
+  });
+  while (!started) std::this_thread::yield();
+
+  // A queued task is removed and never runs.
+  std::atomic<bool> ran{false};
+  const auto queued = compiler.Submit([&] { ran = true; });
+  EXPECT_TRUE(compiler.CancelOrWait(queued));
+
+  // A running task is waited for.
+  std::thread releaser([&] {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    release = true;
+  });
+  EXPECT_FALSE(compiler.CancelOrWait(blocker));
+  EXPECT_TRUE(blocker_done.load());
+  releaser.join();
+
+  compiler.WaitIdle();
+  EXPECT_FALSE(ran.load());
+  EXPECT_EQ(1u, compiler.GetNumCompleted());
+}
+
+// NOLINTNEXTLINE
+TEST_F(BackgroundCompilerTest, RunConcurrently) {
+  BackgroundCompiler compiler(2);
+
+  std::atomic<uint32_t> count{0};
+  std::vector<std::function<void()>> tasks(10, [&] { count++; });
+  compiler.RunConcurrently(std::move(tasks));
+  EXPECT_EQ(10u, count.load());
+
+  // Completes even if the pool is busy, and when invoked from a task on the pool.
+  std::atomic<bool> release{false};
+  compiler.Submit([&] {
+    while (!release) std::this_thread::yield();
+  });
+  compiler.Submit([&] {
+    std::vector<std::function<void()>> nested(4, [&] { count++; });
+    compiler.RunConcurrently(std::move(nested));
+  });
+  compiler.RunConcurrently({[&] { count++; }, [&] { count++; }});
+  EXPECT_GE(count.load(), 12u);
+  release = true;
+  compiler.WaitIdle();
+  EXPECT_EQ(16u, count.load());
+
+  // Exceptions thrown on the calling thread are propagated once all tasks are done.
+  std::vector<std::function<void()>> failing(4, [&] { count++; });
+  failing[0] = [] { throw std::runtime_error("failed"); };
+  EXPECT_THROW(compiler.RunConcurrently(std::move(failing)), std::runtime_error);
+  EXPECT_EQ(19u, count.load());
+}
+
+// NOLINTNEXTLINE
+TEST_F(BackgroundCompilerTest, AdaptiveModuleSwapsInCompiledCode) {
+  auto compiler = ModuleCompiler();
+  auto module = compiler.CompileToModule("fun add2(a: int32, b: int32) -> int32 { return a + b }");
+  ASSERT_FALSE(compiler.HasErrors());
+  EXPECT_FALSE(module->IsCompiled());
+
+  // Requesting an adaptive function starts compiling in the background. The function works before and after.
+  std::function<int32_t(int32_t, int32_t)> add2;
+  ASSERT_TRUE(module->GetFunction("add2", ExecutionMode::Adaptive, &add2));
+  EXPECT_EQ(20, add2(10, 10));
+
+  BackgroundCompiler::Instance()->WaitIdle();
+  EXPECT_TRUE(module->IsCompiled());
+  EXPECT_EQ(30, add2(10, 20));
+
+  // Further requests don't trigger another compilation.
+  const auto num_completed = BackgroundCompiler::Instance()->GetNumCompleted();
+  ASSERT_TRUE(module->GetFunction("add2", ExecutionMode::Adaptive, &add2));
+  BackgroundCompiler::Instance()->WaitIdle();
+  EXPECT_EQ(num_completed, BackgroundCompiler::Instance()->GetNumCompleted());
+}
+
+// NOLINTNEXTLINE
+TEST_F(BackgroundCompilerTest, DestroyModuleWithPendingCompilation) {
+  // Destroying a module while its compilation is queued or running must be safe.
+  for (uint32_t i = 0; i < 10; i++) {
+    auto compiler = ModuleCompiler();
+    auto module = compiler.CompileToModule("fun test() -> int32 { return 10 }");
+    ASSERT_FALSE(compiler.HasErrors());
+    module->CompileToMachineCodeAsync();
+  }
+  BackgroundCompiler::Instance()->WaitIdle();
+}
+
+}  // namespace terrier::execution::vm::test
@@ -0,0 +1,195 @@
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "execution/tpl_test.h"
+#include "execution/util/timer.h"
+#include "execution/vm/bytecode_module.h"
+#include "execution/vm/module.h"
+#include "execution/vm/module_compiler.h"
+
+namespace terrier::execution::vm::test {
+
+class BytecodeOptimizerTest : public TplTest {
+ public:
+  // Count the occurrences of the given bytecode in the given function.
+  static uint32_t CountBytecode(const Module &module, const std::string &func_name, const Bytecode bytecode) {
+    const auto *bytecode_module = module.GetBytecodeModule();
+    const auto *func_info = bytecode_module->LookupFuncInfoByName(func_name);
+    uint32_t count = 0;
+    for (auto iter = bytecode_module->GetBytecodeForFunction(*func_info); !iter.Done(); iter.Advance()) {
+      count += static_cast<uint32_t>(iter.CurrentBytecode() == bytecode);
+    }
+    return count;
+  }
+
+  // The number of instructions in the given function.
+  static uint32_t CountInstructions(const Module &module, const std::string &func_name) {
+    const auto *bytecode_module = module.GetBytecodeModule();
+    const auto *func_info = bytecode_module->LookupFuncInfoByName(func_name);
+    uint32_t count = 0;
+    for (auto iter = bytecode_module->GetBytecodeForFunction(*func_info); !iter.Done(); iter.Advance()) {
+      count++;
+    }
+    return count;
+  }
+};
+
+// NOLINTNEXTLINE
+TEST_F(BytecodeOptimizerTest, FuseCompareAndBranch) {
+  auto src = R"(
+    fun test(n: int32) -> int32 {
+      var sum: int32 = 0
+      for (var i: int32 = 0; i < n; i = i + 1) {
+        if (i != 3) {
+          sum = sum + i
+        }
+      }
+      return sum
+    })";
+  auto compiler = ModuleCompiler();
+  auto optimized = compiler.CompileToModule(src);
+  auto plain = compiler.CompileToModule(src, false);
+  ASSERT_TRUE(optimized != nullptr && plain != nullptr);
+
+  EXPECT_EQ(1u, CountBytecode(*optimized, "test", Bytecode::LessThanJumpIfFalse_int32_t));
+  EXPECT_EQ(1u, CountBytecode(*optimized, "test", Bytecode::NotEqualJumpIfFalse_int32_t));
+  EXPECT_EQ(0u, CountBytecode(*optimized, "test", Bytecode::JumpIfFalse));
+  EXPECT_EQ(2u, CountBytecode(*plain, "test", Bytecode::JumpIfFalse));
+  EXPECT_LT(CountInstructions(*optimized, "test"), CountInstructions(*plain, "test"));
+
+  std::function<int32_t(int32_t)> f_opt, f_plain;
+  ASSERT_TRUE(optimized->GetFunction("test", ExecutionMode::Interpret, &f_opt));
+  ASSERT_TRUE(plain->GetFunction("test", ExecutionMode::Interpret, &f_plain));
+  for (int32_t n : {0, 1, 3, 4, 10, 100}) {
+    EXPECT_EQ(f_plain(n), f_opt(n));
+  }
+  EXPECT_EQ(42, f_opt(10));
+}
+
+// NOLINTNEXTLINE
+TEST_F(BytecodeOptimizerTest, FuseLoadField) {
+  auto src = R"(
+    struct S {
+      b: int64
+      a: int8
+      c: int32
+    }
+    fun test(s: *S, out: *S) -> int64 {
+      out.a = s.a
+      out.c = s.c
+      return s.b
+    })";
+  auto compiler = ModuleCompiler();
+  auto module = compiler.CompileToModule(src);
+  ASSERT_TRUE(module != nullptr);
+
+  // Only the addresses of the stored-to fields remain. The first field needs no address computation.
+  EXPECT_EQ(2u, CountBytecode(*module, "test", Bytecode::Lea));
+  EXPECT_EQ(1u, CountBytecode(*module, "test", Bytecode::LoadField1));
+  EXPECT_EQ(1u, CountBytecode(*module, "test", Bytecode::LoadField4));
+  EXPECT_EQ(1u, CountBytecode(*module, "test", Bytecode::Deref8));
+
+  struct S {
+    int64_t b_;
+    int8_t a_;
+    int32_t c_;
+  };
+
+  std::function<int64_t(S *, S *)> f;
+  ASSERT_TRUE(module->GetFunction("test", ExecutionMode::Interpret, &f));
+  S s{1000000000000, -1, 7}, out{0, 0, 0};
+  EXPECT_EQ(1000000000000, f(&s, &out));
+  EXPECT_EQ(-1, out.a_);
+  EXPECT_EQ(7, out.c_);
+}
+
+// NOLINTNEXTLINE
+TEST_F(BytecodeOptimizerTest, FuseSqlBoolBranch) {
+  auto src = R"(
+    fun test(x: int32) -> int32 {
+      var a = @intToSql(x)
+      if (a > @intToSql(5)) {
+        return 1
+      }
+      return 0
+    })";
+  auto compiler = ModuleCompiler();
+  auto module = compiler.CompileToModule(src);
+  ASSERT_TRUE(module != nullptr);
+
+  EXPECT_EQ(1u, CountBytecode(*module, "test", Bytecode::ForceBoolTruthJumpIfFalse));
+  EXPECT_EQ(0u, CountBytecode(*module, "test", Bytecode::ForceBoolTruth));
+
+  std::function<int32_t(int32_t)> f;
+  ASSERT_TRUE(module->GetFunction("test", ExecutionMode::Interpret, &f));
+  EXPECT_EQ(0, f(5));
+  EXPECT_EQ(1, f(6));
+}
+
+// NOLINTNEXTLINE
+TEST_F(BytecodeOptimizerTest, ShortCircuitNotFused) {
+  // The result of a short-circuiting operator is written on two paths and cannot be fused.
+  auto src = R"(
+    fun test(a: int32, b: int32) -> int32 {
+      if (a < b and b < 10) {
+        return 1
+      }
+      return 0
+    })";
+  auto compiler = ModuleCompiler();
+  auto optimized = compiler.CompileToModule(src);
+  auto plain = compiler.CompileToModule(src, false);
+  ASSERT_TRUE(optimized != nullptr && plain != nullptr);
+
+  std::function<int32_t(int32_t, int32_t)> f_opt, f_plain;
+  ASSERT_TRUE(optimized->GetFunction("test", ExecutionMode::Interpret, &f_opt));
+  ASSERT_TRUE(plain->GetFunction("test", ExecutionMode::Interpret, &f_plain));
+  for (int32_t a : {0, 5, 20}) {
+    for (int32_t b : {0, 5, 20}) {
+      EXPECT_EQ(f_plain(a, b), f_opt(a, b));
+    }
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(BytecodeOptimizerTest, DISABLED_PerfInterpreterSpeedup) {
+  auto src = R"(
+    struct S {
+      a: int64
+      b: int64
+    }
+    fun test(s: *S, n: int64) -> int64 {
+      var sum: int64 = 0
+      for (var i: int64 = 0; i < n; i = i + 1) {
+        if (i % 2 == 0) {
+          sum = sum + s.a
+        } else {
+          sum = sum + s.b
+        }
+      }
+      return sum
+    })";
+
+  struct S {
+    int64_t a_, b_;
+  } s{1, 2};
+
+  auto bench = [&](bool optimize) {
+    auto compiler = ModuleCompiler();
+    auto module = compiler.CompileToModule(src, optimize);
+    std::function<int64_t(S *, int64_t)> f;
+    EXPECT_TRUE(module->GetFunction("test", ExecutionMode::Interpret, &f));
+    util::Timer<std::milli> timer;
+    timer.Start();
+    EXPECT_EQ(15000000, f(&s, 10000000));
+    timer.Stop();
+    return timer.GetElapsed();
+  };
+
+  const auto plain_ms = bench(false), optimized_ms = bench(true);
+  EXECUTION_LOG_INFO("Interpreted: {:.2f} ms unoptimized, {:.2f} ms optimized ({:.2f}x)", plain_ms, optimized_ms,
+                     plain_ms / optimized_ms);
+}
+
+}  // namespace terrier::execution::vm::test
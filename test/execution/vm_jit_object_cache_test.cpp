@@ -0,0 +1,150 @@
+#include <llvm/Support/FileSystem.h>
+
+#include <memory>
+#include <string>
+
+#include "execution/tpl_test.h"
+#include "execution/vm/bytecode_module.h"
+#include "execution/vm/jit_object_cache.h"
+#include "execution/vm/llvm_engine.h"
+#include "execution/vm/module.h"
+#include "execution/vm/module_compiler.h"
+
+namespace terrier::execution::vm::test {
+
+class JitObjectCacheTest : public TplTest {
+ public:
+  static void SetUpTestSuite() { LLVMEngine::Initialize(); }
+
+  void SetUp() override {
+    TplTest::SetUp();
+    llvm::sys::fs::remove_directories(K_DIRECTORY);
+  }
+
+  void TearDown() override {
+    llvm::sys::fs::remove_directories(K_DIRECTORY);
+    TplTest::TearDown();
+  }
+
+  static std::unique_ptr<llvm::MemoryBuffer> MakeObject(const std::string &contents) {
+    return llvm::MemoryBuffer::getMemBufferCopy(contents);
+  }
+
+  static std::string Fingerprint(const JitObjectCache::Key key) { return "module " + std::to_string(key); }
+
+  static constexpr const char *K_DIRECTORY = "./jit_object_cache_test";
+};
+
+// NOLINTNEXTLINE
+TEST_F(JitObjectCacheTest, InsertAndLookup) {
+  JitObjectCache cache(K_DIRECTORY, 1 << 20);
+  EXPECT_EQ(nullptr, cache.Lookup(1, Fingerprint(1), 10));
+
+  cache.Insert(1, Fingerprint(1), 10, *MakeObject("object one"));
+  cache.Insert(2, Fingerprint(2), 10, *MakeObject("object two"));
+  EXPECT_EQ(2u, cache.GetNumEntries());
+
+  auto object = cache.Lookup(1, Fingerprint(1), 10);
+  ASSERT_NE(nullptr, object);
+  EXPECT_EQ("object one", object->getBuffer().str());
+  EXPECT_EQ(1u, cache.GetNumHits());
+  EXPECT_EQ(1u, cache.GetNumMisses());
+
+  // An entry produced by another version of the code generator is dropped.
+  EXPECT_EQ(nullptr, cache.Lookup(2, Fingerprint(2), 11));
+  EXPECT_EQ(1u, cache.GetNumEntries());
+  EXPECT_EQ(nullptr, cache.Lookup(2, Fingerprint(2), 10));
+
+  cache.Clear();
+  EXPECT_EQ(0u, cache.GetNumEntries());
+  EXPECT_EQ(0u, cache.GetSizeInBytes());
+}
+
+// NOLINTNEXTLINE
+TEST_F(JitObjectCacheTest, EvictLeastRecentlyUsed) {
+  const std::string contents(1000, 'x');
+  JitObjectCache cache(K_DIRECTORY, 2500);
+
+  cache.Insert(1, Fingerprint(1), 0, *MakeObject(contents));
+  cache.Insert(2, Fingerprint(2), 0, *MakeObject(contents));
+  EXPECT_NE(nullptr, cache.Lookup(1, Fingerprint(1), 0));
+
+  // Entry 2 is the least recently used one.
+  cache.Insert(3, Fingerprint(3), 0, *MakeObject(contents));
+  EXPECT_EQ(1u, cache.GetNumEvictions());
+  EXPECT_LE(cache.GetSizeInBytes(), 2500u);
+  EXPECT_NE(nullptr, cache.Lookup(1, Fingerprint(1), 0));
+  EXPECT_EQ(nullptr, cache.Lookup(2, Fingerprint(2), 0));
+  EXPECT_NE(nullptr, cache.Lookup(3, Fingerprint(3), 0));
+}
+
+// NOLINTNEXTLINE
+TEST_F(JitObjectCacheTest, EntriesSurviveReopening) {
+  {
+    JitObjectCache cache(K_DIRECTORY, 1 << 20);
+    cache.Insert(42, Fingerprint(42), 7, *MakeObject("persistent"));
+  }
+
+  JitObjectCache cache(K_DIRECTORY, 1 << 20);
+  EXPECT_EQ(1u, cache.GetNumEntries());
+  auto object = cache.Lookup(42, Fingerprint(42), 7);
+  ASSERT_NE(nullptr, object);
+  EXPECT_EQ("persistent", object->getBuffer().str());
+}
+
+// NOLINTNEXTLINE
+TEST_F(JitObjectCacheTest, IdenticalModulesShareKey) {
+  auto compiler = ModuleCompiler();
+  auto module1 = compiler.CompileToModule("fun test(a: int32) -> int32 { return a + 1 }");
+  auto module2 = compiler.CompileToModule("fun test(a: int32) -> int32 { return a + 1 }");
+  auto module3 = compiler.CompileToModule("fun test(a: int32) -> int32 { return a + 2 }");
+  ASSERT_FALSE(compiler.HasErrors());
+
+  const auto fingerprint = JitObjectCache::ComputeFingerprint(*module1->GetBytecodeModule());
+  EXPECT_EQ(fingerprint, JitObjectCache::ComputeFingerprint(*module2->GetBytecodeModule()));
+  EXPECT_NE(fingerprint, JitObjectCache::ComputeFingerprint(*module3->GetBytecodeModule()));
+  const auto key = JitObjectCache::ComputeKey(fingerprint);
+  EXPECT_EQ(key, JitObjectCache::ComputeKey(JitObjectCache::ComputeFingerprint(*module2->GetBytecodeModule())));
+  EXPECT_NE(key, JitObjectCache::ComputeKey(JitObjectCache::ComputeFingerprint(*module3->GetBytecodeModule())));
+}
+
+// NOLINTNEXTLINE
+TEST_F(JitObjectCacheTest, CollidingKeysNeverShareObjects) {
+  JitObjectCache cache(K_DIRECTORY, 1 << 20);
+
+  // Two modules whose keys collide get nothing but their own object.
+  cache.Insert(1, "first module", 10, *MakeObject("object one"));
+  EXPECT_EQ(nullptr, cache.Lookup(1, "second module", 10));
+  EXPECT_NE(nullptr, cache.Lookup(1, "first module", 10));
+
+  cache.Insert(1, "second module", 10, *MakeObject("object two"));
+  EXPECT_EQ(1u, cache.GetNumEntries());
+  EXPECT_EQ(nullptr, cache.Lookup(1, "first module", 10));
+  auto object = cache.Lookup(1, "second module", 10);
+  ASSERT_NE(nullptr, object);
+  EXPECT_EQ("object two", object->getBuffer().str());
+}
+
+// NOLINTNEXTLINE
+TEST_F(JitObjectCacheTest, CompileLoadsCachedModule) {
+  JitObjectCache cache(K_DIRECTORY, 1 << 20);
+  LLVMEngine::CompilerOptions options;
+  options.SetObjectCache(&cache);
+
+  auto compiler = ModuleCompiler();
+  auto module = compiler.CompileToModule("fun test(a: int32, b: int32) -> int32 { return a * b + 1 }");
+  ASSERT_FALSE(compiler.HasErrors());
+
+  // The first compilation fills the cache, the second one is served from it.
+  for (uint32_t i = 0; i < 2; i++) {
+    auto compiled = LLVMEngine::Compile(*module->GetBytecodeModule(), options);
+    ASSERT_TRUE(compiled->IsLoaded());
+    auto *test = reinterpret_cast<int32_t (*)(int32_t, int32_t)>(compiled->GetFunctionPointer("test"));
+    ASSERT_NE(nullptr, test);
+    EXPECT_EQ(13, test(3, 4));
+  }
+  EXPECT_EQ(1u, cache.GetNumEntries());
+  EXPECT_EQ(1u, cache.GetNumHits());
+}
+
+}  // namespace terrier::execution::vm::test
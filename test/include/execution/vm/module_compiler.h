@@ -30,10 +30,10 @@ class ModuleCompiler {
     return ast;
   }
 
-  std::unique_ptr<Module> CompileToModule(const std::string &source) {
+  std::unique_ptr<Module> CompileToModule(const std::string &source, bool optimize = true) {
     auto *ast = CompileToAst(source);
     if (HasErrors()) return nullptr;
-    return std::make_unique<Module>(vm::BytecodeGenerator::Compile(ast, "test"));
+    return std::make_unique<Module>(vm::BytecodeGenerator::Compile(ast, "test", optimize));
   }
 
   // Does the error reporter have any errors?
@@ -64,7 +64,7 @@ class ManualPacketUtil {
     int64_t ret UNUSED_ATTRIBUTE = connect(socket_fd, reinterpret_cast<sockaddr *>(&serv_addr), sizeof(serv_addr));
     TERRIER_ASSERT(ret >= 0, "Connector Error");
 
-    auto io_socket = std::make_unique<NetworkIoWrapper>(socket_fd);
+    auto io_socket = std::make_unique<NetworkIoWrapper>(socket_fd, true, 0, 0, 0);
     PostgresPacketWriter writer(io_socket->GetWriteQueue());
 
     std::unordered_map<std::string, std::string> params{
@@ -1,3 +1,5 @@
+#include <fstream>
+#include <iterator>
 #include <memory>
 #include <random>
 #include <string>
@@ -8,6 +10,7 @@
 #include "main/db_main.h"
 #include "metrics/metrics_manager.h"
 #include "metrics/metrics_store.h"
+#include "metrics/query_trace.h"
 #include "settings/settings_callbacks.h"
 #include "settings/settings_manager.h"
 #include "storage/sql_table.h"
@@ -199,6 +202,57 @@ TEST_F(MetricsTests, TransactionCSVTest) {
   metrics_manager_->UnregisterThread();
 }
 
+/**
+ *  Testing query trace collection and persistence, single thread
+ */
+// NOLINTNEXTLINE
+TEST_F(MetricsTests, QueryTraceTest) {
+  for (const auto &file : metrics::QueryTraceMetricRawData::FILES) unlink(std::string(file).c_str());
+  const settings::setter_callback_fn setter_callback = MetricsTests::EmptySetterCallback;
+  auto action_context = std::make_unique<common::ActionContext>(common::action_id_t(1));
+  settings_manager_->SetBool(settings::Param::metrics_query_trace, true, common::ManagedPointer(action_context),
+                             setter_callback);
+  metrics_manager_->RegisterThread();
+  EXPECT_TRUE(QueryTrace::Enabled());
+
+  {
+    ScopedQueryTraceSpan parse(TraceSpan::PARSE, 1, 1);
+    ScopedQueryTraceSpan untraced(TraceSpan::BIND, 1, 0);  // not recorded
+  }
+  QueryTrace::Record(TraceSpan::EXECUTE_PIPELINE, 1, 1, MetricsUtil::Now(), 2);
+  QueryTrace::Record(TraceSpan::WAL_FSYNC, 0, 0, MetricsUtil::Now());
+
+  metrics_manager_->Aggregate();
+  const auto aggregated_data = reinterpret_cast<QueryTraceMetricRawData *>(
+      metrics_manager_->AggregatedMetrics().at(static_cast<uint8_t>(MetricsComponent::QUERY_TRACE)).get());
+  EXPECT_NE(aggregated_data, nullptr);
+  EXPECT_EQ(aggregated_data->trace_data_.size(), 3);
+  metrics_manager_->ToCSV();
+  EXPECT_EQ(aggregated_data->trace_data_.size(), 0);
+
+  std::ifstream trace_file(std::string(QueryTraceMetricRawData::FILES[0]));
+  const std::string trace((std::istreambuf_iterator<char>(trace_file)), std::istreambuf_iterator<char>());
+  EXPECT_EQ(trace.front(), '[');
+  EXPECT_NE(trace.find(R"("name":"parse")"), std::string::npos);
+  EXPECT_EQ(trace.find(R"("name":"bind")"), std::string::npos);
+  EXPECT_NE(trace.find(R"("pipeline_id":2)"), std::string::npos);
+  EXPECT_NE(trace.find(R"("name":"wal_fsync")"), std::string::npos);
+
+  // The oldest spans of a thread are overwritten once its ring is full
+  for (uint32_t i = 0; i < QueryTraceMetricRawData::RING_CAPACITY + 10; i++) {
+    QueryTrace::Record(TraceSpan::EXECUTE, 1, i + 1, MetricsUtil::Now());
+  }
+  metrics_manager_->Aggregate();
+  EXPECT_EQ(aggregated_data->trace_data_.size(), QueryTraceMetricRawData::RING_CAPACITY);
+  EXPECT_EQ(aggregated_data->num_overwritten_, 10);
+  metrics_manager_->ToCSV();
+
+  metrics_manager_->UnregisterThread();
+  action_context = std::make_unique<common::ActionContext>(common::action_id_t(2));
+  settings_manager_->SetBool(settings::Param::metrics_query_trace, false, common::ManagedPointer(action_context),
+                             setter_callback);
+}
+
 /**
  *  Testing that we can enable and disable per-component metrics
  *
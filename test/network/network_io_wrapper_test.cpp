@@ -0,0 +1,205 @@
+#include "network/network_io_wrapper.h"
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>  // NOLINT
+
+#include "gtest/gtest.h"
+#include "test_util/test_harness.h"
+
+namespace terrier::network {
+
+class NetworkIoWrapperTests : public TerrierTest {
+ protected:
+  // Read whatever the client socket has, up to the given number of bytes
+  static void ReadSome(const int fd, std::string *const received, const std::size_t max_bytes) {
+    char buffer[4096];
+    const ssize_t bytes = read(fd, buffer, std::min(sizeof(buffer), max_bytes));
+    ASSERT_GT(bytes, 0);
+    received->append(buffer, static_cast<std::size_t>(bytes));
+  }
+};
+
+// NOLINTNEXTLINE
+TEST_F(NetworkIoWrapperTests, FlushAllWritesTest) {
+  std::string contents;
+  for (uint32_t i = 0; i < 100000; i++) contents.push_back(static_cast<char>(i % 251));
+
+  for (const bool vectored_writes : {false, true}) {
+    int fds[2];
+    ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+    // Make the socket take less than the whole queue at once
+    const int send_buffer_size = 16384;
+    ASSERT_EQ(0, setsockopt(fds[0], SOL_SOCKET, SO_SNDBUF, &send_buffer_size, sizeof(send_buffer_size)));
+
+    NetworkIoWrapper io_wrapper(fds[0], vectored_writes, 0, 0, 0);
+    const auto queue = io_wrapper.GetWriteQueue();
+    // Writes of odd sizes, so that they are split up between buffers
+    for (std::size_t offset = 0; offset < contents.size(); offset += 999) {
+      queue->BufferWriteRaw(contents.data() + offset, std::min<std::size_t>(999, contents.size() - offset));
+    }
+    EXPECT_TRUE(io_wrapper.ShouldFlush());
+
+    // The flush picks up where it stopped once the client has read some of the bytes
+    std::string received;
+    Transition result;
+    while ((result = io_wrapper.FlushAllWrites()) == Transition::NEED_WRITE) ReadSome(fds[1], &received, 8192);
+    EXPECT_EQ(Transition::PROCEED, result);
+    EXPECT_FALSE(io_wrapper.ShouldFlush());
+    while (received.size() < contents.size()) ReadSome(fds[1], &received, contents.size() - received.size());
+    EXPECT_EQ(contents, received);
+
+    io_wrapper.Close();
+    close(fds[1]);
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(NetworkIoWrapperTests, BackPressureTest) {
+  std::string contents;
+  for (uint32_t i = 0; i < 100000; i++) contents.push_back(static_cast<char>(i % 251));
+
+  int fds[2];
+  ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+  const int send_buffer_size = 16384;
+  ASSERT_EQ(0, setsockopt(fds[0], SOL_SOCKET, SO_SNDBUF, &send_buffer_size, sizeof(send_buffer_size)));
+  NetworkIoWrapper io_wrapper(fds[0], true, 0, 2 * SOCKET_BUFFER_CAPACITY, 0);
+  const auto queue = io_wrapper.GetWriteQueue();
+
+  // The client reads slowly, so the writer has to wait for it whenever the queue is over the limit
+  std::string received;
+  std::thread client([&] {
+    while (received.size() < contents.size()) ReadSome(fds[1], &received, 1024);
+  });
+  for (std::size_t offset = 0; offset < contents.size(); offset += 999) {
+    queue->BufferWriteRaw(contents.data() + offset, std::min<std::size_t>(999, contents.size() - offset));
+    io_wrapper.ApplyBackPressure();
+    EXPECT_LE(queue->QueuedBytes(), 3 * SOCKET_BUFFER_CAPACITY);
+  }
+  // The rest of the result is due for a flush once the writer waited
+  EXPECT_TRUE(io_wrapper.ShouldFlush());
+  while (io_wrapper.FlushAllWrites() == Transition::NEED_WRITE) std::this_thread::yield();
+  client.join();
+  EXPECT_EQ(contents, received);
+
+  io_wrapper.Close();
+  close(fds[1]);
+}
+
+// NOLINTNEXTLINE
+TEST_F(NetworkIoWrapperTests, BackPressureTimeoutTest) {
+  std::string contents;
+  for (uint32_t i = 0; i < 100000; i++) contents.push_back(static_cast<char>(i % 251));
+
+  int fds[2];
+  ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+  const int send_buffer_size = 16384;
+  ASSERT_EQ(0, setsockopt(fds[0], SOL_SOCKET, SO_SNDBUF, &send_buffer_size, sizeof(send_buffer_size)));
+  NetworkIoWrapper io_wrapper(fds[0], true, 0, SOCKET_BUFFER_CAPACITY, 100);
+  const auto queue = io_wrapper.GetWriteQueue();
+
+  // The client never reads, so the writer gives up once the timeout expired instead of waiting forever
+  queue->BufferWriteRaw(contents.data(), contents.size());
+  EXPECT_THROW(io_wrapper.ApplyBackPressure(), ExecutionException);
+  EXPECT_TRUE(io_wrapper.ShouldFlush());
+
+  io_wrapper.Close();
+  close(fds[1]);
+}
+
+// NOLINTNEXTLINE
+TEST_F(NetworkIoWrapperTests, FillReadBufferTest) {
+  int fds[2];
+  ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+  NetworkIoWrapper io_wrapper(fds[0], true, 0, 0, 0);
+  const auto in = io_wrapper.GetReadBuffer();
+
+  EXPECT_EQ(Transition::NEED_READ, io_wrapper.FillReadBuffer());
+
+  const std::string query = "SELECT 1;";
+  ASSERT_EQ(static_cast<ssize_t>(query.size()), write(fds[1], query.data(), query.size()));
+  EXPECT_EQ(Transition::PROCEED, io_wrapper.FillReadBuffer());
+  EXPECT_EQ(query.size(), in->BytesAvailable());
+
+  // The whole request was read, and the client closing the connection is noticed by the next read
+  in->Skip(query.size());
+  close(fds[1]);
+  EXPECT_EQ(Transition::TERMINATE, io_wrapper.FillReadBuffer());
+  io_wrapper.Close();
+}
+
+// NOLINTNEXTLINE
+TEST_F(NetworkIoWrapperTests, SharedMemoryTest) {
+  int fds[2];
+  ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+  NetworkIoWrapper io_wrapper(fds[0], true, 4096, 0, 0);
+  const auto in = io_wrapper.GetReadBuffer();
+  const auto out = io_wrapper.GetWriteQueue();
+
+  // The client gets the answer along with the segment
+  ASSERT_TRUE(io_wrapper.StartSharedMemory('S'));
+  char answer;
+  iovec data{&answer, 1};
+  alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))];
+  msghdr message{};
+  message.msg_iov = &data;
+  message.msg_iovlen = 1;
+  message.msg_control = control;
+  message.msg_controllen = sizeof(control);
+  ASSERT_EQ(1, recvmsg(fds[1], &message, 0));
+  EXPECT_EQ('S', answer);
+  int segment_fd;
+  std::memcpy(&segment_fd, CMSG_DATA(CMSG_FIRSTHDR(&message)), sizeof(int));
+  const auto client = SharedMemoryChannel::Attach(segment_fd);
+  ASSERT_NE(nullptr, client);
+
+  // The server sleeps until the client sends something, and the client wakes it up through the socket
+  EXPECT_EQ(Transition::NEED_READ, io_wrapper.FillReadBuffer());
+  EXPECT_TRUE(io_wrapper.PrepareToWait());
+  const std::string query = "SELECT 1;";
+  ASSERT_EQ(query.size(), client->Send(query.data(), query.size()));
+  ASSERT_TRUE(client->PeerWaiting());
+  ASSERT_EQ(1, write(fds[1], "", 1));
+  EXPECT_EQ(Transition::PROCEED, io_wrapper.FillReadBuffer());
+  EXPECT_EQ(query.size(), in->BytesAvailable());
+  in->Skip(query.size());
+
+  // A result larger than the ring waits for the client to make room
+  std::string contents;
+  for (uint32_t i = 0; i < 100000; i++) contents.push_back(static_cast<char>(i % 251));
+  out->BufferWriteRaw(contents.data(), contents.size());
+  out->ForceFlush();
+  std::string received;
+  char buffer[4096];
+  while (io_wrapper.FlushAllWrites() == Transition::NEED_READ) {
+    EXPECT_TRUE(io_wrapper.PrepareToWait());
+    const size_t bytes = client->Receive(buffer, sizeof(buffer));
+    ASSERT_GT(bytes, 0);
+    received.append(buffer, bytes);
+    EXPECT_TRUE(client->PeerWaiting());
+  }
+  for (size_t bytes; (bytes = client->Receive(buffer, sizeof(buffer))) > 0;) received.append(buffer, bytes);
+  EXPECT_EQ(contents, received);
+
+  // The client closing the socket ends the connection
+  close(fds[1]);
+  EXPECT_EQ(Transition::TERMINATE, io_wrapper.FillReadBuffer());
+  io_wrapper.Close();
+}
+
+// NOLINTNEXTLINE
+TEST_F(NetworkIoWrapperTests, SharedMemoryDisabledTest) {
+  int fds[2];
+  ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+  NetworkIoWrapper io_wrapper(fds[0], true, 0, 0, 0);
+  EXPECT_FALSE(io_wrapper.StartSharedMemory('S'));
+  io_wrapper.Close();
+  close(fds[1]);
+}
+
+}  // namespace terrier::network
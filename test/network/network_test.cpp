@@ -55,7 +55,7 @@ class NetworkTests : public TerrierTest {
   uint16_t connection_thread_count_ = 4;
   FakeCommandFactory fake_command_factory_;
   PostgresProtocolInterpreter::Provider protocol_provider_{
-      common::ManagedPointer<PostgresCommandFactory>(&fake_command_factory_)};
+      common::ManagedPointer<PostgresCommandFactory>(&fake_command_factory_), nullptr, 1024};
 
   void SetUp() override {
     timestamp_manager_ = new transaction::TimestampManager;
@@ -71,7 +71,8 @@ class NetworkTests : public TerrierTest {
                                     common::ManagedPointer(gc_));
 
     tcop_ = new trafficcop::TrafficCop(common::ManagedPointer(txn_manager_), common::ManagedPointer(catalog_), DISABLED,
-                                       DISABLED, DISABLED, 0, false, execution::vm::ExecutionMode::Interpret);
+                                       DISABLED, DISABLED, 0, false, execution::vm::ExecutionMode::Interpret, 0,
+                                       false, false, false, 0, 0, common::Constants::OUTPUT_BATCH_SIZE);
 
     auto txn = txn_manager_->BeginTransaction();
     catalog_->CreateDatabase(common::ManagedPointer(txn), catalog::DEFAULT_DATABASE, true);
@@ -81,11 +82,11 @@ class NetworkTests : public TerrierTest {
     spdlog::flush_every(std::chrono::seconds(1));
 
     try {
-      handle_factory_ = std::make_unique<ConnectionHandleFactory>(common::ManagedPointer(tcop_));
+      handle_factory_ = std::make_unique<ConnectionHandleFactory>(common::ManagedPointer(tcop_), true, 0, 0, 0);
       server_ = std::make_unique<TerrierServer>(
           common::ManagedPointer<ProtocolInterpreter::Provider>(&protocol_provider_),
           common::ManagedPointer(handle_factory_.get()), common::ManagedPointer(&thread_registry_), port_,
-          connection_thread_count_, socket_directory_);
+          connection_thread_count_, socket_directory_, nullptr);
       server_->RunServer();
     } catch (NetworkProcessException &exception) {
       NETWORK_LOG_ERROR("[LaunchServer] exception when launching server");
@@ -0,0 +1,150 @@
+#include "network/postgres/postgres_packet_writer.h"
+
+#include <unistd.h>
+
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "common/math_util.h"
+#include "execution/sql/value.h"
+#include "gtest/gtest.h"
+#include "parser/expression/constant_value_expression.h"
+#include "planner/plannodes/output_schema.h"
+#include "test_util/test_harness.h"
+
+namespace terrier::network {
+
+class PostgresPacketWriterTests : public TerrierTest {
+ protected:
+  using Field = std::optional<std::string>;
+
+  void SetUp() override {
+    for (const auto type : {type::TypeId::BIGINT, type::TypeId::DECIMAL, type::TypeId::VARCHAR}) {
+      columns_.emplace_back("col", type, std::make_unique<parser::ConstantValueExpression>(type));
+      const auto alignment = execution::sql::ValUtil::GetSqlAlignment(type);
+      tuple_size_ = static_cast<uint32_t>(common::MathUtil::AlignTo(tuple_size_, alignment));
+      offsets_.push_back(tuple_size_);
+      tuple_size_ += execution::sql::ValUtil::GetSqlSize(type);
+    }
+    tuple_size_ = static_cast<uint32_t>(common::MathUtil::AlignTo(tuple_size_, alignof(uint64_t)));
+  }
+
+  // Lay out a row of the output batch the way the execution engine does
+  void AddRow(const execution::sql::Integer &id, const execution::sql::Real &price,
+              const execution::sql::StringVal &name) {
+    tuples_.resize(tuples_.size() + tuple_size_);
+    byte *const tuple = tuples_.data() + tuples_.size() - tuple_size_;
+    std::memcpy(tuple + offsets_[0], &id, sizeof(id));
+    std::memcpy(tuple + offsets_[1], &price, sizeof(price));
+    std::memcpy(tuple + offsets_[2], &name, sizeof(name));
+  }
+
+  // Send everything that was written to the queue through a pipe and return it
+  static std::string Drain(WriteQueue *const queue) {
+    int fds[2];
+    EXPECT_EQ(0, pipe(fds));
+    for (auto head = queue->FlushHead(); head != nullptr; head = queue->FlushHead()) {
+      while (head->HasMore()) head->WriteOutTo(fds[1]);
+      queue->MarkHeadFlushed();
+    }
+    close(fds[1]);
+    std::string contents;
+    char buffer[4096];
+    ssize_t bytes;
+    while ((bytes = read(fds[0], buffer, sizeof(buffer))) > 0) contents.append(buffer, static_cast<std::size_t>(bytes));
+    close(fds[0]);
+    return contents;
+  }
+
+  // Parse the DataRow messages of the output into their fields, NULL fields being empty
+  static std::vector<std::vector<Field>> ParseDataRows(const std::string &contents) {
+    std::vector<std::vector<Field>> rows;
+    std::size_t pos = 0;
+    const auto read_int = [&](const std::size_t size) {
+      uint32_t value = 0;
+      for (std::size_t i = 0; i < size; i++) value = (value << 8) | static_cast<unsigned char>(contents[pos++]);
+      return value;
+    };
+    while (pos < contents.size()) {
+      EXPECT_EQ(static_cast<char>(NetworkMessageType::PG_DATA_ROW), contents[pos++]);
+      // The length of a message includes the length field itself
+      const std::size_t start = pos;
+      const std::size_t end = start + read_int(sizeof(int32_t));
+      std::vector<Field> row(read_int(sizeof(int16_t)));
+      for (auto &field : row) {
+        const auto length = static_cast<int32_t>(read_int(sizeof(int32_t)));
+        if (length < 0) continue;
+        field = contents.substr(pos, static_cast<std::size_t>(length));
+        pos += static_cast<std::size_t>(length);
+      }
+      EXPECT_EQ(end, pos);
+      rows.emplace_back(std::move(row));
+    }
+    return rows;
+  }
+
+  std::vector<planner::OutputSchema::Column> columns_;
+  std::vector<uint32_t> offsets_;
+  uint32_t tuple_size_ = 0;
+  std::vector<byte> tuples_;
+};
+
+// NOLINTNEXTLINE
+TEST_F(PostgresPacketWriterTests, TextDataRowsTest) {
+  const std::string long_name = "a name that is too long to be inlined";
+  AddRow(execution::sql::Integer(0), execution::sql::Real(1.5), execution::sql::StringVal("abc"));
+  AddRow(execution::sql::Integer(std::numeric_limits<int64_t>::min()), execution::sql::Real(1e20),
+         execution::sql::StringVal(long_name.c_str()));
+  AddRow(execution::sql::Integer(-42), execution::sql::Real(0.1 + 0.2), execution::sql::StringVal::Null());
+  AddRow(execution::sql::Integer::Null(), execution::sql::Real(100000.0), execution::sql::StringVal(""));
+  AddRow(execution::sql::Integer(7), execution::sql::Real::Null(), execution::sql::StringVal("x"));
+  AddRow(execution::sql::Integer(8), execution::sql::Real(std::numeric_limits<double>::infinity()),
+         execution::sql::StringVal("y"));
+  AddRow(execution::sql::Integer(9), execution::sql::Real(0.00001), execution::sql::StringVal("z"));
+  const uint32_t num_rows = 7;
+
+  // Numbers are written like Postgres writes them
+  const std::vector<std::vector<Field>> expected = {
+      {"0", "1.5", "abc"},
+      {"-9223372036854775808", "1e+20", long_name},
+      {"-42", "0.30000000000000004", std::nullopt},
+      {std::nullopt, "100000", ""},
+      {"7", std::nullopt, "x"},
+      {"8", "Infinity", "y"},
+      {"9", "1e-05", "z"},
+  };
+
+  WriteQueue queue;
+  auto writer = PostgresPacketWriter(common::ManagedPointer(&queue));
+  writer.WriteDataRows(tuples_.data(), num_rows, tuple_size_, columns_, {FieldFormat::text});
+  const auto batch = Drain(&queue);
+  EXPECT_EQ(expected, ParseDataRows(batch));
+
+  // The rows of a batch are the same as the rows written one at a time
+  queue.Reset();
+  for (uint32_t row = 0; row < num_rows; row++) {
+    writer.WriteDataRow(tuples_.data() + row * tuple_size_, columns_, {FieldFormat::text});
+  }
+  EXPECT_EQ(batch, Drain(&queue));
+}
+
+// NOLINTNEXTLINE
+TEST_F(PostgresPacketWriterTests, MixedFormatDataRowsTest) {
+  AddRow(execution::sql::Integer(258), execution::sql::Real(-2.25), execution::sql::StringVal("abc"));
+
+  WriteQueue queue;
+  auto writer = PostgresPacketWriter(common::ManagedPointer(&queue));
+  writer.WriteDataRows(tuples_.data(), 1, tuple_size_, columns_,
+                       {FieldFormat::binary, FieldFormat::text, FieldFormat::text});
+  const auto rows = ParseDataRows(Drain(&queue));
+  ASSERT_EQ(1u, rows.size());
+  EXPECT_EQ(std::string("\0\0\0\0\0\0\x01\x02", 8), rows[0][0]);
+  EXPECT_EQ("-2.25", rows[0][1]);
+  EXPECT_EQ("abc", rows[0][2]);
+}
+
+}  // namespace terrier::network
@@ -0,0 +1,126 @@
+#include "network/shared_memory_channel.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <memory>
+#include <string>
+
+#include "common/error/exception.h"
+#include "gtest/gtest.h"
+#include "test_util/test_harness.h"
+
+namespace terrier::network {
+
+class SharedMemoryChannelTests : public TerrierTest {};
+
+// NOLINTNEXTLINE
+TEST_F(SharedMemoryChannelTests, SendReceiveTest) {
+  auto server = SharedMemoryChannel::Create(1000);
+  ASSERT_NE(nullptr, server);
+  EXPECT_EQ(1024, server->RingSize());
+  auto client = SharedMemoryChannel::Attach(dup(server->GetFd()));
+  ASSERT_NE(nullptr, client);
+  EXPECT_EQ(1024, client->RingSize());
+
+  // Messages of odd sizes, so that they wrap around the end of the rings
+  std::string message;
+  for (uint32_t i = 0; i < 700; i++) message.push_back(static_cast<char>(i % 251));
+  char received[1024];
+  for (uint32_t round = 0; round < 10; round++) {
+    EXPECT_EQ(message.size(), client->Send(message.data(), message.size()));
+    EXPECT_EQ(message.size(), server->Receive(received, sizeof(received)));
+    EXPECT_EQ(message, std::string(received, message.size()));
+
+    EXPECT_EQ(message.size(), server->Send(message.data(), message.size()));
+    EXPECT_EQ(message.size(), client->Receive(received, sizeof(received)));
+    EXPECT_EQ(message, std::string(received, message.size()));
+  }
+
+  // A full ring takes no more bytes, and an empty one gives none
+  EXPECT_EQ(message.size(), server->Send(message.data(), message.size()));
+  EXPECT_EQ(1024 - message.size(), server->Send(message.data(), message.size()));
+  EXPECT_EQ(0, server->Send(message.data(), message.size()));
+  EXPECT_EQ(1024, client->Receive(received, sizeof(received)));
+  EXPECT_EQ(0, client->Receive(received, sizeof(received)));
+}
+
+// NOLINTNEXTLINE
+TEST_F(SharedMemoryChannelTests, WaitTest) {
+  auto server = SharedMemoryChannel::Create(64);
+  ASSERT_NE(nullptr, server);
+  auto client = SharedMemoryChannel::Attach(dup(server->GetFd()));
+  ASSERT_NE(nullptr, client);
+  const std::string message(40, 'x');
+  char received[64];
+
+  // The peer is woken up once it can make progress, and only once
+  EXPECT_FALSE(client->PeerWaiting());
+  EXPECT_TRUE(server->PrepareToWaitForData());
+  EXPECT_FALSE(client->PeerWaiting());
+  EXPECT_EQ(message.size(), client->Send(message.data(), message.size()));
+  EXPECT_TRUE(client->PeerWaiting());
+  EXPECT_FALSE(client->PeerWaiting());
+  // No need to sleep with bytes to receive
+  EXPECT_FALSE(server->PrepareToWaitForData());
+  EXPECT_FALSE(client->PeerWaiting());
+
+  EXPECT_EQ(24, client->Send(message.data(), message.size()));
+  EXPECT_TRUE(client->PrepareToWaitForSpace());
+  EXPECT_EQ(64, server->Receive(received, sizeof(received)));
+  EXPECT_TRUE(server->PeerWaiting());
+  EXPECT_FALSE(server->PeerWaiting());
+  EXPECT_FALSE(client->PrepareToWaitForSpace());
+}
+
+// NOLINTNEXTLINE
+TEST_F(SharedMemoryChannelTests, CorruptCountersTest) {
+  auto server = SharedMemoryChannel::Create(64);
+  ASSERT_NE(nullptr, server);
+  auto client = SharedMemoryChannel::Attach(dup(server->GetFd()));
+  ASSERT_NE(nullptr, client);
+  const std::string message(40, 'x');
+  char received[64];
+
+  // The client claims to have sent more bytes than the ring holds
+  client->out_->tail_.store(65);
+  EXPECT_THROW(server->Receive(received, sizeof(received)), NetworkProcessException);
+  // or moves the tail of its inbound ring behind the head, so that the server would see room it doesn't have
+  client->out_->tail_.store(0);
+  client->in_->tail_.store(0);
+  client->in_->head_.store(1);
+  EXPECT_THROW(server->Send(message.data(), message.size()), NetworkProcessException);
+
+  // Counters within the ring are fine wherever they are
+  client->in_->head_.store(1000);
+  client->in_->tail_.store(1000 + 64);
+  EXPECT_EQ(0, server->Send(message.data(), message.size()));
+  client->in_->head_.store(1000 + 64);
+  EXPECT_EQ(message.size(), server->Send(message.data(), message.size()));
+  EXPECT_EQ(message.size(), client->Receive(received, sizeof(received)));
+}
+
+// NOLINTNEXTLINE
+TEST_F(SharedMemoryChannelTests, SealedSegmentTest) {
+  auto server = SharedMemoryChannel::Create(64);
+  ASSERT_NE(nullptr, server);
+
+  // The client can't resize the segment that the server has mapped, nor lift the seals
+  const int fd = dup(server->GetFd());
+  ASSERT_GE(fd, 0);
+  EXPECT_NE(0, ftruncate(fd, 0));
+  EXPECT_NE(0, ftruncate(fd, 1 << 20));
+  EXPECT_NE(0, fcntl(fd, F_ADD_SEALS, F_SEAL_WRITE));
+  EXPECT_EQ(F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL, fcntl(fd, F_GET_SEALS));
+  close(fd);
+}
+
+// NOLINTNEXTLINE
+TEST_F(SharedMemoryChannelTests, AttachTest) {
+  // Anything but a segment of a channel is refused
+  const int fd = open("/dev/null", O_RDONLY);
+  ASSERT_GE(fd, 0);
+  EXPECT_EQ(nullptr, SharedMemoryChannel::Attach(fd));
+}
+
+}  // namespace terrier::network
@@ -0,0 +1,63 @@
+#include "network/postgres/statement_cache.h"
+
+#include <memory>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "parser/postgresparser.h"
+#include "test_util/test_harness.h"
+
+namespace terrier::network {
+
+class StatementCacheTests : public TerrierTest {
+ public:
+  static std::unique_ptr<Statement> MakeStatement(std::string query_text) {
+    auto parse_result = parser::PostgresParser::BuildParseTree(query_text);
+    return std::make_unique<Statement>(std::move(query_text), std::move(parse_result));
+  }
+};
+
+// Check that the least recently used statements are evicted once the cache is full
+// NOLINTNEXTLINE
+TEST_F(StatementCacheTests, EvictLeastRecentlyUsedTest) {
+  StatementCache cache(2);
+  cache.Add(MakeStatement("SELECT 1;"));
+  cache.Add(MakeStatement("SELECT 2;"));
+  EXPECT_NE(cache.Lookup("SELECT 1;"), nullptr);
+
+  // SELECT 2 was used less recently than SELECT 1
+  cache.Add(MakeStatement("SELECT 3;"));
+  EXPECT_EQ(cache.Size(), 2);
+  EXPECT_NE(cache.Lookup("SELECT 1;"), nullptr);
+  EXPECT_EQ(cache.Lookup("SELECT 2;"), nullptr);
+  EXPECT_NE(cache.Lookup("SELECT 3;"), nullptr);
+}
+
+// Check that the statements that are referred to are not evicted until they are released
+// NOLINTNEXTLINE
+TEST_F(StatementCacheTests, PinTest) {
+  StatementCache cache(1);
+  cache.Add(MakeStatement("SELECT 1;"));
+  const auto pinned = cache.Lookup("SELECT 1;");
+  cache.Pin(pinned);
+  cache.Pin(pinned);
+
+  cache.Add(MakeStatement("SELECT 2;"));
+  EXPECT_EQ(cache.Size(), 2);
+  EXPECT_EQ(cache.Lookup("SELECT 1;"), pinned);
+
+  // The statement that was just added is kept even if the cache is over its capacity
+  cache.Unpin(pinned);
+  cache.Add(MakeStatement("SELECT 3;"));
+  EXPECT_EQ(cache.Size(), 2);
+  EXPECT_EQ(cache.Lookup("SELECT 1;"), pinned);
+  EXPECT_EQ(cache.Lookup("SELECT 2;"), nullptr);
+
+  cache.Unpin(pinned);
+  cache.Add(MakeStatement("SELECT 4;"));
+  EXPECT_EQ(cache.Size(), 1);
+  EXPECT_EQ(cache.Lookup("SELECT 1;"), nullptr);
+  EXPECT_NE(cache.Lookup("SELECT 4;"), nullptr);
+}
+
+}  // namespace terrier::network
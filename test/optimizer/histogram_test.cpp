@@ -147,4 +147,25 @@ TEST_F(HistogramTests, OutputTest) {
   EXPECT_FALSE(os.str().empty());
 }
 
+
+// Two histograms over both halves of a uniform distribution merge into the histogram of the whole distribution
+// NOLINTNEXTLINE
+TEST_F(HistogramTests, MergeTest) {
+  Histogram<int> h_low{100};
+  Histogram<int> h_high{100};
+  for (int i = 0; i < 1000; i++) {
+    for (int j = 1; j <= 50; j++) h_low.Increment(j);
+    for (int j = 51; j <= 100; j++) h_high.Increment(j);
+  }
+
+  h_low.Merge(h_high);
+  EXPECT_EQ(h_low.GetTotalValueCount(), 100000);
+  EXPECT_EQ(h_low.GetMinValue(), 1);
+  EXPECT_EQ(h_low.GetMaxValue(), 100);
+  std::vector<double> res = h_low.Uniform();
+  for (int i = 1; i < 100; i++) {
+    EXPECT_EQ(i, std::floor(res[i - 1]));
+  }
+}
+
 }  // namespace terrier::optimizer
@@ -183,4 +183,21 @@ TEST_F(HyperLogLogTests, LargeDatasetTest) {
   HyperLogLogTests::CheckErrorBounds(threshold, actual, estimate, error);
 }
 
+
+// Two HLLs over overlapping halves of the values merge into an estimate of the union
+// NOLINTNEXTLINE
+TEST_F(HyperLogLogTests, MergeTest) {
+  HyperLogLog<int> hll_a{12};
+  HyperLogLog<int> hll_b{12};
+  const int n = 100000;
+  for (int i = 0; i < n; i++) {
+    hll_a.Update(i);
+    hll_b.Update(i + n / 2);
+  }
+
+  hll_a.Merge(hll_b);
+  const int actual = n + n / 2;
+  HyperLogLogTests::CheckErrorBounds(2 * n, actual, hll_a.EstimateCardinality(), hll_a.RelativeError() + 0.01);
+}
+
 }  // namespace terrier::optimizer
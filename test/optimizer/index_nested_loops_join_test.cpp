@@ -97,11 +97,9 @@ struct IdxJoinTest : public TerrierTest {
     txn_manager_ = db_main_->GetTransactionLayer()->GetTransactionManager();
 
     tcop_ = db_main_->GetTrafficCop();
-    auto oids = tcop_->CreateTempNamespace(network::connection_id_t(0), "terrier");
+    db_oid_ = tcop_->GetDatabaseOid("terrier");
     context_.SetDatabaseName("terrier");
-    context_.SetDatabaseOid(oids.first);
-    context_.SetTempNamespaceOid(oids.second);
-    db_oid_ = oids.first;
+    context_.SetDatabaseOid(db_oid_);
 
     ExecuteSQL("CREATE TABLE foo (col1 INT, col2 INT, col3 INT);", network::QueryType::QUERY_CREATE_TABLE);
     ExecuteSQL("CREATE TABLE bar (col1 INT, col2 INT, col3 INT);", network::QueryType::QUERY_CREATE_TABLE);
@@ -0,0 +1,116 @@
+#include "optimizer/join_order_enumerator.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "test_util/test_harness.h"
+
+namespace terrier::optimizer {
+
+class JoinOrderEnumeratorTests : public TerrierTest {
+ protected:
+  static uint64_t Bit(uint32_t relation) { return uint64_t{1} << relation; }
+
+  // Add num_relations relations of 100 rows each
+  static void AddRelations(JoinOrderEnumerator *enumerator, uint32_t num_relations) {
+    for (uint32_t relation = 0; relation < num_relations; relation++) {
+      enumerator->AddRelation(100);
+    }
+  }
+};
+
+// DPccp considers exactly the connected subgraph/complement pairs of the join graph
+// NOLINTNEXTLINE
+TEST_F(JoinOrderEnumeratorTests, NumPairsTest) {
+  for (uint64_t n = 2; n <= 8; n++) {
+    JoinOrderEnumerator chain;
+    AddRelations(&chain, n);
+    for (uint32_t relation = 0; relation + 1 < n; relation++) {
+      chain.AddPredicate(Bit(relation) | Bit(relation + 1), 0.1);
+    }
+    EXPECT_TRUE(chain.Enumerate());
+    EXPECT_EQ((n * n * n - n) / 6, chain.GetNumPairs());
+
+    JoinOrderEnumerator star;
+    AddRelations(&star, n);
+    for (uint32_t relation = 1; relation < n; relation++) star.AddPredicate(Bit(0) | Bit(relation), 0.1);
+    EXPECT_TRUE(star.Enumerate());
+    EXPECT_EQ((n - 1) * (uint64_t{1} << (n - 2)), star.GetNumPairs());
+
+    JoinOrderEnumerator clique;
+    AddRelations(&clique, n);
+    for (uint32_t left = 0; left < n; left++) {
+      for (uint32_t right = left + 1; right < n; right++) clique.AddPredicate(Bit(left) | Bit(right), 0.1);
+    }
+    EXPECT_TRUE(clique.Enumerate());
+    uint64_t pow3 = 1;
+    for (uint64_t i = 0; i < n; i++) pow3 *= 3;
+    EXPECT_EQ((pow3 - (uint64_t{1} << (n + 1)) + 1) / 2, clique.GetNumPairs());
+  }
+}
+
+// The cheapest plan joins the small relations first, even if that means a bushy tree
+// NOLINTNEXTLINE
+TEST_F(JoinOrderEnumeratorTests, ChainPlanTest) {
+  JoinOrderEnumerator enumerator;
+  enumerator.AddRelation(10);
+  enumerator.AddRelation(1000);
+  enumerator.AddRelation(1000000);
+  enumerator.AddRelation(5);
+  enumerator.AddPredicate(Bit(0) | Bit(1), 0.001);
+  enumerator.AddPredicate(Bit(1) | Bit(2), 0.000001);
+  enumerator.AddPredicate(Bit(2) | Bit(3), 0.2);
+  EXPECT_TRUE(enumerator.Enumerate());
+
+  const auto all = enumerator.GetAllRelations();
+  EXPECT_EQ(0xF, all);
+  EXPECT_EQ(0x7, enumerator.GetLeft(all));
+  EXPECT_EQ(0x8, enumerator.GetRight(all));
+  EXPECT_DOUBLE_EQ(30, enumerator.GetCost(all));
+  EXPECT_DOUBLE_EQ(enumerator.GetCardinality(all), enumerator.GetCardinality(0x7) * 5 * 0.2);
+}
+
+// Without a connected join graph, the relations are joined greedily, with cross products
+// NOLINTNEXTLINE
+TEST_F(JoinOrderEnumeratorTests, DisconnectedTest) {
+  JoinOrderEnumerator enumerator;
+  enumerator.AddRelation(10);
+  enumerator.AddRelation(20);
+  enumerator.AddRelation(30);
+  enumerator.AddPredicate(Bit(0) | Bit(1), 0.1);
+  EXPECT_FALSE(enumerator.Enumerate());
+
+  const auto all = enumerator.GetAllRelations();
+  EXPECT_DOUBLE_EQ(600, enumerator.GetCardinality(all));
+  EXPECT_EQ(0x3, enumerator.GetLeft(all));
+  EXPECT_EQ(0x4, enumerator.GetRight(all));
+}
+
+// Above the threshold, the relations are joined greedily, which still avoids cross products
+// NOLINTNEXTLINE
+TEST_F(JoinOrderEnumeratorTests, GreedyTest) {
+  JoinOrderEnumerator enumerator(3);
+  AddRelations(&enumerator, 5);
+  for (uint32_t relation = 0; relation + 1 < 5; relation++) {
+    enumerator.AddPredicate(Bit(relation) | Bit(relation + 1), 0.01);
+  }
+  EXPECT_FALSE(enumerator.Enumerate());
+  EXPECT_EQ(0, enumerator.GetNumPairs());
+
+  // Every join of the chosen plan is connected by a predicate
+  std::vector<uint64_t> joins{enumerator.GetAllRelations()};
+  while (!joins.empty()) {
+    const auto relations = joins.back();
+    joins.pop_back();
+    if (__builtin_popcountll(relations) < 2) continue;
+    const auto left = enumerator.GetLeft(relations);
+    const auto right = enumerator.GetRight(relations);
+    EXPECT_EQ(relations, left | right);
+    EXPECT_TRUE(((left << 1) & right) != 0 || ((right << 1) & left) != 0);
+    joins.push_back(left);
+    joins.push_back(right);
+  }
+  EXPECT_DOUBLE_EQ(100, enumerator.GetCardinality(enumerator.GetAllRelations()));
+}
+
+}  // namespace terrier::optimizer
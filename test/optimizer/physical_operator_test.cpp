@@ -758,6 +758,94 @@ TEST(OperatorTests, InnerHashJoinTest) {
   delete txn_context;
 }
 
+// NOLINTNEXTLINE
+TEST(OperatorTests, InnerMergeJoinTest) {
+  //===--------------------------------------------------------------------===//
+  // InnerMergeJoin
+  //===--------------------------------------------------------------------===//
+  auto timestamp_manager = transaction::TimestampManager();
+  auto deferred_action_manager = transaction::DeferredActionManager(common::ManagedPointer(&timestamp_manager));
+  auto buffer_pool = storage::RecordBufferSegmentPool(100, 2);
+  transaction::TransactionManager txn_manager = transaction::TransactionManager(
+      common::ManagedPointer(&timestamp_manager), common::ManagedPointer(&deferred_action_manager),
+      common::ManagedPointer(&buffer_pool), false, nullptr);
+
+  transaction::TransactionContext *txn_context = txn_manager.BeginTransaction();
+
+  parser::AbstractExpression *expr_b_1 =
+      new parser::ConstantValueExpression(type::TypeId::BOOLEAN, execution::sql::BoolVal(true));
+  parser::AbstractExpression *expr_b_2 =
+      new parser::ConstantValueExpression(type::TypeId::BOOLEAN, execution::sql::BoolVal(true));
+  parser::AbstractExpression *expr_b_3 =
+      new parser::ConstantValueExpression(type::TypeId::BOOLEAN, execution::sql::BoolVal(false));
+
+  auto x_1 = common::ManagedPointer<parser::AbstractExpression>(expr_b_1);
+  auto x_2 = common::ManagedPointer<parser::AbstractExpression>(expr_b_2);
+  auto x_3 = common::ManagedPointer<parser::AbstractExpression>(expr_b_3);
+
+  auto annotated_expr_0 =
+      AnnotatedExpression(common::ManagedPointer<parser::AbstractExpression>(), std::unordered_set<std::string>());
+  auto annotated_expr_1 = AnnotatedExpression(x_1, std::unordered_set<std::string>());
+  auto annotated_expr_2 = AnnotatedExpression(x_2, std::unordered_set<std::string>());
+  auto annotated_expr_3 = AnnotatedExpression(x_3, std::unordered_set<std::string>());
+
+  Operator inner_merge_join_1 =
+      InnerMergeJoin::Make(std::vector<AnnotatedExpression>(), {x_1}, {x_1}).RegisterWithTxnContext(txn_context);
+  Operator inner_merge_join_2 =
+      InnerMergeJoin::Make(std::vector<AnnotatedExpression>(), {x_1}, {x_1}).RegisterWithTxnContext(txn_context);
+  Operator inner_merge_join_3 = InnerMergeJoin::Make(std::vector<AnnotatedExpression>{annotated_expr_0}, {x_1}, {x_1})
+                                   .RegisterWithTxnContext(txn_context);
+  Operator inner_merge_join_4 = InnerMergeJoin::Make(std::vector<AnnotatedExpression>{annotated_expr_1}, {x_1}, {x_1})
+                                   .RegisterWithTxnContext(txn_context);
+  Operator inner_merge_join_5 = InnerMergeJoin::Make(std::vector<AnnotatedExpression>{annotated_expr_2}, {x_2}, {x_1})
+                                   .RegisterWithTxnContext(txn_context);
+  Operator inner_merge_join_6 = InnerMergeJoin::Make(std::vector<AnnotatedExpression>{annotated_expr_1}, {x_1}, {x_2})
+                                   .RegisterWithTxnContext(txn_context);
+  Operator inner_merge_join_7 = InnerMergeJoin::Make(std::vector<AnnotatedExpression>{annotated_expr_3}, {x_1}, {x_1})
+                                   .RegisterWithTxnContext(txn_context);
+  Operator inner_merge_join_8 = InnerMergeJoin::Make(std::vector<AnnotatedExpression>{annotated_expr_1}, {x_3}, {x_1})
+                                   .RegisterWithTxnContext(txn_context);
+  Operator inner_merge_join_9 = InnerMergeJoin::Make(std::vector<AnnotatedExpression>{annotated_expr_1}, {x_1}, {x_3})
+                                   .RegisterWithTxnContext(txn_context);
+
+  EXPECT_EQ(inner_merge_join_1.GetOpType(), OpType::INNERMERGEJOIN);
+  EXPECT_EQ(inner_merge_join_3.GetOpType(), OpType::INNERMERGEJOIN);
+  EXPECT_EQ(inner_merge_join_1.GetName(), "InnerMergeJoin");
+  EXPECT_EQ(inner_merge_join_1.GetContentsAs<InnerMergeJoin>()->GetJoinPredicates(),
+            std::vector<AnnotatedExpression>());
+  EXPECT_EQ(inner_merge_join_3.GetContentsAs<InnerMergeJoin>()->GetJoinPredicates(),
+            std::vector<AnnotatedExpression>{annotated_expr_0});
+  EXPECT_EQ(inner_merge_join_4.GetContentsAs<InnerMergeJoin>()->GetJoinPredicates(),
+            std::vector<AnnotatedExpression>{annotated_expr_1});
+  EXPECT_EQ(inner_merge_join_1.GetContentsAs<InnerMergeJoin>()->GetLeftKeys(),
+            std::vector<common::ManagedPointer<parser::AbstractExpression>>{x_1});
+  EXPECT_EQ(inner_merge_join_9.GetContentsAs<InnerMergeJoin>()->GetRightKeys(),
+            std::vector<common::ManagedPointer<parser::AbstractExpression>>{x_3});
+  EXPECT_TRUE(inner_merge_join_1 == inner_merge_join_2);
+  EXPECT_FALSE(inner_merge_join_1 == inner_merge_join_3);
+  EXPECT_FALSE(inner_merge_join_4 == inner_merge_join_3);
+  EXPECT_TRUE(inner_merge_join_4 == inner_merge_join_5);
+  EXPECT_TRUE(inner_merge_join_4 == inner_merge_join_6);
+  EXPECT_FALSE(inner_merge_join_4 == inner_merge_join_7);
+  EXPECT_FALSE(inner_merge_join_4 == inner_merge_join_8);
+  EXPECT_FALSE(inner_merge_join_4 == inner_merge_join_9);
+  EXPECT_EQ(inner_merge_join_1.Hash(), inner_merge_join_2.Hash());
+  EXPECT_NE(inner_merge_join_1.Hash(), inner_merge_join_3.Hash());
+  EXPECT_NE(inner_merge_join_4.Hash(), inner_merge_join_3.Hash());
+  EXPECT_EQ(inner_merge_join_4.Hash(), inner_merge_join_5.Hash());
+  EXPECT_EQ(inner_merge_join_4.Hash(), inner_merge_join_6.Hash());
+  EXPECT_NE(inner_merge_join_4.Hash(), inner_merge_join_7.Hash());
+  EXPECT_NE(inner_merge_join_4.Hash(), inner_merge_join_8.Hash());
+  EXPECT_NE(inner_merge_join_4.Hash(), inner_merge_join_9.Hash());
+
+  delete expr_b_1;
+  delete expr_b_2;
+  delete expr_b_3;
+
+  txn_manager.Abort(txn_context);
+  delete txn_context;
+}
+
 // NOLINTNEXTLINE
 TEST(OperatorTests, LeftHashJoinTest) {
   //===--------------------------------------------------------------------===//
@@ -0,0 +1,125 @@
+#include "optimizer/cost_model/stats_cost_model.h"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "optimizer/group_expression.h"
+#include "optimizer/logical_operators.h"
+#include "optimizer/operator_node.h"
+#include "optimizer/optimizer_context.h"
+#include "optimizer/physical_operators.h"
+#include "optimizer/statistics/stats_storage.h"
+#include "test_util/test_harness.h"
+#include "transaction/deferred_action_manager.h"
+#include "transaction/timestamp_manager.h"
+#include "transaction/transaction_manager.h"
+
+namespace terrier::optimizer {
+
+class StatsCostModelTests : public TerrierTest {
+ protected:
+  void SetUp() override {
+    TerrierTest::SetUp();
+    // Due to the deferred action framework being used to manage memory, we need to
+    // simulate a transaction to prevent leaks
+    deferred_action_manager_ = new transaction::DeferredActionManager(common::ManagedPointer(&timestamp_manager_));
+    buffer_pool_ = new storage::RecordBufferSegmentPool(100, 2);
+    txn_manager_ = new transaction::TransactionManager(common::ManagedPointer(&timestamp_manager_),
+                                                       common::ManagedPointer(deferred_action_manager_),
+                                                       common::ManagedPointer(buffer_pool_), false, nullptr);
+    txn_ = txn_manager_->BeginTransaction();
+
+    // Record (A JOIN B) into the memo, A and B being groups 0 and 1, the join group 2
+    std::vector<std::unique_ptr<AbstractOptimizerNode>> children;
+    for (uint32_t table = 1; table <= 2; table++) {
+      children.emplace_back(std::make_unique<OperatorNode>(
+          LogicalGet::Make(catalog::db_oid_t(1), catalog::table_oid_t(table), {}, "tbl" + std::to_string(table), false)
+              .RegisterWithTxnContext(txn_),
+          std::vector<std::unique_ptr<AbstractOptimizerNode>>{}, txn_));
+    }
+    auto join = std::make_unique<OperatorNode>(LogicalInnerJoin::Make().RegisterWithTxnContext(txn_),
+                                               std::move(children), txn_);
+    GroupExpression *gexpr;
+    context_.RecordOptimizerNodeIntoGroup(common::ManagedPointer<AbstractOptimizerNode>(join.get()), &gexpr);
+    join_group_ = gexpr->GetGroupID();
+    left_group_ = gexpr->GetChildGroupId(0);
+    right_group_ = gexpr->GetChildGroupId(1);
+  }
+
+  void TearDown() override {
+    txn_manager_->Abort(txn_);
+    delete txn_manager_;
+    delete deferred_action_manager_;
+    delete buffer_pool_;
+    delete txn_;
+    TerrierTest::TearDown();
+  }
+
+  double Cost(Operator op, std::vector<group_id_t> &&child_groups, group_id_t group_id) {
+    GroupExpression gexpr(std::move(op), std::move(child_groups), txn_);
+    gexpr.SetGroupID(group_id);
+    return cost_model_.CalculateCost(txn_, nullptr, &context_.GetMemo(), &gexpr);
+  }
+
+  void SetNumRows(group_id_t group_id, int num_rows) {
+    context_.GetMemo().GetGroupByID(group_id)->SetNumRows(num_rows);
+  }
+
+  transaction::TimestampManager timestamp_manager_;
+  transaction::DeferredActionManager *deferred_action_manager_;
+  storage::RecordBufferSegmentPool *buffer_pool_;
+  transaction::TransactionManager *txn_manager_;
+  transaction::TransactionContext *txn_;
+
+  OptimizerContext context_{nullptr};
+  StatsStorage stats_storage_;
+  StatsCostModel cost_model_{common::ManagedPointer(&stats_storage_), catalog::db_oid_t(1)};
+  group_id_t left_group_;
+  group_id_t right_group_;
+  group_id_t join_group_;
+};
+
+// NOLINTNEXTLINE
+TEST_F(StatsCostModelTests, HashJoinBuildSideTest) {
+  SetNumRows(left_group_, 10);
+  SetNumRows(right_group_, 100000);
+  SetNumRows(join_group_, 100);
+
+  // Building the hash table over the smaller input is cheaper
+  auto small_build = Cost(InnerHashJoin::Make({}, {}, {}), {left_group_, right_group_}, join_group_);
+  auto large_build = Cost(InnerHashJoin::Make({}, {}, {}), {right_group_, left_group_}, join_group_);
+  EXPECT_LT(small_build, large_build);
+}
+
+// NOLINTNEXTLINE
+TEST_F(StatsCostModelTests, JoinAlgorithmTest) {
+  // With large inputs, the nested loop join is the most expensive
+  SetNumRows(left_group_, 10000);
+  SetNumRows(right_group_, 10000);
+  SetNumRows(join_group_, 10000);
+  auto hash_join = Cost(InnerHashJoin::Make({}, {}, {}), {left_group_, right_group_}, join_group_);
+  auto nl_join = Cost(InnerNLJoin::Make({}), {left_group_, right_group_}, join_group_);
+  EXPECT_LT(hash_join, nl_join);
+
+  // Sorting both inputs costs more than a hash join, so a merge join only pays off if the inputs are already sorted
+  auto merge_join = Cost(InnerMergeJoin::Make({}, {}, {}), {left_group_, right_group_}, join_group_);
+  auto sort = Cost(OrderBy::Make(), {left_group_}, left_group_);
+  EXPECT_LT(merge_join, hash_join);
+  EXPECT_LT(hash_join, merge_join + 2 * sort);
+}
+
+// NOLINTNEXTLINE
+TEST_F(StatsCostModelTests, SeqScanTest) {
+  // Without stats, the table is assumed to have the default number of rows, each of which is produced
+  auto seq_scan = Cost(SeqScan::Make(catalog::db_oid_t(1), catalog::table_oid_t(1), {}, "tbl1", false), {},
+                       left_group_);
+  EXPECT_DOUBLE_EQ(StatsCostModel::DEFAULT_NUM_ROWS * StatsCostModel::TUPLE_CPU_COST, seq_scan);
+
+  // Producing fewer rows through a limit is cheaper
+  SetNumRows(left_group_, 1000);
+  auto limit = Cost(Limit::Make(0, 10, {}, {}), {left_group_}, left_group_);
+  EXPECT_DOUBLE_EQ(10 * StatsCostModel::TUPLE_CPU_COST, limit);
+}
+
+}  // namespace terrier::optimizer
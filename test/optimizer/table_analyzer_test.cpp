@@ -0,0 +1,134 @@
+#include "optimizer/statistics/table_analyzer.h"
+
+#include <memory>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "main/db_main.h"
+#include "optimizer/statistics/stats_storage.h"
+#include "storage/sql_table.h"
+#include "test_util/catalog_test_util.h"
+#include "test_util/storage_test_util.h"
+#include "test_util/test_harness.h"
+#include "transaction/transaction_context.h"
+#include "transaction/transaction_manager.h"
+
+namespace terrier::optimizer {
+
+class TableAnalyzerTests : public TerrierTest {
+ protected:
+  // Enough blocks that every scan of a block but the last one ends in the middle of the table
+  static constexpr uint32_t NUM_BLOCKS = 3;
+  static constexpr uint32_t NUM_DISTINCT_B = 10;
+
+  void SetUp() override {
+    db_main_ = terrier::DBMain::Builder().SetUseGC(true).SetUseGCThread(true).SetRecordBufferSegmentSize(1e6).Build();
+    txn_manager_ = db_main_->GetTransactionLayer()->GetTransactionManager();
+
+    auto col_a = catalog::Schema::Column("a", type::TypeId::INTEGER, false,
+                                         parser::ConstantValueExpression(type::TypeId::INTEGER));
+    StorageTestUtil::ForceOid(&col_a, COL_A);
+    auto col_b = catalog::Schema::Column("b", type::TypeId::INTEGER, true,
+                                         parser::ConstantValueExpression(type::TypeId::INTEGER));
+    StorageTestUtil::ForceOid(&col_b, COL_B);
+    schema_ = catalog::Schema({col_a, col_b});
+    sql_table_ = new storage::SqlTable(db_main_->GetStorageLayer()->GetBlockStore(), schema_);
+
+    // a is unique, b cycles through NUM_DISTINCT_B values and is NULL in every other cycle
+    const auto initializer = sql_table_->InitializerForProjectedRow({COL_A, COL_B});
+    const auto projection_map = sql_table_->ProjectionMapForOids({COL_A, COL_B});
+    auto *const txn = txn_manager_->BeginTransaction();
+    while (sql_table_->GetNumBlocks() < NUM_BLOCKS) {
+      auto *const redo = txn->StageWrite(CatalogTestUtil::TEST_DB_OID, CatalogTestUtil::TEST_TABLE_OID, initializer);
+      auto *const row = redo->Delta();
+      *reinterpret_cast<int32_t *>(row->AccessForceNotNull(projection_map.at(COL_A))) = static_cast<int32_t>(num_rows_);
+      if (num_rows_ / NUM_DISTINCT_B % 2 == 0) {
+        *reinterpret_cast<int32_t *>(row->AccessForceNotNull(projection_map.at(COL_B))) =
+            static_cast<int32_t>(num_rows_ % NUM_DISTINCT_B);
+      } else {
+        row->SetNull(projection_map.at(COL_B));
+      }
+      sql_table_->Insert(common::ManagedPointer(txn), redo);
+      num_rows_++;
+    }
+    txn_manager_->Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+  }
+
+  void TearDown() override {
+    auto *const sql_table = sql_table_;
+    db_main_->GetTransactionLayer()->GetDeferredActionManager()->RegisterDeferredAction([=]() { delete sql_table; });
+  }
+
+  TableAnalyzer MakeAnalyzer(const uint32_t max_sample_blocks) const {
+    return TableAnalyzer(CatalogTestUtil::TEST_DB_OID, CatalogTestUtil::TEST_TABLE_OID,
+                         common::ManagedPointer(sql_table_), schema_, {COL_A, COL_B}, max_sample_blocks);
+  }
+
+  static constexpr catalog::col_oid_t COL_A = catalog::col_oid_t(1);
+  static constexpr catalog::col_oid_t COL_B = catalog::col_oid_t(2);
+
+  std::unique_ptr<DBMain> db_main_;
+  common::ManagedPointer<transaction::TransactionManager> txn_manager_;
+  catalog::Schema schema_;
+  storage::SqlTable *sql_table_;
+  uint32_t num_rows_ = 0;
+};
+
+// NOLINTNEXTLINE
+TEST_F(TableAnalyzerTests, MultiBlockTest) {
+  auto analyzer = MakeAnalyzer(0);
+  auto *const txn = txn_manager_->BeginTransaction();
+  auto stats = analyzer.Analyze(common::ManagedPointer(txn));
+  txn_manager_->Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+  EXPECT_EQ(analyzer.GetNumSampledBlocks(), sql_table_->GetNumBlocks());
+  EXPECT_EQ(stats->GetNumRows(), num_rows_);
+
+  // The sketch of distinct values is only approximate
+  auto col_a_stats = stats->GetColumnStats(COL_A);
+  EXPECT_NEAR(col_a_stats->GetCardinality(), num_rows_, 0.05 * num_rows_);
+  auto col_b_stats = stats->GetColumnStats(COL_B);
+  EXPECT_NEAR(col_b_stats->GetCardinality(), NUM_DISTINCT_B, 1);
+  EXPECT_NEAR(col_b_stats->GetFracNull(), 0.5, 0.01);
+  EXPECT_EQ(col_b_stats->GetCommonVals().size(), NUM_DISTINCT_B);
+}
+
+// NOLINTNEXTLINE
+TEST_F(TableAnalyzerTests, SampleBlocksTest) {
+  auto analyzer = MakeAnalyzer(NUM_BLOCKS - 1);
+  auto *const txn = txn_manager_->BeginTransaction();
+  auto stats = analyzer.Analyze(common::ManagedPointer(txn));
+  txn_manager_->Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+  // The sampled blocks are full, and the row count is scaled up to every block
+  EXPECT_EQ(analyzer.GetNumSampledBlocks(), NUM_BLOCKS - 1);
+  EXPECT_GE(stats->GetNumRows(), num_rows_);
+  EXPECT_NEAR(stats->GetColumnStats(COL_A)->GetCardinality(), stats->GetNumRows(), 0.05 * stats->GetNumRows());
+}
+
+// NOLINTNEXTLINE
+TEST_F(TableAnalyzerTests, UpdateTableStatsTest) {
+  StatsStorage stats_storage;
+  auto analyzer = MakeAnalyzer(0);
+
+  // Stats collected by an aborted txn are dropped
+  auto *txn = txn_manager_->BeginTransaction();
+  stats_storage.UpdateTableStats(CatalogTestUtil::TEST_DB_OID, CatalogTestUtil::TEST_TABLE_OID,
+                                 analyzer.Analyze(common::ManagedPointer(txn)), txn);
+  txn_manager_->Abort(txn);
+  EXPECT_EQ(stats_storage.GetTableStats(CatalogTestUtil::TEST_DB_OID, CatalogTestUtil::TEST_TABLE_OID), nullptr);
+
+  txn = txn_manager_->BeginTransaction();
+  stats_storage.UpdateTableStats(CatalogTestUtil::TEST_DB_OID, CatalogTestUtil::TEST_TABLE_OID,
+                                 analyzer.Analyze(common::ManagedPointer(txn)), txn);
+  EXPECT_EQ(stats_storage.GetTableStats(CatalogTestUtil::TEST_DB_OID, CatalogTestUtil::TEST_TABLE_OID), nullptr);
+  txn_manager_->Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+
+  const auto stats = stats_storage.GetTableStats(CatalogTestUtil::TEST_DB_OID, CatalogTestUtil::TEST_TABLE_OID);
+  ASSERT_NE(stats, nullptr);
+  EXPECT_EQ(stats->GetNumRows(), num_rows_);
+  EXPECT_TRUE(stats->HasColumnStats(COL_A));
+  EXPECT_TRUE(stats->HasColumnStats(COL_B));
+}
+
+}  // namespace terrier::optimizer
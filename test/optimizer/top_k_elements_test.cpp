@@ -365,4 +365,30 @@ TEST_F(TopKElementsTests, OutputTest) {
   }
 }
 
+
+// Keys that are common in only one of two merged top-k objects must be counted over both of them
+// NOLINTNEXTLINE
+TEST_F(TopKElementsTests, MergeTest) {
+  const int k = 3;
+  TopKElements<int> top_k_a(k, 1000);
+  TopKElements<int> top_k_b(k, 1000);
+
+  top_k_a.Increment(1, 100);
+  top_k_a.Increment(2, 50);
+  top_k_a.Increment(3, 40);
+  top_k_b.Increment(3, 40);
+  top_k_b.Increment(4, 70);
+  top_k_b.Increment(5, 10);
+
+  top_k_a.Merge(top_k_b);
+  EXPECT_EQ(top_k_a.GetSize(), k);
+  EXPECT_EQ(top_k_a.EstimateItemCount(1), 100);
+  EXPECT_EQ(top_k_a.EstimateItemCount(3), 80);
+  EXPECT_EQ(top_k_a.EstimateItemCount(4), 70);
+
+  // Sorted by ascending counts
+  std::vector<int> expected{4, 3, 1};
+  EXPECT_EQ(top_k_a.GetSortedTopKeys(), expected);
+}
+
 }  // namespace terrier::optimizer
@@ -74,6 +74,19 @@ TEST_F(ParserTestBase, CopyTest) {
   auto copy_stmt = result->GetStatement(0).CastManagedPointerTo<CopyStatement>();
   EXPECT_EQ(copy_stmt->GetType(), StatementType::COPY);
   EXPECT_EQ(copy_stmt->GetExternalFileFormat(), ExternalFileFormat::BINARY);
+
+  // Like in Postgres, the default format is text, which is tab separated, and CSV is comma separated
+  result = parser::PostgresParser::BuildParseTree("COPY foo TO STDOUT;");
+  copy_stmt = result->GetStatement(0).CastManagedPointerTo<CopyStatement>();
+  EXPECT_FALSE(copy_stmt->IsFrom());
+  EXPECT_EQ(copy_stmt->GetExternalFileFormat(), ExternalFileFormat::TEXT);
+  EXPECT_EQ(copy_stmt->GetDelimiter(), '\t');
+
+  result = parser::PostgresParser::BuildParseTree("COPY foo FROM STDIN WITH (FORMAT csv);");
+  copy_stmt = result->GetStatement(0).CastManagedPointerTo<CopyStatement>();
+  EXPECT_TRUE(copy_stmt->IsFrom());
+  EXPECT_EQ(copy_stmt->GetExternalFileFormat(), ExternalFileFormat::CSV);
+  EXPECT_EQ(copy_stmt->GetDelimiter(), ',');
 }
 
 // NOLINTNEXTLINE
@@ -33,6 +33,7 @@
 #include "planner/plannodes/index_scan_plan_node.h"
 #include "planner/plannodes/insert_plan_node.h"
 #include "planner/plannodes/limit_plan_node.h"
+#include "planner/plannodes/merge_join_plan_node.h"
 #include "planner/plannodes/nested_loop_join_plan_node.h"
 #include "planner/plannodes/order_by_plan_node.h"
 #include "planner/plannodes/output_schema.h"
@@ -41,6 +42,7 @@
 #include "planner/plannodes/seq_scan_plan_node.h"
 #include "planner/plannodes/set_op_plan_node.h"
 #include "planner/plannodes/update_plan_node.h"
+#include "planner/plannodes/window_plan_node.h"
 #include "test_util/storage_test_util.h"
 #include "test_util/test_harness.h"
 #include "type/type_id.h"
@@ -630,6 +632,34 @@ TEST(PlanNodeJsonTest, HashJoinPlanNodeJoinTest) {
   EXPECT_EQ(plan_node->Hash(), deserialized_plan->Hash());
 }
 
+// NOLINTNEXTLINE
+TEST(PlanNodeJsonTest, MergeJoinPlanNodeJoinTest) {
+  // Construct MergeJoinPlanNode
+  auto left_merge_key = std::make_unique<parser::ColumnValueExpression>("table1", "col1");
+  auto right_merge_key = std::make_unique<parser::ColumnValueExpression>("table2", "col2");
+  auto join_pred = PlanNodeJsonTest::BuildDummyPredicate();
+  MergeJoinPlanNode::Builder builder;
+  auto plan_node =
+      builder.SetOutputSchema(PlanNodeJsonTest::BuildDummyOutputSchema())
+          .SetJoinType(LogicalJoinType::INNER)
+          .SetJoinPredicate(common::ManagedPointer(join_pred))
+          .AddLeftMergeKey(common::ManagedPointer(left_merge_key).CastManagedPointerTo<parser::AbstractExpression>())
+          .AddRightMergeKey(common::ManagedPointer(right_merge_key).CastManagedPointerTo<parser::AbstractExpression>())
+          .Build();
+
+  // Serialize to Json
+  auto json = plan_node->ToJson();
+  EXPECT_FALSE(json.is_null());
+
+  // Deserialize plan node
+  auto deserialized = DeserializePlanNode(json);
+  auto deserialized_plan = common::ManagedPointer(deserialized.result_).CastManagedPointerTo<MergeJoinPlanNode>();
+  EXPECT_TRUE(deserialized_plan != nullptr);
+  EXPECT_EQ(PlanNodeType::MERGEJOIN, deserialized_plan->GetPlanNodeType());
+  EXPECT_EQ(*plan_node, *deserialized_plan);
+  EXPECT_EQ(plan_node->Hash(), deserialized_plan->Hash());
+}
+
 // NOLINTNEXTLINE
 TEST(PlanNodeJsonTest, IndexScanPlanNodeJsonTest) {
   // Construct IndexScanPlanNode
@@ -901,4 +931,47 @@ TEST(PlanNodeJsonTest, UpdatePlanNodeJsonTest) {
   EXPECT_EQ(plan_node->Hash(), deserialized_plan->Hash());
 }
 
+// NOLINTNEXTLINE
+TEST(PlanNodeJsonTest, WindowPlanNodeJsonTest) {
+  // Construct WindowPlanNode
+  auto partition_key = std::make_unique<parser::ColumnValueExpression>("table1", "col1");
+  auto sort_key = std::make_unique<parser::ColumnValueExpression>("table1", "col2");
+  auto argument = std::make_unique<parser::ColumnValueExpression>("table1", "col3");
+
+  WindowTerm rank;
+  rank.type_ = WindowFunctionType::RANK;
+  WindowTerm moving_sum;
+  moving_sum.type_ = WindowFunctionType::SUM;
+  moving_sum.argument_ = common::ManagedPointer(argument).CastManagedPointerTo<parser::AbstractExpression>();
+  moving_sum.frame_type_ = WindowFrameType::ROWS;
+  moving_sum.frame_start_ = WindowFrameBoundType::PRECEDING;
+  moving_sum.frame_start_offset_ = 2;
+  moving_sum.frame_end_ = WindowFrameBoundType::FOLLOWING;
+  moving_sum.frame_end_offset_ = 1;
+
+  WindowPlanNode::Builder builder;
+  auto plan_node =
+      builder.SetOutputSchema(PlanNodeJsonTest::BuildDummyOutputSchema())
+          .AddPartitionByTerm(common::ManagedPointer(partition_key).CastManagedPointerTo<parser::AbstractExpression>())
+          .AddSortKey(common::ManagedPointer(sort_key).CastManagedPointerTo<parser::AbstractExpression>(),
+                      optimizer::OrderByOrderingType::DESC)
+          .AddWindowTerm(rank)
+          .AddWindowTerm(moving_sum)
+          .Build();
+
+  // Serialize to Json
+  auto json = plan_node->ToJson();
+  EXPECT_FALSE(json.is_null());
+
+  // Deserialize plan node
+  auto deserialized = DeserializePlanNode(json);
+  auto deserialized_plan = common::ManagedPointer(deserialized.result_).CastManagedPointerTo<WindowPlanNode>();
+  EXPECT_TRUE(deserialized_plan != nullptr);
+  EXPECT_EQ(PlanNodeType::WINDOW, deserialized_plan->GetPlanNodeType());
+  EXPECT_EQ(2, deserialized_plan->GetWindowTerms().size());
+  EXPECT_TRUE(deserialized_plan->GetWindowTerms()[0].argument_ == nullptr);
+  EXPECT_EQ(*plan_node, *deserialized_plan);
+  EXPECT_EQ(plan_node->Hash(), deserialized_plan->Hash());
+}
+
 }  // namespace terrier::planner
@@ -1,3 +1,9 @@
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <chrono>  // NOLINT
+#include <future>  // NOLINT
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -17,6 +23,7 @@
 #include "test_util/sql_table_test_util.h"
 #include "test_util/storage_test_util.h"
 #include "test_util/test_harness.h"
+#include "traffic_cop/traffic_cop.h"
 #include "transaction/transaction_context.h"
 #include "transaction/transaction_manager.h"
 
@@ -24,6 +31,7 @@
 // executions will read old test's data, and the cause of the errors will be hard to identify. Trust me it will drive
 // you nuts...
 #define LOG_FILE_NAME "./test.log"
+#define REPLICATION_LOG_FILE_NAME "./test_replication.log"
 
 namespace terrier::storage {
 class RecoveryTests : public TerrierTest {
@@ -767,4 +775,141 @@ TEST_F(RecoveryTests, DoubleRecoveryTest) {
       [=]() { unlink(secondary_log_file.c_str()); });
 }
 
+// This test streams the logs of a workload to a replica while the workload runs, and checks that the replica applied
+// all of the tables once the primary stopped
+// NOLINTNEXTLINE
+TEST_F(RecoveryTests, ReplicationTest) {
+  const uint16_t replication_port = 15722;
+  unlink(REPLICATION_LOG_FILE_NAME);
+
+  auto replica = terrier::DBMain::Builder()
+                     .SetUseGC(true)
+                     .SetUseGCThread(true)
+                     .SetUseCatalog(true)
+                     .SetCreateDefaultDatabase(false)
+                     .SetUseStatsStorage(true)
+                     .SetUseExecution(true)
+                     .SetUseTrafficCop(true)
+                     .SetUseNetwork(true)
+                     .SetReplicationListenPort(replication_port)
+                     .Build();
+  replica->GetNetworkLayer()->GetReplicationServer()->RunServer();
+  // The DDL the replica replays doesn't invalidate cached plans, so it doesn't cache any
+  EXPECT_TRUE(replica->GetTrafficCop()->ReadOnly());
+  EXPECT_FALSE(replica->GetTrafficCop()->UseQueryCache());
+
+  // The primary ships its logs from its start on, so the replica receives the bootstrap of the catalog as well
+  auto primary = terrier::DBMain::Builder()
+                     .SetWalFilePath(REPLICATION_LOG_FILE_NAME)
+                     .SetUseLogging(true)
+                     .SetUseGC(true)
+                     .SetUseGCThread(true)
+                     .SetUseCatalog(true)
+                     .SetReplicationReplicaAddress("127.0.0.1")
+                     .SetReplicationReplicaPort(replication_port)
+                     .Build();
+  auto primary_txn_manager = primary->GetTransactionLayer()->GetTransactionManager();
+  auto primary_log_manager = primary->GetLogManager();
+  auto primary_catalog = primary->GetCatalogLayer()->GetCatalog();
+
+  LargeSqlTableTestConfiguration config = LargeSqlTableTestConfiguration::Builder()
+                                              .SetNumDatabases(2)
+                                              .SetNumTables(2)
+                                              .SetMaxColumns(5)
+                                              .SetInitialTableSize(1000)
+                                              .SetTxnLength(5)
+                                              .SetInsertUpdateSelectDeleteRatio({0.2, 0.5, 0.2, 0.1})
+                                              .SetVarlenAllowed(true)
+                                              .Build();
+  auto *tested = new LargeSqlTableTestObject(config, primary_txn_manager.Get(), primary_catalog.Get(),
+                                             primary->GetStorageLayer()->GetBlockStore().Get(), &generator_);
+  tested->SimulateOltp(100, 4);
+
+  // Stopping the log manager ends the replication once all of the logs are shipped
+  primary->GetGarbageCollectorThread()->StopGC();
+  primary->GetTransactionLayer()->GetDeferredActionManager()->FullyPerformGC(
+      primary->GetStorageLayer()->GetGarbageCollector(), primary_log_manager);
+  primary_log_manager->PersistAndStop();
+  auto replication_layer = replica->GetReplicationLayer();
+  replication_layer->WaitForReplicationToEnd();
+  replica->GetNetworkLayer()->GetReplicationServer()->StopServer();
+
+  auto replica_txn_manager = replica->GetTransactionLayer()->GetTransactionManager();
+  auto replica_catalog = replica->GetCatalogLayer()->GetCatalog();
+  for (auto &database : tested->GetTables()) {
+    auto database_oid = database.first;
+    for (auto &table_oid : database.second) {
+      auto original_txn = primary_txn_manager->BeginTransaction();
+      auto original_sql_table = primary_catalog->GetDatabaseCatalog(common::ManagedPointer(original_txn), database_oid)
+                                    ->GetTable(common::ManagedPointer(original_txn), table_oid);
+
+      auto *replica_txn = replica_txn_manager->BeginTransaction();
+      auto db_catalog = replica_catalog->GetDatabaseCatalog(common::ManagedPointer(replica_txn), database_oid);
+      EXPECT_TRUE(db_catalog != nullptr);
+      auto replicated_sql_table = db_catalog->GetTable(common::ManagedPointer(replica_txn), table_oid);
+      EXPECT_TRUE(replicated_sql_table != nullptr);
+
+      EXPECT_TRUE(StorageTestUtil::SqlTableEqualDeep(
+          GetBlockLayout(original_sql_table), original_sql_table, replicated_sql_table,
+          tested->GetTupleSlotsForTable(database_oid, table_oid),
+          replication_layer->GetRecoveryManager()->tuple_slot_map_, primary_txn_manager.Get(),
+          replica_txn_manager.Get()));
+      primary_txn_manager->Commit(original_txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+      replica_txn_manager->Commit(replica_txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+    }
+  }
+
+  // The primary persists its logs again when it shuts down. Nobody listens for them anymore, so it never connects
+  primary_log_manager->Start();
+  primary->GetGarbageCollectorThread()->StartGC();
+  primary->GetTransactionLayer()->GetDeferredActionManager()->RegisterDeferredAction([=]() { delete tested; });
+  primary->GetTransactionLayer()->GetDeferredActionManager()->RegisterDeferredAction(
+      [=]() { unlink(REPLICATION_LOG_FILE_NAME); });
+}
+
+// This test checks that the commits of the primary don't wait for a replica that accepted the connection but never
+// acknowledges the logs
+// NOLINTNEXTLINE
+TEST_F(RecoveryTests, ReplicationTimeoutTest) {
+  const uint16_t replication_port = 15723;
+  unlink(REPLICATION_LOG_FILE_NAME);
+
+  // The connection is accepted into the backlog of the socket, and nothing ever reads from it
+  const int replica_fd = socket(AF_INET, SOCK_STREAM, 0);
+  ASSERT_GE(replica_fd, 0);
+  int one = 1;
+  setsockopt(replica_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+  sockaddr_in address{};
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  address.sin_port = htons(replication_port);
+  ASSERT_EQ(0, bind(replica_fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)));
+  ASSERT_EQ(0, listen(replica_fd, 1));
+
+  auto primary = terrier::DBMain::Builder()
+                     .SetWalFilePath(REPLICATION_LOG_FILE_NAME)
+                     .SetUseLogging(true)
+                     .SetUseGC(true)
+                     .SetUseGCThread(true)
+                     .SetUseCatalog(true)
+                     .SetReplicationReplicaAddress("127.0.0.1")
+                     .SetReplicationReplicaPort(replication_port)
+                     .SetReplicationTimeout(100)
+                     .Build();
+  auto txn_manager = primary->GetTransactionLayer()->GetTransactionManager();
+  auto catalog = primary->GetCatalogLayer()->GetCatalog();
+
+  // The replica is dropped once it timed out, which releases the commit
+  std::promise<void> committed;
+  auto *const txn = txn_manager->BeginTransaction();
+  EXPECT_NE(catalog::INVALID_DATABASE_OID, catalog->CreateDatabase(common::ManagedPointer(txn), "timeoutdb", true));
+  txn_manager->Commit(
+      txn, [](void *const promise) { reinterpret_cast<std::promise<void> *>(promise)->set_value(); }, &committed);
+  EXPECT_EQ(std::future_status::ready, committed.get_future().wait_for(std::chrono::seconds(10)));
+
+  close(replica_fd);
+  primary->GetTransactionLayer()->GetDeferredActionManager()->RegisterDeferredAction(
+      [=]() { unlink(REPLICATION_LOG_FILE_NAME); });
+}
+
 }  // namespace terrier::storage
@@ -0,0 +1,97 @@
+#include "traffic_cop/query_normalizer.h"
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "parser/expression/constant_value_expression.h"
+#include "test_util/test_harness.h"
+
+namespace terrier::trafficcop {
+
+class QueryNormalizerTests : public TerrierTest {
+ protected:
+  static bool Normalize(const std::string &query_text, std::string *normalized_text,
+                        std::vector<parser::ConstantValueExpression> *parameters) {
+    return QueryNormalizer::Normalize(query_text, normalized_text, parameters);
+  }
+};
+
+// NOLINTNEXTLINE
+TEST_F(QueryNormalizerTests, ComparisonTest) {
+  std::string normalized_text;
+  std::vector<parser::ConstantValueExpression> parameters;
+  EXPECT_TRUE(Normalize("SELECT * FROM foo  WHERE id = 42 AND name <> 'it''s'", &normalized_text, &parameters));
+  EXPECT_EQ(normalized_text, "SELECT * FROM foo WHERE id = $1 AND name <> $2");
+  ASSERT_EQ(parameters.size(), 2);
+  EXPECT_EQ(parameters[0].GetReturnValueType(), type::TypeId::INTEGER);
+  EXPECT_EQ(parameters[0].Peek<int64_t>(), 42);
+  EXPECT_EQ(parameters[1].GetReturnValueType(), type::TypeId::VARCHAR);
+  EXPECT_EQ(parameters[1].Peek<std::string_view>(), "it's");
+}
+
+// NOLINTNEXTLINE
+TEST_F(QueryNormalizerTests, IntegerTypeTest) {
+  std::string normalized_text;
+  std::vector<parser::ConstantValueExpression> parameters;
+  EXPECT_TRUE(Normalize("DELETE FROM foo WHERE id = 3000000000", &normalized_text, &parameters));
+  EXPECT_EQ(normalized_text, "DELETE FROM foo WHERE id = $1");
+  ASSERT_EQ(parameters.size(), 1);
+  EXPECT_EQ(parameters[0].GetReturnValueType(), type::TypeId::BIGINT);
+  EXPECT_EQ(parameters[0].Peek<int64_t>(), 3000000000);
+
+  // Integers out of BIGINT's range aren't parameterized
+  EXPECT_FALSE(Normalize("DELETE FROM foo WHERE id = 99999999999999999999", &normalized_text, &parameters));
+}
+
+// NOLINTNEXTLINE
+TEST_F(QueryNormalizerTests, InsertTest) {
+  std::string normalized_text;
+  std::vector<parser::ConstantValueExpression> parameters;
+  EXPECT_TRUE(Normalize("INSERT INTO foo (a, b) VALUES (1, 'abc'), (2, 'def');", &normalized_text, &parameters));
+  EXPECT_EQ(normalized_text, "INSERT INTO foo (a, b) VALUES ($1, $2), ($3, $4);");
+  EXPECT_EQ(parameters.size(), 4);
+}
+
+// NOLINTNEXTLINE
+TEST_F(QueryNormalizerTests, ShapeLiteralTest) {
+  std::string normalized_text;
+  std::vector<parser::ConstantValueExpression> parameters;
+
+  // LIMIT counts, ORDER BY positions, function arguments, typed literals, casts, signed and decimal numbers stay
+  EXPECT_FALSE(Normalize("SELECT a FROM foo ORDER BY 1 LIMIT 10", &normalized_text, &parameters));
+  EXPECT_FALSE(Normalize("SELECT substr(s, 1, 2) FROM foo", &normalized_text, &parameters));
+  EXPECT_FALSE(Normalize("SELECT * FROM foo WHERE d = DATE '2020-01-01'", &normalized_text, &parameters));
+  EXPECT_FALSE(Normalize("SELECT * FROM foo WHERE e = '1'::int", &normalized_text, &parameters));
+  EXPECT_FALSE(Normalize("UPDATE foo SET a = b WHERE c = -3 OR d = 1.5", &normalized_text, &parameters));
+  EXPECT_TRUE(normalized_text.empty());
+  EXPECT_TRUE(parameters.empty());
+
+  EXPECT_TRUE(Normalize("SELECT a FROM foo WHERE b > 5 GROUP BY a ORDER BY a, 2", &normalized_text, &parameters));
+  EXPECT_EQ(normalized_text, "SELECT a FROM foo WHERE b > $1 GROUP BY a ORDER BY a, 2");
+  EXPECT_EQ(parameters.size(), 1);
+}
+
+// NOLINTNEXTLINE
+TEST_F(QueryNormalizerTests, CommentTest) {
+  std::string normalized_text;
+  std::vector<parser::ConstantValueExpression> parameters;
+  EXPECT_TRUE(Normalize("SELECT * FROM foo /* a /* nested */ comment */ WHERE id IN (1,2) -- 7\n  AND x = 'y'",
+                        &normalized_text, &parameters));
+  EXPECT_EQ(normalized_text, "SELECT * FROM foo WHERE id IN ($1,$2) AND x = $3");
+  EXPECT_EQ(parameters.size(), 3);
+}
+
+// NOLINTNEXTLINE
+TEST_F(QueryNormalizerTests, UnsupportedTest) {
+  std::string normalized_text;
+  std::vector<parser::ConstantValueExpression> parameters;
+  EXPECT_FALSE(Normalize("CREATE TABLE foo (a INT DEFAULT 1)", &normalized_text, &parameters));
+  EXPECT_FALSE(Normalize("SELECT * FROM foo WHERE id = $1 AND a = 2", &normalized_text, &parameters));
+  EXPECT_FALSE(Normalize("SELECT 1; SELECT 2", &normalized_text, &parameters));
+  EXPECT_FALSE(Normalize("SELECT * FROM foo WHERE a = E'x' AND b = 1", &normalized_text, &parameters));
+  EXPECT_FALSE(Normalize("SELECT * FROM foo WHERE a = 'x", &normalized_text, &parameters));
+}
+
+}  // namespace terrier::trafficcop
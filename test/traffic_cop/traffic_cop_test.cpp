@@ -1,8 +1,11 @@
 #include "traffic_cop/traffic_cop.h"
 
+#include <gflags/gflags.h>
 #include <memory>
 #include <pqxx/pqxx>  // NOLINT
 #include <string>
+#include <thread>  // NOLINT
+#include <tuple>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -10,8 +13,10 @@
 #include "common/settings.h"
 #include "gtest/gtest.h"
 #include "main/db_main.h"
+#include "network/connection_context.h"
 #include "network/connection_handle_factory.h"
 #include "network/terrier_server.h"
+#include "optimizer/statistics/stats_storage.h"
 #include "storage/garbage_collector.h"
 #include "test_util/manual_packet_util.h"
 #include "test_util/test_harness.h"
@@ -19,6 +24,8 @@
 #include "transaction/deferred_action_manager.h"
 #include "transaction/transaction_manager.h"
 
+DECLARE_int64(auto_analyze_threshold);
+
 namespace terrier::trafficcop {
 
 class TrafficCopTests : public TerrierTest {
@@ -47,6 +54,37 @@ class TrafficCopTests : public TerrierTest {
     txn_manager_ = db_main_->GetTransactionLayer()->GetTransactionManager();
   }
 
+  /**
+   * @param table_name name of a table in the default database
+   * @return the stats of the table, or nullptr if it was never analyzed
+   */
+  common::ManagedPointer<optimizer::TableStats> GetTableStats(const std::string &table_name) {
+    auto *const txn = txn_manager_->BeginTransaction();
+    const auto db_oid = catalog_->GetDatabaseOid(common::ManagedPointer(txn), catalog::DEFAULT_DATABASE);
+    const auto accessor = catalog_->GetAccessor(common::ManagedPointer(txn), db_oid, DISABLED);
+    const auto table_oid = accessor->GetTableOid(table_name);
+    txn_manager_->Commit(txn, transaction::TransactionUtil::EmptyCallback, nullptr);
+    return db_main_->GetStatsStorage()->GetTableStats(db_oid, table_oid);
+  }
+
+  /**
+   * Loads rows (i, i % 10) into a table with COPY, enough of them to fill several blocks
+   * @param connection connection to the server
+   * @param table_name name of the table
+   * @param begin first row
+   * @param end row after the last one
+   */
+  static void CopyRows(pqxx::connection *const connection, const std::string &table_name, const uint32_t begin,
+                       const uint32_t end) {
+    pqxx::work txn(*connection);
+    pqxx::stream_to stream(txn, table_name);
+    for (uint32_t i = begin; i < end; i++) {
+      stream << std::make_tuple(i, i % 10);
+    }
+    stream.complete();
+    txn.commit();
+  }
+
   std::unique_ptr<DBMain> db_main_;
   uint16_t port_;
   common::ManagedPointer<catalog::Catalog> catalog_;
@@ -145,7 +183,7 @@ TEST_F(TrafficCopTests, BasicTest) {
 }
 
 /**
- * Test whether a temporary namespace is created for a connection to the database
+ * Test that the temporary namespace of a connection is only created once it's used
  */
 // NOLINTNEXTLINE
 TEST_F(TrafficCopTests, TemporaryNamespaceTest) {
@@ -155,8 +193,8 @@ TEST_F(TrafficCopTests, TemporaryNamespaceTest) {
 
     pqxx::work txn1(connection);
 
-    // Create a new namespace and make sure that its OID is higher than the default start OID,
-    // which should have been assigned to the temporary namespace for this connection
+    // Create a new namespace and make sure that it gets the default start OID, since the connection did not use its
+    // temporary namespace yet
     catalog::namespace_oid_t new_namespace_oid = catalog::INVALID_NAMESPACE_OID;
     do {
       auto txn = txn_manager_->BeginTransaction();
@@ -167,11 +205,23 @@ TEST_F(TrafficCopTests, TemporaryNamespaceTest) {
       new_namespace_oid = db_accessor->CreateNamespace(std::string(trafficcop::TEMP_NAMESPACE_PREFIX));
       txn_manager_->Abort(txn);
     } while (new_namespace_oid == catalog::INVALID_NAMESPACE_OID);
-    EXPECT_GT(new_namespace_oid.UnderlyingValue(), catalog::START_OID);
+    EXPECT_EQ(new_namespace_oid.UnderlyingValue(), catalog::START_OID);
     txn1.commit();
   } catch (const std::exception &e) {
     EXPECT_TRUE(false);
   }
+
+  // The temporary namespace is created on first use and reused afterwards
+  const auto t_cop = db_main_->GetTrafficCop();
+  network::ConnectionContext context;
+  context.SetDatabaseOid(t_cop->GetDatabaseOid(catalog::DEFAULT_DATABASE));
+  ASSERT_NE(context.GetDatabaseOid(), catalog::INVALID_DATABASE_OID);
+  EXPECT_EQ(context.GetTempNamespaceOid(), catalog::INVALID_NAMESPACE_OID);
+  const auto ns_oid = t_cop->GetTempNamespace(common::ManagedPointer(&context));
+  EXPECT_NE(ns_oid, catalog::INVALID_NAMESPACE_OID);
+  EXPECT_EQ(context.GetTempNamespaceOid(), ns_oid);
+  EXPECT_EQ(t_cop->GetTempNamespace(common::ManagedPointer(&context)), ns_oid);
+  EXPECT_TRUE(t_cop->DropTempNamespace(context.GetDatabaseOid(), ns_oid));
 }
 
 // NOLINTNEXTLINE
@@ -189,4 +239,425 @@ TEST_F(TrafficCopTests, ArithmeticErrorTest) {
   }
 }
 
+/**
+ * Test that simple queries differing only in their literals share a cached plan, and that DDL changes invalidate it
+ */
+// NOLINTNEXTLINE
+TEST_F(TrafficCopTests, PlanCacheTest) {
+  const auto plan_cache = db_main_->GetTrafficCop()->GetPlanCache();
+  ASSERT_NE(plan_cache, nullptr);
+
+  try {
+    pqxx::connection connection(fmt::format("host=127.0.0.1 port={0} user={1} sslmode=disable application_name=psql",
+                                            port_, catalog::DEFAULT_DATABASE));
+    pqxx::nontransaction txn(connection);
+    txn.exec("CREATE TABLE TableA (id INT PRIMARY KEY, data TEXT);");
+    for (int i = 0; i < 10; i++) {
+      txn.exec(fmt::format("INSERT INTO TableA VALUES ({}, 'abc{}');", i, i));
+    }
+    EXPECT_EQ(plan_cache->GetNumInsertions(), 1);
+
+    for (int i = 0; i < 10; i++) {
+      pqxx::result r = txn.exec(fmt::format("SELECT data FROM TableA WHERE id = {};", i));
+      ASSERT_EQ(r.size(), 1);
+      EXPECT_EQ(r[0][0].as<std::string>(), fmt::format("abc{}", i));
+    }
+    EXPECT_EQ(plan_cache->GetNumInsertions(), 2);
+    EXPECT_EQ(plan_cache->GetNumHits(), 18);
+
+    // Literals that are part of the statement's shape aren't replaced, the statement is cached as is
+    pqxx::result r = txn.exec("SELECT data FROM TableA ORDER BY 1 LIMIT 2;");
+    EXPECT_EQ(r.size(), 2);
+    EXPECT_EQ(plan_cache->GetNumInsertions(), 3);
+
+    // Creating an index changes the best plan for the lookup
+    txn.exec("CREATE INDEX idx ON TableA (data);");
+    EXPECT_EQ(plan_cache->GetNumInvalidations(), 3);
+    EXPECT_EQ(plan_cache->GetNumEntries(), 0);
+    r = txn.exec("SELECT id FROM TableA WHERE data = 'abc3';");
+    ASSERT_EQ(r.size(), 1);
+    EXPECT_EQ(r[0][0].as<int>(), 3);
+  } catch (const std::exception &e) {
+    EXPECT_TRUE(false);
+  }
+}
+
+/**
+ * Test that plans built by a txn that ran DDL are not shared with other connections, since they may depend on its
+ * uncommitted changes
+ */
+// NOLINTNEXTLINE
+TEST_F(TrafficCopTests, PlanCacheDDLTransactionTest) {
+  const auto plan_cache = db_main_->GetTrafficCop()->GetPlanCache();
+  ASSERT_NE(plan_cache, nullptr);
+
+  try {
+    const auto options = fmt::format("host=127.0.0.1 port={0} user={1} sslmode=disable application_name=psql", port_,
+                                     catalog::DEFAULT_DATABASE);
+    pqxx::connection connection1(options);
+    pqxx::connection connection2(options);
+
+    {
+      pqxx::work txn1(connection1);
+      txn1.exec("CREATE TABLE TableA (id INT PRIMARY KEY, data INT);");
+      txn1.exec("INSERT INTO TableA VALUES (1, 1);");
+      EXPECT_EQ(txn1.exec("SELECT data FROM TableA;").size(), 1);
+      EXPECT_EQ(plan_cache->GetNumInsertions(), 0);
+
+      // The other connection can't see the table, and must not run the plans of the first one
+      pqxx::nontransaction txn2(connection2);
+      EXPECT_THROW(txn2.exec("SELECT data FROM TableA;"), pqxx::sql_error);
+      txn1.abort();
+    }
+
+    // The table is gone, and so are the plans that used it
+    {
+      pqxx::nontransaction txn2(connection2);
+      EXPECT_THROW(txn2.exec("SELECT data FROM TableA;"), pqxx::sql_error);
+      EXPECT_EQ(plan_cache->GetNumInsertions(), 0);
+    }
+
+    // Once the DDL is committed, plans are shared again
+    {
+      pqxx::work txn1(connection1);
+      txn1.exec("CREATE TABLE TableA (id INT PRIMARY KEY, data INT);");
+      txn1.commit();
+    }
+    {
+      pqxx::nontransaction txn2(connection2);
+      EXPECT_EQ(txn2.exec("SELECT data FROM TableA;").size(), 0);
+      EXPECT_EQ(plan_cache->GetNumInsertions(), 1);
+    }
+  } catch (const std::exception &e) {
+    EXPECT_TRUE(false);
+  }
+}
+
+/**
+ * Test that single-row lookups and updates by primary key, which skip optimization and code generation, see and make
+ * the same changes as the regular path
+ */
+// NOLINTNEXTLINE
+TEST_F(TrafficCopTests, PointQueryTest) {
+  try {
+    pqxx::connection connection(fmt::format("host=127.0.0.1 port={0} user={1} sslmode=disable application_name=psql",
+                                            port_, catalog::DEFAULT_DATABASE));
+    pqxx::nontransaction txn(connection);
+    txn.exec("CREATE TABLE TableA (id INT PRIMARY KEY, num BIGINT, data VARCHAR);");
+    for (int i = 0; i < 10; i++) {
+      txn.exec(fmt::format("INSERT INTO TableA VALUES ({}, {}, 'abc{}');", i, i * 10, i));
+    }
+
+    for (int i = 0; i < 10; i++) {
+      pqxx::result r = txn.exec(fmt::format("SELECT data, id, num FROM TableA WHERE id = {};", i));
+      ASSERT_EQ(r.size(), 1);
+      EXPECT_EQ(r[0][0].as<std::string>(), fmt::format("abc{}", i));
+      EXPECT_EQ(r[0][1].as<int>(), i);
+      EXPECT_EQ(r[0][2].as<int64_t>(), i * 10);
+    }
+    EXPECT_EQ(txn.exec("SELECT * FROM TableA WHERE id = 42;").size(), 0);
+
+    pqxx::result r = txn.exec("UPDATE TableA SET data = 'xyz', num = NULL WHERE id = 3;");
+    EXPECT_EQ(r.affected_rows(), 1);
+    r = txn.exec("UPDATE TableA SET data = 'xyz' WHERE id = 42;");
+    EXPECT_EQ(r.affected_rows(), 0);
+
+    r = txn.exec("SELECT num, data FROM TableA WHERE id = 3;");
+    ASSERT_EQ(r.size(), 1);
+    EXPECT_TRUE(r[0][0].is_null());
+    EXPECT_EQ(r[0][1].as<std::string>(), "xyz");
+
+    // The regular path sees the update as well
+    r = txn.exec("SELECT id FROM TableA WHERE data = 'xyz';");
+    ASSERT_EQ(r.size(), 1);
+    EXPECT_EQ(r[0][0].as<int>(), 3);
+  } catch (const std::exception &e) {
+    EXPECT_TRUE(false);
+  }
+}
+
+/**
+ * Test that commands of concurrent connections are handed off to the execution workers and resumed correctly, with
+ * more connections than workers and both the simple and the extended query protocol
+ */
+// NOLINTNEXTLINE
+TEST_F(TrafficCopTests, ConcurrentConnectionsTest) {
+  const auto options = fmt::format("host=127.0.0.1 port={0} user={1} sslmode=disable application_name=psql", port_,
+                                   catalog::DEFAULT_DATABASE);
+  try {
+    pqxx::connection connection(options);
+    {
+      pqxx::work txn(connection);
+      txn.exec("CREATE TABLE concurrenttable (id INT PRIMARY KEY, owner INT);");
+      txn.commit();
+    }
+
+    const int num_clients = 8;
+    const int num_rows = 200;
+    std::vector<std::thread> clients;
+    for (int client = 0; client < num_clients; client++) {
+      clients.emplace_back([&, client] {
+        try {
+          pqxx::connection client_connection(options);
+          for (int i = 0; i < num_rows; i++) {
+            pqxx::work txn(client_connection);
+            if (i % 2 == 0) {
+              txn.exec(fmt::format("INSERT INTO concurrenttable VALUES ({}, {});", client * num_rows + i, client));
+            } else {
+              txn.exec_params("INSERT INTO concurrenttable VALUES ($1, $2);", client * num_rows + i, client);
+            }
+            txn.commit();
+          }
+          pqxx::work txn(client_connection);
+          const auto r = txn.exec_params("SELECT COUNT(*) FROM concurrenttable WHERE owner = $1;", client);
+          EXPECT_EQ(num_rows, r[0][0].as<int>());
+          txn.commit();
+        } catch (const std::exception &e) {
+          EXPECT_TRUE(false) << e.what();
+        }
+      });
+    }
+    for (auto &client : clients) client.join();
+
+    pqxx::work txn(connection);
+    const auto r = txn.exec("SELECT COUNT(*) FROM concurrenttable;");
+    EXPECT_EQ(num_clients * num_rows, r[0][0].as<int>());
+    txn.commit();
+  } catch (const std::exception &e) {
+    EXPECT_TRUE(false) << e.what();
+  }
+}
+
+/**
+ * Test that the executions of a prepared INSERT in one transaction, which share the portal and its execution context,
+ * insert every row and report the rows of their own execution only
+ */
+// NOLINTNEXTLINE
+TEST_F(TrafficCopTests, PreparedInsertBatchTest) {
+  try {
+    pqxx::connection connection(fmt::format("host=127.0.0.1 port={0} user={1} sslmode=disable application_name=psql",
+                                            port_, catalog::DEFAULT_DATABASE));
+    {
+      pqxx::work txn(connection);
+      txn.exec("CREATE TABLE batchtable (id INT PRIMARY KEY, data VARCHAR);");
+      txn.commit();
+    }
+
+    connection.prepare("insert", "INSERT INTO batchtable VALUES ($1, $2);");
+    const int num_rows = 100;
+    for (int batch = 0; batch < 2; batch++) {
+      pqxx::work txn(connection);
+      for (int i = 0; i < num_rows; i++) {
+        const int id = batch * num_rows + i;
+        const auto r = txn.exec_prepared("insert", id, fmt::format("row{}", id));
+        EXPECT_EQ(1, r.affected_rows());
+      }
+      txn.commit();
+    }
+
+    pqxx::work txn(connection);
+    auto r = txn.exec("SELECT COUNT(*) FROM batchtable;");
+    EXPECT_EQ(2 * num_rows, r[0][0].as<int>());
+    r = txn.exec_params("SELECT data FROM batchtable WHERE id = $1;", num_rows + 7);
+    ASSERT_EQ(1, r.size());
+    EXPECT_EQ(fmt::format("row{}", num_rows + 7), r[0][0].as<std::string>());
+    txn.commit();
+  } catch (const std::exception &e) {
+    EXPECT_TRUE(false) << e.what();
+  }
+}
+
+/**
+ * Test that rows loaded with COPY FROM STDIN in several CopyData messages are in the table and its index, and that
+ * COPY TO STDOUT sends them back
+ */
+// NOLINTNEXTLINE
+TEST_F(TrafficCopTests, CopyTest) {
+  try {
+    pqxx::connection connection(fmt::format("host=127.0.0.1 port={0} user={1} sslmode=disable application_name=psql",
+                                            port_, catalog::DEFAULT_DATABASE));
+    {
+      pqxx::work txn(connection);
+      txn.exec("CREATE TABLE copytable (id INT PRIMARY KEY, num BIGINT, data VARCHAR);");
+      txn.commit();
+    }
+
+    // More rows than fit into one batch, with strings that need escaping
+    const int num_rows = 5000;
+    {
+      pqxx::work txn(connection);
+      pqxx::stream_to stream(txn, "copytable");
+      for (int i = 0; i < num_rows; i++) {
+        stream << std::make_tuple(i, int64_t{i} * 10, fmt::format("line\t{}\n\\", i));
+      }
+      stream.complete();
+      txn.commit();
+    }
+
+    {
+      pqxx::nontransaction txn(connection);
+      pqxx::result r = txn.exec("SELECT data, num FROM copytable WHERE id = 1234;");
+      ASSERT_EQ(r.size(), 1);
+      EXPECT_EQ(r[0][0].as<std::string>(), "line\t1234\n\\");
+      EXPECT_EQ(r[0][1].as<int64_t>(), 12340);
+    }
+
+    {
+      pqxx::work txn(connection);
+      pqxx::stream_from stream(txn, "copytable");
+      std::tuple<int, int64_t, std::string> row;
+      int count = 0;
+      while (stream >> row) {
+        EXPECT_EQ(std::get<1>(row), int64_t{std::get<0>(row)} * 10);
+        EXPECT_EQ(std::get<2>(row), fmt::format("line\t{}\n\\", std::get<0>(row)));
+        count++;
+      }
+      stream.complete();
+      EXPECT_EQ(count, num_rows);
+    }
+
+    // A duplicate key fails the COPY, and none of its rows are loaded
+    {
+      pqxx::work txn(connection);
+      pqxx::stream_to stream(txn, "copytable");
+      stream << std::make_tuple(num_rows, int64_t{0}, std::string("new"));
+      stream << std::make_tuple(7, int64_t{0}, std::string("duplicate"));
+      EXPECT_ANY_THROW(stream.complete());
+    }
+    {
+      pqxx::nontransaction txn(connection);
+      EXPECT_EQ(txn.exec(fmt::format("SELECT id FROM copytable WHERE id = {};", num_rows)).size(), 0);
+    }
+  } catch (const std::exception &e) {
+    EXPECT_TRUE(false);
+  }
+}
+
+/**
+ * Test that a COMMIT cancels the query of a cursor that the client didn't fetch completely, and commits the txn
+ */
+// NOLINTNEXTLINE
+TEST_F(TrafficCopTests, CursorCommitTest) {
+  try {
+    pqxx::connection connection(fmt::format("host=127.0.0.1 port={0} user={1} sslmode=disable application_name=psql",
+                                            port_, catalog::DEFAULT_DATABASE));
+    {
+      pqxx::work txn(connection);
+      txn.exec("CREATE TABLE cursortable (id INT, val INT);");
+      txn.commit();
+    }
+    CopyRows(&connection, "cursortable", 0, 100000);
+
+    auto io_socket_unique_ptr = network::ManualPacketUtil::StartConnection(port_);
+    ASSERT_NE(io_socket_unique_ptr, nullptr);
+    const auto io_socket = common::ManagedPointer(io_socket_unique_ptr);
+    network::PostgresPacketWriter writer(io_socket->GetWriteQueue());
+    for (const char *const query : {"BEGIN;", "INSERT INTO cursortable VALUES (-1, -1);"}) {
+      writer.WriteSimpleQuery(query);
+      io_socket->FlushAllWrites();
+      EXPECT_TRUE(network::ManualPacketUtil::ReadUntilReadyOrClose(io_socket));
+    }
+
+    // The portal is suspended after 10 of its rows
+    writer.WriteParseCommand("", "SELECT id FROM cursortable;", {});
+    writer.WriteBindCommand("", "", {}, {}, {});
+    writer.WriteExecuteCommand("", 10);
+    writer.WriteSyncCommand();
+    io_socket->FlushAllWrites();
+    EXPECT_TRUE(network::ManualPacketUtil::ReadUntilReadyOrClose(io_socket));
+
+    writer.WriteSimpleQuery("COMMIT;");
+    io_socket->FlushAllWrites();
+    EXPECT_TRUE(network::ManualPacketUtil::ReadUntilReadyOrClose(io_socket));
+    network::ManualPacketUtil::TerminateConnection(io_socket->GetSocketFd());
+    io_socket->Close();
+
+    pqxx::work txn(connection);
+    const auto r = txn.exec("SELECT COUNT(*) FROM cursortable WHERE id = -1;");
+    EXPECT_EQ(1, r[0][0].as<int>());
+    txn.commit();
+  } catch (const std::exception &e) {
+    EXPECT_TRUE(false) << e.what();
+  }
+}
+
+/**
+ * Test that ANALYZE scans every block of a table that spans several of them
+ */
+// NOLINTNEXTLINE
+TEST_F(TrafficCopTests, AnalyzeTest) {
+  const uint32_t num_rows = 200000;
+  try {
+    pqxx::connection connection(fmt::format("host=127.0.0.1 port={0} user={1} sslmode=disable application_name=psql",
+                                            port_, catalog::DEFAULT_DATABASE));
+    {
+      pqxx::work txn(connection);
+      txn.exec("CREATE TABLE analyzetable (id INT, val INT);");
+      txn.commit();
+    }
+    CopyRows(&connection, "analyzetable", 0, num_rows);
+    // Auto-analyze is off by default
+    EXPECT_EQ(GetTableStats("analyzetable"), nullptr);
+
+    {
+      pqxx::nontransaction txn(connection);
+      txn.exec("ANALYZE analyzetable;");
+    }
+    const auto stats = GetTableStats("analyzetable");
+    ASSERT_NE(stats, nullptr);
+    EXPECT_EQ(stats->GetNumRows(), num_rows);
+    EXPECT_EQ(stats->GetColumnCount(), 2);
+  } catch (const std::exception &e) {
+    EXPECT_TRUE(false);
+  }
+}
+
+class TrafficCopAutoAnalyzeTests : public TrafficCopTests {
+ protected:
+  static constexpr uint32_t AUTO_ANALYZE_THRESHOLD = 1000;
+
+  void SetUp() override {
+    // The settings are read from the flags when the server starts
+    FLAGS_auto_analyze_threshold = AUTO_ANALYZE_THRESHOLD;
+    TrafficCopTests::SetUp();
+  }
+
+  void TearDown() override {
+    FLAGS_auto_analyze_threshold = 0;
+    TrafficCopTests::TearDown();
+  }
+};
+
+/**
+ * Test that a table spanning several blocks is analyzed once enough of its rows were modified
+ */
+// NOLINTNEXTLINE
+TEST_F(TrafficCopAutoAnalyzeTests, AutoAnalyzeTest) {
+  const uint32_t num_rows = 200000;
+  try {
+    pqxx::connection connection(fmt::format("host=127.0.0.1 port={0} user={1} sslmode=disable application_name=psql",
+                                            port_, catalog::DEFAULT_DATABASE));
+    {
+      pqxx::work txn(connection);
+      txn.exec("CREATE TABLE autotable (id INT, val INT);");
+      txn.commit();
+    }
+    CopyRows(&connection, "autotable", 0, num_rows);
+    auto stats = GetTableStats("autotable");
+    ASSERT_NE(stats, nullptr);
+    EXPECT_EQ(stats->GetNumRows(), num_rows);
+
+    // Modifying no more than the threshold plus 10% of the table's rows doesn't trigger another analyze
+    const uint32_t num_small = AUTO_ANALYZE_THRESHOLD;
+    CopyRows(&connection, "autotable", num_rows, num_rows + num_small);
+    EXPECT_EQ(GetTableStats("autotable")->GetNumRows(), num_rows);
+
+    const uint32_t num_large = num_rows / 10 + 1;
+    CopyRows(&connection, "autotable", num_rows + num_small, num_rows + num_small + num_large);
+    EXPECT_EQ(GetTableStats("autotable")->GetNumRows(), num_rows + num_small + num_large);
+  } catch (const std::exception &e) {
+    EXPECT_TRUE(false);
+  }
+}
+
 }  // namespace terrier::trafficcop
@@ -2,11 +2,15 @@
 
 #include <storage/index/index_builder.h>
 
+#include <algorithm>
+#include <fstream>
+#include <mutex>  // NOLINT
 #include <string>
 #include <vector>
 
-#include "csv/csv.h"  // NOLINT
-#include "execution/sql/value.h"
+#include "common/error/exception.h"
+#include "execution/util/parallel_csv_reader.h"
+#include "spdlog/fmt/fmt.h"
 #include "storage/index/index.h"
 #include "storage/sql_table.h"
 
@@ -19,7 +23,7 @@ uint32_t TableReader::ReadTable(const std::string &schema_file, const std::strin
   auto table_info = schema_reader.ReadTableInfo(schema_file);
   auto table_oid = CreateTable(table_info.get());
 
-  // Init table projected row
+  // Init table projected row and batch
   auto table = exec_ctx_->GetAccessor()->GetTable(table_oid);
   auto &table_schema = exec_ctx_->GetAccessor()->GetSchema(table_oid);
   std::vector<catalog::col_oid_t> table_cols;
@@ -27,43 +31,45 @@ uint32_t TableReader::ReadTable(const std::string &schema_file, const std::strin
     table_cols.emplace_back(col.Oid());
   }
   auto pri = table->InitializerForProjectedRow(table_cols);
+  auto pci = table->InitializerForProjectedColumns(table_cols, common::Constants::K_DEFAULT_VECTOR_SIZE);
 
   // Set table column offsets
   auto offset_map = table->ProjectionMapForOids(table_cols);
   std::vector<uint16_t> table_offsets;
+  std::vector<type::TypeId> col_types;
   for (const auto &col_info : table_info->cols_) {
     const auto &col = table_schema.GetColumn(col_info.Name());
     table_offsets.emplace_back(offset_map[col.Oid()]);
+    col_types.emplace_back(col_info.Type());
   }
 
   // Create Indexes
   CreateIndexes(table_info.get(), table_oid);
 
-  // Iterate through CSV file
-  std::vector<std::string> col_names;
-  for (const auto &col : table_info->cols_) {
-    col_names.emplace_back(col.Name());
+  // Parse the CSV file in parallel. The first line is a header.
+  util::ParallelCSVReader reader(data_file, col_types, table_offsets, GuessDelimiter(data_file, col_types.size()), '"',
+                                 '"', NULL_STRING, true);
+  if (!reader.Initialize()) {
+    throw EXECUTION_EXCEPTION(fmt::format("Unable to read CSV file {}", data_file),
+                              common::ErrorCode::ERRCODE_IO_ERROR);
   }
-  csv::CSVReader reader(data_file);
-  for (csv::CSVRow &row : reader) {
-    // Write table data
-    auto *const redo = exec_ctx_->GetTxn()->StageWrite(exec_ctx_->DBOid(), table_oid, pri);
-    uint16_t col_idx = 0;
-    for (csv::CSVField &field : row) {
-      auto col_offset = table_offsets[col_idx];
-      auto col_type = table_info->cols_[col_idx].Type();
-      WriteTableCol(redo->Delta(), col_offset, col_type, &field);
-      col_idx++;
-    }
+
+  // The transaction can only be written to by one thread at a time
+  std::mutex insert_latch;
+  reader.Read(pci, [&](storage::ProjectedColumns *batch) {
+    std::lock_guard<std::mutex> guard(insert_latch);
     // Insert into sql table
-    auto slot = table->Insert(exec_ctx_->GetTxn(), redo);
-    val_written++;
+    table->InsertBatch(exec_ctx_->GetTxn(), exec_ctx_->DBOid(), table_oid, pri, batch);
+    val_written += batch->NumTuples();
 
     // Write index data
-    for (auto &index_info : table_info->indexes_) {
-      WriteIndexEntry(index_info.get(), redo->Delta(), table_offsets, slot);
+    for (uint32_t row = 0; row < batch->NumTuples(); row++) {
+      auto row_view = batch->InterpretAsRow(row);
+      for (auto &index_info : table_info->indexes_) {
+        WriteIndexEntry(index_info.get(), &row_view, table_offsets, batch->TupleSlots()[row]);
+      }
     }
-  }
+  });
 
   // Deallocate
   for (auto &index_info : table_info->indexes_) {
@@ -111,7 +117,7 @@ void TableReader::CreateIndexes(TableInfo *info, catalog::table_oid_t table_oid)
   }
 }
 
-void TableReader::WriteIndexEntry(IndexInfo *index_info, storage::ProjectedRow *table_pr,
+void TableReader::WriteIndexEntry(IndexInfo *index_info, storage::ProjectedColumns::RowView *table_row,
                                   const std::vector<uint16_t> &table_offsets, const storage::TupleSlot &slot) {
   for (uint32_t index_col_idx = 0; index_col_idx < index_info->offsets_.size(); index_col_idx++) {
     // Get the offset of this column in the table
@@ -120,74 +126,29 @@ void TableReader::WriteIndexEntry(IndexInfo *index_info, storage::ProjectedRow *
     // Get the offset of this column in the index
     uint16_t index_offset = index_info->offsets_[index_col_idx];
     // Check null and write bytes.
-    if (index_info->cols_[index_col_idx].Nullable() && table_pr->IsNull(table_offset)) {
+    if (index_info->cols_[index_col_idx].Nullable() && table_row->IsNull(table_offset)) {
       index_info->index_pr_->SetNull(index_offset);
     } else {
       byte *index_data = index_info->index_pr_->AccessForceNotNull(index_offset);
       uint8_t type_size = type::TypeUtil::GetTypeTrueSize(index_info->cols_[index_col_idx].Type());
-      std::memcpy(index_data, table_pr->AccessForceNotNull(table_offset), type_size);
+      std::memcpy(index_data, table_row->AccessForceNotNull(table_offset), type_size);
     }
   }
   // Insert into index
   index_info->index_ptr_->Insert(exec_ctx_->GetTxn(), *index_info->index_pr_, slot);
 }
 
-void TableReader::WriteTableCol(storage::ProjectedRow *insert_pr, uint16_t col_offset, type::TypeId type,
-                                csv::CSVField *field) {
-  if (*field == NULL_STRING) {
-    insert_pr->SetNull(col_offset);
-    return;
-  }
-  byte *insert_offset = insert_pr->AccessForceNotNull(col_offset);
-  switch (type) {
-    case type::TypeId::TINYINT: {
-      auto val = field->get<int8_t>();
-      std::memcpy(insert_offset, &val, sizeof(int8_t));
-      break;
-    }
-    case type::TypeId::SMALLINT: {
-      auto val = field->get<int16_t>();
-      std::memcpy(insert_offset, &val, sizeof(int16_t));
-      break;
-    }
-    case type::TypeId::INTEGER: {
-      auto val = field->get<int32_t>();
-      std::memcpy(insert_offset, &val, sizeof(int32_t));
-      break;
-    }
-    case type::TypeId::BIGINT: {
-      auto val = field->get<int64_t>();
-      std::memcpy(insert_offset, &val, sizeof(int64_t));
-      break;
-    }
-    case type::TypeId::DECIMAL: {
-      auto val = field->get<double>();
-      std::memcpy(insert_offset, &val, sizeof(double));
-      break;
-    }
-    case type::TypeId::DATE: {
-      auto val = sql::Date::FromString(field->get<std::string>());
-      std::memcpy(insert_offset, &val, sizeof(uint32_t));
-      break;
-    }
-    case type::TypeId::VARCHAR: {
-      auto val = field->get<std::string_view>();
-      auto content_size = static_cast<uint32_t>(val.size());
-      if (content_size <= storage::VarlenEntry::InlineThreshold()) {
-        *reinterpret_cast<storage::VarlenEntry *>(insert_offset) =
-            storage::VarlenEntry::CreateInline(reinterpret_cast<const byte *>(val.data()), content_size);
-      } else {
-        // TODO(Amadou): Use execCtx allocator
-        auto content = common::AllocationUtil::AllocateAligned(content_size);
-        std::memcpy(content, val.data(), content_size);
-        *reinterpret_cast<storage::VarlenEntry *>(insert_offset) =
-            storage::VarlenEntry::Create(content, content_size, true);
-      }
-      break;
+char TableReader::GuessDelimiter(const std::string &data_file, const std::size_t num_cols) {
+  // Pick the candidate that splits the header into as many fields as there are columns
+  std::ifstream file(data_file);
+  std::string header;
+  std::getline(file, header);
+  for (const char delimiter : {',', '|', '\t', ';', '^'}) {
+    if (static_cast<std::size_t>(std::count(header.begin(), header.end(), delimiter)) + 1 == num_cols) {
+      return delimiter;
     }
-    default:
-      UNREACHABLE("Unsupported type. Add it here first!!!");
   }
+  return ',';
 }
 
 }  // namespace terrier::execution::sql
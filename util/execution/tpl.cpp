@@ -29,6 +29,7 @@
 #include "execution/util/timer.h"
 #include "execution/vm/bytecode_generator.h"
 #include "execution/vm/bytecode_module.h"
+#include "execution/vm/jit_object_cache.h"
 #include "execution/vm/llvm_engine.h"
 #include "execution/vm/module.h"
 #include "execution/vm/vm.h"
@@ -56,6 +57,8 @@ llvm::cl::opt<std::string> DATA_DIR("data", llvm::cl::desc("Where to find data f
 llvm::cl::opt<std::string> INPUT_FILE(llvm::cl::Positional, llvm::cl::desc("<input file>"), llvm::cl::init(""), llvm::cl::cat(TPL_OPTIONS_CATEGORY));  // NOLINT
 llvm::cl::opt<std::string> OUTPUT_NAME("output-name", llvm::cl::desc("Print the output name"), llvm::cl::init("schema10"), llvm::cl::cat(TPL_OPTIONS_CATEGORY));  // NOLINT
 llvm::cl::opt<bool> IS_MINI_RUNNER("mini-runner", llvm::cl::desc("Is this used for the mini runner?"), llvm::cl::cat(TPL_OPTIONS_CATEGORY));  // NOLINT
+llvm::cl::opt<bool> NO_BYTECODE_OPT("no-bytecode-opt", llvm::cl::desc("Don't run the peephole optimizer over the generated TBC"), llvm::cl::cat(TPL_OPTIONS_CATEGORY));  // NOLINT
+llvm::cl::opt<std::string> JIT_CACHE_DIR("jit-cache-dir", llvm::cl::desc("Cache JIT-compiled modules in this directory across runs"), llvm::cl::init(""), llvm::cl::cat(TPL_OPTIONS_CATEGORY));  // NOLINT
 // clang-format on
 
 tbb::task_scheduler_init scheduler;
@@ -186,7 +189,7 @@ static void CompileAndRun(const std::string &source, const std::string &name = "
   std::unique_ptr<vm::BytecodeModule> bytecode_module;
   {
     util::ScopedTimer<std::milli> timer(&codegen_ms);
-    bytecode_module = vm::BytecodeGenerator::Compile(root, name);
+    bytecode_module = vm::BytecodeGenerator::Compile(root, name, !NO_BYTECODE_OPT);
   }
 
   // Dump Bytecode
@@ -394,6 +397,12 @@ int main(int argc, char **argv) {
   // Init TPL
   terrier::execution::InitTPL();
 
+  std::unique_ptr<terrier::execution::vm::JitObjectCache> jit_cache;
+  if (!JIT_CACHE_DIR.empty()) {
+    jit_cache = std::make_unique<terrier::execution::vm::JitObjectCache>(JIT_CACHE_DIR, uint64_t{256} << 20);
+    terrier::execution::vm::JitObjectCache::SetInstance(jit_cache.get());
+  }
+
   EXECUTION_LOG_INFO("\n{}", terrier::execution::CpuInfo::Instance()->PrettyPrintInfo());
 
   EXECUTION_LOG_INFO("Welcome to TPL (ver. {}.{})", TPL_VERSION_MAJOR, TPL_VERSION_MINOR);
@@ -406,6 +415,7 @@ int main(int argc, char **argv) {
   }
 
   // Cleanup
+  terrier::execution::vm::JitObjectCache::SetInstance(nullptr);
   terrier::execution::ShutdownTPL();
   terrier::LoggersUtil::ShutDown();
 
@@ -10,11 +10,6 @@
 #include "transaction/transaction_context.h"
 #include "type/type_id.h"
 
-// Forward declaration
-namespace csv {
-class CSVField;
-}
-
 namespace terrier::execution::sql {
 /**
  * This class reads table from files
@@ -45,11 +40,11 @@ class TableReader {
   // Create indexes
   void CreateIndexes(TableInfo *info, catalog::table_oid_t table_oid);
 
-  // Writes a column according to its type.
-  void WriteTableCol(storage::ProjectedRow *insert_pr, uint16_t col_offset, type::TypeId type, csv::CSVField *field);
+  // Guess the delimiter of a CSV file from its header
+  static char GuessDelimiter(const std::string &data_file, std::size_t num_cols);
 
   // Write an index entry
-  void WriteIndexEntry(IndexInfo *index_info, storage::ProjectedRow *table_pr,
+  void WriteIndexEntry(IndexInfo *index_info, storage::ProjectedColumns::RowView *table_row,
                        const std::vector<uint16_t> &table_offsets, const storage::TupleSlot &slot);
 
  private:
@@ -101,6 +101,12 @@ class ForcedCostModel : public AbstractCostModel {
    */
   void Visit(UNUSED_ATTRIBUTE const InnerHashJoin *op) override { output_cost_ = (pick_hash_join_) ? 0.f : 1.f; }
 
+  /**
+   * Visit a InnerMergeJoin operator
+   * @param op operator
+   */
+  void Visit(UNUSED_ATTRIBUTE const InnerMergeJoin *op) override { output_cost_ = 2.f; }
+
   /**
    * Visit a LeftHashJoin operator
    * @param op operator